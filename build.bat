@@ -21,8 +21,14 @@ echo Compiling C++ Application...
 cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /D "_WINDOWS" /W3 /I src /Fe"build\Release\MicMute-S.exe" ^
     src\core\main.cpp src\core\globals.cpp src\core\settings.cpp ^
     src\audio\audio.cpp src\ui\tray.cpp src\ui\overlay.cpp src\ui\ui.cpp ^
-    src\audio\recorder.cpp src\audio\WasapiRecorder.cpp src\audio\StreamingWavWriter.cpp ^
-    src\ui\ui_controls.cpp src\audio\call_recorder.cpp ^
+    src\audio\recorder.cpp src\audio\WasapiRecorder.cpp src\audio\RecordingHandoff.cpp src\audio\CaptureHub.cpp src\audio\StreamingWavWriter.cpp ^
+    src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp src\core\thread_pool.cpp src\core\frame_scheduler.cpp src\core\trace.cpp src\core\buffer_pool.cpp src\core\startup_profiler.cpp src\core\binary_delta.cpp ^
+    src\audio\WavDecoder.cpp src\audio\PlaybackEngine.cpp src\audio\WasapiOutput.cpp src\audio\TimeStretch.cpp ^
+    src\audio\PeakPyramid.cpp src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\VoiceActivity.cpp src\audio\ConversationAnalytics.cpp src\audio\DspChain.cpp ^
+    src\audio\Fft.cpp src\audio\Spectrogram.cpp ^
+    src\storage\recording_catalog.cpp src\storage\recording_list_model.cpp src\storage\retention.cpp src\storage\call_stats.cpp src\storage\transcoder.cpp src\storage\encrypted_recording.cpp src\storage\integrity_chain.cpp ^
+    src\core\sha256.cpp src\core\aes_gcm.cpp src\core\background_jobs.cpp src\network\http_client.cpp src\network\s3_client.cpp src\network\upload_queue.cpp src\network\update_download.cpp src\network\update_peer.cpp ^
+    src\ui\ui_controls.cpp src\ui\gdi_cache.cpp src\audio\call_recorder.cpp ^
     src\network\http_server.cpp src\ui\control_panel.cpp src\ui\player_window.cpp src\network\updater.cpp ^
     resources\app.res ^
     user32.lib gdi32.lib shell32.lib ole32.lib uuid.lib Mmdevapi.lib advapi32.lib dwmapi.lib ws2_32.lib Winhttp.lib version.lib
@@ -32,5 +38,215 @@ if %errorlevel% neq 0 (
     exit /b %errorlevel%
 )
 
+echo Compiling headless service...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /D "_CONSOLE" /W3 /I src /Fe"build\Release\MicMute-S-service.exe" ^
+    src\core\service_main.cpp src\core\globals.cpp src\core\settings.cpp ^
+    src\audio\WasapiRecorder.cpp src\audio\RecordingHandoff.cpp src\audio\CaptureHub.cpp src\audio\StreamingWavWriter.cpp src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp ^
+    src\audio\WavDecoder.cpp src\audio\MappedWavReader.cpp src\audio\VoiceActivity.cpp src\audio\ConversationAnalytics.cpp src\audio\DspChain.cpp src\audio\Fft.cpp src\audio\call_recorder.cpp ^
+    src\core\thread_pool.cpp src\core\trace.cpp src\core\buffer_pool.cpp src\core\startup_profiler.cpp src\core\binary_delta.cpp src\core\sha256.cpp src\core\aes_gcm.cpp src\core\background_jobs.cpp src\core\mapped_file.cpp ^
+    src\storage\recording_catalog.cpp src\storage\retention.cpp src\storage\call_stats.cpp src\storage\transcoder.cpp src\storage\encrypted_recording.cpp src\storage\integrity_chain.cpp ^
+    src\network\http_client.cpp src\network\s3_client.cpp src\network\upload_queue.cpp src\network\update_download.cpp src\network\update_peer.cpp src\network\http_server.cpp src\network\updater.cpp ^
+    user32.lib shell32.lib ole32.lib uuid.lib Mmdevapi.lib advapi32.lib ws2_32.lib Winhttp.lib version.lib
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling archive tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\archive_tool.exe" ^
+    src\tools\archive_tool.cpp src\storage\transcoder.cpp src\storage\retention.cpp src\storage\recording_catalog.cpp ^
+    src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp src\core\thread_pool.cpp ^
+    src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling retention tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\retention_tool.exe" ^
+    src\tools\retention_tool.cpp src\storage\retention.cpp src\storage\recording_catalog.cpp ^
+    src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp src\core\thread_pool.cpp ^
+    src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling peaks tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\peaks_tool.exe" ^
+    src\tools\peaks_tool.cpp src\audio\PeakPyramid.cpp src\audio\WavDecoder.cpp ^
+    src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp ^
+    src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling read benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\wav_read_bench.exe" ^
+    src\tools\wav_read_bench.cpp src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\WavMetadata.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling stretch benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\stretch_bench.exe" ^
+    src\tools\stretch_bench.cpp src\audio\TimeStretch.cpp src\audio\WavDecoder.cpp ^
+    src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp ^
+    src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling playback benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\playback_bench.exe" ^
+    src\tools\playback_bench.cpp src\audio\PlaybackEngine.cpp src\audio\WasapiOutput.cpp src\core\trace.cpp ^
+    src\audio\TimeStretch.cpp src\audio\WavDecoder.cpp src\audio\MappedWavReader.cpp src\core\mapped_file.cpp ^
+    src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp ^
+    src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp ^
+    ole32.lib uuid.lib Mmdevapi.lib
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling VAD tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\vad_tool.exe" ^
+    src\tools\vad_tool.cpp src\audio\VoiceActivity.cpp src\audio\WavDecoder.cpp ^
+    src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp ^
+    src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling list benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\list_bench.exe" ^
+    src\tools\list_bench.cpp src\storage\recording_list_model.cpp src\storage\recording_catalog.cpp ^
+    src\audio\WavMetadata.cpp src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp ^
+    user32.lib gdi32.lib
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling spectrogram benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\spectro_bench.exe" ^
+    src\tools\spectro_bench.cpp src\audio\Spectrogram.cpp src\audio\Fft.cpp src\core\thread_pool.cpp ^
+    src\audio\WavDecoder.cpp src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\WavMetadata.cpp ^
+    src\audio\ImaAdpcm.cpp src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling scheduler simulation...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\scheduler_sim.exe" ^
+    src\tools\scheduler_sim.cpp src\core\frame_scheduler.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling trace benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\trace_bench.exe" ^
+    src\tools\trace_bench.cpp src\core\trace.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling buffer pool benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\pool_bench.exe" ^
+    src\tools\pool_bench.cpp src\core\buffer_pool.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling update tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\update_tool.exe" ^
+    src\tools\update_tool.cpp src\network\update_download.cpp src\network\update_peer.cpp src\network\http_client.cpp ^
+    src\core\binary_delta.cpp src\core\sha256.cpp src\core\mapped_file.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling upload tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\upload_tool.exe" ^
+    src\tools\upload_tool.cpp src\network\upload_queue.cpp src\network\s3_client.cpp src\network\http_client.cpp ^
+    src\audio\WavMetadata.cpp src\core\sha256.cpp src\core\thread_pool.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling conversation analytics benchmark...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\analytics_bench.exe" ^
+    src\tools\analytics_bench.cpp src\audio\ConversationAnalytics.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling dsp_tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\dsp_tool.exe" ^
+    src\tools\dsp_tool.cpp src\audio\DspChain.cpp src\audio\Fft.cpp src\audio\WavDecoder.cpp ^
+    src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp ^
+    src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling crypt_tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\crypt_tool.exe" ^
+    src\tools\crypt_tool.cpp src\storage\encrypted_recording.cpp src\core\aes_gcm.cpp src\core\sha256.cpp ^
+    src\audio\WavDecoder.cpp src\audio\MappedWavReader.cpp src\core\mapped_file.cpp src\audio\WavMetadata.cpp src\audio\ImaAdpcm.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling integrity_tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\integrity_tool.exe" ^
+    src\tools\integrity_tool.cpp src\storage\integrity_chain.cpp src\storage\encrypted_recording.cpp ^
+    src\core\aes_gcm.cpp src\core\sha256.cpp src\core\thread_pool.cpp src\audio\WavMetadata.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
+echo Compiling soak_tool...
+cl.exe /nologo /O2 /EHsc /std:c++17 /D "NDEBUG" /W3 /I src /Fe"build\Release\soak_tool.exe" ^
+    src\tools\soak_tool.cpp
+
+if %errorlevel% neq 0 (
+    echo Compilation failed.
+    exit /b %errorlevel%
+)
+
 echo Build successful! Output: build\Release\MicMute-S.exe
 endlocal
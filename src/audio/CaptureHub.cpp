@@ -0,0 +1,568 @@
+#include "audio/CaptureHub.h"
+#include "audio/recorder.h" // For hRecorderWnd and WM_APP_RECORDING_ERROR
+#include "audio/WavDecoder.h"
+#include "core/trace.h"
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+#include <mmreg.h>
+#include <ksmedia.h>
+#include <functiondiscoverykeys_devpkey.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#pragma comment(lib, "ole32.lib")
+
+// Helper template for COM cleanup
+template <class T> static void SafeRelease(T **ppT) {
+    if (*ppT) {
+        (*ppT)->Release();
+        *ppT = nullptr;
+    }
+}
+
+static bool IsFloatFormat(const WAVEFORMATEX* pwfx) {
+    if (pwfx->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) return true;
+    if (pwfx->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
+        const WAVEFORMATEXTENSIBLE* pEx = (const WAVEFORMATEXTENSIBLE*)pwfx;
+        return IsEqualGUID(KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, pEx->SubFormat) != 0;
+    }
+    return false;
+}
+
+static const char* GetEndpointName(CaptureEndpoint endpoint) {
+    return endpoint == CaptureEndpoint::Loopback ? "Loopback" : "Mic";
+}
+
+const char* GetCaptureBackendName(CaptureBackend backend) {
+    switch (backend) {
+        case CaptureBackend::Synthetic: return "synthetic";
+        case CaptureBackend::File: return "file";
+        default: return "wasapi";
+    }
+}
+
+bool ParseCaptureBackend(const std::string& name, CaptureBackend& out) {
+    for (CaptureBackend backend : { CaptureBackend::Wasapi, CaptureBackend::Synthetic, CaptureBackend::File }) {
+        if (_stricmp(name.c_str(), GetCaptureBackendName(backend)) == 0) {
+            out = backend;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Speech-like test signal: a voiced tone (fundamental plus two harmonics)
+// under a 4 Hz syllable envelope, in 1.5 s turns - the mic talks, then the
+// loopback answers - over a low noise floor
+static void GenerateSynthetic(float* out, size_t frames, uint16_t channels, uint32_t rate,
+                              uint64_t position, bool loopback, uint32_t& noise) {
+    const double twoPi = 6.283185307179586;
+    const double f0 = loopback ? 180.0 : 140.0;
+    for (size_t i = 0; i < frames; i++) {
+        double t = (double)(position + i) / rate;
+        bool firstHalf = std::fmod(t, 3.0) < 1.5;
+        float sample = 0.0f;
+        if (firstHalf != loopback) {
+            double voiced = 0.5 * std::sin(twoPi * f0 * t) + 0.25 * std::sin(twoPi * 2 * f0 * t)
+                          + 0.12 * std::sin(twoPi * 3 * f0 * t);
+            double envelope = 0.5 - 0.5 * std::cos(twoPi * 4.0 * t);
+            sample = (float)(0.4 * envelope * voiced);
+        }
+        noise = noise * 1664525u + 1013904223u;
+        sample += (int32_t)noise / 2147483648.0f * 0.002f;
+        for (uint16_t ch = 0; ch < channels; ch++) out[i * channels + ch] = sample;
+    }
+}
+
+// Fill frames from the file, starting over at its end
+static bool ReadLooped(WavDecoder& file, float* out, size_t frames) {
+    size_t got = 0;
+    bool rewound = false;
+    while (got < frames) {
+        size_t n = file.Read(out + got * file.GetChannels(), frames - got);
+        if (n == 0) {
+            if (rewound || !file.Seek(0)) return false;     // Read error
+            rewound = true;
+            continue;
+        }
+        rewound = false;
+        got += n;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// CaptureSubscription
+// ---------------------------------------------------------------------------
+
+CaptureSubscription::CaptureSubscription(CaptureSubscription&& other) noexcept {
+    *this = std::move(other);
+}
+
+CaptureSubscription& CaptureSubscription::operator=(CaptureSubscription&& other) noexcept {
+    if (this != &other) {
+        Close();
+        m_hub = other.m_hub;
+        m_endpoint = other.m_endpoint;
+        m_keepOpen = other.m_keepOpen;
+        m_cursor = other.m_cursor;
+        m_lost = other.m_lost;
+        other.m_hub = nullptr;
+    }
+    return *this;
+}
+
+void CaptureSubscription::Close() {
+    if (!m_hub) return;
+    m_hub->Release(m_endpoint, m_keepOpen);
+    m_hub = nullptr;
+}
+
+bool CaptureSubscription::GetFormat(std::vector<uint8_t>& wfx) const {
+    if (!m_hub) return false;
+    std::lock_guard<std::mutex> lock(m_hub->m_mutex);
+    const CaptureHub::Endpoint& ep = m_hub->m_endpoints[(int)m_endpoint];
+    if (ep.format.empty()) return false;
+    wfx = ep.format;
+    return true;
+}
+
+size_t CaptureSubscription::ReadInto(BufferPool::Buffer& out) {
+    if (!m_hub) return 0;
+    CaptureHub::Endpoint& ep = m_hub->m_endpoints[(int)m_endpoint];
+    if (ep.blockAlign == 0) return 0;
+
+    uint64_t available = ep.ring.GetWriteIndex() - std::min(m_cursor, ep.ring.GetWriteIndex());
+    if (available == 0) return 0;
+    size_t count = (size_t)std::min<uint64_t>(available, ep.ring.GetCapacity());
+
+    size_t start = out.size();
+    out.resize(start + count);
+    uint64_t lost = 0;
+    size_t read = ep.ring.Read(m_cursor, out.data() + start, count, &lost,
+                               [&](uint64_t index) { return m_hub->AlignToFrame(ep, index); });
+    out.resize(start + read);
+    if (lost) {
+        m_lost += lost;
+        ep.lostBytes += lost;
+    }
+    return read;
+}
+
+void CaptureSubscription::Skip() {
+    if (!m_hub) return;
+    m_cursor = m_hub->m_endpoints[(int)m_endpoint].ring.GetWriteIndex();
+}
+
+size_t CaptureSubscription::ReadLatest(std::vector<uint8_t>& out, size_t maxBytes) {
+    out.clear();
+    if (!m_hub) return 0;
+    CaptureHub::Endpoint& ep = m_hub->m_endpoints[(int)m_endpoint];
+    if (ep.blockAlign == 0) return 0;
+
+    uint64_t write = ep.ring.GetWriteIndex();
+    maxBytes = std::min(maxBytes, ep.ring.GetCapacity() / 2);
+    uint64_t cursor = m_hub->AlignToFrame(ep, write > maxBytes ? write - maxBytes : 0);
+    if (cursor >= write) return 0;
+
+    out.resize((size_t)(write - cursor));
+    size_t read = ep.ring.Read(cursor, out.data(), out.size(), nullptr,
+                               [&](uint64_t index) { return m_hub->AlignToFrame(ep, index); });
+    out.resize(read);
+    m_cursor = cursor;
+    return read;
+}
+
+bool CaptureSubscription::ReadPeak(float& peak, uint32_t windowMs) {
+    std::vector<uint8_t> format;
+    if (!GetFormat(format)) return false;
+    const WAVEFORMATEX* wfx = (const WAVEFORMATEX*)format.data();
+    bool isFloat = IsFloatFormat(wfx);
+    if (!(isFloat && wfx->wBitsPerSample == 32) && wfx->wBitsPerSample != 16) return false;
+
+    std::vector<uint8_t> audio;
+    ReadLatest(audio, (size_t)wfx->nAvgBytesPerSec * windowMs / 1000);
+    peak = 0.0f;
+    if (isFloat) {
+        const float* samples = (const float*)audio.data();
+        for (size_t i = 0; i < audio.size() / sizeof(float); i++) peak = std::max(peak, std::fabs(samples[i]));
+    } else {
+        const int16_t* samples = (const int16_t*)audio.data();
+        for (size_t i = 0; i < audio.size() / sizeof(int16_t); i++) peak = std::max(peak, std::fabs(samples[i] / 32768.0f));
+    }
+    peak = std::min(peak, 1.0f);
+    return true;
+}
+
+bool CaptureSubscription::HasFailed() const {
+    return m_hub && m_hub->m_endpoints[(int)m_endpoint].failed;
+}
+
+// ---------------------------------------------------------------------------
+// CaptureHub
+// ---------------------------------------------------------------------------
+
+CaptureHub::CaptureHub() {
+    for (int i = 0; i < (int)CaptureEndpoint::Count; i++) {
+        m_endpoints[i].id = (CaptureEndpoint)i;
+    }
+}
+
+CaptureHub::~CaptureHub() {
+    Shutdown();
+}
+
+CaptureSubscription CaptureHub::Subscribe(CaptureEndpoint endpoint, bool keepOpen) {
+    Endpoint& ep = m_endpoints[(int)endpoint];
+    CaptureSubscription sub;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (keepOpen) {
+        if (m_shutdown) return sub;
+        ep.keepOpen++;
+        // A device that failed under running subscribers is not reopened
+        // (a new format would garble their audio) until they have all left
+        if (!ep.running && !(ep.failed && ep.keepOpen > 1)) {
+            if (ep.thread.joinable()) ep.thread.join();   // Finished its linger
+            ep.failed = false;
+            ep.running = true;
+            ep.sessions++;
+            ep.thread = std::thread(&CaptureHub::CaptureLoop, this, std::ref(ep));
+        }
+    } else {
+        ep.passive++;
+    }
+    sub.m_hub = this;
+    sub.m_endpoint = endpoint;
+    sub.m_keepOpen = keepOpen;
+    sub.m_cursor = ep.ring.GetWriteIndex();   // Audio from now on
+    return sub;
+}
+
+void CaptureHub::Release(CaptureEndpoint endpoint, bool keepOpen) {
+    Endpoint& ep = m_endpoints[(int)endpoint];
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (keepOpen) {
+        ep.lastRelease = GetTickCount64();  // Before the count: the capture thread reads them in that order
+        ep.keepOpen--;
+    } else {
+        ep.passive--;
+    }
+}
+
+bool CaptureHub::IsCapturing(CaptureEndpoint endpoint) const {
+    return m_endpoints[(int)endpoint].blockAlign != 0;
+}
+
+void CaptureHub::SetSource(const CaptureSource& source) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_source = source;
+}
+
+CaptureSource CaptureHub::GetSource() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_source;
+}
+
+uint64_t CaptureHub::AlignToFrame(const Endpoint& ep, uint64_t index) const {
+    uint64_t start = ep.sessionStart;
+    uint64_t align = ep.blockAlign;
+    if (index <= start || align == 0) return std::max(index, start);
+    return start + (index - start + align - 1) / align * align;
+}
+
+void CaptureHub::Shutdown() {
+    m_shutdown = true;
+    for (Endpoint& ep : m_endpoints) {
+        if (ep.thread.joinable()) ep.thread.join();
+    }
+}
+
+// Capture thread for one endpoint
+void CaptureHub::CaptureLoop(Endpoint& ep) {
+    const bool loopback = ep.id == CaptureEndpoint::Loopback;
+    TRACE_THREAD_NAME(loopback ? "Loopback capture" : "Mic capture");
+
+    CaptureSource source = GetSource();
+    bool released = source.backend == CaptureBackend::Wasapi ? DeviceLoop(ep) : GeneratedLoop(ep, source);
+    if (!released) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        EndSession(ep);
+    }
+}
+
+// Subscribers read whole frames of this format from here on
+void CaptureHub::PublishSession(Endpoint& ep, const WAVEFORMATEX* wfx) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (ep.ring.GetCapacity() < RING_BYTES) ep.ring.Reset(RING_BYTES);
+    ep.format.assign((const uint8_t*)wfx, (const uint8_t*)wfx + sizeof(WAVEFORMATEX) + wfx->cbSize);
+    ep.sessionStart = ep.ring.GetWriteIndex();
+    ep.blockAlign = wfx->nBlockAlign;
+}
+
+// Last keep-open subscriber gone and the linger expired: ends the session
+bool CaptureHub::LingerExpired(Endpoint& ep) {
+    if (ep.keepOpen != 0 || GetTickCount64() - ep.lastRelease < CAPTURE_LINGER_MS) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (ep.keepOpen != 0) return false;
+    EndSession(ep);
+    return true;
+}
+
+void CaptureHub::EndSession(Endpoint& ep) {
+    ep.running = false;
+    ep.blockAlign = 0;
+    ep.format.clear();
+}
+
+// Subscribers see HasFailed() on their next drain (a recorder then saves
+// what it has); the manual recorder's window is told too
+void CaptureHub::ReportFailure(Endpoint& ep) {
+    if (ep.keepOpen == 0) return;
+    ep.failed = true;
+    if (hRecorderWnd) {
+        PostMessage(hRecorderWnd, WM_APP_RECORDING_ERROR, 0, 0);
+    }
+}
+
+// The device loop every recorder used to run for itself, publishing
+// packets to the ring
+bool CaptureHub::DeviceLoop(Endpoint& ep) {
+    const bool loopback = ep.id == CaptureEndpoint::Loopback;
+    HRESULT hr;
+    IMMDeviceEnumerator *pEnumerator = nullptr;
+    IMMDevice *pDevice = nullptr;
+    IAudioClient *pAudioClient = nullptr;
+    IAudioCaptureClient *pCaptureClient = nullptr;
+    WAVEFORMATEX *pwfx = nullptr;
+    bool released = false;
+    std::vector<uint8_t> silence;
+
+    CoInitialize(nullptr);
+
+    UINT32 packetLength = 0;
+    UINT32 numFramesAvailable = 0;
+    BYTE *pData = nullptr;
+    DWORD flags = 0;
+
+    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
+                          __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
+    if (FAILED(hr)) goto Exit;
+
+    // Default capture device (microphone), or the default render device
+    // (speaker/output) for loopback
+    hr = pEnumerator->GetDefaultAudioEndpoint(loopback ? eRender : eCapture, eMultimedia, &pDevice);
+    if (FAILED(hr)) goto Exit;
+
+    // Log Device Name
+    {
+        IPropertyStore *pProps = nullptr;
+        if (SUCCEEDED(pDevice->OpenPropertyStore(STGM_READ, &pProps))) {
+            PROPVARIANT varName; PropVariantInit(&varName);
+            if (SUCCEEDED(pProps->GetValue(PKEY_Device_FriendlyName, &varName))) {
+                char buffer[512];
+                snprintf(buffer, sizeof(buffer), "[CaptureHub] %s Device: %ws\n", GetEndpointName(ep.id), varName.pwszVal);
+                OutputDebugStringA(buffer);
+                PropVariantClear(&varName);
+            }
+            pProps->Release();
+        }
+    }
+
+    hr = pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&pAudioClient);
+    if (FAILED(hr)) goto Exit;
+
+    hr = pAudioClient->GetMixFormat(&pwfx);
+    if (FAILED(hr)) goto Exit;
+
+    // LOOPBACK flag captures what's being played
+    hr = pAudioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, loopback ? AUDCLNT_STREAMFLAGS_LOOPBACK : 0,
+                                  10000000, 0, pwfx, nullptr);
+    if (FAILED(hr)) goto Exit;
+
+    hr = pAudioClient->GetService(__uuidof(IAudioCaptureClient), (void**)&pCaptureClient);
+    if (FAILED(hr)) goto Exit;
+
+    hr = pAudioClient->Start();
+    if (FAILED(hr)) goto Exit;
+
+    PublishSession(ep, pwfx);
+
+    while (!m_shutdown) {
+        if (LingerExpired(ep)) {
+            released = true;
+            break;
+        }
+
+        hr = pCaptureClient->GetNextPacketSize(&packetLength);
+        while (SUCCEEDED(hr) && packetLength != 0) {
+            hr = pCaptureClient->GetBuffer(&pData, &numFramesAvailable, &flags, nullptr, nullptr);
+            if (FAILED(hr)) break;
+            if (loopback) TRACE_INSTANT(LoopbackPacket, numFramesAvailable);
+            else TRACE_INSTANT(MicPacket, numFramesAvailable);
+
+            size_t bytes = (size_t)numFramesAvailable * pwfx->nBlockAlign;
+            if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
+                if (silence.size() < bytes) silence.assign(bytes, 0);
+                ep.ring.Write(silence.data(), bytes);
+            } else {
+                ep.ring.Write(pData, bytes);
+            }
+            ep.packets++;
+
+            hr = pCaptureClient->ReleaseBuffer(numFramesAvailable);
+            if (SUCCEEDED(hr)) hr = pCaptureClient->GetNextPacketSize(&packetLength);
+        }
+        // Invalidated (unplugged, default device or format changed): every
+        // call fails from now on, so end the session and let the
+        // subscribers see it instead of feeding them nothing
+        if (FAILED(hr)) break;
+
+        Sleep(10);
+    }
+
+    pAudioClient->Stop();
+
+Exit:
+    if (FAILED(hr) && ep.keepOpen > 0) {
+        if (hr == AUDCLNT_E_DEVICE_INVALIDATED || hr == AUDCLNT_E_RESOURCES_INVALIDATED) {
+            char errBuf[96];
+            snprintf(errBuf, sizeof(errBuf), "[CaptureHub] %s Disconnected/Invalidated!\n", GetEndpointName(ep.id));
+            OutputDebugStringA(errBuf);
+        } else {
+            char errBuf[96];
+            snprintf(errBuf, sizeof(errBuf), "[CaptureHub] %s Error: 0x%08X\n", GetEndpointName(ep.id), (unsigned)hr);
+            OutputDebugStringA(errBuf);
+        }
+        ReportFailure(ep);
+    }
+    if (pwfx) CoTaskMemFree(pwfx);
+    SafeRelease(&pCaptureClient);
+    SafeRelease(&pAudioClient);
+    SafeRelease(&pDevice);
+    SafeRelease(&pEnumerator);
+    CoUninitialize();
+    return released;
+}
+
+// Synthetic/file source: float packets of 10 ms written as the clock
+// says they are due, so subscribers see device-like timing. Sessions,
+// linger and failures behave exactly as with a device.
+bool CaptureHub::GeneratedLoop(Endpoint& ep, const CaptureSource& source) {
+    const bool loopback = ep.id == CaptureEndpoint::Loopback;
+    WavDecoder file;
+    uint32_t rate = SYNTHETIC_RATE;
+    uint16_t channels = 2;
+    if (source.backend == CaptureBackend::File) {
+        const std::string& path = source.files[(int)ep.id];
+        if (path.empty() || !file.Open(path) || file.GetTotalFrames() == 0 || file.GetSampleRate() < 1000) {
+            char errBuf[MAX_PATH + 64];
+            snprintf(errBuf, sizeof(errBuf), "[CaptureHub] %s file cannot be read: %s\n", GetEndpointName(ep.id), path.c_str());
+            OutputDebugStringA(errBuf);
+            ReportFailure(ep);
+            return false;
+        }
+        rate = file.GetSampleRate();
+        channels = file.GetChannels();
+    }
+
+    WAVEFORMATEX wfx = {};
+    wfx.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+    wfx.nChannels = channels;
+    wfx.nSamplesPerSec = rate;
+    wfx.wBitsPerSample = 32;
+    wfx.nBlockAlign = (WORD)(channels * sizeof(float));
+    wfx.nAvgBytesPerSec = rate * wfx.nBlockAlign;
+    PublishSession(ep, &wfx);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const uint64_t packetFrames = rate / 100;
+    uint64_t produced = 0;
+    uint32_t noise = loopback ? 0x9E3779B9u : 0x2545F491u;
+    std::vector<float> packet;
+
+    while (!m_shutdown) {
+        if (LingerExpired(ep)) return true;
+
+        uint64_t elapsedUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        uint64_t due = elapsedUs * rate / 1000000;
+        // Stalled for over a second (suspend, debugger): resume instead
+        // of bursting the backlog, as a device would
+        if (due > produced + rate) produced = due - packetFrames;
+
+        while (produced + packetFrames <= due) {
+            packet.resize((size_t)packetFrames * channels);
+            if (source.backend == CaptureBackend::File) {
+                if (!ReadLooped(file, packet.data(), (size_t)packetFrames)) {
+                    char errBuf[96];
+                    snprintf(errBuf, sizeof(errBuf), "[CaptureHub] %s file read failed\n", GetEndpointName(ep.id));
+                    OutputDebugStringA(errBuf);
+                    ReportFailure(ep);
+                    return false;
+                }
+            } else {
+                GenerateSynthetic(packet.data(), (size_t)packetFrames, channels, rate, produced, loopback, noise);
+            }
+            if (loopback) TRACE_INSTANT(LoopbackPacket, (uint32_t)packetFrames);
+            else TRACE_INSTANT(MicPacket, (uint32_t)packetFrames);
+
+            ep.ring.Write((const uint8_t*)packet.data(), packet.size() * sizeof(float));
+            ep.packets++;
+            produced += packetFrames;
+        }
+
+        Sleep(10);
+    }
+    return false;
+}
+
+std::string CaptureHub::EndpointStats::ToJson() const {
+    std::string json = "{";
+    json += "\"running\":" + std::string(running ? "true" : "false");
+    json += ",\"subscribers\":" + std::to_string(subscribers);
+    json += ",\"passiveSubscribers\":" + std::to_string(passiveSubscribers);
+    json += ",\"sessions\":" + std::to_string(sessions);
+    json += ",\"bytesCaptured\":" + std::to_string(bytesCaptured);
+    json += ",\"packets\":" + std::to_string(packets);
+    json += ",\"lostBytes\":" + std::to_string(lostBytes);
+    json += ",\"failed\":" + std::string(failed ? "true" : "false");
+    json += "}";
+    return json;
+}
+
+std::string CaptureHub::Stats::ToJson() const {
+    std::string json = "{\"backend\":\"" + std::string(GetCaptureBackendName(backend)) + "\"";
+    json += ",\"microphone\":" + endpoints[(int)CaptureEndpoint::Microphone].ToJson();
+    json += ",\"loopback\":" + endpoints[(int)CaptureEndpoint::Loopback].ToJson();
+    json += "}";
+    return json;
+}
+
+CaptureHub::Stats CaptureHub::GetStats() const {
+    Stats stats;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.backend = m_source.backend;
+    for (int i = 0; i < (int)CaptureEndpoint::Count; i++) {
+        const Endpoint& ep = m_endpoints[i];
+        EndpointStats& s = stats.endpoints[i];
+        s.running = ep.running;
+        s.subscribers = ep.keepOpen;
+        s.passiveSubscribers = ep.passive;
+        s.sessions = ep.sessions;
+        s.bytesCaptured = ep.ring.GetWriteIndex();
+        s.packets = ep.packets;
+        s.lostBytes = ep.lostBytes;
+        s.failed = ep.failed;
+    }
+    return stats;
+}
+
+CaptureHub& GetCaptureHub() {
+    // Never destroyed: Shutdown() stops the threads at exit, and recorders
+    // may unsubscribe during static teardown
+    static CaptureHub* hub = new CaptureHub();
+    return *hub;
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/broadcast_ring.h"
+#include "core/buffer_pool.h"
+
+// Default capture endpoints the recorders and meters listen to
+enum class CaptureEndpoint {
+    Microphone,     // Default capture device
+    Loopback,       // Default render device, loopback (what the PC plays)
+    Count
+};
+
+// Where the hub's audio comes from. The headless service can replace the
+// devices with generated audio to load-test on hosts that have none.
+enum class CaptureBackend {
+    Wasapi,         // Default devices
+    Synthetic,      // Speech-like tone bursts, mic and loopback taking turns
+    File            // A WAV per endpoint, looped
+};
+
+struct CaptureSource {
+    CaptureBackend backend = CaptureBackend::Wasapi;
+    std::string files[(int)CaptureEndpoint::Count];    // File backend
+};
+
+const char* GetCaptureBackendName(CaptureBackend backend);
+bool ParseCaptureBackend(const std::string& name, CaptureBackend& out);
+
+class CaptureHub;
+
+// A consumer's view of one endpoint: an independent read cursor into the
+// hub's ring. Reading never blocks the capture thread or other consumers;
+// a consumer that falls a whole ring behind loses the oldest audio
+// (GetLostBytes). Move-only; closing it (or destroying it) unsubscribes.
+class CaptureSubscription {
+public:
+    CaptureSubscription() = default;
+    ~CaptureSubscription() { Close(); }
+    CaptureSubscription(CaptureSubscription&& other) noexcept;
+    CaptureSubscription& operator=(CaptureSubscription&& other) noexcept;
+    CaptureSubscription(const CaptureSubscription&) = delete;
+    CaptureSubscription& operator=(const CaptureSubscription&) = delete;
+
+    bool IsOpen() const { return m_hub != nullptr; }
+    void Close();
+
+    // Device mix format (WAVEFORMATEX plus its extension) of the current
+    // capture session; false until the device has been opened
+    bool GetFormat(std::vector<uint8_t>& wfx) const;
+
+    // Append everything captured since the last read (whole frames)
+    size_t ReadInto(BufferPool::Buffer& out);
+
+    // Discard everything captured so far (paused recorders)
+    void Skip();
+
+    // The newest maxBytes of audio at most (whole frames), whether read
+    // before or not; older unread audio is skipped
+    size_t ReadLatest(std::vector<uint8_t>& out, size_t maxBytes);
+
+    // Peak sample magnitude (0..1) over the newest windowMs, for level
+    // meters; false until the device is open
+    bool ReadPeak(float& peak, uint32_t windowMs);
+
+    uint64_t GetLostBytes() const { return m_lost; }
+
+    // The device failed or was invalidated during this session
+    bool HasFailed() const;
+
+private:
+    friend class CaptureHub;
+
+    CaptureHub* m_hub = nullptr;
+    CaptureEndpoint m_endpoint = CaptureEndpoint::Microphone;
+    bool m_keepOpen = false;
+    uint64_t m_cursor = 0;
+    uint64_t m_lost = 0;
+};
+
+// One WASAPI capture client per endpoint, shared by every recorder and
+// meter in the process.
+//
+// The manual recorder, the call recorder and the level meters used to
+// open their own device clients, so recording manually during an auto
+// recorded call captured everything twice. The hub runs a single capture
+// thread per endpoint that copies packets into a BroadcastRing; each
+// consumer holds a CaptureSubscription with its own cursor. The device is
+// opened by the first subscriber that keeps it open and closed
+// CAPTURE_LINGER_MS after the last one leaves, so back-to-back calls reuse
+// the running stream. Passive subscribers (meters) read it while it runs
+// but never open the device. With a synthetic or file source the same
+// thread generates the packets instead, paced by the clock.
+class CaptureHub {
+public:
+    struct EndpointStats {
+        bool running = false;
+        uint32_t subscribers = 0;       // Keeping the device open
+        uint32_t passiveSubscribers = 0;
+        uint64_t sessions = 0;          // Device opens
+        uint64_t bytesCaptured = 0;
+        uint64_t packets = 0;
+        uint64_t lostBytes = 0;         // Skipped by lapped subscribers
+        bool failed = false;
+
+        std::string ToJson() const;
+    };
+    struct Stats {
+        CaptureBackend backend = CaptureBackend::Wasapi;
+        EndpointStats endpoints[(int)CaptureEndpoint::Count];
+
+        std::string ToJson() const;
+    };
+
+    CaptureHub();
+    ~CaptureHub();
+    CaptureHub(const CaptureHub&) = delete;
+    CaptureHub& operator=(const CaptureHub&) = delete;
+
+    // keepOpen subscribers start the device if needed; passive ones only
+    // see audio while someone else keeps it running
+    CaptureSubscription Subscribe(CaptureEndpoint endpoint, bool keepOpen = true);
+
+    bool IsCapturing(CaptureEndpoint endpoint) const;
+
+    // Takes effect the next time an endpoint is opened
+    void SetSource(const CaptureSource& source);
+    CaptureSource GetSource() const;
+
+    // Stop every capture thread (process exit)
+    void Shutdown();
+
+    Stats GetStats() const;
+
+    static const ULONGLONG CAPTURE_LINGER_MS = 3000;
+    static const size_t RING_BYTES = 4 * 1024 * 1024;   // ~10 s of 48 kHz stereo float
+    static const uint32_t SYNTHETIC_RATE = 48000;
+
+private:
+    friend class CaptureSubscription;
+
+    struct Endpoint {
+        CaptureEndpoint id = CaptureEndpoint::Microphone;
+        BroadcastRing<uint8_t> ring;
+        std::thread thread;
+        bool running = false;                       // Guarded by m_mutex
+        std::vector<uint8_t> format;                // Guarded by m_mutex
+        std::atomic<uint32_t> keepOpen{0};
+        std::atomic<uint32_t> passive{0};
+        std::atomic<ULONGLONG> lastRelease{0};
+        std::atomic<uint64_t> sessionStart{0};      // Ring index of the session's first byte
+        std::atomic<uint32_t> blockAlign{0};        // 0 until the device is open
+        std::atomic<bool> failed{false};
+        std::atomic<uint64_t> sessions{0};
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> lostBytes{0};
+
+        Endpoint() : ring(0) {}
+    };
+
+    // Each loop returns true if the session ended because the last
+    // subscriber left (already unpublished), false on failure or shutdown
+    void CaptureLoop(Endpoint& ep);
+    bool DeviceLoop(Endpoint& ep);
+    bool GeneratedLoop(Endpoint& ep, const CaptureSource& source);
+    void PublishSession(Endpoint& ep, const WAVEFORMATEX* wfx);
+    bool LingerExpired(Endpoint& ep);
+    void EndSession(Endpoint& ep);      // Caller holds m_mutex
+    void ReportFailure(Endpoint& ep);
+    void Release(CaptureEndpoint endpoint, bool keepOpen);
+    uint64_t AlignToFrame(const Endpoint& ep, uint64_t index) const;
+
+    mutable std::mutex m_mutex;
+    Endpoint m_endpoints[(int)CaptureEndpoint::Count];
+    std::atomic<bool> m_shutdown{false};
+    CaptureSource m_source;                         // Guarded by m_mutex
+};
+
+// Process-wide hub
+CaptureHub& GetCaptureHub();
@@ -0,0 +1,162 @@
+#include "audio/ConversationAnalytics.h"
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANALYTICS_SSE 1
+#include <xmmintrin.h>
+#endif
+
+static const float MARGIN_DB = 10.0f;           // Above the track's noise floor
+static const float GATE_DB = -50.0f;            // Absolute minimum for speech
+static const float FLOOR_RISE_DB = 0.05f;       // Per frame (2.5 dB/s)
+static const float FLOOR_MIN_DB = -90.0f;
+static const int HANGOVER_FRAMES = 10;          // 200 ms
+static const uint64_t MAX_PAUSE_FRAMES = 100;   // 2 s of silence ends a monologue
+
+// Sum of squares of both tracks in one pass
+static void SumSquares(const float* a, const float* b, size_t n, double& sumA, double& sumB) {
+    size_t i = 0;
+    float sa = 0.0f, sb = 0.0f;
+#ifdef ANALYTICS_SSE
+    __m128 accA = _mm_setzero_ps();
+    __m128 accB = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        accA = _mm_add_ps(accA, _mm_mul_ps(va, va));
+        accB = _mm_add_ps(accB, _mm_mul_ps(vb, vb));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, accA);
+    sa = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_ps(lanes, accB);
+    sb = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) {
+        sa += a[i] * a[i];
+        sb += b[i] * b[i];
+    }
+    sumA += sa;
+    sumB += sb;
+}
+
+static std::string FormatSeconds(double s) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f", s);
+    return buf;
+}
+
+void ConversationStats::AddToMetadata(WavMetadata& md) const {
+    md["agent_talk_sec"] = FormatSeconds(agentTalkSec);
+    md["customer_talk_sec"] = FormatSeconds(customerTalkSec);
+    md["overlap_sec"] = FormatSeconds(overlapSec);
+    md["silence_sec"] = FormatSeconds(silenceSec);
+    char ratio[16];
+    snprintf(ratio, sizeof(ratio), "%.3f", SilenceRatio());
+    md["silence_ratio"] = ratio;
+    md["longest_agent_monologue_sec"] = FormatSeconds(longestAgentMonologueSec);
+    md["longest_customer_monologue_sec"] = FormatSeconds(longestCustomerMonologueSec);
+}
+
+std::string ConversationStats::ToJson() const {
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"durationSec\":%.1f,\"agentTalkSec\":%.1f,\"customerTalkSec\":%.1f,\"overlapSec\":%.1f,"
+             "\"silenceSec\":%.1f,\"silenceRatio\":%.3f,\"longestAgentMonologueSec\":%.1f,"
+             "\"longestCustomerMonologueSec\":%.1f}",
+             durationSec, agentTalkSec, customerTalkSec, overlapSec, silenceSec, SilenceRatio(),
+             longestAgentMonologueSec, longestCustomerMonologueSec);
+    return buf;
+}
+
+bool ConversationAnalytics::Track::Decide(double sumSquares, uint32_t samples) {
+    float db = (float)(10.0 * std::log10(sumSquares / samples + 1e-12));
+    if (db < floorDb) floorDb = db < FLOOR_MIN_DB ? FLOOR_MIN_DB : db;
+    else floorDb += FLOOR_RISE_DB;
+
+    if (db > floorDb + MARGIN_DB && db > GATE_DB) {
+        hangover = HANGOVER_FRAMES;
+        return true;
+    }
+    if (hangover > 0) {
+        hangover--;
+        return true;
+    }
+    return false;
+}
+
+void ConversationAnalytics::Start(uint32_t sampleRate) {
+    *this = ConversationAnalytics();
+    m_sampleRate = sampleRate;
+    m_frameLen = sampleRate * FRAME_MS / 1000;
+    if (m_frameLen == 0) m_frameLen = 1;
+}
+
+void ConversationAnalytics::AddFrames(const float* mic, const float* loopback, size_t frames) {
+    if (!IsStarted()) return;
+    while (frames > 0) {
+        size_t n = m_frameLen - m_pos;
+        if (n > frames) n = frames;
+        SumSquares(mic, loopback, n, m_micSquares, m_loopSquares);
+        mic += n;
+        loopback += n;
+        frames -= n;
+        m_pos += (uint32_t)n;
+        if (m_pos == m_frameLen) CloseFrame();
+    }
+}
+
+void ConversationAnalytics::CloseFrame() {
+    bool agent = m_agent.Decide(m_micSquares, m_frameLen);
+    bool customer = m_customer.Decide(m_loopSquares, m_frameLen);
+    m_micSquares = m_loopSquares = 0.0;
+    m_pos = 0;
+
+    if (agent) m_agentFrames++;
+    if (customer) m_customerFrames++;
+    if (agent && customer) m_overlapFrames++;
+    if (!agent && !customer) m_silenceFrames++;
+
+    int speaker = agent && !customer ? 1 : (customer && !agent ? 2 : 0);
+    if (speaker) {
+        if (m_holder != speaker) {
+            EndMonologue();
+            m_holder = speaker;
+            m_runStart = m_frames;
+        }
+        m_runLastSpeech = m_frames;
+    } else if (agent && customer) {
+        EndMonologue();         // Interrupted
+    } else if (m_holder && m_frames - m_runLastSpeech >= MAX_PAUSE_FRAMES) {
+        EndMonologue();
+    }
+    m_frames++;
+}
+
+void ConversationAnalytics::EndMonologue() {
+    if (m_holder) {
+        uint64_t length = m_runLastSpeech + 1 - m_runStart;
+        if (length > m_longest[m_holder]) m_longest[m_holder] = length;
+    }
+    m_holder = 0;
+}
+
+ConversationStats ConversationAnalytics::GetStats() const {
+    const double frameSec = FRAME_MS / 1000.0;
+    uint64_t longest[3] = {m_longest[0], m_longest[1], m_longest[2]};
+    if (m_holder) {
+        uint64_t open = m_runLastSpeech + 1 - m_runStart;
+        if (open > longest[m_holder]) longest[m_holder] = open;
+    }
+
+    ConversationStats s;
+    s.durationSec = m_frames * frameSec;
+    s.agentTalkSec = m_agentFrames * frameSec;
+    s.customerTalkSec = m_customerFrames * frameSec;
+    s.overlapSec = m_overlapFrames * frameSec;
+    s.silenceSec = m_silenceFrames * frameSec;
+    s.longestAgentMonologueSec = longest[1] * frameSec;
+    s.longestCustomerMonologueSec = longest[2] * frameSec;
+    return s;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "audio/WavMetadata.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Per-call conversation statistics. The agent is the mic track, the
+// customer the loopback track.
+struct ConversationStats {
+    double durationSec = 0.0;
+    double agentTalkSec = 0.0;
+    double customerTalkSec = 0.0;
+    double overlapSec = 0.0;                // Both talking at once
+    double silenceSec = 0.0;                // Neither talking
+    double longestAgentMonologueSec = 0.0;
+    double longestCustomerMonologueSec = 0.0;
+
+    double SilenceRatio() const { return durationSec > 0.0 ? silenceSec / durationSec : 0.0; }
+
+    // agent_talk_sec, customer_talk_sec, overlap_sec, silence_sec,
+    // silence_ratio, longest_agent_monologue_sec, longest_customer_monologue_sec
+    void AddToMetadata(WavMetadata& md) const;
+    std::string ToJson() const;
+};
+
+// Streaming conversation analytics, run by the recorder's mixer on the two
+// tracks before they are summed.
+//
+// Per 20 ms frame each track gets one energy value (sum of squares, SSE),
+// compared with its own adaptive noise floor (follows drops at once, rises
+// 2.5 dB/s) plus a margin and an absolute gate, with a short hangover so
+// words are not chopped. The talk decisions only update counters and the
+// open monologue, so memory stays constant however long the call runs.
+//
+// A monologue is a stretch where one party holds the floor: it ends when
+// the other party speaks (overlap included) or after 2 s of silence.
+class ConversationAnalytics {
+public:
+    static constexpr uint32_t FRAME_MS = 20;
+
+    void Start(uint32_t sampleRate);
+    bool IsStarted() const { return m_frameLen != 0; }
+
+    // Mono float tracks at the Start() rate, `frames` samples each
+    void AddFrames(const float* mic, const float* loopback, size_t frames);
+
+    // Statistics so far (the open monologue included)
+    ConversationStats GetStats() const;
+
+private:
+    struct Track {
+        float floorDb = -60.0f;
+        int hangover = 0;
+        bool Decide(double sumSquares, uint32_t samples);
+    };
+
+    void CloseFrame();
+    void EndMonologue();
+
+    uint32_t m_sampleRate = 0;
+    uint32_t m_frameLen = 0;        // Samples per analysis frame
+    uint32_t m_pos = 0;
+    double m_micSquares = 0.0;
+    double m_loopSquares = 0.0;
+    Track m_agent, m_customer;
+
+    uint64_t m_frames = 0;
+    uint64_t m_agentFrames = 0;
+    uint64_t m_customerFrames = 0;
+    uint64_t m_overlapFrames = 0;
+    uint64_t m_silenceFrames = 0;
+
+    int m_holder = 0;               // Open monologue: 0 none, 1 agent, 2 customer
+    uint64_t m_runStart = 0;
+    uint64_t m_runLastSpeech = 0;
+    uint64_t m_longest[3] = {0, 0, 0};
+};
@@ -0,0 +1,557 @@
+#include "audio/DspChain.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DSP_SSE 1
+#include <xmmintrin.h>
+#endif
+
+static const double PI = 3.14159265358979323846;
+static const float AGC_SPEECH_DB = -45.0f;      // Quieter blocks never move the AGC
+static const float AGC_MIN_GAIN_DB = -10.0f;
+static const float AGC_LEVEL_SMOOTHING = 0.1f;  // Per block
+static const float GATE_HYSTERESIS_DB = 6.0f;
+static const uint32_t GATE_HOLD_MS = 100;
+static const uint32_t GATE_RELEASE_MS = 150;
+static const float SUPPRESSION_OVERSUBTRACT = 3.0f;    // Includes the minimum tracker's low bias
+static const float SUPPRESSION_POWER_SMOOTHING = 0.3f;  // Per hop
+static const float SUPPRESSION_GAIN_SMOOTHING = 0.5f;
+
+static inline float DbToGain(float db) { return std::pow(10.0f, db / 20.0f); }
+
+static inline float MeanSquareDb(double sumSquares, size_t n) {
+    return (float)(10.0 * std::log10(sumSquares / (n ? n : 1) + 1e-12));
+}
+
+// ---------------------------------------------------------------------------
+// Vector helpers (SSE with a scalar tail)
+// ---------------------------------------------------------------------------
+
+// End of the whole 4-float vectors in n. Bounding the vector loops by this
+// rather than by i + 4 <= n lets the compiler see the tail stays in range.
+static inline size_t VectorEnd(size_t n) { return n & ~(size_t)3; }
+
+static float SumSquares(const float* x, size_t n) {
+    size_t i = 0;
+    float sum = 0.0f;
+#ifdef DSP_SSE
+    __m128 acc = _mm_setzero_ps();
+    for (; i < VectorEnd(n); i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) sum += x[i] * x[i];
+    return sum;
+}
+
+// x[i] *= gain moving linearly from g0 (exclusive) to g1 (reached at the end)
+static void ApplyRamp(float* x, size_t n, float g0, float g1) {
+    if (n == 0) return;
+    const float step = (g1 - g0) / (float)n;
+    size_t i = 0;
+#ifdef DSP_SSE
+    if (g0 == g1) {
+        __m128 g = _mm_set1_ps(g1);
+        for (; i < VectorEnd(n); i += 4) _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), g));
+    } else {
+        __m128 g = _mm_setr_ps(g0 + step, g0 + 2 * step, g0 + 3 * step, g0 + 4 * step);
+        __m128 inc = _mm_set1_ps(4 * step);
+        for (; i < VectorEnd(n); i += 4) {
+            _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), g));
+            g = _mm_add_ps(g, inc);
+        }
+    }
+#endif
+    for (; i < n; i++) x[i] *= g0 + step * (float)(i + 1);
+}
+
+// out[i] = a[i] * b[i]
+static void Multiply(float* out, const float* a, const float* b, size_t n) {
+    size_t i = 0;
+#ifdef DSP_SSE
+    for (; i < VectorEnd(n); i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif
+    for (; i < n; i++) out[i] = a[i] * b[i];
+}
+
+// acc[i] += x[i]
+static void Accumulate(float* acc, const float* x, size_t n) {
+    size_t i = 0;
+#ifdef DSP_SSE
+    for (; i < VectorEnd(n); i += 4) {
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_loadu_ps(x + i)));
+    }
+#endif
+    for (; i < n; i++) acc[i] += x[i];
+}
+
+// Gain that brings each sample to the ceiling: ceiling / max(|x|, ceiling)
+static void RequiredGain(const float* x, float* out, size_t n, float ceiling) {
+    size_t i = 0;
+#ifdef DSP_SSE
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 c = _mm_set1_ps(ceiling);
+    for (; i < VectorEnd(n); i += 4) {
+        __m128 a = _mm_andnot_ps(signMask, _mm_loadu_ps(x + i));
+        _mm_storeu_ps(out + i, _mm_div_ps(c, _mm_max_ps(a, c)));
+    }
+#endif
+    for (; i < n; i++) {
+        float a = std::fabs(x[i]);
+        out[i] = ceiling / (a > ceiling ? a : ceiling);
+    }
+}
+
+// Clamp to [-c, c]
+static void Clamp(float* x, size_t n, float c) {
+    size_t i = 0;
+#ifdef DSP_SSE
+    const __m128 hi = _mm_set1_ps(c), lo = _mm_set1_ps(-c);
+    for (; i < VectorEnd(n); i += 4) {
+        _mm_storeu_ps(x + i, _mm_max_ps(lo, _mm_min_ps(hi, _mm_loadu_ps(x + i))));
+    }
+#endif
+    for (; i < n; i++) x[i] = x[i] > c ? c : (x[i] < -c ? -c : x[i]);
+}
+
+// ---------------------------------------------------------------------------
+// Timings
+// ---------------------------------------------------------------------------
+
+const char* DspStageName(DspStageKind kind) {
+    switch (kind) {
+    case DspStageKind::HighPass:         return "highPass";
+    case DspStageKind::NoiseGate:        return "noiseGate";
+    case DspStageKind::Agc:              return "agc";
+    case DspStageKind::Limiter:          return "limiter";
+    case DspStageKind::NoiseSuppression: return "noiseSuppression";
+    default:                             return "unknown";
+    }
+}
+
+void DspTimings::Counter::Add(uint64_t ns) {
+    blocks.fetch_add(1, std::memory_order_relaxed);
+    totalNs.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t prev = maxNs.load(std::memory_order_relaxed);
+    while (ns > prev && !maxNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void DspTimings::Record(DspStageKind kind, uint64_t ns) {
+    m_stages[(int)kind].Add(ns);
+}
+
+void DspTimings::RecordChain(uint64_t ns, uint64_t budgetNs, double blockUs) {
+    m_chain.Add(ns);
+    m_budgetNs.store(budgetNs, std::memory_order_relaxed);
+    m_blockNs.store((uint64_t)(blockUs * 1000.0), std::memory_order_relaxed);
+    if (budgetNs && ns > budgetNs) m_overruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DspTimings::Reset() {
+    for (Counter& c : m_stages) {
+        c.blocks = 0;
+        c.totalNs = 0;
+        c.maxNs = 0;
+    }
+    m_chain.blocks = 0;
+    m_chain.totalNs = 0;
+    m_chain.maxNs = 0;
+    m_overruns = 0;
+}
+
+static double AvgUs(uint64_t totalNs, uint64_t blocks) {
+    return blocks ? totalNs / 1000.0 / blocks : 0.0;
+}
+
+double DspTimings::GetAvgUs(DspStageKind kind) const {
+    const Counter& c = m_stages[(int)kind];
+    return AvgUs(c.totalNs.load(std::memory_order_relaxed), c.blocks.load(std::memory_order_relaxed));
+}
+
+double DspTimings::GetMaxUs(DspStageKind kind) const {
+    return m_stages[(int)kind].maxNs.load(std::memory_order_relaxed) / 1000.0;
+}
+
+double DspTimings::GetChainAvgUs() const {
+    return AvgUs(m_chain.totalNs.load(std::memory_order_relaxed), m_chain.blocks.load(std::memory_order_relaxed));
+}
+
+double DspTimings::GetChainMaxUs() const {
+    return m_chain.maxNs.load(std::memory_order_relaxed) / 1000.0;
+}
+
+std::string DspTimings::ToJson() const {
+    double blockUs = m_blockNs.load(std::memory_order_relaxed) / 1000.0;
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"blockUs\":%.0f,\"budgetUs\":%.1f,\"blocks\":%llu,\"overruns\":%llu,\"avgUs\":%.2f,\"maxUs\":%.1f,\"stages\":[",
+             blockUs, m_budgetNs.load(std::memory_order_relaxed) / 1000.0,
+             (unsigned long long)GetBlocks(), (unsigned long long)GetOverruns(),
+             GetChainAvgUs(), GetChainMaxUs());
+    std::string json = buf;
+    bool first = true;
+    for (int i = 0; i < (int)DspStageKind::Count; i++) {
+        uint64_t blocks = m_stages[i].blocks.load(std::memory_order_relaxed);
+        if (blocks == 0) continue;
+        DspStageKind kind = (DspStageKind)i;
+        double avg = GetAvgUs(kind);
+        snprintf(buf, sizeof(buf),
+                 "%s{\"name\":\"%s\",\"blocks\":%llu,\"avgUs\":%.2f,\"maxUs\":%.1f,\"realtimePercent\":%.3f}",
+                 first ? "" : ",", DspStageName(kind), (unsigned long long)blocks, avg, GetMaxUs(kind),
+                 blockUs > 0.0 ? avg * 100.0 / blockUs : 0.0);
+        json += buf;
+        first = false;
+    }
+    json += "]}";
+    return json;
+}
+
+DspTimings& GetMicDspTimings() {
+    static DspTimings timings;
+    return timings;
+}
+
+// ---------------------------------------------------------------------------
+// High-pass
+// ---------------------------------------------------------------------------
+
+void HighPassStage::Configure(uint32_t sampleRate, size_t, const DspSettings& s) {
+    // RBJ cookbook, Q = 1/sqrt(2)
+    double w = 2.0 * PI * s.highPassHz / sampleRate;
+    double alpha = std::sin(w) / (2.0 * 0.70710678118654752);
+    double cosw = std::cos(w);
+    double a0 = 1.0 + alpha;
+    m_b0 = (float)((1.0 + cosw) / 2.0 / a0);
+    m_b1 = (float)(-(1.0 + cosw) / a0);
+    m_b2 = m_b0;
+    m_a1 = (float)(-2.0 * cosw / a0);
+    m_a2 = (float)((1.0 - alpha) / a0);
+    Reset();
+}
+
+void HighPassStage::Process(float* x, size_t n) {
+    // Transposed direct form II
+    float z1 = m_z1, z2 = m_z2;
+    for (size_t i = 0; i < n; i++) {
+        float in = x[i];
+        float out = m_b0 * in + z1;
+        z1 = m_b1 * in - m_a1 * out + z2;
+        z2 = m_b2 * in - m_a2 * out;
+        x[i] = out;
+    }
+    if (std::fabs(z1) < 1e-20f) z1 = 0.0f;
+    if (std::fabs(z2) < 1e-20f) z2 = 0.0f;
+    m_z1 = z1;
+    m_z2 = z2;
+}
+
+// ---------------------------------------------------------------------------
+// Noise gate
+// ---------------------------------------------------------------------------
+
+void NoiseGateStage::Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) {
+    double blockMs = 1000.0 * maxBlock / sampleRate;
+    m_openDb = s.gateThresholdDb;
+    m_closeDb = s.gateThresholdDb - GATE_HYSTERESIS_DB;
+    m_closedGain = DbToGain(s.gateAttenuationDb);
+    m_holdBlocks = (int)std::ceil(GATE_HOLD_MS / blockMs);
+    double releaseBlocks = GATE_RELEASE_MS / blockMs;
+    m_releaseStep = (float)std::pow((double)m_closedGain, 1.0 / (releaseBlocks > 1.0 ? releaseBlocks : 1.0));
+    Reset();
+}
+
+void NoiseGateStage::Reset() {
+    m_open = false;
+    m_hold = 0;
+    m_gain = m_closedGain;
+}
+
+void NoiseGateStage::Process(float* x, size_t n) {
+    float db = MeanSquareDb(SumSquares(x, n), n);
+    if (db > m_openDb) {
+        m_open = true;
+        m_hold = m_holdBlocks;
+    } else if (m_open && db < m_closeDb) {
+        if (m_hold > 0) m_hold--;
+        else m_open = false;
+    }
+
+    float target = m_open ? 1.0f : m_closedGain;
+    float gain = target >= m_gain ? target : std::max(target, m_gain * m_releaseStep);
+    ApplyRamp(x, n, m_gain, gain);
+    m_gain = gain;
+}
+
+// ---------------------------------------------------------------------------
+// AGC
+// ---------------------------------------------------------------------------
+
+void AgcStage::Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) {
+    double blockSec = (double)maxBlock / sampleRate;
+    m_targetDb = s.agcTargetDb;
+    m_maxGainDb = s.agcMaxGainDb;
+    m_upStepDb = (float)(3.0 * blockSec);
+    m_downStepDb = (float)(15.0 * blockSec);
+    Reset();
+}
+
+void AgcStage::Reset() {
+    m_levelDb = -100.0f;
+    m_gainDb = 0.0f;
+    m_gain = 1.0f;
+}
+
+void AgcStage::Process(float* x, size_t n) {
+    float db = MeanSquareDb(SumSquares(x, n), n);
+    if (db > AGC_SPEECH_DB) {
+        m_levelDb = m_levelDb <= -100.0f ? db : m_levelDb + AGC_LEVEL_SMOOTHING * (db - m_levelDb);
+        float desired = std::min(std::max(m_targetDb - m_levelDb, AGC_MIN_GAIN_DB), m_maxGainDb);
+        if (desired > m_gainDb) m_gainDb = std::min(desired, m_gainDb + m_upStepDb);
+        else m_gainDb = std::max(desired, m_gainDb - m_downStepDb);
+    }
+    float gain = DbToGain(m_gainDb);
+    ApplyRamp(x, n, m_gain, gain);
+    m_gain = gain;
+}
+
+// ---------------------------------------------------------------------------
+// Limiter
+// ---------------------------------------------------------------------------
+
+void LimiterStage::Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) {
+    m_ceiling = DbToGain(s.limiterCeilingDb);
+    m_window = (size_t)(sampleRate * s.limiterLookaheadMs / 1000.0f);
+    if (m_window < 1) m_window = 1;
+    m_required.assign(maxBlock, 1.0f);
+    m_delay.assign(m_window, 0.0f);
+    m_mins.assign(m_window, 1.0f);
+    m_dequeVal.assign(m_window, 1.0f);
+    m_dequeIdx.assign(m_window, 0);
+    Reset();
+}
+
+void LimiterStage::Reset() {
+    std::fill(m_delay.begin(), m_delay.end(), 0.0f);
+    std::fill(m_mins.begin(), m_mins.end(), 1.0f);
+    m_dequeHead = m_dequeSize = 0;
+    m_index = 0;
+    m_minSum = (double)m_window;
+}
+
+void LimiterStage::Process(float* x, size_t n) {
+    const size_t w = m_window;
+    float* req = m_required.data();
+    RequiredGain(x, req, n, m_ceiling);
+
+    for (size_t i = 0; i < n; i++) {
+        // Sliding minimum of the required gain over the last w samples
+        float r = req[i];
+        while (m_dequeSize > 0) {
+            size_t back = (m_dequeHead + m_dequeSize - 1) % w;
+            if (m_dequeVal[back] < r) break;
+            m_dequeSize--;
+        }
+        size_t slot = (m_dequeHead + m_dequeSize) % w;
+        m_dequeVal[slot] = r;
+        m_dequeIdx[slot] = m_index;
+        m_dequeSize++;
+        if (m_dequeIdx[m_dequeHead] + w <= m_index) {
+            m_dequeHead = (m_dequeHead + 1) % w;
+            m_dequeSize--;
+        }
+        float minGain = m_dequeVal[m_dequeHead];
+
+        // Box filter over the same length, and a w - 1 sample delay: every
+        // minimum averaged here already covers the sample coming out
+        size_t pos = (size_t)(m_index % w);
+        m_minSum += minGain - m_mins[pos];
+        m_mins[pos] = minGain;
+        m_delay[pos] = x[i];
+        float delayed = m_delay[pos + 1 == w ? 0 : pos + 1];
+        x[i] = delayed * (float)(m_minSum / (double)w);
+        m_index++;
+    }
+    // Rounding in the running sum can leave a peak a hair over
+    Clamp(x, n, m_ceiling);
+}
+
+// ---------------------------------------------------------------------------
+// Noise suppression
+// ---------------------------------------------------------------------------
+
+void NoiseSuppressionStage::Configure(uint32_t sampleRate, size_t, const DspSettings& s) {
+    m_fft.Configure(FRAME);
+    m_floorGain = DbToGain(s.suppressionFloorDb);
+    m_window.resize(FRAME);
+    for (size_t i = 0; i < FRAME; i++) {
+        m_window[i] = (float)std::sqrt(0.5 - 0.5 * std::cos(2.0 * PI * i / FRAME));
+    }
+    m_input.assign(FRAME, 0.0f);
+    m_output.assign(HOP, 0.0f);
+    m_accum.assign(FRAME, 0.0f);
+    m_frame.assign(FRAME, 0.0f);
+    m_re.assign(BINS, 0.0f);
+    m_im.assign(BINS, 0.0f);
+    m_smoothed.assign(BINS, 0.0f);
+    m_noise.assign(BINS, 0.0f);
+    m_gain.assign(BINS, 1.0f);
+    // Floor rises 3 dB/s
+    double hopsPerSec = (double)sampleRate / HOP;
+    m_rise = (float)std::pow(2.0, 1.0 / hopsPerSec);
+    Reset();
+}
+
+void NoiseSuppressionStage::Reset() {
+    std::fill(m_input.begin(), m_input.end(), 0.0f);
+    std::fill(m_output.begin(), m_output.end(), 0.0f);
+    std::fill(m_accum.begin(), m_accum.end(), 0.0f);
+    std::fill(m_gain.begin(), m_gain.end(), 1.0f);
+    m_fill = FRAME - HOP;
+    m_outPos = 0;
+    m_noiseInit = false;
+}
+
+void NoiseSuppressionStage::Process(float* x, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        m_input[m_fill++] = x[i];
+        x[i] = m_output[m_outPos++];
+        if (m_fill == FRAME) ProcessFrame();
+    }
+}
+
+void NoiseSuppressionStage::ProcessFrame() {
+    Multiply(m_frame.data(), m_input.data(), m_window.data(), FRAME);
+    m_fft.Forward(m_frame.data(), m_re.data(), m_im.data());
+
+    float* re = m_re.data();
+    float* im = m_im.data();
+    float* smoothed = m_smoothed.data();
+    float* noise = m_noise.data();
+    float* gain = m_gain.data();
+    if (!m_noiseInit) {
+        for (size_t k = 0; k < BINS; k++) smoothed[k] = noise[k] = re[k] * re[k] + im[k] * im[k];
+        m_noiseInit = true;
+    }
+
+    // Per bin: smoothed power, its running minimum as the noise floor, and
+    // a subtraction gain from the two
+
+    size_t k = 0;
+#ifdef DSP_SSE
+    const __m128 powerSmooth = _mm_set1_ps(SUPPRESSION_POWER_SMOOTHING);
+    const __m128 rise = _mm_set1_ps(m_rise);
+    const __m128 over = _mm_set1_ps(SUPPRESSION_OVERSUBTRACT);
+    const __m128 floorGain = _mm_set1_ps(m_floorGain);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 eps = _mm_set1_ps(1e-20f);
+    const __m128 smooth = _mm_set1_ps(SUPPRESSION_GAIN_SMOOTHING);
+    for (; k + 4 <= BINS; k += 4) {
+        __m128 r = _mm_loadu_ps(re + k);
+        __m128 i = _mm_loadu_ps(im + k);
+        __m128 p = _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(i, i));
+        __m128 sp = _mm_loadu_ps(smoothed + k);
+        sp = _mm_add_ps(sp, _mm_mul_ps(powerSmooth, _mm_sub_ps(p, sp)));
+        _mm_storeu_ps(smoothed + k, sp);
+        __m128 nz = _mm_loadu_ps(noise + k);
+        __m128 lower = _mm_cmplt_ps(sp, nz);
+        nz = _mm_or_ps(_mm_and_ps(lower, sp), _mm_andnot_ps(lower, _mm_mul_ps(nz, rise)));
+        _mm_storeu_ps(noise + k, nz);
+        __m128 g = _mm_sub_ps(one, _mm_div_ps(_mm_mul_ps(over, nz), _mm_add_ps(sp, eps)));
+        g = _mm_max_ps(g, floorGain);
+        __m128 prev = _mm_loadu_ps(gain + k);
+        g = _mm_add_ps(prev, _mm_mul_ps(smooth, _mm_sub_ps(g, prev)));
+        _mm_storeu_ps(gain + k, g);
+        _mm_storeu_ps(re + k, _mm_mul_ps(r, g));
+        _mm_storeu_ps(im + k, _mm_mul_ps(i, g));
+    }
+#endif
+    for (; k < BINS; k++) {
+        float p = re[k] * re[k] + im[k] * im[k];
+        smoothed[k] += SUPPRESSION_POWER_SMOOTHING * (p - smoothed[k]);
+        noise[k] = smoothed[k] < noise[k] ? smoothed[k] : noise[k] * m_rise;
+        float g = std::max(1.0f - SUPPRESSION_OVERSUBTRACT * noise[k] / (smoothed[k] + 1e-20f), m_floorGain);
+        gain[k] += SUPPRESSION_GAIN_SMOOTHING * (g - gain[k]);
+        re[k] *= gain[k];
+        im[k] *= gain[k];
+    }
+
+    // Back to time, synthesis window, overlap-add; the first hop is done
+    m_fft.Inverse(re, im, m_frame.data());
+    Multiply(m_frame.data(), m_frame.data(), m_window.data(), FRAME);
+    Accumulate(m_accum.data(), m_frame.data(), FRAME);
+    memcpy(m_output.data(), m_accum.data(), HOP * sizeof(float));
+    memmove(m_accum.data(), m_accum.data() + HOP, (FRAME - HOP) * sizeof(float));
+    std::fill(m_accum.begin() + (FRAME - HOP), m_accum.end(), 0.0f);
+
+    memmove(m_input.data(), m_input.data() + HOP, (FRAME - HOP) * sizeof(float));
+    m_fill = FRAME - HOP;
+    m_outPos = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Chain
+// ---------------------------------------------------------------------------
+
+void DspChain::Configure(uint32_t sampleRate, const DspSettings& settings, DspTimings* timings) {
+    m_settings = settings;
+    m_timings = timings;
+    m_block = sampleRate / 100;
+    if (m_block == 0) m_block = 1;
+    m_blockUs = 1e6 * m_block / sampleRate;
+    m_budgetNs = (uint64_t)(m_blockUs * 1000.0 * settings.budgetPercent / 100.0);
+
+    m_count = 0;
+    DspStage* all[] = {&m_highPass, &m_suppression, &m_gate, &m_agc, &m_limiter};
+    bool enabled[] = {settings.highPass, settings.noiseSuppression, settings.noiseGate, settings.agc, settings.limiter};
+    for (int i = 0; i < 5; i++) {
+        if (!enabled[i]) continue;
+        all[i]->Configure(sampleRate, m_block, settings);
+        m_stages[m_count++] = all[i];
+    }
+}
+
+void DspChain::Reset() {
+    for (int i = 0; i < m_count; i++) m_stages[i]->Reset();
+}
+
+size_t DspChain::GetLatency() const {
+    size_t latency = 0;
+    for (int i = 0; i < m_count; i++) latency += m_stages[i]->GetLatency();
+    return latency;
+}
+
+void DspChain::Process(float* samples, size_t frames) {
+    if (m_count == 0) return;
+    typedef std::chrono::steady_clock Clock;
+    while (frames > 0) {
+        size_t n = frames < m_block ? frames : m_block;
+        if (m_timings) {
+            Clock::time_point start = Clock::now();
+            Clock::time_point last = start;
+            for (int i = 0; i < m_count; i++) {
+                m_stages[i]->Process(samples, n);
+                Clock::time_point now = Clock::now();
+                m_timings->Record(m_stages[i]->Kind(),
+                                  (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+                last = now;
+            }
+            m_timings->RecordChain((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(last - start).count(),
+                                   m_budgetNs, m_blockUs);
+        } else {
+            for (int i = 0; i < m_count; i++) m_stages[i]->Process(samples, n);
+        }
+        samples += n;
+        frames -= n;
+    }
+}
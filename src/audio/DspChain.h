@@ -0,0 +1,228 @@
+#pragma once
+
+#include "audio/Fft.h"
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Which stages run and how they are tuned. Defaults are the transparent
+// ones (rumble filter and a limiter just below full scale); gate, AGC and
+// noise suppression change how the agent sounds and are opt-in.
+struct DspSettings {
+    bool highPass = true;
+    float highPassHz = 80.0f;
+
+    bool noiseGate = false;
+    float gateThresholdDb = -50.0f;     // Opens above, closes 6 dB below
+    float gateAttenuationDb = -30.0f;   // Closed gain (not a hard mute)
+
+    bool agc = false;
+    float agcTargetDb = -20.0f;         // Speech RMS, dBFS
+    float agcMaxGainDb = 15.0f;
+
+    bool limiter = true;
+    float limiterCeilingDb = -1.0f;
+    float limiterLookaheadMs = 5.0f;
+
+    bool noiseSuppression = false;
+    float suppressionFloorDb = -20.0f;  // Deepest cut per bin
+
+    // Real-time share of one core the whole chain may use
+    double budgetPercent = 2.0;
+};
+
+enum class DspStageKind { HighPass, NoiseGate, Agc, Limiter, NoiseSuppression, Count };
+
+const char* DspStageName(DspStageKind kind);
+
+// CPU time per processed block, per stage and for the whole chain.
+// Written by the processing thread with relaxed atomics, read by anyone
+// (the /dsp endpoint, dsp_tool); several chains may share one instance.
+class DspTimings {
+public:
+    void Record(DspStageKind kind, uint64_t ns);
+    void RecordChain(uint64_t ns, uint64_t budgetNs, double blockUs);
+    void Reset();
+
+    // {"blockUs":..,"budgetUs":..,"blocks":..,"overruns":..,"avgUs":..,"maxUs":..,
+    //  "stages":[{"name":..,"blocks":..,"avgUs":..,"maxUs":..,"realtimePercent":..}]}
+    std::string ToJson() const;
+
+    uint64_t GetBlocks() const { return m_chain.blocks.load(std::memory_order_relaxed); }
+    uint64_t GetOverruns() const { return m_overruns.load(std::memory_order_relaxed); }
+    double GetAvgUs(DspStageKind kind) const;
+    double GetMaxUs(DspStageKind kind) const;
+    double GetChainAvgUs() const;
+    double GetChainMaxUs() const;
+
+private:
+    struct Counter {
+        std::atomic<uint64_t> blocks{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::atomic<uint64_t> maxNs{0};
+        void Add(uint64_t ns);
+    };
+
+    Counter m_stages[(int)DspStageKind::Count];
+    Counter m_chain;
+    std::atomic<uint64_t> m_overruns{0};
+    std::atomic<uint64_t> m_budgetNs{0};
+    std::atomic<uint64_t> m_blockNs{0};
+};
+
+// Shared by every recorder's mic chain (reported by POST /dsp)
+DspTimings& GetMicDspTimings();
+
+class DspStage {
+public:
+    virtual ~DspStage() = default;
+    virtual DspStageKind Kind() const = 0;
+    virtual void Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) = 0;
+    virtual void Reset() = 0;
+    virtual void Process(float* x, size_t n) = 0;
+    virtual size_t GetLatency() const { return 0; }
+};
+
+// 2nd-order Butterworth high-pass (rumble, DC, handling noise). Recursive,
+// so per sample; flushes denormals at block end.
+class HighPassStage : public DspStage {
+public:
+    DspStageKind Kind() const override { return DspStageKind::HighPass; }
+    void Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) override;
+    void Reset() override { m_z1 = m_z2 = 0.0f; }
+    void Process(float* x, size_t n) override;
+
+private:
+    float m_b0 = 1.0f, m_b1 = 0.0f, m_b2 = 0.0f, m_a1 = 0.0f, m_a2 = 0.0f;
+    float m_z1 = 0.0f, m_z2 = 0.0f;
+};
+
+// Block-RMS gate with hysteresis and a 100 ms hold; gain ramps across each
+// block (opens within one block, closes over ~150 ms).
+class NoiseGateStage : public DspStage {
+public:
+    DspStageKind Kind() const override { return DspStageKind::NoiseGate; }
+    void Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) override;
+    void Reset() override;
+    void Process(float* x, size_t n) override;
+    bool IsOpen() const { return m_open; }
+
+private:
+    float m_openDb = -50.0f, m_closeDb = -56.0f;
+    float m_closedGain = 0.03f;
+    float m_releaseStep = 1.0f;         // Per-block factor while closing
+    int m_holdBlocks = 10;
+    bool m_open = false;
+    int m_hold = 0;
+    float m_gain = 0.03f;
+};
+
+// Slow speech-level AGC: adapts only on blocks that look like speech,
+// gains up by at most 3 dB/s and down by 15 dB/s, holds in pauses.
+class AgcStage : public DspStage {
+public:
+    DspStageKind Kind() const override { return DspStageKind::Agc; }
+    void Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) override;
+    void Reset() override;
+    void Process(float* x, size_t n) override;
+    float GetGainDb() const { return m_gainDb; }
+
+private:
+    float m_targetDb = -20.0f, m_maxGainDb = 15.0f;
+    float m_upStepDb = 0.03f, m_downStepDb = 0.15f;     // Per block
+    float m_levelDb = -100.0f;
+    float m_gainDb = 0.0f;
+    float m_gain = 1.0f;
+};
+
+// Look-ahead peak limiter. Each sample's required gain goes through a
+// sliding minimum over the look-ahead window and then a box filter of the
+// same length, so the gain has reached every peak's requirement by the
+// time the (delayed) peak comes out, without steps. Output never exceeds
+// the ceiling; latency is the look-ahead.
+class LimiterStage : public DspStage {
+public:
+    DspStageKind Kind() const override { return DspStageKind::Limiter; }
+    void Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) override;
+    void Reset() override;
+    void Process(float* x, size_t n) override;
+    size_t GetLatency() const override { return m_window - 1; }
+
+private:
+    float m_ceiling = 0.89f;
+    size_t m_window = 240;
+    std::vector<float> m_required;      // Per block scratch
+    std::vector<float> m_delay;         // Ring, m_window samples
+    std::vector<float> m_mins;          // Ring of sliding-min outputs for the box filter
+    std::vector<float> m_dequeVal;      // Monotonic deque (ring) for the sliding minimum
+    std::vector<uint64_t> m_dequeIdx;
+    size_t m_dequeHead = 0, m_dequeSize = 0;
+    uint64_t m_index = 0;
+    double m_minSum = 0.0;
+};
+
+// STFT noise suppression: 512-point sqrt-Hann frames at 50% overlap,
+// per-bin noise floor (minimum of the smoothed power: follows drops, rises
+// 3 dB/s), spectral-subtraction gain with a floor, smoothed over time. 512 samples latency.
+class NoiseSuppressionStage : public DspStage {
+public:
+    static constexpr size_t FRAME = 512;
+    static constexpr size_t HOP = FRAME / 2;
+    static constexpr size_t BINS = FRAME / 2 + 1;
+
+    DspStageKind Kind() const override { return DspStageKind::NoiseSuppression; }
+    void Configure(uint32_t sampleRate, size_t maxBlock, const DspSettings& s) override;
+    void Reset() override;
+    void Process(float* x, size_t n) override;
+    size_t GetLatency() const override { return FRAME; }
+
+private:
+    void ProcessFrame();
+
+    RealFft m_fft;
+    float m_floorGain = 0.1f;
+    float m_rise = 1.0f;                // Noise floor growth per hop
+    std::vector<float> m_window;
+    std::vector<float> m_input;         // Last FRAME input samples
+    std::vector<float> m_output;        // Next HOP output samples
+    std::vector<float> m_accum;         // Overlap-add
+    std::vector<float> m_frame, m_re, m_im;
+    std::vector<float> m_smoothed, m_noise, m_gain;
+    size_t m_fill = 0, m_outPos = 0;
+    bool m_noiseInit = false;
+};
+
+// The mic chain: high-pass -> noise suppression -> gate -> AGC -> limiter,
+// each optional. Process() takes any length and runs the stages on fixed
+// 10 ms blocks in place; everything is allocated in Configure(), so the
+// audio thread never allocates. Each stage is timed per block.
+class DspChain {
+public:
+    void Configure(uint32_t sampleRate, const DspSettings& settings, DspTimings* timings = nullptr);
+    bool IsConfigured() const { return m_block != 0; }
+    bool IsActive() const { return m_count > 0; }
+    void Reset();
+
+    void Process(float* samples, size_t frames);
+
+    size_t GetBlockSize() const { return m_block; }
+    size_t GetLatency() const;          // Samples, all enabled stages
+    const DspSettings& GetSettings() const { return m_settings; }
+
+private:
+    DspSettings m_settings;
+    DspTimings* m_timings = nullptr;
+    size_t m_block = 0;
+    uint64_t m_budgetNs = 0;
+    double m_blockUs = 0.0;
+
+    HighPassStage m_highPass;
+    NoiseSuppressionStage m_suppression;
+    NoiseGateStage m_gate;
+    AgcStage m_agc;
+    LimiterStage m_limiter;
+    DspStage* m_stages[(int)DspStageKind::Count] = {};
+    int m_count = 0;
+};
@@ -0,0 +1,153 @@
+#include "audio/Fft.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FFT_SSE 1
+#include <xmmintrin.h>
+#endif
+
+bool RealFft::Configure(size_t size) {
+    if (size < 16 || size > 65536 || (size & (size - 1)) != 0) return false;
+    if (size == m_size) return true;
+
+    const double pi = 3.14159265358979323846;
+    m_size = size;
+    m_half = size / 2;
+
+    unsigned bits = 0;
+    while (((size_t)1 << bits) < m_half) bits++;
+    m_bitrev.resize(m_half);
+    for (unsigned i = 0; i < m_half; i++) {
+        unsigned r = 0;
+        for (unsigned b = 0; b < bits; b++) r |= ((i >> b) & 1) << (bits - 1 - b);
+        m_bitrev[i] = r;
+    }
+
+    m_twRe.assign(m_half, 0.0f);
+    m_twIm.assign(m_half, 0.0f);
+    for (size_t h = 1; h < m_half; h <<= 1) {
+        for (size_t k = 0; k < h; k++) {
+            double a = -pi * (double)k / (double)h;
+            m_twRe[h + k] = (float)std::cos(a);
+            m_twIm[h + k] = (float)std::sin(a);
+        }
+    }
+
+    m_splitRe.resize(m_half);
+    m_splitIm.resize(m_half);
+    for (size_t k = 0; k < m_half; k++) {
+        double a = -2.0 * pi * (double)k / (double)size;
+        m_splitRe[k] = (float)std::cos(a);
+        m_splitIm[k] = (float)std::sin(a);
+    }
+
+    m_re.resize(m_half);
+    m_im.resize(m_half);
+    m_outRe.resize(m_half + 1);
+    m_outIm.resize(m_half + 1);
+    return true;
+}
+
+void RealFft::Complex(float* re, float* im) const {
+    const size_t n = m_half;
+
+    // Half-sizes 1 and 2 together as one radix-4 pass (no twiddle multiplies)
+    for (size_t j = 0; j + 3 < n; j += 4) {
+        float r0 = re[j] + re[j + 1], i0 = im[j] + im[j + 1];
+        float r1 = re[j] - re[j + 1], i1 = im[j] - im[j + 1];
+        float r2 = re[j + 2] + re[j + 3], i2 = im[j + 2] + im[j + 3];
+        float r3 = re[j + 2] - re[j + 3], i3 = im[j + 2] - im[j + 3];
+        // Second stage: twiddles 1 and -i
+        re[j] = r0 + r2;      im[j] = i0 + i2;
+        re[j + 2] = r0 - r2;  im[j + 2] = i0 - i2;
+        re[j + 1] = r1 + i3;  im[j + 1] = i1 - r3;
+        re[j + 3] = r1 - i3;  im[j + 3] = i1 + r3;
+    }
+
+    for (size_t h = 4; h < n; h <<= 1) {
+        const float* wr = m_twRe.data() + h;
+        const float* wi = m_twIm.data() + h;
+        for (size_t j = 0; j < n; j += 2 * h) {
+            float* ar = re + j;
+            float* ai = im + j;
+            float* br = re + j + h;
+            float* bi = im + j + h;
+#ifdef FFT_SSE
+            for (size_t k = 0; k < h; k += 4) {
+                __m128 xr = _mm_loadu_ps(br + k), xi = _mm_loadu_ps(bi + k);
+                __m128 cr = _mm_loadu_ps(wr + k), ci = _mm_loadu_ps(wi + k);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+                __m128 yr = _mm_loadu_ps(ar + k), yi = _mm_loadu_ps(ai + k);
+                _mm_storeu_ps(ar + k, _mm_add_ps(yr, tr));
+                _mm_storeu_ps(ai + k, _mm_add_ps(yi, ti));
+                _mm_storeu_ps(br + k, _mm_sub_ps(yr, tr));
+                _mm_storeu_ps(bi + k, _mm_sub_ps(yi, ti));
+            }
+#else
+            for (size_t k = 0; k < h; k++) {
+                float tr = br[k] * wr[k] - bi[k] * wi[k];
+                float ti = br[k] * wi[k] + bi[k] * wr[k];
+                br[k] = ar[k] - tr;  bi[k] = ai[k] - ti;
+                ar[k] += tr;         ai[k] += ti;
+            }
+#endif
+        }
+    }
+}
+
+void RealFft::Forward(const float* in, float* re, float* im) {
+    const size_t n = m_half;
+    for (size_t i = 0; i < n; i++) {
+        unsigned r = m_bitrev[i];
+        m_re[r] = in[2 * i];
+        m_im[r] = in[2 * i + 1];
+    }
+    Complex(m_re.data(), m_im.data());
+
+    // Split Z (transform of even + i*odd) into the real-input spectrum
+    re[0] = m_re[0] + m_im[0];  im[0] = 0.0f;
+    re[n] = m_re[0] - m_im[0];  im[n] = 0.0f;
+    for (size_t k = 1; k < n; k++) {
+        float zr = m_re[k], zi = m_im[k];
+        float cr = m_re[n - k], ci = -m_im[n - k];      // conj(Z[n - k])
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);  // (Z - conj) / 2i
+        float wr = m_splitRe[k], wi = m_splitIm[k];
+        re[k] = er + or_ * wr - oi * wi;
+        im[k] = ei + or_ * wi + oi * wr;
+    }
+}
+
+void RealFft::Power(const float* in, float* power) {
+    Forward(in, m_outRe.data(), m_outIm.data());
+    for (size_t k = 0; k <= m_half; k++) {
+        power[k] = m_outRe[k] * m_outRe[k] + m_outIm[k] * m_outIm[k];
+    }
+}
+
+void RealFft::Inverse(const float* re, const float* im, float* out) {
+    const size_t n = m_half;
+
+    // Undo the split: Z = E + i*O with E = (X[k] + conj(X[n-k])) / 2,
+    // O = (X[k] - conj(X[n-k])) * conj(W^k) / 2. Conjugated going in and
+    // coming out, the forward transform computes the inverse.
+    for (size_t k = 0; k < n; k++) {
+        float xr = re[k], xi = im[k];
+        float cr = re[n - k], ci = -im[n - k];
+        float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+        float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+        float wr = m_splitRe[k], wi = -m_splitIm[k];
+        float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+        unsigned r = m_bitrev[k];
+        m_re[r] = er - oi;
+        m_im[r] = -(ei + or_);
+    }
+    Complex(m_re.data(), m_im.data());
+
+    const float scale = 1.0f / (float)n;
+    for (size_t i = 0; i < n; i++) {
+        out[2 * i] = m_re[i] * scale;
+        out[2 * i + 1] = -m_im[i] * scale;
+    }
+}
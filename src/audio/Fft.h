@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Real-input FFT for analysis (spectrogram) and STFT filtering (mic noise
+// suppression).
+//
+// A real transform of size N runs as a complex transform of N/2 on the
+// even/odd samples, followed by the usual split step. The complex part is
+// radix-2 decimation-in-time on split re/im arrays, so every stage from
+// half-size 4 upwards is four butterflies per SSE instruction; twiddles
+// are stored per stage, contiguous, to keep those loads aligned.
+//
+// One RealFft per thread: Forward() uses internal scratch buffers.
+class RealFft {
+public:
+    bool Configure(size_t size);    // Power of two, 16..65536
+    size_t GetSize() const { return m_size; }
+
+    // Spectrum of `in` (GetSize() samples): re/im receive GetSize()/2 + 1 bins
+    void Forward(const float* in, float* re, float* im);
+
+    // |X[k]|^2 for k = 0..GetSize()/2
+    void Power(const float* in, float* power);
+
+    // Back to GetSize() real samples from GetSize()/2 + 1 bins (scaled, so
+    // Inverse(Forward(x)) == x)
+    void Inverse(const float* re, const float* im, float* out);
+
+private:
+    void Complex(float* re, float* im) const;
+
+    size_t m_size = 0;
+    size_t m_half = 0;                  // Complex transform size
+    std::vector<unsigned> m_bitrev;     // Index permutation for m_half
+    std::vector<float> m_twRe, m_twIm;  // Stage h uses [h, 2h)
+    std::vector<float> m_splitRe, m_splitIm;    // e^(-2 pi i k / N), k < N/2
+    std::vector<float> m_re, m_im;
+    std::vector<float> m_outRe, m_outIm;
+};
@@ -0,0 +1,119 @@
+#include "audio/ImaAdpcm.h"
+#include <cstring>
+
+namespace ImaAdpcm {
+
+static const int16_t STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static inline int32_t Clamp(int32_t v, int32_t lo, int32_t hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Apply a nibble to the state; shared by encoder and decoder so both
+// reconstruct exactly the same predictor
+static inline int16_t ApplyNibble(ChannelState& s, uint8_t nibble) {
+    int32_t step = STEP_TABLE[s.stepIndex];
+    int32_t diff = step >> 3;
+    if (nibble & 4) diff += step;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 1) diff += step >> 2;
+    s.predictor = Clamp((nibble & 8) ? s.predictor - diff : s.predictor + diff, -32768, 32767);
+    s.stepIndex = Clamp(s.stepIndex + INDEX_TABLE[nibble], 0, 88);
+    return (int16_t)s.predictor;
+}
+
+static inline uint8_t EncodeSample(ChannelState& s, int16_t sample) {
+    int32_t step = STEP_TABLE[s.stepIndex];
+    int32_t diff = sample - s.predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) { nibble = 8; diff = -diff; }
+    if (diff >= step) { nibble |= 4; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 2; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 1; }
+    ApplyNibble(s, nibble);
+    return nibble;
+}
+
+uint16_t GetBlockAlign(uint32_t sampleRate, uint16_t channels) {
+    uint16_t perChannel = sampleRate <= 11025 ? 256 : (sampleRate <= 22050 ? 512 : 1024);
+    return (uint16_t)(perChannel * channels);
+}
+
+uint32_t GetSamplesPerBlock(uint16_t blockAlign, uint16_t channels) {
+    return (uint32_t)(blockAlign - 4 * channels) * 8 / (4 * channels) + 1;
+}
+
+void EncodeBlock(const int16_t* pcm, uint32_t frames, uint16_t channels,
+                 uint16_t blockAlign, ChannelState* state, uint8_t* out) {
+    uint32_t spb = GetSamplesPerBlock(blockAlign, channels);
+    auto sampleAt = [&](uint32_t frame, uint16_t ch) -> int16_t {
+        if (frames == 0) return 0;
+        if (frame >= frames) frame = frames - 1; // Pad short last block
+        return pcm[frame * channels + ch];
+    };
+
+    // Headers: first sample is stored verbatim
+    for (uint16_t ch = 0; ch < channels; ch++) {
+        int16_t first = sampleAt(0, ch);
+        state[ch].predictor = first;
+        memcpy(out + ch * 4, &first, 2);
+        out[ch * 4 + 2] = (uint8_t)state[ch].stepIndex;
+        out[ch * 4 + 3] = 0;
+    }
+
+    uint8_t* p = out + 4 * channels;
+    for (uint32_t frame = 1; frame < spb; frame += 8) {
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            for (int i = 0; i < 8; i += 2) {
+                uint8_t lo = EncodeSample(state[ch], sampleAt(frame + i, ch));
+                uint8_t hi = EncodeSample(state[ch], sampleAt(frame + i + 1, ch));
+                *p++ = (uint8_t)(lo | (hi << 4));
+            }
+        }
+    }
+}
+
+uint32_t DecodeBlock(const uint8_t* in, uint32_t blockBytes, uint16_t channels, int16_t* out) {
+    if (channels == 0 || blockBytes < 4u * channels) return 0;
+
+    ChannelState state[8];
+    if (channels > 8) return 0;
+    for (uint16_t ch = 0; ch < channels; ch++) {
+        int16_t first;
+        memcpy(&first, in + ch * 4, 2);
+        if (in[ch * 4 + 2] > 88) return 0;
+        state[ch].predictor = first;
+        state[ch].stepIndex = in[ch * 4 + 2];
+        out[ch] = first;
+    }
+
+    uint32_t groups = (blockBytes - 4 * channels) / (4 * channels);
+    const uint8_t* p = in + 4 * channels;
+    for (uint32_t g = 0; g < groups; g++) {
+        uint32_t base = 1 + g * 8;
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            for (int i = 0; i < 8; i += 2) {
+                uint8_t b = *p++;
+                out[(base + i) * channels + ch] = ApplyNibble(state[ch], b & 0x0F);
+                out[(base + i + 1) * channels + ch] = ApplyNibble(state[ch], b >> 4);
+            }
+        }
+    }
+    return 1 + groups * 8;
+}
+
+} // namespace ImaAdpcm
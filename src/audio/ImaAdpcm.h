@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// IMA/DVI ADPCM (WAVE_FORMAT_IMA_ADPCM) block codec.
+//
+// 4 bits per sample, so archived 16-bit recordings shrink to ~1/4. The
+// format is decoded natively by Windows (ACM), so archived files keep
+// playing in the player and in Explorer.
+//
+// Block layout per the Microsoft spec: for each channel a 4 byte header
+// (int16 first sample, uint8 step index, uint8 reserved), then the
+// remaining samples as 4 byte groups of 8 nibbles per channel, low nibble
+// first, channels interleaved group by group.
+namespace ImaAdpcm {
+    constexpr uint16_t FORMAT_TAG = 0x0011;
+
+    // Per-channel codec state carried across blocks
+    struct ChannelState {
+        int32_t predictor = 0;
+        int32_t stepIndex = 0;
+    };
+
+    // Conventional block size for a sample rate (256/512/1024 bytes per channel)
+    uint16_t GetBlockAlign(uint32_t sampleRate, uint16_t channels);
+
+    // Frames (samples per channel) stored in one block
+    uint32_t GetSamplesPerBlock(uint16_t blockAlign, uint16_t channels);
+
+    // Encode one block from interleaved 16-bit PCM. frames may be less than
+    // GetSamplesPerBlock() for the last block; the rest is padded with the
+    // last sample. out must hold blockAlign bytes. state has one entry per channel.
+    void EncodeBlock(const int16_t* pcm, uint32_t frames, uint16_t channels,
+                     uint16_t blockAlign, ChannelState* state, uint8_t* out);
+
+    // Decode one block into interleaved 16-bit PCM. out must hold
+    // GetSamplesPerBlock() * channels samples. Returns frames decoded,
+    // 0 if the block is malformed.
+    uint32_t DecodeBlock(const uint8_t* in, uint32_t blockBytes, uint16_t channels, int16_t* out);
+}
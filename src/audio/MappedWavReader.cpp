@@ -0,0 +1,88 @@
+#include "audio/MappedWavReader.h"
+
+static const uint16_t FORMAT_PCM = 0x0001;
+static const uint16_t FORMAT_FLOAT = 0x0003;
+static const uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+static uint32_t ReadU32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+static uint64_t ReadU64(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+bool MappedWavReader::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path)) return false;
+    if (!ParseChunks()) {
+        Close();
+        return false;
+    }
+    m_path = path;
+    return true;
+}
+
+void MappedWavReader::Close() {
+    m_file.Close();
+    m_path.clear();
+    m_info = WavInfo();
+    m_totalFrames = 0;
+    m_rf64 = false;
+}
+
+bool MappedWavReader::ParseChunks() {
+    const uint8_t* data = m_file.GetData();
+    const uint64_t size = m_file.GetSize();
+    if (size < 12 || memcmp(data + 8, "WAVE", 4) != 0) return false;
+    if (memcmp(data, "RF64", 4) == 0) {
+        m_rf64 = true;
+    } else if (memcmp(data, "RIFF", 4) != 0) {
+        return false;
+    }
+
+    uint64_t ds64DataSize = 0;
+    bool haveFmt = false;
+    uint64_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* hdr = data + pos;
+        uint64_t len = ReadU32(hdr + 4);
+        uint64_t payload = pos + 8;
+
+        if (memcmp(hdr, "ds64", 4) == 0 && len >= 16 && payload + 16 <= size) {
+            // riffSize (8), dataSize (8), sampleCount (8), table...
+            ds64DataSize = ReadU64(data + payload + 8);
+        } else if (memcmp(hdr, "fmt ", 4) == 0 && len >= 16 && payload + 16 <= size) {
+            const uint8_t* fmt = data + payload;
+            memcpy(&m_info.formatTag, fmt, 2);
+            memcpy(&m_info.channels, fmt + 2, 2);
+            memcpy(&m_info.sampleRate, fmt + 4, 4);
+            memcpy(&m_info.byteRate, fmt + 8, 4);
+            memcpy(&m_info.blockAlign, fmt + 12, 2);
+            memcpy(&m_info.bitsPerSample, fmt + 14, 2);
+            haveFmt = true;
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            m_info.dataOffset = payload;
+            uint64_t available = size - payload;
+            if (m_rf64 && len == 0xFFFFFFFF) len = ds64DataSize;
+            // Size 0 means the header was never patched (crashed temp file)
+            m_info.dataBytes = (len == 0 || len > available) ? available : len;
+            break; // Everything after the audio is metadata - not needed here
+        }
+        pos = payload + len + (len & 1);
+    }
+
+    if (!haveFmt || m_info.dataOffset == 0 || m_info.blockAlign == 0 || m_info.channels == 0) return false;
+    m_totalFrames = m_info.dataBytes / m_info.blockAlign;
+    return true;
+}
+
+bool MappedWavReader::StoredAs(size_t bytesPerSample, bool isFloat) const {
+    if (m_info.bitsPerSample != bytesPerSample * 8) return false;
+    if (m_info.blockAlign != bytesPerSample * m_info.channels) return false;
+    bool storedFloat = m_info.formatTag == FORMAT_FLOAT ||
+                       (m_info.formatTag == FORMAT_EXTENSIBLE && m_info.bitsPerSample == 32);
+    if (isFloat) return storedFloat;
+    return !storedFloat && (m_info.formatTag == FORMAT_PCM || m_info.formatTag == FORMAT_EXTENSIBLE);
+}
+
+void MappedWavReader::PrefetchFrames(uint64_t startFrame, uint64_t frames) const {
+    if (!IsOpen() || startFrame >= m_totalFrames) return;
+    frames = std::min(frames, m_totalFrames - startFrame);
+    m_file.Prefetch(m_info.dataOffset + startFrame * m_info.blockAlign, frames * m_info.blockAlign);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "audio/WavMetadata.h"
+#include "core/mapped_file.h"
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+
+// Interleaved samples viewed in place inside a mapped file
+template <typename T>
+struct SampleSpan {
+    const T* data = nullptr;
+    size_t frames = 0;
+    uint16_t channels = 0;
+
+    bool empty() const { return data == nullptr || frames == 0; }
+    size_t size() const { return frames * channels; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + size(); }
+    T at(size_t frame, uint16_t channel) const { return data[frame * channels + channel]; }
+};
+
+// Random-access WAV reader over a memory-mapped file.
+//
+// The chunk list is parsed once in Open (RIFF and RF64/ds64, so recordings
+// past 4 GB keep their real size); after that any frame is a pointer
+// offset. GetSamples<T>() hands out zero-copy spans when T matches the
+// stored format (int16_t for 16-bit PCM, float for IEEE float) and the
+// data chunk is suitably aligned - otherwise it returns an empty span and
+// the caller converts from GetFrameBytes() itself.
+//
+// Several readers on the same file share the OS page cache, so the player,
+// peak builder and analysis code can each keep one open cheaply.
+class MappedWavReader {
+public:
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen() && m_info.dataOffset != 0; }
+    bool IsRf64() const { return m_rf64; }
+    const std::string& GetPath() const { return m_path; }
+    const WavInfo& GetInfo() const { return m_info; }
+    uint64_t GetTotalFrames() const { return m_totalFrames; }
+
+    // Start of the data chunk payload (GetInfo().dataBytes long)
+    const uint8_t* GetDataChunk() const { return IsOpen() ? m_file.GetData() + m_info.dataOffset : nullptr; }
+
+    // Raw bytes of frame `frame` (blockAlign each), null past the end
+    const uint8_t* GetFrameBytes(uint64_t frame) const {
+        return frame < m_totalFrames ? m_file.GetData() + m_info.dataOffset + frame * m_info.blockAlign : nullptr;
+    }
+
+    template <typename T>
+    SampleSpan<T> GetSamples(uint64_t startFrame, size_t frames) const {
+        SampleSpan<T> span;
+        if (!IsOpen() || startFrame >= m_totalFrames || !StoredAs(sizeof(T), IsFloatType<T>())) return span;
+        const uint8_t* p = GetFrameBytes(startFrame);
+        if (reinterpret_cast<uintptr_t>(p) % alignof(T) != 0) return span;
+        span.data = reinterpret_cast<const T*>(p);
+        span.frames = (size_t)std::min<uint64_t>(frames, m_totalFrames - startFrame);
+        span.channels = m_info.channels;
+        return span;
+    }
+
+    // Access hints: Sequential for full scans (peaks, transcoding),
+    // Random for scrubbing. PrefetchFrames starts background reads.
+    void SetAccessPattern(MappedFile::Access access) { m_file.SetAccessPattern(access); }
+    void PrefetchFrames(uint64_t startFrame, uint64_t frames) const;
+
+private:
+    template <typename T> static constexpr bool IsFloatType() { return std::is_floating_point<T>::value; }
+    bool StoredAs(size_t bytesPerSample, bool isFloat) const;
+    bool ParseChunks();
+
+    MappedFile m_file;
+    std::string m_path;
+    WavInfo m_info;
+    uint64_t m_totalFrames = 0;
+    bool m_rf64 = false;
+};
@@ -0,0 +1,259 @@
+#include "audio/PeakPyramid.h"
+#include "audio/WavDecoder.h"
+#include "audio/MappedWavReader.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+static const char PEAKS_MAGIC[4] = { 'M', 'M', 'P', 'K' };
+static const uint32_t PEAKS_VERSION = 1;
+
+#pragma pack(push, 1)
+struct PeaksFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t sampleRate;
+    uint16_t channels;
+    uint16_t reserved;
+    uint32_t baseBlock;
+    uint64_t totalFrames;
+    uint64_t entryCount;
+};
+#pragma pack(pop)
+
+static PeakEntry MergeEntries(const PeakEntry& a, const PeakEntry& b) {
+    PeakEntry e;
+    e.min = std::min(a.min, b.min);
+    e.max = std::max(a.max, b.max);
+    e.rms = (uint16_t)std::sqrt(((double)a.rms * a.rms + (double)b.rms * b.rms) / 2.0);
+    return e;
+}
+
+// ============================================================================
+// PeakPyramid
+// ============================================================================
+
+void PeakPyramid::BuildUpperLevels() {
+    m_levels.resize(1);
+    while (m_levels.back().size() > 1) {
+        const std::vector<PeakEntry>& below = m_levels.back();
+        std::vector<PeakEntry> level((below.size() + 1) / 2);
+        for (size_t i = 0; i < level.size(); i++) {
+            level[i] = (2 * i + 1 < below.size()) ? MergeEntries(below[2 * i], below[2 * i + 1]) : below[2 * i];
+        }
+        m_levels.push_back(std::move(level));
+    }
+}
+
+void PeakPyramid::Query(uint64_t startFrame, uint64_t endFrame, size_t columns, std::vector<PeakEntry>& out) const {
+    out.assign(columns, PeakEntry());
+    if (IsEmpty() || columns == 0 || endFrame <= startFrame) return;
+
+    // Coarsest level with at least one entry per column
+    double framesPerColumn = (double)(endFrame - startFrame) / columns;
+    size_t level = 0;
+    while (level + 1 < m_levels.size() && (double)((uint64_t)BASE_BLOCK << (level + 1)) <= framesPerColumn) level++;
+
+    const std::vector<PeakEntry>& entries = m_levels[level];
+    const uint64_t blockFrames = (uint64_t)BASE_BLOCK << level;
+
+    for (size_t c = 0; c < columns; c++) {
+        uint64_t s = startFrame + (uint64_t)(c * framesPerColumn);
+        uint64_t e = startFrame + (uint64_t)((c + 1) * framesPerColumn);
+        size_t first = (size_t)(s / blockFrames);
+        size_t last = (size_t)std::max<uint64_t>(first + 1, (e + blockFrames - 1) / blockFrames);
+        if (first >= entries.size()) continue;
+        last = std::min(last, entries.size());
+
+        // At most ~3 entries per column at the chosen level
+        PeakEntry acc = entries[first];
+        double sumSquares = (double)acc.rms * acc.rms;
+        for (size_t i = first + 1; i < last; i++) {
+            acc.min = std::min(acc.min, entries[i].min);
+            acc.max = std::max(acc.max, entries[i].max);
+            sumSquares += (double)entries[i].rms * entries[i].rms;
+        }
+        acc.rms = (uint16_t)std::sqrt(sumSquares / (last - first));
+        out[c] = acc;
+    }
+}
+
+bool PeakPyramid::Save(const std::string& path) const {
+    if (IsEmpty()) return false;
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        PeaksFileHeader hdr = {};
+        memcpy(hdr.magic, PEAKS_MAGIC, 4);
+        hdr.version = PEAKS_VERSION;
+        hdr.sampleRate = m_sampleRate;
+        hdr.channels = m_channels;
+        hdr.baseBlock = BASE_BLOCK;
+        hdr.totalFrames = m_totalFrames;
+        hdr.entryCount = m_levels[0].size();
+        file.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        file.write(reinterpret_cast<const char*>(m_levels[0].data()), m_levels[0].size() * sizeof(PeakEntry));
+        if (!file.good()) return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool PeakPyramid::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    PeaksFileHeader hdr;
+    if (!file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr))) return false;
+    if (memcmp(hdr.magic, PEAKS_MAGIC, 4) != 0 || hdr.version != PEAKS_VERSION || hdr.baseBlock != BASE_BLOCK) return false;
+    if (hdr.entryCount == 0 || hdr.entryCount > (1ull << 32)) return false;
+
+    std::vector<PeakEntry> level0((size_t)hdr.entryCount);
+    if (!file.read(reinterpret_cast<char*>(level0.data()), level0.size() * sizeof(PeakEntry))) return false;
+
+    m_sampleRate = hdr.sampleRate;
+    m_channels = hdr.channels;
+    m_totalFrames = hdr.totalFrames;
+    m_levels.clear();
+    m_levels.push_back(std::move(level0));
+    BuildUpperLevels();
+    return true;
+}
+
+std::string PeakPyramid::GetSidecarPath(const std::string& wavPath) {
+    std::string path = wavPath;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("\\/");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        path.resize(dot);
+    }
+    return path + ".peaks";
+}
+
+// ============================================================================
+// PeakPyramidBuilder
+// ============================================================================
+
+void PeakPyramidBuilder::Start(uint32_t sampleRate, uint16_t channels) {
+    m_pyramid = PeakPyramid();
+    m_pyramid.m_sampleRate = sampleRate;
+    m_pyramid.m_channels = channels;
+    m_pyramid.m_levels.resize(1);
+    m_channels = channels;
+    m_blockFrames = 0;
+    m_channelIndex = 0;
+    m_min = m_max = 0;
+    m_sumSquares = 0.0;
+}
+
+inline void PeakPyramidBuilder::AddSample(int32_t s) {
+    if (m_blockFrames == 0 && m_channelIndex == 0) {
+        m_min = m_max = s;
+    } else {
+        if (s < m_min) m_min = s;
+        if (s > m_max) m_max = s;
+    }
+    m_sumSquares += (double)s * s;
+
+    if (++m_channelIndex == m_channels) {
+        m_channelIndex = 0;
+        m_pyramid.m_totalFrames++;
+        if (++m_blockFrames == PeakPyramid::BASE_BLOCK) CloseBlock();
+    }
+}
+
+void PeakPyramidBuilder::CloseBlock() {
+    if (m_blockFrames == 0) return;
+    PeakEntry e;
+    e.min = (int16_t)std::max(-32768, std::min(32767, m_min));
+    e.max = (int16_t)std::max(-32768, std::min(32767, m_max));
+    e.rms = (uint16_t)std::min(32767.0, std::sqrt(m_sumSquares / ((double)m_blockFrames * m_channels)));
+    m_pyramid.m_levels[0].push_back(e);
+    m_blockFrames = 0;
+    m_sumSquares = 0.0;
+}
+
+void PeakPyramidBuilder::AddPcm16(const int16_t* samples, size_t frames) {
+    if (!IsStarted()) return;
+    size_t count = frames * m_channels;
+    for (size_t i = 0; i < count; i++) AddSample(samples[i]);
+}
+
+void PeakPyramidBuilder::AddFloat(const float* samples, size_t frames) {
+    if (!IsStarted()) return;
+    size_t count = frames * m_channels;
+    for (size_t i = 0; i < count; i++) AddSample((int32_t)std::lrint(samples[i] * 32768.0f));
+}
+
+PeakPyramid PeakPyramidBuilder::Finish() {
+    CloseBlock();
+    if (m_pyramid.m_levels.empty() || m_pyramid.m_levels[0].empty()) {
+        m_pyramid.m_levels.clear();
+    } else {
+        m_pyramid.BuildUpperLevels();
+    }
+    m_channels = 0;
+    return std::move(m_pyramid);
+}
+
+bool PeakPyramidBuilder::BuildFromWav(const std::string& wavPath, PeakPyramid& out) {
+    // 16-bit PCM (everything the recorder writes) is summarised in place
+    // from the mapped file, with no decode or copy
+    MappedWavReader reader;
+    if (reader.Open(wavPath) && !reader.GetSamples<int16_t>(0, 1).empty()) {
+        PeakPyramidBuilder builder;
+        builder.Start(reader.GetInfo().sampleRate, reader.GetInfo().channels);
+        builder.m_pyramid.m_levels[0].reserve((size_t)(reader.GetTotalFrames() / PeakPyramid::BASE_BLOCK + 1));
+        reader.SetAccessPattern(MappedFile::Access::Sequential);
+
+        const size_t chunkFrames = PeakPyramid::BASE_BLOCK * 1024;
+        for (uint64_t frame = 0; frame < reader.GetTotalFrames(); frame += chunkFrames) {
+            reader.PrefetchFrames(frame + chunkFrames, chunkFrames);
+            SampleSpan<int16_t> span = reader.GetSamples<int16_t>(frame, chunkFrames);
+            builder.AddPcm16(span.data, span.frames);
+        }
+        out = builder.Finish();
+        return !out.IsEmpty();
+    }
+    reader.Close();
+
+    WavDecoder decoder;
+    if (!decoder.Open(wavPath)) return false;
+
+    PeakPyramidBuilder builder;
+    builder.Start(decoder.GetSampleRate(), decoder.GetChannels());
+    builder.m_pyramid.m_levels[0].reserve((size_t)(decoder.GetTotalFrames() / PeakPyramid::BASE_BLOCK + 1));
+
+    // Whole blocks per read keeps the block accounting out of the hot loop's way
+    std::vector<float> buffer((size_t)PeakPyramid::BASE_BLOCK * 64 * decoder.GetChannels());
+    size_t frames;
+    while ((frames = decoder.Read(buffer.data(), PeakPyramid::BASE_BLOCK * 64)) > 0) {
+        builder.AddFloat(buffer.data(), frames);
+    }
+
+    out = builder.Finish();
+    return !out.IsEmpty();
+}
+
+bool LoadOrBuildPeaks(const std::string& wavPath, PeakPyramid& out) {
+    WavDecoder decoder;
+    if (!decoder.Open(wavPath)) return false;
+
+    // Valid if it describes the same audio (archived ADPCM files may be a
+    // partial block longer than the original)
+    std::string sidecar = PeakPyramid::GetSidecarPath(wavPath);
+    if (out.Load(sidecar) && out.GetSampleRate() == decoder.GetSampleRate()) {
+        uint64_t a = out.GetTotalFrames(), b = decoder.GetTotalFrames();
+        if ((a > b ? a - b : b - a) < 4096) return true;
+    }
+    bool encrypted = decoder.IsEncrypted();
+    decoder.Close();
+
+    if (!PeakPyramidBuilder::BuildFromWav(wavPath, out)) return false;
+    if (!encrypted) out.Save(sidecar); // Nothing derived from the audio in plaintext
+    return true;
+}
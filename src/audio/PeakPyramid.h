@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Min/max/RMS summary of one block of audio (all channels folded together)
+struct PeakEntry {
+    int16_t  min = 0;
+    int16_t  max = 0;
+    uint16_t rms = 0;       // 0..32767
+
+    float GetPeak() const {  // 0..1
+        int a = min < 0 ? -(int)min : min;
+        int b = max < 0 ? -(int)max : max;
+        return (a > b ? a : b) / 32768.0f;
+    }
+};
+
+// Multi-resolution waveform summary.
+//
+// Level 0 holds one entry per BASE_BLOCK frames; every level above merges
+// pairs of the one below, so level L covers BASE_BLOCK << L frames per
+// entry. Query picks the coarsest level that still has at least one entry
+// per output column, which makes drawing cost O(columns) at any zoom,
+// whatever the length of the recording.
+//
+// Stored next to the recording as <name>.peaks (level 0 only; the upper
+// levels are rebuilt on load, which is a single pass over level 0).
+class PeakPyramid {
+public:
+    static constexpr uint32_t BASE_BLOCK = 256;
+
+    bool IsEmpty() const { return m_levels.empty(); }
+    uint32_t GetSampleRate() const { return m_sampleRate; }
+    uint16_t GetChannels() const { return m_channels; }
+    uint64_t GetTotalFrames() const { return m_totalFrames; }
+    size_t GetLevelCount() const { return m_levels.size(); }
+    const std::vector<PeakEntry>& GetLevel(size_t level) const { return m_levels[level]; }
+
+    // Summaries of [startFrame, endFrame) split into `columns` equal parts
+    void Query(uint64_t startFrame, uint64_t endFrame, size_t columns, std::vector<PeakEntry>& out) const;
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+    static std::string GetSidecarPath(const std::string& wavPath);
+
+private:
+    friend class PeakPyramidBuilder;
+    void BuildUpperLevels();
+
+    uint32_t m_sampleRate = 0;
+    uint16_t m_channels = 0;
+    uint64_t m_totalFrames = 0;
+    std::vector<std::vector<PeakEntry>> m_levels;
+};
+
+// Builds level 0 incrementally as audio arrives (recorder) or from an
+// existing file (player, batch tool).
+class PeakPyramidBuilder {
+public:
+    void Start(uint32_t sampleRate, uint16_t channels);
+    void AddPcm16(const int16_t* samples, size_t frames);
+    void AddFloat(const float* samples, size_t frames);
+    bool IsStarted() const { return m_channels != 0; }
+
+    // Flushes the partial last block and builds the upper levels
+    PeakPyramid Finish();
+
+    // Fast path for existing recordings (any format WavDecoder reads)
+    static bool BuildFromWav(const std::string& wavPath, PeakPyramid& out);
+
+private:
+    void AddSample(int32_t s);
+    void CloseBlock();
+
+    PeakPyramid m_pyramid;
+    uint16_t m_channels = 0;
+    uint32_t m_blockFrames = 0;
+    uint16_t m_channelIndex = 0;
+    int32_t m_min = 0, m_max = 0;
+    double m_sumSquares = 0.0;
+};
+
+// Load <wav>.peaks if it matches the recording, otherwise build it from
+// the audio and save it for next time
+bool LoadOrBuildPeaks(const std::string& wavPath, PeakPyramid& out);
@@ -0,0 +1,501 @@
+#include "audio/PlaybackEngine.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#include "audio/WasapiOutput.h"
+#endif
+
+static const size_t DECODE_CHUNK_FRAMES = 4096;
+static const auto POSITION_INTERVAL = std::chrono::milliseconds(33);
+
+// ============================================================================
+// NullAudioOutput
+// ============================================================================
+
+bool NullAudioOutput::Open(uint32_t sampleRate, uint16_t channels, RenderCallback render) {
+    Close();
+    if (sampleRate == 0 || channels == 0 || !render) return false;
+
+    m_running = true;
+    m_thread = std::thread([this, sampleRate, channels, render]() {
+        // 10 ms device period
+        size_t period = std::max<size_t>(1, sampleRate / 100);
+        std::vector<float> buffer(period * channels);
+        auto next = std::chrono::steady_clock::now();
+        while (m_running) {
+            render(buffer.data(), period);
+            m_framesRendered += period;
+            if (m_realtime) {
+                next += std::chrono::microseconds(period * 1000000ull / sampleRate);
+                std::this_thread::sleep_until(next);
+            }
+        }
+    });
+    return true;
+}
+
+void NullAudioOutput::Close() {
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+std::unique_ptr<AudioOutput> CreateDefaultAudioOutput() {
+#ifdef _WIN32
+    return std::make_unique<WasapiOutput>();
+#else
+    return std::make_unique<NullAudioOutput>(true);
+#endif
+}
+
+// ============================================================================
+// PlaybackEngine - control (any thread)
+// ============================================================================
+
+PlaybackEngine::PlaybackEngine(std::unique_ptr<AudioOutput> output)
+    : m_output(output ? std::move(output) : CreateDefaultAudioOutput())
+{
+    m_thread = std::thread(&PlaybackEngine::DecoderLoop, this);
+}
+
+PlaybackEngine::~PlaybackEngine() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void PlaybackEngine::SetCallbacks(const PlaybackCallbacks& callbacks) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callbacks = callbacks;
+}
+
+bool PlaybackEngine::Play(const std::string& path, uint64_t startFrame) {
+    // Parse the header here so the caller gets a synchronous answer
+    auto decoder = std::make_unique<WavDecoder>();
+    if (!decoder->Open(path)) return false;
+
+    m_totalFrames = decoder->GetTotalFrames();
+    m_sampleRate = decoder->GetSampleRate();
+    m_positionFrames = std::min(startFrame, decoder->GetTotalFrames());
+    {
+        std::lock_guard<std::mutex> lock(m_pathMutex);
+        m_currentPath = path;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingOpen = std::move(decoder);
+        m_pendingStartFrame = startFrame;
+        m_pendingSeek = -1;
+        m_stopRequested = false;
+    }
+    m_paused = false;
+    m_playing = true;
+    m_cv.notify_all();
+    return true;
+}
+
+void PlaybackEngine::QueueNext(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingNext = path;
+        m_nextChanged = true;
+    }
+    m_cv.notify_all();
+}
+
+void PlaybackEngine::Pause() {
+    if (m_playing) m_paused = true;
+}
+
+void PlaybackEngine::Resume() {
+    m_paused = false;
+}
+
+void PlaybackEngine::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingOpen.reset();
+        m_pendingSeek = -1;
+        m_stopRequested = true;
+    }
+    m_playing = false;
+    m_paused = false;
+    m_positionFrames = 0;
+    m_totalFrames = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_pathMutex);
+        m_currentPath.clear();
+    }
+    m_cv.notify_all();
+}
+
+void PlaybackEngine::Seek(uint64_t frame) {
+    if (!m_playing) return;
+    frame = std::min(frame, (uint64_t)m_totalFrames);
+    m_positionFrames = frame;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingSeek = (int64_t)frame;
+    }
+    m_cv.notify_all();
+}
+
+void PlaybackEngine::SeekMs(uint32_t ms) {
+    Seek((uint64_t)ms * m_sampleRate / 1000);
+}
+
+void PlaybackEngine::SetSpeed(double speed) {
+    speed = std::max(TimeStretcher::MIN_SPEED, std::min(TimeStretcher::MAX_SPEED, speed));
+    m_speed = speed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingSpeed = speed;
+    }
+    m_cv.notify_all();
+}
+
+void PlaybackEngine::SetVolume(float volume) {
+    m_volume = std::max(0.0f, std::min(1.0f, volume));
+}
+
+std::string PlaybackEngine::GetCurrentPath() const {
+    std::lock_guard<std::mutex> lock(m_pathMutex);
+    return m_currentPath;
+}
+
+uint32_t PlaybackEngine::GetPositionMs() const {
+    uint32_t rate = m_sampleRate;
+    return rate ? (uint32_t)(m_positionFrames * 1000 / rate) : 0;
+}
+
+uint32_t PlaybackEngine::GetDurationMs() const {
+    uint32_t rate = m_sampleRate;
+    return rate ? (uint32_t)(m_totalFrames * 1000 / rate) : 0;
+}
+
+// ============================================================================
+// Output thread
+// ============================================================================
+
+void PlaybackEngine::Render(float* out, size_t frames) {
+    size_t samples = frames * m_outChannels.load(std::memory_order_relaxed);
+
+    // Seek/track switch: drop whatever was decoded before it
+    uint64_t flushTo = m_flushTo.load(std::memory_order_acquire);
+    if (m_ring.GetReadIndex() < flushTo) m_ring.SkipTo(flushTo);
+
+    size_t got = m_paused ? 0 : m_ring.Read(out, samples);
+    std::fill(out + got, out + samples, 0.0f);
+    if (!m_paused && got < samples && m_ring.GetWriteIndex() > flushTo &&
+        !m_drained.load(std::memory_order_relaxed)) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    float volume = m_volume.load(std::memory_order_relaxed);
+    if (volume < 0.999f) {
+        for (size_t i = 0; i < got; i++) out[i] *= volume;
+    }
+}
+
+// ============================================================================
+// Decoder thread
+// ============================================================================
+
+bool PlaybackEngine::OpenOutput(uint32_t sampleRate, uint16_t channels) {
+    CloseOutput();
+    // About half a second of audio between decoder and device
+    m_ring.Reset((size_t)sampleRate * channels / 2);
+    m_flushTo = 0;
+    m_markers.clear();
+    m_outChannels = channels;
+    m_outRate = sampleRate;
+    m_stretch.Configure(sampleRate, channels);
+    m_stretch.SetSpeed(m_appliedSpeed);
+    m_outputOpen = m_output->Open(sampleRate, channels, [this](float* out, size_t frames) { Render(out, frames); });
+    return m_outputOpen;
+}
+
+void PlaybackEngine::CloseOutput() {
+    if (m_outputOpen) m_output->Close();
+    m_outputOpen = false;
+    m_outRate = 0;
+}
+
+void PlaybackEngine::PushMarker(uint64_t frame, uint64_t ringIndex) {
+    Marker marker;
+    marker.ringIndex = ringIndex;
+    marker.frame = frame;
+    marker.speed = m_appliedSpeed;
+    marker.track = m_currentTrack;
+    m_markers.push_back(marker);
+}
+
+void PlaybackEngine::Flush(uint64_t frame) {
+    m_flushTo.store(m_ring.GetWriteIndex(), std::memory_order_release);
+    m_markers.clear();
+    PushMarker(frame, m_ring.GetWriteIndex());
+    m_eof = false;
+    m_drained = false;
+    m_stretch.Reset();
+    m_stretchPadded = false;
+}
+
+void PlaybackEngine::StartTrack(std::unique_ptr<WavDecoder> decoder, uint64_t startFrame) {
+    m_current = std::move(decoder);
+    m_current->Seek(startFrame);
+
+    auto track = std::make_shared<TrackInfo>();
+    track->path = m_current->GetPath();
+    track->totalFrames = m_current->GetTotalFrames();
+    track->sampleRate = m_current->GetSampleRate();
+    m_currentTrack = track;
+
+    bool sameFormat = m_outputOpen && m_outRate == m_current->GetSampleRate() &&
+                      m_outChannels == m_current->GetChannels();
+    if (!sameFormat && !OpenOutput(m_current->GetSampleRate(), m_current->GetChannels())) {
+        m_current.reset();
+        return;
+    }
+    Flush(m_current->GetPosition());
+}
+
+void PlaybackEngine::Fill() {
+    if (!m_current || !m_outputOpen || m_eof) return;
+    if (Stretching()) {
+        FillStretched();
+        return;
+    }
+
+    const uint16_t channels = m_outChannels;
+    m_scratch.resize(DECODE_CHUNK_FRAMES * channels);
+
+    for (;;) {
+        size_t space = m_ring.GetWriteAvailable() / channels;
+        if (space < 256) return;
+
+        size_t n = m_current->Read(m_scratch.data(), std::min(space, DECODE_CHUNK_FRAMES));
+        if (n > 0) {
+            m_ring.Write(m_scratch.data(), n * channels);
+            continue;
+        }
+
+        // End of file: continue straight into the queued one if the device
+        // format allows it (gapless), otherwise wait for the ring to drain
+        if (m_next && m_next->GetSampleRate() == m_outRate && m_next->GetChannels() == channels) {
+            m_current = std::move(m_next);
+            auto track = std::make_shared<TrackInfo>();
+            track->path = m_current->GetPath();
+            track->totalFrames = m_current->GetTotalFrames();
+            track->sampleRate = m_current->GetSampleRate();
+            m_currentTrack = track;
+            PushMarker(0, m_ring.GetWriteIndex());
+            continue;
+        }
+        m_eof = true;
+        m_drained = true;
+        return;
+    }
+}
+
+// Decoder -> TimeStretcher -> ring. The stretcher holds some input back
+// (one window plus the search range), so a gapless switch is marked at the
+// ring index where the next file's first frame will come out, and the last
+// file is followed by a window of silence to flush its tail.
+void PlaybackEngine::FillStretched() {
+    const uint16_t channels = m_outChannels;
+    const size_t hop = m_stretch.GetHopFrames();
+    m_scratch.resize(DECODE_CHUNK_FRAMES * channels);
+    m_stretchOut.resize(std::max(DECODE_CHUNK_FRAMES, hop) * channels);
+
+    for (;;) {
+        size_t space = m_ring.GetWriteAvailable() / channels;
+        if (space < hop) return;
+
+        if (m_stretch.GetInputRequired() == 0) {
+            size_t n = m_stretch.Process(m_stretchOut.data(), std::min(space, m_stretchOut.size() / channels));
+            m_ring.Write(m_stretchOut.data(), n * channels);
+            continue;
+        }
+
+        size_t n = m_current->Read(m_scratch.data(), DECODE_CHUNK_FRAMES);
+        if (n > 0) {
+            m_stretch.PushInput(m_scratch.data(), n);
+            continue;
+        }
+
+        if (m_next && m_next->GetSampleRate() == m_outRate && m_next->GetChannels() == channels) {
+            double pending = (double)m_stretch.GetInputEnd() - m_stretch.GetInputPosition();
+            uint64_t ringIndex = m_ring.GetWriteIndex() + (uint64_t)std::max(0.0, pending / m_appliedSpeed) * channels;
+            m_current = std::move(m_next);
+            auto track = std::make_shared<TrackInfo>();
+            track->path = m_current->GetPath();
+            track->totalFrames = m_current->GetTotalFrames();
+            track->sampleRate = m_current->GetSampleRate();
+            m_currentTrack = track;
+            PushMarker(0, ringIndex);
+            continue;
+        }
+        if (!m_stretchPadded) {
+            std::fill(m_scratch.begin(), m_scratch.end(), 0.0f);
+            size_t pad = std::min(m_stretch.GetInputRequired(), DECODE_CHUNK_FRAMES);
+            m_stretch.PushInput(m_scratch.data(), pad);
+            m_stretchPadded = m_stretch.GetInputRequired() == 0;
+            continue;
+        }
+        m_eof = true;
+        m_drained = true;
+        return;
+    }
+}
+
+void PlaybackEngine::ReportPosition() {
+    if (m_markers.empty()) return;
+
+    uint64_t channels = m_outChannels;
+    uint64_t consumed = m_ring.GetReadIndex();
+    uint64_t latency = (uint64_t)m_output->GetLatencyFrames() * channels;
+    uint64_t heard = consumed > latency ? consumed - latency : 0;
+
+    while (m_markers.size() > 1 && m_markers[1].ringIndex <= heard) m_markers.pop_front();
+    const Marker& marker = m_markers.front();
+    const TrackInfo& track = *marker.track;
+
+    uint64_t frame = marker.frame;
+    if (heard > marker.ringIndex) frame += (uint64_t)((heard - marker.ringIndex) / channels * marker.speed);
+    frame = std::min(frame, track.totalFrames);
+
+    bool changed = marker.track != m_reportedTrack;
+    if (changed) {
+        m_reportedTrack = marker.track;
+        m_totalFrames = track.totalFrames;
+        m_sampleRate = track.sampleRate;
+        std::lock_guard<std::mutex> lock(m_pathMutex);
+        m_currentPath = track.path;
+    }
+    m_positionFrames = frame;
+
+    PlaybackCallbacks callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        callbacks = m_callbacks;
+    }
+    if (changed && callbacks.onTrackChanged) callbacks.onTrackChanged(track.path);
+    if (callbacks.onPosition) callbacks.onPosition(track.path, frame, track.totalFrames, track.sampleRate);
+}
+
+void PlaybackEngine::DecoderLoop() {
+    auto lastReport = std::chrono::steady_clock::now();
+
+    for (;;) {
+        std::unique_ptr<WavDecoder> open;
+        uint64_t startFrame = 0;
+        int64_t seek = -1;
+        double speed = -1.0;
+        bool stop = false;
+        bool nextChanged = false;
+        std::string nextPath;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // Short wait: the ring drains ~0.5 s ahead, so 10 ms polling keeps it full
+            m_cv.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                return m_quit || m_pendingOpen || m_pendingSeek >= 0 || m_pendingSpeed >= 0 || m_stopRequested || m_nextChanged;
+            });
+            if (m_quit) break;
+            open = std::move(m_pendingOpen);
+            startFrame = m_pendingStartFrame;
+            seek = m_pendingSeek;
+            speed = m_pendingSpeed;
+            stop = m_stopRequested;
+            nextChanged = m_nextChanged;
+            nextPath = m_pendingNext;
+            m_pendingSeek = -1;
+            m_pendingSpeed = -1.0;
+            m_stopRequested = false;
+            m_nextChanged = false;
+        }
+        if (speed >= 0) m_wantedSpeed = speed;
+
+        if (stop) {
+            CloseOutput();
+            m_current.reset();
+            m_next.reset();
+            m_markers.clear();
+            m_currentTrack.reset();
+            m_reportedTrack.reset();
+            continue;
+        }
+
+        if (open) {
+            m_reportedTrack.reset();
+            StartTrack(std::move(open), startFrame);
+            // Explicit Play - the caller already knows the track changed
+            if (!m_markers.empty()) m_reportedTrack = m_markers.back().track;
+            if (!m_current) {
+                m_playing = false;
+                PlaybackCallbacks callbacks;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    callbacks = m_callbacks;
+                }
+                if (callbacks.onEnded) callbacks.onEnded();
+            }
+        }
+
+        if (nextChanged) {
+            m_next.reset();
+            if (!nextPath.empty()) {
+                auto decoder = std::make_unique<WavDecoder>();
+                if (decoder->Open(nextPath)) m_next = std::move(decoder);
+            }
+        }
+
+        if (seek >= 0 && m_current) {
+            m_current->Seek((uint64_t)seek);
+            Flush(m_current->GetPosition());
+        }
+
+        // Speed change: re-buffer from the frame being heard. Deferred while
+        // the ring still holds the end of the previous file.
+        if (m_wantedSpeed != m_appliedSpeed && (!m_current || m_reportedTrack == m_currentTrack)) {
+            m_appliedSpeed = m_wantedSpeed;
+            m_stretch.SetSpeed(m_appliedSpeed);
+            if (m_current) {
+                ReportPosition();
+                m_current->Seek(m_positionFrames);
+                Flush(m_current->GetPosition());
+            }
+        }
+
+        Fill();
+
+        auto now = std::chrono::steady_clock::now();
+        if (m_current && now - lastReport >= POSITION_INTERVAL) {
+            lastReport = now;
+            ReportPosition();
+        }
+
+        // Played everything that was decoded
+        if (m_current && m_eof && m_ring.GetReadIndex() >= m_ring.GetWriteIndex()) {
+            if (m_next) {
+                // Different format - reopen the device for it
+                StartTrack(std::move(m_next), 0);
+                continue;
+            }
+            ReportPosition();
+            m_current.reset();
+            m_playing = false;
+            m_paused = false;
+            PlaybackCallbacks callbacks;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                callbacks = m_callbacks;
+            }
+            if (callbacks.onEnded) callbacks.onEnded();
+        }
+    }
+
+    CloseOutput();
+}
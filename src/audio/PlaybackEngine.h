@@ -0,0 +1,196 @@
+#pragma once
+
+#include "audio/WavDecoder.h"
+#include "audio/TimeStretch.h"
+#include "core/spsc_ring.h"
+#include <string>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+// Audio device abstraction. The output runs its own thread from Open to
+// Close and pulls interleaved float frames through the render callback.
+class AudioOutput {
+public:
+    using RenderCallback = std::function<void(float* out, size_t frames)>;
+
+    virtual ~AudioOutput() = default;
+    virtual bool Open(uint32_t sampleRate, uint16_t channels, RenderCallback render) = 0;
+    virtual void Close() = 0;
+    // Frames handed to the device but not yet heard
+    virtual uint32_t GetLatencyFrames() const = 0;
+};
+
+// Discards audio. realtime = true paces the pulls like a real device,
+// false pulls as fast as possible (benchmarking the decode path).
+class NullAudioOutput : public AudioOutput {
+public:
+    explicit NullAudioOutput(bool realtime = true) : m_realtime(realtime) {}
+    ~NullAudioOutput() override { Close(); }
+
+    bool Open(uint32_t sampleRate, uint16_t channels, RenderCallback render) override;
+    void Close() override;
+    uint32_t GetLatencyFrames() const override { return 0; }
+
+    uint64_t GetFramesRendered() const { return m_framesRendered; }
+
+private:
+    bool m_realtime;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_framesRendered{0};
+};
+
+// WASAPI on Windows, NullAudioOutput elsewhere
+std::unique_ptr<AudioOutput> CreateDefaultAudioOutput();
+
+// Events are raised on the engine's decoder thread - marshal to the UI
+// thread (PostMessage) before touching windows.
+struct PlaybackCallbacks {
+    // About 30 times a second while a file is loaded
+    std::function<void(const std::string& path, uint64_t frame, uint64_t totalFrames, uint32_t sampleRate)> onPosition;
+    // The audible file changed on its own (gapless advance to the queued file)
+    std::function<void(const std::string& path)> onTrackChanged;
+    // Reached the end with nothing queued
+    std::function<void()> onEnded;
+};
+
+// In-process streaming player.
+//
+//   decoder thread:  WavDecoder (read-ahead) -> float frames -> SpscRing
+//   output thread:   SpscRing -> volume -> device
+//
+// The ring holds ~0.5 s, so the output thread never touches the disk or
+// takes a lock. Positions are tracked as ring indices: every track start
+// or seek pushes a marker (ring index -> file frame), and the frame being
+// heard is the consumed index minus the device latency mapped through the
+// markers. That gives sample-accurate seek and position reports.
+//
+// Play() on a file with the same format as the current one swaps the
+// decoder without reopening the device; QueueNext() continues into the
+// next file with no gap at all.
+//
+// At speeds other than 1x the decoded audio goes through a TimeStretcher
+// on the decoder thread before reaching the ring, and markers carry the
+// speed so ring positions still map back to file frames.
+class PlaybackEngine {
+public:
+    explicit PlaybackEngine(std::unique_ptr<AudioOutput> output = nullptr);
+    ~PlaybackEngine();
+
+    PlaybackEngine(const PlaybackEngine&) = delete;
+    PlaybackEngine& operator=(const PlaybackEngine&) = delete;
+
+    void SetCallbacks(const PlaybackCallbacks& callbacks);
+
+    // Start playing path at startFrame. Returns false if it can't be decoded.
+    bool Play(const std::string& path, uint64_t startFrame = 0);
+    // File to continue with when the current one ends ("" clears)
+    void QueueNext(const std::string& path);
+
+    void Pause();
+    void Resume();
+    void Stop();
+    void Seek(uint64_t frame);
+    void SeekMs(uint32_t ms);
+    void SetVolume(float volume);   // 0..1
+    // 0.5..3.0, pitch preserved. Takes effect immediately (re-buffers from
+    // the frame being heard).
+    void SetSpeed(double speed);
+    double GetSpeed() const { return m_speed; }
+
+    bool IsPlaying() const { return m_playing && !m_paused; }
+    bool IsPaused() const { return m_playing && m_paused; }
+    std::string GetCurrentPath() const;
+    uint64_t GetPositionFrames() const { return m_positionFrames; }
+    uint64_t GetTotalFrames() const { return m_totalFrames; }
+    uint32_t GetSampleRate() const { return m_sampleRate; }
+    uint32_t GetPositionMs() const;
+    uint32_t GetDurationMs() const;
+
+    // Device periods that found the ring short while playing. The wait
+    // for the first block after a start or seek and the end of the last
+    // file don't count.
+    uint64_t GetUnderruns() const { return m_underruns; }
+
+private:
+    struct TrackInfo {
+        std::string path;
+        uint64_t totalFrames = 0;
+        uint32_t sampleRate = 0;
+    };
+    struct Marker {
+        uint64_t ringIndex = 0;   // Sample index in the ring stream
+        uint64_t frame = 0;       // File frame at that index
+        double speed = 1.0;       // File frames per output frame from here on
+        std::shared_ptr<TrackInfo> track;
+    };
+
+    void DecoderLoop();
+    void StartTrack(std::unique_ptr<WavDecoder> decoder, uint64_t startFrame);
+    bool OpenOutput(uint32_t sampleRate, uint16_t channels);
+    void CloseOutput();
+    void Flush(uint64_t frame);
+    void PushMarker(uint64_t frame, uint64_t ringIndex);
+    bool Stretching() const { return m_appliedSpeed != 1.0; }
+    void FillStretched();
+    void Fill();
+    void ReportPosition();
+    void Render(float* out, size_t frames);
+
+    std::unique_ptr<AudioOutput> m_output;
+    PlaybackCallbacks m_callbacks;
+
+    // Output thread <-> decoder thread
+    SpscRing<float> m_ring;
+    std::atomic<uint64_t> m_flushTo{0};   // Consumer skips ring data before this index
+    std::atomic<uint16_t> m_outChannels{0};
+    std::atomic<float> m_volume{1.0f};
+    std::atomic<bool> m_paused{false};
+    std::atomic<bool> m_drained{false};   // Decoder reached the end of the last file
+    std::atomic<uint64_t> m_underruns{0};
+
+    // Commands (guarded by m_mutex)
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::unique_ptr<WavDecoder> m_pendingOpen;
+    uint64_t m_pendingStartFrame = 0;
+    bool m_nextChanged = false;
+    std::string m_pendingNext;
+    int64_t m_pendingSeek = -1;
+    double m_pendingSpeed = -1.0;
+    bool m_stopRequested = false;
+    bool m_quit = false;
+    std::thread m_thread;
+
+    // Decoder thread state
+    std::unique_ptr<WavDecoder> m_current;
+    std::unique_ptr<WavDecoder> m_next;
+    std::shared_ptr<TrackInfo> m_currentTrack;
+    std::shared_ptr<TrackInfo> m_reportedTrack;
+    std::deque<Marker> m_markers;
+    std::vector<float> m_scratch;
+    TimeStretcher m_stretch;
+    std::vector<float> m_stretchOut;
+    double m_appliedSpeed = 1.0;
+    double m_wantedSpeed = 1.0;
+    bool m_stretchPadded = false;   // Tail padding pushed after the last file
+    uint32_t m_outRate = 0;
+    bool m_outputOpen = false;
+    bool m_eof = false;
+
+    // Snapshot for the getters
+    std::atomic<bool> m_playing{false};
+    std::atomic<uint64_t> m_positionFrames{0};
+    std::atomic<uint64_t> m_totalFrames{0};
+    std::atomic<uint32_t> m_sampleRate{0};
+    std::atomic<double> m_speed{1.0};
+    mutable std::mutex m_pathMutex;
+    std::string m_currentPath;
+};
@@ -0,0 +1,145 @@
+#include "audio/RecordingHandoff.h"
+#include "audio/WasapiRecorder.h"
+#include "core/trace.h"
+#include <algorithm>
+#include <cstdio>
+
+static double ElapsedMs(RecordingHandoff::Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(RecordingHandoff::Clock::now() - since).count();
+}
+
+static std::string FormatMs(double ms) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.2f", ms);
+    return buf;
+}
+
+std::string HandoffStats::ToJson() const {
+    std::string json = "{";
+    json += "\"stops\":" + std::to_string(stops);
+    json += ",\"lastStopToReadyMs\":" + FormatMs(lastStopToReadyMs);
+    json += ",\"maxStopToReadyMs\":" + FormatMs(maxStopToReadyMs);
+    json += ",\"avgStopToReadyMs\":" + FormatMs(avgStopToReadyMs);
+    json += ",\"lastFinalizeMs\":" + FormatMs(lastFinalizeMs);
+    json += ",\"maxFinalizeMs\":" + FormatMs(maxFinalizeMs);
+    json += ",\"lastStopToSavedMs\":" + FormatMs(lastStopToSavedMs);
+    json += ",\"pending\":" + std::to_string(pending);
+    json += ",\"overlapped\":" + std::to_string(overlapped);
+    json += ",\"recordersCreated\":" + std::to_string(recordersCreated);
+    json += "}";
+    return json;
+}
+
+RecordingHandoff::RecordingHandoff() {
+    m_worker = std::thread(&RecordingHandoff::WorkerLoop, this);
+}
+
+RecordingHandoff::~RecordingHandoff() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    if (m_worker.joinable()) m_worker.join();   // Finishes whatever is queued first
+    for (WasapiRecorder* recorder : m_idle) delete recorder;
+    m_idle.clear();
+}
+
+WasapiRecorder* RecordingHandoff::Acquire() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idle.empty()) {
+            WasapiRecorder* recorder = m_idle.back();
+            m_idle.pop_back();
+            return recorder;
+        }
+        m_stats.recordersCreated++;
+    }
+    return new WasapiRecorder();
+}
+
+void RecordingHandoff::Release(WasapiRecorder* recorder) {
+    if (!recorder) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_idle.size() < MAX_IDLE_RECORDERS) {
+            m_idle.push_back(recorder);
+            return;
+        }
+    }
+    delete recorder;
+}
+
+void RecordingHandoff::Complete(WasapiRecorder* recorder, FinishFn finish, Clock::time_point stopTime) {
+    if (!recorder) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({ recorder, std::move(finish), stopTime });
+    }
+    m_cv.notify_one();
+}
+
+void RecordingHandoff::MarkReady(Clock::time_point stopTime) {
+    double ms = ElapsedMs(stopTime);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.stops++;
+    m_stats.lastStopToReadyMs = ms;
+    m_stats.maxStopToReadyMs = std::max(m_stats.maxStopToReadyMs, ms);
+    m_totalStopToReadyMs += ms;
+    m_stats.avgStopToReadyMs = m_totalStopToReadyMs / m_stats.stops;
+}
+
+void RecordingHandoff::MarkStarted() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_busy || !m_jobs.empty()) m_stats.overlapped++;
+}
+
+void RecordingHandoff::Drain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCV.wait(lock, [this] { return !m_busy && m_jobs.empty(); });
+}
+
+size_t RecordingHandoff::GetPending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.size() + (m_busy ? 1 : 0);
+}
+
+HandoffStats RecordingHandoff::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    HandoffStats stats = m_stats;
+    stats.pending = m_jobs.size() + (m_busy ? 1 : 0);
+    return stats;
+}
+
+void RecordingHandoff::WorkerLoop() {
+    TRACE_THREAD_NAME("Recording finalize");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+        if (m_jobs.empty()) break;  // Stopping with nothing left
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        Clock::time_point start = Clock::now();
+        {
+            TRACE_SCOPE(FinalizeRecording);
+            job.recorder->Stop();   // Capture already ended; joins the threads
+            if (job.finish) job.finish(*job.recorder);
+            job.recorder->Clear();
+        }
+        double finalizeMs = ElapsedMs(start);
+        double savedMs = ElapsedMs(job.stopTime);
+        Release(job.recorder);
+
+        lock.lock();
+        m_stats.lastFinalizeMs = finalizeMs;
+        m_stats.maxFinalizeMs = std::max(m_stats.maxFinalizeMs, finalizeMs);
+        m_stats.lastStopToSavedMs = savedMs;
+        m_busy = false;
+        if (m_jobs.empty()) m_idleCV.notify_all();
+    }
+}
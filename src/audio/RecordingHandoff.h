@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class WasapiRecorder;
+
+// Stop/start latency of the call recorder's back-to-back handoff
+struct HandoffStats {
+    uint64_t stops = 0;
+    double lastStopToReadyMs = 0;   // Stop signal until a new call can start
+    double maxStopToReadyMs = 0;
+    double avgStopToReadyMs = 0;
+    double lastFinalizeMs = 0;      // Thread joins + header, rename, sidecars (background)
+    double maxFinalizeMs = 0;
+    double lastStopToSavedMs = 0;   // Stop signal until the file is in place
+    uint64_t pending = 0;           // Recordings still closing out
+    uint64_t overlapped = 0;        // Calls started while an earlier one was closing out
+    uint64_t recordersCreated = 0;  // Pool misses
+
+    std::string ToJson() const;
+};
+
+// Back-to-back recording for the call recorder.
+//
+// Stopping a call used to join the capture threads, rewrite the header,
+// rename the file and write the sidecars on the caller's thread, so a
+// /start arriving right after /stop waited behind all of it. Instead the
+// caller signals the recorder to stop capturing, hands it to Complete()
+// and takes another recorder from Acquire() for the next call. A single
+// completion thread closes recordings out in the order they stopped (so
+// call numbers stay in order) and returns each recorder to the pool.
+class RecordingHandoff {
+public:
+    using Clock = std::chrono::steady_clock;
+    using FinishFn = std::function<void(WasapiRecorder&)>;
+
+    RecordingHandoff();
+    ~RecordingHandoff();    // Drains the queue and frees the pooled recorders
+
+    RecordingHandoff(const RecordingHandoff&) = delete;
+    RecordingHandoff& operator=(const RecordingHandoff&) = delete;
+
+    // An idle recorder for the next recording (pooled, or a new one)
+    WasapiRecorder* Acquire();
+
+    // Back to the pool without finalizing (e.g. the recorder never started)
+    void Release(WasapiRecorder* recorder);
+
+    // Close out a recorder that has been told to stop: on the completion
+    // thread, Stop() joins its threads, finish(recorder) finalizes the file,
+    // then the recorder is cleared and pooled. stopTime is when the stop
+    // was requested (for the stop-to-saved latency).
+    void Complete(WasapiRecorder* recorder, FinishFn finish, Clock::time_point stopTime);
+
+    // The caller is ready for the next call (stop-to-ready latency)
+    void MarkReady(Clock::time_point stopTime);
+
+    // A call started; counted as overlapped if others are still closing out
+    void MarkStarted();
+
+    // Wait until every queued recording has been closed out
+    void Drain();
+
+    size_t GetPending() const;
+    HandoffStats GetStats() const;
+
+private:
+    struct Job {
+        WasapiRecorder* recorder;
+        FinishFn finish;
+        Clock::time_point stopTime;
+    };
+
+    void WorkerLoop();
+
+    static const size_t MAX_IDLE_RECORDERS = 2;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;       // Work queued / stopping
+    std::condition_variable m_idleCV;   // Queue drained
+    std::deque<Job> m_jobs;
+    bool m_busy = false;
+    bool m_stopping = false;
+    std::vector<WasapiRecorder*> m_idle;
+    std::thread m_worker;
+
+    HandoffStats m_stats;
+    double m_totalStopToReadyMs = 0;
+};
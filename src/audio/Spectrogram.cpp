@@ -0,0 +1,344 @@
+#include "audio/Spectrogram.h"
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char SPEC_MAGIC[4] = { 'M', 'M', 'S', 'P' };
+static const uint32_t SPEC_VERSION = 1;
+
+#pragma pack(push, 1)
+struct SpecFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t sampleRate;
+    uint16_t fftSize;
+    uint16_t bins;
+    uint32_t tileColumns;
+    uint32_t baseHop;
+    uint32_t reserved;
+    uint64_t totalFrames;
+};
+
+// Followed by TILE_BYTES of tile data
+struct SpecTileRecord {
+    uint32_t level;
+    uint32_t reserved;
+    uint64_t index;
+};
+#pragma pack(pop)
+
+static uint64_t MakeKey(uint32_t level, uint64_t index) { return ((uint64_t)level << 56) | index; }
+
+// ============================================================================
+// SpectrogramSource
+// ============================================================================
+
+bool SpectrogramSource::Open(const std::string& wavPath) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memory = nullptr;
+    if (!m_decoder.Open(wavPath)) return false;
+    m_sampleRate = m_decoder.GetSampleRate();
+    m_totalFrames = m_decoder.GetTotalFrames();
+    return m_sampleRate > 0 && m_decoder.GetChannels() > 0;
+}
+
+void SpectrogramSource::Attach(const float* mono, uint64_t frames, uint32_t sampleRate) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decoder.Close();
+    m_memory = mono;
+    m_totalFrames = frames;
+    m_sampleRate = sampleRate;
+}
+
+void SpectrogramSource::ReadMono(int64_t start, size_t count, float* out) {
+    std::fill(out, out + count, 0.0f);
+    int64_t first = std::max<int64_t>(start, 0);
+    int64_t last = std::min<int64_t>(start + (int64_t)count, (int64_t)m_totalFrames);
+    if (first >= last) return;
+    float* dst = out + (first - start);
+    size_t frames = (size_t)(last - first);
+
+    if (m_memory) {
+        memcpy(dst, m_memory + first, frames * sizeof(float));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint16_t channels = m_decoder.GetChannels();
+    m_interleaved.resize(frames * channels);
+    if (!m_decoder.Seek((uint64_t)first)) return;
+    size_t got = 0;
+    while (got < frames) {
+        size_t n = m_decoder.Read(m_interleaved.data() + got * channels, frames - got);
+        if (n == 0) break;
+        got += n;
+    }
+    const float scale = 1.0f / channels;
+    for (size_t i = 0; i < got; i++) {
+        float sum = 0.0f;
+        for (uint16_t c = 0; c < channels; c++) sum += m_interleaved[i * channels + c];
+        dst[i] = sum * scale;
+    }
+}
+
+// ============================================================================
+// Tile computation
+// ============================================================================
+
+void SpectrogramCache::ComputeTile(SpectrogramSource& source, RealFft& fft, std::vector<float>& scratch,
+                                   uint32_t level, uint64_t index, uint8_t* out) {
+    fft.Configure(FFT_SIZE);
+    const uint64_t hop = GetFramesPerColumn(level);
+    const uint32_t windows = level < 2 ? (1u << level) : 4u;    // Per column
+    const uint64_t firstColumn = index * TILE_COLUMNS;
+    const uint64_t totalFrames = source.GetTotalFrames();
+
+    // scratch: audio for the whole tile, window shape, windowed frame, power
+    const size_t spanFrames = (size_t)(hop * TILE_COLUMNS) + FFT_SIZE;
+    scratch.resize(spanFrames + 2 * FFT_SIZE + (FFT_SIZE / 2 + 1) * 2);
+    float* audio = scratch.data();
+    float* hann = audio + spanFrames;
+    float* frame = hann + FFT_SIZE;
+    float* power = frame + FFT_SIZE;
+    float* sum = power + FFT_SIZE / 2 + 1;
+
+    const double pi = 3.14159265358979323846;
+    float windowGain = 0.0f;
+    for (size_t i = 0; i < FFT_SIZE; i++) {
+        hann[i] = (float)(0.5 - 0.5 * std::cos(2.0 * pi * (double)i / FFT_SIZE));
+        windowGain += hann[i];
+    }
+    // Full-scale sine = 0 dB: its bin power is (A * sum(w) / 2)^2
+    const float norm = 4.0f / (windowGain * windowGain);
+
+    source.ReadMono((int64_t)(firstColumn * hop) - (int64_t)FFT_SIZE / 2, spanFrames, audio);
+
+    for (size_t col = 0; col < TILE_COLUMNS; col++) {
+        uint8_t* cells = out + col * BINS;
+        uint64_t columnStart = (firstColumn + col) * hop;
+        if (columnStart >= totalFrames) {
+            memset(cells, 0, BINS);
+            continue;
+        }
+
+        std::fill(sum, sum + FFT_SIZE / 2 + 1, 0.0f);
+        for (uint32_t w = 0; w < windows; w++) {
+            // Window centred at the w-th of `windows` equal slices of the column
+            uint64_t center = columnStart + (hop * (2 * w + 1)) / (2 * windows);
+            const float* src = audio + (center - (uint64_t)(firstColumn * hop));
+            for (size_t i = 0; i < FFT_SIZE; i++) frame[i] = src[i] * hann[i];
+            fft.Power(frame, power);
+            for (size_t k = 0; k <= FFT_SIZE / 2; k++) sum[k] += power[k];
+        }
+
+        const float scale = norm / windows;
+        for (size_t b = 0; b < BINS; b++) {
+            float p = std::max(sum[2 * b + 1], sum[2 * b + 2]) * scale;
+            float db = p > 1e-12f ? 10.0f * std::log10(p) : DB_FLOOR;
+            float v = (db - DB_FLOOR) * (255.0f / -DB_FLOOR);
+            cells[b] = (uint8_t)std::max(0.0f, std::min(255.0f, v));
+        }
+    }
+}
+
+// ============================================================================
+// SpectrogramCache
+// ============================================================================
+
+struct SpectrogramCache::State {
+    SpectrogramSource source;
+    std::atomic<bool> cancelled{false};
+
+    std::mutex mutex;                           // Everything below
+    std::map<uint64_t, std::pair<Tile, std::list<uint64_t>::iterator>> tiles;
+    std::list<uint64_t> lru;                    // Front = most recent
+    std::set<uint64_t> queued;
+    std::function<void()> onReady;
+
+    std::mutex fileMutex;                       // The sidecar
+    std::string sidecarPath;
+    std::fstream file;
+    std::map<uint64_t, uint64_t> onDisk;        // Key -> offset of the tile data
+    uint64_t appendOffset = 0;
+    SpecFileHeader header{};
+
+    void Insert(uint64_t key, Tile tile) {
+        auto it = tiles.find(key);
+        if (it != tiles.end()) lru.erase(it->second.second);
+        lru.push_front(key);
+        tiles[key] = { std::move(tile), lru.begin() };
+        while (tiles.size() > MEMORY_TILES) {
+            tiles.erase(lru.back());
+            lru.pop_back();
+        }
+    }
+};
+
+bool SpectrogramCache::Open(const std::string& wavPath, ThreadPool& pool) {
+    Close();
+    auto state = std::make_shared<State>();
+    if (!state->source.Open(wavPath)) return false;
+
+    state->sidecarPath = GetSidecarPath(wavPath);
+    memcpy(state->header.magic, SPEC_MAGIC, 4);
+    state->header.version = SPEC_VERSION;
+    state->header.sampleRate = state->source.GetSampleRate();
+    state->header.fftSize = (uint16_t)FFT_SIZE;
+    state->header.bins = (uint16_t)BINS;
+    state->header.tileColumns = (uint32_t)TILE_COLUMNS;
+    state->header.baseHop = BASE_HOP;
+    state->header.totalFrames = state->source.GetTotalFrames();
+    // Without a sidecar tiles are just not kept (never for encrypted recordings)
+    if (!state->source.IsEncrypted()) OpenSidecar(*state);
+
+    m_state = std::move(state);
+    m_pool = &pool;
+    m_path = wavPath;
+    return true;
+}
+
+// Reads the tile directory of an existing sidecar that matches this
+// recording, or starts a new one. A torn last record is ignored and
+// overwritten by the next append.
+bool SpectrogramCache::OpenSidecar(State& s) {
+    const std::ios::openmode mode = std::ios::in | std::ios::out | std::ios::binary;
+    s.file.open(s.sidecarPath, mode);
+    if (s.file.is_open()) {
+        SpecFileHeader existing;
+        if (s.file.read(reinterpret_cast<char*>(&existing), sizeof(existing)) &&
+            memcmp(&existing, &s.header, sizeof(existing)) == 0) {
+            s.file.seekg(0, std::ios::end);
+            uint64_t size = (uint64_t)s.file.tellg();
+            const uint64_t recordSize = sizeof(SpecTileRecord) + TILE_BYTES;
+            uint64_t offset = sizeof(SpecFileHeader);
+            while (offset + recordSize <= size) {
+                SpecTileRecord rec;
+                s.file.seekg((std::streamoff)offset);
+                if (!s.file.read(reinterpret_cast<char*>(&rec), sizeof(rec))) break;
+                if (rec.level < LEVELS) {
+                    s.onDisk[MakeKey(rec.level, rec.index)] = offset + sizeof(rec);
+                }
+                offset += recordSize;
+            }
+            s.file.clear();
+            s.appendOffset = offset;
+            return true;
+        }
+        s.file.close();
+    }
+
+    // New (or stale) sidecar
+    s.file.open(s.sidecarPath, mode | std::ios::trunc);
+    if (!s.file.is_open()) return false;
+    s.file.write(reinterpret_cast<const char*>(&s.header), sizeof(s.header));
+    s.appendOffset = sizeof(s.header);
+    return s.file.good();
+}
+
+void SpectrogramCache::Close() {
+    if (m_state) {
+        // Queued work still holds the state; it sees the flag and returns
+        m_state->cancelled = true;
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->onReady = nullptr;
+    }
+    m_state.reset();
+    m_pool = nullptr;
+    m_path.clear();
+}
+
+uint32_t SpectrogramCache::GetSampleRate() const {
+    return m_state ? m_state->source.GetSampleRate() : 0;
+}
+
+uint64_t SpectrogramCache::GetTotalFrames() const {
+    return m_state ? m_state->source.GetTotalFrames() : 0;
+}
+
+uint64_t SpectrogramCache::GetTileCount(uint32_t level) const {
+    uint64_t framesPerTile = GetFramesPerColumn(level) * TILE_COLUMNS;
+    return (GetTotalFrames() + framesPerTile - 1) / framesPerTile;
+}
+
+void SpectrogramCache::SetReadyCallback(std::function<void()> onReady) {
+    if (!m_state) return;
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->onReady = std::move(onReady);
+}
+
+SpectrogramCache::Tile SpectrogramCache::GetTile(uint32_t level, uint64_t index) {
+    if (!m_state || level >= LEVELS || index >= GetTileCount(level)) return nullptr;
+    uint64_t key = MakeKey(level, index);
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        auto it = m_state->tiles.find(key);
+        if (it != m_state->tiles.end()) {
+            m_state->lru.splice(m_state->lru.begin(), m_state->lru, it->second.second);
+            return it->second.first;
+        }
+        if (!m_state->queued.insert(key).second) return nullptr;
+    }
+    std::shared_ptr<State> state = m_state;
+    m_pool->Submit([state, key]() { RunTile(state, key); });
+    return nullptr;
+}
+
+void SpectrogramCache::RunTile(const std::shared_ptr<State>& state, uint64_t key) {
+    if (state->cancelled) return;
+    uint32_t level = (uint32_t)(key >> 56);
+    uint64_t index = key & ((1ull << 56) - 1);
+    auto tile = std::make_shared<std::vector<uint8_t>>(TILE_BYTES);
+
+    // Sidecar first
+    bool loaded = false;
+    {
+        std::lock_guard<std::mutex> lock(state->fileMutex);
+        auto it = state->onDisk.find(key);
+        if (it != state->onDisk.end() && state->file.is_open()) {
+            state->file.clear();
+            state->file.seekg((std::streamoff)it->second);
+            loaded = (bool)state->file.read(reinterpret_cast<char*>(tile->data()), TILE_BYTES);
+        }
+    }
+
+    if (!loaded) {
+        thread_local RealFft fft;
+        thread_local std::vector<float> scratch;
+        ComputeTile(state->source, fft, scratch, level, index, tile->data());
+        if (state->cancelled) return;
+
+        std::lock_guard<std::mutex> lock(state->fileMutex);
+        if (state->file.is_open()) {
+            SpecTileRecord rec = { level, 0, index };
+            state->file.clear();
+            state->file.seekp((std::streamoff)state->appendOffset);
+            state->file.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+            state->file.write(reinterpret_cast<const char*>(tile->data()), TILE_BYTES);
+            state->file.flush();
+            if (state->file.good()) {
+                state->onDisk[key] = state->appendOffset + sizeof(rec);
+                state->appendOffset += sizeof(rec) + TILE_BYTES;
+            }
+        }
+    }
+
+    std::function<void()> onReady;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->queued.erase(key);
+        state->Insert(key, std::move(tile));
+        onReady = state->onReady;
+    }
+    if (onReady && !state->cancelled) onReady();
+}
+
+std::string SpectrogramCache::GetSidecarPath(const std::string& wavPath) {
+    std::string path = wavPath;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("\\/");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        path.resize(dot);
+    }
+    return path + ".spec";
+}
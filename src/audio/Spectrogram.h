@@ -0,0 +1,103 @@
+#pragma once
+
+#include "audio/Fft.h"
+#include "audio/WavDecoder.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+class ThreadPool;
+
+// Mono audio for the spectrogram: a recording (any format WavDecoder
+// reads) or samples in memory. Reads are serialized; the FFT work that
+// follows them is what runs in parallel.
+class SpectrogramSource {
+public:
+    bool Open(const std::string& wavPath);
+    void Attach(const float* mono, uint64_t frames, uint32_t sampleRate);
+
+    uint32_t GetSampleRate() const { return m_sampleRate; }
+    uint64_t GetTotalFrames() const { return m_totalFrames; }
+    bool IsEncrypted() const { return m_decoder.IsEncrypted(); }
+
+    // count frames from `start` (may be negative), zero outside the file
+    void ReadMono(int64_t start, size_t count, float* out);
+
+private:
+    std::mutex m_mutex;
+    WavDecoder m_decoder;
+    std::vector<float> m_interleaved;
+    const float* m_memory = nullptr;
+    uint32_t m_sampleRate = 0;
+    uint64_t m_totalFrames = 0;
+};
+
+// Tiled STFT spectrogram of one recording.
+//
+// A tile is TILE_COLUMNS columns x BINS rows of dB values (one byte each,
+// 0 = DB_FLOOR or below, 255 = full scale), column-major. Level L has
+// BASE_HOP << L frames per column; above level 2 each column averages the
+// power of four windows spread over its span, so short dropouts still show
+// when zoomed out.
+//
+// Tiles are computed lazily on the thread pool for whatever the view asks
+// for, kept in a small in-memory LRU and appended to <name>.spec next to
+// the recording, so a second look at the same call costs a file read.
+class SpectrogramCache {
+public:
+    static constexpr size_t   FFT_SIZE = 512;
+    static constexpr size_t   BINS = 128;           // FFT bins pooled in pairs
+    static constexpr size_t   TILE_COLUMNS = 256;
+    static constexpr size_t   TILE_BYTES = BINS * TILE_COLUMNS;
+    static constexpr uint32_t BASE_HOP = 128;       // Frames per column at level 0
+    static constexpr uint32_t LEVELS = 6;
+    static constexpr float    DB_FLOOR = -100.0f;
+    static constexpr size_t   MEMORY_TILES = 256;   // 8 MB
+
+    using Tile = std::shared_ptr<const std::vector<uint8_t>>;
+
+    SpectrogramCache() = default;
+    ~SpectrogramCache() { Close(); }
+    SpectrogramCache(const SpectrogramCache&) = delete;
+    SpectrogramCache& operator=(const SpectrogramCache&) = delete;
+
+    bool Open(const std::string& wavPath, ThreadPool& pool);
+    void Close();
+    bool IsOpen() const { return m_state != nullptr; }
+    const std::string& GetPath() const { return m_path; }
+
+    uint32_t GetSampleRate() const;
+    uint64_t GetTotalFrames() const;
+    static uint64_t GetFramesPerColumn(uint32_t level) { return (uint64_t)BASE_HOP << level; }
+    uint64_t GetTileCount(uint32_t level) const;
+
+    // The tile if it is in memory; otherwise null, and it is queued on the
+    // pool (read from the sidecar or computed). onReady runs on a worker
+    // each time a queued tile lands.
+    Tile GetTile(uint32_t level, uint64_t index);
+    void SetReadyCallback(std::function<void()> onReady);
+
+    static std::string GetSidecarPath(const std::string& wavPath);
+
+    // One tile straight from the audio (used by the pool and the benchmark).
+    // scratch is per-thread working memory.
+    static void ComputeTile(SpectrogramSource& source, RealFft& fft, std::vector<float>& scratch,
+                            uint32_t level, uint64_t index, uint8_t* out);
+
+private:
+    struct State;
+    static bool OpenSidecar(State& state);
+    static void RunTile(const std::shared_ptr<State>& state, uint64_t key);
+
+    std::shared_ptr<State> m_state;
+    ThreadPool* m_pool = nullptr;
+    std::string m_path;
+};
@@ -1,4 +1,5 @@
 #include "audio/StreamingWavWriter.h"
+#include "core/trace.h"
 #include <ctime>
 #include <sstream>
 #include <iomanip>
@@ -8,6 +9,8 @@ StreamingWavWriter::StreamingWavWriter()
     : m_isActive(false)
     , m_failed(false)
     , m_totalBytesWritten(0)
+    , m_trailingBytes(0)
+    , m_encrypted(false)
     , m_sampleRate(48000)
     , m_channels(2)
     , m_bitsPerSample(16)
@@ -20,7 +23,8 @@ StreamingWavWriter::~StreamingWavWriter() {
     Abort();
 }
 
-bool StreamingWavWriter::Start(const std::string& outputFolder, int sampleRate, int channels, int bitsPerSample) {
+bool StreamingWavWriter::Start(const std::string& outputFolder, int sampleRate, int channels, int bitsPerSample,
+                               const RecordingKey* encryptionKey) {
     std::lock_guard<std::mutex> lock(m_writeMutex);
 
     if (m_isActive) {
@@ -34,23 +38,41 @@ bool StreamingWavWriter::Start(const std::string& outputFolder, int sampleRate,
     m_blockAlign = channels * bitsPerSample / 8;
     m_byteRate = sampleRate * m_blockAlign;
     m_totalBytesWritten = 0;
+    m_trailingBytes = 0;
     m_lastFlushTime = GetTickCount64();
+    if (bitsPerSample == 16) {
+        m_peaks.Start(sampleRate, static_cast<uint16_t>(channels));
+    }
+    m_chain.Start(sampleRate, static_cast<uint16_t>(channels), static_cast<uint16_t>(bitsPerSample));
 
-    // Generate temp filename with timestamp
+    // Generate temp filename with timestamp (plus a sequence: the previous
+    // call may still be closing out a temp file started the same second)
+    static std::atomic<unsigned> s_tempSequence{0};
     auto t = std::time(nullptr);
     struct tm tm;
     localtime_s(&tm, &t);
     std::ostringstream oss;
     oss << outputFolder << "\\~recording_" 
         << std::put_time(&tm, "%Y%m%d_%H%M%S") 
-        << ".wav.tmp";
+        << "_" << s_tempSequence++ << ".wav.tmp";
     m_tempFilePath = oss.str();
 
     // Open file for binary writing
-    m_file.open(m_tempFilePath, std::ios::binary | std::ios::trunc);
-    if (!m_file.is_open()) {
-        OutputDebugStringA("[StreamingWavWriter] Failed to open temp file\n");
-        return false;
+    m_encrypted = encryptionKey != nullptr;
+    if (m_encrypted) {
+        if (!m_crypt.Open(m_tempFilePath, *encryptionKey, sampleRate, static_cast<uint16_t>(channels),
+                          static_cast<uint16_t>(bitsPerSample))) {
+            m_crypt.Close();
+            DeleteFileA(m_tempFilePath.c_str());
+            OutputDebugStringA("[StreamingWavWriter] Failed to open encrypted temp file\n");
+            return false;
+        }
+    } else {
+        m_file.open(m_tempFilePath, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open()) {
+            OutputDebugStringA("[StreamingWavWriter] Failed to open temp file\n");
+            return false;
+        }
     }
 
     // Write initial WAV header with placeholder size
@@ -66,53 +88,38 @@ bool StreamingWavWriter::Start(const std::string& outputFolder, int sampleRate,
 }
 
 void StreamingWavWriter::WriteWavHeader() {
-    // Write WAV header with placeholder sizes (will be updated on Finalize)
-    // RIFF chunk
-    m_file.write("RIFF", 4);
-    int chunkSize = 0; // Placeholder - will be updated
-    m_file.write(reinterpret_cast<char*>(&chunkSize), 4);
-    m_file.write("WAVE", 4);
-
-    // fmt subchunk
-    m_file.write("fmt ", 4);
-    int subChunk1Size = 16; // PCM
-    m_file.write(reinterpret_cast<char*>(&subChunk1Size), 4);
-
-    short audioFormat = 1; // PCM
-    m_file.write(reinterpret_cast<char*>(&audioFormat), 2);
-
-    short numChannels = static_cast<short>(m_channels);
-    m_file.write(reinterpret_cast<char*>(&numChannels), 2);
-
-    m_file.write(reinterpret_cast<char*>(&m_sampleRate), 4);
-    m_file.write(reinterpret_cast<char*>(&m_byteRate), 4);
-
-    short blockAlign = static_cast<short>(m_blockAlign);
-    m_file.write(reinterpret_cast<char*>(&blockAlign), 2);
-
-    short bitsPerSample = static_cast<short>(m_bitsPerSample);
-    m_file.write(reinterpret_cast<char*>(&bitsPerSample), 2);
-
-    // data subchunk
-    m_file.write("data", 4);
-    int dataSize = 0; // Placeholder - will be updated
-    m_file.write(reinterpret_cast<char*>(&dataSize), 4);
-
+    // WAV header with placeholder sizes (will be updated on Finalize)
+    std::vector<char> header = WavMeta::BuildHeader(m_sampleRate, static_cast<uint16_t>(m_channels),
+                                                    static_cast<uint16_t>(m_bitsPerSample));
+    if (m_encrypted) {
+        m_crypt.PatchHeader(0, header.data(), header.size());
+        return;
+    }
+    m_file.write(header.data(), header.size());
     m_file.flush();
 }
 
 void StreamingWavWriter::WriteChunk(const void* data, size_t bytes) {
     if (!m_isActive || bytes == 0) return;
+    TRACE_SCOPE_ARG(WriteChunk, bytes);
 
     std::lock_guard<std::mutex> lock(m_writeMutex);
 
-    if (!m_file.is_open()) return;
-
-    m_file.write(static_cast<const char*>(data), bytes);
+    if (m_encrypted) {
+        if (!m_crypt.IsOpen()) return;
+        m_crypt.Append(data, bytes);
+    } else {
+        if (!m_file.is_open()) return;
+        m_file.write(static_cast<const char*>(data), bytes);
+    }
     m_totalBytesWritten += bytes;
+    m_chain.Add(data, bytes);
+    if (m_peaks.IsStarted()) {
+        m_peaks.AddPcm16(static_cast<const int16_t*>(data), bytes / m_blockAlign);
+    }
 
     // Check for write failures
-    if (m_file.fail()) {
+    if (m_encrypted ? m_crypt.HasFailed() : m_file.fail()) {
         m_failed = true;
         OutputDebugStringA("[StreamingWavWriter] Write failed! Disk full or disconnected?\n");
         return;
@@ -124,37 +131,66 @@ void StreamingWavWriter::WriteChunk(const void* data, size_t bytes) {
 }
 
 void StreamingWavWriter::UpdateWavHeader() {
-    if (!m_file.is_open()) return;
-
     size_t dataSize = m_totalBytesWritten;
-    int chunkSize = static_cast<int>(36 + dataSize);
+    int chunkSize = static_cast<int>(WavMeta::DATA_OFFSET - 8 + dataSize + m_trailingBytes);
     int dataSizeInt = static_cast<int>(dataSize);
 
+    if (m_encrypted) {
+        m_crypt.PatchHeader(4, &chunkSize, 4);
+        m_crypt.PatchHeader(WavMeta::DATA_CHUNK_OFFSET + 4, &dataSizeInt, 4);
+        return;
+    }
+    if (!m_file.is_open()) return;
+
     // Seek to RIFF chunk size (offset 4)
     m_file.seekp(4, std::ios::beg);
     m_file.write(reinterpret_cast<char*>(&chunkSize), 4);
 
-    // Seek to data chunk size (offset 40)
-    m_file.seekp(40, std::ios::beg);
+    // Seek to data chunk size
+    m_file.seekp(WavMeta::DATA_CHUNK_OFFSET + 4, std::ios::beg);
     m_file.write(reinterpret_cast<char*>(&dataSizeInt), 4);
 
     m_file.flush();
 }
 
-std::string StreamingWavWriter::Finalize(const std::string& finalFilename) {
+std::string StreamingWavWriter::Finalize(const std::string& finalFilename, const WavMetadata* metadata) {
     std::lock_guard<std::mutex> lock(m_writeMutex);
 
     if (!m_isActive) {
         return "";
     }
 
+    // The chain is already built; this only hashes the last partial block
+    WavMetadata embedded = metadata ? *metadata : WavMetadata();
+    m_chain.AddToMetadata(embedded);
+    WriteMetadataChunks(embedded);
+
     // Update WAV header with actual sizes
     UpdateWavHeader();
 
     // Close the file
-    m_file.close();
+    bool closed;
+    if (m_encrypted) {
+        closed = m_crypt.Finish();
+    } else {
+        m_file.close();
+        closed = !m_file.fail();
+    }
 
     m_isActive = false;
+    PeakPyramid peaks = m_peaks.Finish();
+
+    // An incomplete file never takes the final name: it stays behind as the
+    // temp file (whole encrypted chunks are recoverable from it) and the
+    // caller sees the failure
+    if (!closed) {
+        m_failed = true;
+        char debug[512];
+        snprintf(debug, sizeof(debug), "[StreamingWavWriter] Failed to finish recording, left as %s\n",
+                 m_tempFilePath.c_str());
+        OutputDebugStringA(debug);
+        return "";
+    }
 
     // Build final path
     std::string finalPath = m_outputFolder + "\\" + finalFilename;
@@ -168,6 +204,9 @@ std::string StreamingWavWriter::Finalize(const std::string& finalFilename) {
         snprintf(debug, sizeof(debug), "[StreamingWavWriter] Finalized: %s (%.2f MB)\n", 
                  finalPath.c_str(), m_totalBytesWritten / (1024.0 * 1024.0));
         OutputDebugStringA(debug);
+        if (!peaks.IsEmpty() && !m_encrypted) {
+            peaks.Save(PeakPyramid::GetSidecarPath(finalPath));
+        }
         return finalPath;
     } else {
         DWORD err = GetLastError();
@@ -179,12 +218,54 @@ std::string StreamingWavWriter::Finalize(const std::string& finalFilename) {
     }
 }
 
+void StreamingWavWriter::WriteMetadataChunks(const WavMetadata& metadata) {
+    std::vector<char> chunks = WavMeta::BuildChunks(metadata);
+    size_t capacity = WavMeta::RESERVED_REGION_SIZE;
+
+    // Fits in the header region? The leftover must be 0 or big enough for a JUNK header.
+    if (chunks.size() == capacity || chunks.size() + 8 <= capacity) {
+        size_t leftover = capacity - chunks.size();
+        if (leftover > 0) {
+            chunks.insert(chunks.end(), { 'J', 'U', 'N', 'K' });
+            int junkSize = static_cast<int>(leftover - 8);
+            chunks.insert(chunks.end(), reinterpret_cast<char*>(&junkSize), reinterpret_cast<char*>(&junkSize) + 4);
+            chunks.resize(capacity, 0);
+        }
+        if (m_encrypted) {
+            m_crypt.PatchHeader(WavMeta::RESERVED_REGION_OFFSET, chunks.data(), chunks.size());
+            return;
+        }
+        m_file.seekp(WavMeta::RESERVED_REGION_OFFSET, std::ios::beg);
+        m_file.write(chunks.data(), chunks.size());
+        return;
+    }
+
+    // Too large for the header region - append after the audio data
+    if (m_encrypted) {
+        if (m_totalBytesWritten & 1) {
+            m_crypt.AppendTrailing("", 1); // Pad byte for odd-sized data chunk
+            m_trailingBytes += 1;
+        }
+        m_crypt.AppendTrailing(chunks.data(), chunks.size());
+        m_trailingBytes += chunks.size();
+        return;
+    }
+    m_file.seekp(0, std::ios::end);
+    if (m_totalBytesWritten & 1) {
+        m_file.put(0); // Pad byte for odd-sized data chunk
+        m_trailingBytes += 1;
+    }
+    m_file.write(chunks.data(), chunks.size());
+    m_trailingBytes += chunks.size();
+}
+
 void StreamingWavWriter::Abort() {
     std::lock_guard<std::mutex> lock(m_writeMutex);
 
     if (m_file.is_open()) {
         m_file.close();
     }
+    m_crypt.Close();
 
     if (m_isActive && !m_tempFilePath.empty()) {
         // Delete temp file
@@ -195,6 +276,7 @@ void StreamingWavWriter::Abort() {
     m_isActive = false;
     m_totalBytesWritten = 0;
     m_tempFilePath.clear();
+    m_peaks.Finish();
 }
 
 double StreamingWavWriter::GetDurationSeconds() const {
@@ -208,6 +290,17 @@ void StreamingWavWriter::PeriodicFlush() {
     if (now - m_lastFlushTime < 5000) return;
 
     m_lastFlushTime = now;
+    TRACE_SCOPE(WriterFlush);
+
+    // Encrypted: whole chunks are already written, the header lives in the
+    // trailer (a crashed file is recovered from the chunks alone)
+    if (m_encrypted) {
+        if (!m_crypt.Flush()) {
+            m_failed = true;
+            OutputDebugStringA("[StreamingWavWriter] Flush failed!\n");
+        }
+        return;
+    }
 
     // Save current position
     std::streampos currentPos = m_file.tellp();
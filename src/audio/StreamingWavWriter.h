@@ -9,9 +9,15 @@
 #include <fstream>
 #include <mutex>
 #include <atomic>
+#include "audio/WavMetadata.h"
+#include "audio/PeakPyramid.h"
+#include "storage/encrypted_recording.h"
+#include "storage/integrity_chain.h"
 
 // Streaming WAV file writer - writes audio data directly to disk
 // without accumulating in RAM. Handles crash recovery via temp files.
+// With an encryption key the same WAV is written through an
+// EncryptedRecordingWriter instead (see storage/encrypted_recording.h).
 class StreamingWavWriter {
 public:
     StreamingWavWriter();
@@ -19,17 +25,20 @@ public:
 
     // Initialize and open temp file for writing
     // outputFolder: Directory where recordings are saved
+    // encryptionKey: Master key to encrypt the recording at rest (null = plain WAV)
     // Returns true on success
-    bool Start(const std::string& outputFolder, int sampleRate, int channels, int bitsPerSample);
+    bool Start(const std::string& outputFolder, int sampleRate, int channels, int bitsPerSample,
+               const RecordingKey* encryptionKey = nullptr);
 
     // Write a chunk of PCM audio data to disk
     // This appends to the file immediately - no RAM accumulation
     void WriteChunk(const void* data, size_t bytes);
 
-    // Finalize the recording: update WAV header with correct size
-    // and rename temp file to final filename
+    // Finalize the recording: update WAV header with correct size,
+    // embed metadata plus the hash chain root and rename temp file to final filename.
+    // The waveform summary built while writing is saved alongside as .peaks.
     // Returns the final filename on success, empty string on failure
-    std::string Finalize(const std::string& finalFilename);
+    std::string Finalize(const std::string& finalFilename, const WavMetadata* metadata = nullptr);
 
     // Abort recording without saving (delete temp file)
     void Abort();
@@ -46,20 +55,29 @@ public:
     // Check if writer has failed (e.g. disk full, disconnected)
     bool HasFailed() const { return m_failed; }
 
+    // Recording is being encrypted at rest
+    bool IsEncrypted() const { return m_encrypted; }
+
     // Get current recording duration in seconds
     double GetDurationSeconds() const;
 
 private:
     void WriteWavHeader();
     void UpdateWavHeader();
+    void WriteMetadataChunks(const WavMetadata& metadata);
 
     std::ofstream m_file;
+    EncryptedRecordingWriter m_crypt; // Used instead of m_file when encrypting
+    bool m_encrypted;
     std::string m_tempFilePath;
     std::string m_outputFolder;
     std::mutex m_writeMutex;
     std::atomic<bool> m_isActive;
     std::atomic<bool> m_failed;
     std::atomic<size_t> m_totalBytesWritten;
+    size_t m_trailingBytes; // Chunks appended after the data chunk
+    PeakPyramidBuilder m_peaks; // Fed from WriteChunk (16-bit PCM only)
+    IntegrityChain m_chain;     // Fed from WriteChunk, root embedded on Finalize
 
     std::atomic<ULONGLONG> m_lastFlushTime;
     void PeriodicFlush();
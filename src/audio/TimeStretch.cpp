@@ -0,0 +1,173 @@
+#include "audio/TimeStretch.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRETCH_SSE 1
+#include <xmmintrin.h>
+#endif
+
+static const int COARSE_STEP = 4;   // Decimation of the coarse search
+
+static float DotProduct(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    float sum = 0.0f;
+#ifdef STRETCH_SSE
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+void TimeStretcher::Configure(uint32_t sampleRate, uint16_t channels) {
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    m_window = std::max<size_t>(64, (size_t)(sampleRate * WINDOW_MS / 1000.0) & ~(size_t)1);
+    m_hop = m_window / 2;
+    m_search = std::max<int64_t>(COARSE_STEP, (int64_t)(sampleRate * SEARCH_MS / 1000.0));
+
+    // Periodic Hann: two windows half a window apart sum to exactly 1
+    m_hann.resize(m_window);
+    const double pi = 3.14159265358979323846;
+    for (size_t i = 0; i < m_window; i++) {
+        m_hann[i] = (float)(0.5 - 0.5 * std::cos(2.0 * pi * i / m_window));
+    }
+    Reset();
+}
+
+void TimeStretcher::Reset() {
+    m_input.clear();
+    m_mono.clear();
+    m_inputStart = 0;
+    m_analysisPos = 0.0;
+    m_prevPos = -1;
+    m_overlap.assign(m_hop * m_channels, 0.0f);
+}
+
+void TimeStretcher::SetSpeed(double speed) {
+    m_speed = std::max(MIN_SPEED, std::min(MAX_SPEED, speed));
+}
+
+size_t TimeStretcher::GetInputRequired() const {
+    if (m_channels == 0) return 0;
+    int64_t nominal = (int64_t)std::llround(m_analysisPos);
+    int64_t end = nominal + (int64_t)m_window;
+    if (m_prevPos >= 0) {
+        end = std::max(nominal + m_search + (int64_t)m_window, m_prevPos + 2 * (int64_t)m_hop);
+    }
+    int64_t have = m_inputStart + (int64_t)m_mono.size();
+    return end > have ? (size_t)(end - have) : 0;
+}
+
+void TimeStretcher::PushInput(const float* in, size_t frames) {
+    const uint16_t ch = m_channels;
+    m_input.insert(m_input.end(), in, in + frames * ch);
+    size_t monoStart = m_mono.size();
+    m_mono.resize(monoStart + frames);
+    const float scale = 1.0f / ch;
+    for (size_t i = 0; i < frames; i++) {
+        float sum = 0.0f;
+        for (uint16_t c = 0; c < ch; c++) sum += in[i * ch + c];
+        m_mono[monoStart + i] = sum * scale;
+    }
+}
+
+size_t TimeStretcher::Process(float* out, size_t maxFrames) {
+    size_t produced = 0;
+    while (maxFrames - produced >= m_hop && GetInputRequired() == 0) {
+        ProduceHop(out + produced * m_channels);
+        produced += m_hop;
+    }
+    return produced;
+}
+
+// Start (absolute input frame) of the candidate segment near `nominal`
+// whose first half best matches the natural continuation of the previous one
+int64_t TimeStretcher::FindBestOffset(int64_t nominal) const {
+    const size_t overlap = m_hop;
+    const int64_t lo = std::max(m_inputStart, nominal - m_search);
+    const int64_t hi = nominal + m_search;
+    const float* mono = m_mono.data() - m_inputStart;   // Index by absolute frame
+    const float* ref = mono + m_prevPos + (int64_t)m_hop;
+
+    // Coarse pass on every COARSE_STEP-th sample
+    const size_t refLen = overlap / COARSE_STEP;
+    const size_t candidates = (size_t)((hi - lo) / COARSE_STEP) + 1;
+    m_coarseRef.resize(refLen);
+    m_coarseInput.resize(candidates + refLen);
+    for (size_t i = 0; i < refLen; i++) m_coarseRef[i] = ref[i * COARSE_STEP];
+    for (size_t i = 0; i < candidates + refLen; i++) m_coarseInput[i] = mono[lo + (int64_t)i * COARSE_STEP];
+
+    float energy = DotProduct(m_coarseInput.data(), m_coarseInput.data(), refLen);
+    int64_t best = lo;
+    float bestScore = -1e30f;
+    for (size_t c = 0; c < candidates; c++) {
+        float score = DotProduct(m_coarseRef.data(), m_coarseInput.data() + c, refLen) / std::sqrt(energy + 1e-9f);
+        if (score > bestScore) {
+            bestScore = score;
+            best = lo + (int64_t)c * COARSE_STEP;
+        }
+        // Slide the energy window by one coarse sample
+        float leaving = m_coarseInput[c], entering = m_coarseInput[c + refLen];
+        energy = std::max(0.0f, energy - leaving * leaving + entering * entering);
+    }
+
+    // Fine pass at full rate around the coarse winner
+    int64_t fineLo = std::max(lo, best - COARSE_STEP + 1);
+    int64_t fineHi = std::min(hi, best + COARSE_STEP - 1);
+    bestScore = -1e30f;
+    int64_t bestFine = best;
+    for (int64_t k = fineLo; k <= fineHi; k++) {
+        const float* cand = mono + k;
+        float score = DotProduct(ref, cand, overlap) / std::sqrt(DotProduct(cand, cand, overlap) + 1e-9f);
+        if (score > bestScore) {
+            bestScore = score;
+            bestFine = k;
+        }
+    }
+    return bestFine;
+}
+
+void TimeStretcher::ProduceHop(float* out) {
+    const uint16_t ch = m_channels;
+    int64_t nominal = (int64_t)std::llround(m_analysisPos);
+    int64_t start = m_prevPos < 0 ? nominal : FindBestOffset(nominal);
+    start = std::max(start, m_inputStart);
+
+    const float* seg = m_input.data() + (size_t)(start - m_inputStart) * ch;
+    for (size_t i = 0; i < m_hop; i++) {
+        float w = m_hann[i];
+        for (uint16_t c = 0; c < ch; c++) {
+            out[i * ch + c] = m_overlap[i * ch + c] + w * seg[i * ch + c];
+        }
+    }
+    const float* tail = seg + m_hop * ch;
+    for (size_t i = 0; i < m_hop; i++) {
+        float w = m_hann[m_hop + i];
+        for (uint16_t c = 0; c < ch; c++) {
+            m_overlap[i * ch + c] = w * tail[i * ch + c];
+        }
+    }
+
+    m_prevPos = start;
+    m_analysisPos += m_hop * m_speed;
+    Compact();
+}
+
+// Drop input no future segment or reference can reach
+void TimeStretcher::Compact() {
+    int64_t keepFrom = std::min((int64_t)std::llround(m_analysisPos) - m_search, m_prevPos + (int64_t)m_hop);
+    int64_t drop = keepFrom - m_inputStart;
+    if (drop < (int64_t)m_window * 4) return; // Amortise the erase
+    m_input.erase(m_input.begin(), m_input.begin() + (size_t)drop * m_channels);
+    m_mono.erase(m_mono.begin(), m_mono.begin() + (size_t)drop);
+    m_inputStart += drop;
+}
@@ -0,0 +1,283 @@
+#include "audio/VoiceActivity.h"
+#include "audio/MappedWavReader.h"
+#include "audio/WavDecoder.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+static const char VAD_MAGIC[4] = { 'M', 'M', 'V', 'A' };
+static const uint32_t VAD_VERSION = 1;
+
+// Decision parameters (dB, analysis frames of 20 ms)
+static const float MARGIN_DB = 10.0f;       // Above the noise floor
+static const float GATE_DB = -50.0f;        // Absolute minimum level for speech
+static const float FLOOR_RISE_DB = 0.05f;   // Per frame (2.5 dB/s)
+static const float MIN_SWING_DB = 3.0f;     // Std-dev of energy over STATIONARY_FRAMES
+static const int STATIONARY_FRAMES = 50;    // 1 s before or after the frame
+static const int HANG_BEFORE = 5;           // 100 ms lead-in
+static const int HANG_AFTER = 15;           // 300 ms tail
+static const int MIN_GAP = 20;              // Pauses shorter than 400 ms stay speech
+static const int MIN_RUN = 5;               // Bursts shorter than 100 ms are dropped
+
+#pragma pack(push, 1)
+struct VadFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t reserved;
+    uint64_t totalFrames;
+    uint64_t segmentCount;
+};
+#pragma pack(pop)
+
+// ============================================================================
+// VoiceActivityMap
+// ============================================================================
+
+uint64_t VoiceActivityMap::GetSpeechFrames() const {
+    uint64_t total = 0;
+    for (const VoiceSegment& s : m_segments) total += s.end - s.start;
+    return total;
+}
+
+bool VoiceActivityMap::IsSpeech(uint64_t frame) const {
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), frame,
+                               [](uint64_t f, const VoiceSegment& s) { return f < s.start; });
+    return it != m_segments.begin() && frame < (it - 1)->end;
+}
+
+uint64_t VoiceActivityMap::NextSpeech(uint64_t frame) const {
+    if (IsSpeech(frame)) return frame;
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), frame,
+                               [](uint64_t f, const VoiceSegment& s) { return f < s.start; });
+    return it != m_segments.end() ? it->start : m_totalFrames;
+}
+
+bool VoiceActivityMap::Save(const std::string& path) const {
+    if (IsEmpty()) return false;
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        VadFileHeader hdr = {};
+        memcpy(hdr.magic, VAD_MAGIC, 4);
+        hdr.version = VAD_VERSION;
+        hdr.sampleRate = m_sampleRate;
+        hdr.totalFrames = m_totalFrames;
+        hdr.segmentCount = m_segments.size();
+        file.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        file.write(reinterpret_cast<const char*>(m_segments.data()), m_segments.size() * sizeof(VoiceSegment));
+        if (!file.good()) return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool VoiceActivityMap::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    VadFileHeader hdr;
+    if (!file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr))) return false;
+    if (memcmp(hdr.magic, VAD_MAGIC, 4) != 0 || hdr.version != VAD_VERSION) return false;
+    if (hdr.totalFrames == 0 || hdr.segmentCount > (1u << 24)) return false;
+
+    std::vector<VoiceSegment> segments((size_t)hdr.segmentCount);
+    if (!segments.empty() && !file.read(reinterpret_cast<char*>(segments.data()), segments.size() * sizeof(VoiceSegment))) {
+        return false;
+    }
+
+    m_sampleRate = hdr.sampleRate;
+    m_totalFrames = hdr.totalFrames;
+    m_segments = std::move(segments);
+    return true;
+}
+
+std::string VoiceActivityMap::GetSidecarPath(const std::string& wavPath) {
+    std::string path = wavPath;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("\\/");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        path.resize(dot);
+    }
+    return path + ".vad";
+}
+
+// ============================================================================
+// VoiceActivityDetector - inline part
+// ============================================================================
+
+void VoiceActivityDetector::Start(uint32_t sampleRate, uint16_t channels) {
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    m_frameLen = std::max<uint32_t>(1, sampleRate * FRAME_MS / 1000);
+    m_totalFrames = 0;
+    m_pos = 0;
+    m_channelIndex = 0;
+    m_acc = 0.0f;
+    m_sumSquares = 0.0;
+    m_energy.clear();
+    m_energy.reserve(64 * 1024);
+}
+
+inline void VoiceActivityDetector::AddSample(float s) {
+    m_acc += s;
+    if (++m_channelIndex < m_channels) return;
+
+    float mono = m_acc / m_channels;
+    m_acc = 0.0f;
+    m_channelIndex = 0;
+    m_sumSquares += (double)mono * mono;
+    m_totalFrames++;
+    if (++m_pos == m_frameLen) CloseFrame();
+}
+
+void VoiceActivityDetector::CloseFrame() {
+    if (m_pos == 0) return;
+    double meanSquare = m_sumSquares / m_pos;
+    float db = meanSquare > 1e-10 ? (float)(10.0 * std::log10(meanSquare)) : -100.0f;
+    m_energy.push_back((uint8_t)std::max(0.0f, std::min(100.0f, db + 100.0f)));
+    m_pos = 0;
+    m_sumSquares = 0.0;
+}
+
+void VoiceActivityDetector::AddPcm16(const int16_t* samples, size_t frames) {
+    if (!IsStarted()) return;
+    size_t count = frames * m_channels;
+    for (size_t i = 0; i < count; i++) AddSample(samples[i] * (1.0f / 32768.0f));
+}
+
+void VoiceActivityDetector::AddFloat(const float* samples, size_t frames) {
+    if (!IsStarted()) return;
+    size_t count = frames * m_channels;
+    for (size_t i = 0; i < count; i++) AddSample(samples[i]);
+}
+
+// ============================================================================
+// VoiceActivityDetector - decisions
+// ============================================================================
+
+VoiceActivityMap VoiceActivityDetector::Finish() {
+    VoiceActivityMap map;
+    if (!IsStarted()) return map;
+    CloseFrame();
+
+    map.m_sampleRate = m_sampleRate;
+    map.m_totalFrames = m_totalFrames;
+    const int n = (int)m_energy.size();
+    m_channels = 0;
+    if (n == 0) return map;
+
+    std::vector<float> db(n);
+    for (int i = 0; i < n; i++) db[i] = m_energy[i] - 100.0f;
+
+    // Energy mean/variance over any window via prefix sums
+    std::vector<double> sum(n + 1, 0.0), sumSq(n + 1, 0.0);
+    for (int i = 0; i < n; i++) {
+        sum[i + 1] = sum[i] + db[i];
+        sumSq[i + 1] = sumSq[i] + (double)db[i] * db[i];
+    }
+
+    // Seed the floor from the quietest frame of the first second, so a
+    // recording that opens mid-sentence is not taken as the noise level
+    std::vector<uint8_t> active(n, 0);
+    float floorDb = *std::min_element(db.begin(), db.begin() + std::min(n, STATIONARY_FRAMES));
+    for (int i = 0; i < n; i++) {
+        floorDb = db[i] < floorDb ? db[i] : floorDb + FLOOR_RISE_DB;
+        if (db[i] < floorDb + MARGIN_DB || db[i] < GATE_DB) continue;
+
+        // Level tone/music on either side. One-sided windows keep the
+        // onset and end of music from looking lively next to silence.
+        auto variance = [&](int lo, int hi) {
+            lo = std::max(0, lo);
+            hi = std::min(n, hi);
+            double count = hi - lo;
+            double mean = (sum[hi] - sum[lo]) / count;
+            return (sumSq[hi] - sumSq[lo]) / count - mean * mean;
+        };
+        double before = variance(i - STATIONARY_FRAMES + 1, i + 1);
+        double after = variance(i, i + STATIONARY_FRAMES);
+        if (std::min(before, after) < (double)MIN_SWING_DB * MIN_SWING_DB) continue;
+        active[i] = 1;
+    }
+
+    // Drop isolated clicks, then pad and bridge
+    for (int i = 0; i < n;) {
+        if (!active[i]) { i++; continue; }
+        int j = i;
+        while (j < n && active[j]) j++;
+        if (j - i < MIN_RUN) std::fill(active.begin() + i, active.begin() + j, 0);
+        i = j;
+    }
+    std::vector<uint8_t> padded(n, 0);
+    for (int i = 0; i < n; i++) {
+        if (!active[i]) continue;
+        int lo = std::max(0, i - HANG_BEFORE), hi = std::min(n, i + HANG_AFTER + 1);
+        std::fill(padded.begin() + lo, padded.begin() + hi, 1);
+    }
+
+    const uint64_t frameLen = m_frameLen;
+    for (int i = 0; i < n;) {
+        if (!padded[i]) { i++; continue; }
+        int j = i;
+        while (j < n && padded[j]) j++;
+        VoiceSegment seg;
+        seg.start = (uint64_t)i * frameLen;
+        seg.end = std::min((uint64_t)j * frameLen, m_totalFrames);
+        if (!map.m_segments.empty() && seg.start - map.m_segments.back().end < MIN_GAP * frameLen) {
+            map.m_segments.back().end = seg.end;
+        } else {
+            map.m_segments.push_back(seg);
+        }
+        i = j;
+    }
+    return map;
+}
+
+bool VoiceActivityDetector::BuildFromWav(const std::string& wavPath, VoiceActivityMap& out) {
+    VoiceActivityDetector detector;
+
+    // 16-bit PCM straight from the mapping, anything else through the decoder
+    MappedWavReader reader;
+    if (reader.Open(wavPath) && !reader.GetSamples<int16_t>(0, 1).empty()) {
+        detector.Start(reader.GetInfo().sampleRate, reader.GetInfo().channels);
+        reader.SetAccessPattern(MappedFile::Access::Sequential);
+        const size_t chunkFrames = 256 * 1024;
+        for (uint64_t frame = 0; frame < reader.GetTotalFrames(); frame += chunkFrames) {
+            reader.PrefetchFrames(frame + chunkFrames, chunkFrames);
+            SampleSpan<int16_t> span = reader.GetSamples<int16_t>(frame, chunkFrames);
+            detector.AddPcm16(span.data, span.frames);
+        }
+    } else {
+        reader.Close();
+        WavDecoder decoder;
+        if (!decoder.Open(wavPath)) return false;
+        detector.Start(decoder.GetSampleRate(), decoder.GetChannels());
+        std::vector<float> buffer((size_t)16384 * decoder.GetChannels());
+        size_t frames;
+        while ((frames = decoder.Read(buffer.data(), 16384)) > 0) detector.AddFloat(buffer.data(), frames);
+    }
+
+    out = detector.Finish();
+    return !out.IsEmpty();
+}
+
+bool LoadOrBuildVoiceMap(const std::string& wavPath, VoiceActivityMap& out) {
+    std::string sidecar = VoiceActivityMap::GetSidecarPath(wavPath);
+    WavDecoder decoder;
+    if (!decoder.Open(wavPath)) return false;
+
+    if (out.Load(sidecar) && out.GetSampleRate() == decoder.GetSampleRate()) {
+        uint64_t a = out.GetTotalFrames(), b = decoder.GetTotalFrames();
+        if ((a > b ? a - b : b - a) < 4096) return true;
+    }
+    bool encrypted = decoder.IsEncrypted();
+    decoder.Close();
+
+    if (!VoiceActivityDetector::BuildFromWav(wavPath, out)) return false;
+    if (!encrypted) out.Save(sidecar); // Nothing derived from the audio in plaintext
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Speech region of a recording, in sample frames [start, end)
+struct VoiceSegment {
+    uint64_t start = 0;
+    uint64_t end = 0;
+};
+
+// Voice-activity map of one recording, stored next to it as <name>.vad.
+// The player draws it under the seek bar and uses it to skip silence and
+// hold music.
+class VoiceActivityMap {
+public:
+    bool IsEmpty() const { return m_totalFrames == 0; }
+    uint32_t GetSampleRate() const { return m_sampleRate; }
+    uint64_t GetTotalFrames() const { return m_totalFrames; }
+    const std::vector<VoiceSegment>& GetSegments() const { return m_segments; }
+    uint64_t GetSpeechFrames() const;
+
+    bool IsSpeech(uint64_t frame) const;
+    // First speech frame at or after `frame` (GetTotalFrames() if none)
+    uint64_t NextSpeech(uint64_t frame) const;
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+    static std::string GetSidecarPath(const std::string& wavPath);
+
+private:
+    friend class VoiceActivityDetector;
+
+    uint32_t m_sampleRate = 0;
+    uint64_t m_totalFrames = 0;
+    std::vector<VoiceSegment> m_segments;   // Sorted, non-overlapping
+};
+
+// Streaming voice-activity detector.
+//
+// The inline part is deliberately tiny so it can run inside the recorder's
+// mixer: per 20 ms frame it keeps one byte of energy (dBFS). Everything
+// else happens once in Finish(), over the whole energy track:
+//   - adaptive noise floor (follows drops at once, rises ~2.5 dB/s)
+//   - active = energy above floor + margin and above an absolute gate
+//   - stationarity: speech energy swings by syllable (~4 Hz); hold music,
+//     tones and fans stay level, so active frames whose energy barely
+//     varies over the second before or after them are dropped
+//   - hangover/gap filling so words and short pauses are not chopped
+class VoiceActivityDetector {
+public:
+    static constexpr uint32_t FRAME_MS = 20;
+
+    void Start(uint32_t sampleRate, uint16_t channels);
+    bool IsStarted() const { return m_channels != 0; }
+
+    void AddPcm16(const int16_t* samples, size_t frames);
+    void AddFloat(const float* samples, size_t frames);
+
+    VoiceActivityMap Finish();
+
+    // Batch pass for recordings made before the recorder produced maps
+    static bool BuildFromWav(const std::string& wavPath, VoiceActivityMap& out);
+
+private:
+    void AddSample(float s);
+    void CloseFrame();
+
+    uint32_t m_sampleRate = 0;
+    uint16_t m_channels = 0;
+    uint32_t m_frameLen = 0;        // Samples per channel in one analysis frame
+    uint64_t m_totalFrames = 0;
+
+    // Current analysis frame (channels are folded together)
+    uint32_t m_pos = 0;
+    uint16_t m_channelIndex = 0;
+    float m_acc = 0.0f;
+    double m_sumSquares = 0.0;
+
+    std::vector<uint8_t> m_energy;  // Per analysis frame: dBFS + 100, 0 = silent
+};
+
+// Load <wav>.vad if it matches the recording, otherwise build and save it
+bool LoadOrBuildVoiceMap(const std::string& wavPath, VoiceActivityMap& out);
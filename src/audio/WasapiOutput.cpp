@@ -0,0 +1,152 @@
+#include "audio/WasapiOutput.h"
+#include "core/trace.h"
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+#include <mmreg.h>
+#include <ksmedia.h>
+#include <vector>
+#include <cstdio>
+
+#ifndef AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM
+#define AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM 0x80000000
+#endif
+#ifndef AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY
+#define AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY 0x08000000
+#endif
+
+template <class T> static void ReleaseCom(T** ppT) {
+    if (*ppT) {
+        (*ppT)->Release();
+        *ppT = nullptr;
+    }
+}
+
+bool WasapiOutput::Open(uint32_t sampleRate, uint16_t channels, RenderCallback render) {
+    Close();
+    if (sampleRate == 0 || channels == 0 || !render) return false;
+
+    // Device setup happens on the render thread (COM apartment); wait for it
+    HANDLE ready = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!ready) return false;
+    bool ok = false;
+    m_running = true;
+    m_thread = std::thread(&WasapiOutput::RenderLoop, this, sampleRate, channels, render, ready, &ok);
+    WaitForSingleObject(ready, INFINITE);
+    CloseHandle(ready);
+
+    if (!ok) Close();
+    return ok;
+}
+
+void WasapiOutput::Close() {
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+    m_padding = 0;
+}
+
+void WasapiOutput::RenderLoop(uint32_t sampleRate, uint16_t channels, RenderCallback render, HANDLE ready, bool* ok) {
+    HRESULT hr;
+    IMMDeviceEnumerator* pEnumerator = nullptr;
+    IMMDevice* pDevice = nullptr;
+    IAudioClient* pAudioClient = nullptr;
+    IAudioRenderClient* pRenderClient = nullptr;
+    HANDLE hEvent = nullptr;
+    UINT32 bufferFrames = 0;
+    std::vector<float> scratch;
+
+    CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    WAVEFORMATEXTENSIBLE wfx = {};
+    wfx.Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+    wfx.Format.nChannels = channels;
+    wfx.Format.nSamplesPerSec = sampleRate;
+    wfx.Format.wBitsPerSample = 32;
+    wfx.Format.nBlockAlign = (WORD)(channels * 4);
+    wfx.Format.nAvgBytesPerSec = sampleRate * wfx.Format.nBlockAlign;
+    wfx.Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+    wfx.Samples.wValidBitsPerSample = 32;
+    wfx.dwChannelMask = channels == 1 ? SPEAKER_FRONT_CENTER : (SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT);
+    wfx.SubFormat = KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
+
+    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
+                          __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
+    if (FAILED(hr)) goto Exit;
+
+    hr = pEnumerator->GetDefaultAudioEndpoint(eRender, eMultimedia, &pDevice);
+    if (FAILED(hr)) goto Exit;
+
+    hr = pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&pAudioClient);
+    if (FAILED(hr)) goto Exit;
+
+    // 100 ms device buffer, refilled on every period event
+    hr = pAudioClient->Initialize(AUDCLNT_SHAREMODE_SHARED,
+                                  AUDCLNT_STREAMFLAGS_EVENTCALLBACK | AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM |
+                                  AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY,
+                                  1000000, 0, (WAVEFORMATEX*)&wfx, nullptr);
+    if (FAILED(hr)) goto Exit;
+
+    hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!hEvent) { hr = E_FAIL; goto Exit; }
+    hr = pAudioClient->SetEventHandle(hEvent);
+    if (FAILED(hr)) goto Exit;
+
+    hr = pAudioClient->GetBufferSize(&bufferFrames);
+    if (FAILED(hr)) goto Exit;
+
+    hr = pAudioClient->GetService(__uuidof(IAudioRenderClient), (void**)&pRenderClient);
+    if (FAILED(hr)) goto Exit;
+
+    // Prefill with silence so Start has something to play
+    {
+        BYTE* pData = nullptr;
+        hr = pRenderClient->GetBuffer(bufferFrames, &pData);
+        if (FAILED(hr)) goto Exit;
+        pRenderClient->ReleaseBuffer(bufferFrames, AUDCLNT_BUFFERFLAGS_SILENT);
+    }
+
+    hr = pAudioClient->Start();
+    if (FAILED(hr)) goto Exit;
+
+    *ok = true;
+    SetEvent(ready);
+    ready = nullptr;
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+    TRACE_THREAD_NAME("Playback render");
+
+    scratch.resize((size_t)bufferFrames * channels);
+    while (m_running) {
+        WaitForSingleObject(hEvent, 200);
+
+        UINT32 padding = 0;
+        hr = pAudioClient->GetCurrentPadding(&padding);
+        if (FAILED(hr)) break;
+        m_padding = padding;
+
+        UINT32 frames = bufferFrames - padding;
+        if (frames == 0) continue;
+
+        BYTE* pData = nullptr;
+        hr = pRenderClient->GetBuffer(frames, &pData);
+        if (FAILED(hr)) break;
+        TRACE_SCOPE_ARG(RenderBuffer, frames);
+        render(scratch.data(), frames);
+        memcpy(pData, scratch.data(), (size_t)frames * channels * sizeof(float));
+        pRenderClient->ReleaseBuffer(frames, 0);
+    }
+
+    pAudioClient->Stop();
+
+Exit:
+    if (FAILED(hr)) {
+        char errBuf[64];
+        snprintf(errBuf, sizeof(errBuf), "[WasapiOutput] Render Error: 0x%08X\n", (unsigned)hr);
+        OutputDebugStringA(errBuf);
+    }
+    if (ready) SetEvent(ready);
+    if (hEvent) CloseHandle(hEvent);
+    ReleaseCom(&pRenderClient);
+    ReleaseCom(&pAudioClient);
+    ReleaseCom(&pDevice);
+    ReleaseCom(&pEnumerator);
+    CoUninitialize();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include <windows.h>
+#include "audio/PlaybackEngine.h"
+#include <thread>
+#include <atomic>
+
+// Shared-mode, event-driven WASAPI render on the default device.
+// Float in the file's rate/channels; the audio engine converts to the mix
+// format (AUTOCONVERTPCM), so no resampler is needed here.
+class WasapiOutput : public AudioOutput {
+public:
+    ~WasapiOutput() override { Close(); }
+
+    bool Open(uint32_t sampleRate, uint16_t channels, RenderCallback render) override;
+    void Close() override;
+    uint32_t GetLatencyFrames() const override { return m_padding; }
+
+private:
+    void RenderLoop(uint32_t sampleRate, uint16_t channels, RenderCallback render, HANDLE ready, bool* ok);
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint32_t> m_padding{0};
+};
@@ -1,24 +1,17 @@
 #include "audio/WasapiRecorder.h"
 #include "audio/StreamingWavWriter.h"
 #include "audio/recorder.h" // For hRecorderWnd and WM_APP_RECORDING_ERROR
+#include "core/trace.h"
+#include "core/settings.h"
 #include <fstream>
 #include <iostream>
 #include <mmreg.h>
 #include <ksmedia.h>
-#include <functiondiscoverykeys_devpkey.h>
 #include <cstdio>
 #include <cmath>
 
 #pragma comment(lib, "ole32.lib")
 
-// Helper template for COM cleanup
-template <class T> void SafeRelease(T **ppT) {
-    if (*ppT) {
-        (*ppT)->Release();
-        *ppT = nullptr;
-    }
-}
-
 WasapiRecorder::WasapiRecorder() 
     : isRecording(false)
     , isPaused(false)
@@ -29,6 +22,8 @@ WasapiRecorder::WasapiRecorder()
     , m_pWriter(nullptr)
     , m_lastFlushTime(0)
 {
+    micBuffer = GetAudioBufferPool().Acquire(0);
+    loopbackBuffer = GetAudioBufferPool().Acquire(0);
 }
 
 WasapiRecorder::~WasapiRecorder() {
@@ -70,9 +65,9 @@ bool WasapiRecorder::Start() {
     m_streamingMode = false;
     m_recordingStartTime = GetTickCount64();
     
-    // Start both capture threads
-    micThread = std::thread(&WasapiRecorder::MicrophoneLoop, this);
-    loopbackThread = std::thread(&WasapiRecorder::LoopbackLoop, this);
+    // Subscribe to the shared capture streams
+    SubscribeCapture();
+    captureThread = std::thread(&WasapiRecorder::CaptureLoop, this);
     
     return true;
 }
@@ -96,11 +91,33 @@ bool WasapiRecorder::StartStreaming(const std::string& outputFolder) {
     
     m_outputFolder = outputFolder;
     
+    // Encrypted at rest when enabled; never fall back to plaintext
+    RecordingKey key;
+    if (encryptRecordings && !GetConfiguredRecordingKey(key)) {
+        OutputDebugStringA("[WasapiRecorder] No recording key available\n");
+        return false;
+    }
+
     // Start the writer with output format
-    if (!m_pWriter->Start(outputFolder, OUTPUT_SAMPLE_RATE, OUTPUT_CHANNELS, OUTPUT_BITS)) {
+    if (!m_pWriter->Start(outputFolder, OUTPUT_SAMPLE_RATE, OUTPUT_CHANNELS, OUTPUT_BITS,
+                          encryptRecordings ? &key : nullptr)) {
         OutputDebugStringA("[WasapiRecorder] Failed to start streaming writer\n");
         return false;
     }
+    m_vad.Start(OUTPUT_SAMPLE_RATE, OUTPUT_CHANNELS);
+    {
+        std::lock_guard<std::mutex> lock(m_analyticsMutex);
+        m_analytics.Start(OUTPUT_SAMPLE_RATE);
+    }
+    DspSettings dsp = GetConfiguredDspSettings();
+    m_micDsp.Configure(OUTPUT_SAMPLE_RATE, dsp, &GetMicDspTimings());
+    DspSettings mixDsp;
+    mixDsp.highPass = false;
+    mixDsp.limiter = dsp.limiter;
+    mixDsp.limiterCeilingDb = -0.3f;
+    m_mixLimiter.Configure(OUTPUT_SAMPLE_RATE, mixDsp);
+    m_loopDelay.assign(m_micDsp.GetLatency(), 0.0f);
+    m_loopDelayPos = 0;
 
     isRecording = true;
     isPaused = false;
@@ -108,9 +125,10 @@ bool WasapiRecorder::StartStreaming(const std::string& outputFolder) {
     m_recordingStartTime = GetTickCount64();
     m_lastFlushTime = GetTickCount64();
     
-    // Start capture threads
-    micThread = std::thread(&WasapiRecorder::MicrophoneLoop, this);
-    loopbackThread = std::thread(&WasapiRecorder::LoopbackLoop, this);
+    // Subscribe to the shared capture streams (already running if the other
+    // recorder is active or a call just ended)
+    SubscribeCapture();
+    captureThread = std::thread(&WasapiRecorder::CaptureLoop, this);
     
     // Start mixer thread (periodically mixes and writes to disk)
     mixerThread = std::thread(&WasapiRecorder::MixerLoop, this);
@@ -119,23 +137,28 @@ bool WasapiRecorder::StartStreaming(const std::string& outputFolder) {
     return true;
 }
 
-void WasapiRecorder::Stop() {
+void WasapiRecorder::RequestStop() {
     isRecording = false; // Signals threads to stop
     isPaused = false;
     
-    // Wake up mixer thread if waiting
+    // Wake up mixer thread if waiting (it does the final flush)
     m_mixerCV.notify_all();
+}
+
+void WasapiRecorder::Stop() {
+    RequestStop();
     
-    if (micThread.joinable()) {
-        try { micThread.join(); } catch(...) {}
-    }
-    if (loopbackThread.joinable()) {
-        try { loopbackThread.join(); } catch(...) {}
+    if (captureThread.joinable()) {
+        try { captureThread.join(); } catch(...) {}
     }
     if (mixerThread.joinable()) {
          try { mixerThread.join(); } catch(...) {}
     }
     
+    // The hub closes the devices once nobody else needs them
+    m_micSub.Close();
+    m_loopbackSub.Close();
+    
     m_streamingMode = false;
 }
 
@@ -158,226 +181,59 @@ void WasapiRecorder::Clear() {
     }
 }
 
-// Microphone capture loop (user's voice)
-void WasapiRecorder::MicrophoneLoop() {
-    HRESULT hr;
-    IMMDeviceEnumerator *pEnumerator = nullptr;
-    IMMDevice *pDevice = nullptr;
-    IAudioClient *pAudioClient = nullptr;
-    IAudioCaptureClient *pCaptureClient = nullptr;
-
-    CoInitialize(nullptr);
-
-    UINT32 packetLength = 0;
-    UINT32 numFramesAvailable = 0;
-    BYTE *pData = nullptr;
-    DWORD flags = 0;
-
-    // Get Default Capture Device (Microphone)
-    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, 
-                          __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
-    if (FAILED(hr)) goto Exit;
-
-    hr = pEnumerator->GetDefaultAudioEndpoint(eCapture, eMultimedia, &pDevice);
-    if (FAILED(hr)) goto Exit;
-
-    // Log Device Name
-    {
-        IPropertyStore *pProps = nullptr;
-        if (SUCCEEDED(pDevice->OpenPropertyStore(STGM_READ, &pProps))) {
-            PROPVARIANT varName; PropVariantInit(&varName);
-            if (SUCCEEDED(pProps->GetValue(PKEY_Device_FriendlyName, &varName))) {
-                char buffer[512];
-                snprintf(buffer, sizeof(buffer), "[WasapiRecorder] Mic Device: %ws\n", varName.pwszVal);
-                OutputDebugStringA(buffer);
-                PropVariantClear(&varName);
-            }
-            pProps->Release();
-        }
-    }
-
-    // Activate Audio Client
-    hr = pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&pAudioClient);
-    if (FAILED(hr)) goto Exit;
-
-    // Get Mix Format
+// Subscribe to both endpoints of the shared capture hub. The format copies
+// are dropped too: a pooled recorder may have last run on another device.
+void WasapiRecorder::SubscribeCapture() {
     if (pwfxMic) CoTaskMemFree(pwfxMic);
-    hr = pAudioClient->GetMixFormat(&pwfxMic);
-    if (FAILED(hr)) goto Exit;
-
-    // Initialize
-    hr = pAudioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, 0, 10000000, 0, pwfxMic, nullptr);
-    if (FAILED(hr)) goto Exit;
-
-    // Get Capture Service
-    hr = pAudioClient->GetService(__uuidof(IAudioCaptureClient), (void**)&pCaptureClient);
-    if (FAILED(hr)) goto Exit;
-
-    // Start
-    hr = pAudioClient->Start();
-    if (FAILED(hr)) goto Exit;
+    if (pwfxLoopback) CoTaskMemFree(pwfxLoopback);
+    pwfxMic = nullptr;
+    pwfxLoopback = nullptr;
+    m_captureFailed = false;
+    m_micSub = GetCaptureHub().Subscribe(CaptureEndpoint::Microphone);
+    m_loopbackSub = GetCaptureHub().Subscribe(CaptureEndpoint::Loopback);
+}
 
+// Subscriber loop: appends what the hub captured for the microphone (user's
+// voice) and loopback (system audio - CX voice) to the per-source buffers,
+// where the mixer / SaveToFile pick it up as before
+void WasapiRecorder::CaptureLoop() {
+    TRACE_THREAD_NAME("Recorder capture");
+    
     while (isRecording) {
-        if (isPaused) {
-            Sleep(10);
-            continue;
-        }
-
-        hr = pCaptureClient->GetNextPacketSize(&packetLength);
-        while (packetLength != 0) {
-            hr = pCaptureClient->GetBuffer(&pData, &numFramesAvailable, &flags, nullptr, nullptr);
-            if (FAILED(hr)) break;
-
-            std::lock_guard<std::mutex> lock(micBufferMutex);
-            int bytesToCopy = numFramesAvailable * pwfxMic->nBlockAlign;
-            size_t currentSize = micBuffer.size();
-            micBuffer.resize(currentSize + bytesToCopy);
-            
-            if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
-                memset(micBuffer.data() + currentSize, 0, bytesToCopy);
-            } else {
-                memcpy(micBuffer.data() + currentSize, pData, bytesToCopy);
-            }
-
-            pCaptureClient->ReleaseBuffer(numFramesAvailable);
-            hr = pCaptureClient->GetNextPacketSize(&packetLength);
+        DrainSubscription(m_micSub, micBufferMutex, micBuffer, pwfxMic);
+        DrainSubscription(m_loopbackSub, loopbackBufferMutex, loopbackBuffer, pwfxLoopback);
+        if (!m_captureFailed && (m_micSub.HasFailed() || m_loopbackSub.HasFailed())) {
+            OutputDebugStringA("[WasapiRecorder] Capture device failed\n");
+            m_captureFailed = true;
         }
-        
         Sleep(10);
     }
-
-    pAudioClient->Stop();
-
-Exit:
-    if (FAILED(hr) && isRecording) {
-        if (hr == AUDCLNT_E_DEVICE_INVALIDATED || hr == AUDCLNT_E_RESOURCES_INVALIDATED) {
-             OutputDebugStringA("[WasapiRecorder] Mic Disconnected/Invalidated!\n");
-        } else {
-             char errBuf[64];
-             snprintf(errBuf, sizeof(errBuf), "[WasapiRecorder] Mic Error: 0x%08X\n", hr);
-             OutputDebugStringA(errBuf);
-        }
-        
-        if (hRecorderWnd) {
-            PostMessage(hRecorderWnd, WM_APP_RECORDING_ERROR, 0, 0);
-        }
-    }
-    SafeRelease(&pCaptureClient);
-    SafeRelease(&pAudioClient);
-    SafeRelease(&pDevice);
-    SafeRelease(&pEnumerator);
-    CoUninitialize();
+    
+    // Whatever arrived up to the stop
+    DrainSubscription(m_micSub, micBufferMutex, micBuffer, pwfxMic);
+    DrainSubscription(m_loopbackSub, loopbackBufferMutex, loopbackBuffer, pwfxLoopback);
 }
 
-// Loopback capture loop (system audio - CX voice)
-void WasapiRecorder::LoopbackLoop() {
-    HRESULT hr;
-    IMMDeviceEnumerator *pEnumerator = nullptr;
-    IMMDevice *pDevice = nullptr;
-    IAudioClient *pAudioClient = nullptr;
-    IAudioCaptureClient *pCaptureClient = nullptr;
-
-    CoInitialize(nullptr);
-
-    UINT32 packetLength = 0;
-    UINT32 numFramesAvailable = 0;
-    BYTE *pData = nullptr;
-    DWORD flags = 0;
-
-    // Get Default RENDER Device (Speaker/Output) for loopback
-    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, 
-                          __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
-    if (FAILED(hr)) goto Exit;
-
-    hr = pEnumerator->GetDefaultAudioEndpoint(eRender, eMultimedia, &pDevice);
-    if (FAILED(hr)) goto Exit;
-
-    // Log Device Name
-    {
-        IPropertyStore *pProps = nullptr;
-        if (SUCCEEDED(pDevice->OpenPropertyStore(STGM_READ, &pProps))) {
-            PROPVARIANT varName; PropVariantInit(&varName);
-            if (SUCCEEDED(pProps->GetValue(PKEY_Device_FriendlyName, &varName))) {
-                char buffer[512];
-                snprintf(buffer, sizeof(buffer), "[WasapiRecorder] Loopback Device: %ws\n", varName.pwszVal);
-                OutputDebugStringA(buffer);
-                PropVariantClear(&varName);
-            }
-            pProps->Release();
-        }
-    }
-
-    // Activate Audio Client
-    hr = pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&pAudioClient);
-    if (FAILED(hr)) goto Exit;
-
-    // Get Mix Format
-    if (pwfxLoopback) CoTaskMemFree(pwfxLoopback);
-    hr = pAudioClient->GetMixFormat(&pwfxLoopback);
-    if (FAILED(hr)) goto Exit;
-
-    // Initialize with LOOPBACK flag - this captures what's being played
-    hr = pAudioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_LOOPBACK, 10000000, 0, pwfxLoopback, nullptr);
-    if (FAILED(hr)) goto Exit;
-
-    // Get Capture Service
-    hr = pAudioClient->GetService(__uuidof(IAudioCaptureClient), (void**)&pCaptureClient);
-    if (FAILED(hr)) goto Exit;
-
-    // Start
-    hr = pAudioClient->Start();
-    if (FAILED(hr)) goto Exit;
-
-    while (isRecording) {
-        if (isPaused) {
-            Sleep(10);
-            continue;
-        }
-
-        hr = pCaptureClient->GetNextPacketSize(&packetLength);
-        while (packetLength != 0) {
-            hr = pCaptureClient->GetBuffer(&pData, &numFramesAvailable, &flags, nullptr, nullptr);
-            if (FAILED(hr)) break;
-
-            std::lock_guard<std::mutex> lock(loopbackBufferMutex);
-            int bytesToCopy = numFramesAvailable * pwfxLoopback->nBlockAlign;
-            size_t currentSize = loopbackBuffer.size();
-            loopbackBuffer.resize(currentSize + bytesToCopy);
-            
-            if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
-                memset(loopbackBuffer.data() + currentSize, 0, bytesToCopy);
-            } else {
-                memcpy(loopbackBuffer.data() + currentSize, pData, bytesToCopy);
-            }
-
-            pCaptureClient->ReleaseBuffer(numFramesAvailable);
-            hr = pCaptureClient->GetNextPacketSize(&packetLength);
-        }
-        
-        Sleep(10);
+void WasapiRecorder::DrainSubscription(CaptureSubscription& sub, std::mutex& bufferMutex,
+                                       BufferPool::Buffer& buffer, WAVEFORMATEX*& pwfx) {
+    // The format is known once the hub has opened the device
+    if (!pwfx) {
+        std::vector<uint8_t> format;
+        if (!sub.GetFormat(format)) return;
+        WAVEFORMATEX* copy = (WAVEFORMATEX*)CoTaskMemAlloc(format.size());
+        if (!copy) return;
+        memcpy(copy, format.data(), format.size());
+        pwfx = copy;
     }
-
-    pAudioClient->Stop();
-
-Exit:
-    if (FAILED(hr) && isRecording) {
-         if (hr == AUDCLNT_E_DEVICE_INVALIDATED || hr == AUDCLNT_E_RESOURCES_INVALIDATED) {
-             OutputDebugStringA("[WasapiRecorder] Loopback Disconnected/Invalidated!\n");
-        } else {
-             char errBuf[64];
-             snprintf(errBuf, sizeof(errBuf), "[WasapiRecorder] Loopback Error: 0x%08X\n", hr);
-             OutputDebugStringA(errBuf);
-        }
-
-        if (hRecorderWnd) {
-            PostMessage(hRecorderWnd, WM_APP_RECORDING_ERROR, 0, 0);
-        }
+    
+    // Paused: the audio is dropped, as the device loops used to do
+    if (isPaused) {
+        sub.Skip();
+        return;
     }
-    SafeRelease(&pCaptureClient);
-    SafeRelease(&pAudioClient);
-    SafeRelease(&pDevice);
-    SafeRelease(&pEnumerator);
-    CoUninitialize();
+    
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    sub.ReadInto(buffer);
 }
 
 // Helper: Convert float sample to 16-bit PCM
@@ -389,7 +245,7 @@ static inline short FloatToShort(float sample) {
 }
 
 // Helper: Get sample from buffer at frame index (handles float/PCM, mono-mixes channels)
-static float GetSampleFromBuffer(const std::vector<BYTE>& buffer, size_t frameIndex, 
+static float GetSampleFromBuffer(const BufferPool::Buffer& buffer, size_t frameIndex,
                                   WAVEFORMATEX* pwfx, bool isFloat) {
     if (frameIndex >= buffer.size() / pwfx->nBlockAlign) return 0.0f;
     
@@ -413,7 +269,7 @@ static float GetSampleFromBuffer(const std::vector<BYTE>& buffer, size_t frameIn
 }
 
 // Linear interpolation for resampling
-static float InterpolateSample(const std::vector<BYTE>& buffer, double position,
+static float InterpolateSample(const BufferPool::Buffer& buffer, double position,
                                 WAVEFORMATEX* pwfx, bool isFloat) {
     size_t totalFrames = buffer.size() / pwfx->nBlockAlign;
     if (totalFrames == 0) return 0.0f;
@@ -431,31 +287,28 @@ static float InterpolateSample(const std::vector<BYTE>& buffer, double position,
     return s0 + (float)(frac * (s1 - s0));
 }
 
-// Mix both buffers with proper sample rate handling
-std::vector<BYTE> WasapiRecorder::MixBuffers() {
-    std::vector<BYTE> output;
-    
+static bool IsFloatFormat(const WAVEFORMATEX* pwfx) {
+    if (pwfx->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) return true;
+    if (pwfx->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
+        const WAVEFORMATEXTENSIBLE* pEx = (const WAVEFORMATEXTENSIBLE*)pwfx;
+        return IsEqualGUID(KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, pEx->SubFormat) != 0;
+    }
+    return false;
+}
+
+// Mix both buffers with proper sample rate handling. The output goes to
+// the file one second at a time through a pooled block instead of a
+// buffer the size of the whole call.
+bool WasapiRecorder::WriteMixedFile(std::ofstream& file) {
     // Lock both buffers
     std::lock_guard<std::mutex> lockMic(micBufferMutex);
     std::lock_guard<std::mutex> lockLoop(loopbackBufferMutex);
     
-    if (!pwfxMic || !pwfxLoopback) return output;
+    if (!pwfxMic || !pwfxLoopback) return false;
     
     // Detect format types
-    bool micIsFloat = false;
-    bool loopIsFloat = false;
-    
-    if (pwfxMic->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) micIsFloat = true;
-    if (pwfxMic->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
-        WAVEFORMATEXTENSIBLE *pEx = (WAVEFORMATEXTENSIBLE*)pwfxMic;
-        if (IsEqualGUID(KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, pEx->SubFormat)) micIsFloat = true;
-    }
-    
-    if (pwfxLoopback->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) loopIsFloat = true;
-    if (pwfxLoopback->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
-        WAVEFORMATEXTENSIBLE *pEx = (WAVEFORMATEXTENSIBLE*)pwfxLoopback;
-        if (IsEqualGUID(KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, pEx->SubFormat)) loopIsFloat = true;
-    }
+    bool micIsFloat = IsFloatFormat(pwfxMic);
+    bool loopIsFloat = IsFloatFormat(pwfxLoopback);
     
     // Get sample rates
     int micSampleRate = pwfxMic->nSamplesPerSec;
@@ -475,7 +328,7 @@ std::vector<BYTE> WasapiRecorder::MixBuffers() {
     
     // Output frames based on output sample rate
     size_t outputFrames = (size_t)(maxDuration * outputSampleRate);
-    if (outputFrames == 0) return output;
+    if (outputFrames == 0) return false;
     
     // Log sample rates for debugging
     char debugBuf[256];
@@ -485,38 +338,47 @@ std::vector<BYTE> WasapiRecorder::MixBuffers() {
     OutputDebugStringA(debugBuf);
     
     // Output: 16-bit mono
-    output.resize(outputFrames * 2); // 1 channel * 2 bytes per sample
-    short* outPtr = (short*)output.data();
-    
-    for (size_t i = 0; i < outputFrames; i++) {
-        // Calculate position in time (0.0 to maxDuration)
-        double timePos = (double)i / outputSampleRate;
+    WriteWavHeader(file, (int)(outputFrames * 2), outputSampleRate, OUTPUT_CHANNELS, OUTPUT_BITS);
+    
+    size_t blockFrames = (size_t)outputSampleRate;
+    BufferPool::Buffer block = GetAudioBufferPool().Acquire(blockFrames * 2);
+    for (size_t start = 0; start < outputFrames; start += blockFrames) {
+        size_t count = outputFrames - start < blockFrames ? outputFrames - start : blockFrames;
+        block.resize(count * 2);
+        short* outPtr = (short*)block.data();
         
-        // Get mic sample (resample to output rate)
-        float micSample = 0.0f;
-        if (micFrames > 0 && timePos <= micDuration) {
-            double micPos = timePos * micSampleRate;
-            micSample = InterpolateSample(micBuffer, micPos, pwfxMic, micIsFloat);
-        }
-        
-        // Get loopback sample (already at output rate, no resampling needed)
-        float loopSample = 0.0f;
-        if (loopFrames > 0 && timePos <= loopDuration) {
-            double loopPos = timePos * loopSampleRate;
-            loopSample = InterpolateSample(loopbackBuffer, loopPos, pwfxLoopback, loopIsFloat);
+        for (size_t n = 0; n < count; n++) {
+            size_t i = start + n;
+            // Calculate position in time (0.0 to maxDuration)
+            double timePos = (double)i / outputSampleRate;
+            
+            // Get mic sample (resample to output rate)
+            float micSample = 0.0f;
+            if (micFrames > 0 && timePos <= micDuration) {
+                double micPos = timePos * micSampleRate;
+                micSample = InterpolateSample(micBuffer, micPos, pwfxMic, micIsFloat);
+            }
+            
+            // Get loopback sample (already at output rate, no resampling needed)
+            float loopSample = 0.0f;
+            if (loopFrames > 0 && timePos <= loopDuration) {
+                double loopPos = timePos * loopSampleRate;
+                loopSample = InterpolateSample(loopbackBuffer, loopPos, pwfxLoopback, loopIsFloat);
+            }
+            
+            // Mono output: Mix Mic + Loopback
+            float mixedSample = micSample + loopSample;
+            
+            // Clamp to prevent clipping
+            if (mixedSample > 1.0f) mixedSample = 1.0f;
+            if (mixedSample < -1.0f) mixedSample = -1.0f;
+            
+            outPtr[n] = FloatToShort(mixedSample);
         }
-        
-        // Mono output: Mix Mic + Loopback
-        float mixedSample = micSample + loopSample;
-        
-        // Clamp to prevent clipping
-        if (mixedSample > 1.0f) mixedSample = 1.0f;
-        if (mixedSample < -1.0f) mixedSample = -1.0f;
-        
-        outPtr[i] = FloatToShort(mixedSample);
+        file.write((const char*)block.data(), block.size());
     }
     
-    return output;
+    return file.good();
 }
 
 
@@ -545,27 +407,20 @@ void WasapiRecorder::WriteWavHeader(std::ofstream& file, int totalDataLen, int s
 }
 
 bool WasapiRecorder::SaveToFile(const std::string& filename) {
-    // Mix both buffers
-    std::vector<BYTE> mixedAudio = MixBuffers();
-    
-    if (mixedAudio.empty()) return false;
-
     std::ofstream file(filename, std::ios::binary);
     if (!file.is_open()) return false;
 
-    // Use output format: 48kHz stereo 16-bit (or use actual sample rate from loopback)
-    int sampleRate = pwfxLoopback ? pwfxLoopback->nSamplesPerSec : OUTPUT_SAMPLE_RATE;
-    
-    WriteWavHeader(file, (int)mixedAudio.size(), sampleRate, OUTPUT_CHANNELS, OUTPUT_BITS);
-    
-    file.write((char*)mixedAudio.data(), mixedAudio.size());
+    // Mix both buffers: loopback sample rate, mono 16-bit
+    bool ok = WriteMixedFile(file);
     file.close();
-    return true;
+    if (!ok) DeleteFileA(filename.c_str());
+    return ok;
 }
 
 // Mixer thread: periodically mixes captured audio and writes to disk
 void WasapiRecorder::MixerLoop() {
     OutputDebugStringA("[WasapiRecorder] Mixer thread started\n");
+    TRACE_THREAD_NAME("Mixer");
     
     while (isRecording) {
         // Wait for flush interval or stop signal
@@ -582,49 +437,40 @@ void WasapiRecorder::MixerLoop() {
     }
     
     // Final flush of remaining audio
-    MixAndWriteChunk();
+    MixAndWriteChunk(true);
     
     OutputDebugStringA("[WasapiRecorder] Mixer thread stopped\n");
 }
 
 // Mix currently buffered audio and write to disk
-void WasapiRecorder::MixAndWriteChunk() {
+void WasapiRecorder::MixAndWriteChunk(bool final) {
     if (!m_pWriter || !m_pWriter->IsActive()) return;
+    TRACE_SCOPE(MixChunk);
     
-    // Get copies of current buffers and clear them
-    std::vector<BYTE> micCopy, loopCopy;
+    // Take the filled buffers and leave recycled ones of the same size in
+    // their place (after the first chunks the pool always has them)
+    BufferPool& pool = GetAudioBufferPool();
+    BufferPool::Buffer micCopy, loopCopy;
     
     {
         std::lock_guard<std::mutex> lock(micBufferMutex);
         micCopy = std::move(micBuffer);
-        micBuffer.clear();
+        micBuffer = pool.Acquire(micCopy.capacity());
     }
     {
         std::lock_guard<std::mutex> lock(loopbackBufferMutex);
         loopCopy = std::move(loopbackBuffer);
-        loopbackBuffer.clear();
+        loopbackBuffer = pool.Acquire(loopCopy.capacity());
     }
     
-    if (micCopy.empty() && loopCopy.empty()) return;
+    if (micCopy.empty() && loopCopy.empty() && !final) return;
     
     // Need format info for mixing
     if (!pwfxMic || !pwfxLoopback) return;
     
     // Detect format types
-    bool micIsFloat = false;
-    bool loopIsFloat = false;
-    
-    if (pwfxMic->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) micIsFloat = true;
-    if (pwfxMic->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
-        WAVEFORMATEXTENSIBLE *pEx = (WAVEFORMATEXTENSIBLE*)pwfxMic;
-        if (IsEqualGUID(KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, pEx->SubFormat)) micIsFloat = true;
-    }
-    
-    if (pwfxLoopback->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) loopIsFloat = true;
-    if (pwfxLoopback->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
-        WAVEFORMATEXTENSIBLE *pEx = (WAVEFORMATEXTENSIBLE*)pwfxLoopback;
-        if (IsEqualGUID(KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, pEx->SubFormat)) loopIsFloat = true;
-    }
+    bool micIsFloat = IsFloatFormat(pwfxMic);
+    bool loopIsFloat = IsFloatFormat(pwfxLoopback);
     
     // Get sample rates
     int micSampleRate = pwfxMic->nSamplesPerSec;
@@ -640,16 +486,32 @@ void WasapiRecorder::MixAndWriteChunk() {
     double loopDuration = (loopFrames > 0) ? (double)loopFrames / loopSampleRate : 0.0;
     double maxDuration = (micDuration > loopDuration) ? micDuration : loopDuration;
     
-    // Output frames
+    // Output frames. The last chunk runs on for the look-ahead of the mic
+    // chain and the mix limiter with silent input, which pushes out the
+    // end of the call they are still holding.
     size_t outputFrames = (size_t)(maxDuration * outputSampleRate);
+    if (final) outputFrames += m_micDsp.GetLatency() + m_mixLimiter.GetLatency();
     if (outputFrames == 0) return;
     
-    // Create output buffer (16-bit mono)
-    std::vector<BYTE> output(outputFrames * 2);
+    // Output buffer (16-bit mono), handed to the writer and back to the pool
+    BufferPool::Buffer output = pool.Acquire(outputFrames * 2);
+    output.resize(outputFrames * 2);
     short* outPtr = (short*)output.data();
     
+    // Both tracks at the output rate, before summing (mic DSP, analytics),
+    // and their sum
+    BufferPool::Buffer micTrack = pool.Acquire(outputFrames * sizeof(float));
+    BufferPool::Buffer loopTrack = pool.Acquire(outputFrames * sizeof(float));
+    BufferPool::Buffer mixTrack = pool.Acquire(outputFrames * sizeof(float));
+    micTrack.resize(outputFrames * sizeof(float));
+    loopTrack.resize(outputFrames * sizeof(float));
+    mixTrack.resize(outputFrames * sizeof(float));
+    float* micTrackPtr = (float*)micTrack.data();
+    float* loopTrackPtr = (float*)loopTrack.data();
+    float* mixTrackPtr = (float*)mixTrack.data();
+    
     // Helper lambda for getting samples (simplified interpolation)
-    auto getSample = [](const std::vector<BYTE>& buf, size_t frame, WAVEFORMATEX* pwfx, bool isFloat) -> float {
+    auto getSample = [](const BufferPool::Buffer& buf, size_t frame, WAVEFORMATEX* pwfx, bool isFloat) -> float {
         if (buf.empty() || !pwfx || frame >= buf.size() / pwfx->nBlockAlign) return 0.0f;
         size_t offset = frame * pwfx->nBlockAlign;
         float sample = 0.0f;
@@ -682,10 +544,34 @@ void WasapiRecorder::MixAndWriteChunk() {
             loopSample = getSample(loopCopy, loopFrame, pwfxLoopback, loopIsFloat);
         }
         
-        // Mono output: Mix Mic + Loopback
-        float mixedSample = micSample + loopSample;
+        micTrackPtr[i] = micSample;
+        loopTrackPtr[i] = loopSample;
+    }
+    
+    // Mic DSP chain in 10 ms blocks (per-stage CPU time in GetMicDspTimings)
+    {
+        TRACE_SCOPE(MicDsp);
+        m_micDsp.Process(micTrackPtr, outputFrames);
+    }
+    
+    // The chain delays the mic by its look-ahead; delay the loopback to match
+    if (!m_loopDelay.empty()) {
+        for (size_t i = 0; i < outputFrames; i++) {
+            float delayed = m_loopDelay[m_loopDelayPos];
+            m_loopDelay[m_loopDelayPos] = loopTrackPtr[i];
+            loopTrackPtr[i] = delayed;
+            if (++m_loopDelayPos == m_loopDelay.size()) m_loopDelayPos = 0;
+        }
+    }
+    
+    // Mono output: Mix Mic + Loopback, limited rather than clipped
+    for (size_t i = 0; i < outputFrames; i++) mixTrackPtr[i] = micTrackPtr[i] + loopTrackPtr[i];
+    m_mixLimiter.Process(mixTrackPtr, outputFrames);
+    
+    for (size_t i = 0; i < outputFrames; i++) {
+        float mixedSample = mixTrackPtr[i];
         
-        // Clamp
+        // Clamp (only bites with the limiter off)
         if (mixedSample > 1.0f) mixedSample = 1.0f;
         if (mixedSample < -1.0f) mixedSample = -1.0f;
         
@@ -714,16 +600,26 @@ void WasapiRecorder::MixAndWriteChunk() {
         return;
     }
 
-    char debug[128];
-    snprintf(debug, sizeof(debug), "[WasapiRecorder] Wrote %.2f sec chunk to disk\n", maxDuration);
-    OutputDebugStringA(debug);
+    // Energy per 20 ms only - the segmentation runs once at finalize
+    m_vad.AddPcm16(outPtr, outputFrames);
+
+    // Talk/overlap/monologue counters, one pass over both tracks
+    std::lock_guard<std::mutex> lock(m_analyticsMutex);
+    m_analytics.AddFrames(micTrackPtr, loopTrackPtr, outputFrames);
 }
 
-std::string WasapiRecorder::FinalizeStreaming(const std::string& filename) {
+std::string WasapiRecorder::FinalizeStreaming(const std::string& filename, const WavMetadata* metadata) {
     if (!m_pWriter) return "";
     
     // Finalize the streaming writer
-    std::string result = m_pWriter->Finalize(filename);
+    std::string result = m_pWriter->Finalize(filename, metadata);
+
+    // Voice-activity map next to the recording (player seek bar / skip silence),
+    // not for encrypted recordings (the player rebuilds it in memory)
+    VoiceActivityMap vad = m_vad.Finish();
+    if (!result.empty() && !vad.IsEmpty() && !m_pWriter->IsEncrypted()) {
+        vad.Save(VoiceActivityMap::GetSidecarPath(result));
+    }
     
     // Delete writer for next recording
     delete m_pWriter;
@@ -732,6 +628,11 @@ std::string WasapiRecorder::FinalizeStreaming(const std::string& filename) {
     return result;
 }
 
+ConversationStats WasapiRecorder::GetConversationStats() const {
+    std::lock_guard<std::mutex> lock(m_analyticsMutex);
+    return m_analytics.GetStats();
+}
+
 double WasapiRecorder::GetDurationSeconds() const {
     if (isRecording && !isPaused) {
         return (double)(GetTickCount64() - m_recordingStartTime) / 1000.0;
@@ -13,6 +13,12 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include "audio/WavMetadata.h"
+#include "audio/VoiceActivity.h"
+#include "audio/ConversationAnalytics.h"
+#include "audio/DspChain.h"
+#include "audio/CaptureHub.h"
+#include "core/buffer_pool.h"
 
 // Forward declaration
 class StreamingWavWriter;
@@ -29,6 +35,11 @@ public:
     bool StartStreaming(const std::string& outputFolder);
     
     void Stop();
+
+    // Signal the capture and mixer threads to finish without waiting for
+    // them; Stop() later joins them (see RecordingHandoff)
+    void RequestStop();
+
     void Pause();
     void Resume();
     
@@ -36,7 +47,8 @@ public:
     bool SaveToFile(const std::string& filename);
     
     // Finalize streaming recording and return final filename
-    std::string FinalizeStreaming(const std::string& filename);
+    // metadata (optional) is embedded in the WAV header region
+    std::string FinalizeStreaming(const std::string& filename, const WavMetadata* metadata = nullptr);
     
     // Clears the current buffer
     void Clear();
@@ -44,42 +56,76 @@ public:
     bool IsRecording() const { return isRecording; }
     bool IsPaused() const { return isPaused; }
     bool IsStreaming() const { return m_streamingMode; }
+
+    // A capture device failed under this recording (e.g. unplugged); what
+    // was captured up to then is still in the buffers
+    bool HasCaptureFailed() const { return m_captureFailed; }
     
     // Get current recording duration in seconds
     double GetDurationSeconds() const;
 
+    // Talk/silence/overlap statistics of the streaming recording so far
+    // (complete once Stop() has returned)
+    ConversationStats GetConversationStats() const;
+
 private:
-    void MicrophoneLoop();    // Captures microphone audio
-    void LoopbackLoop();      // Captures system audio (loopback)
+    void CaptureLoop();       // Moves mic + loopback audio from the capture hub into the buffers
     void MixerLoop();         // Mixes and writes to disk (streaming mode)
+    void SubscribeCapture();
+    void DrainSubscription(CaptureSubscription& sub, std::mutex& bufferMutex, BufferPool::Buffer& buffer,
+                           WAVEFORMATEX*& pwfx);
     void WriteWavHeader(std::ofstream& file, int totalDataLen, int sampleRate, int channels, int bitsPerSample);
     
-    // Mix two buffers into one (stereo: mic=left, loopback=right)
-    std::vector<BYTE> MixBuffers();
+    // Mix both buffers (legacy mode) straight into a WAV file, a block at a time
+    bool WriteMixedFile(std::ofstream& file);
     
-    // Mix a chunk of data for streaming mode
-    void MixAndWriteChunk();
+    // Mix a chunk of data for streaming mode. The last one also flushes
+    // the audio still held in the DSP look-ahead.
+    void MixAndWriteChunk(bool final = false);
 
     std::atomic<bool> isRecording;
     std::atomic<bool> isPaused;
     std::atomic<ULONGLONG> m_recordingStartTime;
     std::atomic<bool> m_streamingMode;
     
-    // Capture threads
-    std::thread micThread;
-    std::thread loopbackThread;
+    // Subscriptions to the shared capture hub (the device clients are
+    // shared with the other recorder and the meters) and the thread that
+    // drains them
+    CaptureSubscription m_micSub;
+    CaptureSubscription m_loopbackSub;
+    std::thread captureThread;
     std::thread mixerThread;  // For streaming mode
+    std::atomic<bool> m_captureFailed{false};
 
-    // Separate buffers for each source (used as circular buffers in streaming mode)
+    // Separate buffers for each source, from the audio buffer pool. In
+    // streaming mode the mixer takes the filled buffer every chunk and
+    // leaves a recycled one of the same size in its place.
     std::mutex micBufferMutex;
-    std::vector<BYTE> micBuffer;
+    BufferPool::Buffer micBuffer;
     
     std::mutex loopbackBufferMutex;
-    std::vector<BYTE> loopbackBuffer;
+    BufferPool::Buffer loopbackBuffer;
     
     // Streaming writer
     StreamingWavWriter* m_pWriter;
     std::string m_outputFolder;
+
+    // Voice-activity map of the mix, saved as <name>.vad on finalize
+    VoiceActivityDetector m_vad;
+
+    // Conversation analytics over the mic and loopback tracks (mixer thread)
+    mutable std::mutex m_analyticsMutex;
+    ConversationAnalytics m_analytics;
+
+    // Mic track DSP (high-pass, gate, AGC, limiter...) before mixing, and a
+    // limiter on the mix in place of hard clipping (mixer thread only)
+    DspChain m_micDsp;
+    DspChain m_mixLimiter;
+
+    // Loopback delayed by the mic chain's look-ahead, so both tracks line
+    // up again before mixing (ring, allocated in StartStreaming)
+    std::vector<float> m_loopDelay;
+    size_t m_loopDelayPos = 0;
     
     // Mixer synchronization
     std::mutex m_mixerMutex;
@@ -88,7 +134,7 @@ private:
     static const ULONGLONG FLUSH_INTERVAL_MS = 2000; // Flush every 2 seconds
     static const size_t MAX_BUFFER_SIZE = 5 * 1024 * 1024; // 5MB max buffer (~25 seconds)
     
-    // Audio Formats (may differ between devices)
+    // Audio Formats (may differ between devices), copied from the hub
     WAVEFORMATEX* pwfxMic;
     WAVEFORMATEX* pwfxLoopback;
     
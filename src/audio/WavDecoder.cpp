@@ -0,0 +1,235 @@
+#include "audio/WavDecoder.h"
+#include "audio/ImaAdpcm.h"
+#include <algorithm>
+#include <cstring>
+
+static const uint16_t FORMAT_PCM = 0x0001;
+static const uint16_t FORMAT_FLOAT = 0x0003;
+static const uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+// Frames in a (possibly truncated) ADPCM block of the given size
+static uint32_t AdpcmFramesInBlock(uint32_t bytes, uint16_t channels) {
+    if (bytes < 4u * channels) return 0;
+    return 1 + ((bytes - 4u * channels) / (4u * channels)) * 8;
+}
+
+// One sample of any supported PCM/float layout (little endian)
+static float SampleToFloat(const uint8_t* p, uint32_t bps, bool isFloat) {
+    if (isFloat) {
+        float v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+    switch (bps) {
+        case 1: return (p[0] - 128) * (1.0f / 128.0f);
+        case 2: return (int16_t)(p[0] | (p[1] << 8)) * (1.0f / 32768.0f);
+        case 3: return (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) * (1.0f / 2147483648.0f);
+        default: return (int32_t)((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24) * (1.0f / 2147483648.0f);
+    }
+}
+
+bool WavDecoder::Open(const std::string& path) {
+    Close();
+
+    if (m_mapped.Open(path)) {
+        m_info = m_mapped.GetInfo();
+    } else if (EncryptedRecording::IsEncrypted(path)) {
+        m_encrypted.reset(new EncryptedRecordingReader());
+        if (!m_encrypted->Open(path, GetRecordingKeyring()) || !m_encrypted->GetWavInfo(m_info)) {
+            m_encrypted.reset();
+            return false;
+        }
+    } else {
+        WavMetadata metadata;
+        WavMeta::Read(path, metadata, &m_info);
+    }
+    if (m_info.channels == 0 || m_info.sampleRate == 0 || m_info.blockAlign == 0 || m_info.dataOffset == 0) {
+        return false;
+    }
+
+    if (m_info.formatTag == ImaAdpcm::FORMAT_TAG) {
+        m_adpcm = true;
+        m_samplesPerBlock = ImaAdpcm::GetSamplesPerBlock(m_info.blockAlign, m_info.channels);
+        if (m_samplesPerBlock == 0) return false;
+        uint64_t fullBlocks = m_info.dataBytes / m_info.blockAlign;
+        uint32_t tail = (uint32_t)(m_info.dataBytes % m_info.blockAlign);
+        m_totalFrames = fullBlocks * m_samplesPerBlock + AdpcmFramesInBlock(tail, m_info.channels);
+        m_blockBytes.resize(m_info.blockAlign);
+        m_blockPcm.resize((size_t)m_samplesPerBlock * m_info.channels);
+    } else {
+        // Extensible 32-bit is what WASAPI mix formats produce - float
+        m_float = m_info.formatTag == FORMAT_FLOAT ||
+                  (m_info.formatTag == FORMAT_EXTENSIBLE && m_info.bitsPerSample == 32);
+        if (!m_float && m_info.formatTag != FORMAT_PCM && m_info.formatTag != FORMAT_EXTENSIBLE) return false;
+        m_bytesPerSample = m_info.bitsPerSample / 8;
+        if (m_bytesPerSample < 1 || m_bytesPerSample > 4 || (m_float && m_bytesPerSample != 4)) return false;
+        if (m_info.blockAlign != m_bytesPerSample * m_info.channels) return false;
+        m_totalFrames = m_info.dataBytes / m_info.blockAlign;
+    }
+
+    if (m_mapped.IsOpen()) {
+        m_path = path;
+        m_mapped.SetAccessPattern(MappedFile::Access::Sequential);
+        m_windowData = reinterpret_cast<const char*>(m_mapped.GetDataChunk());
+        m_windowLen = (size_t)m_info.dataBytes;
+        PrefetchAhead();
+        return true;
+    }
+
+    if (!m_encrypted) {
+        m_file.open(path, std::ios::binary);
+        if (!m_file.is_open()) return false;
+    }
+    m_path = path;
+    m_window.resize(READ_AHEAD_BYTES);
+    m_windowData = m_window.data();
+    return true;
+}
+
+void WavDecoder::Close() {
+    m_mapped.Close();
+    if (m_file.is_open()) m_file.close();
+    m_file.clear();
+    m_encrypted.reset();
+    m_path.clear();
+    m_info = WavInfo();
+    m_totalFrames = 0;
+    m_position = 0;
+    m_adpcm = false;
+    m_float = false;
+    m_bytesPerSample = 0;
+    m_windowData = nullptr;
+    m_windowStart = 0;
+    m_windowLen = 0;
+    m_prefetchFrom = 0;
+    m_prefetchTo = 0;
+    m_samplesPerBlock = 0;
+    m_blockIndex = UINT64_MAX;
+    m_blockFrames = 0;
+}
+
+bool WavDecoder::ReadBytes(uint64_t offset, void* out, size_t len) {
+    char* dst = static_cast<char*>(out);
+    while (len > 0) {
+        if (offset < m_windowStart || offset >= m_windowStart + m_windowLen) {
+            if (m_mapped.IsOpen()) return false; // Past the end of the data chunk
+            // Refill the window starting at offset
+            uint64_t remaining = m_info.dataBytes > offset ? m_info.dataBytes - offset : 0;
+            size_t want = (size_t)std::min<uint64_t>(m_window.size(), remaining);
+            if (want == 0) return false;
+            m_windowStart = offset;
+            if (m_encrypted) {
+                // Fails on a chunk that does not authenticate - no audio from it
+                m_windowLen = m_encrypted->Read(m_info.dataOffset + offset, m_window.data(), want) ? want : 0;
+            } else {
+                m_file.clear();
+                m_file.seekg((std::streamoff)(m_info.dataOffset + offset), std::ios::beg);
+                m_file.read(m_window.data(), (std::streamsize)want);
+                m_windowLen = (size_t)m_file.gcount();
+            }
+            if (m_windowLen == 0) return false;
+        }
+        size_t inWindow = (size_t)(offset - m_windowStart);
+        size_t n = std::min(len, m_windowLen - inWindow);
+        memcpy(dst, m_windowData + inWindow, n);
+        dst += n;
+        offset += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool WavDecoder::DecodeAdpcmBlock(uint64_t block) {
+    if (block == m_blockIndex) return m_blockFrames > 0;
+    uint64_t offset = block * m_info.blockAlign;
+    uint32_t bytes = (uint32_t)std::min<uint64_t>(m_info.blockAlign, m_info.dataBytes - offset);
+    m_blockIndex = block;
+    m_blockFrames = 0;
+    if (!ReadBytes(offset, m_blockBytes.data(), bytes)) return false;
+    m_blockFrames = ImaAdpcm::DecodeBlock(reinterpret_cast<uint8_t*>(m_blockBytes.data()), bytes,
+                                          m_info.channels, m_blockPcm.data());
+    return m_blockFrames > 0;
+}
+
+// Mapped: keep the OS reading up to two windows ahead of the decode position
+void WavDecoder::PrefetchAhead() {
+    uint64_t offset = m_adpcm ? m_position / m_samplesPerBlock * m_info.blockAlign
+                              : m_position * m_info.blockAlign;
+    if (offset >= m_prefetchFrom && offset + READ_AHEAD_BYTES < m_prefetchTo) return;
+    m_mapped.PrefetchFrames(offset / m_info.blockAlign, READ_AHEAD_BYTES * 2 / m_info.blockAlign);
+    m_prefetchFrom = offset;
+    m_prefetchTo = offset + READ_AHEAD_BYTES * 2;
+}
+
+size_t WavDecoder::Read(float* out, size_t maxFrames) {
+    if (!IsOpen()) return 0;
+    if (m_mapped.IsOpen()) PrefetchAhead();
+    const uint16_t channels = m_info.channels;
+    size_t frames = (size_t)std::min<uint64_t>(maxFrames, m_totalFrames - m_position);
+    size_t done = 0;
+
+    if (m_adpcm) {
+        while (done < frames) {
+            uint64_t block = m_position / m_samplesPerBlock;
+            if (!DecodeAdpcmBlock(block)) break;
+            uint32_t inBlock = (uint32_t)(m_position % m_samplesPerBlock);
+            if (inBlock >= m_blockFrames) break;
+            size_t n = std::min<size_t>(frames - done, m_blockFrames - inBlock);
+            const int16_t* src = m_blockPcm.data() + (size_t)inBlock * channels;
+            float* dst = out + done * channels;
+            for (size_t i = 0; i < n * channels; i++) dst[i] = src[i] * (1.0f / 32768.0f);
+            done += n;
+            m_position += n;
+        }
+        return done;
+    }
+
+    // PCM/float: convert straight out of the read-ahead window
+    const uint32_t bps = m_bytesPerSample;
+    while (done < frames) {
+        uint64_t offset = m_position * m_info.blockAlign;
+        if (offset < m_windowStart || offset >= m_windowStart + m_windowLen) {
+            uint8_t probe;
+            if (!ReadBytes(offset, &probe, 1)) break; // Refills the window
+        }
+        size_t avail = (m_windowLen - (size_t)(offset - m_windowStart)) / m_info.blockAlign;
+        if (avail == 0) {
+            // Frame straddles the window end - take the slow path for it
+            std::vector<uint8_t> frame(m_info.blockAlign);
+            if (!ReadBytes(offset, frame.data(), frame.size())) break;
+            for (uint16_t ch = 0; ch < channels; ch++) {
+                out[done * channels + ch] = SampleToFloat(frame.data() + ch * bps, bps, m_float);
+            }
+            done++;
+            m_position++;
+            continue;
+        }
+
+        size_t n = std::min(frames - done, avail);
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(m_windowData) + (offset - m_windowStart);
+        float* dst = out + done * channels;
+        size_t samples = n * channels;
+        if (m_float) {
+            memcpy(dst, src, samples * 4);
+        } else if (bps == 2) {
+            for (size_t i = 0; i < samples; i++) {
+                int16_t s;
+                memcpy(&s, src + i * 2, 2);
+                dst[i] = s * (1.0f / 32768.0f);
+            }
+        } else {
+            for (size_t i = 0; i < samples; i++) dst[i] = SampleToFloat(src + i * bps, bps, false);
+        }
+        done += n;
+        m_position += n;
+    }
+    return done;
+}
+
+bool WavDecoder::Seek(uint64_t frame) {
+    if (!IsOpen()) return false;
+    m_position = std::min(frame, m_totalFrames);
+    // ADPCM blocks decode on demand in Read; PCM is a plain offset
+    if (m_mapped.IsOpen()) PrefetchAhead();
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "audio/WavMetadata.h"
+#include "audio/MappedWavReader.h"
+#include "storage/encrypted_recording.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+// Streaming WAV decoder used by the playback engine.
+//
+// Supports PCM 8/16/24/32-bit, IEEE float and IMA ADPCM (archived
+// recordings). Output is interleaved float in the file's own rate and
+// channel count. The file is memory-mapped when possible (see
+// MappedWavReader), so any seek is a pointer offset and sequential decoding
+// prefetches READ_AHEAD_BYTES ahead. If mapping fails (e.g. a huge file in
+// a 32-bit process) it falls back to a stream with a read-ahead window of
+// the same size. Encrypted recordings go through the same window, which is
+// refilled by decrypting only the chunks it covers (app keyring).
+class WavDecoder {
+public:
+    static constexpr size_t READ_AHEAD_BYTES = 256 * 1024;
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_windowData != nullptr; }
+    bool IsMapped() const { return m_mapped.IsOpen(); }
+    bool IsEncrypted() const { return m_encrypted != nullptr; }
+
+    const std::string& GetPath() const { return m_path; }
+    const WavInfo& GetInfo() const { return m_info; }
+    uint32_t GetSampleRate() const { return m_info.sampleRate; }
+    uint16_t GetChannels() const { return m_info.channels; }
+    uint64_t GetTotalFrames() const { return m_totalFrames; }
+    uint64_t GetPosition() const { return m_position; }
+
+    // Decode up to maxFrames frames into out (maxFrames * channels floats).
+    // Returns frames decoded; 0 at end of stream or on a read error.
+    size_t Read(float* out, size_t maxFrames);
+
+    // Sample-accurate: the next Read starts exactly at frame
+    bool Seek(uint64_t frame);
+
+private:
+    // Copy len bytes at file offset (relative to the data chunk) through
+    // the read-ahead window
+    bool ReadBytes(uint64_t offset, void* out, size_t len);
+    void PrefetchAhead();
+    bool DecodeAdpcmBlock(uint64_t block);
+
+    std::string m_path;
+    MappedWavReader m_mapped;
+    std::ifstream m_file;
+    std::unique_ptr<EncryptedRecordingReader> m_encrypted;
+    WavInfo m_info;
+    uint64_t m_totalFrames = 0;
+    uint64_t m_position = 0;
+    bool m_adpcm = false;
+    bool m_float = false;
+    uint32_t m_bytesPerSample = 0;
+
+    // Window over the data chunk: the whole chunk when mapped, otherwise
+    // a read-ahead buffer refilled from the stream
+    std::vector<char> m_window;
+    const char* m_windowData = nullptr;
+    uint64_t m_windowStart = 0;
+    size_t m_windowLen = 0;
+    uint64_t m_prefetchFrom = 0;    // Mapped: data range last prefetched
+    uint64_t m_prefetchTo = 0;
+
+    // ADPCM: current decoded block
+    uint32_t m_samplesPerBlock = 0;
+    uint64_t m_blockIndex = UINT64_MAX;
+    uint32_t m_blockFrames = 0;
+    std::vector<char> m_blockBytes;
+    std::vector<int16_t> m_blockPcm;
+};
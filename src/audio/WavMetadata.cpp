@@ -0,0 +1,229 @@
+#include "audio/WavMetadata.h"
+#include <fstream>
+#include <cstring>
+#include <iterator>
+
+namespace WavMeta {
+
+static const uint16_t COMPACT_VERSION = 1;
+
+// Map of metadata keys that are mirrored into standard LIST/INFO tags
+static const struct { const char* tag; const char* key; } INFO_TAGS[] = {
+    { "INAM", "file" },
+    { "ICRD", "start_time" },
+    { "ISFT", "software" },
+    { "ICMT", "comment" },
+};
+
+static void AppendU16(std::vector<char>& buf, uint16_t v) {
+    buf.insert(buf.end(), reinterpret_cast<char*>(&v), reinterpret_cast<char*>(&v) + 2);
+}
+
+static void AppendU32(std::vector<char>& buf, uint32_t v) {
+    buf.insert(buf.end(), reinterpret_cast<char*>(&v), reinterpret_cast<char*>(&v) + 4);
+}
+
+static void AppendChunk(std::vector<char>& buf, const char* id, const std::vector<char>& payload) {
+    buf.insert(buf.end(), id, id + 4);
+    AppendU32(buf, (uint32_t)payload.size());
+    buf.insert(buf.end(), payload.begin(), payload.end());
+    if (payload.size() & 1) buf.push_back(0); // RIFF chunks are word aligned
+}
+
+std::vector<char> BuildHeader(uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample,
+                              uint32_t dataBytes, uint32_t trailingBytes) {
+    std::vector<char> out;
+    out.reserve(DATA_OFFSET);
+    uint16_t blockAlign = (uint16_t)(channels * bitsPerSample / 8);
+
+    out.insert(out.end(), { 'R', 'I', 'F', 'F' });
+    AppendU32(out, DATA_OFFSET - 8 + dataBytes + trailingBytes);
+    out.insert(out.end(), { 'W', 'A', 'V', 'E' });
+
+    out.insert(out.end(), { 'f', 'm', 't', ' ' });
+    AppendU32(out, 16);
+    AppendU16(out, 1); // PCM
+    AppendU16(out, channels);
+    AppendU32(out, sampleRate);
+    AppendU32(out, sampleRate * blockAlign);
+    AppendU16(out, blockAlign);
+    AppendU16(out, bitsPerSample);
+
+    // Reserved region for metadata, filled in on Finalize.
+    // Players skip JUNK chunks, and it keeps audio data sector aligned.
+    out.insert(out.end(), { 'J', 'U', 'N', 'K' });
+    AppendU32(out, RESERVED_REGION_SIZE - 8);
+    out.resize(DATA_CHUNK_OFFSET, 0);
+
+    out.insert(out.end(), { 'd', 'a', 't', 'a' });
+    AppendU32(out, dataBytes);
+    return out;
+}
+
+std::vector<char> EncodeCompact(const WavMetadata& metadata) {
+    std::vector<char> out;
+    AppendU16(out, COMPACT_VERSION);
+    AppendU16(out, (uint16_t)metadata.size());
+    for (const auto& kv : metadata) {
+        uint16_t keyLen = (uint16_t)(kv.first.size() > 0xFFFF ? 0xFFFF : kv.first.size());
+        AppendU16(out, keyLen);
+        out.insert(out.end(), kv.first.begin(), kv.first.begin() + keyLen);
+        AppendU32(out, (uint32_t)kv.second.size());
+        out.insert(out.end(), kv.second.begin(), kv.second.end());
+    }
+    return out;
+}
+
+bool DecodeCompact(const char* data, size_t size, WavMetadata& out) {
+    if (size < 4) return false;
+    uint16_t version, count;
+    memcpy(&version, data, 2);
+    memcpy(&count, data + 2, 2);
+    if (version != COMPACT_VERSION) return false;
+
+    size_t pos = 4;
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t keyLen;
+        uint32_t valLen;
+        if (pos + 2 > size) return false;
+        memcpy(&keyLen, data + pos, 2); pos += 2;
+        if (pos + keyLen + 4 > size) return false;
+        std::string key(data + pos, keyLen); pos += keyLen;
+        memcpy(&valLen, data + pos, 4); pos += 4;
+        if (pos + valLen > size) return false;
+        out[key] = std::string(data + pos, valLen);
+        pos += valLen;
+    }
+    return true;
+}
+
+std::vector<char> BuildChunks(const WavMetadata& metadata) {
+    std::vector<char> out;
+
+    // LIST/INFO with the subset of fields other tools understand
+    std::vector<char> info;
+    info.insert(info.end(), { 'I', 'N', 'F', 'O' });
+    for (const auto& t : INFO_TAGS) {
+        auto it = metadata.find(t.key);
+        if (it == metadata.end() || it->second.empty()) continue;
+        std::vector<char> text(it->second.begin(), it->second.end());
+        text.push_back(0); // INFO strings are zero-terminated
+        AppendChunk(info, t.tag, text);
+    }
+    if (info.size() > 4) AppendChunk(out, "LIST", info);
+
+    AppendChunk(out, "mmdt", EncodeCompact(metadata));
+    return out;
+}
+
+static void ParseInfoList(const char* data, size_t size, WavMetadata& out) {
+    size_t pos = 4; // Skip "INFO"
+    while (pos + 8 <= size) {
+        uint32_t len;
+        memcpy(&len, data + pos + 4, 4);
+        if (pos + 8 + len > size) break;
+        for (const auto& t : INFO_TAGS) {
+            if (memcmp(data + pos, t.tag, 4) == 0) {
+                std::string value(data + pos + 8, len);
+                size_t z = value.find('\0');
+                if (z != std::string::npos) value.resize(z);
+                // Only fill gaps - "mmdt" is authoritative
+                if (out.find(t.key) == out.end()) out[t.key] = value;
+            }
+        }
+        pos += 8 + len + (len & 1);
+    }
+}
+
+bool Read(const std::string& wavPath, WavMetadata& out, WavInfo* info) {
+    std::ifstream file(wavPath, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char riff[12];
+    if (!file.read(riff, 12) || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    file.seekg(12, std::ios::beg);
+
+    WavInfo localInfo;
+    bool foundCompact = false;
+    WavMetadata infoTags;
+    uint64_t pos = 12;
+
+    while (pos + 8 <= fileSize) {
+        char hdr[8];
+        if (!file.read(hdr, 8)) break;
+        uint32_t len;
+        memcpy(&len, hdr + 4, 4);
+        uint64_t payload = pos + 8;
+
+        if (memcmp(hdr, "fmt ", 4) == 0 && len >= 16) {
+            char fmt[16];
+            file.read(fmt, 16);
+            memcpy(&localInfo.formatTag, fmt, 2);
+            memcpy(&localInfo.channels, fmt + 2, 2);
+            memcpy(&localInfo.sampleRate, fmt + 4, 4);
+            memcpy(&localInfo.byteRate, fmt + 8, 4);
+            memcpy(&localInfo.blockAlign, fmt + 12, 2);
+            memcpy(&localInfo.bitsPerSample, fmt + 14, 2);
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            localInfo.dataOffset = payload;
+            // Size 0 means the header was never patched (crashed temp file)
+            localInfo.dataBytes = (len == 0 || payload + len > fileSize) ? fileSize - payload : len;
+            if (foundCompact || len == 0) break; // Metadata was in the header region
+            len = (uint32_t)localInfo.dataBytes;
+        } else if (memcmp(hdr, "mmdt", 4) == 0 && len < (1u << 24)) {
+            std::vector<char> buf(len);
+            if (file.read(buf.data(), len)) {
+                foundCompact = DecodeCompact(buf.data(), len, out);
+            }
+        } else if (memcmp(hdr, "LIST", 4) == 0 && len >= 4 && len < (1u << 20)) {
+            std::vector<char> buf(len);
+            if (file.read(buf.data(), len) && memcmp(buf.data(), "INFO", 4) == 0) {
+                ParseInfoList(buf.data(), len, infoTags);
+            }
+        }
+
+        pos = payload + len + (len & 1);
+        file.clear();
+        file.seekg((std::streamoff)pos, std::ios::beg);
+    }
+
+    for (const auto& kv : infoTags) {
+        if (out.find(kv.first) == out.end()) out[kv.first] = kv.second;
+    }
+    if (info) *info = localInfo;
+    return foundCompact || !infoTags.empty();
+}
+
+std::string GetSidecarPath(const std::string& wavPath) {
+    std::string path = wavPath;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("\\/");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        path.resize(dot);
+    }
+    return path + ".meta";
+}
+
+bool WriteSidecar(const std::string& wavPath, const WavMetadata& metadata) {
+    std::ofstream file(GetSidecarPath(wavPath), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    std::vector<char> payload = EncodeCompact(metadata);
+    file.write("MMDT", 4);
+    file.write(payload.data(), payload.size());
+    return !file.fail();
+}
+
+bool ReadSidecar(const std::string& wavPath, WavMetadata& out) {
+    std::ifstream file(GetSidecarPath(wavPath), std::ios::binary);
+    if (!file.is_open()) return false;
+    std::vector<char> buf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (buf.size() < 4 || memcmp(buf.data(), "MMDT", 4) != 0) return false;
+    return DecodeCompact(buf.data() + 4, buf.size() - 4, out);
+}
+
+} // namespace WavMeta
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+// Call metadata embedded in finalized recordings.
+//
+// The writer reserves a JUNK chunk between "fmt " and "data" so the
+// metadata chunks can be written into the header region at Finalize time.
+// Two chunks are written:
+//   LIST/INFO - standard tags (INAM, ICRD, ISFT, ICMT) for Explorer/players
+//   "mmdt"    - compact binary key/value block, the authoritative copy
+// If the metadata does not fit in the reserved space it is appended after
+// the audio data instead; the reader handles both layouts.
+using WavMetadata = std::map<std::string, std::string>;
+
+// Basic format info collected while walking the chunk list
+struct WavInfo {
+    uint16_t formatTag = 0;
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint32_t byteRate = 0;
+    uint16_t blockAlign = 0;
+    uint16_t bitsPerSample = 0;
+    uint64_t dataOffset = 0;   // File offset of first audio byte
+    uint64_t dataBytes = 0;    // Size of the data chunk payload
+
+    double GetDurationSeconds() const {
+        return byteRate ? (double)dataBytes / byteRate : 0.0;
+    }
+};
+
+namespace WavMeta {
+    // Layout of the header written by StreamingWavWriter
+    constexpr uint32_t RESERVED_REGION_OFFSET = 36;    // Right after "fmt " chunk
+    constexpr uint32_t DATA_CHUNK_OFFSET = 4088;        // "data" chunk header
+    constexpr uint32_t DATA_OFFSET = 4096;              // First audio byte (sector aligned)
+    constexpr uint32_t RESERVED_REGION_SIZE = DATA_CHUNK_OFFSET - RESERVED_REGION_OFFSET;
+
+    // The DATA_OFFSET-byte header StreamingWavWriter starts every file with:
+    // RIFF/WAVE, PCM "fmt ", the reserved JUNK region and the "data" chunk header
+    std::vector<char> BuildHeader(uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample,
+                                  uint32_t dataBytes = 0, uint32_t trailingBytes = 0);
+
+    // Serialize metadata as the chunks that go into the file
+    // (LIST/INFO followed by "mmdt"), including chunk headers and padding.
+    std::vector<char> BuildChunks(const WavMetadata& metadata);
+
+    // Serialize/parse the compact "mmdt" payload (no chunk header)
+    std::vector<char> EncodeCompact(const WavMetadata& metadata);
+    bool DecodeCompact(const char* data, size_t size, WavMetadata& out);
+
+    // Fast reader: walks chunk headers only and seeks over the audio payload.
+    // Returns true if embedded metadata was found. info may be null.
+    bool Read(const std::string& wavPath, WavMetadata& out, WavInfo* info = nullptr);
+
+    // Optional compact sidecar (<name>.meta next to the wav, same encoding as "mmdt")
+    std::string GetSidecarPath(const std::string& wavPath);
+    bool WriteSidecar(const std::string& wavPath, const WavMetadata& metadata);
+    bool ReadSidecar(const std::string& wavPath, WavMetadata& out);
+}
@@ -1,5 +1,6 @@
 #include "audio/audio.h"
 #include "core/resource.h"
+#include "audio/CaptureHub.h"
 #include <iostream>
 #include <windows.h>
 #include <stdio.h>
@@ -99,6 +100,20 @@ private:
     
     ComPtr<AudioVolumeCallback> pVolumeCallback;
 
+    // While a recorder keeps the capture hub running the meters read its
+    // streams (passive subscribers, no extra device work); otherwise the
+    // endpoint meters above
+    CaptureSubscription micMeter;
+    CaptureSubscription speakerMeter;
+    static const uint32_t METER_WINDOW_MS = 50;
+
+    static bool ReadHubPeak(CaptureSubscription& meter, CaptureEndpoint endpoint, float& peak) {
+        CaptureHub& hub = GetCaptureHub();
+        if (!hub.IsCapturing(endpoint)) return false;
+        if (!meter.IsOpen()) meter = hub.Subscribe(endpoint, false);
+        return meter.ReadPeak(peak, METER_WINDOW_MS);
+    }
+
     void InitializeCOM() {
         if (!pEnumerator) {
             CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, 
@@ -227,6 +242,8 @@ public:
         pSpeakerMeterInfo.Reset();
         pSpeakerDevice.Reset();
         pEnumerator.Reset();
+        micMeter.Close();
+        speakerMeter.Close();
     }
 
     float GetCurrentLevel() {
@@ -236,6 +253,7 @@ public:
         
         float peak = 0.0f;
         std::lock_guard<std::mutex> lock(deviceMutex);
+        if (ReadHubPeak(micMeter, CaptureEndpoint::Microphone, peak)) return peak;
         if (pMeterInfo) {
             pMeterInfo->GetPeakValue(&peak);
         }
@@ -245,6 +263,7 @@ public:
     float GetCurrentSpeakerLevel() {
         float peak = 0.0f;
         std::lock_guard<std::mutex> lock(deviceMutex);
+        if (ReadHubPeak(speakerMeter, CaptureEndpoint::Loopback, peak)) return peak;
         if (pSpeakerMeterInfo) {
             pSpeakerMeterInfo->GetPeakValue(&peak);
         }
@@ -357,6 +376,24 @@ void InitializeAudio() {
     }
 }
 
+void WarmUpAudio() {
+    // Own apartment: nothing created here outlives this call
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    {
+        ComPtr<IMMDeviceEnumerator> pEnum;
+        if (SUCCEEDED(CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, IID_PPV_ARGS(&pEnum)))) {
+            ComPtr<IMMDevice> pDevice;
+            if (SUCCEEDED(pEnum->GetDefaultAudioEndpoint(eCapture, eMultimedia, &pDevice))) {
+                ComPtr<IAudioEndpointVolume> pVol;
+                pDevice->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, nullptr, (void**)&pVol);
+            }
+            pDevice.Reset();
+            pEnum->GetDefaultAudioEndpoint(eRender, eMultimedia, &pDevice);
+        }
+    }
+    if (SUCCEEDED(hr)) CoUninitialize();
+}
+
 void UninitializeAudio() {
     if (g_Audio) {
         g_Audio->Stop();
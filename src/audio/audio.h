@@ -11,6 +11,9 @@ using Microsoft::WRL::ComPtr;
 
 // Function prototypes to avoid circular deps if any
 void InitializeAudio();
+// Loads the audio stack (MMDevAPI, endpoint lookups) on a warm-up thread so
+// InitializeAudio on the UI thread finds it loaded. Keeps no objects.
+void WarmUpAudio();
 void UninitializeAudio();
 bool ToggleMuteAll();
 void SetMuteAll(bool mute);
@@ -4,6 +4,13 @@
 #include "network/http_server.h"
 #include "core/globals.h"
 #include "audio/audio.h"
+#include "storage/recording_catalog.h"
+#include "storage/retention.h"
+#include "storage/call_stats.h"
+#include "storage/transcoder.h"
+#include "storage/encrypted_recording.h"
+#include "core/background_jobs.h"
+#include "core/settings.h"
 #include <shlobj.h>
 #include <fstream>
 #include <sstream>
@@ -27,10 +34,9 @@ static std::string GetCurrentDateString() {
 }
 
 // Helper: Get timestamp for file naming
-static std::string GetTimestampString() {
-    time_t now = std::time(nullptr);
+static std::string GetTimestampString(time_t when) {
     struct tm tm;
-    localtime_s(&tm, &now);
+    localtime_s(&tm, &when);
     std::ostringstream oss;
     oss << std::put_time(&tm, "%H-%M-%S");
     return oss.str();
@@ -49,71 +55,20 @@ static bool CreateDirectoryIfNeeded(const std::string& path) {
     return CreateDirectoryA(path.c_str(), nullptr) != 0;
 }
 
-// Helper: Delete directory recursively
-static void DeleteDirectory(const std::string& path) {
-    std::string searchPath = path + "\\*";
-    WIN32_FIND_DATA findData;
-    HANDLE hFind = FindFirstFile(searchPath.c_str(), &findData);
-    if (hFind == INVALID_HANDLE_VALUE) return;
-
-    do {
-        if (strcmp(findData.cFileName, ".") == 0 || strcmp(findData.cFileName, "..") == 0) continue;
-
-        std::string filePath = path + "\\" + findData.cFileName;
-        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            DeleteDirectory(filePath);
-        } else {
-            DeleteFile(filePath.c_str());
-        }
-    } while (FindNextFile(hFind, &findData));
-    FindClose(hFind);
-
-    RemoveDirectory(path.c_str());
+// Helper: Kick off a background retention pass (age / byte budget / free space)
+static void StartRetentionPass() {
+    RetentionPolicy policy = GetConfiguredRetentionPolicy();
+    if (!policy.IsEnabled() || recordingFolder.empty()) return;
+    // Returns false if a pass is already running - that one covers us
+    GetRetentionEngine().RunAsync(recordingFolder, policy);
 }
 
-// Helper: Cleanup old recordings
-static void CleanupOldRecordings() {
-    if (autoDeleteDays <= 0 || recordingFolder.empty()) return;
-
-    time_t now = std::time(nullptr);
-    struct tm tmNow;
-    localtime_s(&tmNow, &now);
-    
-    // Approximate conversion
-    // We iterate folders in recordingFolder
-    std::string searchPath = recordingFolder + "\\*";
-    WIN32_FIND_DATA findData;
-    HANDLE hFind = FindFirstFile(searchPath.c_str(), &findData);
-    
-    if (hFind == INVALID_HANDLE_VALUE) return;
-
-    do {
-        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            if (strcmp(findData.cFileName, ".") == 0 || strcmp(findData.cFileName, "..") == 0) continue;
-
-            // Check if folder name is YYYY-MM-DD
-            int year, month, day;
-            if (sscanf_s(findData.cFileName, "%d-%d-%d", &year, &month, &day) == 3) {
-                struct tm tmFolder = {0};
-                tmFolder.tm_year = year - 1900;
-                tmFolder.tm_mon = month - 1;
-                tmFolder.tm_mday = day;
-                tmFolder.tm_isdst = -1;
-                
-                time_t folderTime = mktime(&tmFolder);
-                if (folderTime != -1) {
-                    double diff = difftime(now, folderTime);
-                    int daysOld = (int)(diff / (60 * 60 * 24));
-                    
-                    if (daysOld > autoDeleteDays) {
-                        std::string path = recordingFolder + "\\" + findData.cFileName;
-                        DeleteDirectory(path);
-                    }
-                }
-            }
-        }
-    } while (FindNextFile(hFind, &findData));
-    FindClose(hFind);
+// Helper: Compress old recordings on idle cores (paused while recording)
+static void StartArchivePass() {
+    if (archiveAfterDays <= 0 || recordingFolder.empty()) return;
+    TranscodeOptions options;
+    options.minAgeDays = archiveAfterDays;
+    GetArchiveTranscoder().RunAsync(recordingFolder, options);
 }
 
 static int CountRecordings(const std::string& folderPath) {
@@ -146,15 +101,16 @@ CallAutoRecorder::CallAutoRecorder()
     , silenceTimeoutMs(30000)    // 30 seconds silence (robust for pauses)
     , minCallDurationMs(10000)   // 10 seconds minimum to be a valid call
     , gracePeriodMs(15000)       // 15 seconds grace - no silence check initially
-    , todayCallCount(0)
     , pRecorder(nullptr)
 {
-    pRecorder = new WasapiRecorder();
+    pRecorder = handoff.Acquire();
     currentDate = GetCurrentDateString();
 }
 
 CallAutoRecorder::~CallAutoRecorder() {
     Disable();
+    // Calls still being finalized are saved before anything goes away
+    handoff.Drain();
     if (pRecorder) {
         delete pRecorder;
         pRecorder = nullptr;
@@ -167,12 +123,16 @@ void CallAutoRecorder::Enable() {
     // Reset date tracking
     currentDate = GetCurrentDateString();
     
-    // Cleanup old recordings if enabled
-    CleanupOldRecordings();
+    // Cleanup old recordings in the background (never blocks the UI thread)
+    StartRetentionPass();
+    StartArchivePass();
     
-    // Scan existing recordings for today
-    std::string folder = GetCurrentDateFolder();
-    todayCallCount = CountRecordings(folder);
+    // Recordings made before the stats store existed: count them once
+    CallStatsStore& stats = GetCallStats(recordingFolder);
+    if (!stats.HasDay(currentDate)) {
+        int existing = CountRecordings(GetCurrentDateFolder());
+        if (existing > 0) stats.SeedDay(currentDate, existing);
+    }
     
     enabled = true;
     currentState = State::DETECTING;
@@ -183,6 +143,7 @@ void CallAutoRecorder::Disable() {
     if (!enabled) return;
     
     // If currently recording, stop and save
+    std::lock_guard<std::mutex> lock(recorderMutex);
     if (currentState == State::RECORDING && pRecorder && pRecorder->IsRecording()) {
         OnSilenceTimeout();
     }
@@ -203,16 +164,30 @@ void CallAutoRecorder::Poll() {
     // Check if date changed (new day)
     std::string today = GetCurrentDateString();
     if (today != currentDate) {
+        // New day - the stats store starts a fresh sequence for it
         currentDate = today;
-        // Date changed, reset count by scanning new folder (likely 0, but good to be safe)
-        std::string folder = GetCurrentDateFolder();
-        todayCallCount = CountRecordings(folder);
+        // Another date folder may have aged past the archive threshold
+        if (currentState != State::RECORDING) StartArchivePass();
     }
 
     // Safety: If extension disconnects (tab closed) while recording, save immediately
     if (currentState == State::RECORDING && !IsExtensionConnected()) {
         ForceStopRecording();
     }
+
+    // A capture device went away mid-call: save what was recorded up to
+    // then rather than keep writing silence. pRecorder is swapped by a
+    // stop on the HTTP thread, so look at it under the lock and stop after
+    // releasing it (ForceStopRecording takes it again and re-checks).
+    bool captureFailed;
+    {
+        std::lock_guard<std::mutex> lock(recorderMutex);
+        captureFailed = currentState == State::RECORDING && pRecorder && pRecorder->HasCaptureFailed();
+    }
+    if (captureFailed) {
+        OutputDebugStringA("[CallRecorder] Capture device failed, saving the call so far\n");
+        ForceStopRecording();
+    }
     
     // No VAD - recording is controlled by HTTP server (extension signals)
     // Poll() is now only for date tracking and UI updates
@@ -223,6 +198,7 @@ void CallAutoRecorder::OnVoiceDetected() {
     
     // Start recording
     if (pRecorder->Start()) {
+        NotifyCaptureStarted();
         recordingStartTick = GetTickCount64();
         recordingStartTime = std::time(nullptr);
         lastVoiceTime = recordingStartTick;
@@ -232,23 +208,50 @@ void CallAutoRecorder::OnVoiceDetected() {
 
 void CallAutoRecorder::OnSilenceTimeout() {
     if (!pRecorder || currentState != State::RECORDING) return;
+    RecordingHandoff::Clock::time_point stopTime = RecordingHandoff::Clock::now();
     
+    // Check minimum duration
+    ULONGLONG duration = GetTickCount64() - recordingStartTick;
+    HandOffRecording(duration >= (DWORD)minCallDurationMs, stopTime);
+}
+
+// End capture now and queue the close-out (thread joins, header, rename,
+// sidecars, catalog) on the completion thread; a fresh recorder takes over
+// so the next call can start as soon as this returns. Caller holds
+// recorderMutex.
+void CallAutoRecorder::HandOffRecording(bool save, RecordingHandoff::Clock::time_point stopTime) {
     TransitionTo(State::SAVING);
     
-    // Stop recording
-    pRecorder->Stop();
+    FinishedCall call;
+    call.metadata = currentCallMetadata;
+    call.date = currentDate;
+    call.startTime = recordingStartTime;
+    call.endTime = std::time(nullptr);
     
-    // Check minimum duration
-    ULONGLONG duration = GetTickCount64() - recordingStartTick;
-    if (duration >= (DWORD)minCallDurationMs) {
-        SaveCurrentRecording();
-    }
+    // Threads leave their loops within a packet; Stop() joins them later
+    pRecorder->RequestStop();
+    WasapiRecorder* finished = pRecorder;
+    pRecorder = handoff.Acquire();
     
-    // Clear buffer for next call
-    pRecorder->Clear();
+    handoff.Complete(finished, [this, call, save](WasapiRecorder& recorder) {
+        if (save) {
+            SaveRecording(recorder, call);
+        } else {
+            // Too short - just cleanup (FinalizeStreaming will still save temp file)
+            recorder.FinalizeStreaming("discarded.wav");
+        }
+        // Only now, with the file closed out, may the transcoder and the
+        // uploads have the disk back (both count, so a call that started
+        // meanwhile keeps them held)
+        NotifyCaptureStopped();
+    }, stopTime);
+    
+    // Clear metadata
+    currentCallMetadata.clear();
     
-    // Ready for next call
+    // Ready for next call (waiting for extension signal)
     TransitionTo(State::DETECTING);
+    handoff.MarkReady(stopTime);
 }
 
 // Force start recording from external trigger (HTTP server)
@@ -263,9 +266,6 @@ void CallAutoRecorder::ForceStartRecording(const std::map<std::string, std::stri
     // If already recording, do nothing
     if (currentState == State::RECORDING) return;
 
-    // Store initial metadata
-    currentCallMetadata = metadata;
-
     // Enforce Folder Selection (Must be on UI thread really, but let's try direct call or use main window)
     // Since this might be called from HTTP thread, we need to be careful. 
     // However, MessageBox is generally thread-safe if parent is NULL or valid window.
@@ -276,18 +276,34 @@ void CallAutoRecorder::ForceStartRecording(const std::map<std::string, std::stri
         // Prompting from a hidden background thread is bad UX (might hide behind windows).
         // Better to fail internally if not set, BUT user asked for PROMPT.
         
-        // Let's use the main window handle if available
+        // Let's use the main window handle if available. The headless
+        // service has nobody to ask (it refuses to start without a folder).
+        if (headlessMode) {
+            OutputDebugStringA("[CallRecorder] No recording folder configured\n");
+            return;
+        }
         if (!EnsureRecordingFolderSelected(hMainWnd)) {
             return; // Cancelled or failed
         }
     }
     
     // Create date folder for streaming
-    std::string dateFolder = CreateDateFolder();
+    std::lock_guard<std::mutex> lock(recorderMutex);
+    if (currentState == State::RECORDING) return;
+
+    // Store initial metadata (a stop handing off the previous call reads
+    // and clears it under the same lock)
+    currentCallMetadata = metadata;
+
+    std::string dateFolder = CreateDateFolder(currentDate);
     if (dateFolder.empty()) return;
     
-    // Start streaming mode for memory safety
+    // Start streaming mode for memory safety (the previous call may still
+    // be finalizing on its own recorder)
     if (pRecorder->StartStreaming(dateFolder)) {
+        // Keep CPU and disk free for the call
+        NotifyCaptureStarted();
+        handoff.MarkStarted();
         recordingStartTick = GetTickCount64();
         recordingStartTime = std::time(nullptr);
         lastVoiceTime = recordingStartTick;
@@ -297,6 +313,8 @@ void CallAutoRecorder::ForceStartRecording(const std::map<std::string, std::stri
 
 // Force stop recording from external trigger (HTTP server)
 void CallAutoRecorder::ForceStopRecording(const std::map<std::string, std::string>& metadata) {
+    RecordingHandoff::Clock::time_point stopTime = RecordingHandoff::Clock::now();
+    std::lock_guard<std::mutex> lock(recorderMutex);
     if (!pRecorder) return;
     
     // If not recording, do nothing
@@ -309,105 +327,121 @@ void CallAutoRecorder::ForceStopRecording(const std::map<std::string, std::strin
         }
     }
     
-    TransitionTo(State::SAVING);
-    
-    // Stop recording
-    pRecorder->Stop();
-    
     // Save if long enough
     ULONGLONG duration = GetTickCount64() - recordingStartTick;
-    if (duration >= (DWORD)minCallDurationMs) {
-        SaveCurrentRecording();
-    } else {
-        // Too short - just cleanup (FinalizeStreaming will still save temp file)
-        pRecorder->FinalizeStreaming("discarded.wav");
-    }
-    
-    // Clear metadata
-    currentCallMetadata.clear();
-    
-    // Ready for next call (waiting for extension signal)
-    TransitionTo(State::DETECTING);
+    HandOffRecording(duration >= (DWORD)minCallDurationMs, stopTime);
 }
 
-std::string CallAutoRecorder::CreateDateFolder() {
+std::string CallAutoRecorder::CreateDateFolder(const std::string& date) {
     if (recordingFolder.empty()) return "";
     
-    std::string dateFolder = recordingFolder + "\\" + currentDate;
+    std::string dateFolder = recordingFolder + "\\" + date;
     CreateDirectoryIfNeeded(dateFolder);
     return dateFolder;
 }
 
-std::string CallAutoRecorder::GetNextFileName(int count) {
+std::string CallAutoRecorder::GetNextFileName(int count, time_t endTime) {
     std::ostringstream oss;
     oss << "call_" << std::setfill('0') << std::setw(3) << count 
-        << "_" << GetTimestampString() << ".wav";
+        << "_" << GetTimestampString(endTime) << ".wav";
     return oss.str();
 }
 
+DayCallStats CallAutoRecorder::GetTodayStats() const {
+    return GetCallStats(recordingFolder).GetDay(currentDate);
+}
+
+ConversationStats CallAutoRecorder::GetLiveConversationStats() const {
+    std::lock_guard<std::mutex> lock(recorderMutex);
+    if (!pRecorder || currentState != State::RECORDING) return ConversationStats();
+    return pRecorder->GetConversationStats();
+}
+
+bool CallAutoRecorder::GetLastCallConversationStats(ConversationStats& out) const {
+    std::lock_guard<std::mutex> lock(lastCallMutex);
+    out = lastCallStats;
+    return hasLastCall;
+}
+
 std::string CallAutoRecorder::GetCurrentDateFolder() const {
     if (recordingFolder.empty()) return "";
     return recordingFolder + "\\" + currentDate;
 }
 
-void CallAutoRecorder::SaveCurrentRecording() {
-    std::string folder = CreateDateFolder();
-    if (folder.empty()) return;
+// Runs on the completion thread (in stop order), after recorder.Stop()
+void CallAutoRecorder::SaveRecording(WasapiRecorder& recorder, const FinishedCall& call) {
+    std::string folder = CreateDateFolder(call.date);
+    if (folder.empty()) {
+        // Recording folder cleared mid-call: keep the audio, free the recorder
+        recorder.FinalizeStreaming("discarded.wav");
+        return;
+    }
+    
+    // Reserve the next number for the filename (persisted, never reused)
+    CallStatsStore& stats = GetCallStats(recordingFolder);
+    int callNumber = stats.AllocateSequence(call.date);
+    std::string filename = GetNextFileName(callNumber, call.endTime);
     
-    // Use the next number for the filename
-    std::string filename = GetNextFileName(todayCallCount + 1);
+    WavMetadata metadata = BuildCallMetadata(call, filename, callNumber);
     
-    time_t endTime = std::time(nullptr);
+    // Talk time, silence, overlap and monologues, counted by the mixer
+    ConversationStats conversation = recorder.GetConversationStats();
+    conversation.AddToMetadata(metadata);
     
-    // Finalize streaming file (updates header and renames)
-    std::string savedPath = pRecorder->FinalizeStreaming(filename);
+    // Finalize streaming file (updates header, embeds metadata and renames)
+    std::string savedPath = recorder.FinalizeStreaming(filename, &metadata);
     
     if (!savedPath.empty()) {
-        // Only now that the file exists on disk, we sync the count
-        todayCallCount = CountRecordings(folder);
+        // Only now that the file exists on disk, count it
+        stats.RecordCall(call.date, (uint32_t)difftime(call.endTime, call.startTime));
+        {
+            std::lock_guard<std::mutex> lock(lastCallMutex);
+            lastCallStats = conversation;
+            hasLastCall = true;
+        }
         
-        CreateMetadataFile(savedPath, recordingStartTime, endTime);
+        // No plaintext copy of the metadata next to an encrypted recording
+        if (writeMetadataSidecar && !EncryptedRecording::IsEncrypted(savedPath)) {
+            WavMeta::WriteSidecar(savedPath, metadata);
+        }
+        GetRecordingCatalog().AddOrUpdate(savedPath);
+        NotifyRecordingSaved(savedPath);
+
+        // New audio counts against the byte budget / free space quotas
+        if (retentionMaxTotalGB > 0 || retentionMinFreeGB > 0) {
+            StartRetentionPass();
+        }
+
         // Notify recorder window about saved file
         NotifyAutoRecordSaved(filename);
     }
 }
 
-void CallAutoRecorder::CreateMetadataFile(const std::string& audioPath, time_t startTime, time_t endTime) {
-    // Replace .wav with .txt
-    std::string txtPath = audioPath;
-    size_t pos = txtPath.rfind(".wav");
-    if (pos != std::string::npos) {
-        txtPath.replace(pos, 4, ".txt");
-    } else {
-        txtPath += ".txt";
-    }
+WavMetadata CallAutoRecorder::BuildCallMetadata(const FinishedCall& call, const std::string& filename, int callNumber) {
+    WavMetadata md;
     
-    std::ofstream txtFile(txtPath);
-    if (txtFile.is_open()) {
-        struct tm tmStart, tmEnd;
-        localtime_s(&tmStart, &startTime);
-        localtime_s(&tmEnd, &endTime);
-        
-        double duration = difftime(endTime, startTime);
-        
-        txtFile << "Call Recording Metadata\n";
-        txtFile << "=======================\n";
-        txtFile << "File: " << audioPath.substr(audioPath.find_last_of("\\/") + 1) << "\n";
-        txtFile << "Start Time: " << std::put_time(&tmStart, "%Y-%m-%d %H:%M:%S") << "\n";
-        txtFile << "End Time: " << std::put_time(&tmEnd, "%Y-%m-%d %H:%M:%S") << "\n";
-        txtFile << "Duration: " << duration << " seconds\n";
-        txtFile << "Call Number: " << todayCallCount << "\n";
-        
-        // Write dynamic metadata from Ozonetel
-        if (!currentCallMetadata.empty()) {
-            txtFile << "\n[Ozonetel Details]\n";
-            for (const auto& kv : currentCallMetadata) {
-                txtFile << kv.first << ": " << kv.second << "\n";
-            }
-        }
-        
-        txtFile.close();
+    // Dynamic metadata from Ozonetel first, so our own fields win on collisions
+    for (const auto& kv : call.metadata) {
+        md[kv.first] = kv.second;
     }
+    
+    time_t startTime = call.startTime;
+    time_t endTime = call.endTime;
+    struct tm tmStart, tmEnd;
+    localtime_s(&tmStart, &startTime);
+    localtime_s(&tmEnd, &endTime);
+    char startBuf[32], endBuf[32];
+    strftime(startBuf, sizeof(startBuf), "%Y-%m-%d %H:%M:%S", &tmStart);
+    strftime(endBuf, sizeof(endBuf), "%Y-%m-%d %H:%M:%S", &tmEnd);
+    
+    md["file"] = filename;
+    md["start_time"] = startBuf;
+    md["end_time"] = endBuf;
+    md["duration_sec"] = std::to_string((long long)difftime(endTime, startTime));
+    md["call_number"] = std::to_string(callNumber);
+    md["mode"] = "auto";
+    md["software"] = std::string("MicMute-S ") + APP_VERSION;
+    return md;
 }
 
 // Global helper functions
@@ -422,6 +456,10 @@ void InitCallRecorder() {
 }
 
 void CleanupCallRecorder() {
+    GetRetentionEngine().Cancel();
+    GetArchiveTranscoder().Cancel();
+    GetRetentionEngine().Wait();
+    GetArchiveTranscoder().Wait();
     if (g_CallRecorder) {
         delete g_CallRecorder;
         g_CallRecorder = nullptr;
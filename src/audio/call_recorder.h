@@ -7,6 +7,11 @@
 #include <atomic>
 #include <ctime>
 #include <map>
+#include <mutex>
+#include "audio/WavMetadata.h"
+#include "audio/ConversationAnalytics.h"
+#include "audio/RecordingHandoff.h"
+#include "storage/call_stats.h"
 
 // Forward declaration
 class WasapiRecorder;
@@ -19,7 +24,7 @@ public:
         IDLE,       // Not detecting, waiting for enable
         DETECTING,  // Monitoring audio levels for voice
         RECORDING,  // Currently recording a call
-        SAVING      // Saving the recording, brief transition state
+        SAVING      // Handing the recording off, brief transition state
     };
 
     CallAutoRecorder();
@@ -36,14 +41,26 @@ public:
     // Get current state
     State GetState() const { return currentState; }
     
-    // Force start/stop from external source (HTTP server)
+    // Force start/stop from external source (HTTP server). Stop returns as
+    // soon as capture has ended; the file is finalized in the background.
     void ForceStartRecording(const std::map<std::string, std::string>& metadata = {});
     void ForceStopRecording(const std::map<std::string, std::string>& metadata = {});
     
-    // Statistics
-    int GetTodayCallCount() const { return todayCallCount; }
+    // Statistics (backed by the persistent call stats store, no folder scans)
+    int GetTodayCallCount() const { return GetTodayStats().calls; }
+    DayCallStats GetTodayStats() const;
+    const std::string& GetCurrentDate() const { return currentDate; }
     std::string GetCurrentDateFolder() const;
 
+    // Conversation analytics: the call being recorded, and the last saved
+    // call (false if none yet)
+    ConversationStats GetLiveConversationStats() const;
+    bool GetLastCallConversationStats(ConversationStats& out) const;
+
+    // Stop-to-ready latency and recordings still being finalized
+    HandoffStats GetHandoffStats() const { return handoff.GetStats(); }
+    size_t GetPendingSaves() const { return handoff.GetPending(); }
+
     // Duration in milliseconds
     ULONGLONG GetRecordingDuration() const {
         if (currentState != State::RECORDING) return 0;
@@ -65,14 +82,24 @@ public:
     int GetGracePeriodMs() const { return gracePeriodMs; }
 
 private:
+    // What the completion thread needs to save a call after the recorder
+    // has moved on to the next one
+    struct FinishedCall {
+        std::map<std::string, std::string> metadata;
+        std::string date;
+        time_t startTime = 0;
+        time_t endTime = 0;
+    };
+
     void TransitionTo(State newState);
     void OnVoiceDetected();
     void OnSilenceTimeout();
+    void HandOffRecording(bool save, RecordingHandoff::Clock::time_point stopTime);
     
-    std::string CreateDateFolder();
-    std::string GetNextFileName(int count);
-    void SaveCurrentRecording();
-    void CreateMetadataFile(const std::string& audioPath, time_t startTime, time_t endTime);
+    std::string CreateDateFolder(const std::string& date);
+    std::string GetNextFileName(int count, time_t endTime);
+    void SaveRecording(WasapiRecorder& recorder, const FinishedCall& call);
+    WavMetadata BuildCallMetadata(const FinishedCall& call, const std::string& filename, int callNumber);
 
     // State
     std::atomic<bool> enabled;
@@ -90,14 +117,24 @@ private:
     int gracePeriodMs;        // No silence check during this initial period
     
     // Statistics
-    int todayCallCount;
     std::string currentDate;  // YYYY-MM-DD format
     
     // Metadata for current call
     std::map<std::string, std::string> currentCallMetadata;
 
-    // Recorder instance (uses existing WasapiRecorder)
+    // Analytics of the last saved call (read by the HTTP server thread)
+    mutable std::mutex lastCallMutex;
+    ConversationStats lastCallStats;
+    bool hasLastCall = false;
+
+    // Recorder for the current/next call (uses existing WasapiRecorder).
+    // Swapped for a pooled one on stop while the old one is finalized;
+    // recorderMutex serializes start/stop between the HTTP and UI threads.
+    mutable std::mutex recorderMutex;
     WasapiRecorder* pRecorder;
+
+    // Declared last: destroyed (and drained) before the state its jobs use
+    RecordingHandoff handoff;
 };
 
 // Global instance
@@ -3,7 +3,12 @@
 #include "audio/call_recorder.h"
 #include "network/http_server.h"
 #include "core/globals.h"
+#include "ui/ui.h"
 #include "core/settings.h"
+#include "storage/recording_catalog.h"
+#include "storage/call_stats.h"
+#include "storage/encrypted_recording.h"
+#include "core/background_jobs.h"
 #include <commdlg.h>
 #include <shlobj.h>
 #include <cstdio>
@@ -227,6 +232,41 @@ std::string GetDateFolderPath() {
 
 static time_t recordingStartTime = 0;
 
+// Finalize the manual recording with its metadata embedded in the WAV
+static std::string FinalizeManualRecording(const std::string& filename, time_t endTime) {
+    struct tm tmStart, tmEnd;
+    localtime_s(&tmStart, &recordingStartTime);
+    localtime_s(&tmEnd, &endTime);
+    char startBuf[32], endBuf[32];
+    strftime(startBuf, sizeof(startBuf), "%Y-%m-%d %H:%M:%S", &tmStart);
+    strftime(endBuf, sizeof(endBuf), "%Y-%m-%d %H:%M:%S", &tmEnd);
+
+    WavMetadata md;
+    md["file"] = filename;
+    md["start_time"] = startBuf;
+    md["end_time"] = endBuf;
+    md["duration_sec"] = std::to_string((long long)difftime(endTime, recordingStartTime));
+    md["mode"] = "manual";
+    md["software"] = std::string("MicMute-S ") + APP_VERSION;
+    recorder.GetConversationStats().AddToMetadata(md);
+
+    std::string savedPath = recorder.FinalizeStreaming(filename, &md);
+    NotifyCaptureStopped();
+    if (!savedPath.empty()) {
+        // No plaintext copy of the metadata next to an encrypted recording
+        if (writeMetadataSidecar && !EncryptedRecording::IsEncrypted(savedPath)) {
+            WavMeta::WriteSidecar(savedPath, md);
+        }
+        GetRecordingCatalog().AddOrUpdate(savedPath);
+        NotifyRecordingSaved(savedPath);
+
+        char dateBuf[16];
+        strftime(dateBuf, sizeof(dateBuf), "%Y-%m-%d", &tmEnd);
+        GetCallStats(recordingFolder).RecordCall(dateBuf, (uint32_t)difftime(endTime, recordingStartTime));
+    }
+    return savedPath;
+}
+
 void DrawIconBtn(LPDRAWITEMSTRUCT lpDrawItem, int type) {
     HDC hdc = lpDrawItem->hDC;
     RECT rc = lpDrawItem->rcItem;
@@ -390,6 +430,7 @@ LRESULT CALLBACK RecorderWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPar
                     
                     // Use STREAMING mode for memory safety
                     if (recorder.StartStreaming(dateFolder)) {
+                        NotifyCaptureStarted();
                         recordingStartTime = std::time(nullptr);
                     } else {
                         MessageBox(hWnd, "Failed to initialize recording.", "Error", MB_ICONERROR);
@@ -410,29 +451,10 @@ LRESULT CALLBACK RecorderWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPar
                     std::string dateFolder = GetDateFolderPath();
                     std::string filename = "Recording_" + timestamp + ".wav";
                     
-                    // Finalize streaming file (updates WAV header and renames)
-                    std::string savedPath = recorder.FinalizeStreaming(filename);
+                    // Finalize streaming file (updates WAV header, embeds metadata and renames)
+                    std::string savedPath = FinalizeManualRecording(filename, endTime);
                     
                     if (!savedPath.empty()) {
-                        // Create Metadata TXT
-                        std::string txtPath = dateFolder + "\\" + "Recording_" + timestamp + ".txt";
-                        std::ofstream txtFile(txtPath);
-                        if (txtFile.is_open()) {
-                            struct tm tmStart, tmEnd;
-                            localtime_s(&tmStart, &recordingStartTime);
-                            localtime_s(&tmEnd, &endTime);
-                            
-                            txtFile << "Recording Metadata\n";
-                            txtFile << "==================\n";
-                            txtFile << "File: " << filename << "\n";
-                            txtFile << "Start Time: " << std::put_time(&tmStart, "%Y-%m-%d %H:%M:%S") << "\n";
-                            txtFile << "End Time: " << std::put_time(&tmEnd, "%Y-%m-%d %H:%M:%S") << "\n";
-                            double duration = difftime(endTime, recordingStartTime);
-                            txtFile << "Duration: " << duration << " seconds\n";
-                            txtFile << "Mode: Streaming (crash-safe)\n";
-                            txtFile.close();
-                        }
-                        
                         // Using a simple message box for now, could be a toast
                         // MessageBox(hWnd, "Recording Saved!", "MicMute-S", MB_OK);
                     } else {
@@ -534,6 +556,7 @@ LRESULT CALLBACK RecorderWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPar
             // Stop recording safely on UI thread
             if (recorder.IsRecording()) {
                 recorder.Stop(); // Calls join() internally
+                NotifyCaptureStopped();
                 
                 // Show Error
                 MessageBox(hWnd, "Recording stopped automatically due to a device disconnect or storage error.", "Recording Error", MB_ICONERROR | MB_OK);
@@ -554,6 +577,10 @@ LRESULT CALLBACK RecorderWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPar
             ShowWindow(hWnd, SW_HIDE);
             return 0;
 
+        case WM_SHOWWINDOW:
+            RequestFrameSchedulerRefresh();
+            return DefWindowProc(hWnd, msg, wParam, lParam);
+
         default:
             return DefWindowProc(hWnd, msg, wParam, lParam);
     }
@@ -579,6 +606,7 @@ void HandleManualStartPause(HWND parent) {
         if (!EnsureRecordingFolderSelected(parent)) return;
         std::string dateFolder = GetDateFolderPath();
         if (recorder.StartStreaming(dateFolder)) {
+            NotifyCaptureStarted();
             recordingStartTime = std::time(nullptr);
         }
     } else {
@@ -598,24 +626,6 @@ void HandleManualStop(HWND parent) {
     std::string dateFolder = GetDateFolderPath();
     std::string filename = "Recording_" + timestamp + ".wav";
 
-    std::string savedPath = recorder.FinalizeStreaming(filename);
-    if (!savedPath.empty()) {
-        std::string txtPath = dateFolder + "\\" + "Recording_" + timestamp + ".txt";
-        std::ofstream txtFile(txtPath);
-        if (txtFile.is_open()) {
-            struct tm tmStart, tmEnd;
-            localtime_s(&tmStart, &recordingStartTime);
-            localtime_s(&tmEnd, &endTime);
-            txtFile << "Recording Metadata\n";
-            txtFile << "==================\n";
-            txtFile << "File: " << filename << "\n";
-            txtFile << "Start Time: " << std::put_time(&tmStart, "%Y-%m-%d %H:%M:%S") << "\n";
-            txtFile << "End Time: " << std::put_time(&tmEnd, "%Y-%m-%d %H:%M:%S") << "\n";
-            double duration = difftime(endTime, recordingStartTime);
-            txtFile << "Duration: " << duration << " seconds\n";
-            txtFile << "Mode: Streaming (crash-safe)\n";
-            txtFile.close();
-        }
-    }
+    FinalizeManualRecording(filename, endTime);
     if (hRecorderWnd) UpdateRecorderUI(hRecorderWnd);
 }
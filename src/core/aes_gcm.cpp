@@ -0,0 +1,471 @@
+#ifdef _WIN32
+#define _CRT_RAND_S     // rand_s (RtlGenRandom)
+#endif
+#include "core/aes_gcm.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define AESGCM_X86 1
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AESNI_TARGET
+#else
+#include <cpuid.h>
+#define AESNI_TARGET __attribute__((target("aes,pclmul,ssse3,sse4.1")))
+#endif
+#endif
+
+// ---------------------------------------------------------------------------
+// Portable AES and GHASH
+// ---------------------------------------------------------------------------
+
+static uint8_t GfMul8(uint8_t a, uint8_t b) {
+    uint8_t p = 0;
+    while (b) {
+        if (b & 1) p ^= a;
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+        b >>= 1;
+    }
+    return p;
+}
+
+struct SBox {
+    uint8_t v[256];
+    SBox() {
+        // Multiplicative inverse (a^254) followed by the affine transform
+        for (int i = 0; i < 256; i++) {
+            uint8_t a = (uint8_t)i, inv = 1;
+            for (int e = 254; e; e >>= 1) {
+                if (e & 1) inv = GfMul8(inv, a);
+                a = GfMul8(a, a);
+            }
+            if (i == 0) inv = 0;
+            uint8_t s = inv;
+            for (int r = 1; r <= 4; r++) s ^= (uint8_t)((inv << r) | (inv >> (8 - r)));
+            v[i] = (uint8_t)(s ^ 0x63);
+        }
+    }
+};
+
+static const uint8_t* GetSBox() {
+    static const SBox box;
+    return box.v;
+}
+
+static inline uint8_t Xtime(uint8_t a) {
+    return (uint8_t)((a << 1) ^ ((a >> 7) * 0x1B));
+}
+
+static void ExpandKey256(const uint8_t key[32], uint8_t rk[240]) {
+    const uint8_t* sbox = GetSBox();
+    memcpy(rk, key, 32);
+    uint8_t rcon = 1;
+    for (int i = 8; i < 60; i++) {
+        uint8_t t[4];
+        memcpy(t, rk + (i - 1) * 4, 4);
+        if (i % 8 == 0) {
+            uint8_t first = t[0];
+            t[0] = (uint8_t)(sbox[t[1]] ^ rcon);
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[first];
+            rcon = Xtime(rcon);
+        } else if (i % 8 == 4) {
+            for (int j = 0; j < 4; j++) t[j] = sbox[t[j]];
+        }
+        for (int j = 0; j < 4; j++) rk[i * 4 + j] = (uint8_t)(rk[(i - 8) * 4 + j] ^ t[j]);
+    }
+}
+
+static void EncryptBlockSoft(const uint8_t rk[240], const uint8_t in[16], uint8_t out[16]) {
+    const uint8_t* sbox = GetSBox();
+    uint8_t s[16], t[16];
+    for (int i = 0; i < 16; i++) s[i] = (uint8_t)(in[i] ^ rk[i]);
+    for (int round = 1; round <= 14; round++) {
+        // SubBytes + ShiftRows (byte i is row i % 4, column i / 4)
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) t[r + 4 * c] = sbox[s[r + 4 * ((c + r) % 4)]];
+        }
+        if (round < 14) {
+            for (int c = 0; c < 4; c++) {
+                uint8_t* col = t + 4 * c;
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                uint8_t all = (uint8_t)(a0 ^ a1 ^ a2 ^ a3);
+                col[0] = (uint8_t)(a0 ^ all ^ Xtime((uint8_t)(a0 ^ a1)));
+                col[1] = (uint8_t)(a1 ^ all ^ Xtime((uint8_t)(a1 ^ a2)));
+                col[2] = (uint8_t)(a2 ^ all ^ Xtime((uint8_t)(a2 ^ a3)));
+                col[3] = (uint8_t)(a3 ^ all ^ Xtime((uint8_t)(a3 ^ a0)));
+            }
+        }
+        for (int i = 0; i < 16; i++) s[i] = (uint8_t)(t[i] ^ rk[round * 16 + i]);
+    }
+    memcpy(out, s, 16);
+}
+
+static uint64_t LoadBe64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+static void StoreBe64(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+// Y = Y * H in GCM's bit-reflected GF(2^128), bit by bit without branches
+static void GfMul128(uint64_t& yHi, uint64_t& yLo, uint64_t hHi, uint64_t hLo) {
+    uint64_t zHi = 0, zLo = 0, vHi = hHi, vLo = hLo;
+    for (int i = 0; i < 128; i++) {
+        uint64_t bit = i < 64 ? (yHi >> (63 - i)) & 1 : (yLo >> (127 - i)) & 1;
+        uint64_t mask = 0 - bit;
+        zHi ^= vHi & mask;
+        zLo ^= vLo & mask;
+        uint64_t carry = 0 - (vLo & 1);
+        vLo = (vLo >> 1) | (vHi << 63);
+        vHi = (vHi >> 1) ^ (0xE100000000000000ull & carry);
+    }
+    yHi = zHi;
+    yLo = zLo;
+}
+
+static void GhashSoft(uint64_t& yHi, uint64_t& yLo, uint64_t hHi, uint64_t hLo, const uint8_t* p, size_t len) {
+    uint8_t block[16];
+    while (len > 0) {
+        size_t n = len < 16 ? len : 16;
+        memset(block, 0, 16);
+        memcpy(block, p, n);
+        yHi ^= LoadBe64(block);
+        yLo ^= LoadBe64(block + 8);
+        GfMul128(yHi, yLo, hHi, hLo);
+        p += n;
+        len -= n;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AES-NI / PCLMULQDQ
+// ---------------------------------------------------------------------------
+
+#ifdef AESGCM_X86
+
+static bool DetectHardware() {
+    unsigned ecx = 0;
+#ifdef _MSC_VER
+    int regs[4];
+    __cpuid(regs, 1);
+    ecx = (unsigned)regs[2];
+#else
+    unsigned eax, ebx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+#endif
+    const unsigned PCLMUL = 1u << 1, SSSE3 = 1u << 9, SSE41 = 1u << 19, AES = 1u << 25;
+    return (ecx & (PCLMUL | SSSE3 | SSE41 | AES)) == (PCLMUL | SSSE3 | SSE41 | AES);
+}
+
+AESNI_TARGET static inline __m128i ByteSwap(__m128i x) {
+    return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+// Unreduced 256-bit carry-less product
+AESNI_TARGET static inline void ClMul(__m128i a, __m128i b, __m128i& lo, __m128i& hi) {
+    __m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t1 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t2 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x11);
+    t1 = _mm_xor_si128(t1, t2);
+    lo = _mm_xor_si128(t0, _mm_slli_si128(t1, 8));
+    hi = _mm_xor_si128(t3, _mm_srli_si128(t1, 8));
+}
+
+// Shift left by one (bit reflection) and reduce modulo x^128 + x^7 + x^2 + x + 1.
+// Linear, so several products can be summed first and reduced once.
+AESNI_TARGET static inline __m128i Reduce(__m128i lo, __m128i hi) {
+    __m128i t7 = _mm_srli_epi32(lo, 31);
+    __m128i t8 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    lo = _mm_or_si128(lo, t7);
+    hi = _mm_or_si128(_mm_or_si128(hi, t8), t9);
+
+    t7 = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    t8 = _mm_srli_si128(t7, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(t7, 12));
+    __m128i t2 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    t2 = _mm_xor_si128(t2, t8);
+    lo = _mm_xor_si128(lo, t2);
+    return _mm_xor_si128(hi, lo);
+}
+
+AESNI_TARGET static inline __m128i GfMulHw(__m128i a, __m128i b) {
+    __m128i lo, hi;
+    ClMul(a, b, lo, hi);
+    return Reduce(lo, hi);
+}
+
+AESNI_TARGET static __m128i GhashHw(__m128i y, const uint8_t hPowers[4][16], const uint8_t* p, size_t len) {
+    const __m128i h1 = _mm_load_si128((const __m128i*)hPowers[0]);
+    const __m128i h2 = _mm_load_si128((const __m128i*)hPowers[1]);
+    const __m128i h3 = _mm_load_si128((const __m128i*)hPowers[2]);
+    const __m128i h4 = _mm_load_si128((const __m128i*)hPowers[3]);
+    while (len >= 64) {
+        __m128i x0 = _mm_xor_si128(y, ByteSwap(_mm_loadu_si128((const __m128i*)p)));
+        __m128i x1 = ByteSwap(_mm_loadu_si128((const __m128i*)(p + 16)));
+        __m128i x2 = ByteSwap(_mm_loadu_si128((const __m128i*)(p + 32)));
+        __m128i x3 = ByteSwap(_mm_loadu_si128((const __m128i*)(p + 48)));
+        __m128i lo, hi, l, h;
+        ClMul(x0, h4, lo, hi);
+        ClMul(x1, h3, l, h);
+        lo = _mm_xor_si128(lo, l);
+        hi = _mm_xor_si128(hi, h);
+        ClMul(x2, h2, l, h);
+        lo = _mm_xor_si128(lo, l);
+        hi = _mm_xor_si128(hi, h);
+        ClMul(x3, h1, l, h);
+        lo = _mm_xor_si128(lo, l);
+        hi = _mm_xor_si128(hi, h);
+        y = Reduce(lo, hi);
+        p += 64;
+        len -= 64;
+    }
+    while (len > 0) {
+        alignas(16) uint8_t block[16] = {};
+        size_t n = len < 16 ? len : 16;
+        memcpy(block, p, n);
+        y = GfMulHw(_mm_xor_si128(y, ByteSwap(_mm_load_si128((const __m128i*)block))), h1);
+        p += n;
+        len -= n;
+    }
+    return y;
+}
+
+AESNI_TARGET static inline __m128i EncryptBlockHw(const __m128i* k, __m128i b) {
+    b = _mm_xor_si128(b, k[0]);
+    for (int r = 1; r < 14; r++) b = _mm_aesenc_si128(b, k[r]);
+    return _mm_aesenclast_si128(b, k[14]);
+}
+
+AESNI_TARGET static void CtrHw(const uint8_t rk[240], const uint8_t j0[16], const uint8_t* in, uint8_t* out, size_t len) {
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = _mm_loadu_si128((const __m128i*)(rk + i * 16));
+    // Counter kept byte-reversed so the 32-bit big-endian counter is lane 0
+    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+    __m128i ctr = _mm_add_epi32(ByteSwap(_mm_loadu_si128((const __m128i*)j0)), one);
+
+    while (len >= 64) {
+        __m128i c1 = _mm_add_epi32(ctr, one);
+        __m128i c2 = _mm_add_epi32(c1, one);
+        __m128i c3 = _mm_add_epi32(c2, one);
+        __m128i b0 = _mm_xor_si128(ByteSwap(ctr), k[0]);
+        __m128i b1 = _mm_xor_si128(ByteSwap(c1), k[0]);
+        __m128i b2 = _mm_xor_si128(ByteSwap(c2), k[0]);
+        __m128i b3 = _mm_xor_si128(ByteSwap(c3), k[0]);
+        ctr = _mm_add_epi32(c3, one);
+        for (int r = 1; r < 14; r++) {
+            b0 = _mm_aesenc_si128(b0, k[r]);
+            b1 = _mm_aesenc_si128(b1, k[r]);
+            b2 = _mm_aesenc_si128(b2, k[r]);
+            b3 = _mm_aesenc_si128(b3, k[r]);
+        }
+        b0 = _mm_aesenclast_si128(b0, k[14]);
+        b1 = _mm_aesenclast_si128(b1, k[14]);
+        b2 = _mm_aesenclast_si128(b2, k[14]);
+        b3 = _mm_aesenclast_si128(b3, k[14]);
+        _mm_storeu_si128((__m128i*)out, _mm_xor_si128(b0, _mm_loadu_si128((const __m128i*)in)));
+        _mm_storeu_si128((__m128i*)(out + 16), _mm_xor_si128(b1, _mm_loadu_si128((const __m128i*)(in + 16))));
+        _mm_storeu_si128((__m128i*)(out + 32), _mm_xor_si128(b2, _mm_loadu_si128((const __m128i*)(in + 32))));
+        _mm_storeu_si128((__m128i*)(out + 48), _mm_xor_si128(b3, _mm_loadu_si128((const __m128i*)(in + 48))));
+        in += 64;
+        out += 64;
+        len -= 64;
+    }
+    while (len > 0) {
+        alignas(16) uint8_t ks[16];
+        _mm_store_si128((__m128i*)ks, EncryptBlockHw(k, ByteSwap(ctr)));
+        ctr = _mm_add_epi32(ctr, one);
+        size_t n = len < 16 ? len : 16;
+        for (size_t i = 0; i < n; i++) out[i] = (uint8_t)(in[i] ^ ks[i]);
+        in += n;
+        out += n;
+        len -= n;
+    }
+}
+
+AESNI_TARGET static void ComputeHPowers(const uint8_t rk[240], uint8_t hPowers[4][16]) {
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = _mm_loadu_si128((const __m128i*)(rk + i * 16));
+    __m128i h = ByteSwap(EncryptBlockHw(k, _mm_setzero_si128()));
+    __m128i p = h;
+    for (int i = 0; i < 4; i++) {
+        _mm_store_si128((__m128i*)hPowers[i], p);
+        p = GfMulHw(p, h);
+    }
+}
+
+AESNI_TARGET static void EncryptBlockHwBytes(const uint8_t rk[240], const uint8_t in[16], uint8_t out[16]) {
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = _mm_loadu_si128((const __m128i*)(rk + i * 16));
+    _mm_storeu_si128((__m128i*)out, EncryptBlockHw(k, _mm_loadu_si128((const __m128i*)in)));
+}
+
+AESNI_TARGET static void GhashHwBytes(const uint8_t hPowers[4][16], const uint8_t* aad, size_t aadLen,
+                                      const uint8_t* data, size_t len, const uint8_t lengths[16], uint8_t out[16]) {
+    __m128i y = _mm_setzero_si128();
+    y = GhashHw(y, hPowers, aad, aadLen);
+    y = GhashHw(y, hPowers, data, len);
+    y = GhashHw(y, hPowers, lengths, 16);
+    _mm_storeu_si128((__m128i*)out, ByteSwap(y));
+}
+
+#endif // AESGCM_X86
+
+// ---------------------------------------------------------------------------
+// AesGcm
+// ---------------------------------------------------------------------------
+
+AesGcm::~AesGcm() {
+    volatile uint8_t* p = m_roundKeys;
+    for (size_t i = 0; i < sizeof(m_roundKeys); i++) p[i] = 0;
+    volatile uint8_t* h = &m_hPowers[0][0];
+    for (size_t i = 0; i < sizeof(m_hPowers); i++) h[i] = 0;
+    m_hHi = m_hLo = 0;
+}
+
+bool AesGcm::HasHardwareSupport() {
+#ifdef AESGCM_X86
+    static const bool supported = DetectHardware();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void AesGcm::SetKey(const uint8_t key[KEY_SIZE], bool allowHardware) {
+    ExpandKey256(key, m_roundKeys);
+    m_hardware = allowHardware && HasHardwareSupport();
+    uint8_t zero[16] = {}, h[16];
+    EncryptBlockSoft(m_roundKeys, zero, h);
+    m_hHi = LoadBe64(h);
+    m_hLo = LoadBe64(h + 8);
+#ifdef AESGCM_X86
+    if (m_hardware) ComputeHPowers(m_roundKeys, m_hPowers);
+#endif
+}
+
+void AesGcm::EncryptBlock(const uint8_t in[16], uint8_t out[16]) const {
+#ifdef AESGCM_X86
+    if (m_hardware) {
+        EncryptBlockHwBytes(m_roundKeys, in, out);
+        return;
+    }
+#endif
+    EncryptBlockSoft(m_roundKeys, in, out);
+}
+
+void AesGcm::Ctr(const uint8_t j0[16], const uint8_t* in, uint8_t* out, size_t len) const {
+#ifdef AESGCM_X86
+    if (m_hardware) {
+        CtrHw(m_roundKeys, j0, in, out, len);
+        return;
+    }
+#endif
+    uint8_t ctr[16], ks[16];
+    memcpy(ctr, j0, 16);
+    while (len > 0) {
+        for (int i = 15; i >= 12; i--) {
+            if (++ctr[i] != 0) break;
+        }
+        EncryptBlockSoft(m_roundKeys, ctr, ks);
+        size_t n = len < 16 ? len : 16;
+        for (size_t i = 0; i < n; i++) out[i] = (uint8_t)(in[i] ^ ks[i]);
+        in += n;
+        out += n;
+        len -= n;
+    }
+}
+
+void AesGcm::Ghash(const uint8_t* aad, size_t aadLen, const uint8_t* data, size_t len, uint8_t out[16]) const {
+    uint8_t lengths[16];
+    StoreBe64(lengths, (uint64_t)aadLen * 8);
+    StoreBe64(lengths + 8, (uint64_t)len * 8);
+#ifdef AESGCM_X86
+    if (m_hardware) {
+        GhashHwBytes(m_hPowers, aad, aadLen, data, len, lengths, out);
+        return;
+    }
+#endif
+    uint64_t yHi = 0, yLo = 0;
+    GhashSoft(yHi, yLo, m_hHi, m_hLo, aad, aadLen);
+    GhashSoft(yHi, yLo, m_hHi, m_hLo, data, len);
+    GhashSoft(yHi, yLo, m_hHi, m_hLo, lengths, 16);
+    StoreBe64(out, yHi);
+    StoreBe64(out + 8, yLo);
+}
+
+void AesGcm::ComputeTag(const uint8_t j0[16], const uint8_t* aad, size_t aadLen,
+                        const uint8_t* cipher, size_t len, uint8_t tag[TAG_SIZE]) const {
+    uint8_t s[16], ek[16];
+    Ghash(aad, aadLen, cipher, len, s);
+    EncryptBlock(j0, ek);
+    for (int i = 0; i < 16; i++) tag[i] = (uint8_t)(s[i] ^ ek[i]);
+}
+
+static void MakeJ0(const uint8_t nonce[AesGcm::NONCE_SIZE], uint8_t j0[16]) {
+    memcpy(j0, nonce, 12);
+    j0[12] = j0[13] = j0[14] = 0;
+    j0[15] = 1;
+}
+
+void AesGcm::Encrypt(const uint8_t nonce[NONCE_SIZE], const uint8_t* aad, size_t aadLen,
+                     const uint8_t* in, uint8_t* out, size_t len, uint8_t tag[TAG_SIZE]) const {
+    uint8_t j0[16];
+    MakeJ0(nonce, j0);
+    Ctr(j0, in, out, len);
+    ComputeTag(j0, aad, aadLen, out, len, tag);
+}
+
+bool AesGcm::Decrypt(const uint8_t nonce[NONCE_SIZE], const uint8_t* aad, size_t aadLen,
+                     const uint8_t* in, uint8_t* out, size_t len, const uint8_t tag[TAG_SIZE]) const {
+    uint8_t j0[16], expected[16];
+    MakeJ0(nonce, j0);
+    ComputeTag(j0, aad, aadLen, in, len, expected);
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; i++) diff |= (uint8_t)(expected[i] ^ tag[i]);
+    if (diff != 0) {
+        if (len) memset(out, 0, len);
+        return false;
+    }
+    Ctr(j0, in, out, len);
+    return true;
+}
+
+bool SecureRandom(void* out, size_t len) {
+    uint8_t* p = static_cast<uint8_t*>(out);
+#ifdef _WIN32
+    while (len > 0) {
+        unsigned int v;
+        if (rand_s(&v) != 0) return false;
+        size_t n = len < sizeof(v) ? len : sizeof(v);
+        memcpy(p, &v, n);
+        p += n;
+        len -= n;
+    }
+    return true;
+#else
+    FILE* f = fopen("/dev/urandom", "rb");
+    if (!f) return false;
+    size_t got = fread(p, 1, len, f);
+    fclose(f);
+    return got == len;
+#endif
+}
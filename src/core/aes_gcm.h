@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// AES-256-GCM (FIPS 197, NIST SP 800-38D) with 96-bit nonces.
+// Used for recordings at rest; no external crypto deps.
+//
+// Uses AES-NI and PCLMULQDQ when the CPU has them (checked once at
+// runtime): CTR runs four blocks in flight and GHASH folds four blocks per
+// reduction. Otherwise a portable path is used (correct but around two
+// orders of magnitude slower - still ~100 recordings per core - and not
+// hardened against cache timing).
+class AesGcm {
+public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t NONCE_SIZE = 12;
+    static constexpr size_t TAG_SIZE = 16;
+
+    AesGcm() = default;
+    ~AesGcm();
+    AesGcm(const AesGcm&) = delete;
+    AesGcm& operator=(const AesGcm&) = delete;
+
+    static bool HasHardwareSupport();
+
+    // allowHardware = false forces the portable path (selftest, benchmark)
+    void SetKey(const uint8_t key[KEY_SIZE], bool allowHardware = true);
+    bool IsHardware() const { return m_hardware; }
+
+    // out may equal in
+    void Encrypt(const uint8_t nonce[NONCE_SIZE], const uint8_t* aad, size_t aadLen,
+                 const uint8_t* in, uint8_t* out, size_t len, uint8_t tag[TAG_SIZE]) const;
+
+    // False (and out zeroed) if the tag does not match
+    bool Decrypt(const uint8_t nonce[NONCE_SIZE], const uint8_t* aad, size_t aadLen,
+                 const uint8_t* in, uint8_t* out, size_t len, const uint8_t tag[TAG_SIZE]) const;
+
+private:
+    void EncryptBlock(const uint8_t in[16], uint8_t out[16]) const;
+    void Ctr(const uint8_t j0[16], const uint8_t* in, uint8_t* out, size_t len) const;
+    void Ghash(const uint8_t* aad, size_t aadLen, const uint8_t* data, size_t len, uint8_t out[16]) const;
+    void ComputeTag(const uint8_t j0[16], const uint8_t* aad, size_t aadLen,
+                    const uint8_t* cipher, size_t len, uint8_t tag[TAG_SIZE]) const;
+
+    alignas(16) uint8_t m_roundKeys[15 * 16] = {};
+    alignas(16) uint8_t m_hPowers[4][16] = {};   // Hardware: H^1..H^4, byte-reversed
+    uint64_t m_hHi = 0, m_hLo = 0;                // Portable: H as two big-endian halves
+    bool m_hardware = false;
+};
+
+// Cryptographically secure random bytes (rand_s on Windows, /dev/urandom
+// elsewhere)
+bool SecureRandom(void* out, size_t len);
@@ -0,0 +1,42 @@
+#include "core/background_jobs.h"
+#include "core/globals.h"
+#include "core/settings.h"
+#include "storage/transcoder.h"
+#include "network/upload_queue.h"
+#include "network/updater.h"
+#include "ui/ui.h"
+
+void InitBackgroundJobs() {
+    AutoUpdater::SetPeerCacheEnabled(updatePeerCacheEnabled);
+
+    UploadQueue& queue = GetUploadQueue();
+    queue.Stop();
+    if (!uploadEnabled || recordingFolder.empty()) return;
+
+    std::string journal = recordingFolder + "\\upload_queue.journal";
+    if (!queue.Start(journal, GetConfiguredUploadSettings())) {
+        OutputDebugStringA("Upload queue not started: incomplete S3 settings\n");
+    }
+}
+
+void CleanupBackgroundJobs() {
+    AutoUpdater::SetPeerCacheEnabled(false);
+    GetUploadQueue().Stop();
+}
+
+void NotifyCaptureStarted() {
+    GetArchiveTranscoder().Pause();
+    GetUploadQueue().BeginCapture();
+    RequestFrameSchedulerRefresh();     // Call recorder polls faster while recording
+}
+
+void NotifyCaptureStopped() {
+    GetUploadQueue().EndCapture();
+    GetArchiveTranscoder().Resume();
+    RequestFrameSchedulerRefresh();
+}
+
+void NotifyRecordingSaved(const std::string& wavPath) {
+    if (!uploadEnabled) return;
+    GetUploadQueue().Enqueue(wavPath);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+// Coordinates the background workers (archive transcoder, upload queue,
+// update peer cache) with the capture path, so recording always gets the
+// CPU, disk and network first.
+
+// Start/stop the upload queue and the update peer cache according to the
+// current settings.
+// InitBackgroundJobs can be called again after settings change.
+void InitBackgroundJobs();
+void CleanupBackgroundJobs();
+
+// Call when capture starts/stops (auto or manual). Pauses the transcoder
+// and switches the upload queue to its recording bandwidth limit.
+void NotifyCaptureStarted();
+void NotifyCaptureStopped();
+
+// A recording has been finalized on disk (queued for upload if enabled)
+void NotifyRecordingSaved(const std::string& wavPath);
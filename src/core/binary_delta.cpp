@@ -0,0 +1,309 @@
+#include "core/binary_delta.h"
+#include "core/sha256.h"
+#include "core/mapped_file.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+static const char DELTA_MAGIC[8] = {'M', 'M', 'D', 'E', 'L', 'T', 'A', '1'};
+static const size_t DELTA_HEADER_SIZE = 8 + 8 + 8 + 32 + 32;
+static const size_t BLOCK = 32;             // Base index granularity
+static const int MAX_CANDIDATES = 16;       // Colliding blocks checked per position
+static const uint8_t OP_COPY = 0x01;
+static const uint8_t OP_LITERAL = 0x02;
+static const size_t IO_CHUNK = 64 * 1024;
+
+// rsync weak checksum over BLOCK bytes, rolled one byte at a time
+struct RollingSum {
+    uint32_t a = 0, b = 0;
+
+    void Init(const uint8_t* p) {
+        a = b = 0;
+        for (size_t i = 0; i < BLOCK; i++) {
+            a += p[i];
+            b += (uint32_t)(BLOCK - i) * p[i];
+        }
+    }
+    void Roll(uint8_t out, uint8_t in) {
+        a += (uint32_t)in - out;
+        b += a - (uint32_t)BLOCK * out;
+    }
+    uint32_t Hash() const { return (a & 0xffff) | (b << 16); }
+};
+
+static bool ReadWholeFile(const std::string& path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::streamoff size = file.tellg();
+    if (size < 0) return false;
+    data.resize((size_t)size);
+    file.seekg(0);
+    return size == 0 || (bool)file.read((char*)data.data(), size);
+}
+
+static void PutU32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out += (char)((v >> (8 * i)) & 0xff);
+}
+
+static void PutU64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; i++) out += (char)((v >> (8 * i)) & 0xff);
+}
+
+static uint32_t GetU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t GetU64(const uint8_t* p) {
+    return (uint64_t)GetU32(p) | ((uint64_t)GetU32(p + 4) << 32);
+}
+
+// Ops are buffered so adjacent copies merge into one
+class DeltaWriter {
+public:
+    DeltaWriter(std::ofstream& out, BinaryDeltaStats& stats) : m_out(out), m_stats(stats) {}
+
+    void Copy(uint64_t offset, uint64_t length) {
+        if (m_copyLength && m_copyOffset + m_copyLength == offset) {
+            m_copyLength += length;
+            return;
+        }
+        FlushCopy();
+        m_copyOffset = offset;
+        m_copyLength = length;
+    }
+
+    void Literal(const uint8_t* data, uint64_t length) {
+        if (!length) return;
+        FlushCopy();
+        while (length) {
+            uint32_t n = length > 0xffffffffu ? 0xffffffffu : (uint32_t)length;
+            std::string op(1, (char)OP_LITERAL);
+            PutU32(op, n);
+            m_out.write(op.data(), op.size());
+            m_out.write((const char*)data, n);
+            m_stats.literalBytes += n;
+            data += n;
+            length -= n;
+        }
+    }
+
+    void FlushCopy() {
+        while (m_copyLength) {
+            uint32_t n = m_copyLength > 0xffffffffu ? 0xffffffffu : (uint32_t)m_copyLength;
+            std::string op(1, (char)OP_COPY);
+            PutU64(op, m_copyOffset);
+            PutU32(op, n);
+            m_out.write(op.data(), op.size());
+            m_stats.copiedBytes += n;
+            m_stats.copyOps++;
+            m_copyOffset += n;
+            m_copyLength -= n;
+        }
+    }
+
+private:
+    std::ofstream& m_out;
+    BinaryDeltaStats& m_stats;
+    uint64_t m_copyOffset = 0;
+    uint64_t m_copyLength = 0;
+};
+
+bool CreateBinaryDelta(const std::string& basePath, const std::string& targetPath,
+                       const std::string& deltaPath, BinaryDeltaStats* statsOut) {
+    std::vector<uint8_t> base, target;
+    if (!ReadWholeFile(basePath, base) || !ReadWholeFile(targetPath, target)) return false;
+
+    BinaryDeltaStats stats;
+    stats.baseSize = base.size();
+    stats.targetSize = target.size();
+
+    std::ofstream out(deltaPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    std::string header(DELTA_MAGIC, sizeof(DELTA_MAGIC));
+    PutU64(header, base.size());
+    PutU64(header, target.size());
+    uint8_t digest[Sha256::DIGEST_SIZE];
+    Sha256 baseHash;
+    baseHash.Update(base.data(), base.size());
+    baseHash.Final(digest);
+    header.append((const char*)digest, sizeof(digest));
+    Sha256 targetHash;
+    targetHash.Update(target.data(), target.size());
+    targetHash.Final(digest);
+    header.append((const char*)digest, sizeof(digest));
+    out.write(header.data(), header.size());
+
+    // Index every whole base block: hash chains through a power-of-two table
+    size_t blocks = base.size() / BLOCK;
+    size_t tableSize = 1024;
+    while (tableSize < blocks * 2) tableSize <<= 1;
+    std::vector<int64_t> head(tableSize, -1);
+    std::vector<int64_t> next(blocks, -1);
+    std::vector<uint32_t> blockHash(blocks);
+    RollingSum sum;
+    for (size_t i = 0; i < blocks; i++) {
+        sum.Init(base.data() + i * BLOCK);
+        uint32_t h = sum.Hash();
+        blockHash[i] = h;
+        size_t slot = h & (tableSize - 1);
+        next[i] = head[slot];
+        head[slot] = (int64_t)i;
+    }
+
+    DeltaWriter writer(out, stats);
+    const uint8_t* b = base.data();
+    const uint8_t* t = target.data();
+    size_t targetSize = target.size();
+    size_t baseSize = base.size();
+    size_t pos = 0;
+    size_t literalStart = 0;
+    if (blocks && targetSize >= BLOCK) sum.Init(t);
+
+    while (blocks && pos + BLOCK <= targetSize) {
+        uint32_t h = sum.Hash();
+        size_t bestOffset = 0, bestLength = 0;
+        int tries = 0;
+        for (int64_t c = head[h & (tableSize - 1)]; c >= 0 && tries < MAX_CANDIDATES; c = next[c], tries++) {
+            if (blockHash[c] != h) continue;
+            size_t offset = (size_t)c * BLOCK;
+            if (memcmp(b + offset, t + pos, BLOCK) != 0) continue;
+            size_t length = BLOCK;
+            while (offset + length < baseSize && pos + length < targetSize && b[offset + length] == t[pos + length]) length++;
+            if (length > bestLength) {
+                bestOffset = offset;
+                bestLength = length;
+            }
+        }
+
+        if (bestLength) {
+            // Grow the match backwards over bytes not yet emitted
+            size_t back = 0;
+            while (pos - back > literalStart && bestOffset > back && b[bestOffset - back - 1] == t[pos - back - 1]) back++;
+            writer.Literal(t + literalStart, pos - back - literalStart);
+            writer.Copy(bestOffset - back, bestLength + back);
+            pos += bestLength;
+            literalStart = pos;
+            if (pos + BLOCK <= targetSize) sum.Init(t + pos);
+        } else {
+            if (pos + BLOCK < targetSize) sum.Roll(t[pos], t[pos + BLOCK]);
+            pos++;
+        }
+    }
+    writer.Literal(t + literalStart, targetSize - literalStart);
+    writer.FlushCopy();
+
+    out.flush();
+    stats.deltaSize = (uint64_t)out.tellp();
+    bool ok = out.good();
+    out.close();
+    if (!ok) {
+        remove(deltaPath.c_str());
+        return false;
+    }
+    if (statsOut) *statsOut = stats;
+    return true;
+}
+
+static bool ReadDeltaHeader(std::ifstream& in, uint64_t& baseSize, uint64_t& targetSize,
+                            uint8_t baseSha[32], uint8_t targetSha[32]) {
+    uint8_t header[DELTA_HEADER_SIZE];
+    if (!in.read((char*)header, sizeof(header))) return false;
+    if (memcmp(header, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0) return false;
+    baseSize = GetU64(header + 8);
+    targetSize = GetU64(header + 16);
+    memcpy(baseSha, header + 24, 32);
+    memcpy(targetSha, header + 56, 32);
+    return true;
+}
+
+std::string GetBinaryDeltaBaseSha256(const std::string& deltaPath) {
+    std::ifstream in(deltaPath, std::ios::binary);
+    uint64_t baseSize, targetSize;
+    uint8_t baseSha[32], targetSha[32];
+    if (!in.is_open() || !ReadDeltaHeader(in, baseSize, targetSize, baseSha, targetSha)) return "";
+    return ToHex(baseSha, 32);
+}
+
+static bool Fail(std::string* error, const char* message) {
+    if (error) *error = message;
+    return false;
+}
+
+bool ApplyBinaryDelta(const std::string& basePath, const std::string& deltaPath,
+                      const std::string& outPath, std::string* error) {
+    std::ifstream in(deltaPath, std::ios::binary);
+    if (!in.is_open()) return Fail(error, "cannot open delta");
+    uint64_t baseSize, targetSize;
+    uint8_t baseSha[32], targetSha[32];
+    if (!ReadDeltaHeader(in, baseSize, targetSize, baseSha, targetSha)) return Fail(error, "not a delta file");
+
+    // Copies read the base at random offsets: map it
+    MappedFile base;
+    if (baseSize > 0 && !base.Open(basePath)) return Fail(error, "cannot open base");
+    if (base.GetSize() != baseSize) return Fail(error, "base size mismatch");
+    if (baseSize > 0) {
+        Sha256 h;
+        h.Update(base.GetData(), (size_t)baseSize);
+        uint8_t digest[32];
+        h.Final(digest);
+        if (memcmp(digest, baseSha, 32) != 0) return Fail(error, "base digest mismatch");
+    }
+
+    std::string tmpPath = outPath + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return Fail(error, "cannot create output");
+
+    Sha256 targetHash;
+    std::vector<char> buffer(IO_CHUNK);
+    uint64_t written = 0;
+    bool ok = true;
+    const char* why = "";
+    while (ok && written < targetSize) {
+        uint8_t op[13];
+        if (!in.read((char*)op, 1)) { ok = false; why = "truncated delta"; break; }
+        if (op[0] == OP_COPY) {
+            if (!in.read((char*)op + 1, 12)) { ok = false; why = "truncated delta"; break; }
+            uint64_t offset = GetU64(op + 1);
+            uint32_t length = GetU32(op + 9);
+            if (offset > baseSize || length > baseSize - offset || length > targetSize - written) {
+                ok = false; why = "copy out of range"; break;
+            }
+            const uint8_t* src = base.GetData() + offset;
+            out.write((const char*)src, length);
+            targetHash.Update(src, length);
+            written += length;
+        } else if (op[0] == OP_LITERAL) {
+            if (!in.read((char*)op + 1, 4)) { ok = false; why = "truncated delta"; break; }
+            uint32_t length = GetU32(op + 1);
+            if (length > targetSize - written) { ok = false; why = "literal out of range"; break; }
+            while (length) {
+                size_t n = length < buffer.size() ? length : buffer.size();
+                if (!in.read(buffer.data(), n)) { ok = false; why = "truncated delta"; break; }
+                out.write(buffer.data(), n);
+                targetHash.Update(buffer.data(), n);
+                written += n;
+                length -= (uint32_t)n;
+            }
+        } else {
+            ok = false; why = "unknown op";
+        }
+    }
+    out.close();
+    if (ok && !out) { ok = false; why = "write failed"; }
+    if (ok) {
+        uint8_t digest[32];
+        targetHash.Final(digest);
+        if (memcmp(digest, targetSha, 32) != 0) { ok = false; why = "target digest mismatch"; }
+    }
+    if (ok) {
+        remove(outPath.c_str());
+        if (rename(tmpPath.c_str(), outPath.c_str()) != 0) { ok = false; why = "cannot rename output"; }
+    }
+    if (!ok) {
+        remove(tmpPath.c_str());
+        return Fail(error, why);
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Binary delta between two versions of a release file (update patches).
+//
+// The target is described as copies from the base plus literal bytes, found
+// rsync style: the base is indexed in 32-byte blocks by a rolling checksum,
+// the target is scanned byte by byte and every verified block match is
+// extended in both directions. Code sections that moved between builds
+// become a handful of copies; only new bytes travel.
+//
+// File layout (little endian):
+//   "MMDELTA1"
+//   u64 base size, u64 target size
+//   32 bytes base SHA-256, 32 bytes target SHA-256
+//   ops until target size bytes are produced:
+//     0x01 u64 base offset, u32 length    copy from the base
+//     0x02 u32 length, <length bytes>     literal bytes
+//
+// Apply checks the base digest before writing anything and the target
+// digest as it writes; the output only appears at outPath if both match.
+
+struct BinaryDeltaStats {
+    uint64_t baseSize = 0;
+    uint64_t targetSize = 0;
+    uint64_t deltaSize = 0;
+    uint64_t copiedBytes = 0;
+    uint64_t literalBytes = 0;
+    uint64_t copyOps = 0;
+};
+
+bool CreateBinaryDelta(const std::string& basePath, const std::string& targetPath,
+                       const std::string& deltaPath, BinaryDeltaStats* stats = nullptr);
+
+bool ApplyBinaryDelta(const std::string& basePath, const std::string& deltaPath,
+                      const std::string& outPath, std::string* error = nullptr);
+
+// Hex SHA-256 of the base a delta expects (empty if unreadable)
+std::string GetBinaryDeltaBaseSha256(const std::string& deltaPath);
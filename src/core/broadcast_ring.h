@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+// Lock-free single-producer / multi-consumer broadcast ring.
+//
+// Like SpscRing the positions are monotonically increasing 64-bit indices,
+// but readers do not consume: each one keeps its own cursor and reads
+// everything written after it. The producer never waits for readers. A
+// reader that falls more than the capacity behind loses the oldest data
+// (Read reports how much) instead of stalling the producer or the other
+// readers. Only trivially copyable T.
+//
+// Overwrites during a copy are detected seqlock-style (the claim index plays
+// the sequence number):
+//   producer  claim.store(w + n, relaxed); fence(release);
+//             buffer stores (relaxed);     write.store(w + n, release)
+//   reader    w = write.load(acquire);     buffer loads (relaxed);
+//             fence(acquire);              claim.load(relaxed)
+// If any load in the copy saw a byte of a later Write, the release fence
+// before those stores synchronizes with the reader's acquire fence, so the
+// re-check sees that Write's claim and the copy is retried. That only holds
+// if the buffer accesses are atomics themselves: the storage is an array of
+// machine words copied through relaxed atomic loads and stores (plain moves
+// on x86 and ARM), never memcpy of shared memory.
+template <typename T>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable<T>::value, "BroadcastRing needs a trivially copyable T");
+    using Word = uintptr_t;
+
+public:
+    explicit BroadcastRing(size_t minCapacity = 0) { Reset(minCapacity); }
+
+    // Not thread safe - only while neither side is running
+    void Reset(size_t minCapacity) {
+        size_t cap = 1;
+        while (cap < minCapacity) cap <<= 1;
+        m_words = std::vector<std::atomic<Word>>((cap * sizeof(T) + sizeof(Word) - 1) / sizeof(Word));
+        m_capacity = cap;
+        m_mask = cap - 1;
+        m_claim.store(0, std::memory_order_relaxed);
+        m_write.store(0, std::memory_order_relaxed);
+    }
+
+    size_t GetCapacity() const { return m_capacity; }
+
+    // ── Producer side ──
+    // Always succeeds; more than the capacity keeps only the newest items
+    void Write(const T* data, size_t count) {
+        uint64_t w = m_write.load(std::memory_order_relaxed);
+        if (count > m_capacity) {
+            data += count - m_capacity;
+            w += count - m_capacity;
+            count = m_capacity;
+        }
+        m_claim.store(w + count, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        size_t first = std::min(count, m_capacity - (size_t)(w & m_mask));
+        StoreBytes((size_t)(w & m_mask) * sizeof(T), reinterpret_cast<const uint8_t*>(data), first * sizeof(T));
+        StoreBytes(0, reinterpret_cast<const uint8_t*>(data + first), (count - first) * sizeof(T));
+        m_write.store(w + count, std::memory_order_release);
+    }
+
+    uint64_t GetWriteIndex() const { return m_write.load(std::memory_order_acquire); }
+
+    // ── Reader side (any thread, cursor owned by the reader) ──
+    // Oldest index still held. Readers behind it have been lapped.
+    uint64_t GetOldestIndex() const {
+        uint64_t w = m_write.load(std::memory_order_acquire);
+        return w > m_capacity ? w - m_capacity : 0;
+    }
+
+    // Copy up to count items starting at cursor and advance it. If the
+    // producer lapped the reader, cursor first moves to alignUp(oldest)
+    // and the skipped items are added to *lost. alignUp lets byte readers
+    // resume on a frame boundary.
+    template <typename AlignFn>
+    size_t Read(uint64_t& cursor, T* out, size_t count, uint64_t* lost, AlignFn alignUp) const {
+        for (;;) {
+            uint64_t w = m_write.load(std::memory_order_acquire);
+            uint64_t oldest = w > m_capacity ? w - m_capacity : 0;
+            if (cursor < oldest) {
+                uint64_t resume = std::min<uint64_t>(alignUp(oldest), w);
+                if (lost) *lost += resume - cursor;
+                cursor = resume;
+            }
+            size_t n = (size_t)std::min<uint64_t>(count, w - cursor);
+            size_t first = std::min(n, m_capacity - (size_t)(cursor & m_mask));
+            LoadBytes((size_t)(cursor & m_mask) * sizeof(T), reinterpret_cast<uint8_t*>(out), first * sizeof(T));
+            LoadBytes(0, reinterpret_cast<uint8_t*>(out + first), (n - first) * sizeof(T));
+            // Pairs with the producer's release fence: orders the loads above
+            // before the claim re-check. Anything below claim - capacity may
+            // have been overwritten mid-copy.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_claim.load(std::memory_order_relaxed) <= cursor + m_capacity) {
+                cursor += n;
+                return n;
+            }
+        }
+    }
+
+    size_t Read(uint64_t& cursor, T* out, size_t count, uint64_t* lost = nullptr) const {
+        return Read(cursor, out, count, lost, [](uint64_t index) { return index; });
+    }
+
+private:
+    // Producer only. Partial words at either end are merged with what the
+    // word already holds; readers never see a torn word, only old or new.
+    void StoreBytes(size_t offset, const uint8_t* src, size_t len) {
+        while (len > 0) {
+            std::atomic<Word>& slot = m_words[offset / sizeof(Word)];
+            size_t at = offset % sizeof(Word);
+            size_t n = std::min(len, sizeof(Word) - at);
+            Word word = n == sizeof(Word) ? 0 : slot.load(std::memory_order_relaxed);
+            memcpy(reinterpret_cast<uint8_t*>(&word) + at, src, n);
+            slot.store(word, std::memory_order_relaxed);
+            offset += n;
+            src += n;
+            len -= n;
+        }
+    }
+
+    void LoadBytes(size_t offset, uint8_t* dst, size_t len) const {
+        while (len > 0) {
+            size_t at = offset % sizeof(Word);
+            size_t n = std::min(len, sizeof(Word) - at);
+            Word word = m_words[offset / sizeof(Word)].load(std::memory_order_relaxed);
+            memcpy(dst, reinterpret_cast<const uint8_t*>(&word) + at, n);
+            offset += n;
+            dst += n;
+            len -= n;
+        }
+    }
+
+    std::vector<std::atomic<Word>> m_words;
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<uint64_t> m_claim{0};
+    alignas(64) std::atomic<uint64_t> m_write{0};
+};
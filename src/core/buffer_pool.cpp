@@ -0,0 +1,150 @@
+#include "core/buffer_pool.h"
+#include <cstring>
+
+// ─────────────────────────── Buffer ──────────────────────────────────────────
+
+BufferPool::Buffer::Buffer(Buffer&& other) noexcept
+    : m_data(std::move(other.m_data)), m_pool(other.m_pool) {
+    other.m_data = std::vector<uint8_t>();
+    other.m_pool = nullptr;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_data = std::move(other.m_data);
+        m_pool = other.m_pool;
+        other.m_data = std::vector<uint8_t>();
+        other.m_pool = nullptr;
+    }
+    return *this;
+}
+
+void BufferPool::Buffer::Reserve(size_t bytes) {
+    if (bytes <= m_data.capacity()) return;
+    // Round up to the size class so the storage lands in a useful bucket
+    // when it goes back, and leaves headroom for the next chunk's jitter
+    m_data.reserve(ClassSize(bytes));
+    if (m_pool) m_pool->m_heapAllocations++;
+}
+
+void BufferPool::Buffer::resize(size_t bytes) {
+    Reserve(bytes);
+    m_data.resize(bytes);
+}
+
+void BufferPool::Buffer::Append(const void* src, size_t bytes) {
+    size_t at = m_data.size();
+    resize(at + bytes);
+    memcpy(m_data.data() + at, src, bytes);
+}
+
+void BufferPool::Buffer::AppendZeros(size_t bytes) {
+    size_t at = m_data.size();
+    resize(at + bytes);
+    memset(m_data.data() + at, 0, bytes);
+}
+
+void BufferPool::Buffer::Release() {
+    if (m_pool) {
+        m_pool->m_outstanding--;
+        m_pool->Return(std::move(m_data));
+        m_pool = nullptr;
+    }
+    m_data = std::vector<uint8_t>();
+}
+
+// ─────────────────────────── BufferPool ──────────────────────────────────────
+
+BufferPool::BufferPool() {
+    // Free lists never grow past this, so returning a buffer never allocates
+    for (auto& list : m_free) list.reserve(MAX_FREE_PER_CLASS);
+}
+
+size_t BufferPool::ClassSize(size_t bytes) {
+    size_t size = (size_t)1 << MIN_CLASS_SHIFT;
+    while (size < bytes && size < ((size_t)1 << MAX_CLASS_SHIFT)) size <<= 1;
+    return size < bytes ? bytes : size;
+}
+
+size_t BufferPool::ClassIndex(size_t capacity) {
+    size_t index = 0;
+    while (index + 1 < CLASS_COUNT && ((size_t)1 << (MIN_CLASS_SHIFT + index + 1)) <= capacity) index++;
+    return index;
+}
+
+BufferPool::Buffer BufferPool::Acquire(size_t minCapacity) {
+    Buffer buffer;
+    buffer.m_pool = this;
+    m_outstanding++;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_acquires++;
+        // Smallest free buffer that is big enough, searching up from the
+        // class the request falls in
+        size_t wanted = ClassSize(minCapacity);
+        for (size_t i = ClassIndex(wanted); i < CLASS_COUNT; i++) {
+            auto& list = m_free[i];
+            for (size_t k = list.size(); k-- > 0;) {
+                if (list[k].capacity() < minCapacity) continue;
+                buffer.m_data = std::move(list[k]);
+                list.erase(list.begin() + k);
+                m_reuses++;
+                m_pooledBuffers--;
+                m_pooledBytes -= buffer.m_data.capacity();
+                return buffer;
+            }
+        }
+    }
+    if (minCapacity) buffer.Reserve(minCapacity);
+    return buffer;
+}
+
+void BufferPool::Return(std::vector<uint8_t>&& storage) {
+    size_t capacity = storage.capacity();
+    if (capacity < ((size_t)1 << MIN_CLASS_SHIFT)) return;
+    storage.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& list = m_free[ClassIndex(capacity)];
+    if (list.size() >= MAX_FREE_PER_CLASS) return;   // Freed when storage goes out of scope
+    list.push_back(std::move(storage));
+    m_pooledBuffers++;
+    m_pooledBytes += capacity;
+}
+
+void BufferPool::Trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& list : m_free) list.clear();
+    m_pooledBuffers = 0;
+    m_pooledBytes = 0;
+}
+
+BufferPool::Stats BufferPool::GetStats() const {
+    Stats stats;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.acquires = m_acquires;
+    stats.reuses = m_reuses;
+    stats.heapAllocations = m_heapAllocations.load();
+    stats.pooledBuffers = m_pooledBuffers;
+    stats.pooledBytes = m_pooledBytes;
+    stats.outstanding = m_outstanding.load();
+    return stats;
+}
+
+std::string BufferPool::Stats::ToJson() const {
+    std::string json = "{";
+    json += "\"acquires\":" + std::to_string(acquires);
+    json += ",\"reuses\":" + std::to_string(reuses);
+    json += ",\"heapAllocations\":" + std::to_string(heapAllocations);
+    json += ",\"pooledBuffers\":" + std::to_string(pooledBuffers);
+    json += ",\"pooledBytes\":" + std::to_string(pooledBytes);
+    json += ",\"outstanding\":" + std::to_string(outstanding);
+    json += "}";
+    return json;
+}
+
+BufferPool& GetAudioBufferPool() {
+    // Never destroyed: recorder buffers may be released during static teardown
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
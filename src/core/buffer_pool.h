@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Size-classed pool of byte buffers for the recording path.
+//
+// Capture threads append into a pooled buffer; every chunk the mixer takes
+// that buffer and hands the capture thread a recycled one, mixes into a
+// pooled output buffer and passes it to the writer. Buffers go back to the
+// pool when their handle is destroyed, with their capacity intact, so
+// after the first chunk or two a recording allocates nothing.
+//
+// Classes are powers of two from 4 KB to 64 MB; each keeps a few free
+// buffers and anything beyond that is freed. Acquire/release take a mutex:
+// they happen a few times per chunk, not per packet.
+class BufferPool {
+public:
+    // Move-only handle. Returns its storage to the pool on destruction.
+    class Buffer {
+    public:
+        Buffer() = default;
+        ~Buffer() { Release(); }
+        Buffer(Buffer&& other) noexcept;
+        Buffer& operator=(Buffer&& other) noexcept;
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        uint8_t* data() { return m_data.data(); }
+        const uint8_t* data() const { return m_data.data(); }
+        size_t size() const { return m_data.size(); }
+        size_t capacity() const { return m_data.capacity(); }
+        bool empty() const { return m_data.empty(); }
+
+        // Growing past the capacity reallocates and is counted as a heap
+        // allocation; shrinking keeps the storage
+        void resize(size_t bytes);
+        void Append(const void* src, size_t bytes);
+        void AppendZeros(size_t bytes);
+        void clear() { m_data.clear(); }
+
+        // Back to the pool now (the handle becomes empty)
+        void Release();
+
+    private:
+        friend class BufferPool;
+        void Reserve(size_t bytes);
+
+        std::vector<uint8_t> m_data;
+        BufferPool* m_pool = nullptr;
+    };
+
+    BufferPool();
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Empty buffer with at least minCapacity bytes of storage
+    Buffer Acquire(size_t minCapacity);
+
+    // Frees every pooled buffer (outstanding ones still come back later)
+    void Trim();
+
+    struct Stats {
+        uint64_t acquires = 0;
+        uint64_t reuses = 0;            // Acquires served from the pool
+        uint64_t heapAllocations = 0;   // New storage: pool misses + growth
+        uint64_t pooledBuffers = 0;     // Free buffers held now
+        uint64_t pooledBytes = 0;
+        uint64_t outstanding = 0;       // Handles alive now
+
+        std::string ToJson() const;
+    };
+    Stats GetStats() const;
+
+    static size_t ClassSize(size_t bytes);
+
+private:
+    static constexpr size_t MIN_CLASS_SHIFT = 12;   // 4 KB
+    static constexpr size_t MAX_CLASS_SHIFT = 26;   // 64 MB
+    static constexpr size_t CLASS_COUNT = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+    static constexpr size_t MAX_FREE_PER_CLASS = 4;
+
+    static size_t ClassIndex(size_t capacity);      // Largest class that fits in capacity
+    void Return(std::vector<uint8_t>&& storage);
+
+    mutable std::mutex m_mutex;
+    std::vector<std::vector<uint8_t>> m_free[CLASS_COUNT];
+    uint64_t m_acquires = 0;
+    uint64_t m_reuses = 0;
+    uint64_t m_pooledBytes = 0;
+    uint64_t m_pooledBuffers = 0;
+    std::atomic<uint64_t> m_heapAllocations{0};
+    std::atomic<uint64_t> m_outstanding{0};
+};
+
+// Shared by the capture, mixer and writer threads of every recording
+BufferPool& GetAudioBufferPool();
@@ -0,0 +1,79 @@
+#include "core/frame_scheduler.h"
+
+FrameScheduler::TaskId FrameScheduler::AddTask(const char* name, uint32_t periodMs, uint32_t slackMs,
+                                               std::function<bool()> run) {
+    Task task;
+    task.name = name;
+    task.periodMs = periodMs ? periodMs : 1;
+    task.slackMs = slackMs < task.periodMs ? slackMs : task.periodMs - 1;
+    task.run = std::move(run);
+    m_tasks.push_back(std::move(task));
+    return m_tasks.size() - 1;
+}
+
+void FrameScheduler::SetActive(TaskId id, bool active, uint64_t nowMs, bool runNow) {
+    if (id >= m_tasks.size()) return;
+    Task& task = m_tasks[id];
+    if (!active) {
+        task.active = false;
+        return;
+    }
+    if (task.active) {
+        if (runNow && task.dueMs > nowMs) task.dueMs = nowMs;
+        return;
+    }
+    task.active = true;
+    task.dueMs = runNow ? nowMs : nowMs + task.periodMs;
+}
+
+bool FrameScheduler::IsActive(TaskId id) const {
+    return id < m_tasks.size() && m_tasks[id].active;
+}
+
+void FrameScheduler::SetPeriod(TaskId id, uint32_t periodMs) {
+    if (id >= m_tasks.size() || periodMs == 0) return;
+    Task& task = m_tasks[id];
+    task.periodMs = periodMs;
+    if (task.slackMs >= periodMs) task.slackMs = periodMs - 1;
+}
+
+size_t FrameScheduler::RunDue(uint64_t nowMs) {
+    size_t ran = 0;
+    // Index loop: a task may activate or add others from its callback
+    for (size_t i = 0; i < m_tasks.size(); i++) {
+        Task& task = m_tasks[i];
+        if (!task.active || task.dueMs > nowMs + task.slackMs) continue;
+
+        // Next deadline on the original cadence, or from now if we fell behind
+        uint64_t next = task.dueMs + task.periodMs;
+        if (next <= nowMs) next = nowMs + task.periodMs;
+        task.dueMs = next;
+        task.runs++;
+        ran++;
+
+        // Copy: the callback may add tasks and reallocate m_tasks
+        std::function<bool()> run = task.run;
+        bool keep = run ? run() : false;
+        if (!keep) m_tasks[i].active = false;
+    }
+    m_stats.runs += ran;
+    if (ran) m_stats.wakeups++;
+    else m_stats.spurious++;
+    return ran;
+}
+
+uint64_t FrameScheduler::GetNextWakeup() const {
+    uint64_t next = NEVER;
+    for (const Task& task : m_tasks) {
+        if (task.active && task.dueMs < next) next = task.dueMs;
+    }
+    return next;
+}
+
+uint64_t FrameScheduler::GetTaskRuns(TaskId id) const {
+    return id < m_tasks.size() ? m_tasks[id].runs : 0;
+}
+
+const char* FrameScheduler::GetTaskName(TaskId id) const {
+    return id < m_tasks.size() ? m_tasks[id].name : "";
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// One tick source for all periodic UI work (meters, animations, playback
+// position, housekeeping) instead of a Win32 timer per feature.
+//
+// Each task has a period and a slack. A task runs at the latest when its
+// period is up and may run up to `slack` ms early, which lets slow tasks
+// ride along with a wakeup that happens anyway. Inactive tasks cost nothing;
+// with no active task GetNextWakeup() is NEVER and the caller arms no timer.
+//
+// Decision logic only: the caller passes the current time to every call,
+// so it behaves the same against the system clock and a virtual one. Not
+// thread safe; owned by the UI thread.
+class FrameScheduler {
+public:
+    using TaskId = size_t;
+    static constexpr uint64_t NEVER = UINT64_MAX;
+
+    // run returns false when the task has nothing left to do (an animation
+    // that settled, a player that stopped); it then stays idle until the
+    // next SetActive(id, true).
+    TaskId AddTask(const char* name, uint32_t periodMs, uint32_t slackMs, std::function<bool()> run);
+
+    // Activating an idle task schedules its first run one period from now
+    // (or right away with runNow). Activating an active task leaves its
+    // schedule alone.
+    void SetActive(TaskId id, bool active, uint64_t nowMs, bool runNow = false);
+    bool IsActive(TaskId id) const;
+
+    // A new period takes effect from the next run
+    void SetPeriod(TaskId id, uint32_t periodMs);
+
+    // Runs every task inside its window (due - slack <= now), in the order
+    // they were added. Returns the number of tasks run. A wakeup that comes
+    // late runs each task once and reschedules from now: no catch-up burst.
+    size_t RunDue(uint64_t nowMs);
+
+    // Absolute time of the next hard deadline, NEVER when idle
+    uint64_t GetNextWakeup() const;
+
+    struct Stats {
+        uint64_t wakeups = 0;       // RunDue calls that ran at least one task
+        uint64_t spurious = 0;      // RunDue calls that ran nothing
+        uint64_t runs = 0;          // Task runs
+    };
+    Stats GetStats() const { return m_stats; }
+    uint64_t GetTaskRuns(TaskId id) const;
+    const char* GetTaskName(TaskId id) const;
+    size_t GetTaskCount() const { return m_tasks.size(); }
+
+private:
+    struct Task {
+        const char* name;
+        uint32_t periodMs;
+        uint32_t slackMs;
+        std::function<bool()> run;
+        bool active = false;
+        uint64_t dueMs = 0;
+        uint64_t runs = 0;
+    };
+
+    std::vector<Task> m_tasks;
+    Stats m_stats;
+};
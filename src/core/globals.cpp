@@ -32,6 +32,36 @@ const char* APP_PASSWORD = STRINGIZE(APP_PASSWORD_SECRET);
 bool hasAgreedToDisclaimer = false;
 bool hasAgreedToManualDisclaimer = false;
 int autoDeleteDays = 0; // 0 = Never delete
+int retentionMaxTotalGB = 0;
+int retentionMinFreeGB = 0;
+int retentionDeletesPerSec = 20;
+int archiveAfterDays = 0;
+bool writeMetadataSidecar = false;
+bool uploadEnabled = false;
+std::string uploadEndpoint = "";
+std::string uploadRegion = "us-east-1";
+std::string uploadBucket = "";
+std::string uploadAccessKey = "";
+std::string uploadSecretKey = "";
+int uploadMaxKBps = 0;
+int uploadRecordingKBps = 64;
+int uploadParallelParts = 3;
+
+bool updatePeerCacheEnabled = false;
+std::string updatePeerUrl = "";
+
+bool micDspHighPass = true;
+bool micDspNoiseGate = false;
+bool micDspAgc = false;
+bool micDspLimiter = true;
+bool micDspNoiseSuppression = false;
+
+bool encryptRecordings = false;
+
+bool headlessMode = false;
+std::string captureBackend = "wasapi";
+std::string captureMicFile = "";
+std::string captureLoopbackFile = "";
 int scrollY = 0;
 
 // Control Panel visibility (all visible by default)
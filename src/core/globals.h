@@ -29,6 +29,44 @@ extern const char* APP_PASSWORD;
 extern bool hasAgreedToDisclaimer;
 extern bool hasAgreedToManualDisclaimer;
 extern int autoDeleteDays;
+extern int retentionMaxTotalGB;     // 0 = no byte budget for recordings
+extern int retentionMinFreeGB;      // 0 = don't enforce free disk space
+extern int retentionDeletesPerSec;  // Rate limit for background deletion
+extern int archiveAfterDays;        // Transcode recordings older than this to ADPCM (0 = off)
+extern bool writeMetadataSidecar; // Also write compact <name>.meta next to recordings
+
+// Upload of finished recordings to S3-compatible storage
+extern bool uploadEnabled;
+extern std::string uploadEndpoint;   // e.g. https://s3.eu-west-1.amazonaws.com
+extern std::string uploadRegion;
+extern std::string uploadBucket;
+extern std::string uploadAccessKey;
+extern std::string uploadSecretKey;  // Stored DPAPI-encrypted
+extern int uploadMaxKBps;            // 0 = unlimited
+extern int uploadRecordingKBps;      // Limit while a call is recorded (0 = pause)
+extern int uploadParallelParts;
+
+// Updates through a LAN peer cache (one seat downloads, the others copy)
+extern bool updatePeerCacheEnabled;     // Serve this seat's update cache on port 9877
+extern std::string updatePeerUrl;       // Peer to ask first, e.g. http://10.0.0.5:9877
+
+// Mic DSP chain between capture and mixing (each stage optional)
+extern bool micDspHighPass;
+extern bool micDspNoiseGate;
+extern bool micDspAgc;
+extern bool micDspLimiter;           // Also limits the mix instead of hard clipping it
+extern bool micDspNoiseSuppression;
+
+// New recordings encrypted at rest (AES-256-GCM, keys DPAPI-protected)
+extern bool encryptRecordings;
+
+// Headless service (MicMute-S-service.exe): no windows or dialogs, set up
+// from a config file. The capture source is only configurable there.
+extern bool headlessMode;
+extern std::string captureBackend;      // "wasapi", "synthetic" or "file"
+extern std::string captureMicFile;      // WAVs looped by the file backend
+extern std::string captureLoopbackFile;
+
 extern int scrollY; // Vertical scroll position for General tab
 
 // Control Panel visibility toggles
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <cstdio>
+
+// Escape a string for embedding in a JSON string literal
+inline std::string JsonEscape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if (c == '\n') out += "\\n";
+        else if (c == '\r') out += "\\r";
+        else if (c == '\t') out += "\\t";
+        else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)c);
+            out += buf;
+        }
+        else out += c;
+    }
+    return out;
+}
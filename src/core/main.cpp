@@ -13,6 +13,9 @@
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <atomic>
 #include "core/resource.h"
 
 // Temporary ID manually added if not in resource.h yet
@@ -28,12 +31,15 @@
 #include "ui/ui.h"
 #include "audio/recorder.h"
 #include "audio/call_recorder.h"
+#include "audio/CaptureHub.h"
 #include "ui/ui_controls.h"
 #include "ui/control_panel.h"
 #include "network/updater.h"
+#include "core/background_jobs.h"
 #include "ui/password_dialog.h"
 #include "ui/disclaimer_dialog.h"
 #include "ui/developer_options.h"
+#include "core/startup_profiler.h"
 
 
 #ifndef DWMWA_USE_IMMERSIVE_DARK_MODE
@@ -171,41 +177,96 @@ void ResizeControlPanel() {
     SetWindowPos(hControlPanel, nullptr, 0, 0, w, h, SWP_NOMOVE | SWP_NOZORDER);
 }
 
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
-    // Set high shutdown priority (0x280 is default for shell, we use same to be treated as system app)
-    SetProcessShutdownParameters(0x280, 0);
-    
-    HRESULT hr = CoInitialize(nullptr);
-    if (FAILED(hr)) return 0;
+// ─────────────────────────── Startup ─────────────────────────────────────────
+// Critical phase (before the message loop): settings, GDI resources, the
+// main window and the tray icon. Everything else is deferred: the audio
+// stack is warmed, and the upload journal started, on warm-up threads from
+// the first lines of WinMain; audio, the call recorder and the control
+// panel follow on the UI thread once the loop runs, and the HTTP server on
+// a warm-up thread once the call recorder exists. The player and developer
+// windows are created on first use.
 
-    HANDLE hMutex = CreateMutex(nullptr, TRUE, "MicMuteS_SingleInstanceMutex");
-    if (GetLastError() == ERROR_ALREADY_EXISTS) {
-        HWND hExisting = FindWindow("MicMuteS_Class", "MicMute-S");
-        if (hExisting) {
-            ShowWindow(hExisting, SW_RESTORE);
-            SetForegroundWindow(hExisting);
-        }
-        CloseHandle(hMutex);
-        CoUninitialize();
-        return 0;
+#define UPDATE_CHECK_TIMER_ID 2
+
+static std::vector<std::thread> startupThreads;
+static std::atomic<int> startupPending(0);
+
+// Every deferred step calls this once; the last one closes the timeline
+static void FinishStartupStep() {
+    if (--startupPending == 0 && StartupMarkComplete()) {
+        OutputDebugStringA(StartupTimelineReport().c_str());
     }
+}
+
+static void StartWarmupThread(void (*step)()) {
+    startupPending++;
+    startupThreads.emplace_back([step] {
+        step();
+        FinishStartupStep();
+    });
+}
 
-    InitCommonControls();
+static void WaitForWarmupThreads() {
+    for (auto& t : startupThreads) {
+        if (t.joinable()) t.join();
+    }
+    startupThreads.clear();
+}
+
+// Time the process spent in the loader and static init before WinMain
+static double GetMsBeforeMain() {
+    FILETIME created, exited, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0.0;
+    GetSystemTimeAsFileTime(&now);
+    ULARGE_INTEGER a, b;
+    a.LowPart = created.dwLowDateTime; a.HighPart = created.dwHighDateTime;
+    b.LowPart = now.dwLowDateTime; b.HighPart = now.dwHighDateTime;
+    if (b.QuadPart <= a.QuadPart) return 0.0;
+    return (double)(b.QuadPart - a.QuadPart) / 10000.0;
+}
+
+// WM_APP_STARTUP_DEFERRED: the UI-thread half of the deferred phase
+static void RunDeferredStartup(HWND hWnd) {
+    {
+        StartupPhase phase("audio");
+        InitializeAudio();
+    }
+    {
+        StartupPhase phase("call recorder");
+        InitCallRecorder();     // Enables itself if autoRecordCalls
+    }
+    // Only now that the recorder exists: an earlier /start would get a 200
+    // and record nothing. Starting the thread here also publishes
+    // g_CallRecorder to the server thread.
+    StartWarmupThread([] {
+        StartupPhase phase("http server");
+        InitHttpServer();
+    });
+    {
+        StartupPhase phase("control panel");
+        CreateControlPanel(GetModuleHandle(nullptr));
+    }
+    UpdateUIState();            // Real mute state for the tray icon
+    RefreshFrameScheduler();
+    FinishStartupStep();
+
+    // Login storms: spread the seats' silent update checks over a few
+    // minutes instead of every machine hitting the API at once
+    UINT jitter = (GetTickCount() ^ (GetCurrentProcessId() * 2654435761u)) % 240000;
+    SetTimer(hWnd, UPDATE_CHECK_TIMER_ID, 60000 + jitter, nullptr);
 
-    InitializeAudio();
-    InitCallRecorder();
-    InitHttpServer();
-    
-    // Auto-Updater Init
-    AutoUpdater::Init(hMainWnd);
-    // Silent startup check
     if (isRunOnStartup) {
-        AutoUpdater::CheckForUpdateAsync(true);
+        ManageStartup(true);    // Refresh the Run key (exe may have moved)
     } else {
-        // Also check silently on normal launch
-        AutoUpdater::CheckForUpdateAsync(true);
+        if (MessageBox(hWnd, "Enable Startup with Windows?", "MicMute-S", MB_YESNO | MB_ICONQUESTION) == IDYES) {
+             ManageStartup(true);
+             isRunOnStartup = true;
+             SaveSettings();
+        }
     }
+}
 
+static void CreateGdiResources(HINSTANCE hInstance) {
     // Create brushes
     hBrushBg = CreateSolidBrush(colorBg);
     hBrushSidebarBg = CreateSolidBrush(colorSidebarBg);
@@ -217,6 +278,28 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     hBrushChroma = CreateSolidBrush(colorChroma);
     hBrushPanelBg = CreateSolidBrush(colorPanelBg);
 
+    // Load High-Res icons (e.g. 64x64) for Control Panel usage
+    // Standard LoadIcon loads 32x32 which looks bad on large buttons.
+    int iconSize = 64; 
+    hIconMicOn = (HICON)LoadImage(hInstance, MAKEINTRESOURCE(IDI_MIC_ON), IMAGE_ICON, iconSize, iconSize, LR_DEFAULTCOLOR);
+    hIconMicOff = (HICON)LoadImage(hInstance, MAKEINTRESOURCE(IDI_MIC_OFF), IMAGE_ICON, iconSize, iconSize, LR_DEFAULTCOLOR);
+
+    // Create Fonts
+    hFontTitle = CreateFont(28, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
+        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
+    hFontStatus = CreateFont(24, 0, 0, 0, FW_SEMIBOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
+        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
+    hFontNormal = CreateFont(18, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
+        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
+    hFontSmall = CreateFont(14, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
+        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
+    hFontOverlay = CreateFont(18, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
+        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
+    hFontBold = CreateFont(20, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
+}
+
+static void RegisterWindowClasses(HINSTANCE hInstance) {
     // Register main window class
     WNDCLASSEX wc = {0};
     wc.cbSize = sizeof(WNDCLASSEX);
@@ -260,6 +343,10 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     wcRec.lpszClassName = "MicMuteS_Recorder";
     RegisterClassEx(&wcRec);
 
+    RegisterDeveloperOptionsClass(hInstance);
+}
+
+static bool CreateMainWindow(HINSTANCE hInstance) {
     // Window size
     int width = 850; 
     int height = 600; 
@@ -275,7 +362,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         nullptr, nullptr, hInstance, nullptr
     );
     
-    if (!hMainWnd) return 0;
+    if (!hMainWnd) return false;
 
     // Mica / DWM setup
     MARGINS margins = {-1};
@@ -289,63 +376,72 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     
     DWM_WINDOW_CORNER_PREFERENCE cornerPref = DWMWCP_ROUND;
     DwmSetWindowAttribute(hMainWnd, DWMWA_WINDOW_CORNER_PREFERENCE, &cornerPref, sizeof(cornerPref));
+    return true;
+}
 
-    // Load High-Res icons (e.g. 64x64) for Control Panel usage
-    // Standard LoadIcon loads 32x32 which looks bad on large buttons.
-    int iconSize = 64; 
-    hIconMicOn = (HICON)LoadImage(hInstance, MAKEINTRESOURCE(IDI_MIC_ON), IMAGE_ICON, iconSize, iconSize, LR_DEFAULTCOLOR);
-    hIconMicOff = (HICON)LoadImage(hInstance, MAKEINTRESOURCE(IDI_MIC_OFF), IMAGE_ICON, iconSize, iconSize, LR_DEFAULTCOLOR);
-
-    // Create Fonts
-    hFontTitle = CreateFont(28, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
-        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
-    hFontStatus = CreateFont(24, 0, 0, 0, FW_SEMIBOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
-        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
-    hFontNormal = CreateFont(18, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
-        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
-    hFontSmall = CreateFont(14, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
-        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
-    hFontOverlay = CreateFont(18, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 
-        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
-    hFontBold = CreateFont(20, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
-        OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_SWISS, "Segoe UI");
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
+    StartupProfilerBegin(GetMsBeforeMain());
 
-    LoadSettings();
+    // Set high shutdown priority (0x280 is default for shell, we use same to be treated as system app)
+    SetProcessShutdownParameters(0x280, 0);
+    
+    HRESULT hr = CoInitialize(nullptr);
+    if (FAILED(hr)) return 0;
 
-    if (isRunOnStartup) {
-        ManageStartup(true);
-    } else {
-        if (MessageBox(hMainWnd, "Enable Startup with Windows?", "MicMute-S", MB_YESNO | MB_ICONQUESTION) == IDYES) {
-             ManageStartup(true);
-             isRunOnStartup = true;
-             SaveSettings();
+    HANDLE hMutex = CreateMutex(nullptr, TRUE, "MicMuteS_SingleInstanceMutex");
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        HWND hExisting = FindWindow("MicMuteS_Class", "MicMute-S");
+        if (hExisting) {
+            ShowWindow(hExisting, SW_RESTORE);
+            SetForegroundWindow(hExisting);
         }
+        CloseHandle(hMutex);
+        CoUninitialize();
+        return 0;
     }
 
-    // Register Developer Options
-    RegisterDeveloperOptionsClass(hInstance);
-
-    // Create the unified control panel (replaces separate overlay/meter/recorder)
-    CreateControlPanel(hInstance);
-
-    
-    // Legacy: still support individual windows if user prefers
-    // if (showOverlay) CreateOverlayWindow(hInstance); 
-    // if (showMeter) CreateMeterWindow(hInstance);
-    // if (showRecorder) CreateRecorderWindow(hInstance);
-    
-    if (autoRecordCalls && g_CallRecorder) {
-        g_CallRecorder->Enable();
+    {
+        StartupPhase phase("settings");
+        LoadSettings();
     }
 
-    AddTrayIcon(hMainWnd);
-    UpdateUIState();
-
-    SetTimer(hMainWnd, 1, 50, nullptr);
-    SetTimer(hMainWnd, 2, 2000, nullptr);
+    // Deferred work that needs no window runs alongside the critical phase
+    StartWarmupThread([] {
+        StartupPhase phase("audio warm-up");
+        WarmUpAudio();
+    });
+    StartWarmupThread([] {
+        StartupPhase phase("upload journal recovery");
+        InitBackgroundJobs();
+    });
+
+    {
+        StartupPhase phase("gdi resources");
+        InitCommonControls();
+        CreateGdiResources(hInstance);
+    }
+    {
+        StartupPhase phase("main window");
+        RegisterWindowClasses(hInstance);
+        if (!CreateMainWindow(hInstance)) {
+            WaitForWarmupThreads();
+            return 0;
+        }
+    }
+    {
+        StartupPhase phase("tray icon");
+        AutoUpdater::Init(hMainWnd);
+        AddTrayIcon(hMainWnd);
+        InitFrameScheduler();
+
+        ShowWindow(hMainWnd, nCmdShow);
+        UpdateWindow(hMainWnd);
+    }
+    StartupMarkInteractive();
 
-    ShowWindow(hMainWnd, nCmdShow);
-    UpdateWindow(hMainWnd);
+    // Audio, call recorder and control panel once the loop is running
+    startupPending++;
+    PostMessage(hMainWnd, WM_APP_STARTUP_DEFERRED, 0, 0);
 
     MSG msg;
     while (GetMessage(&msg, nullptr, 0, 0)) {
@@ -371,10 +467,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     DeleteObject(hFontOverlay);
     DeleteObject(hFontBold);
     
+    WaitForWarmupThreads();
     UninitializeAudio();
     CleanupHttpServer();
-    CleanupCallRecorder();
+    CleanupCallRecorder();      // Drains the handoff into the upload queue...
+    CleanupBackgroundJobs();    // ...so that stops after it
     CleanupRecorder();
+    GetCaptureHub().Shutdown();
     CloseHandle(hMutex);
     
     return (int)msg.wParam;
@@ -488,6 +587,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             
             ResizeControlPanel();
             UpdateLayout(hWnd);
+            if (wParam == SIZE_MINIMIZED || wParam == SIZE_RESTORED) RefreshFrameScheduler();
 
             HWND hFooter = GetDlgItem(hWnd, 9999);
             if (hFooter) {
@@ -656,9 +756,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                 char dateBuf[32];
                 strftime(dateBuf, sizeof(dateBuf), "%d %b %Y", &tm);
 
-                int count = g_CallRecorder->GetTodayCallCount();
-                char statsBuf[128];
-                sprintf_s(statsBuf, "Today (%s): %d call%s recorded", dateBuf, count, count == 1 ? "" : "s");
+                DayCallStats stats = g_CallRecorder->GetTodayStats();
+                char statsBuf[160];
+                sprintf_s(statsBuf, "Today (%s): %d call%s recorded, avg %d:%02d", dateBuf,
+                          stats.calls, stats.calls == 1 ? "" : "s",
+                          (int)stats.GetAverageSeconds() / 60, (int)stats.GetAverageSeconds() % 60);
                 
                 RECT rcStats = {contentX, statsY, rcClient.right - 40, statsY + 30};
                 DrawText(hdc, statsBuf, -1, &rcStats, DT_SINGLELINE | DT_LEFT | DT_VCENTER);
@@ -914,6 +1016,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                 }
                 SaveSettings();
                 UpdateLayout(hWnd); // To show/hide the "Go to" button
+                RefreshFrameScheduler(); // Extension status polling
             }
             else if (wmId == ID_OPEN_DEV_OPTIONS) {
                 CreateDeveloperOptionsWindow(GetModuleHandle(nullptr), hWnd);
@@ -1006,38 +1109,18 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 
 
         case WM_TIMER:
-            if (wParam == 1) {
-                UpdateMeter();
-                // Update control panel meter too
-                UpdateControlPanel();
-                
-                if (g_CallRecorder && g_CallRecorder->IsEnabled()) {
-                    g_CallRecorder->Poll();
-                    if (hRecorderWnd && showRecorder) {
-                        InvalidateRect(hRecorderWnd, nullptr, FALSE);
-                    }
-                }
-                
-                if (isDevModeEnabled && autoRecordCalls) {
-                    HWND hStatus = GetDlgItem(hMainWnd, 9998);
-                    if (hStatus) {
-                        ShowWindow(hStatus, SW_SHOW);
-                        if (IsExtensionConnected()) {
-                            SetWindowText(hStatus, "✓ Extension Connected");
-                        } else {
-                            SetWindowText(hStatus, "Waiting for Extension...");
-                        }
-                    }
-                } else {
-                    HWND hStatus = GetDlgItem(hMainWnd, 9998);
-                    if (hStatus) ShowWindow(hStatus, SW_HIDE);
-                }
-            } else if (wParam == 2) {
-                if (skipTimerCycles > 0) { skipTimerCycles--; break; }
-                UpdateUIState();
+            if (wParam == FRAME_TIMER_ID) OnFrameTimer();
+            else if (wParam == UPDATE_CHECK_TIMER_ID) {
+                KillTimer(hWnd, UPDATE_CHECK_TIMER_ID);
+                AutoUpdater::CheckForUpdateAsync(true);     // Silent
             }
             break;
 
+        case WM_SHOWWINDOW:
+            // Visibility changes after this message: re-evaluate once it has
+            RequestFrameSchedulerRefresh();
+            return DefWindowProc(hWnd, msg, wParam, lParam);
+
         case WM_NCHITTEST: {
             LRESULT hit = DefWindowProc(hWnd, msg, wParam, lParam);
 
@@ -1108,6 +1191,14 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             UpdateControlPanel();
             return 0;
 
+        case WM_APP_FRAME_REFRESH:
+            RefreshFrameScheduler();
+            return 0;
+
+        case WM_APP_STARTUP_DEFERRED:
+            RunDeferredStartup(hWnd);
+            return 0;
+
         default:
             return DefWindowProc(hWnd, msg, wParam, lParam);
     }
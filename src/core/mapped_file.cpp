@@ -0,0 +1,130 @@
+#include "core/mapped_file.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// PrefetchVirtualMemory is Windows 8+; looked up at runtime so the app
+// still starts on Windows 7 (where prefetch is just skipped)
+struct PrefetchRange { PVOID address; SIZE_T bytes; };
+typedef BOOL (WINAPI *PrefetchVirtualMemoryFn)(HANDLE, ULONG_PTR, PrefetchRange*, ULONG);
+
+static PrefetchVirtualMemoryFn GetPrefetchFn() {
+    static PrefetchVirtualMemoryFn fn = (PrefetchVirtualMemoryFn)GetProcAddress(
+        GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory");
+    return fn;
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || (uint64_t)size.QuadPart > (uint64_t)SIZE_MAX) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = (uint64_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mappingHandle) CloseHandle(m_mappingHandle);
+    if (m_fileHandle) CloseHandle(m_fileHandle);
+    m_data = nullptr;
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+    m_size = 0;
+}
+
+void MappedFile::SetAccessPattern(Access) {
+    // Windows has no per-view advice; Prefetch covers sequential scans
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t length) const {
+    if (!m_data || offset >= m_size) return;
+    PrefetchVirtualMemoryFn fn = GetPrefetchFn();
+    if (!fn) return;
+    if (length > m_size - offset) length = m_size - offset;
+    PrefetchRange range = { (PVOID)(m_data + offset), (SIZE_T)length };
+    fn(GetCurrentProcess(), 1, &range, 0);
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps its own reference
+    if (view == MAP_FAILED) return false;
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = (uint64_t)st.st_size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), (size_t)m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void MappedFile::SetAccessPattern(Access access) {
+    if (!m_data) return;
+    int advice = access == Access::Sequential ? MADV_SEQUENTIAL
+               : access == Access::Random     ? MADV_RANDOM
+               : MADV_NORMAL;
+    madvise(const_cast<uint8_t*>(m_data), (size_t)m_size, advice);
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t length) const {
+    if (!m_data || offset >= m_size) return;
+    if (length > m_size - offset) length = m_size - offset;
+    // madvise wants a page-aligned start
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t start = offset & ~(page - 1);
+    madvise(const_cast<uint8_t*>(m_data + start), (size_t)(length + (offset - start)), MADV_WILLNEED);
+}
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file (Win32 file mapping or POSIX
+// mmap). Pages are faulted in on first touch and shared with the OS file
+// cache, so reopening or seeking around a recording costs no copies.
+class MappedFile {
+public:
+    enum class Access { Normal, Sequential, Random };
+
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t* GetData() const { return m_data; }
+    uint64_t GetSize() const { return m_size; }
+
+    // Hint for the whole mapping: Sequential enables aggressive read-ahead,
+    // Random disables it (scrubbing). No-op where unsupported.
+    void SetAccessPattern(Access access);
+
+    // Ask the OS to start reading [offset, offset + length) in the background
+    void Prefetch(uint64_t offset, uint64_t length) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
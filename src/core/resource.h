@@ -40,5 +40,7 @@
 
 #define WM_TRAYICON (WM_USER + 1)
 #define WM_APP_MUTE_CHANGED (WM_APP + 100)
+#define WM_APP_FRAME_REFRESH (WM_APP + 101)
+#define WM_APP_STARTUP_DEFERRED (WM_APP + 102)
 
 #endif
@@ -0,0 +1,157 @@
+// MicMute-S headless service: the call recording pipeline (shared capture,
+// call recorder, background finalize, retention, archive, uploads) with no
+// windows, set up from a config file and driven only through the local
+// HTTP API. For load and soak tests of the real start/stop/finalize path
+// and for shared VDI hosts where nobody sits at the desktop.
+//
+// Build: see build.bat (MicMute-S-service.exe, console subsystem)
+//
+// Usage: MicMute-S-service.exe <config file>
+//
+// The config file holds "Name = value" lines with the registry value names
+// (RecordingFolder, AutoRecordCalls, EncryptRecordings, Upload*, ...) plus
+//   CaptureBackend = wasapi | synthetic | file
+//   CaptureMicFile = <wav>, CaptureLoopbackFile = <wav>   (file backend)
+// RecordingFolder is required; auto recording is on and the call beep off
+// unless the file says otherwise. The upload secret is not read from the
+// file: set MICMUTE_UPLOAD_SECRET_KEY in the service's environment, or save
+// it once in the desktop app under the same Windows account (DPAPI).
+//
+// Control: POST /start, /stop, /ping (heartbeat - a call is saved 5 s after
+// the last one, as when the browser tab closes), /status, /metrics, ...,
+// and /shutdown. Ctrl+C or closing the console also stops the service;
+// a call in progress is saved before exit.
+
+#include "network/http_server.h"
+#include <windows.h>
+#include <objbase.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "core/globals.h"
+#include "core/settings.h"
+#include "core/background_jobs.h"
+#include "audio/call_recorder.h"
+#include "audio/CaptureHub.h"
+#include "audio/recorder.h"
+#include "ui/control_panel.h"
+#include "ui/ui.h"
+
+// The UI timer's interval in the desktop app
+static const DWORD POLL_INTERVAL_MS = 100;
+// Console close/logoff: how long Windows is kept waiting for the cleanup
+static const DWORD CLOSE_WAIT_MS = 5000;
+
+// The few UI hooks the recording pipeline calls. The desktop build gets
+// them from recorder.cpp, control_panel.cpp and ui.cpp; here there is no
+// window to post to, no folder picker and no frame timer to wake.
+HWND hRecorderWnd = nullptr;
+
+bool EnsureRecordingFolderSelected(HWND) {
+    return !recordingFolder.empty();
+}
+
+void NotifyAutoRecordSaved(const std::string& filename) {
+    printf("Saved %s\n", filename.c_str());
+}
+
+void SaveControlPanelPosition() {}
+void RequestFrameSchedulerRefresh() {}
+
+static HANDLE shutdownEvent = nullptr;
+static HANDLE stoppedEvent = nullptr;
+
+static void RequestShutdown() {
+    SetEvent(shutdownEvent);
+}
+
+static BOOL WINAPI OnConsoleCtrl(DWORD type) {
+    RequestShutdown();
+    // The process is ended as soon as this returns for anything but
+    // Ctrl+C/Break, so hold it until the recordings are closed out
+    if (type != CTRL_C_EVENT && type != CTRL_BREAK_EVENT) {
+        WaitForSingleObject(stoppedEvent, CLOSE_WAIT_MS);
+    }
+    return TRUE;
+}
+
+static bool EnsureFolder(const std::string& path) {
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes != INVALID_FILE_ATTRIBUTES) return (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    return CreateDirectoryA(path.c_str(), nullptr) != 0;
+}
+
+static void PrintUsage() {
+    printf("Usage: MicMute-S-service.exe <config file>\n\n");
+    printf("Runs the call recorder without windows, controlled through\n");
+    printf("http://127.0.0.1:9876 (POST /start, /stop, /ping, /status, /metrics, /shutdown).\n\n");
+    printf("Config file: Name = value per line, # comments. Registry value names,\n");
+    printf("e.g. RecordingFolder (required), AutoRecordCalls, EncryptRecordings,\n");
+    printf("AutoDeleteDays, Upload*, MicDsp*, plus CaptureBackend (wasapi,\n");
+    printf("synthetic, file), CaptureMicFile and CaptureLoopbackFile.\n");
+    printf("The upload secret key comes from MICMUTE_UPLOAD_SECRET_KEY or the\n");
+    printf("desktop app's protected settings, never from the file.\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2 || strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0) {
+        PrintUsage();
+        return 2;
+    }
+
+    HRESULT hr = CoInitialize(nullptr);
+    if (FAILED(hr)) return 1;
+
+    // Defaults for a host nobody listens on; the file may override them
+    headlessMode = true;
+    autoRecordCalls = true;
+    beepOnCall = false;
+
+    std::string error;
+    if (!LoadSettingsFile(argv[1], error)) {
+        fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        CoUninitialize();
+        return 1;
+    }
+    if (recordingFolder.empty() || !EnsureFolder(recordingFolder)) {
+        fprintf(stderr, "RecordingFolder is missing or cannot be created: '%s'\n", recordingFolder.c_str());
+        CoUninitialize();
+        return 1;
+    }
+    GetCaptureHub().SetSource(GetConfiguredCaptureSource());
+
+    shutdownEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    stoppedEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+    SetHttpShutdownHandler(RequestShutdown);
+
+    InitBackgroundJobs();
+    InitCallRecorder();
+    InitHttpServer();
+
+    int exitCode = 0;
+    if (!IsHttpServerRunning()) {
+        fprintf(stderr, "Cannot listen on 127.0.0.1:9876 (is MicMute-S already running?)\n");
+        exitCode = 1;
+    } else {
+        printf("MicMute-S service: 127.0.0.1:9876, %s capture, recording to %s\n",
+               GetCaptureBackendName(GetConfiguredCaptureSource().backend), recordingFolder.c_str());
+
+        // What the desktop app's UI timer drives: date rollover and saving
+        // the call when the extension's heartbeat stops
+        while (WaitForSingleObject(shutdownEvent, POLL_INTERVAL_MS) == WAIT_TIMEOUT) {
+            if (g_CallRecorder) g_CallRecorder->Poll();
+        }
+        printf("Shutting down, saving recordings...\n");
+    }
+
+    CleanupHttpServer();
+    CleanupCallRecorder();      // Saves a call in progress and drains the handoff...
+    CleanupBackgroundJobs();    // ...before the upload queue it hands off to stops
+    GetCaptureHub().Shutdown();
+
+    SetHttpShutdownHandler(nullptr);
+    SetEvent(stoppedEvent);
+    CoUninitialize();
+    return exitCode;
+}
@@ -1,7 +1,14 @@
 #include "core/settings.h"
 #include "core/globals.h"
 #include "ui/control_panel.h"
+#include <wincrypt.h>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#pragma comment(lib, "crypt32.lib")
 
 void SaveOverlayPosition() {
     if (!hOverlayWnd) return;
@@ -21,6 +28,42 @@ static std::string GetCurrentExePath() {
     return std::string(buffer);
 }
 
+// Secrets are stored encrypted for the current Windows user (DPAPI)
+static void SaveProtectedString(HKEY hKey, const char* name, const std::string& value) {
+    if (value.empty()) {
+        RegDeleteValue(hKey, name);
+        return;
+    }
+    DATA_BLOB in = { (DWORD)value.size(), (BYTE*)value.data() };
+    DATA_BLOB out = {};
+    if (CryptProtectData(&in, L"MicMute-S", nullptr, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &out)) {
+        RegSetValueEx(hKey, name, 0, REG_BINARY, out.pbData, out.cbData);
+        LocalFree(out.pbData);
+    }
+}
+
+static bool LoadProtectedString(HKEY hKey, const char* name, std::string& value) {
+    DWORD size = 0;
+    if (RegQueryValueEx(hKey, name, nullptr, nullptr, nullptr, &size) != ERROR_SUCCESS || size == 0) return false;
+    std::vector<BYTE> data(size);
+    if (RegQueryValueEx(hKey, name, nullptr, nullptr, data.data(), &size) != ERROR_SUCCESS) return false;
+
+    DATA_BLOB in = { size, data.data() };
+    DATA_BLOB out = {};
+    if (!CryptUnprotectData(&in, nullptr, nullptr, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &out)) return false;
+    value.assign((const char*)out.pbData, out.cbData);
+    LocalFree(out.pbData);
+    return true;
+}
+
+static void LoadRecordingKeys(HKEY hKey) {
+    std::string keys;
+    if (LoadProtectedString(hKey, "RecordingKeys", keys) && !GetRecordingKeyring().Parse(keys)) {
+        OutputDebugStringA("[Settings] Recording keyring is damaged\n");
+    }
+    SecureZeroMemory(&keys[0], keys.size());
+}
+
 void LoadOverlayPosition(int* x, int* y) {
     *x = 50; *y = 50;
     HKEY hKey;
@@ -94,6 +137,55 @@ void SaveSettings() {
         val = (DWORD)autoDeleteDays;
         RegSetValueEx(hKey, "AutoDeleteDays", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
         
+        val = (DWORD)retentionMaxTotalGB;
+        RegSetValueEx(hKey, "RetentionMaxTotalGB", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = (DWORD)retentionMinFreeGB;
+        RegSetValueEx(hKey, "RetentionMinFreeGB", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = (DWORD)retentionDeletesPerSec;
+        RegSetValueEx(hKey, "RetentionDeletesPerSec", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        
+        val = (DWORD)archiveAfterDays;
+        RegSetValueEx(hKey, "ArchiveAfterDays", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        
+        val = writeMetadataSidecar ? 1 : 0;
+        RegSetValueEx(hKey, "WriteMetadataSidecar", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        
+        // Upload
+        val = uploadEnabled ? 1 : 0;
+        RegSetValueEx(hKey, "UploadEnabled", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = (DWORD)uploadMaxKBps;
+        RegSetValueEx(hKey, "UploadMaxKBps", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = (DWORD)uploadRecordingKBps;
+        RegSetValueEx(hKey, "UploadRecordingKBps", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = (DWORD)uploadParallelParts;
+        RegSetValueEx(hKey, "UploadParallelParts", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        RegSetValueEx(hKey, "UploadEndpoint", 0, REG_SZ, (const BYTE*)uploadEndpoint.c_str(), (DWORD)(uploadEndpoint.length() + 1));
+        RegSetValueEx(hKey, "UploadRegion", 0, REG_SZ, (const BYTE*)uploadRegion.c_str(), (DWORD)(uploadRegion.length() + 1));
+        RegSetValueEx(hKey, "UploadBucket", 0, REG_SZ, (const BYTE*)uploadBucket.c_str(), (DWORD)(uploadBucket.length() + 1));
+        RegSetValueEx(hKey, "UploadAccessKey", 0, REG_SZ, (const BYTE*)uploadAccessKey.c_str(), (DWORD)(uploadAccessKey.length() + 1));
+        SaveProtectedString(hKey, "UploadSecretKey", uploadSecretKey);
+        
+        // Update peer cache
+        val = updatePeerCacheEnabled ? 1 : 0;
+        RegSetValueEx(hKey, "UpdatePeerCache", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        RegSetValueEx(hKey, "UpdatePeerUrl", 0, REG_SZ, (const BYTE*)updatePeerUrl.c_str(), (DWORD)(updatePeerUrl.length() + 1));
+        
+        // Mic DSP chain
+        val = micDspHighPass ? 1 : 0;
+        RegSetValueEx(hKey, "MicDspHighPass", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = micDspNoiseGate ? 1 : 0;
+        RegSetValueEx(hKey, "MicDspNoiseGate", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = micDspAgc ? 1 : 0;
+        RegSetValueEx(hKey, "MicDspAgc", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = micDspLimiter ? 1 : 0;
+        RegSetValueEx(hKey, "MicDspLimiter", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        val = micDspNoiseSuppression ? 1 : 0;
+        RegSetValueEx(hKey, "MicDspNoiseSuppression", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        
+        // Encryption at rest (the keyring itself is saved by SaveRecordingKeys)
+        val = encryptRecordings ? 1 : 0;
+        RegSetValueEx(hKey, "EncryptRecordings", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
+        
         // Control panel visibility toggles
         val = showMuteBtn ? 1 : 0;
         RegSetValueEx(hKey, "ShowMuteBtn", 0, REG_DWORD, (BYTE*)&val, sizeof(DWORD));
@@ -203,6 +295,76 @@ void LoadSettings() {
         */
         if (RegQueryValueEx(hKey, "AutoDeleteDays", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
             autoDeleteDays = (int)val;
+        if (RegQueryValueEx(hKey, "RetentionMaxTotalGB", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            retentionMaxTotalGB = (int)val;
+        if (RegQueryValueEx(hKey, "RetentionMinFreeGB", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            retentionMinFreeGB = (int)val;
+        if (RegQueryValueEx(hKey, "RetentionDeletesPerSec", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            retentionDeletesPerSec = (int)val;
+        if (RegQueryValueEx(hKey, "ArchiveAfterDays", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            archiveAfterDays = (int)val;
+        if (RegQueryValueEx(hKey, "WriteMetadataSidecar", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            writeMetadataSidecar = val != 0;
+        
+        // Upload
+        if (RegQueryValueEx(hKey, "UploadEnabled", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            uploadEnabled = val != 0;
+        if (RegQueryValueEx(hKey, "UploadMaxKBps", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            uploadMaxKBps = (int)val;
+        if (RegQueryValueEx(hKey, "UploadRecordingKBps", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            uploadRecordingKBps = (int)val;
+        if (RegQueryValueEx(hKey, "UploadParallelParts", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            uploadParallelParts = (int)val;
+        {
+            char textBuf[512];
+            DWORD textSize = sizeof(textBuf);
+            if (RegQueryValueEx(hKey, "UploadEndpoint", nullptr, nullptr, (BYTE*)textBuf, &textSize) == ERROR_SUCCESS)
+                uploadEndpoint = textBuf;
+            textSize = sizeof(textBuf);
+            if (RegQueryValueEx(hKey, "UploadRegion", nullptr, nullptr, (BYTE*)textBuf, &textSize) == ERROR_SUCCESS)
+                uploadRegion = textBuf;
+            textSize = sizeof(textBuf);
+            if (RegQueryValueEx(hKey, "UploadBucket", nullptr, nullptr, (BYTE*)textBuf, &textSize) == ERROR_SUCCESS)
+                uploadBucket = textBuf;
+            textSize = sizeof(textBuf);
+            if (RegQueryValueEx(hKey, "UploadAccessKey", nullptr, nullptr, (BYTE*)textBuf, &textSize) == ERROR_SUCCESS)
+                uploadAccessKey = textBuf;
+            LoadProtectedString(hKey, "UploadSecretKey", uploadSecretKey);
+        }
+        
+        // Update peer cache
+        size = sizeof(DWORD);
+        if (RegQueryValueEx(hKey, "UpdatePeerCache", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            updatePeerCacheEnabled = val != 0;
+        {
+            char textBuf[512];
+            DWORD textSize = sizeof(textBuf);
+            if (RegQueryValueEx(hKey, "UpdatePeerUrl", nullptr, nullptr, (BYTE*)textBuf, &textSize) == ERROR_SUCCESS)
+                updatePeerUrl = textBuf;
+        }
+        
+        // Mic DSP chain
+        size = sizeof(DWORD);
+        if (RegQueryValueEx(hKey, "MicDspHighPass", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            micDspHighPass = val != 0;
+        size = sizeof(DWORD);
+        if (RegQueryValueEx(hKey, "MicDspNoiseGate", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            micDspNoiseGate = val != 0;
+        size = sizeof(DWORD);
+        if (RegQueryValueEx(hKey, "MicDspAgc", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            micDspAgc = val != 0;
+        size = sizeof(DWORD);
+        if (RegQueryValueEx(hKey, "MicDspLimiter", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            micDspLimiter = val != 0;
+        size = sizeof(DWORD);
+        if (RegQueryValueEx(hKey, "MicDspNoiseSuppression", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            micDspNoiseSuppression = val != 0;
+        
+        // Encryption at rest
+        size = sizeof(DWORD);
+        if (RegQueryValueEx(hKey, "EncryptRecordings", nullptr, nullptr, (BYTE*)&val, &size) == ERROR_SUCCESS)
+            encryptRecordings = val != 0;
+        LoadRecordingKeys(hKey);
         
         // Control panel visibility toggles (override legacy if present)
         size = sizeof(DWORD);
@@ -241,6 +403,205 @@ void LoadSettings() {
     }
 }
 
+// Settings the service config file may set, by registry value name.
+// Not the upload secret: the file is usually readable by more than the
+// service account, so it comes from the environment or DPAPI instead.
+#define UPLOAD_SECRET_ENV "MICMUTE_UPLOAD_SECRET_KEY"
+
+struct BoolSetting { const char* name; bool* value; };
+struct IntSetting { const char* name; int* value; };
+struct TextSetting { const char* name; std::string* value; };
+
+static const BoolSetting fileBoolSettings[] = {
+    { "AutoRecordCalls", &autoRecordCalls },
+    { "BeepOnCall", &beepOnCall },
+    { "WriteMetadataSidecar", &writeMetadataSidecar },
+    { "UploadEnabled", &uploadEnabled },
+    { "MicDspHighPass", &micDspHighPass },
+    { "MicDspNoiseGate", &micDspNoiseGate },
+    { "MicDspAgc", &micDspAgc },
+    { "MicDspLimiter", &micDspLimiter },
+    { "MicDspNoiseSuppression", &micDspNoiseSuppression },
+    { "EncryptRecordings", &encryptRecordings },
+};
+static const IntSetting fileIntSettings[] = {
+    { "AutoDeleteDays", &autoDeleteDays },
+    { "RetentionMaxTotalGB", &retentionMaxTotalGB },
+    { "RetentionMinFreeGB", &retentionMinFreeGB },
+    { "RetentionDeletesPerSec", &retentionDeletesPerSec },
+    { "ArchiveAfterDays", &archiveAfterDays },
+    { "UploadMaxKBps", &uploadMaxKBps },
+    { "UploadRecordingKBps", &uploadRecordingKBps },
+    { "UploadParallelParts", &uploadParallelParts },
+};
+static const TextSetting fileTextSettings[] = {
+    { "RecordingFolder", &recordingFolder },
+    { "UserName", &userName },
+    { "UploadEndpoint", &uploadEndpoint },
+    { "UploadRegion", &uploadRegion },
+    { "UploadBucket", &uploadBucket },
+    { "UploadAccessKey", &uploadAccessKey },
+    { "CaptureBackend", &captureBackend },
+    { "CaptureMicFile", &captureMicFile },
+    { "CaptureLoopbackFile", &captureLoopbackFile },
+};
+
+static std::string Trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+static bool ParseBool(const std::string& text, bool& out) {
+    for (const char* yes : { "1", "true", "yes", "on" }) {
+        if (_stricmp(text.c_str(), yes) == 0) { out = true; return true; }
+    }
+    for (const char* no : { "0", "false", "no", "off" }) {
+        if (_stricmp(text.c_str(), no) == 0) { out = false; return true; }
+    }
+    return false;
+}
+
+static bool ApplyFileSetting(const std::string& name, const std::string& value, std::string& error) {
+    for (const BoolSetting& setting : fileBoolSettings) {
+        if (_stricmp(name.c_str(), setting.name) != 0) continue;
+        if (ParseBool(value, *setting.value)) return true;
+        error = "expected true/false for " + name;
+        return false;
+    }
+    for (const IntSetting& setting : fileIntSettings) {
+        if (_stricmp(name.c_str(), setting.name) != 0) continue;
+        char* end = nullptr;
+        long parsed = strtol(value.c_str(), &end, 10);
+        if (!value.empty() && *end == '\0' && parsed >= 0 && parsed <= 1000000) {
+            *setting.value = (int)parsed;
+            return true;
+        }
+        error = "expected a non-negative number for " + name;
+        return false;
+    }
+    for (const TextSetting& setting : fileTextSettings) {
+        if (_stricmp(name.c_str(), setting.name) != 0) continue;
+        *setting.value = value;
+        return true;
+    }
+    if (_stricmp(name.c_str(), "UploadSecretKey") == 0) {
+        error = "UploadSecretKey cannot be set in the file; use " UPLOAD_SECRET_ENV " or the app's protected store";
+        return false;
+    }
+    error = "unknown setting " + name;
+    return false;
+}
+
+bool LoadSettingsFile(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = Trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+        size_t equals = line.find('=');
+        std::string name = Trim(line.substr(0, equals));
+        std::string value = equals == std::string::npos ? "" : Trim(line.substr(equals + 1));
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        if (equals == std::string::npos || name.empty()) {
+            error = "expected Name = value";
+        } else if (ApplyFileSetting(name, value, error)) {
+            continue;
+        }
+        error = "line " + std::to_string(lineNumber) + ": " + error;
+        return false;
+    }
+
+    CaptureBackend backend;
+    if (!ParseCaptureBackend(captureBackend, backend)) {
+        error = "CaptureBackend must be wasapi, synthetic or file";
+        return false;
+    }
+
+    // Master keys and the upload secret never live in the file: same
+    // DPAPI-protected values as the desktop app for this Windows user,
+    // with the secret overridable from the service's environment
+    HKEY hKey;
+    if (RegOpenKeyEx(HKEY_CURRENT_USER, "Software\\MicMute-S", 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+        LoadRecordingKeys(hKey);
+        LoadProtectedString(hKey, "UploadSecretKey", uploadSecretKey);
+        RegCloseKey(hKey);
+    }
+    const char* secret = getenv(UPLOAD_SECRET_ENV);
+    if (secret && *secret) uploadSecretKey = secret;
+    return true;
+}
+
+RetentionPolicy GetConfiguredRetentionPolicy() {
+    RetentionPolicy policy;
+    policy.maxAgeDays = autoDeleteDays;
+    policy.maxTotalBytes = (uint64_t)retentionMaxTotalGB * 1024 * 1024 * 1024;
+    policy.minFreeBytes = (uint64_t)retentionMinFreeGB * 1024 * 1024 * 1024;
+    policy.maxDeletesPerSecond = retentionDeletesPerSec;
+    return policy;
+}
+
+UploadSettings GetConfiguredUploadSettings() {
+    UploadSettings settings;
+    settings.s3.endpoint = uploadEndpoint;
+    settings.s3.region = uploadRegion.empty() ? "us-east-1" : uploadRegion;
+    settings.s3.bucket = uploadBucket;
+    settings.s3.accessKey = uploadAccessKey;
+    settings.s3.secretKey = uploadSecretKey;
+    settings.keyPrefix = userName;
+    settings.parallelParts = uploadParallelParts;
+    settings.maxBytesPerSec = (uint64_t)uploadMaxKBps * 1024;
+    settings.captureBytesPerSec = (uint64_t)uploadRecordingKBps * 1024;
+    return settings;
+}
+
+DspSettings GetConfiguredDspSettings() {
+    DspSettings settings;
+    settings.highPass = micDspHighPass;
+    settings.noiseGate = micDspNoiseGate;
+    settings.agc = micDspAgc;
+    settings.limiter = micDspLimiter;
+    settings.noiseSuppression = micDspNoiseSuppression;
+    return settings;
+}
+
+void SaveRecordingKeys() {
+    HKEY hKey;
+    if (RegCreateKeyEx(HKEY_CURRENT_USER, "Software\\MicMute-S", 0, nullptr, REG_OPTION_NON_VOLATILE, KEY_WRITE, nullptr, &hKey, nullptr) == ERROR_SUCCESS) {
+        std::string keys = GetRecordingKeyring().Serialize();
+        SaveProtectedString(hKey, "RecordingKeys", keys);
+        SecureZeroMemory(&keys[0], keys.size());
+        RegCloseKey(hKey);
+    }
+}
+
+CaptureSource GetConfiguredCaptureSource() {
+    CaptureSource source;
+    ParseCaptureBackend(captureBackend, source.backend);    // Left on devices if unknown
+    source.files[(int)CaptureEndpoint::Microphone] = captureMicFile;
+    source.files[(int)CaptureEndpoint::Loopback] = captureLoopbackFile;
+    return source;
+}
+
+bool GetConfiguredRecordingKey(RecordingKey& out) {
+    RecordingKeyring& keyring = GetRecordingKeyring();
+    if (keyring.GetCurrent(out)) return true;
+    if (!keyring.Rotate(&out)) return false;
+    SaveRecordingKeys();
+    return true;
+}
+
 void ManageStartup(bool enable) {
     HKEY hKey;
     const char* path = "Software\\Microsoft\\Windows\\CurrentVersion\\Run";
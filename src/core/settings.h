@@ -3,6 +3,12 @@
 #define WIN32_LEAN_AND_MEAN
 #endif
 #include <windows.h>
+#include "storage/retention.h"
+#include "network/upload_queue.h"
+#include "audio/DspChain.h"
+#include "storage/encrypted_recording.h"
+#include "audio/CaptureHub.h"
+#include <string>
 
 void SaveOverlayPosition();
 void LoadOverlayPosition(int* x, int* y);
@@ -10,5 +16,32 @@ void SaveMeterPosition();
 void LoadMeterPosition(int* x, int* y, int* w, int* h);
 void SaveSettings();
 void LoadSettings();
+
+// Headless service: settings from a "Name = value" file (registry value
+// names, # comments) instead of the registry. The recording keyring and
+// UploadSecretKey are not accepted in the file: both come from the
+// DPAPI-protected registry values, the secret may instead be set in the
+// MICMUTE_UPLOAD_SECRET_KEY environment variable. False with error set
+// on a bad line.
+bool LoadSettingsFile(const std::string& path, std::string& error);
 void ManageStartup(bool enable);
 bool IsStartupEnabled();
+
+// Retention policy from the current settings (auto delete days + quotas)
+RetentionPolicy GetConfiguredRetentionPolicy();
+
+// Upload queue settings from the current settings (endpoint, keys, limits)
+UploadSettings GetConfiguredUploadSettings();
+
+// Mic DSP chain stages from the current settings
+DspSettings GetConfiguredDspSettings();
+
+// Capture source of the headless service (devices unless configured)
+CaptureSource GetConfiguredCaptureSource();
+
+// Key new recordings are encrypted with (the keyring's newest; one is
+// generated and saved on first use). False if no key could be created.
+bool GetConfiguredRecordingKey(RecordingKey& out);
+
+// Persist the recording keyring (after a rotation); only this value is written
+void SaveRecordingKeys();
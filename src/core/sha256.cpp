@@ -0,0 +1,177 @@
+#include "core/sha256.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t Rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+Sha256::Sha256() : m_length(0), m_bufferLen(0) {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(m_state, init, sizeof(m_state));
+}
+
+void Sha256::Transform(const uint8_t block[64]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+               (uint32_t)block[i * 4 + 2] << 8 | (uint32_t)block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+    uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t S1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + S1 + ch + K[i] + w[i];
+        uint32_t S0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = S0 + maj;
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
+    m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
+}
+
+void Sha256::Update(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    m_length += len;
+
+    if (m_bufferLen > 0) {
+        size_t take = 64 - m_bufferLen < len ? 64 - m_bufferLen : len;
+        memcpy(m_buffer + m_bufferLen, p, take);
+        m_bufferLen += take;
+        p += take;
+        len -= take;
+        if (m_bufferLen < 64) return;
+        Transform(m_buffer);
+        m_bufferLen = 0;
+    }
+    while (len >= 64) {
+        Transform(p);
+        p += 64;
+        len -= 64;
+    }
+    if (len > 0) {
+        memcpy(m_buffer, p, len);
+        m_bufferLen = len;
+    }
+}
+
+void Sha256::Final(uint8_t out[DIGEST_SIZE]) {
+    uint64_t bits = m_length * 8;
+    uint8_t pad = 0x80;
+    Update(&pad, 1);
+    uint8_t zero = 0;
+    while (m_bufferLen != 56) Update(&zero, 1);
+    uint8_t lenBytes[8];
+    for (int i = 0; i < 8; i++) lenBytes[i] = (uint8_t)(bits >> (56 - i * 8));
+    Update(lenBytes, 8);
+
+    for (int i = 0; i < 8; i++) {
+        out[i * 4]     = (uint8_t)(m_state[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(m_state[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(m_state[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)(m_state[i]);
+    }
+}
+
+std::string Sha256::HashHex(const void* data, size_t len) {
+    Sha256 h;
+    h.Update(data, len);
+    uint8_t digest[DIGEST_SIZE];
+    h.Final(digest);
+    return ToHex(digest, DIGEST_SIZE);
+}
+
+std::string Sha256::HashFileHex(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return "";
+    Sha256 h;
+    std::vector<char> buf(64 * 1024);
+    while (file) {
+        file.read(buf.data(), buf.size());
+        if (file.gcount() > 0) h.Update(buf.data(), (size_t)file.gcount());
+    }
+    uint8_t digest[DIGEST_SIZE];
+    h.Final(digest);
+    return ToHex(digest, DIGEST_SIZE);
+}
+
+std::string HmacSha256(const std::string& key, const std::string& message) {
+    uint8_t k[64] = {};
+    if (key.size() > 64) {
+        Sha256 kh;
+        kh.Update(key.data(), key.size());
+        kh.Final(k);
+    } else {
+        memcpy(k, key.data(), key.size());
+    }
+
+    uint8_t ipad[64], opad[64];
+    for (int i = 0; i < 64; i++) {
+        ipad[i] = k[i] ^ 0x36;
+        opad[i] = k[i] ^ 0x5c;
+    }
+
+    uint8_t inner[Sha256::DIGEST_SIZE];
+    Sha256 ih;
+    ih.Update(ipad, 64);
+    ih.Update(message.data(), message.size());
+    ih.Final(inner);
+
+    uint8_t outer[Sha256::DIGEST_SIZE];
+    Sha256 oh;
+    oh.Update(opad, 64);
+    oh.Update(inner, sizeof(inner));
+    oh.Final(outer);
+    return std::string(reinterpret_cast<char*>(outer), sizeof(outer));
+}
+
+std::string ToHex(const uint8_t* data, size_t len) {
+    static const char* digits = "0123456789abcdef";
+    std::string out(len * 2, '0');
+    for (size_t i = 0; i < len; i++) {
+        out[i * 2] = digits[data[i] >> 4];
+        out[i * 2 + 1] = digits[data[i] & 0x0F];
+    }
+    return out;
+}
+
+std::string ToHex(const std::string& binary) {
+    return ToHex(reinterpret_cast<const uint8_t*>(binary.data()), binary.size());
+}
+
+std::string Base64Encode(const uint8_t* data, size_t len) {
+    static const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t n = (uint32_t)data[i] << 16;
+        if (i + 1 < len) n |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) n |= data[i + 2];
+        out += table[(n >> 18) & 63];
+        out += table[(n >> 12) & 63];
+        out += i + 1 < len ? table[(n >> 6) & 63] : '=';
+        out += i + 2 < len ? table[n & 63] : '=';
+    }
+    return out;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// SHA-256 / HMAC-SHA256 (FIPS 180-4, RFC 2104).
+// Used for upload checksums and request signing; no external crypto deps.
+class Sha256 {
+public:
+    static constexpr size_t DIGEST_SIZE = 32;
+
+    Sha256();
+    void Update(const void* data, size_t len);
+    void Final(uint8_t out[DIGEST_SIZE]);
+
+    // One-shot helpers
+    static std::string HashHex(const void* data, size_t len);
+    static std::string HashHex(const std::string& data) { return HashHex(data.data(), data.size()); }
+
+    // Hex digest of a whole file, empty string if it can't be read
+    static std::string HashFileHex(const std::string& path);
+
+private:
+    void Transform(const uint8_t block[64]);
+
+    uint32_t m_state[8];
+    uint64_t m_length;      // Bytes hashed so far
+    uint8_t  m_buffer[64];
+    size_t   m_bufferLen;
+};
+
+// Raw 32 byte HMAC as a std::string (binary)
+std::string HmacSha256(const std::string& key, const std::string& message);
+
+std::string ToHex(const uint8_t* data, size_t len);
+std::string ToHex(const std::string& binary);
+std::string Base64Encode(const uint8_t* data, size_t len);
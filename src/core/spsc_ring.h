@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+// Lock-free single-producer / single-consumer ring buffer.
+//
+// Read and write positions are monotonically increasing 64-bit counters
+// (masked into a power-of-two buffer), so they double as stream positions:
+// the playback engine maps "samples consumed" back to file frames with them.
+// Only trivially copyable T.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t minCapacity = 0) { Reset(minCapacity); }
+
+    // Not thread safe - only while neither side is running
+    void Reset(size_t minCapacity) {
+        size_t cap = 1;
+        while (cap < minCapacity) cap <<= 1;
+        m_buffer.assign(cap, T());
+        m_mask = cap - 1;
+        m_write.store(0, std::memory_order_relaxed);
+        m_read.store(0, std::memory_order_relaxed);
+    }
+
+    size_t GetCapacity() const { return m_buffer.size(); }
+
+    // ── Producer side ──
+    size_t GetWriteAvailable() const {
+        return m_buffer.size() - (size_t)(m_write.load(std::memory_order_relaxed) - m_read.load(std::memory_order_acquire));
+    }
+
+    size_t Write(const T* data, size_t count) {
+        uint64_t w = m_write.load(std::memory_order_relaxed);
+        count = std::min(count, GetWriteAvailable());
+        size_t first = std::min(count, m_buffer.size() - (size_t)(w & m_mask));
+        memcpy(&m_buffer[(size_t)(w & m_mask)], data, first * sizeof(T));
+        memcpy(&m_buffer[0], data + first, (count - first) * sizeof(T));
+        m_write.store(w + count, std::memory_order_release);
+        return count;
+    }
+
+    uint64_t GetWriteIndex() const { return m_write.load(std::memory_order_acquire); }
+
+    // ── Consumer side ──
+    size_t GetReadAvailable() const {
+        return (size_t)(m_write.load(std::memory_order_acquire) - m_read.load(std::memory_order_relaxed));
+    }
+
+    size_t Read(T* out, size_t count) {
+        uint64_t r = m_read.load(std::memory_order_relaxed);
+        count = std::min(count, GetReadAvailable());
+        size_t first = std::min(count, m_buffer.size() - (size_t)(r & m_mask));
+        memcpy(out, &m_buffer[(size_t)(r & m_mask)], first * sizeof(T));
+        memcpy(out + first, &m_buffer[0], (count - first) * sizeof(T));
+        m_read.store(r + count, std::memory_order_release);
+        return count;
+    }
+
+    // Drop everything before index (clamped to what has been written)
+    void SkipTo(uint64_t index) {
+        uint64_t w = m_write.load(std::memory_order_acquire);
+        uint64_t r = m_read.load(std::memory_order_relaxed);
+        index = std::min(index, w);
+        if (index > r) m_read.store(index, std::memory_order_release);
+    }
+
+    uint64_t GetReadIndex() const { return m_read.load(std::memory_order_acquire); }
+
+private:
+    std::vector<T> m_buffer;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<uint64_t> m_write{0};
+    alignas(64) std::atomic<uint64_t> m_read{0};
+};
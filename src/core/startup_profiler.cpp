@@ -0,0 +1,157 @@
+#include "core/startup_profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PhaseRecord {
+    const char* name;
+    int thread;             // 0 = thread that called StartupProfilerBegin
+    double startMs;
+    double durationMs;
+};
+
+const size_t MAX_PHASES = 64;   // On-demand phases stop being recorded past this
+
+std::mutex g_mutex;
+Clock::time_point g_origin;
+bool g_begun = false;
+double g_beforeMainMs = 0.0;
+double g_interactiveMs = -1.0;
+double g_completeMs = -1.0;
+std::vector<PhaseRecord> g_phases;
+std::vector<std::thread::id> g_threads;
+
+double SinceOriginMs(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(t - g_origin).count() + g_beforeMainMs;
+}
+
+double NowMs() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_begun) return 0.0;
+    return SinceOriginMs(Clock::now());
+}
+
+// Small stable index per thread (caller holds g_mutex)
+int ThreadIndex(std::thread::id id) {
+    for (size_t i = 0; i < g_threads.size(); i++) {
+        if (g_threads[i] == id) return (int)i;
+    }
+    g_threads.push_back(id);
+    return (int)g_threads.size() - 1;
+}
+
+// Warm-up threads never hold up the tray, so their phases are deferred
+// even when they overlap the critical phase
+const char* StageOf(const PhaseRecord& p) {
+    if (p.thread == 0 && (g_interactiveMs < 0 || p.startMs < g_interactiveMs)) return "critical";
+    if (g_completeMs < 0 || p.startMs < g_completeMs) return "deferred";
+    return "on demand";
+}
+
+std::string ThreadLabel(int index) {
+    if (index == 0) return "main";
+    return "warm-up " + std::to_string(index);
+}
+
+} // namespace
+
+void StartupProfilerBegin(double msBeforeMain) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_begun) return;
+    g_origin = Clock::now();
+    g_beforeMainMs = msBeforeMain > 0.0 ? msBeforeMain : 0.0;
+    g_begun = true;
+    g_phases.reserve(MAX_PHASES);
+    ThreadIndex(std::this_thread::get_id());
+    if (g_beforeMainMs > 0.0) {
+        g_phases.push_back({"process start to WinMain", 0, 0.0, g_beforeMainMs});
+    }
+}
+
+void StartupMarkInteractive() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_begun && g_interactiveMs < 0) g_interactiveMs = SinceOriginMs(Clock::now());
+}
+
+bool StartupMarkComplete() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_begun || g_completeMs >= 0) return false;
+    g_completeMs = SinceOriginMs(Clock::now());
+    return true;
+}
+
+StartupPhase::StartupPhase(const char* name) : m_name(name), m_startMs(NowMs()) {}
+
+StartupPhase::~StartupPhase() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_begun || g_phases.size() >= MAX_PHASES) return;
+    double endMs = SinceOriginMs(Clock::now());
+    g_phases.push_back({m_name, ThreadIndex(std::this_thread::get_id()), m_startMs, endMs - m_startMs});
+}
+
+std::string StartupTimelineReport() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_begun) return "Startup timeline not recorded.\n";
+
+    // Phases are appended when they end; list them by start time
+    std::vector<PhaseRecord> phases = g_phases;
+    for (size_t i = 1; i < phases.size(); i++) {
+        for (size_t k = i; k > 0 && phases[k].startMs < phases[k - 1].startMs; k--) {
+            std::swap(phases[k], phases[k - 1]);
+        }
+    }
+
+    std::string out = "Startup timeline (ms since process start)\n\n";
+    out += "   start     took  stage      thread     phase\n";
+    char line[160];
+    for (const PhaseRecord& p : phases) {
+        snprintf(line, sizeof(line), "%8.1f %8.1f  %-9s  %-9s  %s\n",
+                 p.startMs, p.durationMs, StageOf(p), ThreadLabel(p.thread).c_str(), p.name);
+        out += line;
+    }
+    out += "\n";
+    if (g_interactiveMs >= 0) {
+        snprintf(line, sizeof(line), "Tray ready after %.1f ms\n", g_interactiveMs);
+        out += line;
+    }
+    if (g_completeMs >= 0) {
+        snprintf(line, sizeof(line), "Warm after %.1f ms (deferred phase %.1f ms)\n",
+                 g_completeMs, g_completeMs - (g_interactiveMs >= 0 ? g_interactiveMs : 0.0));
+        out += line;
+    } else {
+        out += "Deferred phase still running\n";
+    }
+    return out;
+}
+
+std::string StartupTimelineJson() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    char num[32];
+    auto fmt = [&num](double ms) -> const char* {
+        snprintf(num, sizeof(num), "%.1f", ms);
+        return num;
+    };
+    std::string json = "{";
+    json += "\"beforeMainMs\":"; json += fmt(g_beforeMainMs);
+    json += ",\"interactiveMs\":"; json += g_interactiveMs >= 0 ? fmt(g_interactiveMs) : "null";
+    json += ",\"completeMs\":"; json += g_completeMs >= 0 ? fmt(g_completeMs) : "null";
+    json += ",\"phases\":[";
+    for (size_t i = 0; i < g_phases.size(); i++) {
+        const PhaseRecord& p = g_phases[i];
+        if (i) json += ",";
+        json += "{\"name\":\""; json += p.name;
+        json += "\",\"stage\":\""; json += StageOf(p);
+        json += "\",\"thread\":\""; json += ThreadLabel(p.thread);
+        json += "\",\"startMs\":"; json += fmt(p.startMs);
+        json += ",\"ms\":"; json += fmt(p.durationMs);
+        json += "}";
+    }
+    json += "]}";
+    return json;
+}
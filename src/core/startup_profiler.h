@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+// Startup timeline.
+//
+// WinMain does only what the tray icon needs before entering the message
+// loop (critical phase); audio, the call recorder and the control panel
+// follow on the UI thread while the HTTP server and the upload journal
+// replay start on warm-up threads (deferred phase). Windows that are not
+// needed at launch record an on-demand phase when first created.
+//
+// Each step records its start and duration here, relative to process
+// start, so a slow login on one seat can be pinned to a phase:
+// POST /startup, Developer Options > Startup timeline, or the debug output
+// once startup completes.
+
+// Origin of the timeline. msBeforeMain is how long the process had been
+// running before this call (loader, static init); shown as the first phase.
+void StartupProfilerBegin(double msBeforeMain);
+
+// End of the critical phase: the tray icon is up and the message loop runs
+void StartupMarkInteractive();
+
+// End of the deferred phase: every warm-up step has finished.
+// Returns false if it was already marked.
+bool StartupMarkComplete();
+
+// Records one phase on the calling thread from construction to destruction
+class StartupPhase {
+public:
+    explicit StartupPhase(const char* name);
+    ~StartupPhase();
+    StartupPhase(const StartupPhase&) = delete;
+    StartupPhase& operator=(const StartupPhase&) = delete;
+private:
+    const char* m_name;
+    double m_startMs;
+};
+
+// Plain-text table of every phase, for the debug log and the UI
+std::string StartupTimelineReport();
+
+// {"beforeMainMs":..,"interactiveMs":..,"completeMs":..,"phases":[...]}
+std::string StartupTimelineJson();
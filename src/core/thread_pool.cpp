@@ -0,0 +1,121 @@
+#include "core/thread_pool.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+// Which pool/worker the current thread belongs to (for local submits)
+static thread_local const ThreadPool* t_pool = nullptr;
+static thread_local size_t t_workerIndex = 0;
+
+size_t ThreadPool::GetIdleCoreCount() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 1;
+}
+
+ThreadPool::ThreadPool(size_t threads, bool background) {
+    if (threads == 0) threads = GetIdleCoreCount();
+    for (size_t i = 0; i < threads; i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threads; i++) {
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i, background);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeCv.notify_all();
+    for (auto& t : m_threads) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    size_t target = (t_pool == this) ? t_workerIndex
+                                     : m_nextWorker.fetch_add(1) % m_workers.size();
+    // Count first so m_queued never drops below the tasks actually queued
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queued++;
+        m_unfinished++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_workers[target]->mutex);
+        m_workers[target]->tasks.push_back(std::move(task));
+    }
+    m_wakeCv.notify_one();
+}
+
+bool ThreadPool::TryGetTask(size_t index, std::function<void()>& task) {
+    // Own deque first, newest task
+    {
+        Worker& self = *m_workers[index];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (!self.tasks.empty()) {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            return true;
+        }
+    }
+    // Steal the oldest task from someone else
+    for (size_t i = 1; i < m_workers.size(); i++) {
+        Worker& victim = *m_workers[(index + i) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index, bool background) {
+    t_pool = this;
+    t_workerIndex = index;
+#ifdef _WIN32
+    if (background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#else
+    (void)background;
+#endif
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCv.wait(lock, [this] { return m_stop || m_queued > 0; });
+            if (m_stop && m_queued == 0) break;
+        }
+
+        std::function<void()> task;
+        if (!TryGetTask(index, task)) {
+            std::this_thread::yield(); // Counted but not pushed yet, or taken by another worker
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queued--;
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_unfinished == 0) m_idleCv.notify_all();
+        }
+    }
+
+#ifdef _WIN32
+    if (background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+#endif
+}
+
+void ThreadPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCv.wait(lock, [this] { return m_unfinished == 0; });
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+// Small work-stealing thread pool for background batch jobs
+// (archive transcoding, analysis). Each worker owns a deque: it pops its
+// own work LIFO (cache friendly) and steals FIFO from the others when idle,
+// so a few long files don't leave the other cores waiting.
+class ThreadPool {
+public:
+    // threads = 0 sizes the pool to the idle cores (all but one).
+    // background = true runs workers at background (low CPU/IO) priority.
+    explicit ThreadPool(size_t threads = 0, bool background = true);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task. From a worker thread it goes to that worker's own deque.
+    void Submit(std::function<void()> task);
+
+    // Block until every submitted task has finished
+    void WaitIdle();
+
+    size_t GetThreadCount() const { return m_threads.size(); }
+
+    // Cores left over for background work (hardware threads - 1, at least 1)
+    static size_t GetIdleCoreCount();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(size_t index, bool background);
+    bool TryGetTask(size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCv;
+    std::condition_variable m_idleCv;
+    size_t m_queued = 0;        // Tasks waiting in any deque (guarded by m_mutex)
+    size_t m_unfinished = 0;    // Queued + running (guarded by m_mutex)
+    bool m_stop = false;
+    std::atomic<size_t> m_nextWorker{0};
+};
@@ -0,0 +1,303 @@
+#include "core/trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+static const char* const kTraceNames[] = {
+    "MicPacket",
+    "LoopbackPacket",
+    "MixChunk",
+    "MicDsp",
+    "WriteChunk",
+    "WriterFlush",
+    "FinalizeRecording",
+    "RenderBuffer",
+    "FrameTick",
+    "PaintControlPanel",
+    "PaintPlayer",
+};
+static_assert(sizeof(kTraceNames) / sizeof(kTraceNames[0]) == (size_t)TraceId::Count,
+              "every TraceId needs a name");
+
+const char* GetTraceName(TraceId id) {
+    return id < TraceId::Count ? kTraceNames[(size_t)id] : "?";
+}
+
+// 8192 events x 24 bytes = 192 KB per thread. A capture thread records
+// about 100 packets a second, so that is over a minute of history.
+constexpr uint64_t RING_EVENTS = 8192;
+constexpr size_t MAX_RINGS = 32;
+
+namespace {
+
+// Slots are atomics so the exporter can read while the owner writes; the
+// write index tells it which ones may have been overwritten mid-copy
+struct Slot {
+    std::atomic<uint64_t> ts;
+    std::atomic<uint64_t> meta;    // id | phase << 16
+    std::atomic<uint64_t> arg;
+};
+
+struct Ring {
+    std::unique_ptr<Slot[]> slots{new Slot[RING_EVENTS]};
+    std::atomic<uint64_t> write{0};
+    uint64_t start = 0;             // Write index when the current thread took it over
+    uint32_t tid = 0;               // Guarded by the registry mutex, with start/name/retired
+    std::string name;
+    bool retired = false;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    uint32_t nextTid = 1;
+};
+
+Registry& GetRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+std::atomic<bool> g_enabled{true};
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+Ring* AcquireRing() {
+    Registry& reg = GetRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    Ring* ring = nullptr;
+    if (reg.rings.size() < MAX_RINGS) {
+        reg.rings.emplace_back(new Ring());
+        ring = reg.rings.back().get();
+    } else {
+        // Reuse the ring of a thread that has exited (its history is lost)
+        for (auto& r : reg.rings) {
+            if (r->retired) { ring = r.get(); break; }
+        }
+        if (!ring) return nullptr;
+        ring->start = ring->write.load(std::memory_order_relaxed);
+    }
+    ring->tid = reg.nextTid++;
+    ring->name.clear();
+    ring->retired = false;
+    return ring;
+}
+
+// Retires the calling thread's ring when it exits; the events stay
+// exportable until another thread needs the ring
+struct ThreadRing {
+    Ring* ring = nullptr;
+    bool failed = false;
+    ~ThreadRing() {
+        if (!ring) return;
+        Registry& reg = GetRegistry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        ring->retired = true;
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+Ring* GetThreadRing() {
+    if (t_ring.ring || t_ring.failed) return t_ring.ring;
+    t_ring.ring = AcquireRing();
+    t_ring.failed = t_ring.ring == nullptr;
+    return t_ring.ring;
+}
+
+} // namespace
+
+void TraceRecord(TraceId id, TracePhase phase, uint64_t arg) {
+    if (!g_enabled.load(std::memory_order_relaxed)) return;
+    Ring* ring = GetThreadRing();
+    if (!ring) return;
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count();
+
+    uint64_t w = ring->write.load(std::memory_order_relaxed);
+    Slot& slot = ring->slots[w & (RING_EVENTS - 1)];
+    slot.ts.store(ns, std::memory_order_relaxed);
+    slot.meta.store((uint64_t)id | ((uint64_t)phase << 16), std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    ring->write.store(w + 1, std::memory_order_release);
+}
+
+void TraceSetThreadName(const char* name) {
+    Ring* ring = GetThreadRing();
+    if (!ring) return;
+    Registry& reg = GetRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    ring->name = name ? name : "";
+}
+
+void TraceSetEnabled(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool TraceIsEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+// ─────────────────────────── Export ──────────────────────────────────────────
+
+namespace {
+
+struct Event {
+    uint64_t ts;
+    uint64_t meta;
+    uint64_t arg;
+};
+
+// Events of one ring that were not overwritten while copying
+std::vector<Event> SnapshotRing(const Ring& ring, uint64_t start) {
+    std::vector<Event> events;
+    uint64_t end = ring.write.load(std::memory_order_acquire);
+    uint64_t begin = end > RING_EVENTS ? end - RING_EVENTS : 0;
+    if (begin < start) begin = start;
+    events.reserve((size_t)(end - begin));
+    for (uint64_t i = begin; i < end; i++) {
+        const Slot& slot = ring.slots[i & (RING_EVENTS - 1)];
+        events.push_back({slot.ts.load(std::memory_order_relaxed),
+                          slot.meta.load(std::memory_order_relaxed),
+                          slot.arg.load(std::memory_order_relaxed)});
+    }
+    // The owner may have lapped the oldest slots during the copy (the slot
+    // it is writing now counts as lapped)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = ring.write.load(std::memory_order_relaxed);
+    uint64_t firstValid = after >= RING_EVENTS ? after - RING_EVENTS + 1 : 0;
+    if (firstValid > begin) {
+        size_t drop = (size_t)(firstValid - begin);
+        events.erase(events.begin(), events.begin() + (drop < events.size() ? drop : events.size()));
+    }
+    return events;
+}
+
+void AppendEscaped(std::string& out, const std::string& s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c < 0x20) continue;
+        out += c;
+    }
+}
+
+} // namespace
+
+std::string TraceExportJson() {
+    struct Thread {
+        uint32_t tid;
+        std::string name;
+        const Ring* ring;
+        uint64_t start;
+    };
+    std::vector<Thread> threads;
+    {
+        Registry& reg = GetRegistry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& r : reg.rings) threads.push_back({r->tid, r->name, r.get(), r->start});
+    }
+
+    std::string out;
+    out.reserve(threads.size() * 4096);
+    out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char line[256];
+
+    for (const Thread& t : threads) {
+        if (!t.name.empty()) {
+            out += first ? "\n" : ",\n";
+            first = false;
+            snprintf(line, sizeof(line), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", t.tid);
+            out += line;
+            AppendEscaped(out, t.name);
+            out += "\"}}";
+        }
+
+        // Rings are never freed, so reading one outside the lock is safe
+        std::vector<Event> events = SnapshotRing(*t.ring, t.start);
+        int depth = 0;
+        for (const Event& e : events) {
+            TraceId id = (TraceId)(e.meta & 0xFFFF);
+            TracePhase phase = (TracePhase)((e.meta >> 16) & 0xFF);
+            if (id >= TraceId::Count) continue;
+
+            // An End whose Begin was overwritten would close the wrong slice
+            if (phase == TracePhase::End) {
+                if (depth == 0) continue;
+                depth--;
+            } else if (phase == TracePhase::Begin) {
+                depth++;
+            }
+
+            double us = e.ts / 1000.0;
+            const char* name = GetTraceName(id);
+            switch (phase) {
+                case TracePhase::Begin:
+                    if (e.arg) {
+                        snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%llu}}",
+                                 name, us, t.tid, (unsigned long long)e.arg);
+                    } else {
+                        snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                                 name, us, t.tid);
+                    }
+                    break;
+                case TracePhase::End:
+                    snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                             name, us, t.tid);
+                    break;
+                case TracePhase::Instant:
+                    snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%llu}}",
+                             name, us, t.tid, (unsigned long long)e.arg);
+                    break;
+                case TracePhase::Counter:
+                    snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%llu}}",
+                             name, us, t.tid, (unsigned long long)e.arg);
+                    break;
+                default:
+                    continue;
+            }
+            out += first ? "\n" : ",\n";
+            first = false;
+            out += line;
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool TraceWriteFile(const std::string& path) {
+    std::string json = TraceExportJson();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(json.data(), (std::streamsize)json.size());
+    return file.good();
+}
+
+std::string TraceStats::ToJson() const {
+    std::string json = "{";
+    json += "\"enabled\":" + std::string(TraceIsEnabled() ? "true" : "false");
+    json += ",\"threads\":" + std::to_string(threads);
+    json += ",\"recorded\":" + std::to_string(recorded);
+    json += ",\"retained\":" + std::to_string(retained);
+    json += ",\"ringCapacity\":" + std::to_string(ringCapacity);
+    json += "}";
+    return json;
+}
+
+TraceStats GetTraceStats() {
+    TraceStats stats;
+    stats.ringCapacity = (uint32_t)RING_EVENTS;
+    Registry& reg = GetRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    stats.threads = (uint32_t)reg.rings.size();
+    for (const auto& r : reg.rings) {
+        uint64_t w = r->write.load(std::memory_order_relaxed);
+        stats.recorded += w;
+        stats.retained += w - r->start < RING_EVENTS ? w - r->start : RING_EVENTS;
+    }
+    return stats;
+}
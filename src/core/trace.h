@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Binary trace ring for hot-path instrumentation.
+//
+// Every thread that records gets its own fixed-size ring of 24-byte events
+// (timestamp in ns, event id, phase, one integer argument); recording is a
+// clock read and three relaxed stores, no locks, no formatting. The oldest
+// events are overwritten, so the rings always hold the last few seconds of
+// activity. Export turns the rings into Chrome trace / Perfetto JSON on
+// demand (POST /trace, tools/trace_tool).
+//
+// Event ids are fixed at compile time; add new ones to TraceId and the
+// name table in trace.cpp. Build with /D MICMUTE_NO_TRACE to compile every
+// TRACE_* macro out.
+
+enum class TraceId : uint16_t {
+    // Capture / mix / write (audio/WasapiRecorder, audio/StreamingWavWriter)
+    MicPacket,          // arg = frames
+    LoopbackPacket,     // arg = frames
+    MixChunk,
+    MicDsp,
+    WriteChunk,         // arg = bytes
+    WriterFlush,
+    FinalizeRecording,  // Background close-out (audio/RecordingHandoff)
+    // Playback (audio/WasapiOutput)
+    RenderBuffer,       // arg = frames
+    // UI thread
+    FrameTick,
+    PaintControlPanel,
+    PaintPlayer,
+    Count
+};
+
+const char* GetTraceName(TraceId id);
+
+enum class TracePhase : uint8_t { Begin, End, Instant, Counter };
+
+void TraceRecord(TraceId id, TracePhase phase, uint64_t arg = 0);
+
+// Name shown for the calling thread in the exported trace
+void TraceSetThreadName(const char* name);
+
+// Recording is on by default; off makes TraceRecord a single load
+void TraceSetEnabled(bool enabled);
+bool TraceIsEnabled();
+
+// Chrome trace JSON ({"traceEvents":[...]}) of everything still in the
+// rings, oldest first per thread. Safe while other threads keep recording;
+// events overwritten during the copy are dropped, never torn.
+std::string TraceExportJson();
+bool TraceWriteFile(const std::string& path);
+
+struct TraceStats {
+    uint32_t threads = 0;           // Rings allocated (live + retired)
+    uint64_t recorded = 0;          // Events recorded since start
+    uint64_t retained = 0;          // Events still in the rings
+    uint32_t ringCapacity = 0;      // Events per thread
+
+    std::string ToJson() const;
+};
+TraceStats GetTraceStats();
+
+// Begin/End pair around a scope
+class TraceScope {
+public:
+    explicit TraceScope(TraceId id, uint64_t arg = 0) : m_id(id) { TraceRecord(id, TracePhase::Begin, arg); }
+    ~TraceScope() { TraceRecord(m_id, TracePhase::End); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+private:
+    TraceId m_id;
+};
+
+#ifndef MICMUTE_NO_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(id) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(TraceId::id)
+#define TRACE_SCOPE_ARG(id, arg) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(TraceId::id, (uint64_t)(arg))
+#define TRACE_INSTANT(id, arg) TraceRecord(TraceId::id, TracePhase::Instant, (uint64_t)(arg))
+#define TRACE_COUNTER(id, value) TraceRecord(TraceId::id, TracePhase::Counter, (uint64_t)(value))
+#define TRACE_THREAD_NAME(name) TraceSetThreadName(name)
+#else
+#define TRACE_SCOPE(id) ((void)0)
+#define TRACE_SCOPE_ARG(id, arg) ((void)0)
+#define TRACE_INSTANT(id, arg) ((void)0)
+#define TRACE_COUNTER(id, value) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,301 @@
+#include "network/http_client.h"
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winhttp.h>
+#pragma comment(lib, "winhttp.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
+
+static std::string ToLowerAscii(std::string s) {
+    for (auto& c : s) c = (char)tolower((unsigned char)c);
+    return s;
+}
+
+bool ParseHttpUrl(const std::string& url, std::string& scheme, std::string& host, int& port, std::string& path) {
+    size_t sep = url.find("://");
+    if (sep == std::string::npos) return false;
+    scheme = ToLowerAscii(url.substr(0, sep));
+    if (scheme != "http" && scheme != "https") return false;
+
+    size_t hostStart = sep + 3;
+    size_t pathStart = url.find('/', hostStart);
+    std::string hostPort = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+    path = pathStart == std::string::npos ? "" : url.substr(pathStart);
+    while (!path.empty() && path.back() == '/') path.pop_back();
+
+    size_t colon = hostPort.find(':');
+    if (colon != std::string::npos) {
+        host = hostPort.substr(0, colon);
+        port = atoi(hostPort.c_str() + colon + 1);
+    } else {
+        host = hostPort;
+        port = scheme == "https" ? 443 : 80;
+    }
+    return !host.empty() && port > 0;
+}
+
+// Parse "Name: value\r\n" lines into lower-case keyed map
+static void ParseHeaderBlock(const std::string& block, HttpResponse& response) {
+    size_t pos = 0;
+    while (pos < block.size()) {
+        size_t eol = block.find("\r\n", pos);
+        if (eol == std::string::npos) eol = block.size();
+        std::string line = block.substr(pos, eol - pos);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string value = line.substr(colon + 1);
+            size_t first = value.find_first_not_of(' ');
+            response.headers[ToLowerAscii(line.substr(0, colon))] = first == std::string::npos ? "" : value.substr(first);
+        }
+        pos = eol + 2;
+    }
+}
+
+#ifdef _WIN32
+
+class WinHttpClient : public HttpClient {
+public:
+    WinHttpClient() {
+        m_session = WinHttpOpen(L"MicMute-Uploader/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                                WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+    }
+    ~WinHttpClient() override {
+        if (m_session) WinHttpCloseHandle(m_session);
+    }
+
+    bool Send(const HttpRequest& request, HttpResponse& response) override {
+        response = HttpResponse();
+        if (!m_session) return false;
+
+        bool secure = request.scheme == "https";
+        INTERNET_PORT port = (INTERNET_PORT)(request.port ? request.port : (secure ? 443 : 80));
+        std::wstring host(request.host.begin(), request.host.end());
+        std::wstring method(request.method.begin(), request.method.end());
+        std::wstring path(request.path.begin(), request.path.end());
+
+        HINTERNET hConnect = WinHttpConnect(m_session, host.c_str(), port, 0);
+        if (!hConnect) return false;
+        HINTERNET hRequest = WinHttpOpenRequest(hConnect, method.c_str(), path.c_str(), NULL,
+                                                WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                                secure ? WINHTTP_FLAG_SECURE : 0);
+        if (!hRequest) { WinHttpCloseHandle(hConnect); return false; }
+
+        std::wstring headers;
+        for (const auto& h : request.headers) {
+            std::string line = h.first + ": " + h.second + "\r\n";
+            headers.append(line.begin(), line.end());
+        }
+
+        bool ok = WinHttpSendRequest(hRequest, headers.empty() ? WINHTTP_NO_ADDITIONAL_HEADERS : headers.c_str(),
+                                     (DWORD)-1L, WINHTTP_NO_REQUEST_DATA, 0, (DWORD)request.bodyLen, 0) != FALSE;
+
+        // Body goes out in chunks so the throttle can pace it
+        size_t sent = 0;
+        while (ok && sent < request.bodyLen) {
+            size_t n = request.bodyLen - sent < HTTP_WRITE_CHUNK ? request.bodyLen - sent : HTTP_WRITE_CHUNK;
+            if (request.beforeWrite) request.beforeWrite(n);
+            DWORD written = 0;
+            ok = WinHttpWriteData(hRequest, request.body + sent, (DWORD)n, &written) != FALSE;
+            sent += written;
+        }
+
+        if (ok) ok = WinHttpReceiveResponse(hRequest, NULL) != FALSE;
+
+        if (ok) {
+            DWORD status = 0, size = sizeof(status);
+            WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                                WINHTTP_HEADER_NAME_BY_INDEX, &status, &size, WINHTTP_NO_HEADER_INDEX);
+            response.status = (int)status;
+
+            DWORD rawSize = 0;
+            WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX,
+                                NULL, &rawSize, WINHTTP_NO_HEADER_INDEX);
+            if (rawSize > 0) {
+                std::wstring raw(rawSize / sizeof(wchar_t), L'\0');
+                if (WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX,
+                                        &raw[0], &rawSize, WINHTTP_NO_HEADER_INDEX)) {
+                    std::string block;
+                    for (wchar_t c : raw) { if (c) block += (char)c; }
+                    ParseHeaderBlock(block, response);
+                }
+            }
+
+            // One buffer for the whole body; a failed read is a failed
+            // request (a truncated download must not look complete)
+            std::vector<char> buffer(HTTP_READ_CHUNK);
+            bool stream = request.onBody && response.status >= 200 && response.status < 300;
+            for (;;) {
+                DWORD available = 0;
+                if (!WinHttpQueryDataAvailable(hRequest, &available)) { ok = false; break; }
+                if (available == 0) break;
+                DWORD want = available < (DWORD)buffer.size() ? available : (DWORD)buffer.size();
+                DWORD read = 0;
+                if (!WinHttpReadData(hRequest, buffer.data(), want, &read)) { ok = false; break; }
+                if (read == 0) break;
+                if (stream) {
+                    if (!request.onBody(buffer.data(), read)) { ok = false; break; }
+                } else {
+                    response.body.append(buffer.data(), read);
+                }
+            }
+        }
+
+        WinHttpCloseHandle(hRequest);
+        WinHttpCloseHandle(hConnect);
+        return ok;
+    }
+
+private:
+    HINTERNET m_session = nullptr;
+};
+
+std::unique_ptr<HttpClient> CreateHttpClient() {
+    return std::make_unique<WinHttpClient>();
+}
+
+#else
+
+// Plain HTTP/1.1 over POSIX sockets, one connection per request
+class SocketHttpClient : public HttpClient {
+public:
+    bool Send(const HttpRequest& request, HttpResponse& response) override {
+        response = HttpResponse();
+        if (request.scheme != "http") return false; // No TLS here
+
+        int port = request.port ? request.port : 80;
+        int fd = Connect(request.host, port);
+        if (fd < 0) return false;
+
+        // Same Host value WinHTTP sends (port only when non-default)
+        std::string head = request.method + " " + request.path + " HTTP/1.1\r\n";
+        head += "Host: " + request.host + (port != 80 ? ":" + std::to_string(port) : "") + "\r\n";
+        for (const auto& h : request.headers) {
+            if (ToLowerAscii(h.first) == "host") continue;
+            head += h.first + ": " + h.second + "\r\n";
+        }
+        head += "Content-Length: " + std::to_string(request.bodyLen) + "\r\n";
+        head += "Connection: close\r\n\r\n";
+
+        bool ok = WriteAll(fd, head.data(), head.size());
+        size_t sent = 0;
+        while (ok && sent < request.bodyLen) {
+            size_t n = request.bodyLen - sent < HTTP_WRITE_CHUNK ? request.bodyLen - sent : HTTP_WRITE_CHUNK;
+            if (request.beforeWrite) request.beforeWrite(n);
+            ok = WriteAll(fd, request.body + sent, n);
+            sent += n;
+        }
+
+        if (ok) ok = ReceiveResponse(fd, request, response);
+        close(fd);
+        return ok;
+    }
+
+private:
+    static int Connect(const std::string& host, int port) {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0) return -1;
+
+        int fd = -1;
+        for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+            if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(result);
+        return fd;
+    }
+
+    static bool WriteAll(int fd, const char* data, size_t len) {
+        while (len > 0) {
+            ssize_t n = send(fd, data, len, 0);
+            if (n <= 0) return false;
+            data += n;
+            len -= (size_t)n;
+        }
+        return true;
+    }
+
+    // Status line and headers first; then a plain 2xx body is streamed to
+    // onBody as it arrives, anything else is collected (and de-chunked)
+    static bool ReceiveResponse(int fd, const HttpRequest& request, HttpResponse& response) {
+        std::string raw;
+        char buf[16384];
+        ssize_t n;
+        size_t headerEnd;
+        while ((headerEnd = raw.find("\r\n\r\n")) == std::string::npos) {
+            n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return false;
+            raw.append(buf, (size_t)n);
+        }
+        if (raw.compare(0, 5, "HTTP/") != 0) return false;
+        size_t space = raw.find(' ');
+        response.status = atoi(raw.c_str() + space + 1);
+
+        size_t firstEol = raw.find("\r\n");
+        ParseHeaderBlock(raw.substr(firstEol + 2, headerEnd - firstEol - 2), response);
+
+        std::string body = raw.substr(headerEnd + 4);
+        auto te = response.headers.find("transfer-encoding");
+        bool chunked = te != response.headers.end() && ToLowerAscii(te->second).find("chunked") != std::string::npos;
+
+        if (request.onBody && !chunked && response.status >= 200 && response.status < 300) {
+            auto cl = response.headers.find("content-length");
+            bool sized = cl != response.headers.end();
+            uint64_t expected = sized ? strtoull(cl->second.c_str(), nullptr, 10) : 0;
+            uint64_t received = body.size();
+            if (!body.empty() && !request.onBody(body.data(), body.size())) return false;
+            while (!sized || received < expected) {
+                n = recv(fd, buf, sizeof(buf), 0);
+                if (n < 0) return false;
+                if (n == 0) break;
+                if (!request.onBody(buf, (size_t)n)) return false;
+                received += (uint64_t)n;
+            }
+            return !sized || received == expected;
+        }
+
+        while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) body.append(buf, (size_t)n);
+        if (chunked) {
+            size_t pos = 0;
+            while (pos < body.size()) {
+                size_t eol = body.find("\r\n", pos);
+                if (eol == std::string::npos) break;
+                size_t chunk = strtoul(body.c_str() + pos, nullptr, 16);
+                if (chunk == 0) break;
+                response.body.append(body, eol + 2, chunk);
+                pos = eol + 2 + chunk + 2;
+            }
+        } else {
+            response.body = body;
+        }
+        if (request.onBody && response.status >= 200 && response.status < 300) {
+            // Chunked download: decoded in one piece, handed over the same way
+            bool accepted = response.body.empty() || request.onBody(response.body.data(), response.body.size());
+            response.body.clear();
+            return accepted;
+        }
+        return true;
+    }
+};
+
+std::unique_ptr<HttpClient> CreateHttpClient() {
+    return std::make_unique<SocketHttpClient>();
+}
+
+#endif
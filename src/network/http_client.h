@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+// Minimal blocking HTTP client used by the upload queue and the updater.
+//
+// Windows uses WinHTTP (http + https, system proxy). Other platforms get a
+// plain-socket HTTP/1.1 client so the upload code can run against a local
+// object store stand-in (e.g. MinIO on http://localhost:9000).
+struct HttpRequest {
+    std::string method = "GET";
+    std::string scheme = "https";
+    std::string host;
+    int         port = 0;          // 0 = default for scheme
+    std::string path = "/";        // Already URI encoded, including query
+    std::vector<std::pair<std::string, std::string>> headers;
+    const char* body = nullptr;
+    size_t      bodyLen = 0;
+
+    // Called before each body chunk is written (bandwidth throttling)
+    std::function<void(size_t bytes)> beforeWrite;
+
+    // Downloads: body bytes of a 2xx response are handed over as they
+    // arrive (from one fixed read buffer) instead of being collected in
+    // HttpResponse::body. Status and headers are already filled in when it
+    // is first called. Return false to abort; Send then returns false.
+    std::function<bool(const char* data, size_t len)> onBody;
+};
+
+struct HttpResponse {
+    int status = 0;                               // 0 = transport failure
+    std::map<std::string, std::string> headers;   // Lower-case names
+    std::string body;
+};
+
+class HttpClient {
+public:
+    virtual ~HttpClient() = default;
+    virtual bool Send(const HttpRequest& request, HttpResponse& response) = 0;
+};
+
+// Body chunk sizes used by both implementations
+constexpr size_t HTTP_WRITE_CHUNK = 64 * 1024;
+constexpr size_t HTTP_READ_CHUNK = 64 * 1024;
+
+std::unique_ptr<HttpClient> CreateHttpClient();
+
+// Split "https://host:port/base" into parts. Returns false if malformed.
+bool ParseHttpUrl(const std::string& url, std::string& scheme, std::string& host, int& port, std::string& path);
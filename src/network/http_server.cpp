@@ -1,10 +1,24 @@
 #include "network/http_server.h"
 #include "audio/call_recorder.h"
 #include "audio/recorder.h"
+#include "audio/CaptureHub.h"
 #include <ws2tcpip.h>
 #include <thread>
 #include "core/globals.h"
+#include "core/settings.h"
+#include "storage/retention.h"
+#include "storage/call_stats.h"
+#include "storage/encrypted_recording.h"
+#include "network/upload_queue.h"
+#include "network/updater.h"
+#include "core/trace.h"
+#include "core/buffer_pool.h"
+#include "core/startup_profiler.h"
 #include <atomic>
+#include <cctype>
+#include <ctime>
+#include <filesystem>
+#include <mutex>
 
 #pragma comment(lib, "ws2_32.lib")
 
@@ -14,6 +28,90 @@ constexpr size_t BUFFER_SIZE = 16384; // Increased buffer for metadata
 static SOCKET serverSocket = INVALID_SOCKET;
 static std::atomic<bool> serverRunning(false);
 static std::thread serverThread;
+static std::atomic<void (*)()> shutdownHandler(nullptr);
+
+// Re-wrap pass after a key rotation (header rewrite per recording)
+static std::atomic<bool> rewrapRunning(false);
+static std::atomic<int> rewrapDone(0);
+static std::atomic<int> rewrapFailed(0);
+static std::thread rewrapThread;
+constexpr size_t MAX_RECORDING_KEYS = 64;
+
+// Every recording on disk, not the catalog: that is only filled once the
+// player has been opened, so it misses most of the archive
+static void RewrapFolder(const std::string& rootFolder, const RecordingKey& newKey) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    for (fs::directory_iterator it(rootFolder, ec), end; !ec && it != end && serverRunning; it.increment(ec)) {
+        std::error_code dec;
+        if (!it->is_directory(dec)) continue;
+        if (ParseDateFolderName(it->path().filename().string()) == -1) continue;
+
+        for (fs::directory_iterator fit(it->path(), dec), fend; !dec && fit != fend && serverRunning; fit.increment(dec)) {
+            std::error_code fec;
+            if (!fit->is_regular_file(fec)) continue;
+            std::string ext = fit->path().extension().string();
+            for (auto& c : ext) c = (char)tolower((unsigned char)c);
+            if (ext != ".wav") continue;
+            std::string path = fit->path().string();
+            if (!EncryptedRecording::IsEncrypted(path)) continue;
+            if (RewrapRecording(path, GetRecordingKeyring(), newKey)) rewrapDone++;
+            else rewrapFailed++;
+        }
+    }
+}
+
+static void StartRewrapPass(const RecordingKey& newKey) {
+    if (rewrapRunning.exchange(true)) return; // Next rotation picks up the rest
+    if (rewrapThread.joinable()) rewrapThread.join();   // Previous pass, already finished
+    rewrapDone = 0;
+    rewrapFailed = 0;
+    rewrapThread = std::thread([newKey, rootFolder = recordingFolder]() {
+        RewrapFolder(rootFolder, newKey);
+        rewrapRunning = false;
+    });
+}
+
+// Retention dry run for /retention. Planning stats every recording, which
+// takes seconds on a large archive, so it runs on a background thread and
+// the endpoint answers from the last report
+static std::thread retentionPlanThread;
+static std::atomic<bool> retentionPlanRunning(false);
+static std::mutex retentionPlanMutex;
+static std::string retentionPlanJson;      // Empty until the first plan is done
+static ULONGLONG retentionPlanTime = 0;
+constexpr ULONGLONG RETENTION_PLAN_MAX_AGE_MS = 60000;
+
+static void StartRetentionPlan() {
+    if (retentionPlanRunning.exchange(true)) return;
+    if (retentionPlanThread.joinable()) retentionPlanThread.join();   // Previous plan, already finished
+    retentionPlanThread = std::thread([rootFolder = recordingFolder, policy = GetConfiguredRetentionPolicy()]() {
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+        RetentionReport report = RetentionEngine::Plan(rootFolder, policy, std::time(nullptr));
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+
+        std::lock_guard<std::mutex> lock(retentionPlanMutex);
+        retentionPlanJson = report.ToJson();
+        retentionPlanTime = GetTickCount64();
+        retentionPlanRunning = false;
+    });
+}
+
+static std::string EncryptionStatusJson() {
+    RecordingKey current;
+    bool hasKey = GetRecordingKeyring().GetCurrent(current);
+    std::string body = "{\"enabled\":";
+    body += encryptRecordings ? "true" : "false";
+    body += ",\"keyId\":\"" + (hasKey ? current.IdHex() : std::string()) + "\"";
+    body += ",\"keys\":" + std::to_string(GetRecordingKeyring().Size());
+    body += ",\"hardwareAes\":";
+    body += AesGcm::HasHardwareSupport() ? "true" : "false";
+    body += ",\"rewrap\":{\"running\":";
+    body += rewrapRunning ? "true" : "false";
+    body += ",\"done\":" + std::to_string(rewrapDone.load());
+    body += ",\"failed\":" + std::to_string(rewrapFailed.load()) + "}}";
+    return body;
+}
 
 #include <map>
 #include <vector>
@@ -77,21 +175,67 @@ std::map<std::string, std::string> ParseMetadataFromJSON(const std::string& json
     return metadata;
 }
 
+// Browser origin of the request being handled, echoed in the CORS header
+// (one request at a time on the server thread). Empty for clients that
+// send no Origin (soak_tool, curl), which get no CORS header at all.
+static std::string requestOrigin;
+constexpr size_t MAX_ORIGIN_LENGTH = 200;
+
+// Web pages may only reach the recorder from where the extension runs:
+// its content script fetches with the Ozonetel page's origin, anything
+// else (another site open in the same browser) is refused
+static bool IsAllowedOrigin(const std::string& origin) {
+    if (origin.empty()) return true;
+    if (origin.size() > MAX_ORIGIN_LENGTH) return false;
+    if (origin.rfind("chrome-extension://", 0) == 0 || origin.rfind("moz-extension://", 0) == 0) return true;
+
+    size_t hostStart;
+    if (origin.rfind("https://", 0) == 0) hostStart = 8;
+    else if (origin.rfind("http://", 0) == 0) hostStart = 7;
+    else return false;
+    std::string host = origin.substr(hostStart, origin.find(':', hostStart) - hostStart);
+    for (auto& c : host) c = (char)tolower((unsigned char)c);
+    const std::string domain = "ozonetel.com";
+    return host == domain ||
+           (host.size() > domain.size() && host.compare(host.size() - domain.size() - 1, std::string::npos, "." + domain) == 0);
+}
+
+// Value of the Origin header, empty if there is none
+static std::string GetOriginHeader(const char* request) {
+    const char* headersEnd = strstr(request, "\r\n\r\n");
+    for (const char* line = strstr(request, "\r\n"); line && line != headersEnd; line = strstr(line + 2, "\r\n")) {
+        if (_strnicmp(line + 2, "Origin:", 7) != 0) continue;
+        const char* value = line + 9;
+        while (*value == ' ' || *value == '\t') value++;
+        const char* end = strstr(value, "\r\n");
+        return end ? std::string(value, end - value) : std::string(value);
+    }
+    return "";
+}
+
 // Send HTTP response
 void SendResponse(SOCKET client, int statusCode, const char* statusText, const char* body) {
-    char response[1024];
-    snprintf(response, sizeof(response),
+    char header[768];
+    size_t bodyLen = strlen(body);
+    std::string cors;
+    if (!requestOrigin.empty()) {
+        cors = "Access-Control-Allow-Origin: " + requestOrigin + "\r\n"
+               "Vary: Origin\r\n"
+               "Access-Control-Allow-Methods: POST, OPTIONS\r\n"
+               "Access-Control-Allow-Headers: Content-Type\r\n";
+    }
+    snprintf(header, sizeof(header),
         "HTTP/1.1 %d %s\r\n"
         "Content-Type: application/json\r\n"
-        "Access-Control-Allow-Origin: *\r\n"
-        "Access-Control-Allow-Methods: POST, OPTIONS\r\n"
-        "Access-Control-Allow-Headers: Content-Type\r\n"
+        "%s"
         "Content-Length: %zu\r\n"
-        "\r\n"
-        "%s",
-        statusCode, statusText, strlen(body), body);
+        "\r\n",
+        statusCode, statusText, cors.c_str(), bodyLen);
     
-    send(client, response, (int)strlen(response), 0);
+    // Bodies can be larger than the header (e.g. retention report)
+    std::string response = header;
+    response.append(body, bodyLen);
+    send(client, response.data(), (int)response.size(), 0);
 }
 
 // Handle incoming request
@@ -113,6 +257,14 @@ void HandleRequest(SOCKET client) {
         return;
     }
     
+    requestOrigin = GetOriginHeader(buffer);
+    if (!IsAllowedOrigin(requestOrigin)) {
+        requestOrigin.clear();
+        SendResponse(client, 403, "Forbidden", "{\"error\":\"origin not allowed\"}");
+        closesocket(client);
+        return;
+    }
+
     // Handle CORS preflight
     if (strcmp(method, "OPTIONS") == 0) {
         SendResponse(client, 200, "OK", "{}");
@@ -159,6 +311,7 @@ void HandleRequest(SOCKET client) {
         else if (strcmp(path, "/status") == 0) {
             // Get current status
             const char* status = "idle";
+            size_t saving = g_CallRecorder ? g_CallRecorder->GetPendingSaves() : 0;
             if (g_CallRecorder) {
                 if (g_CallRecorder->GetState() == CallAutoRecorder::State::RECORDING) {
                     status = "recording";
@@ -166,11 +319,112 @@ void HandleRequest(SOCKET client) {
                     status = "waiting";
                 }
             }
-            char body[128];
-            snprintf(body, sizeof(body), "{\"status\":\"%s\",\"connected\":%s}", 
-                     status, extensionConnected ? "true" : "false");
+            char body[160];
+            snprintf(body, sizeof(body), "{\"status\":\"%s\",\"connected\":%s,\"saving\":%zu}", 
+                     status, extensionConnected ? "true" : "false", saving);
             SendResponse(client, 200, "OK", body);
         }
+        else if (strcmp(path, "/stats") == 0) {
+            // Call counters from the stats store (no filesystem access).
+            // Today is the calendar date, not the recorder's last call date
+            std::string today = DateFolderName(time(nullptr));
+            SendResponse(client, 200, "OK", GetCallStats(recordingFolder).ToJson(today).c_str());
+        }
+        else if (strcmp(path, "/retention") == 0) {
+            // Dry run of the retention policy - what would be deleted and why.
+            // 202 until the first plan is ready; after that the last report
+            // with its age, refreshed in the background once it is stale
+            std::string report;
+            ULONGLONG ageMs;
+            {
+                std::lock_guard<std::mutex> lock(retentionPlanMutex);
+                report = retentionPlanJson;
+                ageMs = GetTickCount64() - retentionPlanTime;
+            }
+            if (report.empty() || ageMs > RETENTION_PLAN_MAX_AGE_MS) StartRetentionPlan();
+
+            if (report.empty()) {
+                SendResponse(client, 202, "Accepted", "{\"status\":\"planning\"}");
+            } else {
+                std::string body = "{\"age_ms\":" + std::to_string(ageMs);
+                body += ",\"refreshing\":";
+                body += retentionPlanRunning ? "true," : "false,";
+                body += report.substr(1);
+                SendResponse(client, 200, "OK", body.c_str());
+            }
+        }
+        else if (strcmp(path, "/uploads") == 0) {
+            // Upload queue progress (pending jobs, bytes sent, last error)
+            SendResponse(client, 200, "OK", GetUploadQueue().GetStatus().ToJson().c_str());
+        }
+        else if (strcmp(path, "/analytics") == 0) {
+            // Conversation analytics: call in progress and last saved call
+            std::string body = "{\"recording\":";
+            ConversationStats last;
+            if (g_CallRecorder && g_CallRecorder->GetState() == CallAutoRecorder::State::RECORDING) {
+                body += "true,\"current\":" + g_CallRecorder->GetLiveConversationStats().ToJson();
+            } else {
+                body += "false,\"current\":null";
+            }
+            body += ",\"lastCall\":";
+            body += g_CallRecorder && g_CallRecorder->GetLastCallConversationStats(last) ? last.ToJson() : "null";
+            body += "}";
+            SendResponse(client, 200, "OK", body.c_str());
+        }
+        else if (strcmp(path, "/updates") == 0) {
+            // Updater: last download (delta/peer/origin, bytes, resumes), peer cache
+            SendResponse(client, 200, "OK", AutoUpdater::GetStatusJson().c_str());
+        }
+        else if (strcmp(path, "/metrics") == 0) {
+            // Recording-path counters: buffer pool (heap allocations), trace rings,
+            // stop-to-ready latency of the back-to-back call handoff, shared
+            // capture streams (subscribers, device opens, lapped bytes)
+            std::string body = "{\"buffers\":" + GetAudioBufferPool().GetStats().ToJson();
+            body += ",\"capture\":" + GetCaptureHub().GetStats().ToJson();
+            body += ",\"trace\":" + GetTraceStats().ToJson();
+            body += ",\"handoff\":" + (g_CallRecorder ? g_CallRecorder->GetHandoffStats().ToJson() : std::string("null"));
+            body += "}";
+            SendResponse(client, 200, "OK", body.c_str());
+        }
+        else if (strcmp(path, "/dsp") == 0) {
+            // Mic DSP chain: CPU time per 10 ms block for each stage vs the budget
+            SendResponse(client, 200, "OK", GetMicDspTimings().ToJson().c_str());
+        }
+        else if (strcmp(path, "/encryption") == 0) {
+            // Encryption at rest: current key id, keyring size, AES-NI, re-wrap progress
+            SendResponse(client, 200, "OK", EncryptionStatusJson().c_str());
+        }
+        else if (strcmp(path, "/encryption/rotate") == 0) {
+            // New master key for new recordings; existing ones are re-wrapped
+            // under it in the background (older keys stay for anything missed).
+            // Old keys are never dropped, so rotations are refused while a
+            // pass is still running and once the keyring is full.
+            RecordingKey created;
+            if (rewrapRunning) {
+                SendResponse(client, 409, "Conflict", "{\"error\":\"re-wrap pass still running\"}");
+            } else if (GetRecordingKeyring().Size() >= MAX_RECORDING_KEYS) {
+                SendResponse(client, 409, "Conflict", "{\"error\":\"keyring full\"}");
+            } else if (GetRecordingKeyring().Rotate(&created)) {
+                SaveRecordingKeys();
+                StartRewrapPass(created);
+                SendResponse(client, 200, "OK", EncryptionStatusJson().c_str());
+            } else {
+                SendResponse(client, 500, "Internal Server Error", "{\"error\":\"key generation failed\"}");
+            }
+        }
+        else if (strcmp(path, "/trace") == 0) {
+            // Trace rings as Chrome trace / Perfetto JSON (save the body as .json)
+            SendResponse(client, 200, "OK", TraceExportJson().c_str());
+        }
+        else if (strcmp(path, "/startup") == 0) {
+            // Startup timeline: time spent in each critical/deferred phase
+            SendResponse(client, 200, "OK", StartupTimelineJson().c_str());
+        }
+        else if (strcmp(path, "/shutdown") == 0 && shutdownHandler.load()) {
+            // Headless service only: exit (a call in progress is saved first)
+            SendResponse(client, 200, "OK", "{\"status\":\"shutting_down\"}");
+            shutdownHandler.load()();
+        }
         else {
             SendResponse(client, 404, "Not Found", "{\"error\":\"unknown endpoint\"}");
         }
@@ -254,6 +508,14 @@ void CleanupHttpServer() {
     if (serverThread.joinable()) {
         serverThread.join();
     }
+    // A re-wrap pass stops after the file it is on (the rest keep their
+    // old key, which stays in the keyring)
+    if (rewrapThread.joinable()) {
+        rewrapThread.join();
+    }
+    if (retentionPlanThread.joinable()) {
+        retentionPlanThread.join();
+    }
     
     if (serverSocket != INVALID_SOCKET) {
         closesocket(serverSocket);
@@ -263,6 +525,10 @@ void CleanupHttpServer() {
     WSACleanup();
 }
 
+void SetHttpShutdownHandler(void (*handler)()) {
+    shutdownHandler = handler;
+}
+
 bool IsHttpServerRunning() {
     return serverRunning && serverSocket != INVALID_SOCKET;
 }
@@ -27,6 +27,9 @@ bool IsExtensionConnected();
 // Get time since last heartbeat in milliseconds
 ULONGLONG GetTimeSinceLastHeartbeat();
 
+// Headless service: POST /shutdown calls this (404 while unset)
+void SetHttpShutdownHandler(void (*handler)());
+
 // Force start/stop recording (called by HTTP endpoints)
 void HttpForceStartRecording(const std::map<std::string, std::string>& metadata = {});
 void HttpForceStopRecording(const std::map<std::string, std::string>& metadata = {});
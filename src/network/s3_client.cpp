@@ -0,0 +1,245 @@
+#include "network/s3_client.h"
+#include "core/sha256.h"
+#include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+static const char* EMPTY_SHA256 = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+// Value of the first <tag>...</tag> at or after pos
+static std::string XmlValue(const std::string& xml, const std::string& tag, size_t pos = 0, size_t* endPos = nullptr) {
+    std::string open = "<" + tag + ">";
+    std::string close = "</" + tag + ">";
+    size_t start = xml.find(open, pos);
+    if (start == std::string::npos) return "";
+    start += open.size();
+    size_t end = xml.find(close, start);
+    if (end == std::string::npos) return "";
+    if (endPos) *endPos = end + close.size();
+    return xml.substr(start, end - start);
+}
+
+static std::string XmlUnescapeQuotes(std::string s) {
+    size_t pos;
+    while ((pos = s.find("&quot;")) != std::string::npos) s.replace(pos, 6, "\"");
+    while ((pos = s.find("&#34;")) != std::string::npos) s.replace(pos, 5, "\"");
+    return s;
+}
+
+std::string S3Client::UriEncode(const std::string& s, bool encodeSlash) {
+    static const char* hex = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : s) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || (c == '/' && !encodeSlash)) {
+            out += (char)c;
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 0x0F];
+        }
+    }
+    return out;
+}
+
+S3Client::S3Client(const S3Config& config, std::unique_ptr<HttpClient> http)
+    : m_config(config)
+    , m_http(std::move(http))
+{
+    m_valid = config.IsValid() && m_http && ParseHttpUrl(config.endpoint, m_scheme, m_host, m_port, m_basePath);
+}
+
+int S3Client::GetLastStatus() const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    return m_lastStatus;
+}
+
+std::string S3Client::GetLastError() const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    return m_lastError;
+}
+
+bool S3Client::Request(const std::string& method, const std::string& key,
+                       const std::vector<std::pair<std::string, std::string>>& query,
+                       std::vector<std::pair<std::string, std::string>> headers,
+                       const char* body, size_t bodyLen, HttpResponse& response,
+                       const std::function<void(size_t)>& throttle) {
+    if (!m_valid) return false;
+
+    // Timestamps
+    time_t now = std::time(nullptr);
+    struct tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char amzDate[20], dateStamp[10];
+    strftime(amzDate, sizeof(amzDate), "%Y%m%dT%H%M%SZ", &utc);
+    strftime(dateStamp, sizeof(dateStamp), "%Y%m%d", &utc);
+
+    std::string payloadHash = bodyLen ? Sha256::HashHex(body, bodyLen) : EMPTY_SHA256;
+    bool defaultPort = (m_scheme == "https" && m_port == 443) || (m_scheme == "http" && m_port == 80);
+    std::string hostHeader = defaultPort ? m_host : m_host + ":" + std::to_string(m_port);
+
+    headers.emplace_back("x-amz-content-sha256", payloadHash);
+    headers.emplace_back("x-amz-date", amzDate);
+
+    // Canonical URI (path-style: /bucket/key)
+    std::string uri = m_basePath + "/" + UriEncode(m_config.bucket, true);
+    if (!key.empty()) uri += "/" + UriEncode(key, false);
+
+    // Canonical query: sorted, encoded
+    std::vector<std::pair<std::string, std::string>> q;
+    for (const auto& kv : query) q.emplace_back(UriEncode(kv.first, true), UriEncode(kv.second, true));
+    std::sort(q.begin(), q.end());
+    std::string canonicalQuery;
+    for (const auto& kv : q) {
+        if (!canonicalQuery.empty()) canonicalQuery += "&";
+        canonicalQuery += kv.first + "=" + kv.second;
+    }
+
+    // Canonical headers: lower-case, sorted, host included
+    std::vector<std::pair<std::string, std::string>> signedList;
+    signedList.emplace_back("host", hostHeader);
+    for (const auto& h : headers) {
+        std::string name = h.first;
+        for (auto& c : name) c = (char)tolower((unsigned char)c);
+        signedList.emplace_back(name, h.second);
+    }
+    std::sort(signedList.begin(), signedList.end());
+    std::string canonicalHeaders, signedHeaders;
+    for (const auto& h : signedList) {
+        canonicalHeaders += h.first + ":" + h.second + "\n";
+        if (!signedHeaders.empty()) signedHeaders += ";";
+        signedHeaders += h.first;
+    }
+
+    std::string canonicalRequest = method + "\n" + uri + "\n" + canonicalQuery + "\n" +
+                                   canonicalHeaders + "\n" + signedHeaders + "\n" + payloadHash;
+    std::string scope = std::string(dateStamp) + "/" + m_config.region + "/s3/aws4_request";
+    std::string stringToSign = std::string("AWS4-HMAC-SHA256\n") + amzDate + "\n" + scope + "\n" +
+                               Sha256::HashHex(canonicalRequest);
+
+    std::string kDate = HmacSha256("AWS4" + m_config.secretKey, dateStamp);
+    std::string kRegion = HmacSha256(kDate, m_config.region);
+    std::string kService = HmacSha256(kRegion, "s3");
+    std::string kSigning = HmacSha256(kService, "aws4_request");
+    std::string signature = ToHex(HmacSha256(kSigning, stringToSign));
+
+    headers.emplace_back("Authorization", "AWS4-HMAC-SHA256 Credential=" + m_config.accessKey + "/" + scope +
+                         ", SignedHeaders=" + signedHeaders + ", Signature=" + signature);
+
+    HttpRequest request;
+    request.method = method;
+    request.scheme = m_scheme;
+    request.host = m_host;
+    request.port = m_port;
+    request.path = canonicalQuery.empty() ? uri : uri + "?" + canonicalQuery;
+    request.headers = std::move(headers);
+    request.body = body;
+    request.bodyLen = bodyLen;
+    request.beforeWrite = throttle;
+
+    bool sent = m_http->Send(request, response);
+    bool ok = sent && response.status >= 200 && response.status < 300;
+    if (!ok) {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        m_lastStatus = response.status;
+        m_lastError = sent ? XmlValue(response.body, "Code") : "transport error";
+    }
+    return ok;
+}
+
+bool S3Client::CreateMultipartUpload(const std::string& key, const std::map<std::string, std::string>& metadata,
+                                     std::string& uploadId) {
+    std::vector<std::pair<std::string, std::string>> headers;
+    headers.emplace_back("Content-Type", "audio/wav");
+    for (const auto& kv : metadata) headers.emplace_back("x-amz-meta-" + kv.first, kv.second);
+
+    HttpResponse response;
+    if (!Request("POST", key, { { "uploads", "" } }, headers, nullptr, 0, response)) return false;
+    uploadId = XmlValue(response.body, "UploadId");
+    return !uploadId.empty();
+}
+
+bool S3Client::UploadPart(const std::string& key, const std::string& uploadId, int partNumber,
+                          const char* data, size_t len, std::string& etag,
+                          const std::function<void(size_t)>& throttle) {
+    HttpResponse response;
+    if (!Request("PUT", key, { { "partNumber", std::to_string(partNumber) }, { "uploadId", uploadId } },
+                 {}, data, len, response, throttle)) {
+        return false;
+    }
+    auto it = response.headers.find("etag");
+    if (it == response.headers.end() || it->second.empty()) return false;
+    etag = it->second;
+    return true;
+}
+
+bool S3Client::ListParts(const std::string& key, const std::string& uploadId, std::vector<S3Part>& parts, bool& notFound) {
+    parts.clear();
+    notFound = false;
+    std::string marker;
+
+    for (;;) {
+        std::vector<std::pair<std::string, std::string>> query = { { "uploadId", uploadId } };
+        if (!marker.empty()) query.emplace_back("part-number-marker", marker);
+
+        HttpResponse response;
+        if (!Request("GET", key, query, {}, nullptr, 0, response)) {
+            notFound = response.status == 404;
+            return false;
+        }
+
+        size_t pos = 0;
+        for (;;) {
+            size_t partEnd = 0;
+            std::string part = XmlValue(response.body, "Part", pos, &partEnd);
+            if (part.empty()) break;
+            S3Part p;
+            p.number = atoi(XmlValue(part, "PartNumber").c_str());
+            p.etag = XmlUnescapeQuotes(XmlValue(part, "ETag"));
+            p.size = strtoull(XmlValue(part, "Size").c_str(), nullptr, 10);
+            parts.push_back(p);
+            pos = partEnd;
+        }
+
+        if (XmlValue(response.body, "IsTruncated") != "true") break;
+        marker = XmlValue(response.body, "NextPartNumberMarker");
+        if (marker.empty()) break;
+    }
+    return true;
+}
+
+bool S3Client::CompleteMultipartUpload(const std::string& key, const std::string& uploadId, const std::vector<S3Part>& parts) {
+    std::string xml = "<CompleteMultipartUpload>";
+    for (const auto& p : parts) {
+        xml += "<Part><PartNumber>" + std::to_string(p.number) + "</PartNumber><ETag>" + p.etag + "</ETag></Part>";
+    }
+    xml += "</CompleteMultipartUpload>";
+
+    HttpResponse response;
+    if (!Request("POST", key, { { "uploadId", uploadId } }, { { "Content-Type", "application/xml" } },
+                 xml.data(), xml.size(), response)) {
+        return false;
+    }
+    // S3 can report a failed completion with 200 and an <Error> body
+    if (response.body.find("<Error>") != std::string::npos) {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        m_lastStatus = response.status;
+        m_lastError = XmlValue(response.body, "Code");
+        return false;
+    }
+    return true;
+}
+
+bool S3Client::AbortMultipartUpload(const std::string& key, const std::string& uploadId) {
+    HttpResponse response;
+    return Request("DELETE", key, { { "uploadId", uploadId } }, {}, nullptr, 0, response);
+}
+
+bool S3Client::PutObject(const std::string& key, const std::string& data, const std::string& contentType) {
+    HttpResponse response;
+    return Request("PUT", key, {}, { { "Content-Type", contentType } }, data.data(), data.size(), response);
+}
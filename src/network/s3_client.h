@@ -0,0 +1,77 @@
+#pragma once
+
+#include "network/http_client.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+
+// S3-compatible object store settings (AWS, MinIO, Wasabi, ...)
+struct S3Config {
+    std::string endpoint;    // e.g. https://s3.eu-west-1.amazonaws.com or http://localhost:9000
+    std::string region = "us-east-1";
+    std::string bucket;
+    std::string accessKey;
+    std::string secretKey;
+
+    bool IsValid() const { return !endpoint.empty() && !bucket.empty() && !accessKey.empty() && !secretKey.empty(); }
+};
+
+struct S3Part {
+    int         number = 0;
+    std::string etag;
+    uint64_t    size = 0;
+};
+
+// Path-style S3 client with AWS Signature V4. Every request carries the
+// payload SHA-256 (x-amz-content-sha256), which the server verifies, so a
+// corrupted part is rejected instead of stored.
+class S3Client {
+public:
+    S3Client(const S3Config& config, std::unique_ptr<HttpClient> http);
+
+    bool IsValid() const { return m_valid; }
+
+    // Start a multipart upload. metadata becomes x-amz-meta-* headers.
+    bool CreateMultipartUpload(const std::string& key, const std::map<std::string, std::string>& metadata,
+                               std::string& uploadId);
+
+    bool UploadPart(const std::string& key, const std::string& uploadId, int partNumber,
+                    const char* data, size_t len, std::string& etag,
+                    const std::function<void(size_t)>& throttle = nullptr);
+
+    // Parts the server already has (for resuming). Returns false with
+    // notFound=true if the upload id is unknown (expired/aborted).
+    bool ListParts(const std::string& key, const std::string& uploadId, std::vector<S3Part>& parts, bool& notFound);
+
+    bool CompleteMultipartUpload(const std::string& key, const std::string& uploadId, const std::vector<S3Part>& parts);
+    bool AbortMultipartUpload(const std::string& key, const std::string& uploadId);
+
+    // Single request upload for small objects (metadata JSON)
+    bool PutObject(const std::string& key, const std::string& data, const std::string& contentType);
+
+    // Last HTTP status / error body, for logging
+    int GetLastStatus() const;
+    std::string GetLastError() const;
+
+    static std::string UriEncode(const std::string& s, bool encodeSlash);
+
+private:
+    bool Request(const std::string& method, const std::string& key,
+                 const std::vector<std::pair<std::string, std::string>>& query,
+                 std::vector<std::pair<std::string, std::string>> headers,
+                 const char* body, size_t bodyLen, HttpResponse& response,
+                 const std::function<void(size_t)>& throttle = nullptr);
+
+    S3Config m_config;
+    std::unique_ptr<HttpClient> m_http;
+    std::string m_scheme, m_host, m_basePath;
+    int m_port = 0;
+    bool m_valid = false;
+    mutable std::mutex m_errorMutex;
+    int m_lastStatus = 0;
+    std::string m_lastError;
+};
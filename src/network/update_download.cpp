@@ -0,0 +1,431 @@
+#include "network/update_download.h"
+#include "core/binary_delta.h"
+#include "core/sha256.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+namespace fs = std::filesystem;
+
+static const char* MANIFEST_HEADER = "micmute-update 1";
+static const uint64_t MAX_RETRY_DELAY_MS = 60 * 1000;
+
+static std::string ToLowerAscii(std::string s) {
+    for (auto& c : s) c = (char)tolower((unsigned char)c);
+    return s;
+}
+
+bool IsSha256Hex(const std::string& s) {
+    if (s.size() != 64) return false;
+    for (char c : s) {
+        if (!isxdigit((unsigned char)c)) return false;
+    }
+    return true;
+}
+
+std::string UrlEncodeComponent(const std::string& s) {
+    static const char* hex = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : s) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += (char)c;
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 15];
+        }
+    }
+    return out;
+}
+
+std::string UrlDecodeComponent(const std::string& s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '%' && i + 2 < s.size() && isxdigit((unsigned char)s[i + 1]) && isxdigit((unsigned char)s[i + 2])) {
+            out += (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else if (s[i] == '+') {
+            out += ' ';
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+std::string MakePeerPath(const std::string& sha256, uint64_t size, const std::string& originUrl) {
+    return "/update/" + sha256 + "?size=" + std::to_string(size) + "&src=" + UrlEncodeComponent(originUrl);
+}
+
+// ============================================================================
+// UpdateManifest
+// ============================================================================
+
+bool UpdateManifest::Parse(const std::string& text) {
+    *this = UpdateManifest();
+    std::istringstream in(text);
+    std::string line;
+    bool header = false;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        if (!header) {
+            if (line != MANIFEST_HEADER) return false;
+            header = true;
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "version") {
+            fields >> version;
+        } else if (kind == "file") {
+            File f;
+            fields >> f.name >> f.size >> f.sha256;
+            if (fields.fail() || !IsSha256Hex(f.sha256)) return false;
+            f.sha256 = ToLowerAscii(f.sha256);
+            files.push_back(f);
+        } else if (kind == "delta") {
+            Delta d;
+            fields >> d.file >> d.fromVersion >> d.name >> d.size >> d.sha256 >> d.baseSha256;
+            if (fields.fail() || !IsSha256Hex(d.sha256) || !IsSha256Hex(d.baseSha256)) return false;
+            d.sha256 = ToLowerAscii(d.sha256);
+            d.baseSha256 = ToLowerAscii(d.baseSha256);
+            deltas.push_back(d);
+        }
+        // Unknown records are skipped: newer manifests stay readable
+    }
+    return header && !version.empty() && !files.empty();
+}
+
+std::string UpdateManifest::ToText() const {
+    std::string text = std::string(MANIFEST_HEADER) + "\n";
+    text += "version " + version + "\n";
+    for (const File& f : files) {
+        text += "file " + f.name + " " + std::to_string(f.size) + " " + f.sha256 + "\n";
+    }
+    for (const Delta& d : deltas) {
+        text += "delta " + d.file + " " + d.fromVersion + " " + d.name + " " + std::to_string(d.size) + " " +
+                d.sha256 + " " + d.baseSha256 + "\n";
+    }
+    return text;
+}
+
+const UpdateManifest::File* UpdateManifest::FindFile(const std::string& name) const {
+    for (const File& f : files) {
+        if (f.name == name) return &f;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// UpdateDownloader
+// ============================================================================
+
+UpdateDownloader::UpdateDownloader(const UpdateDownloadOptions& options, std::unique_ptr<HttpClient> http)
+    : m_options(options), m_http(http ? std::move(http) : CreateHttpClient()) {
+    std::error_code ec;
+    fs::create_directories(m_options.cacheDir, ec);
+}
+
+std::string UpdateDownloader::CachePath(const std::string& sha256) const {
+    return (fs::path(m_options.cacheDir) / sha256).string();
+}
+
+std::string UpdateDownloader::ResolveUrl(const std::string& manifestUrl, const std::string& name) {
+    size_t slash = manifestUrl.find_last_of('/');
+    if (slash == std::string::npos) return name;
+    return manifestUrl.substr(0, slash + 1) + name;
+}
+
+bool UpdateDownloader::SleepUnlessCancelled(uint64_t ms) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (!m_cancel && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return !m_cancel;
+}
+
+static bool BuildRequest(const std::string& url, HttpRequest& request) {
+    int port = 0;
+    if (!ParseHttpUrl(url, request.scheme, request.host, port, request.path)) return false;
+    request.port = port;
+    if (request.path.empty()) request.path = "/";
+    return true;
+}
+
+bool UpdateDownloader::FetchManifest(const std::string& url, UpdateManifest& manifest, std::string* error) {
+    HttpRequest request;
+    HttpResponse response;
+    if (!BuildRequest(url, request)) {
+        if (error) *error = "bad manifest url";
+        return false;
+    }
+    if (!m_http->Send(request, response) || response.status != 200) {
+        if (error) *error = "manifest download failed (HTTP " + std::to_string(response.status) + ")";
+        return false;
+    }
+    if (!manifest.Parse(response.body)) {
+        if (error) *error = "malformed manifest";
+        return false;
+    }
+    return true;
+}
+
+// "bytes <first>-<last>/<total>" -> first
+static uint64_t ContentRangeStart(const HttpResponse& response) {
+    auto it = response.headers.find("content-range");
+    if (it == response.headers.end()) return UINT64_MAX;
+    size_t space = it->second.find(' ');
+    if (space == std::string::npos) return UINT64_MAX;
+    return strtoull(it->second.c_str() + space + 1, nullptr, 10);
+}
+
+bool UpdateDownloader::Download(const std::string& url, uint64_t size, const std::string& sha256,
+                                const std::string& destPath, bool fromPeer, UpdateDownloadResult& result) {
+    HttpRequest request;
+    if (!BuildRequest(url, request)) {
+        result.error = "bad url: " + url;
+        return false;
+    }
+
+    // Whatever an earlier attempt (or run) left in the .part file is kept:
+    // hash it and ask only for the rest
+    std::string partPath = destPath + ".part";
+    Sha256 hash;
+    uint64_t have = 0;
+    std::vector<char> buffer(HTTP_READ_CHUNK);
+    std::error_code ec;
+    uint64_t existing = fs::exists(partPath, ec) ? fs::file_size(partPath, ec) : 0;
+    if (existing > size) {
+        fs::remove(partPath, ec);
+    } else if (existing > 0) {
+        std::ifstream in(partPath, std::ios::binary);
+        while (in) {
+            in.read(buffer.data(), buffer.size());
+            if (in.gcount() <= 0) break;
+            hash.Update(buffer.data(), (size_t)in.gcount());
+            have += (uint64_t)in.gcount();
+        }
+    }
+
+    std::ofstream out(partPath, std::ios::binary | std::ios::app);
+    if (!out.is_open()) {
+        result.error = "cannot write " + partPath;
+        return false;
+    }
+    auto restart = [&]() {
+        out.close();
+        out.open(partPath, std::ios::binary | std::ios::trunc);
+        hash = Sha256();
+        have = 0;
+    };
+
+    int failures = 0;
+    uint64_t delay = m_options.retryDelayMs;
+    uint64_t waitedMs = 0;
+    while (have < size) {
+        if (m_cancel) {
+            result.error = "cancelled";
+            return false;
+        }
+
+        HttpRequest attempt = request;
+        bool ranged = have > 0;
+        if (ranged) attempt.headers.push_back({"Range", "bytes=" + std::to_string(have) + "-"});
+
+        // Status and headers are in place by the first body callback
+        HttpResponse response;
+        uint64_t before = have;
+        bool firstChunk = true;
+        bool corrupt = false;
+        attempt.onBody = [&](const char* data, size_t len) -> bool {
+            if (firstChunk) {
+                firstChunk = false;
+                if (response.status == 206) {
+                    if (ContentRangeStart(response) != have) { corrupt = true; return false; }
+                } else if (response.status == 200) {
+                    if (have > 0) {
+                        restart();      // Range ignored: the body is the whole file
+                        before = 0;
+                    }
+                } else {
+                    return false;
+                }
+                if (!out.is_open()) return false;
+            }
+            if (len > size - have) { corrupt = true; return false; }
+            out.write(data, (std::streamsize)len);
+            if (!out) return false;
+            hash.Update(data, len);
+            have += len;
+            result.bytesTransferred += len;
+            if (m_options.onProgress) m_options.onProgress(have, size);
+            return !m_cancel;
+        };
+
+        bool sent = m_http->Send(attempt, response);
+        if (ranged && response.status == 206) result.resumes++;
+        if (sent && have == size) break;
+
+        int status = response.status;
+        if (status == 503 && fromPeer) {
+            // The peer is fetching the file from the origin: wait as asked
+            uint64_t waitMs = 5000;
+            auto retryAfter = response.headers.find("retry-after");
+            if (retryAfter != response.headers.end()) waitMs = std::clamp<uint64_t>(strtoull(retryAfter->second.c_str(), nullptr, 10) * 1000, 500, 60000);
+            if (waitedMs + waitMs > m_options.peerWaitMs) {
+                result.error = "peer still fetching";
+                return false;
+            }
+            waitedMs += waitMs;
+            SleepUnlessCancelled(waitMs);
+            continue;
+        }
+        if (status == 416 || corrupt) {
+            restart();          // Our partial file does not fit the server's: start clean
+        } else if (status >= 400 && status < 500 && status != 408 && status != 429) {
+            result.error = "HTTP " + std::to_string(status) + " for " + url;
+            return false;
+        } else if (fromPeer && status == 0 && have == before) {
+            result.error = "peer unreachable";
+            return false;
+        }
+
+        if (have > before) {
+            failures = 0;       // Progress: a flaky link, not a dead one
+            delay = m_options.retryDelayMs;
+        } else if (++failures >= m_options.attempts) {
+            result.error = "download failed after " + std::to_string(failures) + " attempts (HTTP " + std::to_string(status) + ")";
+            return false;
+        }
+        SleepUnlessCancelled(delay);
+        delay = std::min(delay * 2, MAX_RETRY_DELAY_MS);
+    }
+    out.close();
+
+    uint8_t digest[Sha256::DIGEST_SIZE];
+    hash.Final(digest);
+    if (ToHex(digest, sizeof(digest)) != ToLowerAscii(sha256)) {
+        fs::remove(partPath, ec);
+        result.error = "checksum mismatch for " + url;
+        return false;
+    }
+    fs::remove(destPath, ec);
+    fs::rename(partPath, destPath, ec);
+    if (ec) {
+        result.error = "cannot rename " + partPath;
+        return false;
+    }
+    result.path = destPath;
+    return true;
+}
+
+static bool IsCachedBlob(const std::string& path, uint64_t size, const std::string& sha256) {
+    std::error_code ec;
+    if (!fs::exists(path, ec) || fs::file_size(path, ec) != size) return false;
+    return Sha256::HashFileHex(path) == sha256;
+}
+
+bool UpdateDownloader::FetchBlob(const std::string& originUrl, uint64_t size, const std::string& sha256,
+                                 UpdateDownloadResult& result) {
+    std::string dest = CachePath(sha256);
+    if (IsCachedBlob(dest, size, sha256)) {
+        result.source = "cache";
+        result.path = dest;
+        return true;
+    }
+    for (std::string peer : m_options.peerUrls) {
+        while (!peer.empty() && peer.back() == '/') peer.pop_back();
+        if (Download(peer + MakePeerPath(sha256, size, originUrl), size, sha256, dest, true, result)) {
+            result.source = "peer";
+            return true;
+        }
+        if (m_cancel) return false;
+    }
+    if (Download(originUrl, size, sha256, dest, false, result)) {
+        result.source = "origin";
+        return true;
+    }
+    return false;
+}
+
+UpdateDownloadResult UpdateDownloader::Fetch(const UpdateManifest& manifest, const std::string& manifestUrl,
+                                             const std::string& name, const std::vector<std::string>& localBases) {
+    UpdateDownloadResult result;
+    const UpdateManifest::File* file = manifest.FindFile(name);
+    if (!file) {
+        result.error = name + " is not in the manifest";
+        return result;
+    }
+    std::string dest = CachePath(file->sha256);
+    if (IsCachedBlob(dest, file->size, file->sha256)) {
+        result.ok = true;
+        result.source = "cache";
+        result.path = dest;
+        return result;
+    }
+
+    // A patch from a version we still have: cached download or local file
+    std::map<std::string, std::string> baseHashes;
+    for (const UpdateManifest::Delta& delta : manifest.deltas) {
+        if (delta.file != name) continue;
+        std::string base;
+        std::string cached = CachePath(delta.baseSha256);
+        std::error_code ec;
+        if (fs::exists(cached, ec) && Sha256::HashFileHex(cached) == delta.baseSha256) {
+            base = cached;
+        } else {
+            for (const std::string& path : localBases) {
+                auto it = baseHashes.find(path);
+                if (it == baseHashes.end()) it = baseHashes.emplace(path, Sha256::HashFileHex(path)).first;
+                if (it->second == delta.baseSha256) { base = path; break; }
+            }
+        }
+        if (base.empty()) continue;
+
+        UpdateDownloadResult patch;
+        bool fetched = FetchBlob(ResolveUrl(manifestUrl, delta.name), delta.size, delta.sha256, patch);
+        result.bytesTransferred += patch.bytesTransferred;
+        result.resumes += patch.resumes;
+        if (!fetched) continue;
+
+        std::string error;
+        bool applied = ApplyBinaryDelta(base, patch.path, dest, &error) && Sha256::HashFileHex(dest) == file->sha256;
+        fs::remove(patch.path, ec);
+        if (applied) {
+            result.ok = true;
+            result.source = "delta";
+            result.path = dest;
+            return result;
+        }
+        fs::remove(dest, ec);
+    }
+
+    UpdateDownloadResult whole;
+    result.ok = FetchBlob(ResolveUrl(manifestUrl, name), file->size, file->sha256, whole);
+    result.bytesTransferred += whole.bytesTransferred;
+    result.resumes += whole.resumes;
+    result.source = whole.source;
+    result.path = whole.path;
+    result.error = whole.error;
+    return result;
+}
+
+void UpdateDownloader::PruneCache(const std::vector<std::string>& keepSha256) {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(m_options.cacheDir, ec)) {
+        std::string name = entry.path().filename().string();
+        std::string sha = name.size() > 5 && name.compare(name.size() - 5, 5, ".part") == 0 ? name.substr(0, name.size() - 5) : name;
+        if (!IsSha256Hex(sha)) continue;    // Not ours
+        if (std::find(keepSha256.begin(), keepSha256.end(), sha) != keepSha256.end()) continue;
+        fs::remove(entry.path(), ec);
+    }
+}
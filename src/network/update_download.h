@@ -0,0 +1,113 @@
+#pragma once
+
+#include "network/http_client.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+// Update manifest, published as update-manifest.txt next to each release's
+// assets (tools/update_tool manifest). One record per line:
+//   micmute-update 1
+//   version <tag>
+//   file <name> <size> <sha256>
+//   delta <file name> <from version> <delta name> <size> <sha256> <base sha256>
+// Names resolve relative to the manifest URL.
+struct UpdateManifest {
+    struct File {
+        std::string name;
+        uint64_t size = 0;
+        std::string sha256;
+    };
+    struct Delta {
+        std::string file;           // Manifest file this patch produces
+        std::string fromVersion;
+        std::string name;
+        uint64_t size = 0;
+        std::string sha256;
+        std::string baseSha256;     // Previous version of the file
+    };
+
+    std::string version;
+    std::vector<File> files;
+    std::vector<Delta> deltas;
+
+    bool Parse(const std::string& text);
+    std::string ToText() const;
+    const File* FindFile(const std::string& name) const;
+};
+
+struct UpdateDownloadOptions {
+    std::string cacheDir;                   // Verified files (<sha256>) and partial downloads (<sha256>.part)
+    std::vector<std::string> peerUrls;      // LAN peer caches (http://host:port), asked before the origin
+    uint64_t peerWaitMs = 10 * 60 * 1000;   // How long to wait while a peer fetches the file itself
+    int attempts = 6;                       // Transfers per source; each one resumes where the last stopped
+    uint64_t retryDelayMs = 2000;           // Doubles after each failed transfer
+    std::function<void(uint64_t done, uint64_t total)> onProgress;
+};
+
+struct UpdateDownloadResult {
+    bool ok = false;
+    std::string path;               // Verified file in the cache
+    std::string source;             // "cache", "delta", "peer" or "origin"
+    uint64_t bytesTransferred = 0;  // Over the network, all attempts
+    int resumes = 0;                // Transfers continued with a Range request
+    std::string error;
+};
+
+// Verified, resumable update downloads.
+//
+// Every file is addressed by its SHA-256 from the manifest. Bytes go
+// straight from the HTTP client's read buffer into <sha256>.part and the
+// running digest; a dropped connection continues with a Range request from
+// the bytes already on disk (also across restarts), and the file is only
+// renamed to <sha256> when size and digest match. Sources are tried
+// cheapest first: the cache, a delta patch from a base we already have,
+// a LAN peer cache, then the origin.
+class UpdateDownloader {
+public:
+    explicit UpdateDownloader(const UpdateDownloadOptions& options, std::unique_ptr<HttpClient> http = nullptr);
+
+    bool FetchManifest(const std::string& url, UpdateManifest& manifest, std::string* error = nullptr);
+
+    // Get file `name` of the manifest into the cache. localBases are other
+    // files that may be a delta base (e.g. the running exe).
+    UpdateDownloadResult Fetch(const UpdateManifest& manifest, const std::string& manifestUrl,
+                               const std::string& name, const std::vector<std::string>& localBases = {});
+
+    // One blob (file or delta) by digest: cache, then peers, then originUrl
+    bool FetchBlob(const std::string& originUrl, uint64_t size, const std::string& sha256,
+                   UpdateDownloadResult& result);
+
+    // Range-resumable download of url to destPath (via destPath.part),
+    // verified against size and sha256
+    bool Download(const std::string& url, uint64_t size, const std::string& sha256,
+                  const std::string& destPath, bool fromPeer, UpdateDownloadResult& result);
+
+    // Delete cached files and partial downloads not listed
+    void PruneCache(const std::vector<std::string>& keepSha256);
+
+    std::string CachePath(const std::string& sha256) const;
+
+    // Abort transfers in progress (from any thread)
+    void Cancel() { m_cancel = true; }
+
+    static std::string ResolveUrl(const std::string& manifestUrl, const std::string& name);
+
+private:
+    bool SleepUnlessCancelled(uint64_t ms);
+
+    UpdateDownloadOptions m_options;
+    std::unique_ptr<HttpClient> m_http;
+    std::atomic<bool> m_cancel{false};
+};
+
+// Peer cache request path for a blob: /update/<sha256>?size=<n>&src=<origin url>
+std::string MakePeerPath(const std::string& sha256, uint64_t size, const std::string& originUrl);
+
+std::string UrlEncodeComponent(const std::string& s);
+std::string UrlDecodeComponent(const std::string& s);
+
+bool IsSha256Hex(const std::string& s);
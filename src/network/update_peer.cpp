@@ -0,0 +1,333 @@
+#include "network/update_peer.h"
+#include "network/update_download.h"
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET SocketHandle;
+typedef int SockLen;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int SocketHandle;
+typedef socklen_t SockLen;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+namespace fs = std::filesystem;
+
+static const int MAX_CONNECTIONS = 32;
+static const int IO_TIMEOUT_MS = 30 * 1000;
+static const uint64_t FAILED_FETCH_HOLD_MS = 60 * 1000;
+static const size_t MAX_REQUEST_HEAD = 8192;
+
+static uint64_t NowMs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool SendAll(SocketHandle s, const char* data, size_t len) {
+    while (len > 0) {
+        int n = send(s, data, (int)(len < 65536 ? len : 65536), 0);
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static void SendSimple(SocketHandle s, int status, const char* reason, const std::string& extraHeaders = "") {
+    std::string head = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n";
+    head += extraHeaders;
+    head += "Content-Length: 0\r\nConnection: close\r\n\r\n";
+    SendAll(s, head.data(), head.size());
+}
+
+static void SetTimeouts(SocketHandle s) {
+#ifdef _WIN32
+    DWORD ms = IO_TIMEOUT_MS;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&ms, sizeof(ms));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char*)&ms, sizeof(ms));
+#else
+    timeval tv;
+    tv.tv_sec = IO_TIMEOUT_MS / 1000;
+    tv.tv_usec = 0;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#endif
+}
+
+std::string UpdatePeerServer::Stats::ToJson() const {
+    std::string json = "{";
+    json += "\"requests\":" + std::to_string(requests);
+    json += ",\"hits\":" + std::to_string(hits);
+    json += ",\"misses\":" + std::to_string(misses);
+    json += ",\"originFetches\":" + std::to_string(originFetches);
+    json += ",\"originFailures\":" + std::to_string(originFailures);
+    json += ",\"bytesServed\":" + std::to_string(bytesServed);
+    json += "}";
+    return json;
+}
+
+UpdatePeerServer::UpdatePeerServer(const std::string& cacheDir, const std::string& allowedOriginPrefix,
+                                   std::unique_ptr<HttpClient> origin)
+    : m_cacheDir(cacheDir), m_allowedPrefix(allowedOriginPrefix) {
+    UpdateDownloadOptions options;
+    options.cacheDir = cacheDir;
+    m_downloader = std::make_unique<UpdateDownloader>(options, std::move(origin));
+}
+
+UpdatePeerServer::~UpdatePeerServer() {
+    Stop();
+}
+
+bool UpdatePeerServer::Start(int port, const std::string& bindAddress) {
+    if (m_running) return true;
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return false;
+#endif
+    SocketHandle s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET) return false;
+
+    int opt = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt, sizeof(opt));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    if (inet_pton(AF_INET, bindAddress.c_str(), &addr.sin_addr) != 1 ||
+        bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, SOMAXCONN) != 0) {
+        closesocket(s);
+        return false;
+    }
+    SockLen len = sizeof(addr);
+    getsockname(s, (sockaddr*)&addr, &len);
+    m_port = ntohs(addr.sin_port);
+
+    m_listen = (intptr_t)s;
+    m_running = true;
+    m_acceptThread = std::thread(&UpdatePeerServer::AcceptLoop, this);
+    return true;
+}
+
+void UpdatePeerServer::Stop() {
+    if (!m_running) return;
+    m_running = false;
+    m_downloader->Cancel();
+    if (m_acceptThread.joinable()) m_acceptThread.join();
+    closesocket((SocketHandle)m_listen);
+    m_listen = -1;
+
+    std::vector<std::thread> fetches;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_connections == 0; });
+        fetches.swap(m_fetchThreads);
+    }
+    for (auto& t : fetches) t.join();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+UpdatePeerServer::Stats UpdatePeerServer::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void UpdatePeerServer::AcceptLoop() {
+    SocketHandle listenSocket = (SocketHandle)m_listen;
+    while (m_running) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(listenSocket, &readSet);
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 200 * 1000;
+        if (select((int)listenSocket + 1, &readSet, nullptr, nullptr, &timeout) <= 0) continue;
+
+        SocketHandle client = accept(listenSocket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_connections >= MAX_CONNECTIONS) {
+                SendSimple(client, 503, "Service Unavailable", "Retry-After: 5\r\n");
+                closesocket(client);
+                continue;
+            }
+            m_connections++;
+        }
+        std::thread([this, client] {
+            HandleConnection((intptr_t)client);
+            closesocket(client);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_connections == 0) m_idle.notify_all();
+        }).detach();
+    }
+}
+
+void UpdatePeerServer::HandleConnection(intptr_t clientHandle) {
+    SocketHandle client = (SocketHandle)clientHandle;
+    SetTimeouts(client);
+
+    std::string head;
+    char buf[2048];
+    while (head.find("\r\n\r\n") == std::string::npos) {
+        int n = recv(client, buf, sizeof(buf), 0);
+        if (n <= 0 || head.size() + (size_t)n > MAX_REQUEST_HEAD) return;
+        head.append(buf, (size_t)n);
+    }
+
+    size_t lineEnd = head.find("\r\n");
+    std::string requestLine = head.substr(0, lineEnd);
+    size_t sp1 = requestLine.find(' ');
+    size_t sp2 = requestLine.find(' ', sp1 + 1);
+    if (sp1 == std::string::npos || sp2 == std::string::npos) return SendSimple(client, 400, "Bad Request");
+    std::string method = requestLine.substr(0, sp1);
+    std::string target = requestLine.substr(sp1 + 1, sp2 - sp1 - 1);
+
+    std::string range;
+    size_t pos = lineEnd + 2;
+    while (pos < head.size()) {
+        size_t eol = head.find("\r\n", pos);
+        if (eol == std::string::npos || eol == pos) break;
+        std::string line = head.substr(pos, eol - pos);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string name = line.substr(0, colon);
+            for (auto& c : name) c = (char)tolower((unsigned char)c);
+            if (name == "range") {
+                range = line.substr(colon + 1);
+                range.erase(0, range.find_first_not_of(' '));
+            }
+        }
+        pos = eol + 2;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.requests++;
+    }
+    if (method != "GET") return SendSimple(client, 405, "Method Not Allowed");
+
+    // /update/<sha256>?size=<n>&src=<url>
+    std::string path = target.substr(0, target.find('?'));
+    std::string query = target.size() > path.size() ? target.substr(path.size() + 1) : "";
+    const std::string prefix = "/update/";
+    if (path.compare(0, prefix.size(), prefix) != 0) return SendSimple(client, 404, "Not Found");
+    std::string sha = path.substr(prefix.size());
+    if (!IsSha256Hex(sha)) return SendSimple(client, 404, "Not Found");
+    for (auto& c : sha) c = (char)tolower((unsigned char)c);
+
+    std::string cached = (fs::path(m_cacheDir) / sha).string();
+    std::error_code ec;
+    if (fs::is_regular_file(cached, ec)) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.hits++;
+        }
+        return ServeFile(client, cached, range);
+    }
+
+    uint64_t size = 0;
+    std::string src;
+    size_t start = 0;
+    while (start < query.size()) {
+        size_t amp = query.find('&', start);
+        std::string param = query.substr(start, amp == std::string::npos ? std::string::npos : amp - start);
+        size_t eq = param.find('=');
+        if (eq != std::string::npos) {
+            std::string key = param.substr(0, eq);
+            std::string value = UrlDecodeComponent(param.substr(eq + 1));
+            if (key == "size") size = strtoull(value.c_str(), nullptr, 10);
+            else if (key == "src") src = value;
+        }
+        if (amp == std::string::npos) break;
+        start = amp + 1;
+    }
+    // Only fetch on behalf of a seat from where updates are published
+    if (src.empty() || size == 0 || m_allowedPrefix.empty() ||
+        src.compare(0, m_allowedPrefix.size(), m_allowedPrefix) != 0) {
+        return SendSimple(client, 404, "Not Found");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto failed = m_failedAt.find(sha);
+        if (failed != m_failedAt.end() && NowMs() - failed->second < FAILED_FETCH_HOLD_MS) {
+            return SendSimple(client, 404, "Not Found");
+        }
+        m_stats.misses++;
+    }
+    StartOriginFetch(sha, size, src);
+    SendSimple(client, 503, "Service Unavailable", "Retry-After: 2\r\n");
+}
+
+void UpdatePeerServer::ServeFile(intptr_t clientHandle, const std::string& path, const std::string& rangeHeader) {
+    SocketHandle client = (SocketHandle)clientHandle;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return SendSimple(client, 404, "Not Found");
+    uint64_t size = (uint64_t)file.tellg();
+
+    // Only "bytes=<first>-" is asked for by the downloader
+    uint64_t first = 0;
+    bool partial = rangeHeader.compare(0, 6, "bytes=") == 0;
+    if (partial) {
+        first = strtoull(rangeHeader.c_str() + 6, nullptr, 10);
+        if (first >= size) {
+            return SendSimple(client, 416, "Range Not Satisfiable", "Content-Range: bytes */" + std::to_string(size) + "\r\n");
+        }
+    }
+
+    std::string head = partial ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+    if (partial) head += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(size - 1) + "/" + std::to_string(size) + "\r\n";
+    head += "Content-Type: application/octet-stream\r\n";
+    head += "Content-Length: " + std::to_string(size - first) + "\r\n";
+    head += "Connection: close\r\n\r\n";
+    if (!SendAll(client, head.data(), head.size())) return;
+
+    file.seekg((std::streamoff)first);
+    std::vector<char> buffer(HTTP_READ_CHUNK);
+    uint64_t sent = 0;
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        std::streamsize n = file.gcount();
+        if (n <= 0 || !SendAll(client, buffer.data(), (size_t)n)) break;
+        sent += (uint64_t)n;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytesServed += sent;
+}
+
+void UpdatePeerServer::StartOriginFetch(const std::string& sha256, uint64_t size, const std::string& url) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running || !m_fetching.insert(sha256).second) return;     // Already on its way
+    m_stats.originFetches++;
+    m_fetchThreads.emplace_back([this, sha256, size, url] {
+        UpdateDownloadResult result;
+        bool ok = m_downloader->FetchBlob(url, size, sha256, result);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fetching.erase(sha256);
+        if (!ok) {
+            m_stats.originFailures++;
+            m_failedAt[sha256] = NowMs();
+        }
+    });
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "network/http_client.h"
+#include <string>
+#include <set>
+#include <map>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+class UpdateDownloader;
+
+// LAN peer cache for update downloads.
+//
+// One seat per subnet runs this next to its own update cache; the others
+// list it as a peer (UpdateDownloadOptions::peerUrls) and ask it first:
+//
+//   GET /update/<sha256>?size=<n>&src=<origin url>
+//
+// A cached, verified blob is served with Range support. On a miss the peer
+// starts a single download from src (only URLs under allowedOriginPrefix)
+// and answers 503 + Retry-After until it is in the cache, so a whole floor
+// updating at once costs one origin download. A failed origin fetch answers
+// 404 for a minute and seats fall back to the origin themselves.
+class UpdatePeerServer {
+public:
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t hits = 0;              // Served from the cache
+        uint64_t misses = 0;            // Answered 503 while fetching
+        uint64_t originFetches = 0;
+        uint64_t originFailures = 0;
+        uint64_t bytesServed = 0;
+        std::string ToJson() const;
+    };
+
+    UpdatePeerServer(const std::string& cacheDir, const std::string& allowedOriginPrefix,
+                     std::unique_ptr<HttpClient> origin = nullptr);
+    ~UpdatePeerServer();
+
+    // port 0 picks a free port (see GetPort)
+    bool Start(int port, const std::string& bindAddress = "0.0.0.0");
+    void Stop();
+    int GetPort() const { return m_port; }
+    Stats GetStats() const;
+
+private:
+    void AcceptLoop();
+    void HandleConnection(intptr_t client);
+    void ServeFile(intptr_t client, const std::string& path, const std::string& rangeHeader);
+    void StartOriginFetch(const std::string& sha256, uint64_t size, const std::string& url);
+
+    std::string m_cacheDir;
+    std::string m_allowedPrefix;
+    std::unique_ptr<UpdateDownloader> m_downloader;
+
+    intptr_t m_listen = -1;
+    int m_port = 0;
+    std::atomic<bool> m_running{false};
+    std::thread m_acceptThread;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_idle;
+    int m_connections = 0;
+    std::set<std::string> m_fetching;
+    std::map<std::string, uint64_t> m_failedAt;     // sha256 -> steady ms
+    std::vector<std::thread> m_fetchThreads;
+    Stats m_stats;
+};
@@ -1,15 +1,20 @@
 #include "network/updater.h"
+#include "network/http_client.h"
+#include "network/update_download.h"
+#include "network/update_peer.h"
 #include "core/globals.h"
-#include <winhttp.h>
+#include "core/json.h"
+#include "core/resource.h"
 #include <iostream>
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <memory>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
 
-#pragma comment(lib, "winhttp.lib")
 #pragma comment(lib, "version.lib")
 
 namespace AutoUpdater {
@@ -17,6 +22,14 @@ namespace AutoUpdater {
     static HWND hParent = nullptr;
     static std::atomic<UpdateStatus> currentStatus = UpdateStatus::None;
     static bool isCheckSilent = false;
+
+    // Assets are only fetched on a seat's behalf from this project's releases
+    static const char* RELEASE_DOWNLOAD_PREFIX = "https://github.com/suvojeet-sengupta/MicMute/releases/download/";
+    static const int UPDATE_PEER_PORT = 9877;
+
+    static std::mutex stateMutex;
+    static std::unique_ptr<UpdatePeerServer> peerServer;
+    static std::string lastDownloadJson = "null";
     
     // Simple JSON Value parser (minimal for extraction)
     // We only need tag_name, body, assets array
@@ -25,11 +38,12 @@ namespace AutoUpdater {
         std::string body;
         std::string installerUrl;
         std::string portableUrl;
+        std::string manifestUrl;    // update-manifest.txt (sizes, digests, deltas)
         bool valid = false;
     };
 
     // Forward declarations
-    std::string MakeHttpRequest(const std::wstring& domain, const std::wstring& path);
+    std::string MakeHttpRequest(const std::string& url);
     ReleaseInfo ParseGitHubRelease(const std::string& json);
     bool IsVersionNewer(const std::string& current, const std::string& latest);
     bool IsPortableMode();
@@ -46,10 +60,7 @@ namespace AutoUpdater {
         
         std::thread([]() {
             // GitHub API
-            std::wstring domain = L"api.github.com";
-            std::wstring path = L"/repos/suvojeet-sengupta/MicMute/releases/latest";
-            
-            std::string json = MakeHttpRequest(domain, path);
+            std::string json = MakeHttpRequest("https://api.github.com/repos/suvojeet-sengupta/MicMute/releases/latest");
             
             if (json.empty()) {
                 currentStatus = UpdateStatus::Error;
@@ -98,7 +109,7 @@ namespace AutoUpdater {
                     
                     // Trigger update (simple blocking for now, ideally shows progress dialog)
                     // For now, let's just create a thread detached to download/run
-                    PerformUpdate(url, !portable, [](int p){}); 
+                    PerformUpdate(url, info.manifestUrl, !portable, [](int p){}); 
                 }
             } else {
                 currentStatus = UpdateStatus::UpToDate;
@@ -112,52 +123,17 @@ namespace AutoUpdater {
     
     // --- Helper Implementation ---
 
-    // Basic WinHTTP Request
-    std::string MakeHttpRequest(const std::wstring& domain, const std::wstring& path) {
-        HINTERNET hSession = WinHttpOpen(L"MicMute-Updater/1.0",
-                                         WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                                         WINHTTP_NO_PROXY_NAME,
-                                         WINHTTP_NO_PROXY_BYPASS, 0);
-        if (!hSession) return "";
-
-        HINTERNET hConnect = WinHttpConnect(hSession, domain.c_str(), INTERNET_DEFAULT_HTTPS_PORT, 0);
-        if (!hConnect) { WinHttpCloseHandle(hSession); return ""; }
+    // Small GET (release metadata, manifest); empty on failure
+    std::string MakeHttpRequest(const std::string& url) {
+        HttpRequest request;
+        int port = 0;
+        if (!ParseHttpUrl(url, request.scheme, request.host, port, request.path)) return "";
+        request.port = port;
+        request.headers.push_back({"User-Agent", "MicMute-Updater/1.0"});
 
-        HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", path.c_str(),
-                                                NULL, WINHTTP_NO_REFERER,
-                                                WINHTTP_DEFAULT_ACCEPT_TYPES,
-                                                WINHTTP_FLAG_SECURE);
-        if (!hRequest) { WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return ""; }
-
-        bool result = WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-                                         WINHTTP_NO_REQUEST_DATA, 0, 0, 0);
-        
-        if (result) {
-            result = WinHttpReceiveResponse(hRequest, NULL);
-        }
-        
-        std::string response;
-        if (result) {
-            DWORD dwSize = 0;
-            DWORD dwDownloaded = 0;
-            do {
-                dwSize = 0;
-                if (!WinHttpQueryDataAvailable(hRequest, &dwSize)) break;
-                if (!dwSize) break;
-                
-                std::vector<char> buffer(dwSize + 1);
-                if (WinHttpReadData(hRequest, buffer.data(), dwSize, &dwDownloaded)) {
-                     buffer[dwDownloaded] = 0;
-                     response.append(buffer.data());
-                }
-            } while (dwSize > 0);
-        }
-
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        
-        return response;
+        HttpResponse response;
+        if (!CreateHttpClient()->Send(request, response) || response.status != 200) return "";
+        return response.body;
     }
     
     // Very naive JSON parser to avoid external deps
@@ -191,7 +167,8 @@ namespace AutoUpdater {
         }
         
         // Find assets
-        // We look for .exe (installer) and .zip (portable)
+        // Setup .exe (installer), plain .exe or .zip (portable), the update
+        // manifest; delta patches are only reached through the manifest
         // Check for "browser_download_url"
         size_t currentPos = 0;
         while (true) {
@@ -201,14 +178,19 @@ namespace AutoUpdater {
             size_t start = json.find("\"", urlPos + 22) + 1;
             size_t end = json.find("\"", start);
             std::string url = json.substr(start, end - start);
+            std::string name = url.substr(url.find_last_of('/') + 1);
+            for (auto& c : name) c = (char)tolower((unsigned char)c);
             
-            if (url.find(".exe") != std::string::npos && url.find("setup") != std::string::npos) {
+            if (name == "update-manifest.txt") {
+                info.manifestUrl = url;
+            } else if (name.find(".delta") != std::string::npos || name.find("extension") != std::string::npos) {
+                // Patch or browser extension, not an update by itself
+            } else if (name.find(".exe") != std::string::npos && name.find("setup") != std::string::npos) {
                 info.installerUrl = url;
-            } else if (url.find("portable") != std::string::npos || url.find(".zip") != std::string::npos) {
-                 info.portableUrl = url;
-            } else if (url.find(".exe") != std::string::npos) {
-                // Fallback: any exe might be it
-                if (info.installerUrl.empty()) info.installerUrl = url;
+            } else if (name.find(".exe") != std::string::npos || name.find("portable") != std::string::npos) {
+                info.portableUrl = url;
+            } else if (name.find(".zip") != std::string::npos) {
+                if (info.portableUrl.empty()) info.portableUrl = url;
             }
             
             currentPos = end;
@@ -258,69 +240,54 @@ namespace AutoUpdater {
         return true;
     }
     
-    // Download File Helper
-    bool DownloadFile(const std::string& url, const std::string& destPath) {
-        std::wstring wUrl(url.begin(), url.end());
-        
-        URL_COMPONENTS urlComp = {0};
-        urlComp.dwStructSize = sizeof(urlComp);
-        urlComp.dwHostNameLength = 1;
-        urlComp.dwUrlPathLength = 1;
-        urlComp.dwSchemeLength = 1;
-        
-        if (!WinHttpCrackUrl(wUrl.c_str(), (DWORD)wUrl.length(), 0, &urlComp)) return false;
-        
-        std::wstring hostName(urlComp.lpszHostName, urlComp.dwHostNameLength);
-        std::wstring urlPath(urlComp.lpszUrlPath, urlComp.dwUrlPathLength);
-        
-        HINTERNET hSession = WinHttpOpen(L"MicMute-Updater/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
-        if (!hSession) return false;
-        
-        HINTERNET hConnect = WinHttpConnect(hSession, hostName.c_str(), INTERNET_DEFAULT_HTTPS_PORT, 0);
-        if (!hConnect) { WinHttpCloseHandle(hSession); return false; }
-        
-        HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", urlPath.c_str(), NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
-        if (!hRequest) { WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false; }
-        
-        if (!WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
-        }
-        
-        if (!WinHttpReceiveResponse(hRequest, NULL)) {
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
-        }
-        
-        std::ofstream outfile(destPath, std::ios::binary);
-        if (!outfile.is_open()) {
-             WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
-        }
-        
-        DWORD dwSize = 0;
-        DWORD dwDownloaded = 0;
-        do {
-            dwSize = 0;
-            if (!WinHttpQueryDataAvailable(hRequest, &dwSize)) break;
-            if (!dwSize) break;
-            
-            std::vector<char> buffer(dwSize);
-            if (WinHttpReadData(hRequest, buffer.data(), dwSize, &dwDownloaded)) {
-                 outfile.write(buffer.data(), dwDownloaded);
-            }
-        } while (dwSize > 0);
-        
+    std::string GetUpdateCacheDir() {
+        char base[MAX_PATH];
+        DWORD len = GetEnvironmentVariable("LOCALAPPDATA", base, MAX_PATH);
+        if (len == 0 || len >= MAX_PATH) GetTempPath(MAX_PATH, base);
+        std::string dir = base;
+        if (!dir.empty() && dir.back() != '\\') dir += '\\';
+        return dir + "MicMute-S\\updates";
+    }
+
+    // Releases published before update-manifest.txt: nothing to verify
+    // against, so a plain streamed download
+    static bool DownloadUnverified(const std::string& url, const std::string& destPath) {
+        HttpRequest request;
+        int port = 0;
+        if (!ParseHttpUrl(url, request.scheme, request.host, port, request.path)) return false;
+        request.port = port;
+        std::ofstream outfile(destPath, std::ios::binary | std::ios::trunc);
+        if (!outfile.is_open()) return false;
+        request.onBody = [&outfile](const char* data, size_t len) {
+            outfile.write(data, (std::streamsize)len);
+            return outfile.good();
+        };
+        HttpResponse response;
+        bool ok = CreateHttpClient()->Send(request, response) && response.status == 200;
         outfile.close();
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        
-        return true;
+        return ok && outfile.good();
+    }
+
+    static void RecordDownload(const std::string& name, const UpdateDownloadResult& result) {
+        std::string json = "{";
+        json += "\"file\":\"" + JsonEscape(name) + "\"";
+        json += ",\"ok\":" + std::string(result.ok ? "true" : "false");
+        json += ",\"source\":\"" + JsonEscape(result.source) + "\"";
+        json += ",\"bytesTransferred\":" + std::to_string(result.bytesTransferred);
+        json += ",\"resumes\":" + std::to_string(result.resumes);
+        json += ",\"error\":\"" + JsonEscape(result.error) + "\"";
+        json += "}";
+        std::lock_guard<std::mutex> lock(stateMutex);
+        lastDownloadJson = json;
     }
 
-    void PerformUpdate(const std::string& downloadUrl, bool isInstaller, ProgressCallback onProgress) {
+    void PerformUpdate(const std::string& downloadUrl, const std::string& manifestUrl, bool isInstaller, ProgressCallback onProgress) {
         // Create temp file path
         char tempPath[MAX_PATH];
         GetTempPath(MAX_PATH, tempPath);
-        std::string updateFile = std::string(tempPath) + (isInstaller ? "MicMuteUpdate.exe" : "MicMuteUpdate.zip");
+        std::string name = downloadUrl.substr(downloadUrl.find_last_of('/') + 1);
+        bool isZip = name.size() > 4 && _stricmp(name.c_str() + name.size() - 4, ".zip") == 0;
+        std::string updateFile = std::string(tempPath) + (isInstaller ? "MicMuteUpdate.exe" : (isZip ? "MicMuteUpdate.zip" : "MicMuteUpdate.new"));
         
         // Get our own exe path for restart logic
         char exePath[MAX_PATH];
@@ -328,7 +295,38 @@ namespace AutoUpdater {
         std::string currentExe = exePath;
         std::string currentDir = std::filesystem::path(exePath).parent_path().string();
         
-        if (DownloadFile(downloadUrl, updateFile)) {
+        // Verified, resumable download into the update cache: a delta from
+        // the running exe or the previous download when the release has
+        // one, the LAN peer cache if configured, otherwise the release host
+        bool downloaded = false;
+        UpdateManifest manifest;
+        UpdateDownloadOptions options;
+        options.cacheDir = GetUpdateCacheDir();
+        if (!updatePeerUrl.empty()) options.peerUrls.push_back(updatePeerUrl);
+        options.onProgress = [onProgress](uint64_t done, uint64_t total) {
+            if (onProgress && total) onProgress((int)(done * 100 / total));
+        };
+        UpdateDownloader downloader(options);
+        std::string error;
+        if (!manifestUrl.empty() && downloader.FetchManifest(manifestUrl, manifest, &error)) {
+            UpdateDownloadResult result = downloader.Fetch(manifest, manifestUrl, name, {currentExe});
+            RecordDownload(name, result);
+            if (result.ok) {
+                // Keep this release's files: the base for the next delta
+                std::vector<std::string> keep;
+                for (const auto& f : manifest.files) keep.push_back(f.sha256);
+                for (const auto& d : manifest.deltas) keep.push_back(d.sha256);
+                downloader.PruneCache(keep);
+                downloaded = CopyFile(result.path.c_str(), updateFile.c_str(), FALSE) != FALSE;
+            } else {
+                OutputDebugStringA(("Update download failed: " + result.error + "\n").c_str());
+            }
+        } else {
+            if (!manifestUrl.empty()) OutputDebugStringA(("Update manifest: " + error + "\n").c_str());
+            downloaded = DownloadUnverified(downloadUrl, updateFile);
+        }
+        
+        if (downloaded) {
             if (isInstaller) {
                 // Create a batch script that waits for installer to finish, then restarts MicMute
                 std::string batPath = std::string(tempPath) + "micmute_update_restart.bat";
@@ -345,27 +343,71 @@ namespace AutoUpdater {
                 bat.close();
                 
                 ShellExecute(NULL, "open", batPath.c_str(), NULL, NULL, SW_HIDE);
-                PostQuitMessage(0);
             } else {
                 // Portable update logic
                 std::string batPath = currentDir + "\\update.bat";
                 std::ofstream bat(batPath);
                 
                 bat << "@echo off\n";
-                bat << "timeout /t 2 /nobreak > NUL\n"; // Wait for app close
-                bat << "powershell -command \"Expand-Archive -Path '" << updateFile << "' -DestinationPath '" << currentDir << "' -Force\"\n";
+                if (isZip) {
+                    bat << "timeout /t 2 /nobreak > NUL\n"; // Wait for app close
+                    bat << "powershell -command \"Expand-Archive -Path '" << updateFile << "' -DestinationPath '" << currentDir << "' -Force\"\n";
+                } else {
+                    // Replace the exe once the app has let go of it
+                    bat << "set tries=0\n";
+                    bat << ":replace\n";
+                    bat << "timeout /t 2 /nobreak > NUL\n";
+                    bat << "copy /y \"" << updateFile << "\" \"" << currentExe << "\" > NUL && goto started\n";
+                    bat << "set /a tries+=1\n";
+                    bat << "if %tries% lss 10 goto replace\n";
+                    bat << ":started\n";
+                    bat << "del \"" << updateFile << "\"\n";
+                }
                 bat << "start \"\" \"" << exePath << "\"\n";
                 bat << "del \"%~f0\" & exit\n";
                 bat.close();
                 
                 // Run batch and exit
                 ShellExecute(NULL, "open", batPath.c_str(), NULL, NULL, SW_HIDE);
-                PostQuitMessage(0);
             }
+            // We are on the update thread: exit through the tray menu path
+            PostMessage(hParent, WM_COMMAND, ID_TRAY_EXIT, 0);
         } else {
             MessageBox(hParent, "Download failed.", "Update Error", MB_ICONERROR);
         }
     }
 
+    void SetPeerCacheEnabled(bool enabled) {
+        std::unique_ptr<UpdatePeerServer> stopped;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (enabled == (peerServer != nullptr)) return;
+            if (!enabled) {
+                stopped = std::move(peerServer);
+            } else {
+                auto server = std::make_unique<UpdatePeerServer>(GetUpdateCacheDir(), RELEASE_DOWNLOAD_PREFIX);
+                if (server->Start(UPDATE_PEER_PORT)) {
+                    peerServer = std::move(server);
+                } else {
+                    OutputDebugStringA("Update peer cache not started: port 9877 unavailable\n");
+                }
+            }
+        }
+        if (stopped) stopped->Stop();     // Outside the lock: waits for transfers
+    }
+
+    std::string GetStatusJson() {
+        static const char* names[] = {"none", "checking", "upToDate", "updateAvailable", "error"};
+        std::lock_guard<std::mutex> lock(stateMutex);
+        std::string json = "{";
+        json += "\"status\":\"" + std::string(names[(int)currentStatus.load()]) + "\"";
+        json += ",\"cacheDir\":\"" + JsonEscape(GetUpdateCacheDir()) + "\"";
+        json += ",\"peerUrl\":\"" + JsonEscape(updatePeerUrl) + "\"";
+        json += ",\"lastDownload\":" + lastDownloadJson;
+        json += ",\"peerCache\":" + (peerServer ? peerServer->GetStats().ToJson() : std::string("null"));
+        json += "}";
+        return json;
+    }
+
     UpdateStatus GetCurrentStatus() { return currentStatus; }
 }
@@ -27,8 +27,19 @@ namespace AutoUpdater {
     // Perform update
     // If installer: downloads and runs installer (silent)
     // If portable: downloads zip/exe and replaces via batch script
-    void PerformUpdate(const std::string& downloadUrl, bool isInstaller, ProgressCallback onProgress);
+    // With a manifestUrl the download is resumable, verified against the
+    // manifest digest and uses a delta patch when one applies
+    void PerformUpdate(const std::string& downloadUrl, const std::string& manifestUrl, bool isInstaller, ProgressCallback onProgress);
 
     // Get latest status
     UpdateStatus GetCurrentStatus();
+
+    // %LOCALAPPDATA%\MicMute-S\updates: verified downloads by SHA-256
+    std::string GetUpdateCacheDir();
+
+    // Serve the update cache to other seats on the LAN (port 9877)
+    void SetPeerCacheEnabled(bool enabled);
+
+    // Status, last download (source, bytes, resumes) and peer cache counters
+    std::string GetStatusJson();
 }
@@ -0,0 +1,509 @@
+#include "network/upload_queue.h"
+#include "audio/WavMetadata.h"
+#include "core/sha256.h"
+#include "core/thread_pool.h"
+#include "core/json.h"
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const int PART_ATTEMPTS = 3;
+static const uint64_t MAX_BACKOFF_MS = 5 * 60 * 1000;
+
+static uint64_t NowMs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string UploadStatus::ToJson() const {
+    std::string json = "{";
+    json += "\"pending\":" + std::to_string(pending);
+    json += ",\"completed\":" + std::to_string(completed);
+    json += ",\"failed\":" + std::to_string(failed);
+    json += ",\"bytesSent\":" + std::to_string(bytesSent);
+    json += ",\"throttled\":" + std::string(throttled ? "true" : "false");
+    json += ",\"current\":\"" + JsonEscape(current) + "\"";
+    json += ",\"lastError\":\"" + JsonEscape(lastError) + "\"";
+    json += "}";
+    return json;
+}
+
+// ============================================================================
+// TokenBucket
+// ============================================================================
+
+void TokenBucket::SetRate(uint64_t bytesPerSec, bool paused) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rate = bytesPerSec;
+    m_paused = paused;
+    if (m_tokens > (double)bytesPerSec) m_tokens = (double)bytesPerSec;
+}
+
+void TokenBucket::Acquire(size_t n, const std::atomic<bool>& stop) {
+    while (!stop) {
+        uint64_t waitMs;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_paused && m_rate == 0) return; // Unlimited
+
+            uint64_t now = NowMs();
+            if (!m_paused) {
+                // Capacity of one second of traffic (or one chunk, if larger)
+                double capacity = (double)std::max<uint64_t>(m_rate, n);
+                if (m_lastRefillMs != 0) {
+                    m_tokens = std::min(capacity, m_tokens + (now - m_lastRefillMs) * (double)m_rate / 1000.0);
+                }
+                if (m_tokens >= (double)n) {
+                    m_tokens -= (double)n;
+                    m_lastRefillMs = now;
+                    return;
+                }
+                waitMs = (uint64_t)(((double)n - m_tokens) * 1000.0 / (double)m_rate) + 1;
+            } else {
+                waitMs = 100;
+            }
+            m_lastRefillMs = now;
+        }
+        // Short slices so a rate change (call ended) takes effect quickly
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::min<uint64_t>(waitMs, 100)));
+    }
+}
+
+// ============================================================================
+// UploadQueue
+// ============================================================================
+
+UploadQueue::~UploadQueue() {
+    Stop();
+}
+
+bool UploadQueue::Start(const std::string& journalPath, const UploadSettings& settings,
+                        std::unique_ptr<HttpClient> http) {
+    if (m_running) return false;
+    if (!settings.s3.IsValid()) return false;
+
+    m_settings = settings;
+    m_settings.partSize = std::max<uint64_t>(m_settings.partSize, 5 * 1024 * 1024);
+    m_settings.parallelParts = std::max(1, std::min(m_settings.parallelParts, 16));
+    m_s3 = std::make_unique<S3Client>(m_settings.s3, http ? std::move(http) : CreateHttpClient());
+    if (!m_s3->IsValid()) {
+        m_s3.reset();
+        return false;
+    }
+
+    m_journalPath = journalPath;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.clear();
+        m_status = UploadStatus();
+    }
+    LoadJournal();
+    CompactJournal();
+    {
+        std::lock_guard<std::mutex> lock(m_journalMutex);
+        m_journal.open(m_journalPath, std::ios::app);
+    }
+
+    UpdateThrottle();
+    m_stop = false;
+    m_running = true;
+    m_thread = std::thread(&UploadQueue::WorkerLoop, this);
+    return true;
+}
+
+void UploadQueue::Stop() {
+    if (!m_running) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+
+    std::lock_guard<std::mutex> lock(m_journalMutex);
+    m_journal.close();
+    m_running = false;
+}
+
+bool UploadQueue::Enqueue(const std::string& filePath) {
+    if (!m_running) return false;
+
+    fs::path p(filePath);
+    std::string key = p.parent_path().filename().string() + "/" + p.filename().string();
+    if (!m_settings.keyPrefix.empty()) key = m_settings.keyPrefix + "/" + key;
+
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& job : m_jobs) {
+            if (job.path == filePath) return true;
+        }
+        Job job;
+        job.id = id = m_nextId++;
+        job.path = filePath;
+        job.key = key;
+        m_jobs.push_back(job);
+        m_status.pending = m_jobs.size();
+    }
+    AppendJournal("A " + std::to_string(id) + " " + key + "\t" + filePath);
+    m_cv.notify_all();
+    return true;
+}
+
+void UploadQueue::BeginCapture() {
+    m_captureCount++;
+    UpdateThrottle();
+}
+
+void UploadQueue::EndCapture() {
+    // Never below zero, even when two unmatched calls race
+    int count = m_captureCount.load();
+    while (count > 0 && !m_captureCount.compare_exchange_weak(count, count - 1)) {}
+    UpdateThrottle();
+}
+
+void UploadQueue::UpdateThrottle() {
+    bool capturing = m_captureCount > 0;
+    uint64_t rate = capturing ? m_settings.captureBytesPerSec : m_settings.maxBytesPerSec;
+    bool paused = capturing && m_settings.captureBytesPerSec == 0;
+    m_bucket.SetRate(rate, paused);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_status.throttled = capturing;
+}
+
+UploadStatus UploadQueue::GetStatus() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    UploadStatus status = m_status;
+    status.pending = m_jobs.size() + (m_status.current.empty() ? 0 : 1);
+    return status;
+}
+
+void UploadQueue::SetError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_status.lastError = error;
+}
+
+// ============================================================================
+// Journal
+// ============================================================================
+
+void UploadQueue::AppendJournal(const std::string& line) {
+    std::lock_guard<std::mutex> lock(m_journalMutex);
+    if (!m_journal.is_open()) return;
+    m_journal << line << '\n';
+    m_journal.flush();
+}
+
+void UploadQueue::LoadJournal() {
+    std::ifstream in(m_journalPath);
+    if (!in) return;
+
+    std::map<uint64_t, Job> jobs;
+    uint64_t maxId = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.size() < 3 || line[1] != ' ') continue;
+        char op = line[0];
+        char* end = nullptr;
+        uint64_t id = strtoull(line.c_str() + 2, &end, 10);
+        if (id == 0 || !end) continue;
+        std::string rest = *end == ' ' ? std::string(end + 1) : std::string();
+        maxId = std::max(maxId, id);
+
+        if (op == 'A') {
+            size_t tab = rest.find('\t');
+            if (tab == std::string::npos) continue;
+            Job& job = jobs[id];
+            job.id = id;
+            job.key = rest.substr(0, tab);
+            job.path = rest.substr(tab + 1);
+            continue;
+        }
+
+        auto it = jobs.find(id);
+        if (it == jobs.end()) continue; // Partial write of a compacted job
+        Job& job = it->second;
+        switch (op) {
+            case 'S': job.sha256 = rest; break;
+            case 'U': job.uploadId = rest; job.etags.clear(); break;
+            case 'P': {
+                size_t space = rest.find(' ');
+                if (space != std::string::npos) job.etags[atoi(rest.c_str())] = rest.substr(space + 1);
+                break;
+            }
+            case 'C': job.objectDone = true; break;
+            case 'R': job.uploadId.clear(); job.etags.clear(); break;
+            case 'D':
+            case 'X': jobs.erase(it); break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& kv : jobs) m_jobs.push_back(std::move(kv.second));
+    m_nextId = maxId + 1;
+    m_status.pending = m_jobs.size();
+}
+
+// Rewrite the journal with only the live jobs so it doesn't grow forever
+void UploadQueue::CompactJournal() {
+    std::string tmpPath = m_journalPath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out) return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& job : m_jobs) {
+            std::string id = std::to_string(job.id);
+            out << "A " << id << " " << job.key << "\t" << job.path << '\n';
+            if (!job.sha256.empty()) out << "S " << id << " " << job.sha256 << '\n';
+            if (!job.uploadId.empty()) out << "U " << id << " " << job.uploadId << '\n';
+            for (const auto& part : job.etags) out << "P " << id << " " << part.first << " " << part.second << '\n';
+            if (job.objectDone) out << "C " << id << '\n';
+        }
+        if (!out.good()) return;
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, m_journalPath, ec);
+    if (ec) fs::remove(tmpPath, ec);
+}
+
+// ============================================================================
+// Worker
+// ============================================================================
+
+void UploadQueue::WorkerLoop() {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#endif
+
+    while (!m_stop) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+            if (m_stop) break;
+
+            // Earliest job whose backoff has expired
+            uint64_t now = NowMs();
+            auto ready = std::min_element(m_jobs.begin(), m_jobs.end(), [](const Job& a, const Job& b) {
+                return a.nextAttemptMs < b.nextAttemptMs;
+            });
+            if (ready->nextAttemptMs > now) {
+                m_cv.wait_for(lock, std::chrono::milliseconds(ready->nextAttemptMs - now));
+                continue;
+            }
+            job = std::move(*ready);
+            m_jobs.erase(ready);
+            m_status.current = job.path;
+        }
+
+        bool done = ProcessJob(job);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_status.current.clear();
+        if (done) {
+            m_status.completed++;
+        } else {
+            if (!m_stop) {
+                m_status.failed++;
+                job.attempts++;
+            }
+            uint64_t backoff = std::min<uint64_t>(1000ull << std::min(job.attempts, 16), MAX_BACKOFF_MS);
+            job.nextAttemptMs = NowMs() + backoff;
+            m_jobs.push_back(std::move(job));
+        }
+        m_status.pending = m_jobs.size();
+    }
+
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+#endif
+}
+
+bool UploadQueue::ProcessJob(Job& job) {
+    std::string id = std::to_string(job.id);
+
+    std::error_code ec;
+    uint64_t fileSize = fs::file_size(job.path, ec);
+    if (ec) {
+        // Deleted by retention or by hand - nothing left to upload
+        if (!fs::exists(job.path, ec)) {
+            if (!job.uploadId.empty()) m_s3->AbortMultipartUpload(job.key, job.uploadId);
+            AppendJournal("X " + id);
+            return true;
+        }
+        SetError("Cannot read " + job.path);
+        return false;
+    }
+
+    if (!job.objectDone) {
+        if (job.sha256.empty()) {
+            job.sha256 = Sha256::HashFileHex(job.path);
+            if (job.sha256.empty()) {
+                SetError("Cannot hash " + job.path);
+                return false;
+            }
+            AppendJournal("S " + id + " " + job.sha256);
+        }
+
+        // Resume: the server's part list is authoritative
+        if (!job.uploadId.empty()) {
+            std::vector<S3Part> parts;
+            bool notFound = false;
+            if (m_s3->ListParts(job.key, job.uploadId, parts, notFound)) {
+                job.etags.clear();
+                uint64_t partCount = std::max<uint64_t>(1, (fileSize + m_settings.partSize - 1) / m_settings.partSize);
+                for (const auto& part : parts) {
+                    if (part.number < 1 || (uint64_t)part.number > partCount) continue;
+                    uint64_t expected = std::min<uint64_t>(m_settings.partSize, fileSize - (part.number - 1) * m_settings.partSize);
+                    if (part.size == expected) job.etags[part.number] = part.etag;
+                }
+            } else if (notFound) {
+                AppendJournal("R " + id);
+                job.uploadId.clear();
+                job.etags.clear();
+            } else {
+                SetError("ListParts: " + m_s3->GetLastError());
+                return false;
+            }
+        }
+
+        if (job.uploadId.empty()) {
+            std::map<std::string, std::string> meta;
+            meta["sha256"] = job.sha256;
+            meta["size"] = std::to_string(fileSize);
+            if (!m_s3->CreateMultipartUpload(job.key, meta, job.uploadId)) {
+                SetError("CreateMultipartUpload: " + m_s3->GetLastError());
+                return false;
+            }
+            job.etags.clear();
+            AppendJournal("U " + id + " " + job.uploadId);
+        }
+
+        if (!UploadParts(job, fileSize)) return false;
+
+        std::vector<S3Part> parts;
+        for (const auto& kv : job.etags) {
+            S3Part part;
+            part.number = kv.first;
+            part.etag = kv.second;
+            parts.push_back(part);
+        }
+        if (!m_s3->CompleteMultipartUpload(job.key, job.uploadId, parts)) {
+            std::string error = m_s3->GetLastError();
+            SetError("CompleteMultipartUpload: " + error);
+            if (error == "NoSuchUpload") {
+                AppendJournal("R " + id);
+                job.uploadId.clear();
+                job.etags.clear();
+            }
+            return false;
+        }
+        job.objectDone = true;
+        AppendJournal("C " + id);
+    }
+
+    if (!UploadMetadata(job, fileSize)) return false;
+
+    AppendJournal("D " + id);
+    return true;
+}
+
+bool UploadQueue::UploadParts(Job& job, uint64_t fileSize) {
+    const uint64_t partSize = m_settings.partSize;
+    int partCount = (int)std::max<uint64_t>(1, (fileSize + partSize - 1) / partSize);
+
+    std::vector<int> missing;
+    for (int n = 1; n <= partCount; n++) {
+        if (job.etags.find(n) == job.etags.end()) missing.push_back(n);
+    }
+    if (missing.empty()) return true;
+
+    std::mutex resultMutex;
+    std::atomic<bool> failed{false};
+    auto throttle = [this](size_t bytes) { m_bucket.Acquire(bytes, m_stop); };
+
+    ThreadPool pool(std::min<size_t>(missing.size(), (size_t)m_settings.parallelParts), true);
+    for (int n : missing) {
+        pool.Submit([&, n]() {
+            if (m_stop || failed) return;
+
+            uint64_t offset = (uint64_t)(n - 1) * partSize;
+            size_t len = (size_t)std::min<uint64_t>(partSize, fileSize - offset);
+            std::vector<char> buffer(len);
+            std::ifstream in(job.path, std::ios::binary);
+            in.seekg((std::streamoff)offset);
+            if (!in.read(buffer.data(), (std::streamsize)len)) {
+                failed = true;
+                return;
+            }
+
+            std::string etag;
+            for (int attempt = 0; attempt < PART_ATTEMPTS && !m_stop; attempt++) {
+                if (m_s3->UploadPart(job.key, job.uploadId, n, buffer.data(), len, etag, throttle)) {
+                    {
+                        std::lock_guard<std::mutex> lock(resultMutex);
+                        job.etags[n] = etag;
+                    }
+                    AppendJournal("P " + std::to_string(job.id) + " " + std::to_string(n) + " " + etag);
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_status.bytesSent += len;
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(500 << attempt));
+            }
+            failed = true;
+        });
+    }
+    pool.WaitIdle();
+
+    if (failed || m_stop) {
+        if (failed) SetError("UploadPart: " + m_s3->GetLastError());
+        return false;
+    }
+    return (int)job.etags.size() == partCount;
+}
+
+// <key>.json next to the audio object so the archive can be searched
+// without downloading recordings
+bool UploadQueue::UploadMetadata(const Job& job, uint64_t fileSize) {
+    WavMetadata metadata;
+    if (!WavMeta::Read(job.path, metadata)) WavMeta::ReadSidecar(job.path, metadata);
+
+    std::string json = "{";
+    json += "\"key\":\"" + JsonEscape(job.key) + "\"";
+    json += ",\"size\":" + std::to_string(fileSize);
+    json += ",\"sha256\":\"" + JsonEscape(job.sha256) + "\"";
+    json += ",\"metadata\":{";
+    bool first = true;
+    for (const auto& kv : metadata) {
+        if (!first) json += ",";
+        json += "\"" + JsonEscape(kv.first) + "\":\"" + JsonEscape(kv.second) + "\"";
+        first = false;
+    }
+    json += "}}";
+
+    if (!m_s3->PutObject(job.key + ".json", json, "application/json")) {
+        SetError("PutObject: " + m_s3->GetLastError());
+        return false;
+    }
+    return true;
+}
+
+UploadQueue& GetUploadQueue() {
+    static UploadQueue queue;
+    return queue;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "network/s3_client.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+
+struct UploadSettings {
+    S3Config    s3;
+    std::string keyPrefix;                       // Object key prefix (e.g. agent name)
+    uint64_t    partSize = 8 * 1024 * 1024;      // S3 minimum is 5 MB (except the last part)
+    int         parallelParts = 3;
+    uint64_t    maxBytesPerSec = 0;              // 0 = unlimited
+    uint64_t    captureBytesPerSec = 64 * 1024;  // While a call is being recorded (0 = pause)
+};
+
+struct UploadStatus {
+    size_t      pending = 0;
+    size_t      completed = 0;
+    size_t      failed = 0;      // Failed attempts (jobs are retried)
+    uint64_t    bytesSent = 0;
+    bool        throttled = false;
+    std::string current;
+    std::string lastError;
+
+    std::string ToJson() const;
+};
+
+// Token bucket shared by all part uploads. The rate can change at any time
+// (recording started/stopped); waiters pick it up within 100 ms.
+class TokenBucket {
+public:
+    void SetRate(uint64_t bytesPerSec, bool paused);
+    // Blocks until n bytes may be sent, or stop becomes true
+    void Acquire(size_t n, const std::atomic<bool>& stop);
+
+private:
+    std::mutex m_mutex;
+    uint64_t m_rate = 0;
+    bool m_paused = false;
+    double m_tokens = 0.0;
+    uint64_t m_lastRefillMs = 0;
+};
+
+// Persistent, resumable upload queue for finalized recordings.
+//
+// Each recording becomes one S3 multipart upload (parts uploaded in
+// parallel) followed by a small <key>.json with its metadata. Progress is
+// appended to a journal file (<recording folder>\upload_queue.journal):
+//   A <id> <key>\t<path>   job added
+//   S <id> <sha256>        whole-file checksum (sent as x-amz-meta-sha256)
+//   U <id> <uploadId>      multipart upload started
+//   P <id> <n> <etag>      part n stored
+//   C <id>                 multipart upload completed
+//   R <id>                 upload id expired, start over
+//   D <id>                 done
+//   X <id>                 dropped (file gone)
+// On restart the journal is replayed, so interrupted uploads continue from
+// the last stored part; ListParts is used to reconcile with the server.
+class UploadQueue {
+public:
+    UploadQueue() = default;
+    ~UploadQueue();
+
+    bool Start(const std::string& journalPath, const UploadSettings& settings,
+               std::unique_ptr<HttpClient> http = nullptr);
+    void Stop();
+    bool IsRunning() const { return m_running; }
+
+    // Queue a finalized recording. The key is <prefix>/<date folder>/<file name>.
+    bool Enqueue(const std::string& filePath);
+
+    // Nested: slow down (or pause) uploads while a call is being captured
+    void BeginCapture();
+    void EndCapture();
+
+    UploadStatus GetStatus() const;
+
+private:
+    struct Job {
+        uint64_t id = 0;
+        std::string path;
+        std::string key;
+        std::string sha256;
+        std::string uploadId;
+        std::map<int, std::string> etags;
+        bool objectDone = false;   // Multipart upload completed
+        int attempts = 0;
+        uint64_t nextAttemptMs = 0;
+    };
+
+    void WorkerLoop();
+    bool ProcessJob(Job& job);
+    bool UploadParts(Job& job, uint64_t fileSize);
+    bool UploadMetadata(const Job& job, uint64_t fileSize);
+
+    void LoadJournal();
+    void CompactJournal();
+    void AppendJournal(const std::string& line);
+    void UpdateThrottle();
+    void SetError(const std::string& error);
+
+    UploadSettings m_settings;
+    std::unique_ptr<S3Client> m_s3;
+    std::string m_journalPath;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stop{false};
+
+    mutable std::mutex m_mutex;          // Jobs + status
+    std::condition_variable m_cv;
+    std::deque<Job> m_jobs;
+    uint64_t m_nextId = 1;
+    UploadStatus m_status;
+
+    std::mutex m_journalMutex;
+    std::ofstream m_journal;
+
+    TokenBucket m_bucket;
+    std::atomic<int> m_captureCount{0};
+};
+
+UploadQueue& GetUploadQueue();
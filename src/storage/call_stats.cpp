@@ -0,0 +1,187 @@
+#include "storage/call_stats.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const char* STATS_MAGIC = "MMCS";
+static const int STATS_VERSION = 1;
+static const size_t MAX_DAYS_KEPT = 400; // Older days only live on in the totals
+
+bool CallStatsStore::Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (path == m_path) return true;
+    m_path = path;
+    m_days.clear();
+    m_totals = DayCallStats();
+    return Load();
+}
+
+bool CallStatsStore::IsOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_path.empty();
+}
+
+// Write data to path and have it on the disk before returning, so the
+// rename that follows can never publish an empty or partial file
+static bool WriteFileDurably(const std::string& path, const std::string& data) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    DWORD written = 0;
+    bool ok = WriteFile(file, data.data(), (DWORD)data.size(), &written, nullptr) && written == data.size() &&
+              FlushFileBuffers(file);
+    CloseHandle(file);
+    return ok;
+#else
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = write(fd, data.data(), data.size()) == (ssize_t)data.size() && fsync(fd) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+
+bool CallStatsStore::Load() {
+    std::ifstream file(m_path);
+    if (!file.is_open()) return !fs::exists(m_path); // Missing file is a fresh store
+
+    bool valid = true;
+    std::string magic;
+    int version = 0;
+    if (!(file >> magic >> version) || magic != STATS_MAGIC || version != STATS_VERSION) {
+        valid = false;
+    }
+
+    std::string key;
+    while (valid && file >> key) {
+        if (key == "total") {
+            if (!(file >> m_totals.calls >> m_totals.talkSeconds)) valid = false;
+        } else {
+            DayCallStats day;
+            if (!(file >> day.lastSeq >> day.calls >> day.talkSeconds)) valid = false;
+            else m_days[key] = day;
+        }
+    }
+    if (valid) return true;
+
+    // Keep the damaged file for a look instead of saving over it; the
+    // lines read before the damage stay, the rest is seeded again from
+    // the recordings on disk
+    file.close();
+    std::error_code ec;
+    fs::rename(m_path, m_path + ".bad", ec);
+    char debug[512];
+    snprintf(debug, sizeof(debug), "[CallStats] %s is damaged, moved to .bad\n", m_path.c_str());
+#ifdef _WIN32
+    OutputDebugStringA(debug);
+#else
+    fputs(debug, stderr);
+#endif
+    return false;
+}
+
+bool CallStatsStore::Save() {
+    if (m_path.empty()) return false;
+
+    while (m_days.size() > MAX_DAYS_KEPT) {
+        m_days.erase(m_days.begin()); // Dates sort chronologically
+    }
+
+    std::ostringstream out;
+    out << STATS_MAGIC << " " << STATS_VERSION << "\n";
+    out << "total " << m_totals.calls << " " << m_totals.talkSeconds << "\n";
+    for (const auto& kv : m_days) {
+        out << kv.first << " " << kv.second.lastSeq << " " << kv.second.calls << " " << kv.second.talkSeconds << "\n";
+    }
+
+    // Write-then-rename so a crash never leaves a half written store
+    std::string tmpPath = m_path + ".tmp";
+    if (!WriteFileDurably(tmpPath, out.str())) return false;
+    std::error_code ec;
+    fs::rename(tmpPath, m_path, ec);
+    return !ec;
+}
+
+int CallStatsStore::AllocateSequence(const std::string& date) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int seq = ++m_days[date].lastSeq;
+    Save();
+    return seq;
+}
+
+void CallStatsStore::RecordCall(const std::string& date, uint32_t durationSeconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DayCallStats& day = m_days[date];
+    day.calls++;
+    day.talkSeconds += durationSeconds;
+    m_totals.calls++;
+    m_totals.talkSeconds += durationSeconds;
+    Save();
+}
+
+bool CallStatsStore::HasDay(const std::string& date) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_days.find(date) != m_days.end();
+}
+
+void CallStatsStore::SeedDay(const std::string& date, int existingCalls) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DayCallStats& day = m_days[date];
+    if (existingCalls > day.lastSeq) day.lastSeq = existingCalls;
+    if (existingCalls > day.calls) day.calls = existingCalls;
+    Save();
+}
+
+DayCallStats CallStatsStore::GetDay(const std::string& date) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_days.find(date);
+    return it != m_days.end() ? it->second : DayCallStats();
+}
+
+DayCallStats CallStatsStore::GetTotals() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totals;
+}
+
+std::string CallStatsStore::ToJson(const std::string& today) const {
+    DayCallStats day = GetDay(today);
+    DayCallStats total = GetTotals();
+    size_t dayCount;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dayCount = m_days.size();
+    }
+
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+        "{\"date\":\"%s\","
+        "\"today\":{\"calls\":%d,\"last_seq\":%d,\"talk_seconds\":%llu,\"avg_seconds\":%.1f},"
+        "\"total\":{\"calls\":%d,\"talk_seconds\":%llu,\"avg_seconds\":%.1f},"
+        "\"days\":%zu}",
+        today.c_str(),
+        day.calls, day.lastSeq, (unsigned long long)day.talkSeconds, day.GetAverageSeconds(),
+        total.calls, (unsigned long long)total.talkSeconds, total.GetAverageSeconds(),
+        dayCount);
+    return buf;
+}
+
+CallStatsStore& GetCallStats(const std::string& recordingRoot) {
+    static CallStatsStore store;
+    if (!recordingRoot.empty()) {
+        store.Open((fs::path(recordingRoot) / "callstats.dat").string());
+    }
+    return store;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <cstdint>
+
+// Per-day call counters
+struct DayCallStats {
+    int      lastSeq = 0;         // Last call number handed out for the day
+    int      calls = 0;           // Saved recordings (auto + manual)
+    uint64_t talkSeconds = 0;     // Sum of recording durations
+
+    double GetAverageSeconds() const {
+        return calls ? (double)talkSeconds / calls : 0.0;
+    }
+};
+
+// Persistent call sequence allocator and statistics.
+//
+// Replaces rescanning the date folder on every save: the next call number
+// and the counters are O(1) updates to an in-memory map, written through to
+// <recording folder>\callstats.dat. Every update rewrites a temp file and
+// renames it over the old one, so a crash leaves either the old or the new
+// state, never a torn file (the temp file is flushed to disk before the
+// rename). A damaged store is moved aside to callstats.dat.bad rather than
+// overwritten. Numbers are never reused even if recordings are deleted
+// afterwards.
+class CallStatsStore {
+public:
+    // Load the store at path (missing file = empty store). Reopening the
+    // same path is a no-op.
+    bool Open(const std::string& path);
+    bool IsOpen() const;
+
+    // Reserve the next call number for a date (YYYY-MM-DD)
+    int AllocateSequence(const std::string& date);
+
+    // Account a saved recording
+    void RecordCall(const std::string& date, uint32_t durationSeconds);
+
+    // One-time migration for days that predate the store
+    bool HasDay(const std::string& date) const;
+    void SeedDay(const std::string& date, int existingCalls);
+
+    DayCallStats GetDay(const std::string& date) const;
+    DayCallStats GetTotals() const;
+
+    // {"today":{...},"total":{...},"days":N} for the HTTP API
+    std::string ToJson(const std::string& today) const;
+
+private:
+    bool Load();
+    bool Save();
+
+    mutable std::mutex m_mutex;
+    std::string m_path;
+    std::map<std::string, DayCallStats> m_days;
+    DayCallStats m_totals;   // lastSeq unused
+};
+
+// Process-wide store kept in the given recording folder. The store is
+// reopened automatically when the recording folder changes.
+CallStatsStore& GetCallStats(const std::string& recordingRoot);
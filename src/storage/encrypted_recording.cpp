@@ -0,0 +1,601 @@
+#include "storage/encrypted_recording.h"
+#include "core/sha256.h"
+#include <algorithm>
+#include <cstring>
+
+static const char MAGIC[8] = { 'M', 'M', 'S', 'E', 'N', 'C', '0', '1' };
+static const char FOOTER_MAGIC[8] = { 'M', 'M', 'S', 'E', 'E', 'N', 'D', '1' };
+
+// Header field offsets (see encrypted_recording.h)
+static const size_t OFF_HEADER_SIZE = 8;
+static const size_t OFF_CHUNK_SIZE = 12;
+static const size_t OFF_SAMPLE_RATE = 16;
+static const size_t OFF_CHANNELS = 20;
+static const size_t OFF_BITS = 22;
+static const size_t OFF_WAV_HEADER_SIZE = 24;
+static const size_t OFF_FILE_ID = 32;
+static const size_t OFF_KEY_ID = 48;
+static const size_t OFF_WRAP_NONCE = 64;
+static const size_t OFF_WRAPPED_KEY = 76;
+static const size_t OFF_WRAP_TAG = 108;
+
+static const size_t CHUNK_AAD_SIZE = 48;    // Magic..file id: immutable
+static const size_t WRAP_AAD_SIZE = 64;     // ..key id
+static const size_t FOOTER_SIZE = 16;
+static const size_t TRAILER_FIXED_SIZE = 16;
+static const uint32_t NONCE_DATA = 0;
+static const uint32_t NONCE_TRAILER = 1;
+static const uint32_t MAX_CHUNK_SIZE = 16 * 1024 * 1024;
+static const uint32_t MAX_SECTION_SIZE = 64 * 1024 * 1024;
+
+static void PutU16(uint8_t* p, uint16_t v) { memcpy(p, &v, 2); }
+static void PutU32(uint8_t* p, uint32_t v) { memcpy(p, &v, 4); }
+static void PutU64(uint8_t* p, uint64_t v) { memcpy(p, &v, 8); }
+static uint16_t GetU16(const uint8_t* p) { uint16_t v; memcpy(&v, p, 2); return v; }
+static uint32_t GetU32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+static uint64_t GetU64(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+// 96-bit nonce: section type || big-endian index. The file key is unique
+// per recording, so (type, index) never repeats under one key.
+static void MakeNonce(uint32_t type, uint64_t index, uint8_t nonce[AesGcm::NONCE_SIZE]) {
+    for (int i = 0; i < 4; i++) nonce[i] = (uint8_t)(type >> (24 - 8 * i));
+    for (int i = 0; i < 8; i++) nonce[4 + i] = (uint8_t)(index >> (56 - 8 * i));
+}
+
+static void Wipe(void* p, size_t len) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (len--) *v++ = 0;
+}
+
+// Wrap/unwrap the per-file key with a master key (AAD: header up to the key id)
+static void WrapFileKey(const RecordingKey& master, const uint8_t fileKey[AesGcm::KEY_SIZE],
+                        uint8_t header[EncryptedRecording::HEADER_SIZE]) {
+    memcpy(header + OFF_KEY_ID, master.id, 16);
+    SecureRandom(header + OFF_WRAP_NONCE, AesGcm::NONCE_SIZE);
+    AesGcm wrap;
+    wrap.SetKey(master.key);
+    wrap.Encrypt(header + OFF_WRAP_NONCE, header, WRAP_AAD_SIZE, fileKey,
+                 header + OFF_WRAPPED_KEY, AesGcm::KEY_SIZE, header + OFF_WRAP_TAG);
+}
+
+static bool UnwrapFileKey(const RecordingKeyring& keys, const uint8_t header[EncryptedRecording::HEADER_SIZE],
+                          uint8_t fileKey[AesGcm::KEY_SIZE], std::string& error) {
+    RecordingKey master;
+    if (!keys.Find(header + OFF_KEY_ID, master)) {
+        error = "no key for this recording (key id " + ToHex(header + OFF_KEY_ID, 16) + ")";
+        return false;
+    }
+    AesGcm wrap;
+    wrap.SetKey(master.key);
+    bool ok = wrap.Decrypt(header + OFF_WRAP_NONCE, header, WRAP_AAD_SIZE, header + OFF_WRAPPED_KEY,
+                           fileKey, AesGcm::KEY_SIZE, header + OFF_WRAP_TAG);
+    Wipe(&master, sizeof(master));
+    if (!ok) error = "file key failed authentication (damaged header)";
+    return ok;
+}
+
+static bool CheckHeader(const uint8_t header[EncryptedRecording::HEADER_SIZE], std::string& error) {
+    if (memcmp(header, MAGIC, 8) != 0) {
+        error = "not an encrypted recording";
+        return false;
+    }
+    uint32_t chunkSize = GetU32(header + OFF_CHUNK_SIZE);
+    if (GetU32(header + OFF_HEADER_SIZE) != EncryptedRecording::HEADER_SIZE ||
+        chunkSize == 0 || chunkSize > MAX_CHUNK_SIZE ||
+        GetU32(header + OFF_WAV_HEADER_SIZE) > MAX_SECTION_SIZE) {
+        error = "unsupported container header";
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Keys
+// ---------------------------------------------------------------------------
+
+static void ComputeKeyId(RecordingKey& k) {
+    Sha256 sha;
+    sha.Update(k.key, sizeof(k.key));
+    uint8_t digest[Sha256::DIGEST_SIZE];
+    sha.Final(digest);
+    memcpy(k.id, digest, sizeof(k.id));
+}
+
+bool RecordingKey::Generate(RecordingKey& out) {
+    if (!SecureRandom(out.key, sizeof(out.key))) return false;
+    ComputeKeyId(out);
+    return true;
+}
+
+bool RecordingKey::FromHex(const std::string& hex, RecordingKey& out) {
+    if (hex.size() != 2 * sizeof(out.key)) return false;
+    for (size_t i = 0; i < sizeof(out.key); i++) {
+        int v = 0;
+        for (int n = 0; n < 2; n++) {
+            char c = hex[2 * i + n];
+            int d = (c >= '0' && c <= '9') ? c - '0'
+                  : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                  : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+            if (d < 0) return false;
+            v = v * 16 + d;
+        }
+        out.key[i] = (uint8_t)v;
+    }
+    ComputeKeyId(out);
+    return true;
+}
+
+std::string RecordingKey::ToHex() const {
+    return ::ToHex(key, sizeof(key));
+}
+
+std::string RecordingKey::IdHex() const {
+    return ::ToHex(id, sizeof(id));
+}
+
+void RecordingKeyring::Add(const RecordingKey& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_keys.erase(std::remove_if(m_keys.begin(), m_keys.end(), [&](const RecordingKey& k) {
+        return memcmp(k.id, key.id, sizeof(k.id)) == 0;
+    }), m_keys.end());
+    m_keys.insert(m_keys.begin(), key);
+}
+
+bool RecordingKeyring::Rotate(RecordingKey* created) {
+    RecordingKey key;
+    if (!RecordingKey::Generate(key)) return false;
+    Add(key);
+    if (created) *created = key;
+    Wipe(&key, sizeof(key));
+    return true;
+}
+
+bool RecordingKeyring::GetCurrent(RecordingKey& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_keys.empty()) return false;
+    out = m_keys.front();
+    return true;
+}
+
+bool RecordingKeyring::Find(const uint8_t id[16], RecordingKey& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& k : m_keys) {
+        if (memcmp(k.id, id, sizeof(k.id)) == 0) {
+            out = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t RecordingKeyring::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_keys.size();
+}
+
+void RecordingKeyring::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_keys.empty()) Wipe(m_keys.data(), m_keys.size() * sizeof(RecordingKey));
+    m_keys.clear();
+}
+
+std::string RecordingKeyring::Serialize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string out;
+    for (const auto& k : m_keys) {
+        out += k.ToHex();
+        out += '\n';
+    }
+    return out;
+}
+
+bool RecordingKeyring::Parse(const std::string& text) {
+    std::vector<RecordingKey> keys;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find_first_of("\r\n", pos);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (line.empty()) continue;
+        RecordingKey k;
+        if (!RecordingKey::FromHex(line, k)) return false;
+        keys.push_back(k);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_keys.swap(keys);
+    if (!keys.empty()) Wipe(keys.data(), keys.size() * sizeof(RecordingKey));
+    return true;
+}
+
+RecordingKeyring& GetRecordingKeyring() {
+    static RecordingKeyring keyring;
+    return keyring;
+}
+
+bool EncryptedRecording::IsEncrypted(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[8];
+    return file.read(magic, 8) && memcmp(magic, MAGIC, 8) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+EncryptedRecordingWriter::~EncryptedRecordingWriter() {
+    Close();
+}
+
+bool EncryptedRecordingWriter::Open(const std::string& path, const RecordingKey& key, uint32_t sampleRate,
+                                    uint16_t channels, uint16_t bitsPerSample, uint32_t wavHeaderSize) {
+    Close();
+    m_failed = false;
+    m_chunkIndex = 0;
+    m_dataBytes = 0;
+    m_trailing.clear();
+    m_pending.clear();
+    m_pending.reserve(EncryptedRecording::CHUNK_SIZE);
+    m_cipher.resize(EncryptedRecording::CHUNK_SIZE + AesGcm::TAG_SIZE);
+    m_wavHeader.assign(wavHeaderSize, 0);
+
+    memset(m_header, 0, sizeof(m_header));
+    memcpy(m_header, MAGIC, 8);
+    PutU32(m_header + OFF_HEADER_SIZE, EncryptedRecording::HEADER_SIZE);
+    PutU32(m_header + OFF_CHUNK_SIZE, EncryptedRecording::CHUNK_SIZE);
+    PutU32(m_header + OFF_SAMPLE_RATE, sampleRate);
+    PutU16(m_header + OFF_CHANNELS, channels);
+    PutU16(m_header + OFF_BITS, bitsPerSample);
+    PutU32(m_header + OFF_WAV_HEADER_SIZE, wavHeaderSize);
+
+    uint8_t fileKey[AesGcm::KEY_SIZE];
+    if (!SecureRandom(m_header + OFF_FILE_ID, 16) || !SecureRandom(fileKey, sizeof(fileKey))) {
+        return false;
+    }
+    WrapFileKey(key, fileKey, m_header);
+    m_aes.SetKey(fileKey);
+    Wipe(fileKey, sizeof(fileKey));
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) return false;
+    m_file.write(reinterpret_cast<const char*>(m_header), sizeof(m_header));
+    m_file.flush();
+    m_failed = m_file.fail();
+    return !m_failed;
+}
+
+void EncryptedRecordingWriter::PatchHeader(uint32_t offset, const void* data, size_t len) {
+    if (offset + len > m_wavHeader.size()) return;
+    memcpy(m_wavHeader.data() + offset, data, len);
+}
+
+bool EncryptedRecordingWriter::WriteChunk(const uint8_t* data, size_t len) {
+    uint8_t nonce[AesGcm::NONCE_SIZE];
+    MakeNonce(NONCE_DATA, m_chunkIndex++, nonce);
+    m_aes.Encrypt(nonce, m_header, CHUNK_AAD_SIZE, data, m_cipher.data(), len, m_cipher.data() + len);
+    m_file.write(reinterpret_cast<const char*>(m_cipher.data()), len + AesGcm::TAG_SIZE);
+    if (m_file.fail()) m_failed = true;
+    return !m_failed;
+}
+
+bool EncryptedRecordingWriter::Append(const void* data, size_t len) {
+    if (!m_file.is_open() || m_failed) return false;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    m_dataBytes += len;
+
+    // Whole chunks straight from the caller's buffer when nothing is pending
+    while (m_pending.empty() && len >= EncryptedRecording::CHUNK_SIZE) {
+        if (!WriteChunk(p, EncryptedRecording::CHUNK_SIZE)) return false;
+        p += EncryptedRecording::CHUNK_SIZE;
+        len -= EncryptedRecording::CHUNK_SIZE;
+    }
+    while (len > 0) {
+        size_t take = std::min(len, EncryptedRecording::CHUNK_SIZE - m_pending.size());
+        m_pending.insert(m_pending.end(), p, p + take);
+        p += take;
+        len -= take;
+        if (m_pending.size() == EncryptedRecording::CHUNK_SIZE) {
+            if (!WriteChunk(m_pending.data(), m_pending.size())) return false;
+            m_pending.clear();
+        }
+    }
+    return true;
+}
+
+void EncryptedRecordingWriter::AppendTrailing(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    m_trailing.insert(m_trailing.end(), p, p + len);
+}
+
+bool EncryptedRecordingWriter::Flush() {
+    if (!m_file.is_open()) return false;
+    m_file.flush();
+    if (m_file.fail()) m_failed = true;
+    return !m_failed;
+}
+
+bool EncryptedRecordingWriter::Finish() {
+    if (!m_file.is_open()) return false;
+    if (!m_pending.empty()) {
+        WriteChunk(m_pending.data(), m_pending.size());
+        m_pending.clear();
+    }
+
+    // Trailer: sizes, the final WAV header and metadata appended after the data
+    std::vector<uint8_t> trailer(TRAILER_FIXED_SIZE + m_wavHeader.size() + m_trailing.size() + AesGcm::TAG_SIZE);
+    PutU64(trailer.data(), m_dataBytes);
+    PutU32(trailer.data() + 8, (uint32_t)m_wavHeader.size());
+    PutU32(trailer.data() + 12, (uint32_t)m_trailing.size());
+    if (!m_wavHeader.empty()) memcpy(trailer.data() + TRAILER_FIXED_SIZE, m_wavHeader.data(), m_wavHeader.size());
+    if (!m_trailing.empty()) {
+        memcpy(trailer.data() + TRAILER_FIXED_SIZE + m_wavHeader.size(), m_trailing.data(), m_trailing.size());
+    }
+    size_t plainLen = trailer.size() - AesGcm::TAG_SIZE;
+    uint8_t nonce[AesGcm::NONCE_SIZE];
+    MakeNonce(NONCE_TRAILER, 0, nonce);
+    m_aes.Encrypt(nonce, m_header, CHUNK_AAD_SIZE, trailer.data(), trailer.data(), plainLen, trailer.data() + plainLen);
+    m_file.write(reinterpret_cast<const char*>(trailer.data()), trailer.size());
+
+    uint8_t footer[FOOTER_SIZE];
+    PutU64(footer, trailer.size());
+    memcpy(footer + 8, FOOTER_MAGIC, 8);
+    m_file.write(reinterpret_cast<const char*>(footer), sizeof(footer));
+
+    m_file.flush();
+    if (m_file.fail()) m_failed = true;
+    m_file.close();
+    return !m_failed;
+}
+
+void EncryptedRecordingWriter::Close() {
+    if (m_file.is_open()) m_file.close();
+    if (!m_pending.empty()) Wipe(m_pending.data(), m_pending.size());
+    m_pending.clear();
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+bool EncryptedRecordingReader::Open(const std::string& path, const RecordingKeyring& keys) {
+    Close();
+    m_error.clear();
+
+    m_file.open(path, std::ios::binary);
+    if (!m_file.is_open()) {
+        m_error = "cannot open file";
+        return false;
+    }
+    if (!m_file.read(reinterpret_cast<char*>(m_header), sizeof(m_header))) {
+        m_error = "not an encrypted recording";
+        return false;
+    }
+    if (!CheckHeader(m_header, m_error)) return false;
+
+    uint8_t fileKey[AesGcm::KEY_SIZE];
+    if (!UnwrapFileKey(keys, m_header, fileKey, m_error)) return false;
+    m_aes.SetKey(fileKey);
+    Wipe(fileKey, sizeof(fileKey));
+
+    m_chunkSize = GetU32(m_header + OFF_CHUNK_SIZE);
+    m_cipher.resize((size_t)m_chunkSize + AesGcm::TAG_SIZE);
+    const uint64_t stride = (uint64_t)m_chunkSize + AesGcm::TAG_SIZE;
+
+    m_file.seekg(0, std::ios::end);
+    uint64_t fileSize = (uint64_t)m_file.tellg();
+
+    uint8_t footer[FOOTER_SIZE];
+    bool hasFooter = false;
+    if (fileSize >= EncryptedRecording::HEADER_SIZE + FOOTER_SIZE) {
+        m_file.seekg((std::streamoff)(fileSize - FOOTER_SIZE), std::ios::beg);
+        hasFooter = m_file.read(reinterpret_cast<char*>(footer), FOOTER_SIZE) &&
+                    memcmp(footer + 8, FOOTER_MAGIC, 8) == 0;
+    }
+
+    if (hasFooter) {
+        uint64_t trailerLen = GetU64(footer);
+        uint64_t chunkEnd = fileSize - FOOTER_SIZE - trailerLen;
+        if (trailerLen < TRAILER_FIXED_SIZE + AesGcm::TAG_SIZE || trailerLen > MAX_SECTION_SIZE ||
+            trailerLen > fileSize - FOOTER_SIZE - EncryptedRecording::HEADER_SIZE) {
+            m_error = "damaged trailer";
+            return false;
+        }
+        std::vector<uint8_t> trailer((size_t)trailerLen);
+        m_file.seekg((std::streamoff)chunkEnd, std::ios::beg);
+        size_t plainLen = trailer.size() - AesGcm::TAG_SIZE;
+        uint8_t nonce[AesGcm::NONCE_SIZE];
+        MakeNonce(NONCE_TRAILER, 0, nonce);
+        if (!m_file.read(reinterpret_cast<char*>(trailer.data()), trailer.size()) ||
+            !m_aes.Decrypt(nonce, m_header, CHUNK_AAD_SIZE, trailer.data(), trailer.data(), plainLen,
+                           trailer.data() + plainLen)) {
+            m_error = "trailer failed authentication";
+            return false;
+        }
+        m_dataBytes = GetU64(trailer.data());
+        uint32_t headerLen = GetU32(trailer.data() + 8);
+        uint32_t trailingLen = GetU32(trailer.data() + 12);
+        if ((uint64_t)TRAILER_FIXED_SIZE + headerLen + trailingLen != plainLen) {
+            m_error = "damaged trailer";
+            return false;
+        }
+        const uint8_t* p = trailer.data() + TRAILER_FIXED_SIZE;
+        m_wavHeader.assign(p, p + headerLen);
+        m_trailing.assign(p + headerLen, p + headerLen + trailingLen);
+
+        // The chunk region must hold exactly the chunks the trailer accounts for
+        uint64_t full = m_dataBytes / m_chunkSize;
+        uint64_t tail = m_dataBytes % m_chunkSize;
+        uint64_t expected = full * stride + (tail ? tail + AesGcm::TAG_SIZE : 0);
+        if (chunkEnd - EncryptedRecording::HEADER_SIZE != expected) {
+            m_error = "audio chunks missing or truncated";
+            return false;
+        }
+        m_finalized = true;
+    } else {
+        // Never finalized (crash): whole chunks only, newest one may be torn
+        uint64_t full = fileSize > EncryptedRecording::HEADER_SIZE
+                      ? (fileSize - EncryptedRecording::HEADER_SIZE) / stride : 0;
+        m_dataBytes = full * m_chunkSize;
+        while (full > 0 && !LoadChunk(full - 1)) {
+            full--;
+            m_dataBytes = full * m_chunkSize;
+        }
+        m_error.clear();
+
+        std::vector<char> wav = WavMeta::BuildHeader(GetU32(m_header + OFF_SAMPLE_RATE), GetU16(m_header + OFF_CHANNELS),
+                                                     GetU16(m_header + OFF_BITS), (uint32_t)m_dataBytes);
+        wav.resize(GetU32(m_header + OFF_WAV_HEADER_SIZE), 0);
+        m_wavHeader.assign(wav.begin(), wav.end());
+        m_trailing.clear();
+        m_finalized = false;
+    }
+    return true;
+}
+
+void EncryptedRecordingReader::Close() {
+    if (m_file.is_open()) m_file.close();
+    if (!m_chunk.empty()) Wipe(m_chunk.data(), m_chunk.size());
+    m_chunk.clear();
+    m_wavHeader.clear();
+    m_trailing.clear();
+    m_dataBytes = 0;
+    m_chunkIndex = UINT64_MAX;
+    m_chunksDecrypted = 0;
+    m_finalized = false;
+}
+
+bool EncryptedRecordingReader::LoadChunk(uint64_t index) {
+    if (index == m_chunkIndex) return true;
+    uint64_t start = index * m_chunkSize;
+    if (start >= m_dataBytes) return false;
+    size_t len = (size_t)std::min<uint64_t>(m_chunkSize, m_dataBytes - start);
+
+    m_chunkIndex = UINT64_MAX;
+    m_chunk.resize(len);
+    uint64_t pos = EncryptedRecording::HEADER_SIZE + index * ((uint64_t)m_chunkSize + AesGcm::TAG_SIZE);
+    m_file.clear();
+    m_file.seekg((std::streamoff)pos, std::ios::beg);
+    if (!m_file.read(reinterpret_cast<char*>(m_cipher.data()), len + AesGcm::TAG_SIZE)) {
+        m_error = "read failed";
+        return false;
+    }
+    uint8_t nonce[AesGcm::NONCE_SIZE];
+    MakeNonce(NONCE_DATA, index, nonce);
+    if (!m_aes.Decrypt(nonce, m_header, CHUNK_AAD_SIZE, m_cipher.data(), m_chunk.data(), len,
+                       m_cipher.data() + len)) {
+        m_error = "chunk " + std::to_string(index) + " failed authentication";
+        return false;
+    }
+    m_chunkIndex = index;
+    m_chunksDecrypted++;
+    return true;
+}
+
+bool EncryptedRecordingReader::Read(uint64_t offset, void* out, size_t len) {
+    if (!m_file.is_open() || offset + len > GetSize()) return false;
+    uint8_t* dst = static_cast<uint8_t*>(out);
+    const uint64_t dataStart = m_wavHeader.size();
+    const uint64_t dataEnd = dataStart + m_dataBytes;
+
+    while (len > 0) {
+        size_t n;
+        if (offset < dataStart) {
+            n = (size_t)std::min<uint64_t>(len, dataStart - offset);
+            memcpy(dst, m_wavHeader.data() + offset, n);
+        } else if (offset < dataEnd) {
+            uint64_t rel = offset - dataStart;
+            uint64_t index = rel / m_chunkSize;
+            if (!LoadChunk(index)) return false;
+            size_t within = (size_t)(rel - index * m_chunkSize);
+            n = std::min(len, m_chunk.size() - within);
+            memcpy(dst, m_chunk.data() + within, n);
+        } else {
+            n = len;
+            memcpy(dst, m_trailing.data() + (offset - dataEnd), n);
+        }
+        dst += n;
+        offset += n;
+        len -= n;
+    }
+    return true;
+}
+
+// Walk a chunk list held in memory ("data" reports its size but its
+// payload lives in the chunks, so the walk stops there)
+static void WalkChunks(const uint8_t* p, size_t size, size_t pos, WavInfo* info, WavMetadata* meta, bool& found) {
+    while (pos + 8 <= size) {
+        uint32_t len = GetU32(p + pos + 4);
+        const uint8_t* payload = p + pos + 8;
+        size_t avail = size - pos - 8;
+        if (memcmp(p + pos, "data", 4) == 0) return;
+        if (len > avail) return;
+        if (info && memcmp(p + pos, "fmt ", 4) == 0 && len >= 16) {
+            info->formatTag = GetU16(payload);
+            info->channels = GetU16(payload + 2);
+            info->sampleRate = GetU32(payload + 4);
+            info->byteRate = GetU32(payload + 8);
+            info->blockAlign = GetU16(payload + 12);
+            info->bitsPerSample = GetU16(payload + 14);
+        } else if (meta && memcmp(p + pos, "mmdt", 4) == 0) {
+            found = WavMeta::DecodeCompact(reinterpret_cast<const char*>(payload), len, *meta) || found;
+        }
+        pos += 8 + (size_t)len + (len & 1);
+    }
+}
+
+bool EncryptedRecordingReader::GetWavInfo(WavInfo& info) const {
+    if (m_wavHeader.size() < 12 || memcmp(m_wavHeader.data(), "RIFF", 4) != 0) return false;
+    info = WavInfo();
+    bool found = false;
+    WalkChunks(m_wavHeader.data(), m_wavHeader.size(), 12, &info, nullptr, found);
+    info.dataOffset = m_wavHeader.size();
+    info.dataBytes = m_dataBytes;
+    return info.blockAlign != 0;
+}
+
+bool EncryptedRecordingReader::ReadMetadata(WavMetadata& out) const {
+    bool found = false;
+    if (m_wavHeader.size() >= 12) {
+        WalkChunks(m_wavHeader.data(), m_wavHeader.size(), 12, nullptr, &out, found);
+    }
+    if (!found && !m_trailing.empty()) {
+        // Appended after the data, behind a pad byte when the data size is odd
+        WalkChunks(m_trailing.data(), m_trailing.size(), (size_t)(m_dataBytes & 1), nullptr, &out, found);
+    }
+    return found;
+}
+
+// ---------------------------------------------------------------------------
+// Key rotation
+// ---------------------------------------------------------------------------
+
+bool RewrapRecording(const std::string& path, const RecordingKeyring& keys, const RecordingKey& newKey,
+                     std::string* error) {
+    std::string err;
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    uint8_t header[EncryptedRecording::HEADER_SIZE];
+    uint8_t fileKey[AesGcm::KEY_SIZE];
+    bool ok = false;
+
+    if (!file.is_open()) {
+        err = "cannot open file";
+    } else if (!file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        err = "not an encrypted recording";
+    } else if (CheckHeader(header, err) && UnwrapFileKey(keys, header, fileKey, err)) {
+        if (memcmp(header + OFF_KEY_ID, newKey.id, 16) == 0) {
+            ok = true; // Already under this key
+        } else {
+            // Only key id, nonce, wrapped key and tag change: one small write
+            WrapFileKey(newKey, fileKey, header);
+            file.seekp(OFF_KEY_ID, std::ios::beg);
+            file.write(reinterpret_cast<const char*>(header + OFF_KEY_ID), sizeof(header) - OFF_KEY_ID);
+            file.flush();
+            ok = !file.fail();
+            if (!ok) err = "write failed";
+        }
+        Wipe(fileKey, sizeof(fileKey));
+    }
+
+    if (!ok && error) *error = err;
+    return ok;
+}
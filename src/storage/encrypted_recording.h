@@ -0,0 +1,158 @@
+#pragma once
+
+#include "core/aes_gcm.h"
+#include "audio/WavMetadata.h"
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Encrypted recordings at rest.
+//
+// An encrypted recording keeps its .wav name but holds a container instead
+// of RIFF. The plaintext is exactly the WAV the writer would have produced
+// (header region, audio data, trailing metadata), so everything that reads
+// through WavDecoder or the catalog works unchanged once the key is known.
+//
+//   header   128 bytes, plaintext:
+//              0  "MMSENC01"
+//              8  u32 header size (128), u32 chunk size (plaintext bytes)
+//             16  u32 sample rate, u16 channels, u16 bits, u32 WAV header size
+//             28  u32 reserved, 32 file id [16]              (AAD of every chunk)
+//             48  key id [16]                                (which master key)
+//             64  wrap nonce [12], wrapped file key [32], wrap tag [16], 4 reserved
+//   chunks   audio data in chunkSize pieces: ciphertext + 16-byte tag,
+//            nonce = 0 || chunk index, so any time range decrypts alone
+//   trailer  written on finalize: [u64 data bytes][u32 header len]
+//            [u32 trailing len][WAV header][trailing chunks] + tag (nonce 1 || 0)
+//   footer   u64 trailer length, "MMSEEND1"
+//
+// Each file has its own random AES-256-GCM key, wrapped by a master key.
+// Rotating the master key only rewrites the wrap in the 128-byte header
+// (RewrapRecording); the audio is never re-encrypted. A file without a
+// footer (crash) still opens: its whole chunks are readable and the WAV
+// header is rebuilt from the container header.
+
+// 256-bit master key; the id is the first 16 bytes of its SHA-256
+struct RecordingKey {
+    uint8_t key[AesGcm::KEY_SIZE] = {};
+    uint8_t id[16] = {};
+
+    static bool Generate(RecordingKey& out);
+    static bool FromHex(const std::string& hex, RecordingKey& out);
+    std::string ToHex() const;
+    std::string IdHex() const;
+};
+
+// Master keys that can open recordings; the newest encrypts new ones.
+// Serialized one hex key per line, newest first (kept DPAPI-protected in
+// the registry by settings.cpp).
+class RecordingKeyring {
+public:
+    void Add(const RecordingKey& key);          // Becomes current
+    bool Rotate(RecordingKey* created = nullptr);
+    bool GetCurrent(RecordingKey& out) const;
+    bool Find(const uint8_t id[16], RecordingKey& out) const;
+    size_t Size() const;
+    void Clear();
+
+    std::string Serialize() const;
+    bool Parse(const std::string& text);
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<RecordingKey> m_keys;           // Newest first
+};
+
+// The app's keyring (recorder, player, catalog, API)
+RecordingKeyring& GetRecordingKeyring();
+
+namespace EncryptedRecording {
+    constexpr uint32_t HEADER_SIZE = 128;
+    constexpr uint32_t CHUNK_SIZE = 64 * 1024;
+
+    bool IsEncrypted(const std::string& path);
+}
+
+// Encrypts as audio is appended: whole chunks go to disk as soon as they
+// fill, the header region and trailing metadata stay in memory until
+// Finish(). Not thread-safe (StreamingWavWriter serializes calls).
+class EncryptedRecordingWriter {
+public:
+    ~EncryptedRecordingWriter();
+
+    bool Open(const std::string& path, const RecordingKey& key, uint32_t sampleRate,
+              uint16_t channels, uint16_t bitsPerSample, uint32_t wavHeaderSize = WavMeta::DATA_OFFSET);
+
+    // Plaintext WAV header region (sizes, metadata in the reserved space)
+    void PatchHeader(uint32_t offset, const void* data, size_t len);
+    bool Append(const void* data, size_t len);
+    void AppendTrailing(const void* data, size_t len);
+
+    // Whole chunks written so far reach the OS; a partial chunk stays in memory
+    bool Flush();
+    bool Finish();
+    void Close();                                // Without a trailer
+
+    bool IsOpen() const { return m_file.is_open(); }
+    bool HasFailed() const { return m_failed; }
+    uint64_t GetDataBytes() const { return m_dataBytes; }
+
+private:
+    bool WriteChunk(const uint8_t* data, size_t len);
+
+    std::ofstream m_file;
+    AesGcm m_aes;
+    uint8_t m_header[EncryptedRecording::HEADER_SIZE] = {};
+    std::vector<uint8_t> m_wavHeader;
+    std::vector<uint8_t> m_trailing;
+    std::vector<uint8_t> m_pending;
+    std::vector<uint8_t> m_cipher;
+    uint64_t m_chunkIndex = 0;
+    uint64_t m_dataBytes = 0;
+    bool m_failed = false;
+};
+
+// Random access to the plaintext WAV: Read() decrypts (and authenticates)
+// only the chunks it touches, keeping the last one cached.
+class EncryptedRecordingReader {
+public:
+    bool Open(const std::string& path, const RecordingKeyring& keys);
+    void Close();
+
+    const std::string& GetError() const { return m_error; }
+    bool IsFinalized() const { return m_finalized; }    // False: recovered after a crash
+    uint64_t GetSize() const { return m_wavHeader.size() + m_dataBytes + m_trailing.size(); }
+    uint64_t GetDataOffset() const { return m_wavHeader.size(); }
+    uint64_t GetDataBytes() const { return m_dataBytes; }
+    uint64_t GetChunksDecrypted() const { return m_chunksDecrypted; }
+
+    // Format and layout of the plaintext WAV, embedded metadata
+    bool GetWavInfo(WavInfo& info) const;
+    bool ReadMetadata(WavMetadata& out) const;
+
+    // False on a read error or a chunk that fails authentication
+    bool Read(uint64_t offset, void* out, size_t len);
+
+private:
+    bool LoadChunk(uint64_t index);
+
+    std::ifstream m_file;
+    AesGcm m_aes;
+    std::string m_error;
+    uint8_t m_header[EncryptedRecording::HEADER_SIZE] = {};
+    uint32_t m_chunkSize = 0;
+    uint64_t m_dataBytes = 0;
+    std::vector<uint8_t> m_wavHeader;
+    std::vector<uint8_t> m_trailing;
+    std::vector<uint8_t> m_chunk;
+    std::vector<uint8_t> m_cipher;
+    uint64_t m_chunkIndex = UINT64_MAX;
+    uint64_t m_chunksDecrypted = 0;
+    bool m_finalized = false;
+};
+
+// Re-wrap a recording's file key under newKey (header rewrite only)
+bool RewrapRecording(const std::string& path, const RecordingKeyring& keys, const RecordingKey& newKey,
+                     std::string* error = nullptr);
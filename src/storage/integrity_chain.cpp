@@ -0,0 +1,242 @@
+#include "storage/integrity_chain.h"
+#include "storage/encrypted_recording.h"
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+static const char SEED_TAG[] = "MMS-CHAIN-1";
+static const uint32_t BLOCKS_PER_SLICE = 64;    // 4 MiB of audio per verify task
+static const uint64_t BATCH_BYTES = 8ull << 30; // Audio in flight: bounds the block hashes held (4 MiB)
+
+void IntegrityChain::Seed(uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample, uint8_t chain[32]) {
+    Sha256 sha;
+    sha.Update(SEED_TAG, sizeof(SEED_TAG) - 1);
+    sha.Update(&sampleRate, 4);
+    sha.Update(&channels, 2);
+    sha.Update(&bitsPerSample, 2);
+    sha.Final(chain);
+}
+
+void IntegrityChain::Link(uint8_t chain[32], const uint8_t blockHash[32]) {
+    Sha256 sha;
+    sha.Update(chain, 32);
+    sha.Update(blockHash, 32);
+    sha.Final(chain);
+}
+
+std::string IntegrityChain::RootHex(const uint8_t chain[32], uint64_t dataBytes) {
+    Sha256 sha;
+    sha.Update(chain, 32);
+    sha.Update(&dataBytes, 8);
+    uint8_t root[32];
+    sha.Final(root);
+    return ToHex(root, 32);
+}
+
+void IntegrityChain::Start(uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample) {
+    Seed(sampleRate, channels, bitsPerSample, m_chain);
+    m_block = Sha256();
+    m_blockFill = 0;
+    m_bytes = 0;
+    m_started = true;
+}
+
+void IntegrityChain::Add(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    m_bytes += len;
+    while (len > 0) {
+        size_t take = std::min<size_t>(len, BLOCK_SIZE - m_blockFill);
+        m_block.Update(p, take);
+        m_blockFill += (uint32_t)take;
+        p += take;
+        len -= take;
+        if (m_blockFill == BLOCK_SIZE) {
+            uint8_t hash[32];
+            m_block.Final(hash);
+            Link(m_chain, hash);
+            m_block = Sha256();
+            m_blockFill = 0;
+        }
+    }
+}
+
+std::string IntegrityChain::GetRootHex() const {
+    uint8_t chain[32];
+    memcpy(chain, m_chain, 32);
+    if (m_blockFill > 0) {
+        Sha256 partial = m_block;
+        uint8_t hash[32];
+        partial.Final(hash);
+        Link(chain, hash);
+    }
+    return RootHex(chain, m_bytes);
+}
+
+void IntegrityChain::AddToMetadata(WavMetadata& md) const {
+    md["integrity_alg"] = ALGORITHM;
+    md["integrity_block"] = std::to_string(BLOCK_SIZE);
+    md["integrity_root"] = GetRootHex();
+}
+
+const char* IntegrityResult::GetStatusName() const {
+    switch (status) {
+        case IntegrityStatus::Verified:   return "verified";
+        case IntegrityStatus::Mismatch:   return "MISMATCH";
+        case IntegrityStatus::NoChain:    return "no-chain";
+        case IntegrityStatus::Transcoded: return "transcoded";
+        default:                          return "unreadable";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Verifier
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct VerifyJob {
+    IntegrityResult result;
+    bool encrypted = false;
+    WavInfo info;
+    uint64_t blocks = 0;
+    std::vector<uint8_t> hashes;            // 32 bytes per block, filled by slices
+    std::atomic<bool> readFailed{false};
+};
+
+void PrepareJob(VerifyJob& job) {
+    IntegrityResult& r = job.result;
+    WavMetadata md;
+    job.encrypted = EncryptedRecording::IsEncrypted(r.path);
+    if (job.encrypted) {
+        EncryptedRecordingReader reader;
+        if (!reader.Open(r.path, GetRecordingKeyring())) {
+            r.message = reader.GetError();
+            return;
+        }
+        reader.GetWavInfo(job.info);
+        reader.ReadMetadata(md);
+    } else {
+        WavMeta::Read(r.path, md, &job.info);
+    }
+    if (job.info.dataOffset == 0) {
+        r.message = "not a wav file";
+        return;
+    }
+
+    auto root = md.find("integrity_root");
+    if (root == md.end()) {
+        r.status = IntegrityStatus::NoChain;
+        return;
+    }
+    r.expectedRoot = root->second;
+    auto codec = md.find("codec");
+    if (codec != md.end() && codec->second != "pcm") {
+        r.status = IntegrityStatus::Transcoded;
+        r.message = codec->second;
+        return;
+    }
+    auto alg = md.find("integrity_alg");
+    auto block = md.find("integrity_block");
+    if (alg == md.end() || alg->second != IntegrityChain::ALGORITHM ||
+        block == md.end() || block->second != std::to_string(IntegrityChain::BLOCK_SIZE)) {
+        r.message = "unsupported chain parameters";
+        return;
+    }
+
+    r.dataBytes = job.info.dataBytes;
+    job.blocks = (job.info.dataBytes + IntegrityChain::BLOCK_SIZE - 1) / IntegrityChain::BLOCK_SIZE;
+    r.status = IntegrityStatus::Mismatch; // Until the fold says otherwise
+}
+
+// Hash blocks [first, first + count) of one recording
+void HashSlice(VerifyJob& job, uint64_t first, uint64_t count) {
+    const uint64_t start = first * IntegrityChain::BLOCK_SIZE;
+    const size_t len = (size_t)std::min<uint64_t>(count * IntegrityChain::BLOCK_SIZE, job.info.dataBytes - start);
+    std::vector<uint8_t> buf(len);
+
+    bool ok;
+    if (job.encrypted) {
+        EncryptedRecordingReader reader;
+        ok = reader.Open(job.result.path, GetRecordingKeyring()) &&
+             reader.Read(job.info.dataOffset + start, buf.data(), len);
+    } else {
+        std::ifstream file(job.result.path, std::ios::binary);
+        file.seekg((std::streamoff)(job.info.dataOffset + start), std::ios::beg);
+        ok = file.read(reinterpret_cast<char*>(buf.data()), (std::streamsize)len).good();
+    }
+    if (!ok) {
+        job.readFailed = true;
+        return;
+    }
+
+    for (uint64_t b = 0; b < count; b++) {
+        size_t off = (size_t)(b * IntegrityChain::BLOCK_SIZE);
+        Sha256 sha;
+        sha.Update(buf.data() + off, std::min<size_t>(IntegrityChain::BLOCK_SIZE, len - off));
+        sha.Final(job.hashes.data() + (size_t)(first + b) * 32);
+    }
+}
+
+void FoldJob(VerifyJob& job) {
+    IntegrityResult& r = job.result;
+    if (r.status != IntegrityStatus::Mismatch) return;
+    if (job.readFailed) {
+        r.status = IntegrityStatus::Unreadable;
+        r.message = job.encrypted ? "audio chunk failed authentication" : "read failed";
+        return;
+    }
+    uint8_t chain[32];
+    IntegrityChain::Seed(job.info.sampleRate, job.info.channels, job.info.bitsPerSample, chain);
+    for (uint64_t b = 0; b < job.blocks; b++) {
+        IntegrityChain::Link(chain, job.hashes.data() + (size_t)b * 32);
+    }
+    r.actualRoot = IntegrityChain::RootHex(chain, job.info.dataBytes);
+    r.status = r.actualRoot == r.expectedRoot ? IntegrityStatus::Verified : IntegrityStatus::Mismatch;
+    job.hashes.clear();
+    job.hashes.shrink_to_fit();
+}
+
+} // namespace
+
+std::vector<IntegrityResult> VerifyRecordings(const std::vector<std::string>& paths, ThreadPool& pool) {
+    std::vector<std::unique_ptr<VerifyJob>> jobs;
+    for (const auto& p : paths) {
+        jobs.emplace_back(new VerifyJob());
+        jobs.back()->result.path = p;
+    }
+
+    // Headers and metadata first, then the slices of as many files as fit
+    // in a batch, all on the pool (small files and one huge file alike)
+    for (auto& j : jobs) {
+        VerifyJob* job = j.get();
+        pool.Submit([job]() { PrepareJob(*job); });
+    }
+    pool.WaitIdle();
+
+    size_t batchStart = 0;
+    while (batchStart < jobs.size()) {
+        uint64_t batchBytes = 0;
+        size_t batchEnd = batchStart;
+        while (batchEnd < jobs.size() && (batchEnd == batchStart || batchBytes < BATCH_BYTES)) {
+            VerifyJob* job = jobs[batchEnd++].get();
+            if (job->result.status != IntegrityStatus::Mismatch) continue;
+            batchBytes += job->info.dataBytes;
+            job->hashes.resize((size_t)job->blocks * 32);
+            for (uint64_t first = 0; first < job->blocks; first += BLOCKS_PER_SLICE) {
+                uint64_t count = std::min<uint64_t>(BLOCKS_PER_SLICE, job->blocks - first);
+                pool.Submit([job, first, count]() { HashSlice(*job, first, count); });
+            }
+        }
+        pool.WaitIdle();
+        for (size_t i = batchStart; i < batchEnd; i++) FoldJob(*jobs[i]);
+        batchStart = batchEnd;
+    }
+
+    std::vector<IntegrityResult> results;
+    results.reserve(jobs.size());
+    for (auto& j : jobs) results.push_back(std::move(j->result));
+    return results;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "audio/WavMetadata.h"
+#include "core/sha256.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class ThreadPool;
+
+// Tamper evidence for recordings: a SHA-256 hash chain over the audio data
+// in fixed BLOCK_SIZE blocks, built while the recording streams to disk.
+//
+//   seed   = SHA-256("MMS-CHAIN-1" || u32 rate || u16 channels || u16 bits)
+//   c[i]   = SHA-256(c[i-1] || SHA-256(block i))      (last block may be short)
+//   root   = SHA-256(c[n] || u64 data bytes)
+//
+// The writer only hashes each byte once as it is written, so finishing is
+// O(one block) no matter how long the call was. The root goes into the
+// embedded metadata ("integrity_root"). Verification hashes the blocks in
+// parallel and folds the short chain of digests in order, so one large
+// file uses every core just as well as an archive of small ones.
+//
+// Anyone who can rewrite the file can also rewrite the root, so the root is
+// evidence only once it has left the machine (uploaded metadata, exported
+// list); encrypted recordings additionally authenticate it with the file key.
+class IntegrityChain {
+public:
+    static constexpr uint32_t BLOCK_SIZE = 64 * 1024;
+    static constexpr const char* ALGORITHM = "sha256-chain-v1";
+
+    void Start(uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample);
+    void Add(const void* data, size_t len);
+    bool IsStarted() const { return m_started; }
+    uint64_t GetBytes() const { return m_bytes; }
+
+    // Root over everything added so far (hex); the chain can keep growing
+    std::string GetRootHex() const;
+
+    // integrity_alg / integrity_block / integrity_root
+    void AddToMetadata(WavMetadata& md) const;
+
+    // Shared with the verifier
+    static void Seed(uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample, uint8_t chain[32]);
+    static void Link(uint8_t chain[32], const uint8_t blockHash[32]);
+    static std::string RootHex(const uint8_t chain[32], uint64_t dataBytes);
+
+private:
+    Sha256 m_block;
+    uint32_t m_blockFill = 0;
+    uint8_t m_chain[32] = {};
+    uint64_t m_bytes = 0;
+    bool m_started = false;
+};
+
+enum class IntegrityStatus {
+    Verified,       // Audio matches the recorded root
+    Mismatch,       // Audio (or its length) changed since it was recorded
+    NoChain,        // Recorded before hash chains, or metadata stripped
+    Transcoded,     // Archived to ADPCM: the root describes the original PCM
+    Unreadable      // Missing, not a recording, or no key for an encrypted one
+};
+
+struct IntegrityResult {
+    std::string path;
+    IntegrityStatus status = IntegrityStatus::Unreadable;
+    std::string expectedRoot;
+    std::string actualRoot;
+    uint64_t dataBytes = 0;
+    std::string message;
+
+    const char* GetStatusName() const;
+};
+
+// Verify recordings (plain or encrypted through the app keyring) on the
+// pool. Results are in the order of paths.
+std::vector<IntegrityResult> VerifyRecordings(const std::vector<std::string>& paths, ThreadPool& pool);
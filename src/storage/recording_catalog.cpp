@@ -0,0 +1,349 @@
+#include "storage/recording_catalog.h"
+#include "storage/encrypted_recording.h"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace fs = std::filesystem;
+
+static std::string ToLower(std::string s) {
+    for (auto& c : s) c = (char)tolower((unsigned char)c);
+    return s;
+}
+
+// Legacy recordings (before metadata was embedded) have a free-form
+// "Key: Value" .txt file next to them. Parse it once at scan time.
+static void ReadLegacyTextMetadata(const fs::path& wavPath, WavMetadata& out) {
+    fs::path txt = wavPath;
+    txt.replace_extension(".txt");
+    std::ifstream file(txt);
+    if (!file.is_open()) return;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t colon = line.find(": ");
+        if (colon == std::string::npos || colon == 0) continue;
+        out[line.substr(0, colon)] = line.substr(colon + 2);
+    }
+}
+
+bool RecordingCatalog::LoadEntry(const std::string& wavPath, CatalogEntry& entry) {
+    std::error_code ec;
+    fs::path p(wavPath);
+    entry.path = p.string();
+    entry.name = p.stem().string();
+    entry.dateFolder = p.parent_path().filename().string();
+    entry.sizeBytes = fs::file_size(p, ec);
+    if (ec) return false;
+    return LoadHeader(entry);
+}
+
+bool RecordingCatalog::LoadHeader(CatalogEntry& entry) {
+    WavInfo info;
+    entry.metadata.clear();
+    if (EncryptedRecording::IsEncrypted(entry.path)) {
+        // Format and metadata come from the trailer; no audio is decrypted
+        EncryptedRecordingReader reader;
+        if (reader.Open(entry.path, GetRecordingKeyring())) {
+            reader.GetWavInfo(info);
+            reader.ReadMetadata(entry.metadata);
+        }
+    } else if (!WavMeta::Read(entry.path, entry.metadata, &info)) {
+        if (!WavMeta::ReadSidecar(entry.path, entry.metadata)) {
+            ReadLegacyTextMetadata(fs::path(entry.path), entry.metadata);
+        }
+    }
+    entry.durationMs = (uint32_t)(info.GetDurationSeconds() * 1000.0);
+    entry.headerLoaded = true;
+    return true;
+}
+
+// Newest first (date folder + call number / timestamp sort by path)
+static bool NewerFirst(const CatalogEntry& a, const CatalogEntry& b) {
+    return a.path > b.path;
+}
+
+size_t RecordingCatalog::IndexOfLocked(const std::string& path) const {
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), path,
+        [](const CatalogEntry& e, const std::string& p) { return e.path > p; });
+    if (it == m_entries.end() || it->path != path) return SIZE_MAX;
+    return (size_t)(it - m_entries.begin());
+}
+
+void RecordingCatalog::Rescan(const std::string& rootFolder) {
+    ScanFiles(rootFolder);
+    while (LoadPendingHeaders(1024) > 0) {}
+}
+
+void RecordingCatalog::ScanFiles(const std::string& rootFolder) {
+    std::vector<CatalogEntry> tmp;
+    if (!rootFolder.empty()) {
+        try {
+            for (auto& e : fs::recursive_directory_iterator(rootFolder)) {
+                if (!e.is_regular_file()) continue;
+                if (ToLower(e.path().extension().string()) != ".wav") continue;
+                CatalogEntry entry;
+                std::error_code ec;
+                entry.path = e.path().string();
+                entry.name = e.path().stem().string();
+                entry.dateFolder = e.path().parent_path().filename().string();
+                entry.sizeBytes = e.file_size(ec);
+                if (!ec) tmp.push_back(std::move(entry));
+            }
+        } catch (...) {}
+    }
+    std::sort(tmp.begin(), tmp.end(), NewerFirst);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Keep headers already read for files that did not change
+    for (auto& entry : tmp) {
+        size_t i = IndexOfLocked(entry.path);
+        if (i == SIZE_MAX) continue;
+        CatalogEntry& old = m_entries[i];
+        if (old.headerLoaded && old.sizeBytes == entry.sizeBytes) {
+            entry.durationMs = old.durationMs;
+            entry.metadata = std::move(old.metadata);
+            entry.headerLoaded = true;
+        }
+    }
+    m_entries = std::move(tmp);
+    m_pendingCursor = 0;
+    m_generation++;
+}
+
+size_t RecordingCatalog::LoadPendingHeaders(size_t maxCount) {
+    std::vector<CatalogEntry> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (m_pendingCursor < m_entries.size() && batch.size() < maxCount) {
+            const CatalogEntry& e = m_entries[m_pendingCursor++];
+            if (!e.headerLoaded) batch.push_back(e);
+        }
+    }
+    if (batch.empty()) return 0;
+
+    // File reads happen without the lock so views stay responsive
+    for (auto& e : batch) LoadHeader(e);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& e : batch) {
+        size_t i = IndexOfLocked(e.path);
+        if (i != SIZE_MAX && !m_entries[i].headerLoaded) m_entries[i] = std::move(e);
+    }
+    m_generation++;
+    return batch.size();
+}
+
+void RecordingCatalog::AddOrUpdate(const std::string& wavPath) {
+    CatalogEntry entry;
+    if (!LoadEntry(wavPath, entry)) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_generation++;
+    size_t i = IndexOfLocked(entry.path);
+    if (i != SIZE_MAX) {
+        m_entries[i] = std::move(entry);
+        return;
+    }
+    auto pos = std::lower_bound(m_entries.begin(), m_entries.end(), entry, NewerFirst);
+    size_t index = (size_t)(pos - m_entries.begin());
+    m_entries.insert(pos, std::move(entry));
+    if (index < m_pendingCursor) m_pendingCursor++;
+}
+
+void RecordingCatalog::Remove(const std::string& wavPath) {
+    std::string path = fs::path(wavPath).string();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t i = IndexOfLocked(path);
+    if (i == SIZE_MAX) return;
+    m_entries.erase(m_entries.begin() + i);
+    if (i < m_pendingCursor) m_pendingCursor--;
+    m_generation++;
+}
+
+std::vector<CatalogEntry> RecordingCatalog::Snapshot() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries;
+}
+
+std::string RecordingCatalog::FindByQuery(const std::string& query) const {
+    if (query.empty()) return "";
+    std::string ql = ToLower(query);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // First: filename match
+    for (const auto& e : m_entries) {
+        if (ToLower(e.name).find(ql) != std::string::npos) return e.path;
+    }
+    // Second: metadata values (customer number, campaign, ...)
+    for (const auto& e : m_entries) {
+        for (const auto& kv : e.metadata) {
+            if (ToLower(kv.second).find(ql) != std::string::npos) return e.path;
+        }
+    }
+    return "";
+}
+
+size_t RecordingCatalog::GetCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+uint64_t RecordingCatalog::GetGeneration() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_generation;
+}
+
+static bool ContainsLower(const std::string& haystack, const std::string& lowerNeedle) {
+    auto it = std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+        [](char a, char b) { return tolower((unsigned char)a) == b; });
+    return it != haystack.end();
+}
+
+static bool MatchesQuery(const CatalogEntry& e, const CatalogQuery& q, const std::string& textLower,
+                         const std::string& keyLower, const std::string& valueLower) {
+    if (!q.dateFrom.empty() && e.dateFolder.compare(0, q.dateFrom.size(), q.dateFrom) < 0) return false;
+    if (!q.dateTo.empty() && e.dateFolder.compare(0, q.dateTo.size(), q.dateTo) > 0) return false;
+    if (q.minDurationMs > 0 && e.durationMs < q.minDurationMs) return false;
+    if (q.maxDurationMs != UINT32_MAX && e.durationMs > q.maxDurationMs) return false;
+
+    if (!keyLower.empty()) {
+        bool found = false;
+        for (const auto& kv : e.metadata) {
+            if (ToLower(kv.first) == keyLower && ContainsLower(kv.second, valueLower)) { found = true; break; }
+        }
+        if (!found) return false;
+    }
+    if (!textLower.empty() && !ContainsLower(e.name, textLower)) {
+        bool found = false;
+        for (const auto& kv : e.metadata) {
+            if (ContainsLower(kv.second, textLower)) { found = true; break; }
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+std::vector<uint32_t> RecordingCatalog::Query(const CatalogQuery& query, uint64_t* generation) const {
+    std::string textLower = ToLower(query.text);
+    std::string keyLower = ToLower(query.metaKey);
+    std::string valueLower = ToLower(query.metaValue);
+    bool filtered = query.IsFiltered();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation) *generation = m_generation;
+
+    std::vector<uint32_t> ids;
+    ids.reserve(filtered ? 1024 : m_entries.size());
+    for (uint32_t i = 0; i < (uint32_t)m_entries.size(); i++) {
+        if (!filtered || MatchesQuery(m_entries[i], query, textLower, keyLower, valueLower)) ids.push_back(i);
+    }
+
+    // Entries are stored newest first; ties keep that order
+    const std::vector<CatalogEntry>& e = m_entries;
+    switch (query.sort) {
+    case CatalogSort::Newest:
+        break;
+    case CatalogSort::Oldest:
+        std::reverse(ids.begin(), ids.end());
+        break;
+    case CatalogSort::Longest:
+        std::stable_sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) { return e[a].durationMs > e[b].durationMs; });
+        break;
+    case CatalogSort::Shortest:
+        std::stable_sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) { return e[a].durationMs < e[b].durationMs; });
+        break;
+    case CatalogSort::Largest:
+        std::stable_sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) { return e[a].sizeBytes > e[b].sizeBytes; });
+        break;
+    case CatalogSort::Name:
+        std::stable_sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) { return e[a].name < e[b].name; });
+        break;
+    }
+    return ids;
+}
+
+bool RecordingCatalog::ReadEntries(const std::vector<uint32_t>& ids, uint64_t generation,
+                                   size_t first, size_t count, std::vector<CatalogEntry>& out) const {
+    out.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation != m_generation) return false;
+    size_t last = std::min(ids.size(), first + count);
+    for (size_t i = first; i < last; i++) out.push_back(m_entries[ids[i]]);
+    return true;
+}
+
+int64_t RecordingCatalog::FindId(const std::string& path, uint64_t generation) const {
+    std::string normalized = fs::path(path).string();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation != m_generation) return -1;
+    size_t i = IndexOfLocked(normalized);
+    return i == SIZE_MAX ? -1 : (int64_t)i;
+}
+
+// ============================================================================
+// CatalogQuery
+// ============================================================================
+
+bool CatalogQuery::IsFiltered() const {
+    return !text.empty() || !dateFrom.empty() || !dateTo.empty() || minDurationMs > 0 ||
+           maxDurationMs != UINT32_MAX || !metaKey.empty();
+}
+
+CatalogQuery CatalogQuery::Parse(const std::string& search) {
+    CatalogQuery q;
+    size_t pos = 0;
+    while (pos < search.size()) {
+        size_t end = search.find(' ', pos);
+        if (end == std::string::npos) end = search.size();
+        std::string word = search.substr(pos, end - pos);
+        pos = end + 1;
+        if (word.empty()) continue;
+
+        std::string lower = ToLower(word);
+        size_t eq = word.find('=');
+        if (lower.compare(0, 5, "date:") == 0) {
+            q.dateFrom = q.dateTo = word.substr(5);
+        } else if (lower.compare(0, 5, "from:") == 0) {
+            q.dateFrom = word.substr(5);
+        } else if (lower.compare(0, 3, "to:") == 0) {
+            q.dateTo = word.substr(3);
+        } else if ((lower.compare(0, 4, "dur>") == 0 || lower.compare(0, 4, "dur<") == 0) && word.size() > 4) {
+            uint32_t ms = (uint32_t)(atof(word.c_str() + 4) * 1000.0);
+            if (lower[3] == '>') q.minDurationMs = ms;
+            else q.maxDurationMs = ms;
+        } else if (lower.compare(0, 5, "sort:") == 0) {
+            std::string name = lower.substr(5);
+            for (CatalogSort s : { CatalogSort::Newest, CatalogSort::Oldest, CatalogSort::Longest,
+                                   CatalogSort::Shortest, CatalogSort::Largest, CatalogSort::Name }) {
+                if (name == ToLower(GetSortName(s))) q.sort = s;
+            }
+        } else if (eq != std::string::npos && eq > 0) {
+            q.metaKey = word.substr(0, eq);
+            q.metaValue = word.substr(eq + 1);
+        } else {
+            if (!q.text.empty()) q.text += ' ';
+            q.text += word;
+        }
+    }
+    return q;
+}
+
+const char* CatalogQuery::GetSortName(CatalogSort sort) {
+    switch (sort) {
+    case CatalogSort::Newest:   return "Newest";
+    case CatalogSort::Oldest:   return "Oldest";
+    case CatalogSort::Longest:  return "Longest";
+    case CatalogSort::Shortest: return "Shortest";
+    case CatalogSort::Largest:  return "Largest";
+    case CatalogSort::Name:     return "Name";
+    }
+    return "";
+}
+
+RecordingCatalog& GetRecordingCatalog() {
+    static RecordingCatalog catalog;
+    return catalog;
+}
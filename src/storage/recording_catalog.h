@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include "audio/WavMetadata.h"
+
+// One finalized recording on disk
+struct CatalogEntry {
+    std::string path;
+    std::string name;        // Filename without extension
+    std::string dateFolder;  // Parent folder name (YYYY-MM-DD)
+    uint64_t    sizeBytes = 0;
+    uint32_t    durationMs = 0;
+    WavMetadata metadata;    // Embedded metadata (or legacy .txt fallback)
+    bool        headerLoaded = false;   // durationMs/metadata valid
+};
+
+enum class CatalogSort { Newest, Oldest, Longest, Shortest, Largest, Name };
+
+// Filter and order for a view over the catalog. Empty fields match all.
+struct CatalogQuery {
+    CatalogSort sort = CatalogSort::Newest;
+    std::string text;                   // File name or any metadata value
+    std::string dateFrom, dateTo;       // Date folder prefixes, inclusive
+    uint32_t    minDurationMs = 0;
+    uint32_t    maxDurationMs = UINT32_MAX;
+    std::string metaKey, metaValue;     // Key present and value contains metaValue
+
+    bool IsFiltered() const;
+
+    // Search box syntax, space separated; anything else is free text:
+    //   date:2024-05   from:2024-05-01   to:2024-06-30
+    //   dur>60   dur<600   (seconds)
+    //   key=value   (metadata, e.g. campaign=spring)
+    //   sort:newest|oldest|longest|shortest|largest|name
+    static CatalogQuery Parse(const std::string& search);
+    static const char* GetSortName(CatalogSort sort);
+};
+
+// In-memory index of recordings under the recording folder.
+// Metadata comes from the embedded "mmdt" chunk via WavMeta::Read, which
+// only touches the header region of each file, so search never re-parses
+// free-form text files (legacy .txt sidecars are read once on scan).
+//
+// Loading is two-phase so a large archive shows up at once: ScanFiles()
+// only lists the folder tree, then LoadPendingHeaders() fills in duration
+// and metadata in batches. Headers of unchanged files survive a rescan.
+// Every change bumps the generation; entry ids (indices, newest first)
+// returned by Query() are only valid for the generation they came with.
+class RecordingCatalog {
+public:
+    // Rebuild the index from disk (newest first), headers included
+    void Rescan(const std::string& rootFolder);
+
+    // Phase 1: file list, sizes and dates only
+    void ScanFiles(const std::string& rootFolder);
+
+    // Phase 2: read up to maxCount missing headers; returns how many were
+    // read (0 once every entry is loaded)
+    size_t LoadPendingHeaders(size_t maxCount);
+
+    // Add or refresh a single recording (e.g. right after it was saved)
+    void AddOrUpdate(const std::string& wavPath);
+
+    // Forget a recording that was deleted from disk
+    void Remove(const std::string& wavPath);
+
+    // Copy of the current entries
+    std::vector<CatalogEntry> Snapshot() const;
+
+    // Case-insensitive match on file name and metadata values.
+    // Returns the path of the newest match, or empty string.
+    std::string FindByQuery(const std::string& query) const;
+
+    size_t GetCount() const;
+    uint64_t GetGeneration() const;
+
+    // Ids of the matching entries in the requested order
+    std::vector<uint32_t> Query(const CatalogQuery& query, uint64_t* generation) const;
+
+    // Copy entries ids[first, first + count) out. Fails (returns false) if
+    // the catalog changed since the ids were produced.
+    bool ReadEntries(const std::vector<uint32_t>& ids, uint64_t generation,
+                     size_t first, size_t count, std::vector<CatalogEntry>& out) const;
+
+    // Id of a path for the given generation, or -1
+    int64_t FindId(const std::string& path, uint64_t generation) const;
+
+private:
+    static bool LoadEntry(const std::string& wavPath, CatalogEntry& entry);
+    static bool LoadHeader(CatalogEntry& entry);
+    size_t IndexOfLocked(const std::string& path) const;
+
+    mutable std::mutex m_mutex;
+    std::vector<CatalogEntry> m_entries;
+    uint64_t m_generation = 0;
+    size_t m_pendingCursor = 0;     // No unloaded header before this index
+};
+
+// Process-wide catalog used by the player, search and API
+RecordingCatalog& GetRecordingCatalog();
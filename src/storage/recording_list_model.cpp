@@ -0,0 +1,75 @@
+#include "storage/recording_list_model.h"
+#include <algorithm>
+
+void RecordingListModel::SetQuery(const CatalogQuery& query) {
+    m_query = query;
+    Requery();
+}
+
+bool RecordingListModel::Refresh() {
+    if (m_catalog.GetGeneration() == m_generation) return false;
+    Requery();
+    return true;
+}
+
+void RecordingListModel::Requery() {
+    m_ids = m_catalog.Query(m_query, &m_generation);
+    m_window.clear();
+    m_windowFirst = 0;
+}
+
+bool RecordingListModel::LoadWindow(int first, int count) {
+    first = std::max(0, first);
+    if (!m_catalog.ReadEntries(m_ids, m_generation, (size_t)first, (size_t)count, m_scratch)) {
+        // The catalog moved on; ids are stale
+        Requery();
+        if (!m_catalog.ReadEntries(m_ids, m_generation, (size_t)first, (size_t)count, m_scratch)) return false;
+    }
+
+    m_window.resize(m_scratch.size());
+    for (size_t i = 0; i < m_scratch.size(); i++) {
+        CatalogEntry& e = m_scratch[i];
+        RecordingRow& r = m_window[i];
+        r.path       = std::move(e.path);
+        r.display    = std::move(e.name);
+        r.dateStr    = std::move(e.dateFolder);
+        r.sizeKB     = (uint32_t)(e.sizeBytes / 1024);
+        r.durationMs = e.durationMs;
+    }
+    m_windowFirst = first;
+    return true;
+}
+
+void RecordingListModel::SetVisibleRange(int first, int count) {
+    int last = std::min(first + count, GetCount());
+    first = std::max(0, first);
+    int windowLast = m_windowFirst + (int)m_window.size();
+    if (first >= m_windowFirst && last <= windowLast) return;
+    LoadWindow(first - PAGE_MARGIN, count + 2 * PAGE_MARGIN);
+}
+
+const RecordingRow* RecordingListModel::GetRow(int index) {
+    if (index < 0 || index >= GetCount()) return nullptr;
+    if (index < m_windowFirst || index >= m_windowFirst + (int)m_window.size()) {
+        if (!LoadWindow(index - PAGE_MARGIN, 2 * PAGE_MARGIN + 1)) return nullptr;
+        if (index - m_windowFirst >= (int)m_window.size()) return nullptr;  // Requery shrank the list
+    }
+    return &m_window[index - m_windowFirst];
+}
+
+std::string RecordingListModel::GetPath(int index) {
+    const RecordingRow* row = GetRow(index);
+    return row ? row->path : std::string();
+}
+
+int RecordingListModel::IndexOf(const std::string& path) {
+    if (path.empty()) return -1;
+    int64_t id = m_catalog.FindId(path, m_generation);
+    if (id < 0) {
+        if (!Refresh()) return -1;
+        id = m_catalog.FindId(path, m_generation);
+        if (id < 0) return -1;
+    }
+    auto it = std::find(m_ids.begin(), m_ids.end(), (uint32_t)id);
+    return it == m_ids.end() ? -1 : (int)(it - m_ids.begin());
+}
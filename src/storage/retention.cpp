@@ -0,0 +1,347 @@
+#include "storage/retention.h"
+#include "storage/recording_catalog.h"
+#include "core/json.h"
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <cstdio>
+#include <cctype>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// One recording and all files that belong to it
+struct RetentionItem {
+    fs::path wavPath;
+    std::vector<fs::path> files;     // .wav + companions
+    uint64_t bytes = 0;
+    time_t folderTime = 0;           // Local midnight of the date folder
+    fs::file_time_type mtime;
+    bool held = false;
+    bool marked = false;
+    RetentionReason reason = RetentionReason::Age;
+};
+
+std::string ToLower(std::string s) {
+    for (auto& c : s) c = (char)tolower((unsigned char)c);
+    return s;
+}
+
+bool LocalTime(time_t t, struct tm& out) {
+#ifdef _WIN32
+    return localtime_s(&out, &t) == 0;
+#else
+    return localtime_r(&t, &out) != nullptr;
+#endif
+}
+
+void ScanDateFolder(const fs::path& folder, time_t folderTime, std::vector<RetentionItem>& out) {
+    std::error_code ec;
+    bool folderHeld = fs::exists(folder / ".hold", ec);
+
+    // Group every file by stem so companions go with their recording
+    std::map<std::string, std::vector<std::pair<fs::path, uint64_t>>> byStem;
+    std::map<std::string, fs::path> wavByStem;
+    std::map<std::string, fs::file_time_type> mtimeByStem;
+    std::vector<std::string> heldStems;
+
+    for (fs::directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code fec;
+        if (!it->is_regular_file(fec)) continue;
+        const fs::path& p = it->path();
+        std::string stem = p.stem().string();
+        std::string ext = ToLower(p.extension().string());
+
+        if (ext == ".hold") {
+            heldStems.push_back(stem);
+            continue;
+        }
+        // In-progress temp files (~recording_*.wav.tmp) are never retention candidates
+        if (ext == ".tmp") continue;
+
+        uint64_t size = it->file_size(fec);
+        if (fec) size = 0;
+        byStem[stem].emplace_back(p, size);
+        if (ext == ".wav") {
+            wavByStem[stem] = p;
+            mtimeByStem[stem] = it->last_write_time(fec);
+        }
+    }
+
+    for (const auto& kv : wavByStem) {
+        RetentionItem item;
+        item.wavPath = kv.second;
+        item.folderTime = folderTime;
+        item.mtime = mtimeByStem[kv.first];
+        item.held = folderHeld || std::find(heldStems.begin(), heldStems.end(), kv.first) != heldStems.end();
+        for (const auto& f : byStem[kv.first]) {
+            item.files.push_back(f.first);
+            item.bytes += f.second;
+        }
+        out.push_back(std::move(item));
+    }
+}
+
+const char* ReasonName(RetentionReason r) {
+    switch (r) {
+        case RetentionReason::Age:       return "age";
+        case RetentionReason::Budget:    return "budget";
+        case RetentionReason::FreeSpace: return "free_space";
+    }
+    return "";
+}
+
+} // namespace
+
+std::string DateFolderName(time_t t) {
+    struct tm tmNow = {};
+    if (!LocalTime(t, tmNow)) return "";
+    char buf[16];
+    strftime(buf, sizeof(buf), "%Y-%m-%d", &tmNow);
+    return buf;
+}
+
+time_t ParseDateFolderName(const std::string& name) {
+    int year, month, day;
+    char tail;
+    if (name.size() != 10 || std::sscanf(name.c_str(), "%4d-%2d-%2d%c", &year, &month, &day, &tail) != 3) {
+        return -1;
+    }
+    struct tm tmFolder = {};
+    tmFolder.tm_year = year - 1900;
+    tmFolder.tm_mon = month - 1;
+    tmFolder.tm_mday = day;
+    tmFolder.tm_isdst = -1;
+    return mktime(&tmFolder);
+}
+
+bool IsUnderLegalHold(const std::string& wavPath) {
+    std::error_code ec;
+    fs::path p(wavPath);
+    fs::path marker = p;
+    marker.replace_extension(".hold");
+    return fs::exists(marker, ec) || fs::exists(p.parent_path() / ".hold", ec);
+}
+
+std::string RetentionReport::ToJson(size_t maxActions) const {
+    std::string json;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+        "{\"dry_run\":%s,\"files_scanned\":%llu,\"bytes_scanned\":%llu,\"free_bytes\":%llu,"
+        "\"files_to_delete\":%llu,\"bytes_to_delete\":%llu,\"files_held\":%llu,"
+        "\"files_deleted\":%llu,\"bytes_deleted\":%llu,\"errors\":%llu,\"cancelled\":%s,\"actions\":[",
+        dryRun ? "true" : "false",
+        (unsigned long long)filesScanned, (unsigned long long)bytesScanned, (unsigned long long)freeBytes,
+        (unsigned long long)filesToDelete, (unsigned long long)bytesToDelete, (unsigned long long)filesHeld,
+        (unsigned long long)filesDeleted, (unsigned long long)bytesDeleted, (unsigned long long)errors,
+        cancelled ? "true" : "false");
+    json = buf;
+
+    size_t n = std::min(maxActions, actions.size());
+    for (size_t i = 0; i < n; i++) {
+        const auto& a = actions[i];
+        if (i) json += ",";
+        // Date folder and name only: the report goes out over the local API
+        fs::path wav(a.wavPath);
+        json += "{\"file\":\"" + JsonEscape((wav.parent_path().filename() / wav.filename()).string()) + "\"";
+        std::snprintf(buf, sizeof(buf), ",\"bytes\":%llu,\"reason\":\"%s\",\"held\":%s}",
+            (unsigned long long)a.bytes, ReasonName(a.reason), a.held ? "true" : "false");
+        json += buf;
+    }
+    json += "]}";
+    return json;
+}
+
+RetentionReport RetentionEngine::Plan(const std::string& rootFolder, const RetentionPolicy& policy,
+                                      time_t now, uint64_t freeBytesOverride) {
+    RetentionReport report;
+    if (rootFolder.empty() || !policy.IsEnabled()) return report;
+
+    std::vector<RetentionItem> items;
+    std::string today = DateFolderName(now);
+    std::error_code ec;
+
+    for (fs::directory_iterator it(rootFolder, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code dec;
+        if (!it->is_directory(dec)) continue;
+        std::string name = it->path().filename().string();
+        if (name == today) continue;
+        time_t folderTime = ParseDateFolderName(name);
+        if (folderTime == -1) continue;
+        ScanDateFolder(it->path(), folderTime, items);
+    }
+
+    // Oldest first: date folder, then file time
+    std::sort(items.begin(), items.end(), [](const RetentionItem& a, const RetentionItem& b) {
+        if (a.folderTime != b.folderTime) return a.folderTime < b.folderTime;
+        return a.mtime < b.mtime;
+    });
+
+    uint64_t totalBytes = 0;
+    for (const auto& item : items) totalBytes += item.bytes;
+    report.filesScanned = items.size();
+    report.bytesScanned = totalBytes;
+
+    if (freeBytesOverride) {
+        report.freeBytes = freeBytesOverride;
+    } else {
+        std::error_code sec;
+        fs::space_info si = fs::space(rootFolder, sec);
+        report.freeBytes = sec ? 0 : si.available;
+    }
+
+    uint64_t reclaim = 0;
+    auto mark = [&](RetentionItem& item, RetentionReason reason) {
+        item.marked = true;
+        item.reason = reason;
+        if (!item.held) reclaim += item.bytes;
+    };
+
+    // Age quota (same rule as the old folder cleanup: older than N days)
+    if (policy.maxAgeDays > 0) {
+        for (auto& item : items) {
+            int daysOld = (int)(difftime(now, item.folderTime) / (60 * 60 * 24));
+            if (daysOld > policy.maxAgeDays) mark(item, RetentionReason::Age);
+        }
+    }
+
+    // Byte budget over everything that is kept
+    if (policy.maxTotalBytes > 0) {
+        for (auto& item : items) {
+            if (totalBytes - reclaim <= policy.maxTotalBytes) break;
+            if (!item.marked) mark(item, RetentionReason::Budget);
+        }
+    }
+
+    // Free space floor - only meaningful if we know the free space
+    if (policy.minFreeBytes > 0 && report.freeBytes > 0) {
+        for (auto& item : items) {
+            if (report.freeBytes + reclaim >= policy.minFreeBytes) break;
+            if (!item.marked) mark(item, RetentionReason::FreeSpace);
+        }
+    }
+
+    for (const auto& item : items) {
+        if (!item.marked) continue;
+        RetentionAction action;
+        action.wavPath = item.wavPath.string();
+        for (const auto& f : item.files) {
+            if (f != item.wavPath) action.companions.push_back(f.string());
+        }
+        action.bytes = item.bytes;
+        action.reason = item.reason;
+        action.held = item.held;
+        if (item.held) {
+            report.filesHeld++;
+        } else {
+            report.filesToDelete++;
+            report.bytesToDelete += item.bytes;
+        }
+        report.actions.push_back(std::move(action));
+    }
+    return report;
+}
+
+RetentionReport RetentionEngine::Run(const std::string& rootFolder, const RetentionPolicy& policy) {
+    RetentionReport report = Plan(rootFolder, policy, std::time(nullptr));
+    report.dryRun = false;
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    uint64_t attempts = 0;
+    std::vector<fs::path> touchedFolders;
+
+    for (const auto& action : report.actions) {
+        if (action.held) continue;
+        if (m_cancel) { report.cancelled = true; break; }
+
+        // Rate limit: spread deletes so the disk stays responsive for recording
+        if (policy.maxDeletesPerSecond > 0 && attempts > 0) {
+            auto due = start + std::chrono::milliseconds(attempts * 1000 / policy.maxDeletesPerSecond);
+            if (due > Clock::now()) std::this_thread::sleep_until(due);
+        }
+        attempts++;
+
+        fs::path wav(action.wavPath);
+        fs::path folder = wav.parent_path();
+        bool ok = true;
+
+        // Remove companions first so a half-deleted recording still has its .wav
+        for (const auto& companion : action.companions) {
+            std::error_code cec;
+            if (!fs::remove(companion, cec) && cec) ok = false;
+        }
+        std::error_code wec;
+        if (!fs::remove(wav, wec) && wec) ok = false;
+
+        if (ok) {
+            report.filesDeleted++;
+            report.bytesDeleted += action.bytes;
+            GetRecordingCatalog().Remove(action.wavPath);
+        } else {
+            report.errors++;
+        }
+        if (touchedFolders.empty() || touchedFolders.back() != folder) touchedFolders.push_back(folder);
+    }
+
+    // Drop date folders that are now empty (fails harmlessly otherwise)
+    for (const auto& folder : touchedFolders) {
+        std::error_code ec;
+        if (fs::is_empty(folder, ec) && !ec) fs::remove(folder, ec);
+    }
+
+    std::lock_guard<std::mutex> lock(m_reportMutex);
+    m_lastReport = report;
+    return report;
+}
+
+bool RetentionEngine::RunAsync(const std::string& rootFolder, const RetentionPolicy& policy) {
+    if (m_running.exchange(true)) return false;
+    if (m_thread.joinable()) m_thread.join();
+
+    m_cancel = false;
+    m_thread = std::thread([this, rootFolder, policy]() {
+#ifdef _WIN32
+        // Background mode lowers CPU, I/O and memory priority for this thread
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#endif
+        Run(rootFolder, policy);
+#ifdef _WIN32
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+#endif
+        m_running = false;
+    });
+    return true;
+}
+
+void RetentionEngine::Cancel() {
+    m_cancel = true;
+}
+
+void RetentionEngine::Wait() {
+    if (m_thread.joinable()) m_thread.join();
+}
+
+RetentionEngine::~RetentionEngine() {
+    Cancel();
+    Wait();
+}
+
+RetentionReport RetentionEngine::GetLastReport() const {
+    std::lock_guard<std::mutex> lock(m_reportMutex);
+    return m_lastReport;
+}
+
+RetentionEngine& GetRetentionEngine() {
+    static RetentionEngine engine;
+    return engine;
+}
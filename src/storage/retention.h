@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+// Recording retention (auto-delete) engine.
+//
+// Recordings live in <root>\YYYY-MM-DD\*.wav. A recording is the .wav plus
+// its companions (.meta, legacy .txt). Deletion candidates are picked oldest
+// first by three independent quotas:
+//   - age:        date folder older than maxAgeDays
+//   - byte budget: total size of all recordings above maxTotalBytes
+//   - free space: free disk space on the volume below minFreeBytes
+// Anything under legal hold is never deleted:
+//   - <name>.hold next to the recording holds that one recording
+//   - .hold inside a date folder holds the whole folder
+// Today's folder is never touched (the active recording is written there).
+//
+// Planning is pure (no deletes) so it doubles as the dry-run report.
+// Execution runs on a low-priority background thread and is rate limited,
+// so enabling auto record never blocks the UI on a large archive.
+
+struct RetentionPolicy {
+    int      maxAgeDays = 0;          // 0 = no age limit
+    uint64_t maxTotalBytes = 0;       // 0 = no byte budget
+    uint64_t minFreeBytes = 0;        // 0 = don't check free space
+    int      maxDeletesPerSecond = 20; // 0 = unlimited
+
+    bool IsEnabled() const { return maxAgeDays > 0 || maxTotalBytes > 0 || minFreeBytes > 0; }
+};
+
+enum class RetentionReason { Age, Budget, FreeSpace };
+
+struct RetentionAction {
+    std::string wavPath;
+    std::vector<std::string> companions; // .meta, legacy .txt, ...
+    uint64_t    bytes = 0;            // Including companion files
+    RetentionReason reason = RetentionReason::Age;
+    bool        held = false;         // Would be deleted but is under legal hold
+};
+
+struct RetentionReport {
+    bool     dryRun = true;
+    uint64_t filesScanned = 0;
+    uint64_t bytesScanned = 0;
+    uint64_t freeBytes = 0;           // Free space on the volume at scan time
+    uint64_t filesToDelete = 0;
+    uint64_t bytesToDelete = 0;
+    uint64_t filesHeld = 0;
+    uint64_t filesDeleted = 0;        // Only for executed runs
+    uint64_t bytesDeleted = 0;
+    uint64_t errors = 0;
+    bool     cancelled = false;
+    std::vector<RetentionAction> actions; // Oldest first
+
+    // Summary (and at most maxActions actions) as JSON for the HTTP API.
+    // Actions name the recording as <date folder>\<file>, not the full path.
+    std::string ToJson(size_t maxActions = 50) const;
+};
+
+class RetentionEngine {
+public:
+    RetentionEngine() = default;
+    ~RetentionEngine();
+
+    // Scan rootFolder and decide what the policy would delete. No side effects.
+    // freeBytesOverride is used instead of querying the volume when non-zero.
+    static RetentionReport Plan(const std::string& rootFolder, const RetentionPolicy& policy,
+                                time_t now, uint64_t freeBytesOverride = 0);
+
+    // Plan and delete on a background thread. Returns false if already running.
+    bool RunAsync(const std::string& rootFolder, const RetentionPolicy& policy);
+
+    // Plan and delete on the calling thread (used by RunAsync)
+    RetentionReport Run(const std::string& rootFolder, const RetentionPolicy& policy);
+
+    void Cancel();
+    void Wait();
+    bool IsRunning() const { return m_running; }
+
+    // Report of the last completed run
+    RetentionReport GetLastReport() const;
+
+private:
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_cancel{false};
+    mutable std::mutex m_reportMutex;
+    RetentionReport m_lastReport;
+};
+
+// Local date of t as a "YYYY-MM-DD" date folder name
+std::string DateFolderName(time_t t);
+
+// "YYYY-MM-DD" date folder name -> local midnight, or -1 if not a date folder
+time_t ParseDateFolderName(const std::string& name);
+
+// True if the recording or its date folder carries a .hold marker
+bool IsUnderLegalHold(const std::string& wavPath);
+
+// Process-wide engine
+RetentionEngine& GetRetentionEngine();
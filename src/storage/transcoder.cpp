@@ -0,0 +1,339 @@
+#include "storage/transcoder.h"
+#include "storage/retention.h"
+#include "storage/recording_catalog.h"
+#include "storage/encrypted_recording.h"
+#include "audio/WavMetadata.h"
+#include "audio/ImaAdpcm.h"
+#include "core/thread_pool.h"
+#include <filesystem>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+static void PutU16(std::vector<char>& buf, uint16_t v) {
+    buf.insert(buf.end(), reinterpret_cast<char*>(&v), reinterpret_cast<char*>(&v) + 2);
+}
+
+static void PutU32(std::vector<char>& buf, uint32_t v) {
+    buf.insert(buf.end(), reinterpret_cast<char*>(&v), reinterpret_cast<char*>(&v) + 4);
+}
+
+// Header up to and including the "data" chunk header of the ADPCM file
+static std::vector<char> BuildAdpcmHeader(const WavInfo& pcm, uint16_t blockAlign, uint32_t samplesPerBlock,
+                                          uint32_t frames, uint32_t dataBytes, const WavMetadata& metadata) {
+    std::vector<char> meta = WavMeta::BuildChunks(metadata);
+    uint32_t byteRate = (uint32_t)((uint64_t)pcm.sampleRate * blockAlign / samplesPerBlock);
+
+    std::vector<char> h;
+    h.insert(h.end(), { 'R', 'I', 'F', 'F' });
+    PutU32(h, 0); // Patched below
+    h.insert(h.end(), { 'W', 'A', 'V', 'E' });
+
+    h.insert(h.end(), { 'f', 'm', 't', ' ' });
+    PutU32(h, 20);
+    PutU16(h, ImaAdpcm::FORMAT_TAG);
+    PutU16(h, pcm.channels);
+    PutU32(h, pcm.sampleRate);
+    PutU32(h, byteRate);
+    PutU16(h, blockAlign);
+    PutU16(h, 4);                          // Bits per sample
+    PutU16(h, 2);                          // cbSize
+    PutU16(h, (uint16_t)samplesPerBlock);
+
+    // Compressed formats need the real sample count
+    h.insert(h.end(), { 'f', 'a', 'c', 't' });
+    PutU32(h, 4);
+    PutU32(h, frames);
+
+    h.insert(h.end(), meta.begin(), meta.end());
+
+    h.insert(h.end(), { 'd', 'a', 't', 'a' });
+    PutU32(h, dataBytes);
+
+    uint32_t riffSize = (uint32_t)(h.size() - 8 + dataBytes + (dataBytes & 1));
+    memcpy(h.data() + 4, &riffSize, 4);
+    return h;
+}
+
+std::vector<std::string> ArchiveTranscoder::FindCandidates(const std::string& rootFolder, int minAgeDays, time_t now) {
+    std::vector<std::string> out;
+    if (rootFolder.empty() || minAgeDays <= 0) return out;
+
+    std::error_code ec;
+    for (fs::directory_iterator it(rootFolder, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code dec;
+        if (!it->is_directory(dec)) continue;
+        time_t folderTime = ParseDateFolderName(it->path().filename().string());
+        if (folderTime == -1) continue;
+        int daysOld = (int)(difftime(now, folderTime) / (60 * 60 * 24));
+        if (daysOld <= minAgeDays) continue;
+        if (fs::exists(it->path() / ".hold", dec)) continue;
+
+        for (fs::directory_iterator fit(it->path(), dec), fend; !dec && fit != fend; fit.increment(dec)) {
+            std::error_code fec;
+            if (!fit->is_regular_file(fec)) continue;
+            std::string ext = fit->path().extension().string();
+            for (auto& c : ext) c = (char)tolower((unsigned char)c);
+            if (ext != ".wav") continue;
+            std::string path = fit->path().string();
+            if (IsUnderLegalHold(path)) continue;
+            out.push_back(path);
+        }
+    }
+    return out;
+}
+
+TranscodeResult ArchiveTranscoder::TranscodeFile(const std::string& wavPath, double minSnrDb,
+                                                 const std::function<bool()>& keepGoing) {
+    TranscodeResult result;
+    result.path = wavPath;
+
+    // The container is not RIFF, and an ADPCM copy would be written in the clear
+    if (EncryptedRecording::IsEncrypted(wavPath)) {
+        result.message = "encrypted";
+        return result;
+    }
+
+    WavMetadata metadata;
+    WavInfo pcm;
+    if (!WavMeta::Read(wavPath, metadata, &pcm) && pcm.dataOffset == 0) {
+        result.status = TranscodeStatus::Failed;
+        result.message = "not a wav file";
+        return result;
+    }
+    if (pcm.formatTag != 1 || pcm.bitsPerSample != 16 || pcm.channels < 1 || pcm.channels > 2) {
+        result.message = "not 16-bit pcm";
+        return result;
+    }
+    if (pcm.dataBytes < pcm.blockAlign) {
+        result.message = "empty";
+        return result;
+    }
+    if (metadata.empty()) WavMeta::ReadSidecar(wavPath, metadata);
+
+    std::error_code ec;
+    result.bytesBefore = fs::file_size(wavPath, ec);
+
+    const uint16_t channels = pcm.channels;
+    const uint16_t blockAlign = ImaAdpcm::GetBlockAlign(pcm.sampleRate, channels);
+    const uint32_t spb = ImaAdpcm::GetSamplesPerBlock(blockAlign, channels);
+    const uint32_t frames = (uint32_t)(pcm.dataBytes / pcm.blockAlign);
+    const uint32_t blocks = (frames + spb - 1) / spb;
+    const uint32_t dataBytes = blocks * blockAlign;
+
+    metadata["codec"] = "ima_adpcm";
+    metadata["original_bytes"] = std::to_string(result.bytesBefore);
+
+    std::string tmpPath = wavPath + ".adpcm.tmp";
+    auto fail = [&](TranscodeStatus status, const char* message) {
+        std::error_code rec;
+        fs::remove(tmpPath, rec);
+        result.status = status;
+        result.message = message;
+        return result;
+    };
+
+    // ── Encode ──
+    {
+        std::ifstream in(wavPath, std::ios::binary);
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!in.is_open() || !out.is_open()) return fail(TranscodeStatus::Failed, "cannot open");
+
+        std::vector<char> header = BuildAdpcmHeader(pcm, blockAlign, spb, frames, dataBytes, metadata);
+        out.write(header.data(), header.size());
+        in.seekg((std::streamoff)pcm.dataOffset, std::ios::beg);
+
+        std::vector<int16_t> pcmBlock((size_t)spb * channels);
+        std::vector<uint8_t> adpcmBlock(blockAlign);
+        ImaAdpcm::ChannelState state[2];
+        uint32_t remaining = frames;
+
+        for (uint32_t b = 0; b < blocks; b++) {
+            if (keepGoing && !keepGoing()) return fail(TranscodeStatus::Cancelled, "cancelled");
+            uint32_t n = remaining < spb ? remaining : spb;
+            in.read(reinterpret_cast<char*>(pcmBlock.data()), (std::streamsize)n * channels * 2);
+            if ((uint32_t)in.gcount() != n * channels * 2) return fail(TranscodeStatus::Failed, "short read");
+            ImaAdpcm::EncodeBlock(pcmBlock.data(), n, channels, blockAlign, state, adpcmBlock.data());
+            out.write(reinterpret_cast<char*>(adpcmBlock.data()), blockAlign);
+            remaining -= n;
+        }
+        if (dataBytes & 1) out.put(0);
+        out.flush();
+        if (out.fail()) return fail(TranscodeStatus::Failed, "write failed");
+    }
+
+    // ── Verify: decode the new file and compare with the original ──
+    {
+        WavMetadata checkMeta;
+        WavInfo adpcm;
+        WavMeta::Read(tmpPath, checkMeta, &adpcm);
+        if (adpcm.formatTag != ImaAdpcm::FORMAT_TAG || adpcm.dataBytes != dataBytes ||
+            checkMeta.size() != metadata.size()) {
+            return fail(TranscodeStatus::Failed, "header check failed");
+        }
+
+        std::ifstream orig(wavPath, std::ios::binary);
+        std::ifstream enc(tmpPath, std::ios::binary);
+        orig.seekg((std::streamoff)pcm.dataOffset, std::ios::beg);
+        enc.seekg((std::streamoff)adpcm.dataOffset, std::ios::beg);
+
+        std::vector<int16_t> expected((size_t)spb * channels);
+        std::vector<int16_t> decoded((size_t)spb * channels);
+        std::vector<uint8_t> block(blockAlign);
+        double signal = 0.0, noise = 0.0;
+        uint32_t remaining = frames;
+
+        for (uint32_t b = 0; b < blocks; b++) {
+            if (keepGoing && !keepGoing()) return fail(TranscodeStatus::Cancelled, "cancelled");
+            uint32_t n = remaining < spb ? remaining : spb;
+            orig.read(reinterpret_cast<char*>(expected.data()), (std::streamsize)n * channels * 2);
+            enc.read(reinterpret_cast<char*>(block.data()), blockAlign);
+            if (!orig || !enc) return fail(TranscodeStatus::Failed, "verify read failed");
+            if (ImaAdpcm::DecodeBlock(block.data(), blockAlign, channels, decoded.data()) < n) {
+                return fail(TranscodeStatus::Failed, "verify decode failed");
+            }
+            for (uint32_t i = 0; i < n * channels; i++) {
+                double s = expected[i];
+                double e = s - decoded[i];
+                signal += s * s;
+                noise += e * e;
+            }
+            remaining -= n;
+        }
+
+        double total = (double)frames * channels;
+        result.snrDb = noise > 0.0 ? 10.0 * std::log10((signal + 1.0) / noise) : 99.0;
+        // Near-silent files have a poor SNR by definition; accept a tiny absolute error
+        bool quiet = noise / total < 16.0;
+        if (result.snrDb < minSnrDb && !quiet) {
+            return fail(TranscodeStatus::Failed, "round-trip snr too low");
+        }
+    }
+
+    // ── Swap in atomically, keep the original timestamp for retention ordering ──
+    fs::file_time_type mtime = fs::last_write_time(wavPath, ec);
+    if (!ec) fs::last_write_time(tmpPath, mtime, ec);
+    fs::rename(tmpPath, wavPath, ec);
+    if (ec) return fail(TranscodeStatus::Failed, "rename failed");
+
+    result.bytesAfter = fs::file_size(wavPath, ec);
+    result.status = TranscodeStatus::Transcoded;
+    GetRecordingCatalog().AddOrUpdate(wavPath);
+    return result;
+}
+
+bool ArchiveTranscoder::Checkpoint() {
+    std::unique_lock<std::mutex> lock(m_pauseMutex);
+    m_pauseCv.wait(lock, [this] { return m_pauseCount == 0 || m_cancel; });
+    return !m_cancel;
+}
+
+TranscodeSummary ArchiveTranscoder::Run(const std::string& rootFolder, const TranscodeOptions& options,
+                                        const std::function<void(const TranscodeResult&)>& onResult) {
+    TranscodeSummary summary;
+    std::vector<std::string> files = FindCandidates(rootFolder, options.minAgeDays, std::time(nullptr));
+    summary.candidates = files.size();
+
+    if (options.dryRun) {
+        for (const auto& f : files) {
+            TranscodeResult r;
+            r.path = f;
+            r.message = "dry run";
+            summary.skipped++;
+            if (onResult) onResult(r);
+        }
+    } else if (!files.empty()) {
+        std::mutex summaryMutex;
+        ThreadPool pool(options.threads);
+        for (const auto& f : files) {
+            pool.Submit([&, f]() {
+                TranscodeResult r;
+                if (m_cancel) {
+                    r.path = f;
+                    r.status = TranscodeStatus::Cancelled;
+                } else {
+                    r = TranscodeFile(f, options.minSnrDb, [this]() { return Checkpoint(); });
+                }
+                {
+                    std::lock_guard<std::mutex> lock(summaryMutex);
+                    switch (r.status) {
+                        case TranscodeStatus::Transcoded:
+                            summary.transcoded++;
+                            summary.bytesBefore += r.bytesBefore;
+                            summary.bytesAfter += r.bytesAfter;
+                            break;
+                        case TranscodeStatus::Skipped:   summary.skipped++; break;
+                        case TranscodeStatus::Failed:    summary.failed++; break;
+                        case TranscodeStatus::Cancelled: summary.cancelled = true; break;
+                    }
+                }
+                if (onResult) onResult(r);
+            });
+        }
+        pool.WaitIdle();
+    }
+
+    std::lock_guard<std::mutex> lock(m_summaryMutex);
+    m_lastSummary = summary;
+    return summary;
+}
+
+bool ArchiveTranscoder::RunAsync(const std::string& rootFolder, const TranscodeOptions& options) {
+    if (m_running.exchange(true)) return false;
+    if (m_thread.joinable()) m_thread.join();
+
+    m_cancel = false;
+    m_thread = std::thread([this, rootFolder, options]() {
+        Run(rootFolder, options);
+        m_running = false;
+    });
+    return true;
+}
+
+void ArchiveTranscoder::Pause() {
+    std::lock_guard<std::mutex> lock(m_pauseMutex);
+    m_pauseCount++;
+}
+
+void ArchiveTranscoder::Resume() {
+    {
+        std::lock_guard<std::mutex> lock(m_pauseMutex);
+        if (m_pauseCount > 0) m_pauseCount--;
+    }
+    m_pauseCv.notify_all();
+}
+
+bool ArchiveTranscoder::IsPaused() const {
+    std::lock_guard<std::mutex> lock(m_pauseMutex);
+    return m_pauseCount > 0;
+}
+
+void ArchiveTranscoder::Cancel() {
+    {
+        std::lock_guard<std::mutex> lock(m_pauseMutex);
+        m_cancel = true;
+    }
+    m_pauseCv.notify_all();
+}
+
+void ArchiveTranscoder::Wait() {
+    if (m_thread.joinable()) m_thread.join();
+}
+
+ArchiveTranscoder::~ArchiveTranscoder() {
+    Cancel();
+    Wait();
+}
+
+TranscodeSummary ArchiveTranscoder::GetLastSummary() const {
+    std::lock_guard<std::mutex> lock(m_summaryMutex);
+    return m_lastSummary;
+}
+
+ArchiveTranscoder& GetArchiveTranscoder() {
+    static ArchiveTranscoder transcoder;
+    return transcoder;
+}
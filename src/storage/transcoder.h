@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <ctime>
+
+// Archive transcoder: rewrites old 16-bit PCM recordings as IMA ADPCM WAV
+// (about 4x smaller, still playable by Windows and the built-in player).
+//
+// Each file is encoded to <name>.wav.adpcm.tmp, then decoded again and
+// compared against the original PCM. Only if the round trip matches
+// (sample count, SNR above the threshold) is the temp file renamed over
+// the original. The catalog entry is then refreshed, so readers see either
+// the old or the new file, never a partial one. Embedded metadata is
+// carried over and tagged with the codec and original size.
+//
+// Recordings under legal hold and today's folder are never touched.
+// Encrypted recordings are reported as skipped and left as they are.
+
+struct TranscodeOptions {
+    int    minAgeDays = 30;     // Only date folders older than this
+    double minSnrDb = 20.0;     // Round-trip quality gate
+    size_t threads = 0;         // 0 = idle cores
+    bool   dryRun = false;      // List candidates only
+};
+
+enum class TranscodeStatus { Transcoded, Skipped, Failed, Cancelled };
+
+struct TranscodeResult {
+    std::string path;
+    TranscodeStatus status = TranscodeStatus::Skipped;
+    uint64_t bytesBefore = 0;
+    uint64_t bytesAfter = 0;
+    double snrDb = 0.0;
+    std::string message;        // Reason for skip / failure
+};
+
+struct TranscodeSummary {
+    size_t candidates = 0;
+    size_t transcoded = 0;
+    size_t skipped = 0;
+    size_t failed = 0;
+    uint64_t bytesBefore = 0;
+    uint64_t bytesAfter = 0;
+    bool cancelled = false;
+};
+
+class ArchiveTranscoder {
+public:
+    ArchiveTranscoder() = default;
+    ~ArchiveTranscoder();
+
+    // PCM .wav files in date folders older than minAgeDays (not held)
+    static std::vector<std::string> FindCandidates(const std::string& rootFolder, int minAgeDays, time_t now);
+
+    // Transcode a single file. keepGoing is polled between blocks; it may
+    // block (pause) and returns false to cancel.
+    static TranscodeResult TranscodeFile(const std::string& wavPath, double minSnrDb,
+                                         const std::function<bool()>& keepGoing = nullptr);
+
+    // Run the whole job on the calling thread using a work-stealing pool.
+    // onResult is called from worker threads.
+    TranscodeSummary Run(const std::string& rootFolder, const TranscodeOptions& options,
+                         const std::function<void(const TranscodeResult&)>& onResult = nullptr);
+
+    // Run in the background. Returns false if already running.
+    bool RunAsync(const std::string& rootFolder, const TranscodeOptions& options);
+
+    // Pause/Resume nest (auto and manual recording may overlap); workers
+    // stop at the next block boundary while paused.
+    void Pause();
+    void Resume();
+    void Cancel();
+    void Wait();
+
+    bool IsRunning() const { return m_running; }
+    bool IsPaused() const;
+    TranscodeSummary GetLastSummary() const;
+
+private:
+    bool Checkpoint();
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_cancel{false};
+
+    mutable std::mutex m_pauseMutex;
+    std::condition_variable m_pauseCv;
+    int m_pauseCount = 0;
+
+    mutable std::mutex m_summaryMutex;
+    TranscodeSummary m_lastSummary;
+};
+
+// Process-wide transcoder (paused while a call is being recorded)
+ArchiveTranscoder& GetArchiveTranscoder();
@@ -0,0 +1,132 @@
+// MicMute-S conversation analytics benchmark
+//
+// Feeds ConversationAnalytics a scripted two-party call (agent on the mic
+// track, customer on the loopback track: monologues, pauses, an overlap),
+// checks talk time, silence, overlap and longest monologues against the
+// script, then measures the cost of the stage in the mixer's 2 s chunks.
+// No Win32 dependencies:
+//
+//   Windows: see build.bat (analytics_bench.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o analytics_bench
+//              src/tools/analytics_bench.cpp src/audio/ConversationAnalytics.cpp
+//
+// Usage: analytics_bench [--minutes N]
+//        (exit code 1 if a check fails)
+
+#include "audio/ConversationAnalytics.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const uint32_t RATE = 48000;
+static const size_t CHUNK = RATE * 2;     // Mixer flush interval
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: analytics_bench [--minutes N]\n");
+}
+
+struct Span {
+    double start, end;
+};
+
+static bool InSpans(const std::vector<Span>& spans, double t) {
+    for (const Span& s : spans) {
+        if (t >= s.start && t < s.end) return true;
+    }
+    return false;
+}
+
+// Noise bursts with a syllable envelope and a 120 ms gap every second,
+// over a -70 dBFS noise floor
+class Voice {
+public:
+    explicit Voice(uint32_t seed) : m_seed(seed) {}
+
+    float Sample(bool talking, double t) {
+        m_seed = m_seed * 1664525u + 1013904223u;
+        float noise = ((m_seed >> 8) / 8388608.0f) - 1.0f;
+        if (!talking || std::fmod(t, 1.0) > 0.88) return noise * 0.0005f;
+        double envelope = 0.6 + 0.4 * std::fabs(std::sin(2.0 * 3.14159265358979 * 2.0 * t));
+        return noise * (float)(0.2 * envelope);
+    }
+
+private:
+    uint32_t m_seed;
+};
+
+static bool Near(double value, double expected, double tolerance) {
+    return std::fabs(value - expected) <= tolerance;
+}
+
+int main(int argc, char** argv) {
+    int minutes = 60;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--minutes") == 0 && hasValue) minutes = atoi(argv[++i]);
+        else { PrintUsage(); return 2; }
+    }
+    if (minutes < 1) minutes = 1;
+
+    // 0-20 s agent monologue, 3 s silence, customer 23-35 s, agent cuts in
+    // at 33 s (2 s overlap) and talks to 45 s, 5 s hold, customer 50-55 s
+    std::vector<Span> agent = {{0, 20}, {33, 45}};
+    std::vector<Span> customer = {{23, 35}, {50, 55}};
+    const double callSec = 60.0;
+
+    ConversationAnalytics analytics;
+    analytics.Start(RATE);
+    Voice agentVoice(1), customerVoice(2);
+    std::vector<float> mic(CHUNK), loop(CHUNK);
+    size_t total = (size_t)(callSec * RATE);
+    for (size_t done = 0; done < total; done += CHUNK) {
+        size_t n = total - done < CHUNK ? total - done : CHUNK;
+        for (size_t i = 0; i < n; i++) {
+            double t = (double)(done + i) / RATE;
+            mic[i] = agentVoice.Sample(InSpans(agent, t), t);
+            loop[i] = customerVoice.Sample(InSpans(customer, t), t);
+        }
+        analytics.AddFrames(mic.data(), loop.data(), n);
+    }
+    ConversationStats s = analytics.GetStats();
+    printf("Scripted call:\n  %s\n", s.ToJson().c_str());
+
+    printf("Checks:\n");
+    Check(Near(s.durationSec, 60.0, 0.05), "duration 60 s");
+    Check(Near(s.agentTalkSec, 32.0, 0.6), "agent talk 32 s");
+    Check(Near(s.customerTalkSec, 17.0, 0.6), "customer talk 17 s");
+    Check(Near(s.overlapSec, 2.0, 0.4), "overlap 2 s");
+    Check(Near(s.silenceSec, 13.0, 0.8), "silence 13 s");
+    Check(Near(s.longestAgentMonologueSec, 20.0, 0.5), "longest agent monologue 20 s");
+    Check(Near(s.longestCustomerMonologueSec, 10.0, 0.5), "longest customer monologue 10 s (ends at the overlap)");
+    WavMetadata md;
+    s.AddToMetadata(md);
+    Check(md.size() == 7 && Near(atof(md["silence_ratio"].c_str()), s.SilenceRatio(), 0.001), "metadata fields");
+
+    // Cost per mixer chunk over a long call (same buffers, steady state)
+    printf("Cost:\n");
+    ConversationAnalytics bench;
+    bench.Start(RATE);
+    size_t chunks = (size_t)minutes * 30;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < chunks; c++) bench.AddFrames(mic.data(), loop.data(), CHUNK);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double perChunkUs = sec * 1e6 / chunks;
+    double realtime = (minutes * 60.0) / (sec > 0 ? sec : 1e-9);
+    printf("  %d min of audio: %.1f ms, %.1f us per 2 s chunk, %.0fx realtime (%.4f%% of a core)\n",
+           minutes, sec * 1000.0, perChunkUs, realtime, 100.0 / realtime);
+    Check(realtime > 1000.0, "under 0.1% of a core");
+
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+// MicMute-S archive tool
+//
+// Batch version of the background archive transcoder, for running on a
+// file server against a synced recordings folder. No Win32 dependencies:
+//
+//   Windows: see build.bat (archive_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -pthread -I src -o archive_tool
+//              src/tools/archive_tool.cpp src/storage/transcoder.cpp src/storage/retention.cpp
+//              src/storage/recording_catalog.cpp src/audio/WavMetadata.cpp src/audio/ImaAdpcm.cpp
+//              src/core/thread_pool.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: archive_tool <recordings folder> [--days N] [--threads N] [--min-snr DB] [--dry-run]
+//        archive_tool --file <recording.wav> [--min-snr DB]
+//        archive_tool --selftest    (exit code 1 if a check fails)
+
+#include "storage/transcoder.h"
+#include "storage/encrypted_recording.h"
+#include "audio/WavMetadata.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void PrintUsage() {
+    printf("Usage: archive_tool <recordings folder> [--days N] [--threads N] [--min-snr DB] [--dry-run]\n");
+    printf("       archive_tool --file <recording.wav> [--min-snr DB]\n");
+    printf("       archive_tool --selftest\n");
+}
+
+static const char* StatusName(TranscodeStatus s) {
+    switch (s) {
+        case TranscodeStatus::Transcoded: return "OK  ";
+        case TranscodeStatus::Skipped:    return "SKIP";
+        case TranscodeStatus::Failed:     return "FAIL";
+        case TranscodeStatus::Cancelled:  return "STOP";
+    }
+    return "?";
+}
+
+static void PrintResult(const TranscodeResult& r) {
+    if (r.status == TranscodeStatus::Transcoded) {
+        printf("%s %s  %llu -> %llu bytes, snr %.1f dB\n", StatusName(r.status), r.path.c_str(),
+               (unsigned long long)r.bytesBefore, (unsigned long long)r.bytesAfter, r.snrDb);
+    } else {
+        printf("%s %s  %s\n", StatusName(r.status), r.path.c_str(), r.message.c_str());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Self test
+// ---------------------------------------------------------------------------
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static std::vector<char> LoadFile(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+// Ten seconds of 48 kHz mono speech-band tone, as the recorder writes it
+static std::vector<char> MakeAudio() {
+    const uint32_t rate = 48000;
+    std::vector<char> data(rate * 10 * 2);
+    for (size_t i = 0; i < data.size() / 2; i++) {
+        int16_t s = (int16_t)(9000.0 * sin(2.0 * 3.14159265358979 * 300.0 * i / rate) +
+                              3000.0 * sin(2.0 * 3.14159265358979 * 1100.0 * i / rate));
+        memcpy(&data[i * 2], &s, 2);
+    }
+    return data;
+}
+
+static bool WritePlain(const std::string& path, const std::vector<char>& data) {
+    std::vector<char> header = WavMeta::BuildHeader(48000, 1, 16, (uint32_t)data.size());
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(header.data(), header.size());
+    f.write(data.data(), data.size());
+    return f.good();
+}
+
+static bool WriteEncrypted(const std::string& path, const std::vector<char>& data) {
+    RecordingKey key;
+    if (!RecordingKey::Generate(key)) return false;
+    EncryptedRecordingWriter writer;
+    if (!writer.Open(path, key, 48000, 1, 16)) return false;
+    std::vector<char> header = WavMeta::BuildHeader(48000, 1, 16, (uint32_t)data.size());
+    writer.PatchHeader(0, header.data(), header.size());
+    return writer.Append(data.data(), data.size()) && writer.Finish();
+}
+
+static int SelfTest() {
+    fs::path root = fs::temp_directory_path() / "archive_tool_selftest";
+    std::error_code ec;
+    fs::remove_all(root, ec);
+
+    // A date folder well past the default 30 days
+    time_t old = std::time(nullptr) - 60 * 24 * 60 * 60;
+    struct tm tmOld = *localtime(&old);
+    char folderName[16];
+    strftime(folderName, sizeof(folderName), "%Y-%m-%d", &tmOld);
+    fs::path folder = root / folderName;
+    fs::create_directories(folder, ec);
+
+    const std::string plainPath = (folder / "call_plain.wav").string();
+    const std::string encPath = (folder / "call_encrypted.wav").string();
+    std::vector<char> audio = MakeAudio();
+
+    printf("Archive transcoder (%s)\n", folder.string().c_str());
+    Check(WritePlain(plainPath, audio), "writes a 10 s PCM recording");
+    Check(WriteEncrypted(encPath, audio) && EncryptedRecording::IsEncrypted(encPath),
+          "writes a 10 s encrypted recording");
+    std::vector<char> encBefore = LoadFile(encPath);
+
+    std::vector<std::string> candidates = ArchiveTranscoder::FindCandidates(root.string(), 30, std::time(nullptr));
+    Check(candidates.size() == 2, "both recordings are candidates");
+
+    TranscodeResult plain, encrypted;
+    TranscodeOptions options;
+    options.threads = 1;
+    ArchiveTranscoder transcoder;
+    std::mutex resultMutex;
+    TranscodeSummary s = transcoder.Run(root.string(), options, [&](const TranscodeResult& r) {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        (r.path == encPath ? encrypted : plain) = r;
+    });
+
+    Check(s.transcoded == 1 && s.skipped == 1 && s.failed == 0, "one transcoded, one skipped, none failed");
+    Check(plain.status == TranscodeStatus::Transcoded && plain.bytesAfter * 3 < plain.bytesBefore,
+          "PCM recording shrinks to ADPCM");
+    Check(encrypted.status == TranscodeStatus::Skipped && encrypted.message == "encrypted",
+          "encrypted recording is skipped as \"encrypted\"");
+    Check(EncryptedRecording::IsEncrypted(encPath) && LoadFile(encPath) == encBefore,
+          "encrypted recording is left byte for byte");
+    Check(!fs::exists(encPath + ".adpcm.tmp", ec), "no plaintext temp file next to it");
+
+    TranscodeResult single = ArchiveTranscoder::TranscodeFile(encPath, options.minSnrDb);
+    Check(single.status == TranscodeStatus::Skipped && single.message == "encrypted",
+          "--file on an encrypted recording skips it");
+
+    fs::remove_all(root, ec);
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    TranscodeOptions options;
+    std::string root, singleFile;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--days") == 0 && hasValue)         options.minAgeDays = atoi(argv[++i]);
+        else if (strcmp(arg, "--threads") == 0 && hasValue) options.threads = (size_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--min-snr") == 0 && hasValue) options.minSnrDb = atof(argv[++i]);
+        else if (strcmp(arg, "--file") == 0 && hasValue)    singleFile = argv[++i];
+        else if (strcmp(arg, "--dry-run") == 0)             options.dryRun = true;
+        else if (strcmp(arg, "--selftest") == 0)            return SelfTest();
+        else if (arg[0] != '-' && root.empty())             root = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    if (!singleFile.empty()) {
+        TranscodeResult r = ArchiveTranscoder::TranscodeFile(singleFile, options.minSnrDb);
+        PrintResult(r);
+        return r.status == TranscodeStatus::Failed ? 1 : 0;
+    }
+    if (root.empty()) { PrintUsage(); return 2; }
+
+    std::mutex printMutex;
+    ArchiveTranscoder transcoder;
+    TranscodeSummary s = transcoder.Run(root, options, [&](const TranscodeResult& r) {
+        std::lock_guard<std::mutex> lock(printMutex);
+        PrintResult(r);
+    });
+
+    printf("\n%zu candidates: %zu transcoded, %zu skipped, %zu failed\n",
+           s.candidates, s.transcoded, s.skipped, s.failed);
+    if (s.transcoded) {
+        printf("%.1f MB -> %.1f MB\n", s.bytesBefore / 1048576.0, s.bytesAfter / 1048576.0);
+    }
+    return s.failed ? 1 : 0;
+}
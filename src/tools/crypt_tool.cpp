@@ -0,0 +1,600 @@
+// MicMute-S recording encryption tool
+//
+// Encrypts, decrypts and re-wraps recordings in the encrypted container
+// (storage/encrypted_recording.h), checks AES-256-GCM against the NIST test
+// vectors and the container against tampering, truncation and key
+// rotation, and benchmarks how many concurrent recordings one core can
+// encrypt. No Win32 dependencies:
+//
+//   Windows: see build.bat (crypt_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o crypt_tool
+//              src/tools/crypt_tool.cpp src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp
+//              src/core/sha256.cpp src/audio/WavDecoder.cpp src/audio/MappedWavReader.cpp
+//              src/core/mapped_file.cpp src/audio/WavMetadata.cpp src/audio/ImaAdpcm.cpp
+//
+// Usage: crypt_tool --genkey
+//        crypt_tool --encrypt <in.wav> <out.wav> --key HEX
+//        crypt_tool --decrypt <in.wav> <out.wav> --key HEX [--start sec] [--length sec]
+//        crypt_tool --rewrap <file.wav> --key HEX --new-key HEX
+//        crypt_tool --selftest
+//        crypt_tool --bench [--streams N] [--seconds S]
+//                   (exit code 1 if a check fails)
+
+#include "storage/encrypted_recording.h"
+#include "audio/WavDecoder.h"
+#include "core/sha256.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const uint32_t RATE = 48000;     // Recorder output: 48 kHz mono 16-bit
+static const uint32_t STREAM_BYTES_PER_SEC = RATE * 2;
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: crypt_tool --genkey\n");
+    printf("       crypt_tool --encrypt <in.wav> <out.wav> --key HEX\n");
+    printf("       crypt_tool --decrypt <in.wav> <out.wav> --key HEX [--start sec] [--length sec]\n");
+    printf("       crypt_tool --rewrap <file.wav> --key HEX --new-key HEX\n");
+    printf("       crypt_tool --selftest\n");
+    printf("       crypt_tool --bench [--streams N] [--seconds S]\n");
+}
+
+static double Seconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+// ---------------------------------------------------------------------------
+// Commands
+// ---------------------------------------------------------------------------
+
+static int Encrypt(const std::string& inPath, const std::string& outPath, const RecordingKey& key) {
+    std::ifstream in(inPath, std::ios::binary);
+    WavMetadata metadata;
+    WavInfo info;
+    WavMeta::Read(inPath, metadata, &info);
+    if (!in.is_open() || info.blockAlign == 0 || info.dataOffset == 0) {
+        fprintf(stderr, "Not a wav file: %s\n", inPath.c_str());
+        return 1;
+    }
+
+    // The whole source file is the plaintext: its own header is kept
+    // as-is (so the header region is whatever precedes the data chunk)
+    std::vector<char> header((size_t)info.dataOffset);
+    in.read(header.data(), header.size());
+
+    EncryptedRecordingWriter writer;
+    if (!writer.Open(outPath, key, info.sampleRate, info.channels, info.bitsPerSample, (uint32_t)header.size())) {
+        fprintf(stderr, "Cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    writer.PatchHeader(0, header.data(), header.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<char> buf(1 << 20);
+    uint64_t remaining = info.dataBytes;
+    while (remaining > 0 && in) {
+        in.read(buf.data(), (std::streamsize)std::min<uint64_t>(buf.size(), remaining));
+        size_t n = (size_t)in.gcount();
+        if (n == 0) break;
+        writer.Append(buf.data(), n);
+        remaining -= n;
+    }
+    std::vector<char> trailing((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!trailing.empty()) writer.AppendTrailing(trailing.data(), trailing.size());
+    bool ok = writer.Finish();
+    double secs = Seconds(std::chrono::steady_clock::now() - t0);
+
+    printf("Encrypted %s -> %s: %.1f MB audio in %.3f s (key %s, %s AES)\n", inPath.c_str(), outPath.c_str(),
+           writer.GetDataBytes() / 1e6, secs, key.IdHex().c_str(),
+           AesGcm::HasHardwareSupport() ? "hardware" : "software");
+    return ok ? 0 : 1;
+}
+
+static int Decrypt(const std::string& inPath, const std::string& outPath, const RecordingKeyring& keys,
+                   double start, double length) {
+    EncryptedRecordingReader reader;
+    if (!reader.Open(inPath, keys)) {
+        fprintf(stderr, "%s: %s\n", inPath.c_str(), reader.GetError().c_str());
+        return 1;
+    }
+    WavInfo info;
+    reader.GetWavInfo(info);
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        fprintf(stderr, "Cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t from = 0, to = reader.GetSize();
+    bool range = start > 0 || length > 0;
+    if (range) {
+        // Time range: only the chunks covering it are read and decrypted
+        uint64_t first = std::min<uint64_t>((uint64_t)(start * info.sampleRate), info.dataBytes / info.blockAlign);
+        uint64_t frames = length > 0 ? (uint64_t)(length * info.sampleRate) : UINT64_MAX;
+        frames = std::min<uint64_t>(frames, info.dataBytes / info.blockAlign - first);
+        from = info.dataOffset + first * info.blockAlign;
+        to = from + frames * info.blockAlign;
+        std::vector<char> header = WavMeta::BuildHeader(info.sampleRate, info.channels, info.bitsPerSample,
+                                                        (uint32_t)(to - from));
+        out.write(header.data(), header.size());
+    }
+
+    std::vector<char> buf(1 << 20);
+    for (uint64_t pos = from; pos < to; ) {
+        size_t n = (size_t)std::min<uint64_t>(buf.size(), to - pos);
+        if (!reader.Read(pos, buf.data(), n)) {
+            fprintf(stderr, "%s: %s\n", inPath.c_str(), reader.GetError().c_str());
+            return 1;
+        }
+        out.write(buf.data(), n);
+        pos += n;
+    }
+    double secs = Seconds(std::chrono::steady_clock::now() - t0);
+
+    printf("Decrypted %s -> %s: %.1f MB in %.3f s, %llu of %llu chunks%s\n", inPath.c_str(), outPath.c_str(),
+           (to - from) / 1e6, secs, (unsigned long long)reader.GetChunksDecrypted(),
+           (unsigned long long)((reader.GetDataBytes() + EncryptedRecording::CHUNK_SIZE - 1) / EncryptedRecording::CHUNK_SIZE),
+           reader.IsFinalized() ? "" : " (recovered: file was never finalized)");
+    return out.good() ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// Selftest
+// ---------------------------------------------------------------------------
+
+static void CheckVectors(bool hardware) {
+    // NIST GCM test cases 13 and 14 (256-bit zero key, zero IV)
+    uint8_t key[32] = {}, nonce[12] = {}, zero[16] = {}, out[16], tag[16];
+    AesGcm aes;
+    aes.SetKey(key, hardware);
+    printf(" %s path\n", aes.IsHardware() ? "hardware" : "software");
+
+    aes.Encrypt(nonce, nullptr, 0, nullptr, nullptr, 0, tag);
+    Check(ToHex(tag, 16) == "530f8afbc74536b9a963b4f1c4cb738b", "test case 13 (empty) tag");
+
+    aes.Encrypt(nonce, nullptr, 0, zero, out, 16, tag);
+    Check(ToHex(out, 16) == "cea7403d4d606b6e074ec5d3baf39d18", "test case 14 ciphertext");
+    Check(ToHex(tag, 16) == "d0d1c8a799996bf0265b98b5d48ab919", "test case 14 tag");
+
+    uint8_t back[16];
+    Check(aes.Decrypt(nonce, nullptr, 0, out, back, 16, tag) && memcmp(back, zero, 16) == 0, "test case 14 decrypts");
+    tag[0] ^= 1;
+    Check(!aes.Decrypt(nonce, nullptr, 0, out, back, 16, tag), "test case 14 bad tag rejected");
+}
+
+static void CheckPathsAgree() {
+    std::mt19937 rng(46);
+    uint8_t key[32], nonce[12];
+    for (auto& b : key) b = (uint8_t)rng();
+    AesGcm hw, sw;
+    hw.SetKey(key, true);
+    sw.SetKey(key, false);
+
+    bool same = true;
+    for (int i = 0; i < 300 && same; i++) {
+        size_t len = rng() % 1100, aadLen = rng() % 70;
+        std::vector<uint8_t> in(len + 1), aad(aadLen + 1), a(len + 1), b(len + 1);
+        for (auto& x : in) x = (uint8_t)rng();
+        for (auto& x : aad) x = (uint8_t)rng();
+        for (auto& x : nonce) x = (uint8_t)rng();
+        uint8_t ta[16], tb[16];
+        hw.Encrypt(nonce, aad.data(), aadLen, in.data(), a.data(), len, ta);
+        sw.Encrypt(nonce, aad.data(), aadLen, in.data(), b.data(), len, tb);
+        same = memcmp(a.data(), b.data(), len) == 0 && memcmp(ta, tb, 16) == 0;
+    }
+    Check(same, "hardware and software paths agree (300 random messages)");
+}
+
+// A 16-bit mono recording laid out the way StreamingWavWriter writes it
+struct TestRecording {
+    std::vector<char> header;
+    std::vector<char> data;
+    std::vector<char> trailing;
+    WavMetadata metadata;
+
+    std::vector<char> Plain() const {
+        std::vector<char> all(header);
+        all.insert(all.end(), data.begin(), data.end());
+        all.insert(all.end(), trailing.begin(), trailing.end());
+        return all;
+    }
+};
+
+static TestRecording MakeRecording(double seconds, bool trailingMetadata) {
+    TestRecording r;
+    size_t frames = (size_t)(seconds * RATE);
+    r.data.resize(frames * 2 + (trailingMetadata ? 1 : 0)); // Odd size exercises the pad byte
+    for (size_t i = 0; i < frames; i++) {
+        int16_t s = (int16_t)(12000.0 * sin(2.0 * 3.14159265358979 * 440.0 * i / RATE) + (i % 7));
+        memcpy(&r.data[i * 2], &s, 2);
+    }
+    r.metadata["file"] = "call_0001";
+    r.metadata["start_time"] = "2026-10-19 09:30:00";
+    r.metadata["customer"] = trailingMetadata ? std::string(6000, 'x') : "ACME";
+
+    std::vector<char> chunks = WavMeta::BuildChunks(r.metadata);
+    uint32_t trailingBytes = 0;
+    if (trailingMetadata) {
+        if (r.data.size() & 1) r.trailing.push_back(0);
+        r.trailing.insert(r.trailing.end(), chunks.begin(), chunks.end());
+        trailingBytes = (uint32_t)r.trailing.size();
+    }
+    r.header = WavMeta::BuildHeader(RATE, 1, 16, (uint32_t)r.data.size(), trailingBytes);
+    if (!trailingMetadata) {
+        size_t leftover = WavMeta::RESERVED_REGION_SIZE - chunks.size();
+        chunks.insert(chunks.end(), { 'J', 'U', 'N', 'K' });
+        uint32_t junk = (uint32_t)(leftover - 8);
+        chunks.insert(chunks.end(), reinterpret_cast<char*>(&junk), reinterpret_cast<char*>(&junk) + 4);
+        chunks.resize(WavMeta::RESERVED_REGION_SIZE, 0);
+        memcpy(&r.header[WavMeta::RESERVED_REGION_OFFSET], chunks.data(), chunks.size());
+    }
+    return r;
+}
+
+// Written in uneven pieces, header and metadata patched at the end like
+// StreamingWavWriter::Finalize does
+static bool WriteRecording(const std::string& path, const RecordingKey& key, const TestRecording& r, bool finish) {
+    EncryptedRecordingWriter writer;
+    if (!writer.Open(path, key, RATE, 1, 16)) return false;
+    std::vector<char> placeholder = WavMeta::BuildHeader(RATE, 1, 16);
+    writer.PatchHeader(0, placeholder.data(), placeholder.size());
+    std::mt19937 rng(7);
+    for (size_t pos = 0; pos < r.data.size(); ) {
+        size_t n = std::min<size_t>(r.data.size() - pos, 1 + rng() % 40000);
+        if (!writer.Append(r.data.data() + pos, n)) return false;
+        pos += n;
+    }
+    if (!finish) {
+        writer.Flush();
+        writer.Close();
+        return true;
+    }
+    writer.PatchHeader(0, r.header.data(), r.header.size());
+    if (!r.trailing.empty()) writer.AppendTrailing(r.trailing.data(), r.trailing.size());
+    return writer.Finish();
+}
+
+static bool ReadAll(EncryptedRecordingReader& reader, std::vector<char>& out) {
+    out.resize((size_t)reader.GetSize());
+    return reader.Read(0, out.data(), out.size());
+}
+
+static std::vector<char> LoadFile(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+static void SaveFile(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(bytes.data(), bytes.size());
+}
+
+static void CheckContainer(const std::string& dir) {
+    RecordingKey k1, k2;
+    RecordingKey::Generate(k1);
+    RecordingKey::Generate(k2);
+    RecordingKeyring ring1, ring2, both;
+    ring1.Add(k1);
+    ring2.Add(k2);
+    both.Add(k1);
+    both.Add(k2);
+
+    // Keyring round trip
+    RecordingKeyring parsed;
+    Check(parsed.Parse(both.Serialize()) && parsed.Size() == 2, "keyring serializes and parses");
+    RecordingKey current;
+    Check(parsed.GetCurrent(current) && memcmp(current.id, k2.id, 16) == 0, "newest key is current");
+
+    const std::string path = dir + "/enc_test.wav";
+    TestRecording rec = MakeRecording(12.3, false);
+    std::vector<char> plain = rec.Plain();
+    Check(WriteRecording(path, k1, rec, true), "writes a 12.3 s recording");
+    Check(EncryptedRecording::IsEncrypted(path), "detected as encrypted");
+
+    std::vector<char> file = LoadFile(path);
+    bool leaks = std::search(file.begin(), file.end(), rec.data.begin() + 100000, rec.data.begin() + 100064) != file.end() ||
+                 std::search(file.begin(), file.end(), std::begin("ACME") , std::end("ACME") - 1) != file.end();
+    Check(!leaks, "no audio or metadata bytes in the clear");
+
+    EncryptedRecordingReader reader;
+    std::vector<char> all;
+    Check(reader.Open(path, ring1) && reader.IsFinalized(), "opens, finalized");
+    Check(ReadAll(reader, all) && all == plain, "decrypts to the exact WAV");
+
+    WavInfo info;
+    WavMetadata md;
+    Check(reader.GetWavInfo(info) && info.sampleRate == RATE && info.channels == 1 &&
+          info.dataOffset == WavMeta::DATA_OFFSET && info.dataBytes == rec.data.size(), "format and data layout");
+    Check(reader.ReadMetadata(md) && md == rec.metadata, "metadata from the header region");
+
+    // Random ranges decrypt only what they touch
+    std::mt19937 rng(3);
+    bool rangesOk = true;
+    for (int i = 0; i < 200 && rangesOk; i++) {
+        uint64_t off = rng() % plain.size();
+        size_t len = (size_t)std::min<uint64_t>(plain.size() - off, rng() % 200000);
+        std::vector<char> part(len);
+        rangesOk = reader.Read(off, part.data(), len) && memcmp(part.data(), &plain[(size_t)off], len) == 0;
+    }
+    Check(rangesOk, "200 random ranges match");
+
+    EncryptedRecordingReader fresh;
+    fresh.Open(path, ring1);
+    std::vector<char> second(STREAM_BYTES_PER_SEC);
+    fresh.Read(WavMeta::DATA_OFFSET + 6 * STREAM_BYTES_PER_SEC, second.data(), second.size());
+    char msg[128];
+    snprintf(msg, sizeof(msg), "1 s range at 6 s decrypts %llu of %llu chunks",
+             (unsigned long long)fresh.GetChunksDecrypted(),
+             (unsigned long long)((rec.data.size() + EncryptedRecording::CHUNK_SIZE - 1) / EncryptedRecording::CHUNK_SIZE));
+    Check(fresh.GetChunksDecrypted() <= 3, msg);
+
+    // Player / analysis path: WavDecoder through the app keyring
+    GetRecordingKeyring().Clear();
+    GetRecordingKeyring().Add(k1);
+    WavDecoder decoder;
+    bool decoded = decoder.Open(path) && decoder.IsEncrypted() && decoder.GetTotalFrames() == rec.data.size() / 2;
+    if (decoded) {
+        uint64_t at = 5 * RATE + 123;
+        float samples[256];
+        decoded = decoder.Seek(at) && decoder.Read(samples, 256) == 256;
+        for (int i = 0; decoded && i < 256; i++) {
+            int16_t s;
+            memcpy(&s, &rec.data[(size_t)(at + i) * 2], 2);
+            decoded = fabsf(samples[i] - s / 32768.0f) < 1e-6f;
+        }
+    }
+    Check(decoded, "WavDecoder seeks and decodes an encrypted recording");
+    decoder.Close();
+    GetRecordingKeyring().Clear();
+    Check(!decoder.Open(path), "WavDecoder refuses it without the key");
+
+    EncryptedRecordingReader wrong;
+    Check(!wrong.Open(path, ring2), "other key rejected");
+
+    // Metadata too large for the header region goes to the trailer
+    TestRecording big = MakeRecording(1.5, true);
+    const std::string bigPath = dir + "/enc_trailing.wav";
+    std::vector<char> bigAll;
+    WavMetadata bigMd;
+    EncryptedRecordingReader bigReader;
+    Check(WriteRecording(bigPath, k1, big, true) && bigReader.Open(bigPath, ring1) &&
+          ReadAll(bigReader, bigAll) && bigAll == big.Plain() && bigReader.ReadMetadata(bigMd) &&
+          bigMd == big.metadata, "odd data size with trailing metadata");
+
+    // Tampering: a flipped bit fails exactly the chunk it is in
+    std::vector<char> tampered = file;
+    const size_t stride = EncryptedRecording::CHUNK_SIZE + AesGcm::TAG_SIZE;
+    tampered[EncryptedRecording::HEADER_SIZE + 5 * stride + 1000] ^= 0x10;
+    const std::string tamperedPath = dir + "/enc_tampered.wav";
+    SaveFile(tamperedPath, tampered);
+    EncryptedRecordingReader t;
+    std::vector<char> buf(4096);
+    Check(t.Open(tamperedPath, ring1), "tampered file still opens");
+    Check(!t.Read(WavMeta::DATA_OFFSET + 5ull * EncryptedRecording::CHUNK_SIZE + 100, buf.data(), buf.size()),
+          "tampered chunk fails authentication");
+    Check(t.Read(WavMeta::DATA_OFFSET + 9ull * EncryptedRecording::CHUNK_SIZE, buf.data(), buf.size()),
+          "other chunks still read");
+
+    // Reordered chunks
+    std::vector<char> swapped = file;
+    std::swap_ranges(swapped.begin() + EncryptedRecording::HEADER_SIZE + 2 * stride,
+                     swapped.begin() + EncryptedRecording::HEADER_SIZE + 3 * stride,
+                     swapped.begin() + EncryptedRecording::HEADER_SIZE + 3 * stride);
+    SaveFile(tamperedPath, swapped);
+    EncryptedRecordingReader s;
+    Check(s.Open(tamperedPath, ring1) &&
+          !s.Read(WavMeta::DATA_OFFSET + 2ull * EncryptedRecording::CHUNK_SIZE, buf.data(), buf.size()),
+          "swapped chunks rejected");
+
+    // A chunk cut out of the middle
+    std::vector<char> cut = file;
+    cut.erase(cut.begin() + EncryptedRecording::HEADER_SIZE + 4 * stride,
+              cut.begin() + EncryptedRecording::HEADER_SIZE + 5 * stride);
+    SaveFile(tamperedPath, cut);
+    EncryptedRecordingReader c;
+    Check(!c.Open(tamperedPath, ring1), "removed chunk detected");
+
+    // Crash: never finalized, the last (torn) chunk half written
+    const std::string crashPath = dir + "/enc_crash.wav";
+    WriteRecording(crashPath, k1, rec, false);
+    std::vector<char> crashed = LoadFile(crashPath);
+    crashed.resize(crashed.size() - 777);
+    SaveFile(crashPath, crashed);
+    EncryptedRecordingReader r;
+    std::vector<char> recovered;
+    size_t wholeChunks = (crashed.size() - EncryptedRecording::HEADER_SIZE) / stride;
+    Check(r.Open(crashPath, ring1) && !r.IsFinalized() && ReadAll(r, recovered) &&
+          r.GetDataBytes() == wholeChunks * EncryptedRecording::CHUNK_SIZE &&
+          memcmp(recovered.data() + WavMeta::DATA_OFFSET, rec.data.data(), (size_t)r.GetDataBytes()) == 0,
+          "crashed recording recovers every whole chunk");
+    WavInfo crashInfo;
+    Check(r.GetWavInfo(crashInfo) && crashInfo.dataBytes == r.GetDataBytes(), "recovered header is rebuilt");
+
+    // Key rotation: re-wrap touches only the header
+    std::string err;
+    Check(RewrapRecording(path, ring1, k2, &err), "re-wrap under the new key");
+    std::vector<char> rewrapped = LoadFile(path);
+    Check(rewrapped.size() == file.size() &&
+          memcmp(rewrapped.data() + EncryptedRecording::HEADER_SIZE, file.data() + EncryptedRecording::HEADER_SIZE,
+                 file.size() - EncryptedRecording::HEADER_SIZE) == 0, "audio untouched by re-wrap");
+    EncryptedRecordingReader newKey, oldKey;
+    Check(newKey.Open(path, ring2) && ReadAll(newKey, all) && all == plain, "opens with the new key only");
+    Check(!oldKey.Open(path, ring1), "old key no longer opens it");
+    Check(!RewrapRecording(path, ring1, k1, &err), "re-wrap needs the current key");
+
+    for (const char* name : { "/enc_test.wav", "/enc_trailing.wav", "/enc_tampered.wav", "/enc_crash.wav" }) {
+        std::error_code ec;
+        fs::remove(dir + name, ec);
+    }
+}
+
+static int SelfTest() {
+    bool hardware = AesGcm::HasHardwareSupport();
+    printf("AES-256-GCM (%s)\n", hardware ? "AES-NI + PCLMULQDQ available" : "no hardware AES");
+    CheckVectors(false);
+    if (hardware) {
+        CheckVectors(true);
+        CheckPathsAgree();
+    }
+
+    printf("\nContainer\n");
+    CheckContainer(fs::temp_directory_path().string());
+
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+static double GcmThroughput(bool hardware) {
+    uint8_t key[32] = { 1 }, nonce[12] = {}, tag[16];
+    std::vector<uint8_t> buf(EncryptedRecording::CHUNK_SIZE, 0x5a);
+    AesGcm aes;
+    aes.SetKey(key, hardware);
+    uint64_t bytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    double secs = 0;
+    while (secs < 0.5) {
+        for (int i = 0; i < 16; i++) {
+            nonce[11]++;
+            aes.Encrypt(nonce, key, 16, buf.data(), buf.data(), buf.size(), tag);
+        }
+        bytes += 16 * buf.size();
+        secs = Seconds(std::chrono::steady_clock::now() - t0);
+    }
+    return bytes / secs;
+}
+
+static int Bench(int streams, int seconds) {
+    bool hardware = AesGcm::HasHardwareSupport();
+    printf("AES-256-GCM on 64 KiB chunks\n");
+    double sw = GcmThroughput(false);
+    printf("  software:  %8.1f MB/s\n", sw / 1e6);
+    double hw = 0;
+    if (AesGcm::HasHardwareSupport()) {
+        hw = GcmThroughput(true);
+        printf("  hardware:  %8.1f MB/s (%.1fx)\n", hw / 1e6, hw / sw);
+    }
+    double best = hardware ? hw : sw;
+    printf("  one core encrypts %.0f recordings in real time (%u KB/s each)\n",
+           best / STREAM_BYTES_PER_SEC, STREAM_BYTES_PER_SEC / 1000);
+
+    // The real writers, interleaved the way concurrent recorders deliver
+    // audio (10 ms blocks), to files, on this one thread
+    printf("\n%d concurrent recordings x %d s on one thread (%s AES, files in %s)\n", streams, seconds,
+           hardware ? "hardware" : "software", fs::temp_directory_path().string().c_str());
+    RecordingKey key;
+    RecordingKey::Generate(key);
+    std::vector<std::unique_ptr<EncryptedRecordingWriter>> writers;
+    std::vector<std::string> paths;
+    for (int i = 0; i < streams; i++) {
+        paths.push_back((fs::temp_directory_path() / ("crypt_bench_" + std::to_string(i) + ".wav")).string());
+        writers.emplace_back(new EncryptedRecordingWriter());
+        if (!writers.back()->Open(paths.back(), key, RATE, 1, 16)) {
+            fprintf(stderr, "Cannot write %s\n", paths.back().c_str());
+            return 1;
+        }
+    }
+    std::vector<char> block(STREAM_BYTES_PER_SEC / 100);
+    for (size_t i = 0; i < block.size(); i++) block[i] = (char)(i * 31);
+
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok = true;
+    for (int b = 0; b < seconds * 100 && ok; b++) {
+        for (auto& w : writers) ok = w->Append(block.data(), block.size()) && ok;
+    }
+    for (auto& w : writers) ok = w->Finish() && ok;
+    double secs = Seconds(std::chrono::steady_clock::now() - t0);
+    for (const auto& p : paths) {
+        std::error_code ec;
+        fs::remove(p, ec);
+    }
+
+    double audio = (double)streams * seconds;
+    printf("  %.1f s of audio encrypted and written in %.3f s: %.0fx real time\n", audio, secs, audio / secs);
+    printf("  -> %.0f%% of one core for %d live recordings, capacity ~%.0f streams\n",
+           100.0 * secs / seconds, streams, streams * seconds / secs);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    std::string command, keyHex, newKeyHex;
+    std::vector<std::string> paths;
+    int streams = 64, seconds = 10;
+    double start = 0, length = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--genkey") == 0 || strcmp(arg, "--encrypt") == 0 || strcmp(arg, "--decrypt") == 0 ||
+            strcmp(arg, "--rewrap") == 0 || strcmp(arg, "--selftest") == 0 || strcmp(arg, "--bench") == 0) {
+            command = arg + 2;
+        }
+        else if (strcmp(arg, "--key") == 0 && hasValue) keyHex = argv[++i];
+        else if (strcmp(arg, "--new-key") == 0 && hasValue) newKeyHex = argv[++i];
+        else if (strcmp(arg, "--start") == 0 && hasValue) start = atof(argv[++i]);
+        else if (strcmp(arg, "--length") == 0 && hasValue) length = atof(argv[++i]);
+        else if (strcmp(arg, "--streams") == 0 && hasValue) streams = atoi(argv[++i]);
+        else if (strcmp(arg, "--seconds") == 0 && hasValue) seconds = atoi(argv[++i]);
+        else if (arg[0] != '-') paths.push_back(arg);
+        else { PrintUsage(); return 2; }
+    }
+    if (streams < 1) streams = 1;
+    if (seconds < 1) seconds = 1;
+
+    if (command == "selftest") return SelfTest();
+    if (command == "bench") return Bench(streams, seconds);
+    if (command == "genkey") {
+        RecordingKey key;
+        if (!RecordingKey::Generate(key)) return 1;
+        printf("%s  (id %s)\n", key.ToHex().c_str(), key.IdHex().c_str());
+        return 0;
+    }
+
+    RecordingKey key, newKey;
+    if (!RecordingKey::FromHex(keyHex, key)) {
+        fprintf(stderr, "--key must be 64 hex digits\n");
+        return 2;
+    }
+    RecordingKeyring keys;
+    keys.Add(key);
+
+    if (command == "encrypt" && paths.size() == 2) return Encrypt(paths[0], paths[1], key);
+    if (command == "decrypt" && paths.size() == 2) return Decrypt(paths[0], paths[1], keys, start, length);
+    if (command == "rewrap" && paths.size() == 1) {
+        if (!RecordingKey::FromHex(newKeyHex, newKey)) {
+            fprintf(stderr, "--new-key must be 64 hex digits\n");
+            return 2;
+        }
+        std::string err;
+        if (!RewrapRecording(paths[0], keys, newKey, &err)) {
+            fprintf(stderr, "%s: %s\n", paths[0].c_str(), err.c_str());
+            return 1;
+        }
+        printf("Re-wrapped %s: key %s -> %s\n", paths[0].c_str(), key.IdHex().c_str(), newKey.IdHex().c_str());
+        return 0;
+    }
+    PrintUsage();
+    return 2;
+}
@@ -0,0 +1,384 @@
+// MicMute-S mic DSP tool
+//
+// Runs the recorder's mic DSP chain (high-pass, noise suppression, gate,
+// AGC, look-ahead limiter) offline over a recording, printing the CPU time
+// each stage took per 10 ms block, and checks the stages and the chain's
+// budget on synthetic signals. No Win32 dependencies:
+//
+//   Windows: see build.bat (dsp_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o dsp_tool
+//              src/tools/dsp_tool.cpp src/audio/DspChain.cpp src/audio/Fft.cpp
+//              src/audio/WavDecoder.cpp src/audio/MappedWavReader.cpp src/core/mapped_file.cpp
+//              src/audio/WavMetadata.cpp src/audio/ImaAdpcm.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: dsp_tool <in.wav> <out.wav> [--gate] [--agc] [--ns] [--no-highpass]
+//                 [--no-limiter] [--ceiling dB] [--target dB]
+//        dsp_tool --selftest [--minutes N]
+//                 (exit code 1 if a check fails)
+
+#include "audio/DspChain.h"
+#include "audio/WavDecoder.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count heap allocations so the selftest can prove Process() makes none.
+// Kept out of line: inlined, GCC pairs its built-in new with the free()
+// below and warns about a mismatched delete.
+#ifdef _MSC_VER
+#define REPLACEMENT_NOINLINE __declspec(noinline)
+#else
+#define REPLACEMENT_NOINLINE __attribute__((noinline))
+#endif
+
+static std::atomic<size_t> g_allocations{0};
+
+REPLACEMENT_NOINLINE void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+REPLACEMENT_NOINLINE void* operator new[](size_t size) { return operator new(size); }
+REPLACEMENT_NOINLINE void operator delete(void* p) noexcept { free(p); }
+REPLACEMENT_NOINLINE void operator delete(void* p, size_t) noexcept { free(p); }
+REPLACEMENT_NOINLINE void operator delete[](void* p) noexcept { free(p); }
+REPLACEMENT_NOINLINE void operator delete[](void* p, size_t) noexcept { free(p); }
+
+static const uint32_t RATE = 48000;
+static const double PI = 3.14159265358979323846;
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: dsp_tool <in.wav> <out.wav> [--gate] [--agc] [--ns] [--no-highpass]\n");
+    printf("                [--no-limiter] [--ceiling dB] [--target dB]\n");
+    printf("       dsp_tool --selftest [--minutes N]\n");
+}
+
+static bool WriteWav16(const std::string& path, const std::vector<float>& samples, uint32_t rate) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    uint32_t dataBytes = (uint32_t)(samples.size() * 2);
+    uint32_t riffSize = 36 + dataBytes;
+    uint16_t format = 1, channels = 1, bits = 16, blockAlign = 2;
+    uint32_t fmtSize = 16, byteRate = rate * 2;
+    out.write("RIFF", 4);
+    out.write((const char*)&riffSize, 4);
+    out.write("WAVEfmt ", 8);
+    out.write((const char*)&fmtSize, 4);
+    out.write((const char*)&format, 2);
+    out.write((const char*)&channels, 2);
+    out.write((const char*)&rate, 4);
+    out.write((const char*)&byteRate, 4);
+    out.write((const char*)&blockAlign, 2);
+    out.write((const char*)&bits, 2);
+    out.write("data", 4);
+    out.write((const char*)&dataBytes, 4);
+    std::vector<int16_t> pcm(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        float s = samples[i] * 32767.0f;
+        pcm[i] = (int16_t)(s > 32767.0f ? 32767.0f : (s < -32768.0f ? -32768.0f : s));
+    }
+    out.write((const char*)pcm.data(), dataBytes);
+    return (bool)out;
+}
+
+static int ProcessFile(const std::string& inPath, const std::string& outPath, const DspSettings& settings) {
+    WavDecoder decoder;
+    if (!decoder.Open(inPath)) {
+        printf("Cannot open %s\n", inPath.c_str());
+        return 1;
+    }
+    uint32_t rate = decoder.GetSampleRate();
+    uint16_t channels = decoder.GetChannels();
+
+    // The mic path is mono: downmix
+    std::vector<float> mono;
+    mono.reserve((size_t)decoder.GetTotalFrames());
+    std::vector<float> chunk(4096 * channels);
+    size_t got;
+    while ((got = decoder.Read(chunk.data(), 4096)) > 0) {
+        for (size_t f = 0; f < got; f++) {
+            float sum = 0.0f;
+            for (uint16_t c = 0; c < channels; c++) sum += chunk[f * channels + c];
+            mono.push_back(sum / channels);
+        }
+    }
+
+    DspTimings timings;
+    DspChain chain;
+    chain.Configure(rate, settings, &timings);
+    auto t0 = std::chrono::steady_clock::now();
+    chain.Process(mono.data(), mono.size());
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (!WriteWav16(outPath, mono, rate)) {
+        printf("Cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    double audioSec = (double)mono.size() / rate;
+    printf("%s -> %s: %.1f s of audio in %.1f ms (%.0fx realtime), latency %zu samples\n",
+           inPath.c_str(), outPath.c_str(), audioSec, sec * 1000.0,
+           audioSec / (sec > 0 ? sec : 1e-9), chain.GetLatency());
+    printf("%s\n", timings.ToJson().c_str());
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Selftest
+// ---------------------------------------------------------------------------
+
+static DspSettings Only(DspStageKind kind) {
+    DspSettings s;
+    s.highPass = kind == DspStageKind::HighPass;
+    s.noiseGate = kind == DspStageKind::NoiseGate;
+    s.agc = kind == DspStageKind::Agc;
+    s.limiter = kind == DspStageKind::Limiter;
+    s.noiseSuppression = kind == DspStageKind::NoiseSuppression;
+    return s;
+}
+
+static std::vector<float> Sine(double hz, float amplitude, double seconds) {
+    std::vector<float> x((size_t)(seconds * RATE));
+    for (size_t i = 0; i < x.size(); i++) x[i] = amplitude * (float)std::sin(2.0 * PI * hz * i / RATE);
+    return x;
+}
+
+class Noise {
+public:
+    float Next(float amplitude) {
+        m_seed = m_seed * 1664525u + 1013904223u;
+        return amplitude * (((m_seed >> 8) / 8388608.0f) - 1.0f);
+    }
+
+private:
+    uint32_t m_seed = 12345;
+};
+
+static double RmsDb(const float* x, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += (double)x[i] * x[i];
+    return 10.0 * std::log10(sum / (n ? n : 1) + 1e-20);
+}
+
+static double PeakOf(const std::vector<float>& x) {
+    double peak = 0.0;
+    for (float v : x) peak = std::fabs(v) > peak ? std::fabs(v) : peak;
+    return peak;
+}
+
+// RMS of the last `seconds` of x
+static double TailDb(const std::vector<float>& x, double seconds) {
+    size_t n = (size_t)(seconds * RATE);
+    return RmsDb(x.data() + x.size() - n, n);
+}
+
+static void Run(DspChain& chain, std::vector<float>& x) {
+    chain.Process(x.data(), x.size());
+}
+
+static void CheckHighPass() {
+    DspChain chain;
+    chain.Configure(RATE, Only(DspStageKind::HighPass));
+    std::vector<float> low = Sine(20.0, 0.5f, 2.0);
+    std::vector<float> voice = Sine(1000.0, 0.5f, 2.0);
+    double lowIn = TailDb(low, 1.0), voiceIn = TailDb(voice, 1.0);
+    Run(chain, low);
+    chain.Reset();
+    Run(chain, voice);
+    std::vector<float> dc(RATE, 0.3f);
+    chain.Reset();
+    Run(chain, dc);
+    printf("  high-pass: 20 Hz %.1f dB, 1 kHz %.2f dB, DC tail %.1f dBFS\n",
+           TailDb(low, 1.0) - lowIn, TailDb(voice, 1.0) - voiceIn, TailDb(dc, 0.1));
+    Check(TailDb(low, 1.0) - lowIn < -20.0, "high-pass: 20 Hz down more than 20 dB");
+    Check(std::fabs(TailDb(voice, 1.0) - voiceIn) < 0.2, "high-pass: 1 kHz within 0.2 dB");
+    Check(TailDb(dc, 0.1) < -80.0, "high-pass: DC removed");
+}
+
+static void CheckLimiter() {
+    DspSettings s = Only(DspStageKind::Limiter);
+    float ceiling = std::pow(10.0f, s.limiterCeilingDb / 20.0f);
+
+    // Loud tone with sharp clicks up to 4x full scale
+    DspChain chain;
+    chain.Configure(RATE, s);
+    std::vector<float> hot = Sine(440.0, 1.5f, 2.0);
+    Noise noise;
+    for (size_t i = 0; i < hot.size(); i += 997) hot[i] = noise.Next(4.0f);
+    Run(chain, hot);
+    printf("  limiter: hot input peak out %.4f (ceiling %.4f), latency %zu samples\n",
+           PeakOf(hot), ceiling, chain.GetLatency());
+    Check(PeakOf(hot) <= ceiling + 1e-6, "limiter: never above the ceiling");
+
+    // Below the ceiling it is a pure delay
+    chain.Configure(RATE, s);
+    std::vector<float> quiet = Sine(440.0, 0.5f, 1.0);
+    std::vector<float> original = quiet;
+    Run(chain, quiet);
+    size_t delay = chain.GetLatency();
+    double maxError = 0.0;
+    for (size_t i = delay; i < quiet.size(); i++) {
+        double e = std::fabs(quiet[i] - original[i - delay]);
+        if (e > maxError) maxError = e;
+    }
+    Check(maxError < 1e-6, "limiter: transparent below the ceiling (delay only)");
+    Check(delay == (size_t)(RATE * s.limiterLookaheadMs / 1000.0f) - 1, "limiter: latency is the look-ahead");
+}
+
+static void CheckGate() {
+    DspChain chain;
+    chain.Configure(RATE, Only(DspStageKind::NoiseGate));
+    // 2 s of -65 dBFS room noise, then 2 s of speech-level tone
+    Noise noise;
+    std::vector<float> x(4 * RATE);
+    for (size_t i = 0; i < 2 * RATE; i++) x[i] = noise.Next(0.001f);
+    for (size_t i = 2 * RATE; i < x.size(); i++) x[i] = 0.1f * (float)std::sin(2.0 * PI * 300.0 * i / RATE);
+    std::vector<float> in = x;
+    Run(chain, x);
+    double noiseCut = RmsDb(x.data() + RATE, RATE) - RmsDb(in.data() + RATE, RATE);
+    double speechChange = RmsDb(x.data() + 3 * RATE, RATE) - RmsDb(in.data() + 3 * RATE, RATE);
+    printf("  gate: noise %.1f dB, speech %.2f dB\n", noiseCut, speechChange);
+    Check(noiseCut < -25.0, "gate: room noise attenuated more than 25 dB");
+    Check(std::fabs(speechChange) < 0.5, "gate: speech passes");
+}
+
+static void CheckAgc() {
+    DspSettings s = Only(DspStageKind::Agc);
+    DspChain chain;
+    chain.Configure(RATE, s);
+    // Quiet talker (-33 dBFS RMS) for 10 s, then a loud one (-13 dBFS) for 5 s
+    std::vector<float> quiet = Sine(250.0, 0.0316f, 10.0);
+    std::vector<float> loud = Sine(250.0, 0.316f, 5.0);
+    Run(chain, quiet);
+    Run(chain, loud);
+    double quietOut = TailDb(quiet, 1.0), loudOut = TailDb(loud, 1.0);
+    printf("  agc: quiet talker ends at %.1f dBFS, loud talker at %.1f dBFS (target %.0f)\n",
+           quietOut, loudOut, s.agcTargetDb);
+    Check(std::fabs(quietOut - s.agcTargetDb) < 1.5, "agc: quiet talker brought to target");
+    Check(std::fabs(loudOut - s.agcTargetDb) < 1.5, "agc: loud talker brought to target");
+}
+
+static void CheckSuppression() {
+    // Floor 0 dB: must reconstruct the input exactly (delayed)
+    DspSettings s = Only(DspStageKind::NoiseSuppression);
+    s.suppressionFloorDb = 0.0f;
+    DspChain chain;
+    chain.Configure(RATE, s);
+    std::vector<float> x = Sine(700.0, 0.3f, 1.0);
+    std::vector<float> original = x;
+    Run(chain, x);
+    size_t delay = chain.GetLatency();
+    double maxError = 0.0;
+    for (size_t i = delay + NoiseSuppressionStage::FRAME; i < x.size(); i++) {
+        double e = std::fabs(x[i] - original[i - delay]);
+        if (e > maxError) maxError = e;
+    }
+    Check(maxError < 1e-4, "suppression: perfect reconstruction with the cut disabled");
+
+    // -50 dBFS hiss, then a -20 dBFS tone over the same hiss
+    chain.Configure(RATE, Only(DspStageKind::NoiseSuppression));
+    Noise noise;
+    std::vector<float> y(6 * RATE);
+    for (size_t i = 0; i < y.size(); i++) {
+        y[i] = noise.Next(0.0055f);
+        if (i >= 3 * RATE) y[i] += 0.14f * (float)std::sin(2.0 * PI * 1000.0 * i / RATE);
+    }
+    std::vector<float> in = y;
+    Run(chain, y);
+    double hissCut = RmsDb(y.data() + 2 * RATE, RATE) - RmsDb(in.data() + 2 * RATE, RATE);
+    double toneChange = RmsDb(y.data() + 5 * RATE, RATE) - RmsDb(in.data() + 5 * RATE, RATE);
+    printf("  suppression: hiss %.1f dB, tone %.2f dB\n", hissCut, toneChange);
+    Check(hissCut < -10.0, "suppression: steady hiss cut more than 10 dB");
+    Check(std::fabs(toneChange) < 1.0, "suppression: tone kept within 1 dB");
+}
+
+static void CheckBudget(int minutes) {
+    DspSettings s;
+    s.noiseGate = s.agc = s.noiseSuppression = true;
+    DspTimings timings;
+    DspChain chain;
+    chain.Configure(RATE, s, &timings);
+
+    // Speech-like bursts over noise, processed in the mixer's 2 s chunks
+    Noise noise;
+    std::vector<float> chunk(2 * RATE);
+    for (size_t i = 0; i < chunk.size(); i++) {
+        double t = (double)i / RATE;
+        float env = std::fmod(t, 1.0) < 0.7 ? 0.2f : 0.0f;
+        chunk[i] = noise.Next(0.002f) + env * (float)std::sin(2.0 * PI * 180.0 * t) * noise.Next(1.0f);
+    }
+    std::vector<float> work(chunk.size());
+    size_t chunks = (size_t)minutes * 30;
+    size_t allocationsBefore = g_allocations.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < chunks; c++) {
+        memcpy(work.data(), chunk.data(), chunk.size() * sizeof(float));
+        chain.Process(work.data(), work.size());
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    size_t allocations = g_allocations.load() - allocationsBefore;
+
+    double realtime = (minutes * 60.0) / (sec > 0 ? sec : 1e-9);
+    printf("  full chain: %d min in %.1f ms, %.0fx realtime, latency %.1f ms\n",
+           minutes, sec * 1000.0, realtime, chain.GetLatency() * 1000.0 / RATE);
+    printf("  %s\n", timings.ToJson().c_str());
+    Check(allocations == 0, "no heap allocations while processing");
+    Check(timings.GetChainAvgUs() < 10000.0 * s.budgetPercent / 100.0, "full chain average within its budget per 10 ms block");
+    Check(PeakOf(work) <= std::pow(10.0, s.limiterCeilingDb / 20.0) + 1e-6, "full chain output under the ceiling");
+}
+
+static int SelfTest(int minutes) {
+    printf("Stages:\n");
+    CheckHighPass();
+    CheckLimiter();
+    CheckGate();
+    CheckAgc();
+    CheckSuppression();
+    printf("Budget:\n");
+    CheckBudget(minutes);
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    DspSettings settings;
+    bool selftest = false;
+    int minutes = 10;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--selftest") == 0) selftest = true;
+        else if (strcmp(arg, "--minutes") == 0 && hasValue) minutes = atoi(argv[++i]);
+        else if (strcmp(arg, "--gate") == 0) settings.noiseGate = true;
+        else if (strcmp(arg, "--agc") == 0) settings.agc = true;
+        else if (strcmp(arg, "--ns") == 0) settings.noiseSuppression = true;
+        else if (strcmp(arg, "--no-highpass") == 0) settings.highPass = false;
+        else if (strcmp(arg, "--no-limiter") == 0) settings.limiter = false;
+        else if (strcmp(arg, "--ceiling") == 0 && hasValue) settings.limiterCeilingDb = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--target") == 0 && hasValue) settings.agcTargetDb = (float)atof(argv[++i]);
+        else if (arg[0] != '-') paths.push_back(arg);
+        else { PrintUsage(); return 2; }
+    }
+    if (minutes < 1) minutes = 1;
+
+    if (selftest) return SelfTest(minutes);
+    if (paths.size() != 2) { PrintUsage(); return 2; }
+    return ProcessFile(paths[0], paths[1], settings);
+}
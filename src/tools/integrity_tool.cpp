@@ -0,0 +1,343 @@
+// MicMute-S recording integrity tool
+//
+// Verifies the hash chain root embedded in recordings (see
+// storage/integrity_chain.h) for single files or whole archive folders,
+// hashing on every core, and checks the chain builder and verifier on
+// synthetic recordings. No Win32 dependencies:
+//
+//   Windows: see build.bat (integrity_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -pthread -o integrity_tool
+//              src/tools/integrity_tool.cpp src/storage/integrity_chain.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//              src/core/thread_pool.cpp src/audio/WavMetadata.cpp
+//
+// Usage: integrity_tool <folder|file.wav>... [--threads N] [--key HEX]...
+//        integrity_tool --selftest
+//        integrity_tool --bench [--mb N] [--files N]
+//                       (exit code 1 if a recording fails verification or a check fails)
+
+#include "storage/integrity_chain.h"
+#include "storage/encrypted_recording.h"
+#include "core/thread_pool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const uint32_t RATE = 48000;
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: integrity_tool <folder|file.wav>... [--threads N] [--key HEX]...\n");
+    printf("       integrity_tool --selftest\n");
+    printf("       integrity_tool --bench [--mb N] [--files N]\n");
+}
+
+static double Seconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+static size_t AllCores() {
+    size_t n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+static void CollectWavs(const std::string& path, std::vector<std::string>& out) {
+    std::error_code ec;
+    if (!fs::is_directory(path, ec)) {
+        out.push_back(path);
+        return;
+    }
+    for (auto it = fs::recursive_directory_iterator(path, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (!it->is_regular_file()) continue;
+        std::string ext = it->path().extension().string();
+        if (ext == ".wav" || ext == ".WAV") out.push_back(it->path().string());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Verify
+// ---------------------------------------------------------------------------
+
+static int Verify(const std::vector<std::string>& inputs, size_t threads) {
+    std::vector<std::string> paths;
+    for (const auto& p : inputs) CollectWavs(p, paths);
+
+    uint64_t bytes = 0;
+    int counts[5] = {};
+    auto t0 = std::chrono::steady_clock::now();
+    ThreadPool pool(threads, false);
+    std::vector<IntegrityResult> results = VerifyRecordings(paths, pool);
+    double secs = Seconds(std::chrono::steady_clock::now() - t0);
+
+    for (const auto& r : results) {
+        counts[(int)r.status]++;
+        bytes += r.dataBytes;
+        if (r.status == IntegrityStatus::Verified || r.status == IntegrityStatus::NoChain) continue;
+        printf("%-10s %s%s%s\n", r.GetStatusName(), r.path.c_str(), r.message.empty() ? "" : ": ", r.message.c_str());
+        if (r.status == IntegrityStatus::Mismatch) {
+            printf("           recorded %s\n           computed %s\n", r.expectedRoot.c_str(), r.actualRoot.c_str());
+        }
+    }
+
+    printf("\n%zu recordings: %d verified, %d MISMATCH, %d without a chain, %d transcoded, %d unreadable\n",
+           results.size(), counts[(int)IntegrityStatus::Verified], counts[(int)IntegrityStatus::Mismatch],
+           counts[(int)IntegrityStatus::NoChain], counts[(int)IntegrityStatus::Transcoded],
+           counts[(int)IntegrityStatus::Unreadable]);
+    printf("%.1f MB of audio hashed in %.3f s on %zu threads (%.0f MB/s)\n", bytes / 1e6, secs,
+           pool.GetThreadCount(), secs > 0 ? bytes / 1e6 / secs : 0.0);
+    return counts[(int)IntegrityStatus::Mismatch] + counts[(int)IntegrityStatus::Unreadable] == 0 ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// Selftest / benchmark
+// ---------------------------------------------------------------------------
+
+static std::vector<char> MakeAudio(size_t bytes, uint32_t seed) {
+    std::vector<char> audio(bytes);
+    std::mt19937 rng(seed);
+    for (auto& b : audio) b = (char)rng();
+    return audio;
+}
+
+// A recording as StreamingWavWriter finalizes it: chain fed in uneven
+// pieces while "streaming", root embedded in the header region
+static std::vector<char> MakeWav(const std::vector<char>& audio, WavMetadata md, bool withChain) {
+    IntegrityChain chain;
+    chain.Start(RATE, 1, 16);
+    std::mt19937 rng(1);
+    for (size_t pos = 0; pos < audio.size(); ) {
+        size_t n = std::min<size_t>(audio.size() - pos, 1 + rng() % 9000);
+        chain.Add(audio.data() + pos, n);
+        pos += n;
+    }
+    if (withChain) chain.AddToMetadata(md);
+
+    std::vector<char> wav = WavMeta::BuildHeader(RATE, 1, 16, (uint32_t)audio.size());
+    std::vector<char> chunks = WavMeta::BuildChunks(md);
+    size_t leftover = WavMeta::RESERVED_REGION_SIZE - chunks.size();
+    chunks.insert(chunks.end(), { 'J', 'U', 'N', 'K' });
+    uint32_t junk = (uint32_t)(leftover - 8);
+    chunks.insert(chunks.end(), reinterpret_cast<char*>(&junk), reinterpret_cast<char*>(&junk) + 4);
+    chunks.resize(WavMeta::RESERVED_REGION_SIZE, 0);
+    memcpy(&wav[WavMeta::RESERVED_REGION_OFFSET], chunks.data(), chunks.size());
+    wav.insert(wav.end(), audio.begin(), audio.end());
+    return wav;
+}
+
+static void SaveFile(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(bytes.data(), bytes.size());
+}
+
+static IntegrityStatus VerifyOne(const std::string& path, ThreadPool& pool) {
+    return VerifyRecordings({ path }, pool)[0].status;
+}
+
+static int SelfTest() {
+    printf("Chain\n");
+    std::vector<char> audio = MakeAudio(3 * IntegrityChain::BLOCK_SIZE + 12345, 5);
+
+    IntegrityChain whole, pieces;
+    whole.Start(RATE, 1, 16);
+    whole.Add(audio.data(), audio.size());
+    pieces.Start(RATE, 1, 16);
+    for (size_t pos = 0; pos < audio.size(); pos += 777) {
+        pieces.Add(audio.data() + pos, std::min<size_t>(777, audio.size() - pos));
+    }
+    Check(whole.GetRootHex() == pieces.GetRootHex(), "root independent of write sizes");
+
+    // The root is defined by the formula, not by this implementation
+    uint8_t c[32];
+    IntegrityChain::Seed(RATE, 1, 16, c);
+    for (size_t pos = 0; pos < audio.size(); pos += IntegrityChain::BLOCK_SIZE) {
+        Sha256 sha;
+        sha.Update(audio.data() + pos, std::min<size_t>(IntegrityChain::BLOCK_SIZE, audio.size() - pos));
+        uint8_t h[32];
+        sha.Final(h);
+        IntegrityChain::Link(c, h);
+    }
+    Check(IntegrityChain::RootHex(c, audio.size()) == whole.GetRootHex(), "root matches the block-by-block definition");
+
+    IntegrityChain other;
+    other.Start(44100, 1, 16);
+    other.Add(audio.data(), audio.size());
+    Check(other.GetRootHex() != whole.GetRootHex(), "format is part of the root");
+
+    // Finalize cost: a 200 MB stream's root costs no more than a short one's
+    IntegrityChain longCall;
+    longCall.Start(RATE, 1, 16);
+    std::vector<char> block(1 << 20, 1);
+    for (int i = 0; i < 200; i++) longCall.Add(block.data(), block.size() - 7);
+    auto t0 = std::chrono::steady_clock::now();
+    std::string root = longCall.GetRootHex();
+    double finishMs = Seconds(std::chrono::steady_clock::now() - t0) * 1000.0;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "root of a 200 MB stream in %.3f ms (no re-read)", finishMs);
+    Check(finishMs < 5.0 && root.size() == 64, msg);
+
+    printf("\nVerifier\n");
+    std::string dir = fs::temp_directory_path().string();
+    ThreadPool pool(AllCores(), false);
+    WavMetadata md;
+    md["file"] = "call_0042";
+
+    std::vector<char> big = MakeAudio(20 * 1024 * 1024 + 3, 9);
+    std::vector<char> wav = MakeWav(big, md, true);
+    const std::string good = dir + "/chain_good.wav";
+    SaveFile(good, wav);
+    Check(VerifyOne(good, pool) == IntegrityStatus::Verified, "untouched 20 MB recording verifies");
+
+    std::vector<char> edited = wav;
+    edited[WavMeta::DATA_OFFSET + 13 * IntegrityChain::BLOCK_SIZE + 99] ^= 1;
+    const std::string bad = dir + "/chain_bad.wav";
+    SaveFile(bad, edited);
+    Check(VerifyOne(bad, pool) == IntegrityStatus::Mismatch, "one flipped bit is a mismatch");
+
+    std::vector<char> swapped = wav;
+    std::swap_ranges(swapped.begin() + WavMeta::DATA_OFFSET,
+                     swapped.begin() + WavMeta::DATA_OFFSET + IntegrityChain::BLOCK_SIZE,
+                     swapped.begin() + WavMeta::DATA_OFFSET + IntegrityChain::BLOCK_SIZE);
+    SaveFile(bad, swapped);
+    Check(VerifyOne(bad, pool) == IntegrityStatus::Mismatch, "reordered blocks are a mismatch");
+
+    std::vector<char> cut(wav.begin(), wav.end() - IntegrityChain::BLOCK_SIZE);
+    SaveFile(bad, cut);
+    Check(VerifyOne(bad, pool) == IntegrityStatus::Mismatch, "truncated recording is a mismatch");
+
+    const std::string legacy = dir + "/chain_legacy.wav";
+    SaveFile(legacy, MakeWav(audio, md, false));
+    Check(VerifyOne(legacy, pool) == IntegrityStatus::NoChain, "recording without a chain reported as such");
+
+    WavMetadata archived = md;
+    archived["codec"] = "ima_adpcm";
+    const std::string adpcm = dir + "/chain_adpcm.wav";
+    SaveFile(adpcm, MakeWav(audio, archived, true));
+    Check(VerifyOne(adpcm, pool) == IntegrityStatus::Transcoded, "transcoded recording not mistaken for an edit");
+
+    // Encrypted: the chain covers the plaintext audio
+    RecordingKey key;
+    RecordingKey::Generate(key);
+    const std::string enc = dir + "/chain_enc.wav";
+    {
+        EncryptedRecordingWriter writer;
+        writer.Open(enc, key, RATE, 1, 16);
+        writer.PatchHeader(0, wav.data(), WavMeta::DATA_OFFSET);
+        writer.Append(big.data(), big.size());
+        writer.Finish();
+    }
+    GetRecordingKeyring().Clear();
+    Check(VerifyOne(enc, pool) == IntegrityStatus::Unreadable, "encrypted recording without the key is unreadable");
+    GetRecordingKeyring().Add(key);
+    Check(VerifyOne(enc, pool) == IntegrityStatus::Verified, "encrypted recording verifies with the key");
+    GetRecordingKeyring().Clear();
+
+    // Same answers on one thread and on all of them
+    std::vector<std::string> all = { good, bad, legacy, adpcm, good };
+    ThreadPool single(1, false);
+    std::vector<IntegrityResult> a = VerifyRecordings(all, single), b = VerifyRecordings(all, pool);
+    bool same = a.size() == b.size();
+    for (size_t i = 0; same && i < a.size(); i++) {
+        same = a[i].path == b[i].path && a[i].status == b[i].status && a[i].actualRoot == b[i].actualRoot;
+    }
+    Check(same, "parallel results match single-threaded, in input order");
+
+    for (const auto& p : { good, bad, legacy, adpcm, enc }) {
+        std::error_code ec;
+        fs::remove(p, ec);
+    }
+
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
+
+static int Bench(int totalMb, int files) {
+    std::string dir = (fs::temp_directory_path() / "integrity_bench").string();
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    printf("Writing %d recordings, %d MB of audio in total, to %s\n", files, totalMb, dir.c_str());
+
+    std::vector<std::string> paths;
+    size_t perFile = (size_t)totalMb * 1024 * 1024 / files;
+    WavMetadata md;
+    for (int i = 0; i < files; i++) {
+        md["file"] = "call_" + std::to_string(i);
+        paths.push_back(dir + "/call_" + std::to_string(i) + ".wav");
+        SaveFile(paths.back(), MakeWav(MakeAudio(perFile, i), md, true));
+    }
+
+    double base = 0;
+    for (size_t threads : { (size_t)1, AllCores() }) {
+        ThreadPool pool(threads, false);
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<IntegrityResult> results = VerifyRecordings(paths, pool);
+        double secs = Seconds(std::chrono::steady_clock::now() - t0);
+        int verified = 0;
+        for (const auto& r : results) verified += r.status == IntegrityStatus::Verified;
+        if (threads == 1) base = secs;
+        printf("  %2zu threads: %.3f s, %7.0f MB/s, %d/%d verified", threads, secs, totalMb / secs, verified, files);
+        if (threads > 1) printf(" (%.1fx)", base / secs);
+        printf("\n");
+        if (verified != files) g_failures++;
+    }
+
+    // One large recording alone still spreads over every core
+    ThreadPool pool(AllCores(), false);
+    auto t0 = std::chrono::steady_clock::now();
+    IntegrityStatus status = VerifyRecordings({ paths[0] }, pool)[0].status;
+    double secs = Seconds(std::chrono::steady_clock::now() - t0);
+    printf("  one %.0f MB recording alone on %zu threads: %.3f s (%.0f MB/s)\n", perFile / 1048576.0,
+           pool.GetThreadCount(), secs, perFile / 1048576.0 / secs);
+    if (status != IntegrityStatus::Verified) g_failures++;
+
+    fs::remove_all(dir, ec);
+    return g_failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    size_t threads = AllCores();
+    bool selftest = false, bench = false;
+    int mb = 512, files = 8;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--selftest") == 0) selftest = true;
+        else if (strcmp(arg, "--bench") == 0) bench = true;
+        else if (strcmp(arg, "--threads") == 0 && hasValue) threads = (size_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--mb") == 0 && hasValue) mb = atoi(argv[++i]);
+        else if (strcmp(arg, "--files") == 0 && hasValue) files = atoi(argv[++i]);
+        else if (strcmp(arg, "--key") == 0 && hasValue) {
+            RecordingKey key;
+            if (!RecordingKey::FromHex(argv[++i], key)) {
+                fprintf(stderr, "--key must be 64 hex digits\n");
+                return 2;
+            }
+            GetRecordingKeyring().Add(key);
+        }
+        else if (arg[0] != '-') paths.push_back(arg);
+        else { PrintUsage(); return 2; }
+    }
+    if (threads < 1) threads = 1;
+    if (mb < 1) mb = 1;
+    if (files < 1) files = 1;
+
+    if (selftest) return SelfTest();
+    if (bench) return Bench(mb, files);
+    if (paths.empty()) { PrintUsage(); return 2; }
+    return Verify(paths, threads);
+}
@@ -0,0 +1,288 @@
+// MicMute-S recording list benchmark
+//
+// Measures how the player's virtualized recording list behaves on a large
+// archive: catalog load (folder listing, then headers), query time per
+// sort order and filter, and per-frame cost while scrolling. On Windows
+// the frame includes drawing the visible rows with GDI into a memory DC,
+// like the player does.
+//
+//   Windows: see build.bat (list_bench.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o list_bench
+//              src/tools/list_bench.cpp src/storage/recording_list_model.cpp
+//              src/storage/recording_catalog.cpp src/audio/WavMetadata.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: list_bench <recordings folder> [--rows N]
+//        list_bench --make <empty folder> [--count N]
+//
+// --make writes header-only stub recordings (default 100000) spread over
+// date folders, with metadata and a range of durations. The stubs declare
+// one byte per second of audio so 100k of them stay small; they are for
+// this benchmark only and do not play.
+
+#include "storage/recording_list_model.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage() {
+    printf("Usage: list_bench <recordings folder> [--rows N]\n");
+    printf("       list_bench --make <empty folder> [--count N]\n");
+}
+
+static double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// ---------------------------------------------------------------------------
+// Stub archive
+// ---------------------------------------------------------------------------
+
+static void Put32(std::vector<char>& out, uint32_t v) { out.insert(out.end(), (char*)&v, (char*)&v + 4); }
+static void Put16(std::vector<char>& out, uint16_t v) { out.insert(out.end(), (char*)&v, (char*)&v + 2); }
+
+static bool WriteStub(const fs::path& path, uint32_t seconds, const WavMetadata& metadata) {
+    std::vector<char> out;
+    out.insert(out.end(), { 'R', 'I', 'F', 'F' });
+    Put32(out, 0);
+    out.insert(out.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    Put32(out, 16);
+    Put16(out, 1);          // PCM
+    Put16(out, 1);          // Mono
+    Put32(out, 1);          // 1 "sample" per second, 1 byte per second
+    Put32(out, 1);
+    Put16(out, 1);
+    Put16(out, 8);
+    std::vector<char> meta = WavMeta::BuildChunks(metadata);
+    out.insert(out.end(), meta.begin(), meta.end());
+    out.insert(out.end(), { 'd', 'a', 't', 'a' });
+    Put32(out, seconds);
+    out.resize(out.size() + seconds, (char)0x80);
+    if (seconds & 1) out.push_back(0);
+    uint32_t riffSize = (uint32_t)out.size() - 8;
+    memcpy(out.data() + 4, &riffSize, 4);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+    return file.good();
+}
+
+static int MakeArchive(const std::string& root, int count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> perDay(20, 400);
+    std::exponential_distribution<double> duration(1.0 / 240.0);
+    const char* campaigns[] = { "spring", "renewals", "support", "winback", "billing" };
+
+    int made = 0, day = 0;
+    Clock::time_point start = Clock::now();
+    while (made < count) {
+        // Walk back from 2026-12-31 one day at a time (30-day months are fine here)
+        int dayIndex = day++;
+        int year = 2026 - dayIndex / 360, month = 12 - (dayIndex / 30) % 12, dom = 30 - dayIndex % 30;
+        char folder[16];
+        snprintf(folder, sizeof(folder), "%04d-%02d-%02d", year, month, dom);
+        fs::path dir = fs::path(root) / folder;
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+
+        int calls = std::min(perDay(rng), count - made);
+        for (int i = 0; i < calls; i++) {
+            char name[64];
+            snprintf(name, sizeof(name), "call_%04d_%02d%02d%02d.wav", i + 1, 8 + i * 10 / calls, i % 60, (i * 7) % 60);
+            WavMetadata metadata;
+            metadata["customer"] = std::to_string(100000 + rng() % 900000);
+            metadata["campaign"] = campaigns[rng() % 5];
+            metadata["agent"] = "agent" + std::to_string(rng() % 40);
+            uint32_t seconds = 5 + (uint32_t)std::min(duration(rng), 7200.0);
+            if (!WriteStub(dir / name, seconds, metadata)) { printf("Cannot write %s\n", (dir / name).string().c_str()); return 1; }
+            made++;
+        }
+    }
+    printf("%d stub recordings in %d date folders (%.1f s)\n", made, day, ElapsedMs(start) / 1000.0);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Frame rendering (what the player does per visible row)
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+struct Canvas {
+    HDC dc = nullptr;
+    HBITMAP bmp = nullptr;
+    HFONT font = nullptr;
+    Canvas() {
+        HDC screen = GetDC(nullptr);
+        dc = CreateCompatibleDC(screen);
+        bmp = CreateCompatibleBitmap(screen, 420, 28 * 64);
+        ReleaseDC(nullptr, screen);
+        SelectObject(dc, bmp);
+        font = CreateFontA(-13, 0, 0, 0, FW_NORMAL, 0, 0, 0, DEFAULT_CHARSET, 0, 0, CLEARTYPE_QUALITY, 0, "Segoe UI");
+        SelectObject(dc, font);
+        SetBkMode(dc, TRANSPARENT);
+    }
+    ~Canvas() { DeleteObject(font); DeleteObject(bmp); DeleteDC(dc); }
+    void DrawRow(int slot, const char* name, const char* meta) {
+        RECT rn = { 28, slot * 28, 330, slot * 28 + 28 };
+        DrawTextA(dc, name, -1, &rn, DT_SINGLELINE | DT_VCENTER | DT_END_ELLIPSIS);
+        RECT rm = { 280, slot * 28, 414, slot * 28 + 28 };
+        DrawTextA(dc, meta, -1, &rm, DT_SINGLELINE | DT_VCENTER | DT_RIGHT);
+    }
+};
+#else
+struct Canvas {
+    size_t sink = 0;
+    void DrawRow(int, const char* name, const char* meta) { sink += strlen(name) + strlen(meta); }
+};
+#endif
+
+static void RenderFrame(RecordingListModel& model, Canvas& canvas, int first, int rows) {
+    model.SetVisibleRange(first, rows + 1);
+    for (int i = first; i < first + rows && i < model.GetCount(); i++) {
+        const RecordingRow* row = model.GetRow(i);
+        if (!row) break;
+        char meta[64];
+        if (row->durationMs > 0)
+            snprintf(meta, sizeof(meta), "%s  %u:%02u", row->dateStr.c_str(), row->durationMs / 60000, row->durationMs / 1000 % 60);
+        else
+            snprintf(meta, sizeof(meta), "%s  %uKB", row->dateStr.c_str(), row->sizeKB);
+        canvas.DrawRow(i - first, row->display.c_str(), meta);
+    }
+}
+
+struct FrameStats {
+    std::vector<double> us;
+    void Print(const char* label) {
+        if (us.empty()) return;
+        std::sort(us.begin(), us.end());
+        double sum = 0.0;
+        for (double v : us) sum += v;
+        printf("  %-28s %7zu frames  avg %7.1f us  p50 %7.1f  p99 %7.1f  max %8.1f\n", label, us.size(),
+               sum / us.size(), us[us.size() / 2], us[us.size() * 99 / 100], us.back());
+    }
+};
+
+// Wheel: 3 rows per frame from the top to the bottom (capped)
+static void ScrollWheel(RecordingListModel& model, Canvas& canvas, int rows, const char* label) {
+    FrameStats stats;
+    int maxFirst = std::max(0, model.GetCount() - rows);
+    for (int first = 0; first <= maxFirst && stats.us.size() < 40000; first += 3) {
+        Clock::time_point t = Clock::now();
+        RenderFrame(model, canvas, first, rows);
+        stats.us.push_back(ElapsedMs(t) * 1000.0);
+    }
+    stats.Print(label);
+}
+
+// Scrollbar drag / jumps: every frame lands somewhere new
+static void ScrollJump(RecordingListModel& model, Canvas& canvas, int rows, const char* label) {
+    FrameStats stats;
+    std::mt19937 rng(1);
+    int maxFirst = std::max(0, model.GetCount() - rows);
+    for (int i = 0; i < 2000; i++) {
+        int first = maxFirst ? (int)(rng() % (uint32_t)(maxFirst + 1)) : 0;
+        Clock::time_point t = Clock::now();
+        RenderFrame(model, canvas, first, rows);
+        stats.us.push_back(ElapsedMs(t) * 1000.0);
+    }
+    stats.Print(label);
+}
+
+static int Bench(const std::string& root, int rows) {
+    RecordingCatalog catalog;
+
+    Clock::time_point t = Clock::now();
+    catalog.ScanFiles(root);
+    double scanMs = ElapsedMs(t);
+    size_t total = catalog.GetCount();
+    if (total == 0) { printf("No recordings under %s\n", root.c_str()); return 1; }
+
+    RecordingListModel model(catalog);
+    t = Clock::now();
+    model.Refresh();
+    Canvas canvas;
+    RenderFrame(model, canvas, 0, rows);
+    double firstFrameMs = ElapsedMs(t);
+
+    t = Clock::now();
+    size_t batches = 0;
+    while (catalog.LoadPendingHeaders(2048) > 0) batches++;
+    double headerMs = ElapsedMs(t);
+
+    printf("%zu recordings\n\n", total);
+    printf("load:\n");
+    printf("  folder listing             %8.1f ms   (list shows after this)\n", scanMs);
+    printf("  first frame                %8.2f ms\n", firstFrameMs);
+    printf("  headers, %3zu batches       %8.1f ms   (background)\n\n", batches, headerMs);
+
+    printf("queries:\n");
+    const char* queries[] = { "", "sort:oldest", "sort:longest", "sort:name", "campaign=renewals",
+                              "date:2026-11", "dur>600 sort:longest", "1234" };
+    for (const char* q : queries) {
+        t = Clock::now();
+        model.SetQuery(CatalogQuery::Parse(q));
+        double ms = ElapsedMs(t);
+        printf("  %-24s %8.2f ms  %7d rows\n", *q ? q : "(all, newest)", ms, model.GetCount());
+    }
+
+    printf("\nscrolling, %d visible rows:\n", rows);
+    model.SetQuery(CatalogQuery());
+    ScrollWheel(model, canvas, rows, "wheel, newest");
+    ScrollJump(model, canvas, rows, "jumps, newest");
+    model.SetQuery(CatalogQuery::Parse("sort:longest"));
+    ScrollWheel(model, canvas, rows, "wheel, longest");
+    ScrollJump(model, canvas, rows, "jumps, longest");
+    model.SetQuery(CatalogQuery::Parse("campaign=support sort:name"));
+    ScrollJump(model, canvas, rows, "jumps, filtered by name");
+
+    printf("\nview memory: %.0f KB of ids + %d rows paged in\n",
+           total * 4 / 1024.0, 2 * RecordingListModel::PAGE_MARGIN + rows + 1);
+
+    // For comparison, what the old list did on every load: a full copy
+    // of every entry (last, so freeing it does not skew the numbers above)
+    {
+        t = Clock::now();
+        std::vector<CatalogEntry> snapshot = catalog.Snapshot();
+        std::vector<RecordingRow> copy(snapshot.size());
+        for (size_t i = 0; i < snapshot.size(); i++) {
+            copy[i].path = snapshot[i].path;
+            copy[i].display = snapshot[i].name;
+            copy[i].dateStr = snapshot[i].dateFolder;
+        }
+        printf("previous list, full copy on load: %.1f ms\n", ElapsedMs(t));
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string root, makeRoot;
+    int count = 100000, rows = 5;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--make") == 0 && hasValue)        makeRoot = argv[++i];
+        else if (strcmp(arg, "--count") == 0 && hasValue)  count = atoi(argv[++i]);
+        else if (strcmp(arg, "--rows") == 0 && hasValue)   rows = atoi(argv[++i]);
+        else if (arg[0] != '-' && root.empty())            root = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    if (!makeRoot.empty()) return count > 0 ? MakeArchive(makeRoot, count) : 2;
+    if (root.empty() || rows <= 0 || rows > 64) { PrintUsage(); return 2; }
+    return Bench(root, rows);
+}
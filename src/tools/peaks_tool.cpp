@@ -0,0 +1,131 @@
+// MicMute-S peaks tool
+//
+// Builds the .peaks waveform sidecars for recordings made before the
+// recorder wrote them, and measures pyramid build speed and query latency.
+// No Win32 dependencies:
+//
+//   Windows: see build.bat (peaks_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o peaks_tool
+//              src/tools/peaks_tool.cpp src/audio/PeakPyramid.cpp src/audio/WavDecoder.cpp
+//              src/audio/MappedWavReader.cpp src/core/mapped_file.cpp src/audio/WavMetadata.cpp
+//              src/audio/ImaAdpcm.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: peaks_tool <recordings folder> [--force]
+//        peaks_tool --bench <recording.wav> [--columns N]
+
+#include "audio/PeakPyramid.h"
+#include "audio/WavDecoder.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage() {
+    printf("Usage: peaks_tool <recordings folder> [--force]\n");
+    printf("       peaks_tool --bench <recording.wav> [--columns N]\n");
+}
+
+static double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static int BuildFolder(const std::string& root, bool force) {
+    size_t built = 0, skipped = 0, failed = 0;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec)) {
+        if (ec) break;
+        if (!it->is_regular_file(ec) || it->path().extension() != ".wav") continue;
+
+        std::string path = it->path().string();
+        std::string sidecar = PeakPyramid::GetSidecarPath(path);
+        if (!force && fs::exists(sidecar, ec)) { skipped++; continue; }
+
+        PeakPyramid pyramid;
+        if (PeakPyramidBuilder::BuildFromWav(path, pyramid) && pyramid.Save(sidecar)) {
+            printf("OK   %s  %zu entries\n", path.c_str(), pyramid.GetLevel(0).size());
+            built++;
+        } else {
+            printf("FAIL %s\n", path.c_str());
+            failed++;
+        }
+    }
+    printf("\n%zu built, %zu already present, %zu failed\n", built, skipped, failed);
+    return failed ? 1 : 0;
+}
+
+static int Bench(const std::string& path, size_t columns) {
+    WavDecoder decoder;
+    if (!decoder.Open(path)) { printf("Cannot decode %s\n", path.c_str()); return 1; }
+    const uint64_t total = decoder.GetTotalFrames();
+    const uint32_t rate = decoder.GetSampleRate();
+    const double audioMB = (double)decoder.GetInfo().dataBytes / 1048576.0;
+    decoder.Close();
+
+    printf("%s: %.1f s, %u Hz, %.1f MB of audio\n", path.c_str(), (double)total / rate, rate, audioMB);
+
+    // Cold build from the audio (what the player does for an old recording)
+    Clock::time_point t = Clock::now();
+    PeakPyramid pyramid;
+    if (!PeakPyramidBuilder::BuildFromWav(path, pyramid)) { printf("Build failed\n"); return 1; }
+    double buildMs = ElapsedMs(t);
+    printf("build:  %8.2f ms  (%.0f MB/s, %zu levels)\n", buildMs, audioMB / (buildMs / 1000.0), pyramid.GetLevelCount());
+
+    // Sidecar round trip (what the player does for a new recording)
+    std::string tmp = (fs::temp_directory_path() / "peaks_tool_bench.peaks").string();
+    t = Clock::now();
+    pyramid.Save(tmp);
+    double saveMs = ElapsedMs(t);
+    t = Clock::now();
+    PeakPyramid loaded;
+    bool ok = loaded.Load(tmp);
+    double loadMs = ElapsedMs(t);
+    std::error_code ec;
+    uintmax_t sidecarBytes = fs::file_size(tmp, ec);
+    fs::remove(tmp, ec);
+    printf("save:   %8.2f ms  load: %.2f ms  (%llu byte sidecar)%s\n", saveMs, loadMs,
+           (unsigned long long)sidecarBytes, ok ? "" : "  LOAD FAILED");
+
+    // Query latency from the whole file down to one second, all at the same width
+    printf("\nquery %zu columns:\n", columns);
+    std::vector<PeakEntry> out;
+    for (uint64_t span = total; span >= rate; span /= 4) {
+        const int iterations = 2000;
+        uint64_t step = total > span ? (total - span) / iterations : 0;
+        t = Clock::now();
+        for (int i = 0; i < iterations; i++) {
+            uint64_t start = step * i;
+            pyramid.Query(start, start + span, columns, out);
+        }
+        double us = ElapsedMs(t) * 1000.0 / iterations;
+        printf("  %10.1f s window  %8.2f us\n", (double)span / rate, us);
+        if (span < 4) break;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string root, benchFile;
+    size_t columns = 1000;
+    bool force = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--bench") == 0 && hasValue)        benchFile = argv[++i];
+        else if (strcmp(arg, "--columns") == 0 && hasValue) columns = (size_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--force") == 0)               force = true;
+        else if (arg[0] != '-' && root.empty())             root = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    if (!benchFile.empty()) return Bench(benchFile, columns ? columns : 1);
+    if (root.empty()) { PrintUsage(); return 2; }
+    return BuildFolder(root, force);
+}
@@ -0,0 +1,243 @@
+// MicMute-S playback benchmark
+//
+// Measures what the player's decoder thread pays per block (WavDecoder
+// reads, plus the WSOLA time-stretcher at speeds other than 1x), then plays
+// through the real PlaybackEngine into a real-time NullAudioOutput with
+// seeks, speed changes and a gapless switch, counting ring underruns.
+// Needs no audio device:
+//
+//   Windows: see build.bat (playback_bench.exe)
+//   Linux:   g++ -std=c++17 -O2 -pthread -I src -o playback_bench
+//              src/tools/playback_bench.cpp src/audio/PlaybackEngine.cpp src/audio/TimeStretch.cpp
+//              src/audio/WavDecoder.cpp src/audio/MappedWavReader.cpp src/core/mapped_file.cpp
+//              src/audio/WavMetadata.cpp src/audio/ImaAdpcm.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: playback_bench [recording.wav] [--seconds N] [--play-seconds N] [--load THREADS]
+//        (seconds applies to the synthetic recording; load adds busy threads
+//         competing with the decoder during the real-time run)
+
+#include "audio/PlaybackEngine.h"
+#include "audio/TimeStretch.h"
+#include "audio/WavDecoder.h"
+#include "audio/WavMetadata.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static const size_t BLOCK_FRAMES = 4096;    // The engine's decode chunk
+
+static void PrintUsage() {
+    printf("Usage: playback_bench [recording.wav] [--seconds N] [--play-seconds N] [--load THREADS]\n");
+}
+
+static double Micros(Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+// A recording as the recorder writes it (48 kHz mono 16-bit) with a
+// voice-like buzz: wandering pitch, syllable envelope
+static bool WriteSynthetic(const std::string& path, double seconds) {
+    const uint32_t rate = 48000;
+    const double pi = 3.14159265358979323846;
+    size_t frames = (size_t)(rate * seconds);
+    std::vector<int16_t> pcm(frames);
+    double phase = 0.0;
+    for (size_t i = 0; i < frames; i++) {
+        double t = (double)i / rate;
+        phase += (140.0 + 40.0 * std::sin(2.0 * pi * 0.7 * t)) / rate;
+        double s = 0.0;
+        for (int h = 1; h <= 12; h++) s += std::sin(2.0 * pi * h * phase) / h;
+        pcm[i] = (int16_t)(8000.0 * s * (0.5 + 0.5 * std::sin(2.0 * pi * 3.0 * t)));
+    }
+    std::vector<char> header = WavMeta::BuildHeader(rate, 1, 16, (uint32_t)(frames * 2));
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(header.data(), header.size());
+    out.write(reinterpret_cast<const char*>(pcm.data()), frames * 2);
+    return out.good();
+}
+
+struct BlockCost {
+    std::vector<double> us;     // Per decoded block
+    uint64_t outputFrames = 0;
+};
+
+// The decoder thread's work for one file, block by block: read, and at
+// speeds other than 1x push through the stretcher and drain it
+static BlockCost MeasureBlocks(const std::string& path, double speed) {
+    BlockCost cost;
+    WavDecoder decoder;
+    if (!decoder.Open(path)) return cost;
+    const uint16_t channels = decoder.GetChannels();
+    TimeStretcher stretch;
+    stretch.Configure(decoder.GetSampleRate(), channels);
+    stretch.SetSpeed(speed);
+    std::vector<float> in(BLOCK_FRAMES * channels);
+    std::vector<float> out(std::max(BLOCK_FRAMES, stretch.GetHopFrames()) * channels);
+
+    for (;;) {
+        Clock::time_point t0 = Clock::now();
+        size_t n = decoder.Read(in.data(), BLOCK_FRAMES);
+        if (n == 0) break;
+        size_t produced = n;
+        if (speed != 1.0) {
+            produced = 0;
+            stretch.PushInput(in.data(), n);
+            while (stretch.GetInputRequired() == 0) produced += stretch.Process(out.data(), out.size() / channels);
+        }
+        cost.us.push_back(Micros(Clock::now() - t0));
+        cost.outputFrames += produced;
+    }
+    return cost;
+}
+
+struct RealtimeResult {
+    uint64_t framesRendered = 0;
+    uint64_t underruns = 0;
+    int trackChanges = 0;
+    int seeks = 0;
+    bool ended = false;
+};
+
+// Plays the tail of path into the queued copy (gapless), seeking every
+// 700 ms and switching speed halfway through
+static RealtimeResult PlayRealtime(const std::string& path, const std::string& next, double speed, double seconds) {
+    RealtimeResult result;
+    auto output = std::make_unique<NullAudioOutput>(true);
+    NullAudioOutput* device = output.get();
+    PlaybackEngine engine(std::move(output));
+
+    std::atomic<int> trackChanges{0};
+    std::atomic<bool> ended{false};
+    PlaybackCallbacks callbacks;
+    callbacks.onTrackChanged = [&](const std::string&) { trackChanges++; };
+    callbacks.onEnded = [&]() { ended = true; };
+    engine.SetCallbacks(callbacks);
+
+    WavDecoder probe;
+    if (!probe.Open(path)) return result;
+    uint64_t total = probe.GetTotalFrames();
+    uint32_t rate = probe.GetSampleRate();
+
+    engine.SetSpeed(speed);
+    engine.Play(path, total > rate ? total - rate : 0);   // One second before the switch
+    engine.QueueNext(next);
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point nextSeek = start + std::chrono::milliseconds(2000);
+    bool switched = false;
+    uint32_t seed = 12345;
+    while (Clock::now() - start < std::chrono::duration<double>(seconds) && !ended) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (Clock::now() >= nextSeek) {
+            seed = seed * 1664525u + 1013904223u;
+            engine.Seek((uint64_t)(seed % 1000) * engine.GetTotalFrames() / 1200);
+            result.seeks++;
+            nextSeek += std::chrono::milliseconds(700);
+        }
+        if (!switched && Clock::now() - start >= std::chrono::duration<double>(seconds / 2)) {
+            engine.SetSpeed(speed == 1.0 ? 1.5 : 1.0);
+            switched = true;
+        }
+    }
+    result.framesRendered = device->GetFramesRendered();
+    result.underruns = engine.GetUnderruns();
+    result.trackChanges = trackChanges;
+    result.ended = ended;
+    engine.Stop();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    std::string path;
+    double seconds = 60.0;
+    double playSeconds = 5.0;
+    int load = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--seconds") == 0 && hasValue)           seconds = atof(argv[++i]);
+        else if (strcmp(arg, "--play-seconds") == 0 && hasValue) playSeconds = atof(argv[++i]);
+        else if (strcmp(arg, "--load") == 0 && hasValue)         load = atoi(argv[++i]);
+        else if (arg[0] != '-' && path.empty())                  path = arg;
+        else { PrintUsage(); return 2; }
+    }
+    if (seconds < 5 || playSeconds <= 0 || load < 0) { PrintUsage(); return 2; }
+
+    std::string synthetic;
+    if (path.empty()) {
+        synthetic = (fs::temp_directory_path() / "playback_bench.wav").string();
+        if (!WriteSynthetic(synthetic, seconds)) { printf("Cannot write %s\n", synthetic.c_str()); return 1; }
+        path = synthetic;
+    }
+    WavDecoder probe;
+    if (!probe.Open(path)) { printf("Cannot decode %s\n", path.c_str()); return 1; }
+    const uint32_t rate = probe.GetSampleRate();
+    const uint16_t channels = probe.GetChannels();
+    printf("%s: %.1f s, %u Hz, %u ch\n\n", synthetic.empty() ? path.c_str() : "synthetic voice",
+           (double)probe.GetTotalFrames() / rate, rate, channels);
+
+    // Cost per decoded block. The ring holds 0.5 s, so a block only has
+    // to be ready well within the time it takes to play.
+    printf("Decoder thread, per %zu-frame block (%.1f ms of input)\n", BLOCK_FRAMES, 1000.0 * BLOCK_FRAMES / rate);
+    printf("speed   blocks   mean us    p99 us    max us   %% of one core\n");
+    const double speeds[] = { 1.0, 0.75, 1.5, 2.0, 3.0 };
+    for (double speed : speeds) {
+        BlockCost cost = MeasureBlocks(path, speed);
+        if (cost.us.empty()) continue;
+        std::vector<double> sorted = cost.us;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double us : sorted) sum += us;
+        double p99 = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+        double playedUs = 1e6 * (double)cost.outputFrames / rate;
+        printf("%4.2fx  %7zu  %8.1f  %8.1f  %8.1f  %13.3f\n", speed, sorted.size(), sum / sorted.size(), p99,
+               sorted.back(), 100.0 * sum / playedUs);
+    }
+
+    // Real time through the engine
+    std::string next = (fs::temp_directory_path() / "playback_bench_next.wav").string();
+    std::error_code ec;
+    fs::copy_file(path, next, fs::copy_options::overwrite_existing, ec);
+    if (ec) { printf("Cannot copy to %s\n", next.c_str()); return 1; }
+
+    std::atomic<bool> stopLoad{false};
+    std::vector<std::thread> busy;
+    for (int i = 0; i < load; i++) {
+        busy.emplace_back([&stopLoad]() {
+            volatile double x = 1.0;
+            while (!stopLoad) x = x * 1.0000001 + 1e-9;
+        });
+    }
+
+    printf("\nPlaybackEngine -> NullAudioOutput, real time, %.0f s each%s\n", playSeconds,
+           load ? (", " + std::to_string(load) + " busy threads").c_str() : "");
+    printf("speed   played s   seeks   track changes   underruns\n");
+    uint64_t underruns = 0;
+    for (double speed : { 1.0, 2.0 }) {
+        RealtimeResult r = PlayRealtime(path, next, speed, playSeconds);
+        printf("%4.2fx  %9.2f  %6d  %14d  %10llu\n", speed, (double)r.framesRendered / rate, r.seeks,
+               r.trackChanges, (unsigned long long)r.underruns);
+        underruns += r.underruns;
+    }
+    stopLoad = true;
+    for (auto& t : busy) t.join();
+    printf("\n%s\n", underruns == 0 ? "no underruns" : "UNDERRUNS: the decoder fell behind the device");
+
+    fs::remove(next, ec);
+    if (!synthetic.empty()) fs::remove(synthetic, ec);
+    return 0;
+}
@@ -0,0 +1,204 @@
+// MicMute-S recording buffer benchmark
+//
+// Replays the streaming recorder's buffer traffic - two capture streams
+// appending 10 ms packets, a mixer that takes both buffers every 2 s chunk,
+// mixes into an output buffer and hands it to the writer - and counts heap
+// allocations per chunk with the old per-chunk vectors and with the audio
+// buffer pool. No Win32 dependencies:
+//
+//   Windows: see build.bat (pool_bench.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o pool_bench
+//              src/tools/pool_bench.cpp src/core/buffer_pool.cpp
+//
+// Usage: pool_bench [--chunks N] [--mic-rate HZ] [--loop-rate HZ]
+//        (exit code 1 if the pooled path allocates in steady state)
+
+#include "core/buffer_pool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Every heap allocation in the process goes through here. Kept out of
+// line: inlined, GCC pairs its built-in new with the free() below and
+// warns about a mismatched delete.
+#ifdef _MSC_VER
+#define REPLACEMENT_NOINLINE __declspec(noinline)
+#else
+#define REPLACEMENT_NOINLINE __attribute__((noinline))
+#endif
+
+static std::atomic<uint64_t> g_heapAllocs(0);
+
+REPLACEMENT_NOINLINE void* operator new(size_t size) {
+    g_heapAllocs++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+REPLACEMENT_NOINLINE void* operator new[](size_t size) { return operator new(size); }
+REPLACEMENT_NOINLINE void operator delete(void* p) noexcept { free(p); }
+REPLACEMENT_NOINLINE void operator delete(void* p, size_t) noexcept { free(p); }
+REPLACEMENT_NOINLINE void operator delete[](void* p) noexcept { free(p); }
+REPLACEMENT_NOINLINE void operator delete[](void* p, size_t) noexcept { free(p); }
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage() {
+    printf("Usage: pool_bench [--chunks N] [--mic-rate HZ] [--loop-rate HZ]\n");
+}
+
+struct Format {
+    uint32_t rate;
+    uint32_t blockAlign;    // Float stereo, like a typical shared-mode mix format
+};
+
+// Packet sizes wander around 10 ms like WASAPI's do
+static uint32_t NextPacketFrames(uint32_t rate, uint32_t& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    uint32_t base = rate / 100;
+    return base - base / 10 + (seed >> 8) % (base / 5 + 1);
+}
+
+// Mono 16-bit mix of two float stereo streams, nearest-sample resampling
+template <typename Buf>
+static void Mix(const Buf& mic, const Buf& loop, const Format& fm, const Format& fl, uint32_t outRate, int16_t* out, size_t outFrames) {
+    size_t micFrames = mic.size() / fm.blockAlign;
+    size_t loopFrames = loop.size() / fl.blockAlign;
+    const float* m = (const float*)mic.data();
+    const float* l = (const float*)loop.data();
+    for (size_t i = 0; i < outFrames; i++) {
+        size_t mi = (size_t)((uint64_t)i * fm.rate / outRate);
+        size_t li = (size_t)((uint64_t)i * fl.rate / outRate);
+        float s = 0.0f;
+        if (mi < micFrames) s += 0.5f * (m[mi * 2] + m[mi * 2 + 1]);
+        if (li < loopFrames) s += 0.5f * (l[li * 2] + l[li * 2 + 1]);
+        if (s > 1.0f) s = 1.0f;
+        if (s < -1.0f) s = -1.0f;
+        out[i] = (int16_t)(s * 32767.0f);
+    }
+}
+
+static uint64_t g_written = 0;  // Writer sink
+
+struct Result {
+    double allocsPerChunk;      // Steady state (after warm-up)
+    uint64_t warmupAllocs;
+    double usPerChunk;
+};
+
+// Before: vectors moved out each chunk (capture regrows from empty) and a
+// fresh output vector per chunk
+static Result RunVectors(int chunks, const Format& fm, const Format& fl) {
+    std::mutex micMutex, loopMutex;
+    std::vector<uint8_t> micBuffer, loopBuffer;
+    std::vector<float> packet(4096, 0.1f);
+    uint32_t seedM = 1, seedL = 2;
+    const int warmup = 2;
+    uint64_t warmupAllocs = 0, start = g_heapAllocs.load();
+    auto t0 = Clock::now();
+    for (int c = 0; c < chunks; c++) {
+        if (c == warmup) { warmupAllocs = g_heapAllocs.load() - start; start = g_heapAllocs.load(); t0 = Clock::now(); }
+        for (int p = 0; p < 200; p++) {
+            uint32_t f = NextPacketFrames(fm.rate, seedM);
+            std::lock_guard<std::mutex> lock(micMutex);
+            size_t at = micBuffer.size();
+            micBuffer.resize(at + f * fm.blockAlign);
+            memcpy(micBuffer.data() + at, packet.data(), f * fm.blockAlign);
+        }
+        for (int p = 0; p < 200; p++) {
+            uint32_t f = NextPacketFrames(fl.rate, seedL);
+            std::lock_guard<std::mutex> lock(loopMutex);
+            size_t at = loopBuffer.size();
+            loopBuffer.resize(at + f * fl.blockAlign);
+            memcpy(loopBuffer.data() + at, packet.data(), f * fl.blockAlign);
+        }
+        std::vector<uint8_t> micCopy, loopCopy;
+        { std::lock_guard<std::mutex> lock(micMutex); micCopy = std::move(micBuffer); micBuffer.clear(); }
+        { std::lock_guard<std::mutex> lock(loopMutex); loopCopy = std::move(loopBuffer); loopBuffer.clear(); }
+        size_t outFrames = micCopy.size() / fm.blockAlign * 48000 / fm.rate;
+        std::vector<uint8_t> output(outFrames * 2);
+        Mix(micCopy, loopCopy, fm, fl, 48000, (int16_t*)output.data(), outFrames);
+        g_written += output.size();
+    }
+    Result r;
+    r.warmupAllocs = warmupAllocs;
+    r.allocsPerChunk = (double)(g_heapAllocs.load() - start) / (chunks - warmup);
+    r.usPerChunk = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / (chunks - warmup);
+    return r;
+}
+
+// After: the recorder's pooled handoff (audio/WasapiRecorder.cpp)
+static Result RunPool(int chunks, const Format& fm, const Format& fl) {
+    BufferPool& pool = GetAudioBufferPool();
+    std::mutex micMutex, loopMutex;
+    BufferPool::Buffer micBuffer = pool.Acquire(0);
+    BufferPool::Buffer loopBuffer = pool.Acquire(0);
+    std::vector<float> packet(4096, 0.1f);
+    uint32_t seedM = 1, seedL = 2;
+    const int warmup = 2;
+    uint64_t warmupAllocs = 0, start = g_heapAllocs.load();
+    auto t0 = Clock::now();
+    for (int c = 0; c < chunks; c++) {
+        if (c == warmup) { warmupAllocs = g_heapAllocs.load() - start; start = g_heapAllocs.load(); t0 = Clock::now(); }
+        for (int p = 0; p < 200; p++) {
+            uint32_t f = NextPacketFrames(fm.rate, seedM);
+            std::lock_guard<std::mutex> lock(micMutex);
+            micBuffer.Append(packet.data(), f * fm.blockAlign);
+        }
+        for (int p = 0; p < 200; p++) {
+            uint32_t f = NextPacketFrames(fl.rate, seedL);
+            std::lock_guard<std::mutex> lock(loopMutex);
+            loopBuffer.Append(packet.data(), f * fl.blockAlign);
+        }
+        BufferPool::Buffer micCopy, loopCopy;
+        { std::lock_guard<std::mutex> lock(micMutex); micCopy = std::move(micBuffer); micBuffer = pool.Acquire(micCopy.capacity()); }
+        { std::lock_guard<std::mutex> lock(loopMutex); loopCopy = std::move(loopBuffer); loopBuffer = pool.Acquire(loopCopy.capacity()); }
+        size_t outFrames = micCopy.size() / fm.blockAlign * 48000 / fm.rate;
+        BufferPool::Buffer output = pool.Acquire(outFrames * 2);
+        output.resize(outFrames * 2);
+        Mix(micCopy, loopCopy, fm, fl, 48000, (int16_t*)output.data(), outFrames);
+        g_written += output.size();
+    }
+    Result r;
+    r.warmupAllocs = warmupAllocs;
+    r.allocsPerChunk = (double)(g_heapAllocs.load() - start) / (chunks - warmup);
+    r.usPerChunk = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / (chunks - warmup);
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int chunks = 300;     // 10 minutes of 2 s chunks
+    uint32_t micRate = 44100, loopRate = 48000;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--chunks") == 0 && hasValue) chunks = atoi(argv[++i]);
+        else if (strcmp(arg, "--mic-rate") == 0 && hasValue) micRate = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--loop-rate") == 0 && hasValue) loopRate = (uint32_t)atoi(argv[++i]);
+        else { PrintUsage(); return 2; }
+    }
+    if (chunks < 4 || micRate < 8000 || loopRate < 8000) { PrintUsage(); return 2; }
+
+    Format fm = {micRate, 8};
+    Format fl = {loopRate, 8};
+    printf("%d chunks of 2 s, mic %u Hz, loopback %u Hz (float stereo)\n\n", chunks, micRate, loopRate);
+
+    Result before = RunVectors(chunks, fm, fl);
+    Result after = RunPool(chunks, fm, fl);
+
+    printf("                     warm-up allocs   allocs/chunk   us/chunk\n");
+    printf("per-chunk vectors    %14llu   %12.2f   %8.0f\n", (unsigned long long)before.warmupAllocs, before.allocsPerChunk, before.usPerChunk);
+    printf("buffer pool          %14llu   %12.2f   %8.0f\n", (unsigned long long)after.warmupAllocs, after.allocsPerChunk, after.usPerChunk);
+
+    BufferPool::Stats stats = GetAudioBufferPool().GetStats();
+    printf("\npool: %s\n", stats.ToJson().c_str());
+
+    bool ok = after.allocsPerChunk == 0.0;
+    printf("\n%s\n", ok ? "PASS: no heap allocations in steady state" : "FAIL: pooled path still allocates");
+    return ok ? 0 : 1;
+}
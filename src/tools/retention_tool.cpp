@@ -0,0 +1,346 @@
+// MicMute-S retention tool
+//
+// Runs the retention engine against a recordings folder (dry run by
+// default), and self-tests its decisions on a synthetic archive of about
+// 100k recordings. No Win32 dependencies:
+//
+//   Windows: see build.bat (retention_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -pthread -I src -o retention_tool
+//              src/tools/retention_tool.cpp src/storage/retention.cpp src/storage/recording_catalog.cpp
+//              src/audio/WavMetadata.cpp src/audio/ImaAdpcm.cpp src/core/thread_pool.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: retention_tool <recordings folder> [--days N] [--max-gb G] [--min-free-gb G] [--delete]
+//        retention_tool --selftest [--files N]
+//        (exit code 1 if a check fails)
+
+#include "storage/retention.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: retention_tool <recordings folder> [--days N] [--max-gb G] [--min-free-gb G] [--delete]\n");
+    printf("       retention_tool --selftest [--files N]\n");
+}
+
+static const char* ReasonText(RetentionReason r) {
+    switch (r) {
+        case RetentionReason::Age:       return "age";
+        case RetentionReason::Budget:    return "budget";
+        case RetentionReason::FreeSpace: return "free space";
+    }
+    return "?";
+}
+
+static double Seconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+// ---------------------------------------------------------------------------
+// Self test
+// ---------------------------------------------------------------------------
+
+static const int FOLDERS = 200;       // Date folders 1..200 days old
+static const int HELD_FOLDER = 195;   // Has a folder-level .hold
+static const int HELD_FILE_FOLDER = 193;
+
+struct SynthRecording {
+    std::string wavPath;
+    uint64_t bytes = 0;               // Including the .meta companion
+    int daysOld = 0;
+    int mtimeRank = 0;                // Order of file times within the folder
+    bool held = false;
+};
+
+static std::string FolderName(time_t t) {
+    struct tm tmLocal = *localtime(&t);
+    char buf[16];
+    strftime(buf, sizeof(buf), "%Y-%m-%d", &tmLocal);
+    return buf;
+}
+
+static bool MakeFile(const fs::path& path, uint64_t size) {
+    { std::ofstream f(path, std::ios::binary | std::ios::trunc); if (!f) return false; }
+    std::error_code ec;
+    fs::resize_file(path, size, ec);  // Sparse: sizes matter, contents don't
+    return !ec;
+}
+
+// Oldest first, the order Plan must consider recordings in
+static bool OlderFirst(const SynthRecording& a, const SynthRecording& b) {
+    if (a.daysOld != b.daysOld) return a.daysOld > b.daysOld;
+    return a.mtimeRank < b.mtimeRank;
+}
+
+static std::vector<std::string> ActionPaths(const RetentionReport& report) {
+    std::vector<std::string> paths;
+    for (const auto& a : report.actions) paths.push_back(a.wavPath);
+    return paths;
+}
+
+// The quota walks: everything in order is marked until the kept bytes (or
+// free space) satisfy the limit; held recordings are marked but free nothing
+static std::vector<std::string> ExpectedBudget(const std::vector<SynthRecording>& ordered, uint64_t total, uint64_t budget) {
+    std::vector<std::string> out;
+    uint64_t reclaim = 0;
+    for (const auto& r : ordered) {
+        if (total - reclaim <= budget) break;
+        out.push_back(r.wavPath);
+        if (!r.held) reclaim += r.bytes;
+    }
+    return out;
+}
+
+static int SelfTest(size_t files) {
+    fs::path root = fs::temp_directory_path() / "retention_tool_selftest";
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    fs::create_directories(root, ec);
+
+    // Noon today: whole-day ages stay exact across DST changes
+    time_t wall = std::time(nullptr);
+    struct tm tmNoon = *localtime(&wall);
+    tmNoon.tm_hour = 12;
+    tmNoon.tm_min = tmNoon.tm_sec = 0;
+    time_t now = mktime(&tmNoon);
+    const std::string today = FolderName(now);
+
+    const size_t perFolder = std::max<size_t>(1, files / FOLDERS);
+    printf("Synthetic archive: %d date folders x %zu recordings in %s\n", FOLDERS, perFolder, root.string().c_str());
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<SynthRecording> recordings;
+    uint64_t total = 0;
+    bool created = true;
+    auto fileNow = fs::file_time_type::clock::now();
+    for (int d = 1; d <= FOLDERS && created; d++) {
+        fs::path folder = root / FolderName(now - (time_t)d * 24 * 60 * 60);
+        fs::create_directories(folder, ec);
+        if (d == HELD_FOLDER) created = MakeFile(folder / ".hold", 0) && created;
+        for (size_t i = 0; i < perFolder && created; i++) {
+            char name[32];
+            snprintf(name, sizeof(name), "call_%05zu", i);
+            SynthRecording r;
+            r.wavPath = (folder / (std::string(name) + ".wav")).string();
+            r.daysOld = d;
+            // File times run against name order, so sorting by name would be wrong
+            r.mtimeRank = (int)((i * 37) % perFolder);
+            r.bytes = 2000 + (i * 7919) % 500000;
+            created = MakeFile(r.wavPath, r.bytes) && created;
+            fs::last_write_time(r.wavPath, fileNow - std::chrono::hours(24 * d) + std::chrono::seconds(r.mtimeRank), ec);
+            if (i % 4 == 0) {
+                created = MakeFile(folder / (std::string(name) + ".meta"), 120) && created;
+                r.bytes += 120;
+            }
+            r.held = d == HELD_FOLDER || (d == HELD_FILE_FOLDER && i == 3);
+            if (d == HELD_FILE_FOLDER && i == 3) created = MakeFile(folder / (std::string(name) + ".hold"), 0) && created;
+            total += r.bytes;
+            recordings.push_back(r);
+        }
+    }
+    // Today's folder, including an in-progress temp file
+    fs::create_directories(root / today, ec);
+    for (int i = 0; i < 20 && created; i++) {
+        created = MakeFile(root / today / ("call_today_" + std::to_string(i) + ".wav"), 100000);
+    }
+    created = created && MakeFile(root / today / "~recording_1.wav.tmp", 100000);
+    Check(created, "archive created");
+    printf("       %zu recordings, %.1f GB, built in %.1f s\n", recordings.size(), total / 1e9,
+           Seconds(std::chrono::steady_clock::now() - t0));
+
+    std::vector<SynthRecording> ordered = recordings;
+    std::sort(ordered.begin(), ordered.end(), OlderFirst);
+    std::vector<std::string> allOrdered;
+    for (const auto& r : ordered) allOrdered.push_back(r.wavPath);
+
+    printf("\nAge\n");
+    {
+        RetentionPolicy policy;
+        policy.maxAgeDays = 90;
+        t0 = std::chrono::steady_clock::now();
+        RetentionReport report = RetentionEngine::Plan(root.string(), policy, now);
+        printf("       planned in %.2f s\n", Seconds(std::chrono::steady_clock::now() - t0));
+        std::vector<std::string> expected;
+        uint64_t held = 0;
+        for (const auto& r : ordered) {
+            if (r.daysOld <= 90) continue;
+            expected.push_back(r.wavPath);
+            if (r.held) held++;
+        }
+        Check(report.filesScanned == recordings.size() && report.bytesScanned == total,
+              "every recording but today's scanned, companions counted");
+        Check(ActionPaths(report) == expected, "folders older than 90 days, oldest first, file time within a day");
+        bool allAge = true;
+        for (const auto& a : report.actions) allAge = allAge && a.reason == RetentionReason::Age;
+        Check(allAge, "all marked for age");
+        Check(report.filesHeld == held && held == perFolder + 1, "folder and file holds reported as held");
+        bool heldNotCounted = report.filesToDelete + report.filesHeld == expected.size();
+        Check(heldNotCounted, "held recordings not counted for deletion");
+        bool companions = true;
+        for (const auto& a : report.actions) {
+            bool hasMeta = a.wavPath.find("call_") != std::string::npos &&
+                           atoi(a.wavPath.c_str() + a.wavPath.rfind("call_") + 5) % 4 == 0;
+            companions = companions && a.companions.size() == (hasMeta ? 1u : 0u);
+        }
+        Check(companions, ".meta companions go with their recording");
+    }
+
+    printf("\nByte budget\n");
+    {
+        RetentionPolicy policy;
+        policy.maxTotalBytes = total / 2;
+        RetentionReport report = RetentionEngine::Plan(root.string(), policy, now);
+        std::vector<std::string> expected = ExpectedBudget(ordered, total, policy.maxTotalBytes);
+        Check(ActionPaths(report) == expected, "oldest recordings marked until under budget");
+        Check(total - report.bytesToDelete <= policy.maxTotalBytes, "kept bytes within the budget");
+        uint64_t lastBytes = 0;
+        for (auto it = report.actions.rbegin(); it != report.actions.rend(); ++it) {
+            if (!it->held) { lastBytes = it->bytes; break; }
+        }
+        Check(total - report.bytesToDelete + lastBytes > policy.maxTotalBytes, "no more than needed (newest kept)");
+        bool reasons = true;
+        for (const auto& a : report.actions) reasons = reasons && a.reason == RetentionReason::Budget;
+        Check(reasons, "all marked for budget");
+    }
+
+    printf("\nFree space\n");
+    {
+        RetentionPolicy policy;
+        const uint64_t free = 10ull * 1000 * 1000 * 1000;
+        policy.minFreeBytes = free + total / 4;
+        RetentionReport report = RetentionEngine::Plan(root.string(), policy, now, free);
+        uint64_t need = total / 4, reclaim = 0;
+        std::vector<std::string> expected;
+        for (const auto& r : ordered) {
+            if (reclaim >= need) break;
+            expected.push_back(r.wavPath);
+            if (!r.held) reclaim += r.bytes;
+        }
+        Check(report.freeBytes == free, "free space override used");
+        Check(ActionPaths(report) == expected && report.bytesToDelete >= need, "oldest recordings freed to the floor");
+    }
+
+    printf("\nCombined quotas\n");
+    {
+        RetentionPolicy policy;
+        policy.maxAgeDays = 180;
+        policy.maxTotalBytes = total / 3;
+        RetentionReport report = RetentionEngine::Plan(root.string(), policy, now);
+        size_t age = 0, budget = 0;
+        bool order = true;
+        for (const auto& a : report.actions) {
+            if (a.reason == RetentionReason::Age) {
+                order = order && budget == 0;
+                age++;
+            } else {
+                budget++;
+            }
+        }
+        Check(age == 20 * perFolder && budget > 0 && order, "age first, then budget on what is left");
+        Check(ActionPaths(report) == ExpectedBudget(ordered, total, policy.maxTotalBytes), "same oldest-first walk");
+    }
+
+    printf("\nToday\n");
+    {
+        RetentionPolicy policy;
+        policy.maxTotalBytes = 1;
+        policy.maxAgeDays = 1;
+        RetentionReport report = RetentionEngine::Plan(root.string(), policy, now);
+        bool todayUntouched = true;
+        for (const auto& a : report.actions) todayUntouched = todayUntouched && a.wavPath.find(today) == std::string::npos;
+        Check(ActionPaths(report) == allOrdered, "everything else marked at a 1-byte budget");
+        Check(todayUntouched, "today's folder never marked");
+    }
+
+    printf("\nDelete\n");
+    {
+        RetentionPolicy policy;
+        policy.maxAgeDays = 190;
+        policy.maxDeletesPerSecond = 0;
+        RetentionEngine engine;
+        t0 = std::chrono::steady_clock::now();
+        RetentionReport report = engine.Run(root.string(), policy);
+        printf("       %llu recordings deleted in %.2f s\n", (unsigned long long)report.filesDeleted,
+               Seconds(std::chrono::steady_clock::now() - t0));
+        bool folders = true;
+        for (int d = 191; d <= FOLDERS; d++) {
+            bool exists = fs::exists(root / FolderName(now - (time_t)d * 24 * 60 * 60), ec);
+            folders = folders && exists == (d == HELD_FOLDER || d == HELD_FILE_FOLDER);
+        }
+        Check(report.errors == 0 && report.filesDeleted == 9 * perFolder - 1, "recordings past 190 days deleted");
+        Check(folders, "emptied date folders removed, folders with holds kept");
+        size_t heldLeft = 0;
+        for (const auto& r : recordings) {
+            if (r.held && r.daysOld > 190) heldLeft += fs::exists(r.wavPath, ec) ? 1 : 0;
+        }
+        Check(heldLeft == perFolder + 1, "held recordings still on disk");
+        Check(fs::exists(root / today / "~recording_1.wav.tmp", ec), "in-progress recording untouched");
+    }
+
+    fs::remove_all(root, ec);
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    RetentionPolicy policy;
+    policy.maxDeletesPerSecond = 0;
+    std::string root;
+    bool selftest = false, execute = false;
+    size_t files = 100000;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--days") == 0 && hasValue)             policy.maxAgeDays = atoi(argv[++i]);
+        else if (strcmp(arg, "--max-gb") == 0 && hasValue)      policy.maxTotalBytes = (uint64_t)(atof(argv[++i]) * 1e9);
+        else if (strcmp(arg, "--min-free-gb") == 0 && hasValue) policy.minFreeBytes = (uint64_t)(atof(argv[++i]) * 1e9);
+        else if (strcmp(arg, "--files") == 0 && hasValue)       files = (size_t)atol(argv[++i]);
+        else if (strcmp(arg, "--delete") == 0)                  execute = true;
+        else if (strcmp(arg, "--selftest") == 0)                selftest = true;
+        else if (arg[0] != '-' && root.empty())                 root = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    if (selftest) return SelfTest(std::max<size_t>(files, FOLDERS));
+    if (root.empty() || !policy.IsEnabled()) { PrintUsage(); return 2; }
+
+    RetentionReport report;
+    if (execute) {
+        RetentionEngine engine;
+        report = engine.Run(root, policy);
+    } else {
+        report = RetentionEngine::Plan(root, policy, std::time(nullptr));
+    }
+
+    for (const auto& a : report.actions) {
+        printf("%s %-10s %s  %llu bytes\n", a.held ? "HOLD" : (execute ? "DEL " : "plan"), ReasonText(a.reason),
+               a.wavPath.c_str(), (unsigned long long)a.bytes);
+    }
+    printf("\n%llu recordings scanned (%.1f GB), %.1f GB free\n", (unsigned long long)report.filesScanned,
+           report.bytesScanned / 1e9, report.freeBytes / 1e9);
+    if (execute) {
+        printf("%llu deleted (%.1f GB), %llu held, %llu errors\n", (unsigned long long)report.filesDeleted,
+               report.bytesDeleted / 1e9, (unsigned long long)report.filesHeld, (unsigned long long)report.errors);
+    } else {
+        printf("%llu to delete (%.1f GB), %llu held (dry run, add --delete)\n", (unsigned long long)report.filesToDelete,
+               report.bytesToDelete / 1e9, (unsigned long long)report.filesHeld);
+    }
+    return report.errors ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+// MicMute-S frame scheduler simulation
+//
+// Drives FrameScheduler with a virtual clock: checks its decisions
+// (coalescing, idle animations, no wakeups when idle, no catch-up bursts)
+// and compares wakeups per minute with the separate Win32 timers it
+// replaced, for the usual desktop states. No Win32 dependencies:
+//
+//   Windows: see build.bat (scheduler_sim.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o scheduler_sim
+//              src/tools/scheduler_sim.cpp src/core/frame_scheduler.cpp
+//
+// Usage: scheduler_sim [--minutes N]
+//        (exit code 1 if a check fails)
+
+#include "core/frame_scheduler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: scheduler_sim [--minutes N]\n");
+}
+
+// Virtual event loop: sleep until the next wakeup, run what is due.
+// The timer fires `latenessMs` after the requested time, like a loaded box.
+static void RunUntil(FrameScheduler& s, uint64_t& now, uint64_t endMs, uint64_t latenessMs = 0) {
+    for (;;) {
+        uint64_t next = s.GetNextWakeup();
+        if (next == FrameScheduler::NEVER || next + latenessMs > endMs) break;
+        now = next + latenessMs > now ? next + latenessMs : now;
+        s.RunDue(now);
+    }
+    now = endMs;
+}
+
+static void TestIdle() {
+    printf("idle\n");
+    FrameScheduler s;
+    uint64_t now = 0;
+    FrameScheduler::TaskId meter = s.AddTask("meter", 50, 10, [] { return true; });
+    Check(s.GetNextWakeup() == FrameScheduler::NEVER, "nothing active: no wakeup at all");
+    s.SetActive(meter, true, now);
+    s.SetActive(meter, false, now);
+    RunUntil(s, now, 60000);
+    Check(s.GetStats().wakeups == 0 && s.GetStats().spurious == 0, "deactivated task never runs");
+}
+
+static void TestPeriod() {
+    printf("single task\n");
+    FrameScheduler s;
+    uint64_t now = 0;
+    FrameScheduler::TaskId meter = s.AddTask("meter", 50, 0, [] { return true; });
+    s.SetActive(meter, true, now);
+    RunUntil(s, now, 10000);
+    Check(s.GetTaskRuns(meter) == 200, "50 ms task runs 200 times in 10 s");
+
+    // Re-activating an active task keeps its cadence
+    uint64_t due = s.GetNextWakeup();
+    s.SetActive(meter, true, now + 20);
+    Check(s.GetNextWakeup() == due, "activate while active keeps the schedule");
+
+    s.SetActive(meter, true, now, true);
+    Check(s.GetNextWakeup() == now, "runNow pulls the deadline in");
+}
+
+static void TestCoalescing() {
+    printf("coalescing\n");
+    FrameScheduler s;
+    uint64_t now = 0;
+    std::vector<uint64_t> slowRuns;
+    FrameScheduler::TaskId meter = s.AddTask("meter", 50, 10, [] { return true; });
+    FrameScheduler::TaskId player = s.AddTask("player", 80, 30, [] { return true; });
+    FrameScheduler::TaskId house = s.AddTask("housekeeping", 2000, 1000, [&] { slowRuns.push_back(now); return true; });
+    s.SetActive(meter, true, now);
+    s.SetActive(player, true, now);
+    s.SetActive(house, true, now);
+    RunUntil(s, now, 60000);
+
+    uint64_t separate = 60000 / 50 + 60000 / 80 + 60000 / 2000;
+    printf("  wakeups: %llu coalesced vs %llu separate timers\n",
+           (unsigned long long)s.GetStats().wakeups, (unsigned long long)separate);
+    Check(s.GetStats().wakeups == s.GetTaskRuns(meter), "slow tasks ride along with the meter tick");
+    Check(s.GetTaskRuns(house) == 30, "2 s task still runs 30 times a minute");
+    Check(s.GetTaskRuns(player) >= 60000 / 80, "80 ms task keeps at least its rate");
+
+    bool late = false;
+    for (size_t i = 0; i < slowRuns.size(); i++) {
+        if (slowRuns[i] > (i + 1) * 2000) late = true;
+    }
+    Check(!late, "no task runs after its deadline");
+}
+
+static void TestAnimation() {
+    printf("animation\n");
+    FrameScheduler s;
+    uint64_t now = 0;
+    int frames = 0;
+    FrameScheduler::TaskId anim = s.AddTask("overlay", 16, 0, [&] { return ++frames < 7; });
+    s.SetActive(anim, true, now, true);
+    RunUntil(s, now, 10000);
+    Check(frames == 7, "animation runs until it settles");
+    Check(!s.IsActive(anim) && s.GetNextWakeup() == FrameScheduler::NEVER, "then stops waking the CPU");
+
+    s.SetActive(anim, true, now);
+    Check(s.GetNextWakeup() == now + 16, "re-triggered animation starts one frame later");
+}
+
+static void TestLateWakeup() {
+    printf("late wakeup\n");
+    FrameScheduler s;
+    uint64_t now = 0;
+    FrameScheduler::TaskId meter = s.AddTask("meter", 50, 0, [] { return true; });
+    s.SetActive(meter, true, now);
+    // Machine resumes from sleep 10 s later
+    now = 10000;
+    size_t ran = s.RunDue(now);
+    Check(ran == 1, "one run after a long stall");
+    Check(s.GetNextWakeup() == now + 50, "rescheduled from now, no burst of missed ticks");
+
+    // A timer that always fires 15 ms late (default Windows resolution)
+    FrameScheduler t;
+    uint64_t clock = 0;
+    FrameScheduler::TaskId m = t.AddTask("meter", 50, 0, [] { return true; });
+    t.SetActive(m, true, clock);
+    RunUntil(t, clock, 10000, 15);
+    Check(t.GetTaskRuns(m) >= 195, "late timer keeps the average rate");
+}
+
+static void TestReentrancy() {
+    printf("reentrancy\n");
+    FrameScheduler s;
+    uint64_t now = 0;
+    FrameScheduler::TaskId second = 0;
+    int secondRuns = 0;
+    FrameScheduler::TaskId first = s.AddTask("first", 100, 0, [&] {
+        s.SetActive(second, true, now, true);
+        return false;
+    });
+    second = s.AddTask("second", 100, 0, [&] { secondRuns++; return false; });
+    s.SetActive(first, true, now);
+    RunUntil(s, now, 1000);
+    Check(secondRuns == 1, "task activated from a callback runs in the same wakeup");
+    Check(s.GetStats().wakeups == 1, "both in one wakeup");
+}
+
+// Wakeups per minute: the old fixed timers vs the scheduler, per state.
+// The tasks and conditions mirror the ones registered in ui/ui.cpp.
+struct DesktopState {
+    const char* name;
+    bool panelVisible;
+    bool playerPlaying;
+    bool autoRecord;
+    bool recording;
+};
+
+static void CompareStates(double minutes) {
+    const uint64_t endMs = (uint64_t)(minutes * 60000.0);
+    const DesktopState states[] = {
+        {"hidden, auto-record idle", false, false, true, false},
+        {"hidden, recording a call", false, false, true, true},
+        {"control panel visible", true, false, true, false},
+        {"panel + player playing", true, true, true, false},
+    };
+
+    printf("\nwakeups per minute        old timers   scheduler\n");
+    for (const DesktopState& st : states) {
+        // Old: 50 ms + 2 s on the main window always, 80 ms while the player exists
+        double old = 60000.0 / 50 + 60000.0 / 2000 + (st.playerPlaying ? 60000.0 / 80 : 0.0);
+
+        FrameScheduler s;
+        uint64_t now = 0;
+        FrameScheduler::TaskId meter = s.AddTask("meter", 50, 10, [] { return true; });
+        FrameScheduler::TaskId calls = s.AddTask("calls", 250, 100, [] { return true; });
+        FrameScheduler::TaskId state = s.AddTask("ui-state", 2000, 1000, [] { return true; });
+        FrameScheduler::TaskId player = s.AddTask("player", 80, 30, [] { return true; });
+        s.SetActive(meter, st.panelVisible, now);
+        s.SetActive(state, st.panelVisible, now);
+        s.SetActive(player, st.playerPlaying, now);
+        // Not recording: only the midnight date rollover, at most once per run here
+        if (st.autoRecord) {
+            if (!st.recording) s.SetPeriod(calls, (uint32_t)(endMs + 1));
+            s.SetActive(calls, true, now);
+        }
+        RunUntil(s, now, endMs);
+        printf("%-26s %10.0f  %10.1f\n", st.name, old, s.GetStats().wakeups / minutes);
+    }
+}
+
+int main(int argc, char** argv) {
+    double minutes = 10.0;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--minutes") == 0 && hasValue) minutes = atof(argv[++i]);
+        else { PrintUsage(); return 2; }
+    }
+    if (minutes <= 0.0) { PrintUsage(); return 2; }
+
+    TestIdle();
+    TestPeriod();
+    TestCoalescing();
+    TestAnimation();
+    TestLateWakeup();
+    TestReentrancy();
+    CompareStates(minutes);
+
+    printf("\n%s\n", g_failures ? "FAIL" : "PASS");
+    return g_failures ? 1 : 0;
+}
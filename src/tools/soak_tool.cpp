@@ -0,0 +1,249 @@
+// MicMute-S soak tool
+//
+// Drives a running recorder - usually MicMute-S-service.exe with the
+// synthetic or file capture backend - through the local HTTP API the way
+// the browser extension does: back-to-back calls of /start, heartbeats and
+// /stop, for a number of calls or minutes. Reports the client-side latency
+// of /start and /stop, checks that every call reached "recording" and that
+// every recording was finalized at the end, and prints the recorder's
+// handoff and capture metrics. No Win32 dependencies:
+//
+//   Windows: see build.bat (soak_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -o soak_tool src/tools/soak_tool.cpp
+//
+// Usage: soak_tool [--calls N | --minutes M] [--call-ms MS] [--gap-ms MS]
+//                  [--port P] [--shutdown]
+//        (exit code 1 if a request fails or recordings are left unsaved)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET SocketHandle;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int SocketHandle;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static const int IO_TIMEOUT_MS = 10000;
+static const int HEARTBEAT_MS = 1000;       // The extension pings about this often
+static const int DRAIN_TIMEOUT_MS = 120000;
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: soak_tool [--calls N | --minutes M] [--call-ms MS] [--gap-ms MS]\n");
+    printf("                 [--port P] [--shutdown]\n");
+}
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void SleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// One POST on its own connection (the recorder closes after each reply)
+static bool Post(int port, const char* path, const std::string& body, std::string& response) {
+    response.clear();
+    SocketHandle s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET) return false;
+#ifdef _WIN32
+    DWORD ms = IO_TIMEOUT_MS;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&ms, sizeof(ms));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char*)&ms, sizeof(ms));
+#else
+    timeval tv;
+    tv.tv_sec = IO_TIMEOUT_MS / 1000;
+    tv.tv_usec = 0;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#endif
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(s, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        closesocket(s);
+        return false;
+    }
+
+    char header[256];
+    snprintf(header, sizeof(header),
+             "POST %s HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\n"
+             "Content-Length: %zu\r\nConnection: close\r\n\r\n", path, body.size());
+    std::string request = header + body;
+    bool ok = send(s, request.data(), (int)request.size(), 0) == (int)request.size();
+
+    std::string reply;
+    char buf[8192];
+    int n;
+    while (ok && (n = (int)recv(s, buf, sizeof(buf), 0)) > 0) reply.append(buf, (size_t)n);
+    closesocket(s);
+
+    // 200s only; the body after the header
+    size_t space = reply.find(' ');
+    size_t bodyStart = reply.find("\r\n\r\n");
+    if (!ok || space == std::string::npos || reply.compare(space + 1, 3, "200") != 0 || bodyStart == std::string::npos) return false;
+    response = reply.substr(bodyStart + 4);
+    return true;
+}
+
+// Raw value of "key" in a flat JSON object (strings without their quotes)
+static std::string JsonField(const std::string& json, const char* key) {
+    std::string needle = std::string("\"") + key + "\":";
+    size_t pos = json.find(needle);
+    if (pos == std::string::npos) return "";
+    pos += needle.size();
+    if (pos < json.size() && json[pos] == '"') {
+        size_t end = json.find('"', pos + 1);
+        return end == std::string::npos ? "" : json.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = json.find_first_of(",}", pos);
+    return json.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+// Nested object "key" as JSON text
+static std::string JsonObject(const std::string& json, const char* key) {
+    std::string needle = std::string("\"") + key + "\":";
+    size_t pos = json.find(needle);
+    if (pos == std::string::npos) return "null";
+    pos += needle.size();
+    if (pos >= json.size() || json[pos] != '{') return JsonField(json, key);
+    int depth = 0;
+    for (size_t i = pos; i < json.size(); i++) {
+        if (json[i] == '{') depth++;
+        else if (json[i] == '}' && --depth == 0) return json.substr(pos, i - pos + 1);
+    }
+    return "null";
+}
+
+static void PrintLatency(const char* what, std::vector<double> ms) {
+    if (ms.empty()) return;
+    std::sort(ms.begin(), ms.end());
+    printf("  %-6s p50 %7.2f ms   p95 %7.2f ms   max %7.2f ms   (%zu requests)\n", what,
+           ms[ms.size() / 2], ms[std::min(ms.size() - 1, ms.size() * 95 / 100)], ms.back(), ms.size());
+}
+
+int main(int argc, char** argv) {
+    int calls = 20, minutes = 0, callMs = 11000, gapMs = 200, port = 9876;
+    bool shutdown = false;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--calls") == 0 && hasValue) calls = atoi(argv[++i]);
+        else if (strcmp(arg, "--minutes") == 0 && hasValue) minutes = atoi(argv[++i]);
+        else if (strcmp(arg, "--call-ms") == 0 && hasValue) callMs = atoi(argv[++i]);
+        else if (strcmp(arg, "--gap-ms") == 0 && hasValue) gapMs = atoi(argv[++i]);
+        else if (strcmp(arg, "--port") == 0 && hasValue) port = atoi(argv[++i]);
+        else if (strcmp(arg, "--shutdown") == 0) shutdown = true;
+        else { PrintUsage(); return 2; }
+    }
+    if (calls < 1) calls = 1;
+    if (callMs < 0) callMs = 0;
+    if (gapMs < 0) gapMs = 0;
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return 1;
+#endif
+
+    std::string response;
+    if (!Post(port, "/status", "", response)) {
+        fprintf(stderr, "No recorder answering on 127.0.0.1:%d\n", port);
+        return 1;
+    }
+    if (minutes > 0) printf("Soak: back-to-back calls of %d ms for %d min\n", callMs, minutes);
+    else printf("Load: %d back-to-back calls of %d ms\n", calls, callMs);
+
+    std::vector<double> startMs, stopMs;
+    int failedRequests = 0, notRecording = 0, made = 0;
+    Clock::time_point begin = Clock::now();
+    for (;;) {
+        if (minutes > 0 ? MsSince(begin) >= minutes * 60000.0 : made >= calls) break;
+        made++;
+
+        char body[160];
+        snprintf(body, sizeof(body), "{\"source\":\"soak_tool\",\"metadata\":{\"callId\":\"soak-%d\",\"agent\":\"soak_tool\"}}", made);
+
+        Clock::time_point t = Clock::now();
+        if (Post(port, "/start", body, response)) startMs.push_back(MsSince(t));
+        else failedRequests++;
+        if (!Post(port, "/status", "", response)) failedRequests++;
+        else if (JsonField(response, "status") != "recording") notRecording++;
+
+        // Heartbeats through the call, or the recorder saves it early as
+        // if the browser tab had closed
+        Clock::time_point callStart = Clock::now();
+        while (MsSince(callStart) < callMs) {
+            SleepMs((int)std::min<double>(HEARTBEAT_MS, callMs - MsSince(callStart) + 1));
+            if (MsSince(callStart) < callMs && !Post(port, "/ping", "", response)) failedRequests++;
+        }
+
+        t = Clock::now();
+        if (Post(port, "/stop", body, response)) stopMs.push_back(MsSince(t));
+        else failedRequests++;
+
+        if (made % 10 == 0) {
+            Post(port, "/status", "", response);
+            printf("  call %d: saving %s\n", made, JsonField(response, "saving").c_str());
+        }
+        SleepMs(gapMs);
+    }
+
+    // Everything stopped must reach the disk
+    bool drained = false;
+    Clock::time_point drainStart = Clock::now();
+    while (MsSince(drainStart) < DRAIN_TIMEOUT_MS) {
+        if (Post(port, "/status", "", response) && JsonField(response, "saving") == "0") {
+            drained = true;
+            break;
+        }
+        SleepMs(100);
+    }
+
+    printf("\n%d calls in %.1f s\n", made, MsSince(begin) / 1000.0);
+    PrintLatency("/start", startMs);
+    PrintLatency("/stop", stopMs);
+    if (Post(port, "/metrics", "", response)) {
+        printf("  handoff %s\n", JsonObject(response, "handoff").c_str());
+        printf("  capture %s\n", JsonObject(response, "capture").c_str());
+    }
+
+    printf("\n");
+    Check(failedRequests == 0, "every request answered 200");
+    Check(notRecording == 0, "every call reached \"recording\" (AutoRecordCalls on)");
+    Check(drained, "every recording finalized");
+
+    if (shutdown) Check(Post(port, "/shutdown", "", response), "recorder shut down");
+
+    printf("\n%s\n", g_failures ? "FAIL" : "PASS");
+    return g_failures ? 1 : 0;
+}
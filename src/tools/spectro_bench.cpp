@@ -0,0 +1,164 @@
+// MicMute-S spectrogram benchmark
+//
+// Measures the FFT and the spectrogram tile builder: FFTs per second, tiles
+// per second per zoom level on one thread and on the background pool, and
+// (for a real recording) the cold/warm path through the .spec sidecar.
+// No Win32 dependencies:
+//
+//   Windows: see build.bat (spectro_bench.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -pthread -o spectro_bench
+//              src/tools/spectro_bench.cpp src/audio/Spectrogram.cpp src/audio/Fft.cpp
+//              src/core/thread_pool.cpp src/audio/WavDecoder.cpp src/audio/MappedWavReader.cpp
+//              src/core/mapped_file.cpp src/audio/WavMetadata.cpp src/audio/ImaAdpcm.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: spectro_bench [recording.wav] [--threads N] [--seconds N]
+//        (seconds = length of the synthetic signal when no file is given)
+
+#include "audio/Spectrogram.h"
+#include "core/thread_pool.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage() {
+    printf("Usage: spectro_bench [recording.wav] [--threads N] [--seconds N]\n");
+}
+
+static double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Voice-like buzz plus line noise at 16 kHz, like a narrowband call
+static std::vector<float> Synthesize(uint32_t rate, double seconds) {
+    std::vector<float> out((size_t)(rate * seconds));
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.002f);
+    const double pi = 3.14159265358979323846;
+    double phase = 0.0;
+    for (size_t i = 0; i < out.size(); i++) {
+        double t = (double)i / rate;
+        phase += (130.0 + 30.0 * std::sin(2.0 * pi * 0.4 * t)) / rate;
+        double s = 0.0;
+        for (int h = 1; h <= 16; h++) s += std::sin(2.0 * pi * h * phase) / h;
+        out[i] = (float)(0.2 * s * (0.5 + 0.5 * std::sin(2.0 * pi * 3.5 * t))) + noise(rng);
+    }
+    return out;
+}
+
+int main(int argc, char** argv) {
+    std::string path;
+    size_t threads = 0;
+    double seconds = 600.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--threads") == 0 && hasValue)      threads = (size_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--seconds") == 0 && hasValue) seconds = atof(argv[++i]);
+        else if (arg[0] != '-' && path.empty())             path = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    // FFT alone
+    {
+        RealFft fft;
+        fft.Configure(SpectrogramCache::FFT_SIZE);
+        std::vector<float> in(SpectrogramCache::FFT_SIZE), power(SpectrogramCache::FFT_SIZE / 2 + 1);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> uni(-1.0f, 1.0f);
+        for (float& v : in) v = uni(rng);
+        const int count = 200000;
+        volatile float sink = 0.0f;     // Keeps the loop from being optimised away
+        Clock::time_point t = Clock::now();
+        for (int i = 0; i < count; i++) {
+            in[i & 511] += 1e-6f;
+            fft.Power(in.data(), power.data());
+            sink += power[i & 255];
+        }
+        double ms = ElapsedMs(t);
+        printf("fft %zu-point real: %.2f us each, %.0f per second\n\n",
+               SpectrogramCache::FFT_SIZE, ms * 1000.0 / count, count / ms * 1000.0);
+    }
+
+    SpectrogramSource source;
+    std::vector<float> synthetic;
+    if (!path.empty()) {
+        if (!source.Open(path)) { printf("Cannot decode %s\n", path.c_str()); return 1; }
+        printf("%s: %.1f s at %u Hz\n", path.c_str(), (double)source.GetTotalFrames() / source.GetSampleRate(),
+               source.GetSampleRate());
+    } else {
+        synthetic = Synthesize(16000, seconds);
+        source.Attach(synthetic.data(), synthetic.size(), 16000);
+        printf("synthetic: %.0f s at 16000 Hz\n", seconds);
+    }
+    const uint64_t totalFrames = source.GetTotalFrames();
+    if (totalFrames == 0) return 1;
+
+    ThreadPool pool(threads, false);
+    printf("pool: %zu threads\n\n", pool.GetThreadCount());
+    printf("level  s/tile   tiles   1 thread tiles/s   pool tiles/s   whole file, pool\n");
+
+    for (uint32_t level = 0; level < SpectrogramCache::LEVELS; level++) {
+        uint64_t framesPerTile = SpectrogramCache::GetFramesPerColumn(level) * SpectrogramCache::TILE_COLUMNS;
+        uint64_t tiles = (totalFrames + framesPerTile - 1) / framesPerTile;
+
+        // One thread, up to 64 tiles
+        uint64_t single = std::min<uint64_t>(tiles, 64);
+        RealFft fft;
+        std::vector<float> scratch;
+        std::vector<uint8_t> tile(SpectrogramCache::TILE_BYTES);
+        Clock::time_point t = Clock::now();
+        for (uint64_t i = 0; i < single; i++) {
+            SpectrogramCache::ComputeTile(source, fft, scratch, level, i, tile.data());
+        }
+        double singleMs = ElapsedMs(t);
+
+        // Every tile of the level on the pool
+        t = Clock::now();
+        for (uint64_t i = 0; i < tiles; i++) {
+            pool.Submit([&source, level, i]() {
+                thread_local RealFft localFft;
+                thread_local std::vector<float> localScratch;
+                thread_local std::vector<uint8_t> out(SpectrogramCache::TILE_BYTES);
+                SpectrogramCache::ComputeTile(source, localFft, localScratch, level, i, out.data());
+            });
+        }
+        pool.WaitIdle();
+        double poolMs = ElapsedMs(t);
+
+        printf("%5u  %6.2f  %6llu  %17.1f  %13.1f  %12.0f ms\n", level,
+               (double)framesPerTile / source.GetSampleRate(), (unsigned long long)tiles,
+               single / singleMs * 1000.0, tiles / poolMs * 1000.0, poolMs);
+    }
+
+    // End to end through the cache and its sidecar
+    if (!path.empty()) {
+        const uint32_t level = 2;
+        std::remove(SpectrogramCache::GetSidecarPath(path).c_str());
+        for (int pass = 0; pass < 2; pass++) {
+            SpectrogramCache cache;
+            if (!cache.Open(path, pool)) return 1;
+            uint64_t tiles = cache.GetTileCount(level);
+            std::atomic<uint64_t> ready{0};
+            cache.SetReadyCallback([&ready]() { ready++; });
+            Clock::time_point t = Clock::now();
+            for (uint64_t i = 0; i < tiles; i++) cache.GetTile(level, i);
+            pool.WaitIdle();
+            double ms = ElapsedMs(t);
+            printf("\ncache, level %u, %s: %llu tiles in %.0f ms (%.0f tiles/s)", level,
+                   pass == 0 ? "computed + written" : "read from .spec", (unsigned long long)ready.load(), ms,
+                   ready / ms * 1000.0);
+        }
+        printf("\n");
+    }
+    return 0;
+}
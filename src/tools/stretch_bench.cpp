@@ -0,0 +1,120 @@
+// MicMute-S time-stretch benchmark
+//
+// Runs the playback time-stretcher offline over a recording (or a
+// synthetic voice-like signal) at each supported speed and reports the
+// CPU cost per second of audio played. No Win32 dependencies:
+//
+//   Windows: see build.bat (stretch_bench.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o stretch_bench
+//              src/tools/stretch_bench.cpp src/audio/TimeStretch.cpp src/audio/WavDecoder.cpp
+//              src/audio/MappedWavReader.cpp src/core/mapped_file.cpp src/audio/WavMetadata.cpp
+//              src/audio/ImaAdpcm.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: stretch_bench [recording.wav] [--rate HZ] [--channels N] [--seconds N]
+//        (rate/channels/seconds apply to the synthetic signal)
+
+#include "audio/TimeStretch.h"
+#include "audio/WavDecoder.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage() {
+    printf("Usage: stretch_bench [recording.wav] [--rate HZ] [--channels N] [--seconds N]\n");
+}
+
+// Glottal-pulse-like buzz with a wandering pitch and syllable envelope -
+// close enough to speech for the correlation search to do real work
+static std::vector<float> Synthesize(uint32_t rate, uint16_t channels, double seconds) {
+    size_t frames = (size_t)(rate * seconds);
+    std::vector<float> out(frames * channels);
+    const double pi = 3.14159265358979323846;
+    double phase = 0.0;
+    for (size_t i = 0; i < frames; i++) {
+        double t = (double)i / rate;
+        double pitch = 140.0 + 40.0 * std::sin(2.0 * pi * 0.7 * t);
+        phase += pitch / rate;
+        double s = 0.0;
+        for (int h = 1; h <= 12; h++) s += std::sin(2.0 * pi * h * phase) / h;
+        double envelope = 0.5 + 0.5 * std::sin(2.0 * pi * 3.0 * t);
+        for (uint16_t c = 0; c < channels; c++) out[i * channels + c] = (float)(0.25 * s * envelope);
+    }
+    return out;
+}
+
+int main(int argc, char** argv) {
+    std::string path;
+    uint32_t rate = 48000;
+    uint16_t channels = 2;
+    double seconds = 60.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--rate") == 0 && hasValue)          rate = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--channels") == 0 && hasValue) channels = (uint16_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--seconds") == 0 && hasValue)  seconds = atof(argv[++i]);
+        else if (arg[0] != '-' && path.empty())              path = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    std::vector<float> input;
+    if (!path.empty()) {
+        WavDecoder decoder;
+        if (!decoder.Open(path)) { printf("Cannot decode %s\n", path.c_str()); return 1; }
+        rate = decoder.GetSampleRate();
+        channels = decoder.GetChannels();
+        input.resize((size_t)decoder.GetTotalFrames() * channels);
+        input.resize(decoder.Read(input.data(), (size_t)decoder.GetTotalFrames()) * channels);
+        printf("%s: ", path.c_str());
+    } else {
+        if (rate == 0 || channels == 0 || seconds <= 0) { PrintUsage(); return 2; }
+        input = Synthesize(rate, channels, seconds);
+        printf("synthetic voice: ");
+    }
+    const size_t inputFrames = input.size() / channels;
+    const double inputSeconds = (double)inputFrames / rate;
+    printf("%.1f s, %u Hz, %u ch\n\n", inputSeconds, rate, channels);
+    if (inputFrames == 0) return 1;
+
+    printf("speed   output s   cpu ms   ms per played s   %% of one core\n");
+    const double speeds[] = { 0.5, 0.75, 1.25, 1.5, 2.0, 2.5, 3.0 };
+    const size_t chunk = 4096;
+    std::vector<float> out;
+
+    for (double speed : speeds) {
+        TimeStretcher stretch;
+        stretch.Configure(rate, channels);
+        stretch.SetSpeed(speed);
+        out.resize(std::max(chunk, stretch.GetHopFrames()) * channels);
+
+        size_t fed = 0, produced = 0;
+        std::clock_t cpuStart = std::clock();
+        Clock::time_point wallStart = Clock::now();
+        for (;;) {
+            size_t n = stretch.Process(out.data(), out.size() / channels);
+            produced += n;
+            if (n > 0) continue;
+            if (fed >= inputFrames) break;
+            size_t push = std::min(chunk, inputFrames - fed);
+            stretch.PushInput(input.data() + fed * channels, push);
+            fed += push;
+        }
+        double cpuMs = (double)(std::clock() - cpuStart) * 1000.0 / CLOCKS_PER_SEC;
+        double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - wallStart).count();
+        double ms = std::max(cpuMs, 0.0) > 0.0 ? cpuMs : wallMs;   // clock() is coarse on some systems
+
+        double outputSeconds = (double)produced / rate;
+        double perSecond = ms / outputSeconds;
+        printf("%4.2fx  %9.1f  %7.1f  %16.3f  %13.2f\n", speed, outputSeconds, ms, perSecond, perSecond / 10.0);
+    }
+    return 0;
+}
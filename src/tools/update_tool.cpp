@@ -0,0 +1,488 @@
+// MicMute-S update tool
+//
+// Release side of the verified updater: builds binary delta patches and
+// the update-manifest.txt published with each release, and self-tests the
+// downloader (resume, verification, deltas, LAN peer cache) against a
+// local HTTP stand-in for the release host. No Win32 dependencies:
+//
+//   Windows: see build.bat (update_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -pthread -I src -o update_tool
+//              src/tools/update_tool.cpp src/network/update_download.cpp src/network/update_peer.cpp
+//              src/network/http_client.cpp src/core/binary_delta.cpp src/core/sha256.cpp
+//              src/core/mapped_file.cpp
+//
+// Usage: update_tool manifest --version V --out update-manifest.txt
+//                    [--base-dir DIR --base-version V] <release files...>
+//        update_tool delta <base> <target> <delta out>
+//        update_tool apply <base> <delta> <out>
+//        update_tool selftest
+//        (exit code 1 if a check fails)
+
+#include "network/update_download.h"
+#include "network/update_peer.h"
+#include "core/binary_delta.h"
+#include "core/sha256.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET SocketHandle;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int SocketHandle;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: update_tool manifest --version V --out update-manifest.txt\n");
+    printf("                   [--base-dir DIR --base-version V] <release files...>\n");
+    printf("       update_tool delta <base> <target> <delta out>\n");
+    printf("       update_tool apply <base> <delta> <out>\n");
+    printf("       update_tool selftest\n");
+}
+
+static bool WriteFile(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), (std::streamsize)data.size());
+    return out.good();
+}
+
+static std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// ============================================================================
+// Release side
+// ============================================================================
+
+static int RunDelta(const char* base, const char* target, const char* out) {
+    BinaryDeltaStats stats;
+    if (!CreateBinaryDelta(base, target, out, &stats)) {
+        fprintf(stderr, "Cannot create delta\n");
+        return 1;
+    }
+    printf("%s: %llu -> %llu bytes, delta %llu bytes (%.1f%%), %llu copies, %llu literal bytes\n", out,
+           (unsigned long long)stats.baseSize, (unsigned long long)stats.targetSize,
+           (unsigned long long)stats.deltaSize, stats.targetSize ? 100.0 * stats.deltaSize / stats.targetSize : 0.0,
+           (unsigned long long)stats.copyOps, (unsigned long long)stats.literalBytes);
+    return 0;
+}
+
+static int RunApply(const char* base, const char* delta, const char* out) {
+    std::string error;
+    if (!ApplyBinaryDelta(base, delta, out, &error)) {
+        fprintf(stderr, "Cannot apply delta: %s\n", error.c_str());
+        return 1;
+    }
+    printf("%s: %s\n", out, Sha256::HashFileHex(out).c_str());
+    return 0;
+}
+
+// Deltas are written next to the manifest and only listed when they save
+// at least half of the full download
+static int RunManifest(const std::string& version, const std::string& outPath, const std::string& baseDir,
+                       const std::string& baseVersion, const std::vector<std::string>& files) {
+    UpdateManifest manifest;
+    manifest.version = version;
+    fs::path outDir = fs::path(outPath).parent_path();
+    for (const std::string& path : files) {
+        std::error_code ec;
+        UpdateManifest::File f;
+        f.name = fs::path(path).filename().string();
+        f.size = fs::file_size(path, ec);
+        if (ec) {
+            fprintf(stderr, "Cannot read %s\n", path.c_str());
+            return 1;
+        }
+        f.sha256 = Sha256::HashFileHex(path);
+        manifest.files.push_back(f);
+        printf("file  %s %llu %s\n", f.name.c_str(), (unsigned long long)f.size, f.sha256.c_str());
+
+        fs::path base = fs::path(baseDir) / f.name;
+        if (baseDir.empty() || !fs::exists(base, ec)) continue;
+        UpdateManifest::Delta d;
+        d.file = f.name;
+        d.fromVersion = baseVersion;
+        d.name = f.name + ".from-" + baseVersion + ".delta";
+        std::string deltaPath = (outDir / d.name).string();
+        BinaryDeltaStats stats;
+        if (!CreateBinaryDelta(base.string(), path, deltaPath, &stats)) {
+            fprintf(stderr, "Cannot create delta for %s\n", f.name.c_str());
+            return 1;
+        }
+        if (stats.deltaSize * 2 > f.size) {
+            printf("delta %s skipped (%llu bytes)\n", d.name.c_str(), (unsigned long long)stats.deltaSize);
+            fs::remove(deltaPath, ec);
+            continue;
+        }
+        d.size = stats.deltaSize;
+        d.sha256 = Sha256::HashFileHex(deltaPath);
+        d.baseSha256 = Sha256::HashFileHex(base.string());
+        manifest.deltas.push_back(d);
+        printf("delta %s %llu\n", d.name.c_str(), (unsigned long long)d.size);
+    }
+    if (!WriteFile(outPath, manifest.ToText())) {
+        fprintf(stderr, "Cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Self-test: release host stand-in
+// ============================================================================
+
+// Serves fixed files over plain HTTP with Range support, and misbehaves on
+// request: connections cut after dropEvery body bytes, Range ignored, or a
+// flipped byte in the body.
+class OriginStandIn {
+public:
+    std::map<std::string, std::string> files;   // path -> content
+    uint64_t dropEvery = 0;
+    bool ignoreRange = false;
+    bool corrupt = false;
+
+    bool Start() {
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return false;
+#endif
+        m_listen = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_listen == INVALID_SOCKET) return false;
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (bind(m_listen, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(m_listen, SOMAXCONN) != 0) return false;
+#ifdef _WIN32
+        int len = sizeof(addr);
+#else
+        socklen_t len = sizeof(addr);
+#endif
+        getsockname(m_listen, (sockaddr*)&addr, &len);
+        m_port = ntohs(addr.sin_port);
+        m_running = true;
+        m_thread = std::thread(&OriginStandIn::Loop, this);
+        return true;
+    }
+
+    void Stop() {
+        m_running = false;
+        if (m_thread.joinable()) m_thread.join();
+        closesocket(m_listen);
+    }
+
+    std::string Url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + path;
+    }
+
+    int Requests(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_requests[path];
+    }
+
+private:
+    void Loop() {
+        while (m_running) {
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(m_listen, &readSet);
+            timeval timeout = {0, 100 * 1000};
+            if (select((int)m_listen + 1, &readSet, nullptr, nullptr, &timeout) <= 0) continue;
+            SocketHandle client = accept(m_listen, nullptr, nullptr);
+            if (client == INVALID_SOCKET) continue;
+            Handle(client);
+            closesocket(client);
+        }
+    }
+
+    static void SendAll(SocketHandle s, const char* data, size_t len) {
+        while (len > 0) {
+            int n = send(s, data, (int)len, 0);
+            if (n <= 0) return;
+            data += n;
+            len -= (size_t)n;
+        }
+    }
+
+    void Handle(SocketHandle client) {
+        std::string head;
+        char buf[2048];
+        while (head.find("\r\n\r\n") == std::string::npos) {
+            int n = recv(client, buf, sizeof(buf), 0);
+            if (n <= 0) return;
+            head.append(buf, (size_t)n);
+        }
+        size_t sp1 = head.find(' ');
+        size_t sp2 = head.find(' ', sp1 + 1);
+        std::string path = head.substr(sp1 + 1, sp2 - sp1 - 1);
+        path = path.substr(0, path.find('?'));
+        uint64_t first = 0;
+        size_t range = head.find("Range: bytes=");
+        if (range != std::string::npos && !ignoreRange) first = strtoull(head.c_str() + range + 13, nullptr, 10);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests[path]++;
+        }
+
+        auto it = files.find(path);
+        if (it == files.end()) {
+            const char* notFound = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            SendAll(client, notFound, strlen(notFound));
+            return;
+        }
+        const std::string& data = it->second;
+        std::string reply = first ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+        if (first) reply += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(data.size() - 1) + "/" + std::to_string(data.size()) + "\r\n";
+        reply += "Content-Length: " + std::to_string(data.size() - first) + "\r\nConnection: close\r\n\r\n";
+        std::string body = data.substr((size_t)first);
+        if (corrupt && !body.empty()) body[body.size() / 2] ^= 0x20;
+        if (dropEvery && body.size() > dropEvery) body.resize((size_t)dropEvery);
+        reply += body;
+        SendAll(client, reply.data(), reply.size());
+    }
+
+    SocketHandle m_listen = INVALID_SOCKET;
+    int m_port = 0;
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::map<std::string, int> m_requests;
+};
+
+static std::string RandomBytes(size_t n, uint32_t seed) {
+    std::string s(n, '\0');
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        s[i] = (char)(seed >> 24);
+    }
+    return s;
+}
+
+static UpdateDownloadOptions SeatOptions(const fs::path& cacheDir) {
+    UpdateDownloadOptions options;
+    options.cacheDir = cacheDir.string();
+    options.retryDelayMs = 10;
+    options.peerWaitMs = 30 * 1000;
+    return options;
+}
+
+static int RunSelfTest() {
+    fs::path root = fs::temp_directory_path() / "micmute_update_selftest";
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    fs::create_directories(root, ec);
+
+    // Version 1 and 2 of a 1.5 MB "exe": v2 has a rewritten block, an
+    // inserted section and a removed one, like a rebuilt binary
+    std::string v1 = RandomBytes(1536 * 1024, 1);
+    std::string v2 = v1;
+    v2.replace(100000, 4096, RandomBytes(4096, 2));
+    v2.insert(700000, RandomBytes(8192, 3));
+    v2.erase(1200000, 2048);
+    std::string v1Path = (root / "MicMute-S-v1.exe").string();
+    std::string v2Path = (root / "MicMute-S.exe").string();
+    WriteFile(v1Path, v1);
+    WriteFile(v2Path, v2);
+
+    printf("Delta:\n");
+    std::string deltaPath = (root / "MicMute-S.exe.from-v1.delta").string();
+    BinaryDeltaStats stats;
+    Check(CreateBinaryDelta(v1Path, v2Path, deltaPath, &stats), "delta created");
+    printf("       %llu bytes for a %llu byte target\n", (unsigned long long)stats.deltaSize, (unsigned long long)stats.targetSize);
+    Check(stats.deltaSize * 20 < stats.targetSize, "delta is under 5% of the full file");
+    std::string rebuilt = (root / "rebuilt.exe").string();
+    Check(ApplyBinaryDelta(v1Path, deltaPath, rebuilt) && ReadFile(rebuilt) == v2, "delta reproduces the target");
+    std::string error;
+    Check(!ApplyBinaryDelta(v2Path, deltaPath, rebuilt, &error) && !error.empty(), "wrong base rejected");
+
+    UpdateManifest manifest;
+    manifest.version = "v2";
+    manifest.files.push_back({"MicMute-S.exe", v2.size(), Sha256::HashFileHex(v2Path)});
+    manifest.deltas.push_back({"MicMute-S.exe", "v1", "MicMute-S.exe.from-v1.delta", stats.deltaSize,
+                               Sha256::HashFileHex(deltaPath), Sha256::HashFileHex(v1Path)});
+    UpdateManifest parsed;
+    Check(parsed.Parse(manifest.ToText()) && parsed.ToText() == manifest.ToText(), "manifest round trip");
+
+    OriginStandIn origin;
+    origin.files["/rel/v2/update-manifest.txt"] = manifest.ToText();
+    origin.files["/rel/v2/MicMute-S.exe"] = v2;
+    origin.files["/rel/v2/MicMute-S.exe.from-v1.delta"] = ReadFile(deltaPath);
+    if (!origin.Start()) {
+        printf("FAIL: cannot start the stand-in server\n");
+        return 1;
+    }
+    std::string manifestUrl = origin.Url("/rel/v2/update-manifest.txt");
+    const std::string& sha = manifest.files[0].sha256;
+
+    printf("Resume:\n");
+    {
+        UpdateDownloader seat(SeatOptions(root / "seat-resume"));
+        UpdateManifest fetched;
+        Check(seat.FetchManifest(manifestUrl, fetched) && fetched.version == "v2", "manifest fetched");
+        origin.dropEvery = 256 * 1024;
+        UpdateDownloadResult r = seat.Fetch(fetched, manifestUrl, "MicMute-S.exe");
+        origin.dropEvery = 0;
+        Check(r.ok && r.source == "origin" && ReadFile(r.path) == v2, "download through dropped connections verified");
+        Check(r.resumes >= 5, "continued with Range requests");
+        Check(r.bytesTransferred == v2.size(), "no byte downloaded twice");
+        UpdateDownloadResult again = seat.Fetch(fetched, manifestUrl, "MicMute-S.exe");
+        Check(again.ok && again.source == "cache" && again.bytesTransferred == 0, "second fetch served from the cache");
+    }
+
+    printf("Restart:\n");
+    {
+        fs::path cache = root / "seat-restart";
+        fs::create_directories(cache, ec);
+        WriteFile((cache / (sha + ".part")).string(), v2.substr(0, v2.size() / 2));
+        UpdateDownloader seat(SeatOptions(cache));
+        UpdateDownloadResult r = seat.Fetch(manifest, manifestUrl, "MicMute-S.exe");
+        Check(r.ok && r.bytesTransferred == v2.size() - v2.size() / 2, "partial file from an earlier run continued");
+
+        WriteFile((cache / (sha + ".part")).string(), v2.substr(0, 1000));
+        fs::remove(cache / sha, ec);
+        origin.ignoreRange = true;
+        r = seat.Fetch(manifest, manifestUrl, "MicMute-S.exe");
+        origin.ignoreRange = false;
+        Check(r.ok && ReadFile(r.path) == v2, "server ignoring Range: restarted from zero");
+    }
+
+    printf("Verification:\n");
+    {
+        fs::path cache = root / "seat-corrupt";
+        UpdateDownloader seat(SeatOptions(cache));
+        origin.corrupt = true;
+        UpdateDownloadResult r = seat.Fetch(manifest, manifestUrl, "MicMute-S.exe");
+        origin.corrupt = false;
+        Check(!r.ok && r.error.find("checksum") != std::string::npos, "corrupted download rejected");
+        Check(!fs::exists(cache / sha, ec) && !fs::exists(cache / (sha + ".part"), ec), "nothing left in the cache");
+        UpdateManifest wrong = manifest;
+        wrong.files[0].size--;
+        r = seat.Fetch(wrong, manifestUrl, "MicMute-S.exe");
+        Check(!r.ok, "size mismatch rejected");
+    }
+
+    printf("Delta download:\n");
+    {
+        UpdateDownloader seat(SeatOptions(root / "seat-delta"));
+        UpdateDownloadResult r = seat.Fetch(manifest, manifestUrl, "MicMute-S.exe", {v1Path});
+        Check(r.ok && r.source == "delta" && ReadFile(r.path) == v2, "patched from the running version");
+        Check(r.bytesTransferred == stats.deltaSize, "only the delta was downloaded");
+        seat.PruneCache({sha});
+        size_t left = 0;
+        for (const auto& entry : fs::directory_iterator(root / "seat-delta", ec)) { (void)entry; left++; }
+        Check(left == 1, "cache pruned to the current version");
+    }
+
+    printf("Peer cache:\n");
+    {
+        int before = origin.Requests("/rel/v2/MicMute-S.exe");
+        UpdatePeerServer peer((root / "peer").string(), origin.Url("/rel/"));
+        Check(peer.Start(0, "127.0.0.1"), "peer started");
+        std::string peerUrl = "http://127.0.0.1:" + std::to_string(peer.GetPort());
+
+        const int seats = 4;
+        std::vector<UpdateDownloadResult> results(seats);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < seats; i++) {
+            threads.emplace_back([&, i] {
+                UpdateDownloadOptions options = SeatOptions(root / ("seat-peer" + std::to_string(i)));
+                options.peerUrls.push_back(peerUrl);
+                UpdateDownloader seat(options);
+                results[i] = seat.Fetch(manifest, manifestUrl, "MicMute-S.exe");
+            });
+        }
+        for (auto& t : threads) t.join();
+        bool allPeer = true;
+        for (const auto& r : results) allPeer = allPeer && r.ok && r.source == "peer" && ReadFile(r.path) == v2;
+        Check(allPeer, "every seat served by the peer");
+        Check(origin.Requests("/rel/v2/MicMute-S.exe") - before == 1, "one origin download for the whole subnet");
+        UpdatePeerServer::Stats peerStats = peer.GetStats();
+        printf("       %s\n", peerStats.ToJson().c_str());
+
+        UpdatePeerServer strict((root / "peer-strict").string(), "https://example.invalid/");
+        strict.Start(0, "127.0.0.1");
+        UpdateDownloadOptions options = SeatOptions(root / "seat-strict");
+        options.peerUrls.push_back("http://127.0.0.1:" + std::to_string(strict.GetPort()));
+        UpdateDownloader seat(options);
+        UpdateDownloadResult r = seat.Fetch(manifest, manifestUrl, "MicMute-S.exe");
+        Check(r.ok && r.source == "origin" && strict.GetStats().originFetches == 0,
+              "peer refuses foreign URLs, seat falls back to the origin");
+
+        UpdateDownloadOptions deadOptions = SeatOptions(root / "seat-dead-peer");
+        deadOptions.peerUrls.push_back("http://127.0.0.1:1");
+        UpdateDownloader deadSeat(deadOptions);
+        r = deadSeat.Fetch(manifest, manifestUrl, "MicMute-S.exe");
+        Check(r.ok && r.source == "origin", "unreachable peer skipped");
+        strict.Stop();
+        peer.Stop();
+    }
+
+    origin.Stop();
+    fs::remove_all(root, ec);
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return 2;
+    }
+    std::string command = argv[1];
+    if (command == "selftest") return RunSelfTest();
+    if (command == "delta" && argc == 5) return RunDelta(argv[2], argv[3], argv[4]);
+    if (command == "apply" && argc == 5) return RunApply(argv[2], argv[3], argv[4]);
+    if (command != "manifest") {
+        PrintUsage();
+        return 2;
+    }
+
+    std::string version, out, baseDir, baseVersion;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--version") == 0 && hasValue)           version = argv[++i];
+        else if (strcmp(arg, "--out") == 0 && hasValue)          out = argv[++i];
+        else if (strcmp(arg, "--base-dir") == 0 && hasValue)     baseDir = argv[++i];
+        else if (strcmp(arg, "--base-version") == 0 && hasValue) baseVersion = argv[++i];
+        else if (arg[0] != '-')                                  files.push_back(arg);
+        else { PrintUsage(); return 2; }
+    }
+    if (version.empty() || out.empty() || files.empty() || (!baseDir.empty() && baseVersion.empty())) {
+        PrintUsage();
+        return 2;
+    }
+    return RunManifest(version, out, baseDir, baseVersion, files);
+}
@@ -0,0 +1,614 @@
+// MicMute-S upload tool
+//
+// Self-tests the recording upload queue (multipart upload, resume from the
+// journal, retries, bandwidth throttling) against a local HTTP stand-in
+// for an S3-compatible object store. No Win32 dependencies:
+//
+//   Windows: see build.bat (upload_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -pthread -I src -o upload_tool
+//              src/tools/upload_tool.cpp src/network/upload_queue.cpp src/network/s3_client.cpp
+//              src/network/http_client.cpp src/audio/WavMetadata.cpp src/core/sha256.cpp
+//              src/core/thread_pool.cpp
+//
+// Usage: upload_tool selftest
+//        (exit code 1 if a check fails)
+
+#include "network/upload_queue.h"
+#include "core/sha256.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET SocketHandle;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int SocketHandle;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+namespace fs = std::filesystem;
+
+static const uint64_t PART_SIZE = 5 * 1024 * 1024;   // Queue minimum
+
+static int g_failures = 0;
+
+static void Check(bool ok, const char* what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+static void PrintUsage() {
+    printf("Usage: upload_tool selftest\n");
+}
+
+static bool WriteFile(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), (std::streamsize)data.size());
+    return out.good();
+}
+
+static std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static std::string RandomBytes(size_t n, uint32_t seed) {
+    std::string s(n, '\0');
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        s[i] = (char)(seed >> 24);
+    }
+    return s;
+}
+
+// ============================================================================
+// Object store stand-in
+// ============================================================================
+
+// Path-style S3 subset the queue uses: CreateMultipartUpload, UploadPart,
+// ListParts, CompleteMultipartUpload, AbortMultipartUpload and PutObject.
+// Signatures are not checked, but every payload must match its
+// x-amz-content-sha256 header, like a real server. Faults on request: the
+// next failParts part uploads get 500, the next failCreates uploads 503.
+class ObjectStoreStandIn {
+public:
+    std::atomic<int> failParts{0};
+    std::atomic<int> failCreates{0};
+
+    bool Start() {
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return false;
+#endif
+        m_listen = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_listen == INVALID_SOCKET) return false;
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (bind(m_listen, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(m_listen, SOMAXCONN) != 0) return false;
+#ifdef _WIN32
+        int len = sizeof(addr);
+#else
+        socklen_t len = sizeof(addr);
+#endif
+        getsockname(m_listen, (sockaddr*)&addr, &len);
+        m_port = ntohs(addr.sin_port);
+        m_running = true;
+        m_thread = std::thread(&ObjectStoreStandIn::Loop, this);
+        return true;
+    }
+
+    void Stop() {
+        m_running = false;
+        if (m_thread.joinable()) m_thread.join();
+        closesocket(m_listen);
+    }
+
+    std::string Endpoint() const {
+        return "http://127.0.0.1:" + std::to_string(m_port);
+    }
+
+    // Requests per operation ("create", "part", "list", "complete", "abort", "put")
+    int Count(const std::string& op) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_counts[op];
+    }
+
+    uint64_t PartBytes() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_partBytes;
+    }
+
+    bool GetObject(const std::string& key, std::string& data, std::string* sha256Meta = nullptr) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_objects.find(key);
+        if (it == m_objects.end()) return false;
+        data = it->second.data;
+        if (sha256Meta) *sha256Meta = it->second.sha256Meta;
+        return true;
+    }
+
+    // An upload left behind by an earlier run, holding the given parts
+    std::string SeedUpload(const std::string& key, const std::string& sha256Meta,
+                           const std::map<int, std::string>& parts, std::map<int, std::string>& etags) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string uploadId = "upload-" + std::to_string(++m_nextUpload);
+        Upload& upload = m_uploads[uploadId];
+        upload.key = key;
+        upload.sha256Meta = sha256Meta;
+        for (const auto& kv : parts) {
+            upload.parts[kv.first] = kv.second;
+            etags[kv.first] = ETagOf(kv.second);
+        }
+        return uploadId;
+    }
+
+    void Reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counts.clear();
+        m_partBytes = 0;
+    }
+
+private:
+    struct Upload {
+        std::string key;
+        std::string sha256Meta;
+        std::map<int, std::string> parts;
+    };
+    struct Object {
+        std::string data;
+        std::string sha256Meta;
+    };
+
+    static std::string ETagOf(const std::string& data) {
+        return "\"" + Sha256::HashHex(data).substr(0, 32) + "\"";
+    }
+
+    static std::string Unescape(const std::string& s) {
+        std::string out;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (s[i] == '%' && i + 2 < s.size()) {
+                out += (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+                i += 2;
+            } else {
+                out += s[i];
+            }
+        }
+        return out;
+    }
+
+    static std::string Header(const std::string& head, const std::string& lowerName) {
+        std::string lower = head;
+        for (auto& c : lower) c = (char)tolower((unsigned char)c);
+        size_t pos = lower.find("\r\n" + lowerName + ":");
+        if (pos == std::string::npos) return "";
+        pos += lowerName.size() + 3;
+        size_t end = head.find("\r\n", pos);
+        while (pos < end && head[pos] == ' ') pos++;
+        return head.substr(pos, end - pos);
+    }
+
+    void Loop() {
+        while (m_running) {
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(m_listen, &readSet);
+            timeval timeout = {0, 100 * 1000};
+            if (select((int)m_listen + 1, &readSet, nullptr, nullptr, &timeout) <= 0) continue;
+            SocketHandle client = accept(m_listen, nullptr, nullptr);
+            if (client == INVALID_SOCKET) continue;
+            Handle(client);
+            closesocket(client);
+        }
+    }
+
+    static void SendAll(SocketHandle s, const char* data, size_t len) {
+        while (len > 0) {
+            int n = send(s, data, (int)len, 0);
+            if (n <= 0) return;
+            data += n;
+            len -= (size_t)n;
+        }
+    }
+
+    static void Reply(SocketHandle client, int status, const std::string& body,
+                      const std::string& extraHeaders = std::string()) {
+        const char* reason = status == 200 ? "OK" : status == 204 ? "No Content" : status == 404 ? "Not Found" :
+                             status == 400 ? "Bad Request" : status == 503 ? "Service Unavailable" : "Internal Server Error";
+        std::string reply = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n" + extraHeaders;
+        reply += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        SendAll(client, reply.data(), reply.size());
+    }
+
+    static std::string Error(const std::string& code) {
+        return "<Error><Code>" + code + "</Code></Error>";
+    }
+
+    void Handle(SocketHandle client) {
+        std::string raw;
+        char buf[65536];
+        size_t headerEnd;
+        while ((headerEnd = raw.find("\r\n\r\n")) == std::string::npos) {
+            int n = recv(client, buf, sizeof(buf), 0);
+            if (n <= 0) return;
+            raw.append(buf, (size_t)n);
+        }
+        std::string head = raw.substr(0, headerEnd + 2);
+        std::string body = raw.substr(headerEnd + 4);
+        size_t contentLength = (size_t)strtoull(Header(head, "content-length").c_str(), nullptr, 10);
+        while (body.size() < contentLength) {
+            int n = recv(client, buf, sizeof(buf), 0);
+            if (n <= 0) return;
+            body.append(buf, (size_t)n);
+        }
+
+        size_t sp1 = head.find(' ');
+        size_t sp2 = head.find(' ', sp1 + 1);
+        std::string method = head.substr(0, sp1);
+        std::string target = head.substr(sp1 + 1, sp2 - sp1 - 1);
+        size_t qpos = target.find('?');
+        std::string path = Unescape(target.substr(0, qpos));
+        std::map<std::string, std::string> query;
+        if (qpos != std::string::npos) {
+            std::string q = target.substr(qpos + 1);
+            size_t pos = 0;
+            while (pos <= q.size()) {
+                size_t amp = q.find('&', pos);
+                std::string kv = q.substr(pos, amp == std::string::npos ? std::string::npos : amp - pos);
+                size_t eq = kv.find('=');
+                query[Unescape(kv.substr(0, eq))] = eq == std::string::npos ? "" : Unescape(kv.substr(eq + 1));
+                if (amp == std::string::npos) break;
+                pos = amp + 1;
+            }
+        }
+        // "/bucket/key" -> key
+        size_t slash = path.find('/', 1);
+        std::string key = slash == std::string::npos ? "" : path.substr(slash + 1);
+
+        if (Header(head, "x-amz-content-sha256") != Sha256::HashHex(body)) {
+            Reply(client, 400, Error("XAmzContentSHA256Mismatch"));
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool hasUpload = query.count("uploadId") != 0;
+        auto upload = hasUpload ? m_uploads.find(query["uploadId"]) : m_uploads.end();
+        if (hasUpload && (upload == m_uploads.end() || upload->second.key != key)) {
+            m_counts[method == "PUT" ? "part" : method == "GET" ? "list" : method == "POST" ? "complete" : "abort"]++;
+            Reply(client, 404, Error("NoSuchUpload"));
+            return;
+        }
+
+        if (method == "POST" && query.count("uploads")) {
+            m_counts["create"]++;
+            if (failCreates > 0) {
+                failCreates--;
+                Reply(client, 503, Error("SlowDown"));
+                return;
+            }
+            std::string uploadId = "upload-" + std::to_string(++m_nextUpload);
+            m_uploads[uploadId].key = key;
+            m_uploads[uploadId].sha256Meta = Header(head, "x-amz-meta-sha256");
+            Reply(client, 200, "<InitiateMultipartUploadResult><UploadId>" + uploadId +
+                               "</UploadId></InitiateMultipartUploadResult>");
+        } else if (method == "PUT" && hasUpload) {
+            m_counts["part"]++;
+            if (failParts > 0) {
+                failParts--;
+                Reply(client, 500, Error("InternalError"));
+                return;
+            }
+            int number = atoi(query["partNumber"].c_str());
+            upload->second.parts[number] = body;
+            m_partBytes += body.size();
+            Reply(client, 200, "", "ETag: " + ETagOf(body) + "\r\n");
+        } else if (method == "GET" && hasUpload) {
+            m_counts["list"]++;
+            std::string xml = "<ListPartsResult>";
+            for (const auto& part : upload->second.parts) {
+                std::string etag = ETagOf(part.second);
+                xml += "<Part><PartNumber>" + std::to_string(part.first) + "</PartNumber><ETag>&quot;" +
+                       etag.substr(1, etag.size() - 2) + "&quot;</ETag><Size>" +
+                       std::to_string(part.second.size()) + "</Size></Part>";
+            }
+            xml += "<IsTruncated>false</IsTruncated></ListPartsResult>";
+            Reply(client, 200, xml);
+        } else if (method == "POST" && hasUpload) {
+            m_counts["complete"]++;
+            // Every listed part must be stored with that ETag; all but the last at least 5 MB
+            Object object;
+            size_t pos = 0, listed = 0;
+            for (;;) {
+                size_t numberAt = body.find("<PartNumber>", pos);
+                if (numberAt == std::string::npos) break;
+                int number = atoi(body.c_str() + numberAt + 12);
+                size_t etagAt = body.find("<ETag>", numberAt) + 6;
+                std::string etag = body.substr(etagAt, body.find("</ETag>", etagAt) - etagAt);
+                auto part = upload->second.parts.find(number);
+                if (part == upload->second.parts.end() || ETagOf(part->second) != etag || number != (int)++listed ||
+                    (listed > 1 && object.data.size() % PART_SIZE != 0)) {
+                    Reply(client, 400, Error("InvalidPart"));
+                    return;
+                }
+                object.data += part->second;
+                pos = etagAt;
+            }
+            if (listed == 0) {
+                Reply(client, 400, Error("MalformedXML"));
+                return;
+            }
+            object.sha256Meta = upload->second.sha256Meta;
+            m_objects[key] = std::move(object);
+            m_uploads.erase(upload);
+            Reply(client, 200, "<CompleteMultipartUploadResult><Key>" + key + "</Key></CompleteMultipartUploadResult>");
+        } else if (method == "DELETE" && hasUpload) {
+            m_counts["abort"]++;
+            m_uploads.erase(upload);
+            Reply(client, 204, "");
+        } else if (method == "PUT") {
+            m_counts["put"]++;
+            m_objects[key].data = body;
+            Reply(client, 200, "", "ETag: " + ETagOf(body) + "\r\n");
+        } else {
+            Reply(client, 400, Error("NotImplemented"));
+        }
+    }
+
+    SocketHandle m_listen = INVALID_SOCKET;
+    int m_port = 0;
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::map<std::string, int> m_counts;
+    std::map<std::string, Upload> m_uploads;
+    std::map<std::string, Object> m_objects;
+    uint64_t m_partBytes = 0;
+    int m_nextUpload = 0;
+};
+
+// ============================================================================
+// Self-test
+// ============================================================================
+
+static bool WaitFor(const std::function<bool()>& done, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return true;
+}
+
+static bool WaitCompleted(UploadQueue& queue, size_t n, int timeoutMs = 30 * 1000) {
+    return WaitFor([&] { UploadStatus s = queue.GetStatus(); return s.completed >= n && s.pending == 0; }, timeoutMs);
+}
+
+static bool ObjectMatches(ObjectStoreStandIn& store, const std::string& key, const std::string& data) {
+    std::string stored, sha;
+    return store.GetObject(key, stored, &sha) && stored == data && sha == Sha256::HashHex(data);
+}
+
+static int RunSelfTest() {
+    fs::path root = fs::temp_directory_path() / "micmute_upload_selftest";
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    fs::path day = root / "2026-10-19";
+    fs::create_directories(day, ec);
+    const std::string journal = (root / "upload_queue.journal").string();
+
+    ObjectStoreStandIn store;
+    if (!store.Start()) {
+        printf("FAIL: cannot start the stand-in server\n");
+        return 1;
+    }
+
+    UploadSettings settings;
+    settings.s3.endpoint = store.Endpoint();
+    settings.s3.bucket = "recordings";
+    settings.s3.accessKey = "test";
+    settings.s3.secretKey = "test-secret";
+    settings.keyPrefix = "agent-7";
+    settings.partSize = PART_SIZE;
+    settings.parallelParts = 3;
+
+    // Three parts: two full, one short
+    const std::string a = RandomBytes(2 * PART_SIZE + 123457, 1);
+    const std::string aPath = (day / "call_a.wav").string();
+    const std::string aKey = "agent-7/2026-10-19/call_a.wav";
+    WriteFile(aPath, a);
+
+    printf("Multipart upload:\n");
+    {
+        UploadQueue queue;
+        Check(queue.Start(journal, settings), "queue started");
+        Check(queue.Enqueue(aPath), "recording queued");
+        Check(WaitCompleted(queue, 1), "upload completed");
+        Check(ObjectMatches(store, aKey, a), "object matches the file, sha256 in its metadata");
+        Check(store.Count("create") == 1 && store.Count("part") == 3 && store.Count("complete") == 1,
+              "one multipart upload of three parts");
+        std::string json;
+        Check(store.GetObject(aKey + ".json", json) && json.find(Sha256::HashHex(a)) != std::string::npos,
+              "metadata JSON stored next to it");
+        queue.Stop();
+
+        UploadQueue restarted;
+        restarted.Start(journal, settings);
+        Check(restarted.GetStatus().pending == 0 && ReadFile(journal).empty(), "journal compacts to nothing");
+        restarted.Stop();
+    }
+
+    printf("Resume from the journal:\n");
+    {
+        // An earlier run stored parts 1 and 2 but only journaled part 1;
+        // ListParts is authoritative, so only part 3 goes out again
+        store.Reset();
+        const std::string b = RandomBytes(2 * PART_SIZE + 4096, 2);
+        const std::string bPath = (day / "call_b.wav").string();
+        const std::string bKey = "agent-7/2026-10-19/call_b.wav";
+        WriteFile(bPath, b);
+        std::map<int, std::string> etags;
+        std::string uploadId = store.SeedUpload(bKey, Sha256::HashHex(b),
+                                                { { 1, b.substr(0, PART_SIZE) }, { 2, b.substr(PART_SIZE, PART_SIZE) } },
+                                                etags);
+        WriteFile(journal, "A 7 " + bKey + "\t" + bPath + "\n" +
+                           "S 7 " + Sha256::HashHex(b) + "\n" +
+                           "U 7 " + uploadId + "\n" +
+                           "P 7 1 " + etags[1] + "\n");
+
+        UploadQueue queue;
+        queue.Start(journal, settings);
+        Check(WaitCompleted(queue, 1), "interrupted upload completed");
+        Check(ObjectMatches(store, bKey, b), "object matches the file");
+        Check(store.Count("create") == 0 && store.Count("list") == 1 && store.Count("part") == 1,
+              "same upload id kept, only the missing part sent");
+        queue.Stop();
+
+        // Upload id the server no longer knows (expired or aborted)
+        store.Reset();
+        WriteFile(journal, "A 8 " + bKey + "\t" + bPath + "\n" +
+                           "U 8 upload-expired\n" +
+                           "P 8 1 " + etags[1] + "\n");
+        UploadQueue expired;
+        expired.Start(journal, settings);
+        Check(WaitCompleted(expired, 1), "expired upload completed");
+        Check(ObjectMatches(store, bKey, b) && store.Count("create") == 1 && store.Count("part") == 3,
+              "expired upload id started over");
+
+        // Stopped mid-upload, continued by the next process
+        store.Reset();
+        settings.captureBytesPerSec = 0;
+        const std::string c = RandomBytes(PART_SIZE + 777, 3);
+        const std::string cPath = (day / "call_c.wav").string();
+        const std::string cKey = "agent-7/2026-10-19/call_c.wav";
+        WriteFile(cPath, c);
+        UploadQueue first;
+        first.Start(journal, settings);
+        first.BeginCapture();
+        first.Enqueue(cPath);
+        Check(WaitFor([&] { return store.Count("create") == 1; }, 10 * 1000), "upload started");
+        first.Stop();
+        first.EndCapture();
+        std::string partial;
+        Check(!store.GetObject(cKey, partial), "not completed before the stop");
+
+        UploadQueue second;
+        second.Start(journal, settings);
+        Check(WaitCompleted(second, 1), "completed after a restart");
+        Check(ObjectMatches(store, cKey, c) && store.Count("create") == 1, "continued the same multipart upload");
+        second.Stop();
+        settings.captureBytesPerSec = 64 * 1024;
+    }
+
+    printf("Retries:\n");
+    {
+        store.Reset();
+        const std::string d = RandomBytes(2 * PART_SIZE, 4);
+        const std::string dPath = (day / "call_d.wav").string();
+        const std::string dKey = "agent-7/2026-10-19/call_d.wav";
+        WriteFile(dPath, d);
+        store.failParts = 2;
+
+        UploadQueue queue;
+        queue.Start(journal, settings);
+        queue.Enqueue(dPath);
+        Check(WaitCompleted(queue, 1), "upload completed");
+        Check(ObjectMatches(store, dKey, d) && store.Count("part") == 4, "failed parts retried in place");
+        Check(queue.GetStatus().failed == 0, "part retries do not fail the job");
+
+        // A failed job is retried after a backoff
+        store.Reset();
+        store.failCreates = 1;
+        const std::string e = RandomBytes(PART_SIZE / 2, 5);
+        const std::string ePath = (day / "call_e.wav").string();
+        WriteFile(ePath, e);
+        queue.Enqueue(ePath);
+        Check(WaitCompleted(queue, 2), "upload completed");
+        UploadStatus status = queue.GetStatus();
+        Check(ObjectMatches(store, "agent-7/2026-10-19/call_e.wav", e) && store.Count("create") == 2,
+              "job retried after the server refused it");
+        Check(status.failed == 1 && status.lastError.find("SlowDown") != std::string::npos,
+              "failed attempt counted and reported");
+        queue.Stop();
+    }
+
+    printf("Throttling:\n");
+    {
+        // 12 MB at 6 MB/s: the token bucket starts empty, so at least 2 s
+        store.Reset();
+        const std::string f = RandomBytes(2 * PART_SIZE + 2 * 1024 * 1024, 6);
+        const std::string fPath = (day / "call_f.wav").string();
+        WriteFile(fPath, f);
+        UploadSettings limited = settings;
+        limited.maxBytesPerSec = 6 * 1024 * 1024;
+
+        UploadQueue queue;
+        queue.Start(journal, limited);
+        auto t0 = std::chrono::steady_clock::now();
+        queue.Enqueue(fPath);
+        Check(WaitCompleted(queue, 1), "upload completed");
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        printf("       %.1f MB in %.2f s\n", f.size() / 1048576.0, secs);
+        Check(secs >= 1.8, "held to the configured rate");
+        queue.Stop();
+
+        // Paused while a call is captured; nested calls, extra EndCapture
+        store.Reset();
+        limited.maxBytesPerSec = 0;
+        limited.captureBytesPerSec = 0;
+        const std::string g = RandomBytes(PART_SIZE + 1, 7);
+        const std::string gPath = (day / "call_g.wav").string();
+        WriteFile(gPath, g);
+        UploadQueue paused;
+        paused.Start(journal, limited);
+        paused.BeginCapture();
+        paused.BeginCapture();
+        paused.Enqueue(gPath);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        Check(paused.GetStatus().throttled && store.PartBytes() == 0, "nothing sent during a call");
+        paused.EndCapture();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        Check(paused.GetStatus().throttled && store.PartBytes() == 0, "still paused while a second call runs");
+        paused.EndCapture();
+        Check(WaitCompleted(paused, 1), "resumed once both calls ended");
+        paused.EndCapture();
+        Check(!paused.GetStatus().throttled, "unbalanced EndCapture ignored");
+        paused.BeginCapture();
+        Check(paused.GetStatus().throttled, "next call still pauses uploads");
+        paused.EndCapture();
+        paused.Stop();
+    }
+
+    store.Stop();
+    fs::remove_all(root, ec);
+    printf("\n%s\n", g_failures == 0 ? "PASS" : "FAIL");
+    return g_failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "selftest") == 0) return RunSelfTest();
+    PrintUsage();
+    return 2;
+}
@@ -0,0 +1,211 @@
+// MicMute-S voice-activity tool
+//
+// Builds the .vad voice-activity sidecars for recordings made before the
+// recorder wrote them, prints the map of one file, and checks the
+// detector's accuracy and cost on synthetic speech, silence and hold
+// music. No Win32 dependencies:
+//
+//   Windows: see build.bat (vad_tool.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o vad_tool
+//              src/tools/vad_tool.cpp src/audio/VoiceActivity.cpp src/audio/WavDecoder.cpp
+//              src/audio/MappedWavReader.cpp src/core/mapped_file.cpp src/audio/WavMetadata.cpp
+//              src/audio/ImaAdpcm.cpp
+//              src/storage/encrypted_recording.cpp src/core/aes_gcm.cpp src/core/sha256.cpp
+//
+// Usage: vad_tool <recordings folder> [--force]
+//        vad_tool --file <recording.wav>
+//        vad_tool --selftest       (exit code 1 if accuracy is below target)
+
+#include "audio/VoiceActivity.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage() {
+    printf("Usage: vad_tool <recordings folder> [--force]\n");
+    printf("       vad_tool --file <recording.wav>\n");
+    printf("       vad_tool --selftest\n");
+}
+
+static int BuildFolder(const std::string& root, bool force) {
+    size_t built = 0, skipped = 0, failed = 0;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec)) {
+        if (ec) break;
+        if (!it->is_regular_file(ec) || it->path().extension() != ".wav") continue;
+
+        std::string path = it->path().string();
+        std::string sidecar = VoiceActivityMap::GetSidecarPath(path);
+        if (!force && fs::exists(sidecar, ec)) { skipped++; continue; }
+
+        VoiceActivityMap map;
+        if (VoiceActivityDetector::BuildFromWav(path, map) && map.Save(sidecar)) {
+            printf("OK   %s  %.0f%% speech, %zu segments\n", path.c_str(),
+                   100.0 * map.GetSpeechFrames() / map.GetTotalFrames(), map.GetSegments().size());
+            built++;
+        } else {
+            printf("FAIL %s\n", path.c_str());
+            failed++;
+        }
+    }
+    printf("\n%zu built, %zu already present, %zu failed\n", built, skipped, failed);
+    return failed ? 1 : 0;
+}
+
+static int PrintFile(const std::string& path) {
+    VoiceActivityMap map;
+    if (!LoadOrBuildVoiceMap(path, map)) { printf("Cannot analyse %s\n", path.c_str()); return 1; }
+    double rate = map.GetSampleRate();
+    for (const VoiceSegment& s : map.GetSegments()) {
+        printf("%9.2f - %9.2f s\n", s.start / rate, s.end / rate);
+    }
+    printf("\n%.0f%% speech (%.1f of %.1f s)\n", 100.0 * map.GetSpeechFrames() / map.GetTotalFrames(),
+           map.GetSpeechFrames() / rate, map.GetTotalFrames() / rate);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Self-test on synthetic audio
+// ---------------------------------------------------------------------------
+
+enum class Region { Silence, Speech, Music };
+
+struct Synthetic {
+    std::vector<int16_t> pcm;
+    std::vector<Region> truth;      // Per sample
+};
+
+// Alternating regions of line noise, voice-like syllables (harmonic buzz
+// with a wandering pitch, ~4 syllables/s) and a sustained hold-music chord
+static Synthetic Synthesize(uint32_t rate, double seconds) {
+    const double pi = 3.14159265358979323846;
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+
+    Synthetic out;
+    size_t total = (size_t)(rate * seconds);
+    out.pcm.reserve(total);
+    out.truth.reserve(total);
+
+    const Region pattern[] = { Region::Silence, Region::Speech, Region::Silence, Region::Music,
+                               Region::Speech, Region::Silence, Region::Speech, Region::Music };
+    size_t patternIndex = 0;
+    double phase = 0.0;
+    while (out.pcm.size() < total) {
+        Region region = pattern[patternIndex++ % (sizeof(pattern) / sizeof(pattern[0]))];
+        size_t len = (size_t)(rate * (3.0 + 6.0 * uni(rng)));
+        double syllableRate = 3.0 + 2.0 * uni(rng);
+        double basePitch = 100.0 + 120.0 * uni(rng);
+        double chord[3] = { 220.0 * (1.0 + uni(rng)), 0, 0 };
+        chord[1] = chord[0] * 1.25;
+        chord[2] = chord[0] * 1.5;
+
+        for (size_t i = 0; i < len && out.pcm.size() < total; i++) {
+            double t = (double)i / rate;
+            double s = 0.0003 * noise(rng);   // ~-70 dBFS line noise everywhere
+            if (region == Region::Speech) {
+                double pitch = basePitch * (1.0 + 0.1 * std::sin(2.0 * pi * 0.5 * t));
+                phase += pitch / rate;
+                double voiced = 0.0;
+                for (int h = 1; h <= 10; h++) voiced += std::sin(2.0 * pi * h * phase) / h;
+                double syllable = std::pow(std::max(0.0, std::sin(pi * syllableRate * t)), 2.0);
+                s += 0.2 * voiced * syllable + 0.01 * syllable * noise(rng);
+            } else if (region == Region::Music) {
+                for (double f : chord) s += 0.08 * std::sin(2.0 * pi * f * t);
+            }
+            s = std::max(-1.0, std::min(1.0, s));
+            out.pcm.push_back((int16_t)(s * 32767.0));
+            out.truth.push_back(region);
+        }
+    }
+    return out;
+}
+
+static int SelfTest() {
+    const uint32_t rate = 48000;
+    const double seconds = 600.0;
+    Synthetic input = Synthesize(rate, seconds);
+    printf("synthetic: %.0f s at %u Hz mono (speech / line noise / hold music)\n\n", seconds, rate);
+
+    // Inline cost, fed the way the recorder's mixer feeds it (2 s chunks)
+    VoiceActivityDetector detector;
+    detector.Start(rate, 1);
+    const size_t chunk = rate * 2;
+    Clock::time_point t = Clock::now();
+    for (size_t pos = 0; pos < input.pcm.size(); pos += chunk) {
+        detector.AddPcm16(input.pcm.data() + pos, std::min(chunk, input.pcm.size() - pos));
+    }
+    double inlineMs = std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+    t = Clock::now();
+    VoiceActivityMap map = detector.Finish();
+    double finishMs = std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+
+    printf("inline:  %.1f ms for %.0f s  (%.2f ns/sample, %.4f%% of one core in real time)\n",
+           inlineMs, seconds, inlineMs * 1e6 / input.pcm.size(), inlineMs / (seconds * 1000.0) * 100.0);
+    printf("finish:  %.2f ms  (%zu segments)\n\n", finishMs, map.GetSegments().size());
+
+    // Frame accuracy. Hangover is intended, so non-speech within 500 ms
+    // after speech is not counted against the detector.
+    uint64_t speech = 0, speechHit = 0, other = 0, otherHit = 0, musicFrames = 0, musicHit = 0;
+    const uint64_t grace = rate / 2;
+    uint64_t lastSpeech = UINT64_MAX;
+    for (uint64_t i = 0; i < input.truth.size(); i++) {
+        bool detected = map.IsSpeech(i);
+        if (input.truth[i] == Region::Speech) {
+            speech++;
+            speechHit += detected;
+            lastSpeech = i;
+            continue;
+        }
+        if (lastSpeech != UINT64_MAX && i - lastSpeech < grace) continue;
+        uint64_t nextSpeech = i;
+        while (nextSpeech < input.truth.size() && nextSpeech - i < grace / 5 && input.truth[nextSpeech] != Region::Speech) nextSpeech++;
+        if (nextSpeech - i < grace / 5 && nextSpeech < input.truth.size()) continue; // 100 ms lead-in
+        other++;
+        otherHit += !detected;
+        if (input.truth[i] == Region::Music) {
+            musicFrames++;
+            musicHit += !detected;
+        }
+    }
+
+    double recall = speech ? (double)speechHit / speech : 1.0;
+    double rejection = other ? (double)otherHit / other : 1.0;
+    double musicRejection = musicFrames ? (double)musicHit / musicFrames : 1.0;
+    printf("speech kept:          %6.2f%%  (target >= 95%%)\n", recall * 100.0);
+    printf("non-speech skipped:   %6.2f%%  (target >= 90%%)\n", rejection * 100.0);
+    printf("  of which hold music %6.2f%%\n", musicRejection * 100.0);
+
+    bool pass = recall >= 0.95 && rejection >= 0.90;
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    std::string root, file;
+    bool force = false, selfTest = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--file") == 0 && hasValue)   file = argv[++i];
+        else if (strcmp(arg, "--force") == 0)         force = true;
+        else if (strcmp(arg, "--selftest") == 0)      selfTest = true;
+        else if (arg[0] != '-' && root.empty())       root = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    if (selfTest) return SelfTest();
+    if (!file.empty()) return PrintFile(file);
+    if (root.empty()) { PrintUsage(); return 2; }
+    return BuildFolder(root, force);
+}
@@ -0,0 +1,136 @@
+// MicMute-S WAV read benchmark
+//
+// Compares the memory-mapped reader with plain stream reads on a real
+// recording: random seek latency (scrubbing) and sequential throughput
+// (peak building, transcoding, analysis). No Win32 dependencies:
+//
+//   Windows: see build.bat (wav_read_bench.exe)
+//   Linux:   g++ -std=c++17 -O2 -I src -o wav_read_bench
+//              src/tools/wav_read_bench.cpp src/audio/MappedWavReader.cpp src/core/mapped_file.cpp
+//              src/audio/WavMetadata.cpp
+//
+// Usage: wav_read_bench <recording.wav> [--seeks N] [--frames N]
+//
+// Run it twice: the first pass shows cold-cache numbers, the second warm.
+
+#include "audio/MappedWavReader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage() {
+    printf("Usage: wav_read_bench <recording.wav> [--seeks N] [--frames N]\n");
+}
+
+static double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Sum of the bytes read, so neither loop can be optimised away
+static uint64_t Checksum(const uint8_t* p, size_t len) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < len; i += 64) sum += p[i];
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    std::string path;
+    size_t seeks = 2000;
+    size_t framesPerSeek = 1024;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--seeks") == 0 && hasValue)       seeks = (size_t)atoi(argv[++i]);
+        else if (strcmp(arg, "--frames") == 0 && hasValue) framesPerSeek = (size_t)atoi(argv[++i]);
+        else if (arg[0] != '-' && path.empty())            path = arg;
+        else { PrintUsage(); return 2; }
+    }
+    if (path.empty() || seeks == 0 || framesPerSeek == 0) { PrintUsage(); return 2; }
+
+    Clock::time_point t = Clock::now();
+    MappedWavReader reader;
+    if (!reader.Open(path)) { printf("Cannot map %s\n", path.c_str()); return 1; }
+    double openMs = ElapsedMs(t);
+
+    const WavInfo& info = reader.GetInfo();
+    const uint64_t frames = reader.GetTotalFrames();
+    const size_t blockAlign = info.blockAlign;
+    const size_t chunkBytes = framesPerSeek * blockAlign;
+    if (frames <= framesPerSeek) { printf("Recording too short\n"); return 1; }
+
+    printf("%s: %.1f s, %u Hz, %u ch, %u-bit%s, %.1f MB of audio\n", path.c_str(),
+           (double)frames / info.sampleRate, info.sampleRate, info.channels, info.bitsPerSample,
+           reader.IsRf64() ? " (RF64)" : "", info.dataBytes / 1048576.0);
+    printf("open + parse (mapped): %.3f ms\n\n", openMs);
+
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> positions(seeks);
+    for (uint64_t& p : positions) p = rng() % (frames - framesPerSeek);
+
+    uint64_t sumStream = 0, sumMapped = 0;
+    std::vector<uint8_t> buffer(std::max<size_t>(chunkBytes, 1 << 20));
+
+    // Random seeks: stream seek + read vs touching the mapped span
+    {
+        std::ifstream file(path, std::ios::binary);
+        t = Clock::now();
+        for (uint64_t p : positions) {
+            file.seekg((std::streamoff)(info.dataOffset + p * blockAlign), std::ios::beg);
+            file.read(reinterpret_cast<char*>(buffer.data()), (std::streamsize)chunkBytes);
+            sumStream += Checksum(buffer.data(), chunkBytes);
+        }
+        double streamUs = ElapsedMs(t) * 1000.0 / seeks;
+
+        reader.SetAccessPattern(MappedFile::Access::Random);
+        t = Clock::now();
+        for (uint64_t p : positions) {
+            sumMapped += Checksum(reader.GetFrameBytes(p), chunkBytes);
+        }
+        double mappedUs = ElapsedMs(t) * 1000.0 / seeks;
+
+        printf("random seek + %zu frames (%zu seeks):\n", framesPerSeek, seeks);
+        printf("  stream  %8.2f us/seek\n", streamUs);
+        printf("  mapped  %8.2f us/seek\n\n", mappedUs);
+    }
+
+    // Sequential scan of the whole data chunk
+    {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg((std::streamoff)info.dataOffset, std::ios::beg);
+        uint64_t remaining = info.dataBytes;
+        t = Clock::now();
+        while (remaining > 0) {
+            size_t n = (size_t)std::min<uint64_t>(remaining, buffer.size());
+            if (!file.read(reinterpret_cast<char*>(buffer.data()), (std::streamsize)n)) break;
+            sumStream += Checksum(buffer.data(), n);
+            remaining -= n;
+        }
+        double streamMs = ElapsedMs(t);
+
+        reader.SetAccessPattern(MappedFile::Access::Sequential);
+        const uint8_t* data = reader.GetDataChunk();
+        const uint64_t step = buffer.size();
+        t = Clock::now();
+        for (uint64_t off = 0; off < info.dataBytes; off += step) {
+            size_t n = (size_t)std::min<uint64_t>(step, info.dataBytes - off);
+            reader.PrefetchFrames((off + step) / blockAlign, step * 4 / blockAlign);
+            sumMapped += Checksum(data + off, n);
+        }
+        double mappedMs = ElapsedMs(t);
+
+        double mb = info.dataBytes / 1048576.0;
+        printf("sequential scan:\n");
+        printf("  stream  %8.2f ms  (%.0f MB/s)\n", streamMs, mb / (streamMs / 1000.0));
+        printf("  mapped  %8.2f ms  (%.0f MB/s)\n", mappedMs, mb / (mappedMs / 1000.0));
+    }
+
+    return sumStream == sumMapped ? 0 : 1;
+}
@@ -10,6 +10,8 @@
 #include "network/http_server.h"
 #include "ui/ui_controls.h"
 #include "audio/WasapiRecorder.h"
+#include "ui/gdi_cache.h"
+#include "core/trace.h"
 #include <dwmapi.h>
 #include <cmath>
 #include <cstdio>
@@ -40,6 +42,22 @@ static int cpHoverItem = -1; // -1: None, 0: Mute, 1: RecStart, 2: RecStop, 3: F
 // Mini Mode
 static bool cpMiniMode = false;
 
+// Retained rendering: cached GDI objects and the last frame, plus where the
+// sections that change on their own (meters, status line) were drawn so a
+// timer tick can repaint just them
+static GdiCache cpGdi;
+static BackBuffer cpBuffer;
+static FrameStats cpFrameStats("ControlPanel");
+static RECT cpMeterRect = {}, cpMicArea = {}, cpSpkArea = {};
+static RECT cpStatusRect = {};
+static bool cpMeterValid = false, cpStatusValid = false;    // Section is in the current frame
+static bool cpDirtyMeter = false, cpDirtyStatus = false;    // Invalidated by TickControlPanel
+static uint32_t cpMeterDrawn = 0;       // Signature of the bars in the back buffer
+static std::string cpStatusDrawn;       // Text + colour of the status line in the back buffer
+static uint32_t cpStateDrawn = 0;       // GetPanelState() at the last full paint
+static std::string cpStatsDrawn;
+static ULONGLONG cpStatsCheckTime = 0;
+
 
 // Notification for saved recordings
 static std::string cpLastSavedFile;
@@ -233,18 +251,17 @@ static void DrawMuteButton(HDC hdc, RECT area, bool isMuted) {
 
     // Outer glow ring
     COLORREF glowColor = isMuted ? RGB(255, 50, 50) : RGB(50, 220, 80);
-    HPEN glowPen = CreatePen(PS_SOLID, 2, glowColor);
+    HPEN glowPen = cpGdi.Pen(PS_SOLID, 2, glowColor);
     HPEN oldPen = (HPEN)SelectObject(hdc, glowPen);
     HBRUSH oldBr = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
     Ellipse(hdc, cx - radius - 2, cy - radius - 2, cx + radius + 2, cy + radius + 2);
     SelectObject(hdc, oldPen);
     SelectObject(hdc, oldBr);
-    DeleteObject(glowPen);
 
     // Filled circle background
     COLORREF fillColor = isMuted ? RGB(180, 30, 30) : RGB(30, 160, 60);
-    HBRUSH fillBr = CreateSolidBrush(fillColor);
-    HPEN borderPen = CreatePen(PS_SOLID, 1, glowColor);
+    HBRUSH fillBr = cpGdi.Brush(fillColor);
+    HPEN borderPen = cpGdi.Pen(PS_SOLID, 1, glowColor);
     SelectObject(hdc, fillBr);
     SelectObject(hdc, borderPen);
     Ellipse(hdc, cx - radius, cy - radius, cx + radius, cy + radius);
@@ -267,8 +284,6 @@ static void DrawMuteButton(HDC hdc, RECT area, bool isMuted) {
     // Cleanup
     SelectObject(hdc, GetStockObject(BLACK_PEN));
     SelectObject(hdc, GetStockObject(NULL_BRUSH));
-    DeleteObject(fillBr);
-    DeleteObject(borderPen);
 
     if (cpHoverItem == 0) {
         // Tooltip
@@ -279,52 +294,201 @@ static void DrawMuteButton(HDC hdc, RECT area, bool isMuted) {
     }
 }
 
-// Draw mini waveform inline
-static void DrawMiniWaveform(HDC hdc, RECT area, float* history, int histIndex, bool isMuted, 
-                              COLORREF colorLow, COLORREF colorHigh) {
-    int centerY = (area.top + area.bottom) / 2;
-    int height = area.bottom - area.top;
-    int maxHalf = height / 2 - 3;
+// Bar heights (half extents, pixels) for one meter; history is oldest first from histIndex
+static void ComputeMeterBars(const float* history, int histIndex, bool isMuted, int maxHalf,
+                             float* display, int* half) {
+    const float minDb = -48.0f;
+    for (int i = 0; i < (int)LEVEL_HISTORY_SIZE; i++) {
+        float raw = history[(histIndex + i) % LEVEL_HISTORY_SIZE];
+        float d = 0.0f;
+        if (raw > 0.0f) {
+            float db = 20.0f * log10f(raw);
+            if (db < minDb) db = minDb;
+            d = (db - minDb) / (0.0f - minDb);
+        }
+        if (d < 0.0f) d = 0.0f;
+        if (d > 1.0f) d = 1.0f;
+        if (isMuted) d = 0.0f;
+        display[i] = d;
+        half[i] = (int)(d * maxHalf);
+    }
+}
 
-    // Center line
-    HPEN gridPen = CreatePen(PS_DOT, 1, RGB(40, 40, 55));
-    SelectObject(hdc, gridPen);
-    MoveToEx(hdc, area.left, centerY, nullptr);
-    LineTo(hdc, area.right, centerY);
-    DeleteObject(gridPen);
+// Draw mini waveform inline. The bars go straight into the back buffer's
+// pixels: one pass over the DIB instead of a pen and a LineTo per bar.
+static void DrawMiniWaveform(BackBuffer& buffer, RECT area, const float* display, const int* half,
+                             COLORREF colorLow, COLORREF colorHigh) {
+    uint32_t* pixels = buffer.GetPixels();
+    int bw = buffer.GetWidth(), bh = buffer.GetHeight();
+    if (!pixels) return;
+    GdiFlush();
 
-    float stepX = (float)(area.right - area.left) / (float)(LEVEL_HISTORY_SIZE - 1);
+    int centerY = (area.top + area.bottom) / 2;
+    int left = max((int)area.left, 0), right = min((int)area.right, bw);
+    if (centerY < 0 || centerY >= bh) return;
+
+    // Center line, dotted (3 on, 3 off like PS_DOT)
+    const uint32_t grid = 0x282837;     // RGB(40, 40, 55)
+    uint32_t* row = pixels + (size_t)centerY * bw;
+    for (int x = left; x < right; x++) {
+        if (((x - area.left) / 3) % 2 == 0) row[x] = grid;
+    }
 
+    float stepX = (float)(area.right - area.left) / (float)(LEVEL_HISTORY_SIZE - 1);
     for (int i = 0; i < (int)LEVEL_HISTORY_SIZE; i++) {
-        int bufIdx = (histIndex + i) % LEVEL_HISTORY_SIZE;
-        float raw = history[bufIdx];
+        if (half[i] <= 0) continue;
+        int x = area.left + (int)(i * stepX);      // The last bar sits on area.right
+        if (x < left || x > right || x >= bw) continue;
+
+        float d = display[i];
+        uint32_t r = (uint32_t)(GetRValue(colorLow) + (GetRValue(colorHigh) - GetRValue(colorLow)) * d);
+        uint32_t g = (uint32_t)(GetGValue(colorLow) + (GetGValue(colorHigh) - GetGValue(colorLow)) * d);
+        uint32_t b = (uint32_t)(GetBValue(colorLow) + (GetBValue(colorHigh) - GetBValue(colorLow)) * d);
+        uint32_t col = (r << 16) | (g << 8) | b;
+
+        int y0 = max(centerY - half[i], 0), y1 = min(centerY + half[i], bh);
+        uint32_t* px = pixels + (size_t)y0 * bw + x;
+        for (int y = y0; y < y1; y++, px += bw) *px = col;
+    }
+}
 
-        float display = 0.0f;
-        float minDb = -48.0f;
-        if (raw > 0.0f) {
-            float db = 20.0f * log10f(raw);
-            if (db < minDb) db = minDb;
-            display = (db - minDb) / (0.0f - minDb);
+// FNV-1a over the bar heights of both meters
+static uint32_t HashMeterBars(const int* mic, const int* spk) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < LEVEL_HISTORY_SIZE; i++) {
+        h = (h ^ (uint32_t)mic[i]) * 16777619u;
+        h = (h ^ (uint32_t)spk[i]) * 16777619u;
+    }
+    return h;
+}
+
+static int MeterMaxHalf(const RECT& area) {
+    return (area.bottom - area.top) / 2 - 3;
+}
+
+// What the voice meter would draw now; equal signatures mean identical bars
+// (a silent or muted meter stays the same while the history scrolls)
+static uint32_t GetMeterSignature(bool isMuted) {
+    float display[LEVEL_HISTORY_SIZE];
+    int mic[LEVEL_HISTORY_SIZE], spk[LEVEL_HISTORY_SIZE];
+    ComputeMeterBars(levelHistory.data(), levelHistoryIndex, isMuted, MeterMaxHalf(cpMicArea), display, mic);
+    ComputeMeterBars(speakerLevelHistory.data(), levelHistoryIndex, false, MeterMaxHalf(cpSpkArea), display, spk);
+    return HashMeterBars(mic, spk);
+}
+
+// Section 2: both meters and their labels, background included so it can be
+// redrawn on its own over the previous frame
+static void DrawVoiceMeter(HDC mem, bool isMuted) {
+    FillRect(mem, &cpMeterRect, cpGdi.Brush(colorPanelBg));
+
+    float micDisplay[LEVEL_HISTORY_SIZE], spkDisplay[LEVEL_HISTORY_SIZE];
+    int mic[LEVEL_HISTORY_SIZE], spk[LEVEL_HISTORY_SIZE];
+    ComputeMeterBars(levelHistory.data(), levelHistoryIndex, isMuted, MeterMaxHalf(cpMicArea), micDisplay, mic);
+    ComputeMeterBars(speakerLevelHistory.data(), levelHistoryIndex, false, MeterMaxHalf(cpSpkArea), spkDisplay, spk);
+    DrawMiniWaveform(cpBuffer, cpMicArea, micDisplay, mic, RGB(0, 255, 0), RGB(255, 255, 0));
+    DrawMiniWaveform(cpBuffer, cpSpkArea, spkDisplay, spk, RGB(0, 200, 255), RGB(0, 100, 255));
+    cpMeterDrawn = HashMeterBars(mic, spk);
+
+    // Labels
+    SetTextColor(mem, RGB(120, 120, 140));
+    SelectObject(mem, hFontSmall);
+    RECT lblMic = {cpMicArea.left + 2, 1, cpMicArea.right, 14};
+    DrawText(mem, "MIC", -1, &lblMic, DT_LEFT | DT_TOP | DT_SINGLELINE);
+    RECT lblSpk = {cpSpkArea.left + 2, cpSpkArea.top - 1, cpSpkArea.right, cpSpkArea.top + 12};
+    DrawText(mem, "SPK", -1, &lblSpk, DT_LEFT | DT_TOP | DT_SINGLELINE);
+}
+
+// Section 3 content: the status line and its optional dot
+struct RecStatus {
+    std::string text;
+    COLORREF color = 0;
+    int dotX = -1;          // Dot offset from the left of the section, -1 for none
+    COLORREF dotColor = 0;
+};
+
+static RecStatus GetRecStatus() {
+    RecStatus st;
+    ULONGLONG now = GetTickCount64();
+    bool showingSaved = (cpSavedNotifyTime > 0 && (now - cpSavedNotifyTime) < SAVED_NOTIFY_MS);
+
+    if (showingSaved) {
+        st.color = RGB(100, 255, 120);
+        st.text = "Saved: " + cpLastSavedFile;
+    }
+    else if (g_CallRecorder && g_CallRecorder->IsEnabled() &&
+             g_CallRecorder->GetState() == CallAutoRecorder::State::RECORDING) {
+        // Pulse on the clock, not per paint, now that frames are skipped
+        cpAnimFrame = (int)((now / 50) % 3);
+        int pulse = 180 + (cpAnimFrame * 25);
+        st.color = RGB(pulse, 55, 55);
+        const char* dots[] = {"●  ", " ● ", "  ●"};
+
+        ULONGLONG ms = g_CallRecorder->GetRecordingDuration();
+        int seconds = (int)((ms / 1000) % 60);
+        int minutes = (int)((ms / 1000) / 60);
+        char timeBuf[32];
+        sprintf_s(timeBuf, "Rec %02d:%02d", minutes, seconds);
+        st.text = std::string(dots[cpAnimFrame]) + timeBuf;
+    }
+    else if (IsManualRecording()) {
+        if (IsManualPaused()) { // Fix for manual timer if needed later
+            st.color = RGB(255, 200, 0);
+            st.text = "⏸ Paused";
+        } else {
+            st.color = RGB(255, 70, 70);
+
+            // Get manual duration
+            WasapiRecorder* pRec = GetManualRecorder();
+            int totalSec = 0;
+            if (pRec) totalSec = (int)pRec->GetDurationSeconds();
+
+            char timeBuf[32];
+            sprintf_s(timeBuf, "Rec %02d:%02d", totalSec / 60, totalSec % 60);
+            st.text = "● " + std::string(timeBuf);
         }
-        if (display < 0.0f) display = 0.0f;
-        if (display > 1.0f) display = 1.0f;
-        if (isMuted) display = 0.0f;
-
-        int half = (int)(display * maxHalf);
-
-        int r = (int)(GetRValue(colorLow) + (GetRValue(colorHigh) - GetRValue(colorLow)) * display);
-        int g = (int)(GetGValue(colorLow) + (GetGValue(colorHigh) - GetGValue(colorLow)) * display);
-        int b = (int)(GetBValue(colorLow) + (GetBValue(colorHigh) - GetBValue(colorLow)) * display);
-        COLORREF col = isMuted ? RGB(35, 35, 45) : RGB(r, g, b);
-
-        HPEN lp = CreatePen(PS_SOLID, 1, col);
-        HPEN op = (HPEN)SelectObject(hdc, lp);
-        int x = area.left + (int)(i * stepX);
-        MoveToEx(hdc, x, centerY - half, nullptr);
-        LineTo(hdc, x, centerY + half);
-        SelectObject(hdc, op);
-        DeleteObject(lp);
     }
+    else if (g_CallRecorder && g_CallRecorder->IsEnabled()) {
+        if (IsExtensionConnected()) {
+            st.color = RGB(100, 180, 255);
+            st.text = "Auto: Ready";
+            st.dotX = 70;
+            st.dotColor = RGB(50, 220, 80);      // Green status dot
+        } else {
+            st.color = RGB(255, 165, 60);
+            st.text = "Waiting Ext...";
+            st.dotX = 80;
+            st.dotColor = RGB(255, 100, 50);     // Red/Orange status dot
+        }
+    } else {
+        st.color = colorTextDim;
+        st.text = "Idle";
+    }
+    return st;
+}
+
+static std::string GetStatusSignature(const RecStatus& st) {
+    return st.text + '\x1f' + std::to_string(st.color) + '\x1f' + std::to_string(st.dotX);
+}
+
+static void DrawRecStatus(HDC mem, RECT statusRect) {
+    RecStatus st = GetRecStatus();
+    FillRect(mem, &statusRect, cpGdi.Brush(colorPanelBg));
+
+    SelectObject(mem, hFontSmall);
+    SetTextColor(mem, st.color);
+    DrawText(mem, st.text.c_str(), -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT | DT_END_ELLIPSIS);
+    if (st.dotX >= 0) {
+        RECT rcDot = {statusRect.left + st.dotX, statusRect.top + 8, statusRect.left + st.dotX + 6, statusRect.top + 14};
+        FillRect(mem, &rcDot, cpGdi.Brush(st.dotColor));
+    }
+    cpStatusDrawn = GetStatusSignature(st);
+}
+
+// Everything else on the panel that can change without a settings change
+// or mouse input (those repaint the whole panel themselves)
+static uint32_t GetPanelState() {
+    return (IsDefaultMicMuted() ? 1u : 0u) | (IsManualRecording() ? 2u : 0u) | (IsManualPaused() ? 4u : 0u) |
+           (IsExtensionConnected() ? 8u : 0u) | (g_CallRecorder && g_CallRecorder->IsEnabled() ? 16u : 0u);
 }
 
 // Get today's stats string
@@ -337,9 +501,14 @@ static std::string GetCallStatsString() {
     char dateBuf[32];
     strftime(dateBuf, sizeof(dateBuf), "%d %b", &tm);
 
-    int count = g_CallRecorder->GetTodayCallCount();
-    char buf[64];
-    sprintf_s(buf, "%s: %d call%s", dateBuf, count, count == 1 ? "" : "s");
+    DayCallStats stats = g_CallRecorder->GetTodayStats();
+    char buf[96];
+    if (stats.calls > 0) {
+        sprintf_s(buf, "%s: %d call%s, %llum talk", dateBuf, stats.calls, stats.calls == 1 ? "" : "s",
+                  (unsigned long long)(stats.talkSeconds / 60));
+    } else {
+        sprintf_s(buf, "%s: 0 calls", dateBuf);
+    }
     return std::string(buf);
 }
 
@@ -389,26 +558,74 @@ void CreateControlPanel(HINSTANCE hInstance) {
     }
 }
 
+// Resize if content changed
+static void FitControlPanelToContent() {
+    int w, h;
+    RECT r; GetWindowRect(hControlPanel, &r);
+    float scale = GetWindowScale(hControlPanel);
+    GetPanelDimensions(panelSizeMode, scale, &w, &h);
+
+    if (r.right - r.left != w || r.bottom - r.top != h) {
+         // Center horizontally? Or keep left/right?
+         // Usually center.
+         int currentCenterX = (r.left + r.right) / 2;
+         int newLeft = currentCenterX - w / 2;
+         SetWindowPos(hControlPanel, nullptr, newLeft, r.top, w, h, SWP_NOZORDER);
+    }
+}
+
 void UpdateControlPanel() {
     if (hControlPanel && IsWindowVisible(hControlPanel)) {
-        // Resize if content changed
-        int w, h;
-        RECT r; GetWindowRect(hControlPanel, &r);
-        float scale = GetWindowScale(hControlPanel);
-        GetPanelDimensions(panelSizeMode, scale, &w, &h);
-        
-        if (r.right - r.left != w || r.bottom - r.top != h) {
-             // Center horizontally? Or keep left/right? 
-             // Usually center.
-             int currentCenterX = (r.left + r.right) / 2;
-             int newLeft = currentCenterX - w / 2;
-             SetWindowPos(hControlPanel, nullptr, newLeft, r.top, w, h, SWP_NOZORDER);
-        }
-        
+        FitControlPanelToContent();
         InvalidateRect(hControlPanel, nullptr, FALSE);
     }
 }
 
+void TickControlPanel() {
+    if (!hControlPanel || !IsWindowVisible(hControlPanel)) return;
+    FitControlPanelToContent();
+
+    bool full = GetPanelState() != cpStateDrawn;
+    ULONGLONG now = GetTickCount64();
+    if (!full && isDevModeEnabled && showCallStats && !cpMiniMode && now - cpStatsCheckTime >= 1000) {
+        cpStatsCheckTime = now;
+        full = GetCallStatsString() != cpStatsDrawn;
+    }
+    if (full) {
+        InvalidateRect(hControlPanel, nullptr, FALSE);
+        return;
+    }
+
+    bool dirty = false;
+    if (cpMeterValid && GetMeterSignature(IsDefaultMicMuted()) != cpMeterDrawn) {
+        cpDirtyMeter = true;
+        InvalidateRect(hControlPanel, &cpMeterRect, FALSE);
+        dirty = true;
+    }
+    if (cpStatusValid && GetStatusSignature(GetRecStatus()) != cpStatusDrawn) {
+        cpDirtyStatus = true;
+        InvalidateRect(hControlPanel, &cpStatusRect, FALSE);
+        dirty = true;
+    }
+    if (!dirty) cpFrameStats.Skip();
+}
+
+FrameStats::Report GetControlPanelFrameStats() {
+    return cpFrameStats.GetLastReport();
+}
+
+// The update region is covered by the sections TickControlPanel marked
+// dirty, so the rest of the previous frame is still correct
+static bool IsSectionPaint(const RECT& rcPaint) {
+    RECT covered = {};
+    if (cpDirtyMeter && cpMeterValid) UnionRect(&covered, &covered, &cpMeterRect);
+    if (cpDirtyStatus && cpStatusValid) UnionRect(&covered, &covered, &cpStatusRect);
+    if (IsRectEmpty(&covered)) return false;
+    RECT both;
+    UnionRect(&both, &covered, &rcPaint);
+    return EqualRect(&both, &covered) != 0;
+}
+
 void SetControlPanelSavedStatus(const std::string& filename) {
     cpLastSavedFile = filename;
     cpSavedNotifyTime = GetTickCount64();
@@ -421,34 +638,53 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             return 1;
 
         case WM_PAINT: {
+            TRACE_SCOPE(PaintControlPanel);
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hWnd, &ps);
             RECT rect;
             GetClientRect(hWnd, &rect);
 
-            // Double buffer
-            HDC mem = CreateCompatibleDC(hdc);
-            HBITMAP bmp = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-            HBITMAP oldBmp = (HBITMAP)SelectObject(mem, bmp);
+            cpFrameStats.Begin();
+
+            // Persistent back buffer; it keeps the last frame between paints
+            bool recreated = false;
+            HDC mem = cpBuffer.Begin(hdc, rect.right, rect.bottom, &recreated);
+            if (!mem) {
+                EndPaint(hWnd, &ps);
+                return 0;
+            }
+            cpGdi.Trim();
+            bool isMuted = IsDefaultMicMuted();
+
+            // Only the meter and/or status line changed: redraw those
+            // sections over the previous frame and present just them
+            if (!recreated && IsSectionPaint(ps.rcPaint)) {
+                if (cpDirtyMeter) DrawVoiceMeter(mem, isMuted);
+                if (cpDirtyStatus) DrawRecStatus(mem, cpStatusRect);
+                cpDirtyMeter = cpDirtyStatus = false;
+                cpBuffer.Present(hdc, ps.rcPaint);
+                EndPaint(hWnd, &ps);
+                cpFrameStats.End(true);
+                return 0;
+            }
+            cpDirtyMeter = cpDirtyStatus = false;
+            cpMeterValid = cpStatusValid = false;
+            cpStateDrawn = GetPanelState();
+            cpStatsDrawn.clear();
 
             // Background
-            HBRUSH bgBr = CreateSolidBrush(colorPanelBg);
+            HBRUSH bgBr = cpGdi.Brush(colorPanelBg);
             FillRect(mem, &rect, bgBr);
-            DeleteObject(bgBr);
 
             // Border
-            HPEN borderPen = CreatePen(PS_SOLID, 1, colorPanelBorder);
+            HPEN borderPen = cpGdi.Pen(PS_SOLID, 1, colorPanelBorder);
             SelectObject(mem, borderPen);
             SelectObject(mem, GetStockObject(NULL_BRUSH));
             RoundRect(mem, 0, 0, rect.right, rect.bottom, 16, 16);
-            DeleteObject(borderPen);
-
-            SetBkMode(mem, TRANSPARENT);
 
             int margin = 8;
             int drawX = margin;
             int panelH = rect.bottom;
-            bool isMuted = IsDefaultMicMuted();
 
             // === Section 1: Mute Button ===
             if (showMuteBtn || cpMiniMode) { // Always show in mini mode (if enabled? assume yes or fallback)
@@ -467,41 +703,35 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 RECT rc = {drawX, 0, drawX + toggleW, panelH};
                 
                 if (cpHoverItem == 5) {
-                     HBRUSH hHover = CreateSolidBrush(RGB(50, 50, 65));
+                     HBRUSH hHover = cpGdi.Brush(RGB(50, 50, 65));
                      FillRect(mem, &rc, hHover);
-                     DeleteObject(hHover);
                 }
 
                 // Draw Arrow >
                 int cx = (rc.left + rc.right) / 2;
                 int cy = (rc.top + rc.bottom) / 2;
                 
-                HPEN arrowPen = CreatePen(PS_SOLID, 2, colorTextDim);
+                HPEN arrowPen = cpGdi.Pen(PS_SOLID, 2, colorTextDim);
                 SelectObject(mem, arrowPen);
                 
                 // > shape
                 MoveToEx(mem, cx - 3, cy - 5, nullptr);
                 LineTo(mem, cx + 2, cy);
                 LineTo(mem, cx - 3, cy + 5);
-                
-                DeleteObject(arrowPen);
-                
+
                 // Blit and return early
-                BitBlt(hdc, 0, 0, rect.right, rect.bottom, mem, 0, 0, SRCCOPY);
-                SelectObject(mem, oldBmp);
-                DeleteObject(bmp);
-                DeleteDC(mem);
+                cpBuffer.Present(hdc, rect);
                 EndPaint(hWnd, &ps);
+                cpFrameStats.End(false);
                 return 0;
             }
 
             // === Separator ===
             if (showMuteBtn && (showVoiceMeter || (isDevModeEnabled && (showRecStatus || showManualRec || showCallStats)))) {
-                HPEN sepPen = CreatePen(PS_SOLID, 1, colorPanelBorder);
+                HPEN sepPen = cpGdi.Pen(PS_SOLID, 1, colorPanelBorder);
                 SelectObject(mem, sepPen);
                 MoveToEx(mem, drawX, 6, nullptr);
                 LineTo(mem, drawX, panelH - 6);
-                DeleteObject(sepPen);
                 drawX += margin;
             }
 
@@ -510,109 +740,28 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 int meterW = 120;
                 int halfH = (panelH - 4) / 2;
 
-                RECT micArea = {drawX, 2, drawX + meterW, halfH};
-                RECT spkArea = {drawX, halfH + 2, drawX + meterW, panelH - 2};
-
-                DrawMiniWaveform(mem, micArea, levelHistory.data(), levelHistoryIndex, isMuted,
-                                  RGB(0, 255, 0), RGB(255, 255, 0));
-                DrawMiniWaveform(mem, spkArea, speakerLevelHistory.data(), levelHistoryIndex, false,
-                                  RGB(0, 200, 255), RGB(0, 100, 255));
-
-                // Labels
-                SetTextColor(mem, RGB(120, 120, 140));
-                SelectObject(mem, hFontSmall);
-                RECT lblMic = {drawX + 2, 1, drawX + meterW, 14};
-                DrawText(mem, "MIC", -1, &lblMic, DT_LEFT | DT_TOP | DT_SINGLELINE);
-                RECT lblSpk = {drawX + 2, halfH + 1, drawX + meterW, halfH + 14};
-                DrawText(mem, "SPK", -1, &lblSpk, DT_LEFT | DT_TOP | DT_SINGLELINE);
+                cpMicArea = {drawX, 2, drawX + meterW, halfH};
+                cpSpkArea = {drawX, halfH + 2, drawX + meterW, panelH - 2};
+                cpMeterRect = {drawX, 1, drawX + meterW + 1, panelH - 2};
+                DrawVoiceMeter(mem, isMuted);
+                cpMeterValid = true;
 
                 drawX += meterW + margin;
 
                 // Separator
-                HPEN sepPen2 = CreatePen(PS_SOLID, 1, colorPanelBorder);
+                HPEN sepPen2 = cpGdi.Pen(PS_SOLID, 1, colorPanelBorder);
                 SelectObject(mem, sepPen2);
                 MoveToEx(mem, drawX, 6, nullptr);
                 LineTo(mem, drawX, panelH - 6);
-                DeleteObject(sepPen2);
                 drawX += margin;
             }
 
             // === Section 3: Recording Status ===
             if (isDevModeEnabled && showRecStatus) {
                 int statusW = 140;
-                RECT statusRect = {drawX, 4, drawX + statusW, panelH - 4};
-
-                ULONGLONG now = GetTickCount64();
-                bool showingSaved = (cpSavedNotifyTime > 0 && (now - cpSavedNotifyTime) < SAVED_NOTIFY_MS);
-
-                SelectObject(mem, hFontSmall);
-
-                if (showingSaved) {
-                    SetTextColor(mem, RGB(100, 255, 120));
-                    std::string msg = "Saved: " + cpLastSavedFile;
-                    DrawText(mem, msg.c_str(), -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT | DT_END_ELLIPSIS);
-                }
-                else if (g_CallRecorder && g_CallRecorder->IsEnabled() &&
-                         g_CallRecorder->GetState() == CallAutoRecorder::State::RECORDING) {
-                    cpAnimFrame = (cpAnimFrame + 1) % 3;
-                    int pulse = 180 + (cpAnimFrame * 25);
-                    SetTextColor(mem, RGB(pulse, 55, 55));
-                    const char* dots[] = {"●  ", " ● ", "  ●"};
-                    
-                    ULONGLONG ms = g_CallRecorder->GetRecordingDuration();
-                    int seconds = (int)((ms / 1000) % 60);
-                    int minutes = (int)((ms / 1000) / 60);
-                    char timeBuf[32];
-                    sprintf_s(timeBuf, "Rec %02d:%02d", minutes, seconds);
-                    
-                    std::string msg = std::string(dots[cpAnimFrame]) + timeBuf;
-                    DrawText(mem, msg.c_str(), -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT);
-                }
-                else if (IsManualRecording()) {
-                    if (IsManualPaused()) { // Fix for manual timer if needed later
-                        SetTextColor(mem, RGB(255, 200, 0));
-                        DrawText(mem, "⏸ Paused", -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT);
-                    } else {
-                        SetTextColor(mem, RGB(255, 70, 70));
-                        
-                        // Get manual duration
-                        WasapiRecorder* pRec = GetManualRecorder();
-                        int totalSec = 0; 
-                        if (pRec) totalSec = (int)pRec->GetDurationSeconds();
-                        
-                        int minutes = totalSec / 60;
-                        int seconds = totalSec % 60;
-                        char timeBuf[32];
-                        sprintf_s(timeBuf, "Rec %02d:%02d", minutes, seconds);
-                        
-                        std::string msg = "● " + std::string(timeBuf);
-                        DrawText(mem, msg.c_str(), -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT); 
-                    }
-                }
-                else if (g_CallRecorder && g_CallRecorder->IsEnabled()) {
-                    if (IsExtensionConnected()) {
-                        SetTextColor(mem, RGB(100, 180, 255));
-                        DrawText(mem, "Auto: Ready", -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT);
-                        
-                        // Green status dot
-                        HBRUSH dotBr = CreateSolidBrush(RGB(50, 220, 80));
-                        RECT rcDot = {statusRect.left + 70, statusRect.top + 8, statusRect.left + 76, statusRect.top + 14};
-                        FillRect(mem, &rcDot, dotBr);
-                        DeleteObject(dotBr);
-                    } else {
-                        SetTextColor(mem, RGB(255, 165, 60));
-                        DrawText(mem, "Waiting Ext...", -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT);
-                        
-                        // Red/Orange status dot
-                        HBRUSH dotBr = CreateSolidBrush(RGB(255, 100, 50));
-                        RECT rcDot = {statusRect.left + 80, statusRect.top + 8, statusRect.left + 86, statusRect.top + 14};
-                        FillRect(mem, &rcDot, dotBr);
-                        DeleteObject(dotBr);
-                    }
-                } else {
-                    SetTextColor(mem, colorTextDim);
-                    DrawText(mem, "Idle", -1, &statusRect, DT_SINGLELINE | DT_VCENTER | DT_LEFT);
-                }
+                cpStatusRect = {drawX, 4, drawX + statusW, panelH - 4};
+                DrawRecStatus(mem, cpStatusRect);
+                cpStatusValid = true;
 
                 drawX += statusW + margin;
             }
@@ -629,11 +778,10 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                     bool recording = IsManualRecording();
                     bool paused = IsManualPaused();
 
-                    HBRUSH br = CreateSolidBrush(RGB(45, 45, 60));
+                    HBRUSH br = cpGdi.Brush(RGB(45, 45, 60));
                     FillRect(mem, &rc, br);
-                    DeleteObject(br);
 
-                    HBRUSH shapeBr = CreateSolidBrush(RGB(240, 240, 245));
+                    HBRUSH shapeBr = cpGdi.Brush(RGB(240, 240, 245));
                     int cx = (rc.left + rc.right) / 2;
                     int cy = (rc.top + rc.bottom) / 2;
 
@@ -664,23 +812,20 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                             DrawText(mem, "Rec", -1, &rcTip, DT_SINGLELINE | DT_CENTER | DT_VCENTER);
                         }
                     }
-                    DeleteObject(shapeBr);
                     drawX += btnW + 4;
                 }
 
                 // Stop button
                 {
                     RECT rc = {drawX, bY, drawX + btnW, bY + btnH};
-                    HBRUSH br = CreateSolidBrush(RGB(45, 45, 60));
+                    HBRUSH br = cpGdi.Brush(RGB(45, 45, 60));
                     FillRect(mem, &rc, br);
-                    DeleteObject(br);
 
                     int cx = (rc.left + rc.right) / 2;
                     int cy = (rc.top + rc.bottom) / 2;
                     RECT sq = {cx - 5, cy - 5, cx + 5, cy + 5};
-                    HBRUSH red = CreateSolidBrush(RGB(255, 70, 70));
+                    HBRUSH red = cpGdi.Brush(RGB(255, 70, 70));
                     FillRect(mem, &sq, red);
-                    DeleteObject(red);
                     drawX += btnW + margin;
                 }
             }
@@ -694,24 +839,21 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 // Folder button
                 {
                     RECT rc = {drawX, bY, drawX + btnW, bY + btnH};
-                    HBRUSH br = CreateSolidBrush(RGB(45, 45, 60));
+                    HBRUSH br = cpGdi.Brush(RGB(45, 45, 60));
                     if (cpHoverItem == 3) {
-                         DeleteObject(br);
-                         br = CreateSolidBrush(RGB(65, 65, 80));
+                         br = cpGdi.Brush(RGB(65, 65, 80));
                     }
                     FillRect(mem, &rc, br);
-                    DeleteObject(br);
 
                     int cx = (rc.left + rc.right) / 2;
                     int cy = (rc.top + rc.bottom) / 2;
                     
                     // Draw simple folder shape
-                    HBRUSH folderBr = CreateSolidBrush(RGB(200, 200, 220));
+                    HBRUSH folderBr = cpGdi.Brush(RGB(200, 200, 220));
                     RECT rBody = {cx - 7, cy - 4, cx + 7, cy + 6};
                     RECT rTab = {cx - 7, cy - 7, cx - 2, cy - 4};
                     FillRect(mem, &rBody, folderBr);
                     FillRect(mem, &rTab, folderBr);
-                    DeleteObject(folderBr);
                     
                     if (cpHoverItem == 3) { // Tooltip
                         SetTextColor(mem, colorTextDim);
@@ -726,28 +868,26 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
 
             // Separator check needs to allow for Folder button being present
             if (isDevModeEnabled && (showManualRec || autoRecordCalls) && showCallStats) {
-                 // Gradient Separator
-                for(int i=6; i<panelH-6; i++) {
-                    int alpha = 255 - abs(i - panelH/2) * 5;
-                    if(alpha < 0) alpha = 0;
-                    SetPixel(mem, drawX, i, RGB(60, 60, 80));
-                }
+                 // Separator
+                SelectObject(mem, cpGdi.Pen(PS_SOLID, 1, RGB(60, 60, 80)));
+                MoveToEx(mem, drawX, 6, nullptr);
+                LineTo(mem, drawX, panelH - 6);
                 drawX += margin;
             }
 
             // === Section 5: Call Stats ===
             if (isDevModeEnabled && showCallStats) {
                 std::string stats = GetCallStatsString();
+                cpStatsDrawn = stats;
                 if (!stats.empty()) {
                     // Stats badge
                     int badgeW = 100;
                     RECT badgeRect = {drawX, 4, drawX + badgeW, panelH - 4};
 
                     // Badge background
-                    HBRUSH badgeBr = CreateSolidBrush(RGB(35, 35, 50));
+                    HBRUSH badgeBr = cpGdi.Brush(RGB(35, 35, 50));
                     RECT badgeBg = {drawX, (panelH - 24) / 2, drawX + badgeW, (panelH + 24) / 2};
                     FillRect(mem, &badgeBg, badgeBr);
-                    DeleteObject(badgeBr);
 
                     SetTextColor(mem, colorAccent);
                     SelectObject(mem, hFontSmall);
@@ -759,11 +899,10 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             // === Section 6: Settings Button ===
             {
                 // Separator before Settings
-                HPEN sepPen = CreatePen(PS_SOLID, 1, colorPanelBorder);
+                HPEN sepPen = cpGdi.Pen(PS_SOLID, 1, colorPanelBorder);
                 SelectObject(mem, sepPen);
                 MoveToEx(mem, drawX, 6, nullptr);
                 LineTo(mem, drawX, panelH - 6);
-                DeleteObject(sepPen);
                 drawX += margin;
 
                 int btnW = 28;
@@ -771,19 +910,17 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 int bY = (panelH - btnH) / 2;
                 RECT rc = {drawX, bY, drawX + btnW, bY + btnH};
 
-                HBRUSH br = CreateSolidBrush(RGB(45, 45, 60));
+                HBRUSH br = cpGdi.Brush(RGB(45, 45, 60));
                 if (cpHoverItem == 4) {
-                    DeleteObject(br);
-                    br = CreateSolidBrush(RGB(65, 65, 85)); // Lighter on hover
+                    br = cpGdi.Brush(RGB(65, 65, 85)); // Lighter on hover
                 }
                 FillRect(mem, &rc, br);
-                DeleteObject(br);
 
                 // Draw a simple gear/cog or home icon
                 int cx = (rc.left + rc.right) / 2;
                 int cy = (rc.top + rc.bottom) / 2;
                 
-                HPEN gearPen = CreatePen(PS_SOLID, 2, colorText);
+                HPEN gearPen = cpGdi.Pen(PS_SOLID, 2, colorText);
                 SelectObject(mem, gearPen);
                 SelectObject(mem, GetStockObject(NULL_BRUSH));
                 
@@ -802,7 +939,6 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 }
                 
                 SelectObject(mem, GetStockObject(BLACK_PEN));
-                DeleteObject(gearPen);
 
                 drawX += btnW + margin;
             }
@@ -813,24 +949,21 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 int bY = (panelH - btnW) / 2;
                 RECT pRc = {drawX, bY, drawX + btnW, bY + btnW};
                 
-                HBRUSH pBr = CreateSolidBrush(RGB(45, 45, 60));
+                HBRUSH pBr = cpGdi.Brush(RGB(45, 45, 60));
                 if (cpHoverItem == 6) { // 6 for Player
-                    DeleteObject(pBr);
-                    pBr = CreateSolidBrush(RGB(65, 65, 85));
+                    pBr = cpGdi.Brush(RGB(65, 65, 85));
                 }
                 FillRect(mem, &pRc, pBr);
-                DeleteObject(pBr);
 
                 // Draw Play Icon (Triangle)
                 int pcx = (pRc.left + pRc.right) / 2;
                 int pcy = (pRc.top + pRc.bottom) / 2;
                 
-                HBRUSH playBr = CreateSolidBrush(colorText); // RGB(220, 220, 220)
+                HBRUSH playBr = cpGdi.Brush(colorText); // RGB(220, 220, 220)
                 POINT pts[3] = {{pcx - 3, pcy - 5}, {pcx - 3, pcy + 5}, {pcx + 5, pcy}};
                 HRGN rgn = CreatePolygonRgn(pts, 3, WINDING);
                 FillRgn(mem, rgn, playBr);
                 DeleteObject(rgn);
-                DeleteObject(playBr);
 
                 if (cpHoverItem == 6) { // Tooltip
                     SetTextColor(mem, colorTextDim);
@@ -846,27 +979,25 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             {
                  // Add a collapse button at the very end
                  // Separator
-                 HPEN sepPen = CreatePen(PS_SOLID, 1, colorPanelBorder);
+                 HPEN sepPen = cpGdi.Pen(PS_SOLID, 1, colorPanelBorder);
                  SelectObject(mem, sepPen);
                  MoveToEx(mem, drawX, 6, nullptr);
                  LineTo(mem, drawX, panelH - 6);
-                 DeleteObject(sepPen);
                  drawX += margin;
                  
                  int toggleW = 20;
                  RECT rc = {drawX, 0, drawX + toggleW, panelH};
                  
                  if (cpHoverItem == 5) {
-                     HBRUSH hHover = CreateSolidBrush(RGB(50, 50, 65));
+                     HBRUSH hHover = cpGdi.Brush(RGB(50, 50, 65));
                      FillRect(mem, &rc, hHover);
-                     DeleteObject(hHover);
                  }
                  
                  // Draw Arrow <
                 int cx = (rc.left + rc.right) / 2;
                 int cy = (rc.top + rc.bottom) / 2;
                 
-                HPEN arrowPen = CreatePen(PS_SOLID, 2, colorTextDim);
+                HPEN arrowPen = cpGdi.Pen(PS_SOLID, 2, colorTextDim);
                 SelectObject(mem, arrowPen);
                 
                 // < shape
@@ -874,17 +1005,13 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 LineTo(mem, cx - 3, cy);
                 LineTo(mem, cx + 2, cy + 5);
                 
-                DeleteObject(arrowPen);
             }
 
             // Blit
-            BitBlt(hdc, 0, 0, rect.right, rect.bottom, mem, 0, 0, SRCCOPY);
-
-            SelectObject(mem, oldBmp);
-            DeleteObject(bmp);
-            DeleteDC(mem);
+            cpBuffer.Present(hdc, rect);
 
             EndPaint(hWnd, &ps);
+            cpFrameStats.End(false);
             return 0;
         }
 
@@ -1176,6 +1303,10 @@ LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             ShowWindow(hWnd, SW_HIDE);
             return 0;
 
+        case WM_SHOWWINDOW:
+            RequestFrameSchedulerRefresh();
+            return DefWindowProc(hWnd, msg, wParam, lParam);
+
         default:
             return DefWindowProc(hWnd, msg, wParam, lParam);
     }
@@ -6,10 +6,13 @@
 
 #include <windows.h>
 #include <string>
+#include "ui/gdi_cache.h"
 
 // Control Panel Window
 void CreateControlPanel(HINSTANCE hInstance);
 void UpdateControlPanel();
+void TickControlPanel();    // Main timer: repaint only the sections that changed
+FrameStats::Report GetControlPanelFrameStats();
 void SetControlPanelSavedStatus(const std::string& filename);
 void LayoutControlPanel(HWND hWnd);
 LRESULT CALLBACK ControlPanelWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
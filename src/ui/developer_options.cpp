@@ -3,15 +3,20 @@
 #include "core/resource.h"
 #include "core/settings.h"
 #include "ui/ui.h"
+#include "core/trace.h"
+#include "core/startup_profiler.h"
 #include <dwmapi.h>
 #include <commctrl.h>
 #include <string>
+#include <cstdio>
 
 // Local IDs for this window
 #define ID_DEV_AUTO_REC      2001
 #define ID_DEV_MANUAL_BTN    2003
 #define ID_DEV_DELETE_LABEL  2004
 #define ID_DEV_DELETE_COMBO  2005
+#define ID_DEV_SAVE_TRACE    2006
+#define ID_DEV_STARTUP       2007
 
 static HWND hDevOptionsWnd = nullptr;
 
@@ -69,6 +74,16 @@ static LRESULT CALLBACK DeveloperOptionsWndProc(HWND hWnd, UINT msg, WPARAM wPar
             else if (autoDeleteDays == 90) comboIdx = 5;
             SendMessage(hCombo, CB_SETCURSEL, comboIdx, 0);
 
+            // Dump the trace rings (same JSON as POST /trace)
+            CreateWindow("BUTTON", "Save performance trace",
+                WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+                x, y + gap*3, 200, 28, hWnd, (HMENU)ID_DEV_SAVE_TRACE, hInst, nullptr);
+
+            // Time spent in each startup phase (same data as POST /startup)
+            CreateWindow("BUTTON", "Startup timeline",
+                WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+                x + 210, y + gap*3, 110, 28, hWnd, (HMENU)ID_DEV_STARTUP, hInst, nullptr);
+
             // Fonts
             if (hFontTitle) SendMessage(GetWindow(hWnd, GW_CHILD), WM_SETFONT, (WPARAM)hFontTitle, TRUE);
             if (hFontNormal) {
@@ -132,6 +147,7 @@ static LRESULT CALLBACK DeveloperOptionsWndProc(HWND hWnd, UINT msg, WPARAM wPar
                 // To apply instantly we might need to re-init
                 CleanupCallRecorder();
                 if (autoRecordCalls) InitCallRecorder();
+                RefreshFrameScheduler();
             }
             else if (id == ID_DEV_MANUAL_BTN && code == BN_CLICKED) {
                 bool isChecked = (SendMessage((HWND)lParam, BM_GETCHECK, 0, 0) == BST_CHECKED);
@@ -161,6 +177,24 @@ static LRESULT CALLBACK DeveloperOptionsWndProc(HWND hWnd, UINT msg, WPARAM wPar
                 }
                 SaveSettings();
             }
+            else if (id == ID_DEV_SAVE_TRACE && code == BN_CLICKED) {
+                char tempDir[MAX_PATH];
+                GetTempPathA(MAX_PATH, tempDir);
+                SYSTEMTIME st;
+                GetLocalTime(&st);
+                char path[MAX_PATH];
+                snprintf(path, sizeof(path), "%sMicMute-S-trace-%04d%02d%02d-%02d%02d%02d.json", tempDir,
+                         st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+                if (TraceWriteFile(path)) {
+                    std::string msg = std::string("Trace saved to:\n") + path + "\n\nOpen it in ui.perfetto.dev or chrome://tracing.";
+                    MessageBoxA(hWnd, msg.c_str(), "Performance trace", MB_OK | MB_ICONINFORMATION);
+                } else {
+                    MessageBoxA(hWnd, "Could not write the trace file.", "Performance trace", MB_OK | MB_ICONERROR);
+                }
+            }
+            else if (id == ID_DEV_STARTUP && code == BN_CLICKED) {
+                MessageBoxA(hWnd, StartupTimelineReport().c_str(), "Startup timeline", MB_OK | MB_ICONINFORMATION);
+            }
             break;
         }
 
@@ -0,0 +1,152 @@
+#include "ui/gdi_cache.h"
+#include <cstdio>
+
+// ─────────────────────────── GdiCache ────────────────────────────────────────
+
+HPEN GdiCache::Pen(int style, int width, COLORREF color) {
+    uint64_t key = ((uint64_t)(uint8_t)style << 56) | ((uint64_t)(uint16_t)width << 32) | color;
+    auto it = m_pens.find(key);
+    if (it != m_pens.end()) return it->second;
+    HPEN pen = CreatePen(style, width, color);
+    m_pens[key] = pen;
+    return pen;
+}
+
+HBRUSH GdiCache::Brush(COLORREF color) {
+    auto it = m_brushes.find(color);
+    if (it != m_brushes.end()) return it->second;
+    HBRUSH brush = CreateSolidBrush(color);
+    m_brushes[color] = brush;
+    return brush;
+}
+
+void GdiCache::Trim(size_t maxObjects) {
+    if (GetObjectCount() > maxObjects) Clear();
+}
+
+void GdiCache::Clear() {
+    for (auto& kv : m_pens) DeleteObject(kv.second);
+    for (auto& kv : m_brushes) DeleteObject(kv.second);
+    m_pens.clear();
+    m_brushes.clear();
+}
+
+// ─────────────────────────── BackBuffer ──────────────────────────────────────
+
+HDC BackBuffer::Begin(HDC target, int w, int h, bool* recreated) {
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+    bool fresh = false;
+    if (!m_dc) {
+        m_dc = CreateCompatibleDC(target);
+        fresh = true;
+    }
+    if (!m_bitmap || w != m_width || h != m_height) {
+        BITMAPINFO bmi = {};
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = w;
+        bmi.bmiHeader.biHeight = -h;    // Top-down
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+
+        void* bits = nullptr;
+        HBITMAP bitmap = CreateDIBSection(target, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+        if (!bitmap) {
+            OutputDebugStringA("[BackBuffer] CreateDIBSection failed\n");
+            return nullptr;
+        }
+        HGDIOBJ old = SelectObject(m_dc, bitmap);
+        if (m_bitmap) DeleteObject(m_bitmap);
+        else m_oldBitmap = old;
+        m_bitmap = bitmap;
+        m_pixels = (uint32_t*)bits;
+        m_width = w;
+        m_height = h;
+        fresh = true;
+    }
+
+    // Cached pens/brushes from the previous frame may still be selected
+    SelectObject(m_dc, GetStockObject(BLACK_PEN));
+    SelectObject(m_dc, GetStockObject(NULL_BRUSH));
+    SelectObject(m_dc, GetStockObject(DEFAULT_GUI_FONT));
+    SetBkMode(m_dc, TRANSPARENT);
+    SelectClipRgn(m_dc, nullptr);
+
+    if (recreated) *recreated = fresh;
+    return m_dc;
+}
+
+void BackBuffer::Present(HDC target, const RECT& rc) {
+    if (!m_dc) return;
+    BitBlt(target, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top, m_dc, rc.left, rc.top, SRCCOPY);
+}
+
+void BackBuffer::Release() {
+    if (m_dc) {
+        SelectObject(m_dc, GetStockObject(BLACK_PEN));
+        SelectObject(m_dc, GetStockObject(NULL_BRUSH));
+        SelectObject(m_dc, GetStockObject(DEFAULT_GUI_FONT));
+        if (m_oldBitmap) SelectObject(m_dc, m_oldBitmap);
+        DeleteDC(m_dc);
+    }
+    if (m_bitmap) DeleteObject(m_bitmap);
+    m_dc = nullptr;
+    m_bitmap = nullptr;
+    m_oldBitmap = nullptr;
+    m_pixels = nullptr;
+    m_width = m_height = 0;
+}
+
+// ─────────────────────────── FrameStats ──────────────────────────────────────
+
+static double CounterToUs(LONGLONG ticks) {
+    static LARGE_INTEGER freq = {};
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    return (double)ticks * 1e6 / (double)freq.QuadPart;
+}
+
+void FrameStats::Begin() {
+    QueryPerformanceCounter(&m_start);
+}
+
+void FrameStats::End(bool partial) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    double us = CounterToUs(now.QuadPart - m_start.QuadPart);
+    m_frames++;
+    if (partial) m_partial++;
+    m_totalUs += us;
+    if (us > m_maxUs) m_maxUs = us;
+    MaybeReport();
+}
+
+void FrameStats::Skip() {
+    m_skipped++;
+    MaybeReport();
+}
+
+void FrameStats::MaybeReport() {
+    ULONGLONG now = GetTickCount64();
+    if (m_windowStart == 0) { m_windowStart = now; return; }
+    ULONGLONG elapsed = now - m_windowStart;
+    if (elapsed < m_intervalMs) return;
+
+    Report r;
+    r.frames = m_frames;
+    r.partialFrames = m_partial;
+    r.skipped = m_skipped;
+    r.avgUs = m_frames ? m_totalUs / m_frames : 0.0;
+    r.maxUs = m_maxUs;
+    r.busyPercent = m_totalUs / ((double)elapsed * 1000.0) * 100.0;
+    m_last = r;
+
+    char debug[256];
+    sprintf_s(debug, "[%s] %u frames (%u partial), %u idle ticks, paint avg %.0f us max %.0f us, %.2f%% of UI thread\n",
+              m_name, r.frames, r.partialFrames, r.skipped, r.avgUs, r.maxUs, r.busyPercent);
+    OutputDebugStringA(debug);
+
+    m_windowStart = now;
+    m_frames = m_partial = m_skipped = 0;
+    m_totalUs = m_maxUs = 0.0;
+}
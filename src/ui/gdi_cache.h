@@ -0,0 +1,106 @@
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include <windows.h>
+#include <unordered_map>
+#include <cstdint>
+
+// Pens and brushes created once per colour and kept for the life of the
+// window, instead of CreatePen/DeleteObject around every draw call. Objects
+// handed out are owned by the cache: never DeleteObject them.
+class GdiCache {
+public:
+    GdiCache() = default;
+    ~GdiCache() { Clear(); }
+    GdiCache(const GdiCache&) = delete;
+    GdiCache& operator=(const GdiCache&) = delete;
+
+    // Same argument order as CreatePen / CreateSolidBrush
+    HPEN   Pen(int style, int width, COLORREF color);
+    HBRUSH Brush(COLORREF color);
+
+    // Drops everything once more than maxObjects are held (colours computed
+    // per frame). Only call while none of the objects is selected into a DC,
+    // e.g. right after BackBuffer::Begin.
+    void Trim(size_t maxObjects = 256);
+    void Clear();
+
+    size_t GetObjectCount() const { return m_pens.size() + m_brushes.size(); }
+
+private:
+    std::unordered_map<uint64_t, HPEN> m_pens;
+    std::unordered_map<COLORREF, HBRUSH> m_brushes;
+};
+
+// Persistent 32-bit top-down DIB back buffer. Recreated only when the
+// window size changes, so a frame costs the drawing plus one BitBlt of the
+// dirty rectangle. The pixels stay valid between frames, which is what lets
+// a window repaint one section and present just that.
+class BackBuffer {
+public:
+    BackBuffer() = default;
+    ~BackBuffer() { Release(); }
+    BackBuffer(const BackBuffer&) = delete;
+    BackBuffer& operator=(const BackBuffer&) = delete;
+
+    // Memory DC sized to w x h with stock pen/brush/font selected and a
+    // transparent background mode. `recreated` says the old pixels are gone
+    // and the whole frame must be drawn.
+    HDC Begin(HDC target, int w, int h, bool* recreated = nullptr);
+    void Present(HDC target, const RECT& rc);
+    void Release();
+
+    // Direct pixel access (0x00RRGGBB, rows top to bottom). Call GdiFlush()
+    // before touching pixels that GDI has just drawn to.
+    uint32_t* GetPixels() const { return m_pixels; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+private:
+    HDC m_dc = nullptr;
+    HBITMAP m_bitmap = nullptr;
+    HGDIOBJ m_oldBitmap = nullptr;
+    uint32_t* m_pixels = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+// Per-frame timing for a window's paint handler. Begin/End bracket WM_PAINT;
+// Skip counts timer ticks that found nothing to redraw. Every interval the
+// totals are written with OutputDebugStringA and kept as the last report.
+class FrameStats {
+public:
+    struct Report {
+        uint32_t frames = 0;        // Paints in the interval
+        uint32_t partialFrames = 0; // Of those, how many redrew only a section
+        uint32_t skipped = 0;       // Ticks with nothing dirty
+        double avgUs = 0.0;         // Mean paint time
+        double maxUs = 0.0;
+        double busyPercent = 0.0;   // Paint time / wall time
+    };
+
+    explicit FrameStats(const char* name, DWORD intervalMs = 10000) : m_name(name), m_intervalMs(intervalMs) {}
+
+    void Begin();
+    void End(bool partial);
+    void Skip();
+
+    Report GetLastReport() const { return m_last; }
+
+private:
+    void MaybeReport();
+
+    const char* m_name;
+    DWORD m_intervalMs;
+    LARGE_INTEGER m_start = {};
+    ULONGLONG m_windowStart = 0;
+    uint32_t m_frames = 0;
+    uint32_t m_partial = 0;
+    uint32_t m_skipped = 0;
+    double m_totalUs = 0.0;
+    double m_maxUs = 0.0;
+    Report m_last;
+};
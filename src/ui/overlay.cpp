@@ -84,11 +84,28 @@ void UpdateOverlay() {
         bool muted = IsDefaultMicMuted();
         animTarget = muted ? 1.0f : 0.0f;
         
-        // Start animation timer
-        SetTimer(hOverlayWnd, 3, 16, nullptr); // ~60 FPS
+        // Start the ~60 FPS animation task on the frame scheduler
+        WakeOverlayAnimation();
     }
 }
 
+// One animation frame; false once the overlay has settled on its target
+bool StepOverlayAnimation() {
+    if (!hOverlayWnd) return false;
+    float speed = 0.15f; // Adjust for speed
+    if (animProgress < animTarget) {
+        animProgress += speed;
+        if (animProgress > animTarget) animProgress = animTarget;
+    } else if (animProgress > animTarget) {
+        animProgress -= speed;
+        if (animProgress < animTarget) animProgress = animTarget;
+    }
+
+    InvalidateRect(hOverlayWnd, nullptr, TRUE);
+
+    return abs(animProgress - animTarget) >= 0.001f;
+}
+
 void UpdateMeter() {
     bool meterVisible = (hMeterWnd && IsWindowVisible(hMeterWnd));
     bool panelVisible = (hControlPanel && IsWindowVisible(hControlPanel));
@@ -124,26 +141,6 @@ LRESULT CALLBACK OverlayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
                  SWP_NOZORDER | SWP_NOACTIVATE);
              return 0;
         }
-        case WM_TIMER:
-            if (wParam == 3) {
-                // Animation logic
-                float speed = 0.15f; // Adjust for speed
-                if (animProgress < animTarget) {
-                    animProgress += speed;
-                    if (animProgress > animTarget) animProgress = animTarget;
-                } else if (animProgress > animTarget) {
-                    animProgress -= speed;
-                    if (animProgress < animTarget) animProgress = animTarget;
-                }
-                
-                InvalidateRect(hWnd, nullptr, TRUE);
-                
-                if (abs(animProgress - animTarget) < 0.001f) {
-                    KillTimer(hWnd, 3);
-                }
-            }
-            return 0;
-
         case WM_PAINT: {
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hWnd, &ps);
@@ -246,6 +243,10 @@ LRESULT CALLBACK OverlayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
             ShowWindow(hWnd, SW_HIDE);
             return 0;
         
+        case WM_SHOWWINDOW:
+            RequestFrameSchedulerRefresh();
+            return DefWindowProc(hWnd, msg, wParam, lParam);
+
         default:
             return DefWindowProc(hWnd, msg, wParam, lParam);
     }
@@ -423,6 +424,10 @@ LRESULT CALLBACK MeterWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             ShowWindow(hWnd, SW_HIDE);
             return 0;
         
+        case WM_SHOWWINDOW:
+            RequestFrameSchedulerRefresh();
+            return DefWindowProc(hWnd, msg, wParam, lParam);
+
         default:
             return DefWindowProc(hWnd, msg, wParam, lParam);
     }
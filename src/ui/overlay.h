@@ -7,6 +7,7 @@
 void CreateOverlayWindow(HINSTANCE hInstance);
 void CreateMeterWindow(HINSTANCE hInstance);
 void UpdateOverlay();
+bool StepOverlayAnimation();     // Frame scheduler task, false when settled
 void UpdateMeter();
 
 LRESULT CALLBACK OverlayWndProc(HWND, UINT, WPARAM, LPARAM);
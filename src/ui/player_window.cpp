@@ -4,6 +4,17 @@
 #include "ui/player_window.h"
 #include "core/globals.h"
 #include "core/resource.h"
+#include "storage/recording_catalog.h"
+#include "storage/recording_list_model.h"
+#include "audio/PlaybackEngine.h"
+#include "audio/PeakPyramid.h"
+#include "audio/VoiceActivity.h"
+#include "audio/Spectrogram.h"
+#include "core/thread_pool.h"
+#include "ui/gdi_cache.h"
+#include "core/trace.h"
+#include "core/startup_profiler.h"
+#include "ui/ui.h"
 #include <windows.h>
 #include <windowsx.h>
 #include <dwmapi.h>
@@ -15,14 +26,12 @@
 #include <atomic>
 #include <fstream>
 #include <filesystem>
-#include <mmsystem.h>
 #include <iomanip>
 #include <sstream>
 #include <cmath>
 #include <cstdio>
 #include <mutex>
 
-#pragma comment(lib, "winmm.lib")
 #pragma comment(lib, "dwmapi.lib")
 
 // ── Dimensions ──────────────────────────────────────────────────────────────
@@ -31,7 +40,6 @@
 
 // ── Sub-control ID for the hidden search edit ──────────────────────────────
 #define IDC_EDIT_SEARCH  4001
-#define IDC_TIMER_POS    4002
 
 // ── Theme colours (derived from the global palette) ─────────────────────────
 static COLORREF cBg;
@@ -101,40 +109,64 @@ static DWORD  posCurMs   = 0;
 static DWORD  posTotalMs = 0;
 static float  volume     = 1.0f;     // 0..1
 
-// ── Recording list ──────────────────────────────────────────────────────────
-struct RecEntry {
-    std::string path;
-    std::string display;   // filename without extension
-    std::string dateStr;   // parent folder name (date)
-    DWORD       sizeKB;
-};
-static std::vector<RecEntry> recList;
+// Playback speed steps (pitch preserved), cycled by the speed button / [ ]
+static const double SPEED_STEPS[] = { 0.5, 0.75, 1.0, 1.25, 1.5, 1.75, 2.0, 2.5, 3.0 };
+static const int SPEED_STEP_COUNT = sizeof(SPEED_STEPS) / sizeof(SPEED_STEPS[0]);
+static int speedStep = 2;   // 1x
+
+// ── Recording list (virtualized view over the catalog) ──────────────────────
+static RecordingListModel recList(GetRecordingCatalog());
 static int  listScrollY  = 0;
 static int  listSelIdx    = -1;
 static int  listHoverIdx  = -1;
 static std::mutex listMtx;
 
-// ── Waveform visualiser (fake spectrum bars) ────────────────────────────────
+// ── Waveform visualiser (peaks of the loaded file) ──────────────────────────
 #define WAVE_BARS 40
 static float waveBars[WAVE_BARS] = {};
 static float waveTargets[WAVE_BARS] = {};
+static float wavePeaks[WAVE_BARS] = {};     // 0..1, normalised to the file's loudest column
+static bool  wavePeaksValid = false;
+static std::string wavePeaksPath;
+
+// ── Speech regions of the loaded file (from its .vad map) ──────────────────
+static std::vector<std::pair<DWORD, DWORD>> speechMs;   // [start, end) in ms
+static bool  speechValid = false;
+static std::string speechPath;
+static bool  skipSilence = false;   // Jump over non-speech while playing
+
+// ── Spectrogram (takes the waveform's place when shown) ────────────────────
+static SpectrogramCache spectro;
+static ThreadPool* spectroPool = nullptr;  // Created on first use
+static bool     showSpectro  = false;
+static uint32_t spectroLevel = 2;          // Zoom: BASE_HOP << level frames per pixel
+static std::atomic<bool> spectroPosted{false};
 
 // ── Hit-test zones (computed during paint) ──────────────────────────────────
 enum HitZone { HZ_NONE=0, HZ_PLAY, HZ_STOP, HZ_PREV, HZ_NEXT,
-               HZ_SEEK, HZ_VOL, HZ_SEARCH_BTN, HZ_LIST_ITEM, HZ_FOLDER };
+               HZ_SEEK, HZ_VOL, HZ_SPEED, HZ_SKIP, HZ_SEARCH_BTN, HZ_LIST_ITEM, HZ_FOLDER, HZ_SORT };
 static RECT rcPlay{}, rcStop{}, rcPrev{}, rcNext{};
-static RECT rcSeek{}, rcVol{}, rcSearchBtn{}, rcListArea{}, rcFolderBtn{};
+static RECT rcSeek{}, rcVol{}, rcSpeed{}, rcSkip{}, rcSearchBtn{}, rcListArea{}, rcFolderBtn{}, rcSortBtn{};
 static HitZone hoverZone = HZ_NONE;
 static bool seekDragging = false;
 static bool volDragging  = false;
 
 // ── Search state ────────────────────────────────────────────────────────────
-static std::string searchQuery;
-static std::mutex searchMtx;
 static std::string searchStatus;
 
+// ── Retained GDI state (pens, brushes and the back buffer live with the window)
+static GdiCache playerGdi;
+static BackBuffer playerBuffer;
+static FrameStats playerFrameStats("Player");
+
+// Position/waveform tick on the shared frame scheduler; idle while the
+// player is stopped or paused and the bars have settled
+static FrameScheduler::TaskId playerTask = 0;
+static bool playerTaskAdded = false;
+
 // ── Forward declarations ────────────────────────────────────────────────────
-static void UpdatePosition();
+static bool UpdatePosition();
+static void WakePlayerTick();
 static void PaintPlayer(HWND hWnd);
 static void LoadRecordingList();
 static void PlayFile(const std::string& path);
@@ -163,32 +195,30 @@ static void DrawTextCentered(HDC hdc, const char* txt, RECT rc, HFONT font, COLO
 // ── GDI icon drawing helpers (replace broken UTF-8 emoji) ─────────────────
 static void DrawPlayTriangle(HDC hdc, int cx, int cy, int sz, COLORREF col) {
     POINT pts[3] = {{cx - sz/3, cy - sz/2}, {cx - sz/3, cy + sz/2}, {cx + sz/2, cy}};
-    HBRUSH br = CreateSolidBrush(col);
+    HBRUSH br = playerGdi.Brush(col);
     HRGN rgn = CreatePolygonRgn(pts, 3, WINDING);
     FillRgn(hdc, rgn, br);
-    DeleteObject(rgn); DeleteObject(br);
+    DeleteObject(rgn);
 }
 
 static void DrawPauseIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HBRUSH br = CreateSolidBrush(col);
+    HBRUSH br = playerGdi.Brush(col);
     int bw = max(2, sz / 5);
     int gap = max(2, sz / 4);
     RECT r1 = {cx - gap - bw, cy - sz/2, cx - gap, cy + sz/2};
     RECT r2 = {cx + gap, cy - sz/2, cx + gap + bw, cy + sz/2};
     FillRect(hdc, &r1, br); FillRect(hdc, &r2, br);
-    DeleteObject(br);
 }
 
 static void DrawStopSquare(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HBRUSH br = CreateSolidBrush(col);
+    HBRUSH br = playerGdi.Brush(col);
     int half = sz / 3;
     RECT r = {cx - half, cy - half, cx + half, cy + half};
     FillRect(hdc, &r, br);
-    DeleteObject(br);
 }
 
 static void DrawPrevIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HBRUSH br = CreateSolidBrush(col);
+    HBRUSH br = playerGdi.Brush(col);
     // Bar on left
     int bw = max(2, sz / 6);
     RECT bar = {cx - sz/3 - bw, cy - sz/3, cx - sz/3, cy + sz/3};
@@ -197,11 +227,11 @@ static void DrawPrevIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
     POINT pts[3] = {{cx + sz/3, cy - sz/3}, {cx + sz/3, cy + sz/3}, {cx - sz/3, cy}};
     HRGN rgn = CreatePolygonRgn(pts, 3, WINDING);
     FillRgn(hdc, rgn, br);
-    DeleteObject(rgn); DeleteObject(br);
+    DeleteObject(rgn);
 }
 
 static void DrawNextIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HBRUSH br = CreateSolidBrush(col);
+    HBRUSH br = playerGdi.Brush(col);
     // Bar on right
     int bw = max(2, sz / 6);
     RECT bar = {cx + sz/3, cy - sz/3, cx + sz/3 + bw, cy + sz/3};
@@ -210,22 +240,21 @@ static void DrawNextIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
     POINT pts[3] = {{cx - sz/3, cy - sz/3}, {cx - sz/3, cy + sz/3}, {cx + sz/3, cy}};
     HRGN rgn = CreatePolygonRgn(pts, 3, WINDING);
     FillRgn(hdc, rgn, br);
-    DeleteObject(rgn); DeleteObject(br);
+    DeleteObject(rgn);
 }
 
 static void DrawSearchLens(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HPEN pen = CreatePen(PS_SOLID, 2, col);
+    HPEN pen = playerGdi.Pen(PS_SOLID, 2, col);
     HBRUSH nbr = (HBRUSH)GetStockObject(NULL_BRUSH);
     SelectObject(hdc, pen); SelectObject(hdc, nbr);
     int r = sz / 3;
     Ellipse(hdc, cx - r, cy - r, cx + r, cy + r);
     MoveToEx(hdc, cx + r - 1, cy + r - 1, nullptr);
     LineTo(hdc, cx + sz/2, cy + sz/2);
-    DeleteObject(pen);
 }
 
 static void DrawFolderIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HPEN pen = CreatePen(PS_SOLID, 1, col);
+    HPEN pen = playerGdi.Pen(PS_SOLID, 1, col);
     HBRUSH nbr = (HBRUSH)GetStockObject(NULL_BRUSH);
     SelectObject(hdc, pen); SelectObject(hdc, nbr);
     int hw = sz/2, hh = sz/3;
@@ -236,11 +265,10 @@ static void DrawFolderIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
     LineTo(hdc, cx - hw, cy - hh);
     LineTo(hdc, cx - hw/3, cy - hh);
     LineTo(hdc, cx, cy - hh + 2);
-    DeleteObject(pen);
 }
 
 static void DrawSpeakerIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HBRUSH br = CreateSolidBrush(col);
+    HBRUSH br = playerGdi.Brush(col);
     // Speaker body (small rect)
     int bw = sz/5, bh = sz/3;
     RECT body = {cx - sz/3, cy - bh/2, cx - sz/3 + bw, cy + bh/2};
@@ -251,18 +279,17 @@ static void DrawSpeakerIcon(HDC hdc, int cx, int cy, int sz, COLORREF col) {
     POINT cone[4] = {{cx - sz/3 + bw, cy - bh/2}, {cx - sz/3 + bw, cy + bh/2}, {cx, cy + sz/3}, {cx, cy - sz/3}};
     HRGN rgn = CreatePolygonRgn(cone, 4, WINDING);
     FillRgn(hdc, rgn, br);
-    DeleteObject(rgn); DeleteObject(br);
+    DeleteObject(rgn);
     // Sound waves
-    HPEN pen = CreatePen(PS_SOLID, 1, col);
+    HPEN pen = playerGdi.Pen(PS_SOLID, 1, col);
     SelectObject(hdc, pen);
     SelectObject(hdc, (HBRUSH)GetStockObject(NULL_BRUSH));
     Arc(hdc, cx+2, cy-sz/4, cx+sz/3+2, cy+sz/4, cx+sz/4, cy-sz/4, cx+sz/4, cy+sz/4);
-    DeleteObject(pen);
 }
 
 static void DrawMusicNote(HDC hdc, int cx, int cy, int sz, COLORREF col) {
-    HPEN pen = CreatePen(PS_SOLID, 2, col);
-    HBRUSH br = CreateSolidBrush(col);
+    HPEN pen = playerGdi.Pen(PS_SOLID, 2, col);
+    HBRUSH br = playerGdi.Brush(col);
     SelectObject(hdc, pen);
     // Stem
     MoveToEx(hdc, cx + 1, cy - sz/3, nullptr);
@@ -270,143 +297,212 @@ static void DrawMusicNote(HDC hdc, int cx, int cy, int sz, COLORREF col) {
     // Note head (small ellipse)
     SelectObject(hdc, br);
     Ellipse(hdc, cx - 2, cy + sz/6, cx + 3, cy + sz/3 + 1);
-    DeleteObject(pen); DeleteObject(br);
 }
 
-// ─────────────────────────── MCI Wrappers ────────────────────────────────────
-static void MCI_Close() {
-    mciSendStringA("close myAudio", nullptr, 0, nullptr);
+// ─────────────────────────── Playback engine ─────────────────────────────────
+// Created on first use. Callbacks arrive on the engine's decoder thread:
+// positions go through atomics, track changes are posted to the window.
+#define WM_PLAYER_TRACK_CHANGED (WM_USER + 20)
+#define WM_PLAYER_ENDED         (WM_USER + 21)
+#define WM_PLAYER_PEAKS         (WM_USER + 22)
+#define WM_PLAYER_SPEECH        (WM_USER + 23)
+#define WM_PLAYER_SPECTRO       (WM_USER + 24)
+
+// Result of a background peak load, owned by the message handler
+struct WavePeaksResult {
+    std::string path;
+    std::vector<float> peaks;
+};
+
+// Result of a background voice-activity load
+struct SpeechMapResult {
+    std::string path;
+    std::vector<std::pair<DWORD, DWORD>> ranges;
+};
+
+static PlaybackEngine* engine = nullptr;
+static std::atomic<DWORD> enginePosMs{0};
+static std::atomic<DWORD> engineTotalMs{0};
+
+static PlaybackEngine& GetEngine() {
+    if (!engine) {
+        engine = new PlaybackEngine();
+        PlaybackCallbacks cb;
+        cb.onPosition = [](const std::string&, uint64_t frame, uint64_t total, uint32_t rate) {
+            if (rate == 0) return;
+            enginePosMs   = (DWORD)(frame * 1000 / rate);
+            engineTotalMs = (DWORD)(total * 1000 / rate);
+        };
+        cb.onTrackChanged = [](const std::string& path) {
+            if (hPlayerWnd) PostMessage(hPlayerWnd, WM_PLAYER_TRACK_CHANGED, 0, (LPARAM)new std::string(path));
+        };
+        cb.onEnded = []() {
+            if (hPlayerWnd) PostMessage(hPlayerWnd, WM_PLAYER_ENDED, 0, 0);
+        };
+        engine->SetCallbacks(cb);
+    }
+    return *engine;
 }
 
-static DWORD MCI_GetLength() {
-    char buf[64] = {};
-    mciSendStringA("status myAudio length", buf, sizeof(buf), nullptr);
-    return (DWORD)atoi(buf);
+// Queue the entry after the selection so playback continues without a gap
+static void QueueFollowing() {
+    std::string next;
+    {
+        std::lock_guard<std::mutex> lk(listMtx);
+        if (recList.GetCount() > 0 && listSelIdx >= 0)
+            next = recList.GetPath((listSelIdx + 1) % recList.GetCount());
+    }
+    GetEngine().QueueNext(next);
 }
 
-static DWORD MCI_GetPos() {
-    char buf[64] = {};
-    mciSendStringA("status myAudio position", buf, sizeof(buf), nullptr);
-    return (DWORD)atoi(buf);
+static void Engine_SetPos(DWORD ms) {
+    GetEngine().SeekMs(ms);
+    enginePosMs = ms;
 }
 
-static void MCI_SetPos(DWORD ms) {
-    char cmd[128];
-    sprintf_s(cmd, "seek myAudio to %u", (unsigned)ms);
-    mciSendStringA(cmd, nullptr, 0, nullptr);
+static void Engine_SetVolume(float vol) {  // 0..1
+    if (engine) engine->SetVolume(vol);
 }
 
-static void MCI_SetVolume(int vol) {  // 0-1000
-    char cmd[128];
-    sprintf_s(cmd, "setaudio myAudio volume to %d", vol);
-    mciSendStringA(cmd, nullptr, 0, nullptr);
+static void Engine_SetSpeed(int step) {
+    speedStep = max(0, min(SPEED_STEP_COUNT - 1, step));
+    GetEngine().SetSpeed(SPEED_STEPS[speedStep]);
+    if (hPlayerWnd) InvalidateRect(hPlayerWnd, nullptr, FALSE);
 }
 
-static void MCI_Play(const std::string& path) {
+static void Engine_Play(const std::string& path) {
     if (path.empty()) return;
-    MCI_Close();
-    std::string cmd = "open \"" + path + "\" type waveaudio alias myAudio";
-    mciSendStringA(cmd.c_str(), nullptr, 0, nullptr);
-    MCI_SetVolume((int)(volume * 1000));
-    mciSendStringA("play myAudio notify", nullptr, 0, hPlayerWnd);
-    posTotalMs = MCI_GetLength();
+    PlaybackEngine& e = GetEngine();
+    e.SetVolume(volume);
+    e.SetSpeed(SPEED_STEPS[speedStep]);
+    if (!e.Play(path)) {
+        isPlaying = false;
+        isPaused  = false;
+        return;
+    }
+    posCurMs   = 0;
+    posTotalMs = e.GetDurationMs();
+    enginePosMs   = 0;
+    engineTotalMs = posTotalMs;
     isPlaying = true;
     isPaused  = false;
+    QueueFollowing();
+    WakePlayerTick();
 }
 
-static void MCI_Pause() {
-    mciSendStringA("pause myAudio", nullptr, 0, nullptr);
+static void Engine_Pause() {
+    if (engine) engine->Pause();
     isPaused  = true;
     isPlaying = false;
+    WakePlayerTick();
 }
 
-static void MCI_Resume() {
-    mciSendStringA("resume myAudio", nullptr, 0, nullptr);
+static void Engine_Resume() {
+    if (engine) engine->Resume();
     isPaused  = false;
     isPlaying = true;
+    WakePlayerTick();
 }
 
-static void MCI_Stop() {
-    mciSendStringA("stop myAudio", nullptr, 0, nullptr);
-    MCI_Close();
+static void Engine_Stop() {
+    if (engine) engine->Stop();
     isPlaying  = false;
     isPaused   = false;
     posCurMs   = 0;
     posTotalMs = 0;
+    WakePlayerTick();
 }
 
-// ────────────────────── Recording list scan ──────────────────────────────────
-static void LoadRecordingList() {
-    std::vector<RecEntry> tmp;
-    if (recordingFolder.empty()) return;
-    try {
-        for (auto& e : std::filesystem::recursive_directory_iterator(recordingFolder)) {
-            if (!e.is_regular_file()) continue;
-            auto ext = e.path().extension().string();
-            // lowercase
-            for (auto& c : ext) c = (char)tolower((unsigned char)c);
-            if (ext != ".wav") continue;
-            RecEntry r;
-            r.path    = e.path().string();
-            r.display = e.path().stem().string();
-            r.dateStr = e.path().parent_path().filename().string();
-            r.sizeKB  = (DWORD)(e.file_size() / 1024);
-            tmp.push_back(std::move(r));
+// Load (or build, for recordings made before .peaks sidecars) the summary
+// off the UI thread. Drawing is then WAVE_BARS lookups per frame.
+static void LoadWavePeaksAsync(const std::string& path) {
+    if (path == wavePeaksPath) return;
+    wavePeaksPath  = path;
+    wavePeaksValid = false;
+    if (path.empty()) return;
+    HWND hWnd = hPlayerWnd;
+    std::thread([hWnd, path]() {
+        PeakPyramid pyramid;
+        if (!LoadOrBuildPeaks(path, pyramid)) return;
+        std::vector<PeakEntry> cols;
+        pyramid.Query(0, pyramid.GetTotalFrames(), WAVE_BARS, cols);
+
+        WavePeaksResult* r = new WavePeaksResult{path, std::vector<float>(WAVE_BARS, 0.0f)};
+        float loudest = 0.0f;
+        for (const PeakEntry& c : cols) loudest = (std::max)(loudest, c.GetPeak());
+        for (int i = 0; i < WAVE_BARS; i++) {
+            r->peaks[i] = loudest > 0.0f ? cols[i].GetPeak() / loudest : 0.0f;
         }
-    } catch (...) {}
-    // Sort newest first (by filename / path descending)
-    std::sort(tmp.begin(), tmp.end(), [](const RecEntry& a, const RecEntry& b) {
-        return a.path > b.path;
-    });
-    std::lock_guard<std::mutex> lk(listMtx);
-    recList = std::move(tmp);
+        if (!hWnd || !PostMessage(hWnd, WM_PLAYER_PEAKS, 0, (LPARAM)r)) delete r;
+    }).detach();
 }
 
-// ────────────────────── Search ───────────────────────────────────────────────
-static std::string FindRecordingByMetadata(const std::string& query) {
-    if (query.empty() || recordingFolder.empty()) return "";
-    // First: case-insensitive filename match anywhere in list
-    {
-        std::lock_guard<std::mutex> lk(listMtx);
-        std::string ql = query;
-        for (auto& c : ql) c = (char)tolower((unsigned char)c);
-        for (auto& r : recList) {
-            std::string dl = r.display;
-            for (auto& c : dl) c = (char)tolower((unsigned char)c);
-            if (dl.find(ql) != std::string::npos) return r.path;
+// Same for the voice-activity map (built by a batch pass for old files)
+static void LoadSpeechMapAsync(const std::string& path) {
+    if (path == speechPath) return;
+    speechPath  = path;
+    speechValid = false;
+    if (path.empty()) return;
+    HWND hWnd = hPlayerWnd;
+    std::thread([hWnd, path]() {
+        VoiceActivityMap map;
+        if (!LoadOrBuildVoiceMap(path, map) || map.GetSampleRate() == 0) return;
+        SpeechMapResult* r = new SpeechMapResult{path, {}};
+        uint64_t rate = map.GetSampleRate();
+        for (const VoiceSegment& seg : map.GetSegments()) {
+            r->ranges.push_back({(DWORD)(seg.start * 1000 / rate), (DWORD)(seg.end * 1000 / rate)});
         }
+        if (!hWnd || !PostMessage(hWnd, WM_PLAYER_SPEECH, 0, (LPARAM)r)) delete r;
+    }).detach();
+}
+
+// Point the spectrogram at the current file (tiles follow lazily)
+static void SyncSpectrogram() {
+    if (!showSpectro || currentAudioPath.empty()) { spectro.Close(); return; }
+    if (spectro.IsOpen() && spectro.GetPath() == currentAudioPath) return;
+    if (!spectroPool) spectroPool = new ThreadPool(0, true);
+    if (!spectro.Open(currentAudioPath, *spectroPool)) return;
+    spectro.SetReadyCallback([]() {
+        // One repaint per batch of finished tiles
+        if (!spectroPosted.exchange(true) && hPlayerWnd) PostMessage(hPlayerWnd, WM_PLAYER_SPECTRO, 0, 0);
+    });
+}
+
+// ────────────────────── Recording list scan ──────────────────────────────────
+// Folder listing first so the list fills at once, then headers (duration,
+// metadata) in batches. The window refreshes its view after each step.
+static std::atomic<int> listLoadSeq{0};
+static void LoadRecordingList() {
+    if (recordingFolder.empty()) return;
+    int seq = ++listLoadSeq;
+    RecordingCatalog& catalog = GetRecordingCatalog();
+    catalog.ScanFiles(recordingFolder);
+    if (hPlayerWnd) PostMessage(hPlayerWnd, WM_USER + 10, 0, 0);
+    while (seq == listLoadSeq && catalog.LoadPendingHeaders(2048) > 0) {
+        if (hPlayerWnd) PostMessage(hPlayerWnd, WM_USER + 10, 0, 0);
     }
-    // Second: search inside .txt metadata files
-    try {
-        for (auto& entry : std::filesystem::recursive_directory_iterator(recordingFolder)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
-                std::ifstream file(entry.path());
-                if (file.is_open()) {
-                    std::stringstream buf;
-                    buf << file.rdbuf();
-                    if (buf.str().find(query) != std::string::npos) {
-                        auto wav = entry.path(); wav.replace_extension(".wav");
-                        if (std::filesystem::exists(wav)) return wav.string();
-                    }
-                }
-            }
-        }
-    } catch (...) {}
-    return "";
 }
 
 // ────────────────────── Play a file ─────────────────────────────────────────
 static void PlayFile(const std::string& path) {
-    MCI_Stop();
     currentAudioPath = path;
     if (!path.empty()) {
-        MCI_Play(path);
-        // highlight in list
-        std::lock_guard<std::mutex> lk(listMtx);
-        for (int i = 0; i < (int)recList.size(); i++) {
-            if (recList[i].path == path) { listSelIdx = i; break; }
+        // highlight in list (also decides what gets queued next)
+        {
+            std::lock_guard<std::mutex> lk(listMtx);
+            int idx = recList.IndexOf(path);
+            if (idx >= 0) listSelIdx = idx;
         }
+        // Same format as the current file: swapped without reopening the device
+        Engine_Play(path);
+        LoadWavePeaksAsync(path);
+        LoadSpeechMapAsync(path);
+    } else {
+        Engine_Stop();
+        LoadWavePeaksAsync("");
+        LoadSpeechMapAsync("");
     }
+    SyncSpectrogram();
     if (hPlayerWnd) InvalidateRect(hPlayerWnd, nullptr, FALSE);
 }
 
@@ -415,9 +511,9 @@ static void PlayPrev() {
     std::string p;
     {
         std::lock_guard<std::mutex> lk(listMtx);
-        if (recList.empty()) return;
-        listSelIdx = (listSelIdx <= 0) ? (int)recList.size()-1 : listSelIdx-1;
-        p = recList[listSelIdx].path;
+        if (recList.GetCount() == 0) return;
+        listSelIdx = (listSelIdx <= 0) ? recList.GetCount()-1 : listSelIdx-1;
+        p = recList.GetPath(listSelIdx);
     }
     PlayFile(p);
 }
@@ -425,32 +521,79 @@ static void PlayNext() {
     std::string p;
     {
         std::lock_guard<std::mutex> lk(listMtx);
-        if (recList.empty()) return;
-        listSelIdx = (listSelIdx+1 >= (int)recList.size()) ? 0 : listSelIdx+1;
-        p = recList[listSelIdx].path;
+        if (recList.GetCount() == 0) return;
+        listSelIdx = (listSelIdx+1 >= recList.GetCount()) ? 0 : listSelIdx+1;
+        p = recList.GetPath(listSelIdx);
     }
     PlayFile(p);
 }
 
 // ────────────────────── Waveform animation ──────────────────────────────────
-static void UpdateWaveform() {
+// Bars ease towards the file's real peaks, or a flat line until they load.
+// Eases the bars toward their targets; false once they have settled
+static bool UpdateWaveform() {
+    bool moving = false;
     for (int i = 0; i < WAVE_BARS; i++) {
-        if (isPlaying) {
-            waveTargets[i] = 0.15f + (float)(rand() % 85) / 100.0f;
-        } else {
-            waveTargets[i] = 0.05f;
-        }
-        waveBars[i] += (waveTargets[i] - waveBars[i]) * 0.25f;
+        waveTargets[i] = wavePeaksValid ? 0.05f + wavePeaks[i] * 0.95f : 0.05f;
+        float step = (waveTargets[i] - waveBars[i]) * 0.25f;
+        if (std::fabs(step) > 0.0005f) moving = true;
+        waveBars[i] += step;
     }
+    return moving;
 }
 
-// ────────────────────── Timer tick ──────────────────────────────────────────
-static void UpdatePosition() {
-    if (isPlaying) {
-        posCurMs = MCI_GetPos();
+// ────────────────────── Skip silence ────────────────────────────────────────
+// Gaps under a second are left alone; longer ones jump to just before the
+// next speech (or to the end, which advances to the next recording).
+static void SkipNonSpeech() {
+    if (!skipSilence || !speechValid || !isPlaying || seekDragging) return;
+    if (speechPath != currentAudioPath) return;
+    const DWORD leadIn = 250;
+    DWORD next = posTotalMs;
+    for (const auto& r : speechMs) {
+        if (posCurMs < r.second) { next = (posCurMs >= r.first) ? posCurMs : r.first; break; }
     }
-    UpdateWaveform();
-    if (hPlayerWnd) InvalidateRect(hPlayerWnd, nullptr, FALSE);
+    if (next > posCurMs + 1000) {
+        DWORD target = next < posTotalMs ? next - leadIn : posTotalMs;
+        Engine_SetPos(target);
+        posCurMs = target;
+    }
+}
+
+// ────────────────────── Frame tick ──────────────────────────────────────────
+// Repaints only when the position moved or the bars are still easing.
+// Returns false once there is nothing left to animate, which takes the
+// task off the scheduler until WakePlayerTick.
+static bool UpdatePosition() {
+    static DWORD lastCur = 0, lastTotal = 0;
+    static bool lastPlaying = false, lastPaused = false;
+    if (isPlaying && !seekDragging) {
+        posCurMs = enginePosMs;
+        if (engineTotalMs) posTotalMs = engineTotalMs;
+        SkipNonSpeech();
+    }
+    bool moving = UpdateWaveform();
+    bool changed = posCurMs != lastCur || posTotalMs != lastTotal || isPlaying != lastPlaying || isPaused != lastPaused;
+    lastCur = posCurMs;
+    lastTotal = posTotalMs;
+    lastPlaying = isPlaying;
+    lastPaused = isPaused;
+    if (!hPlayerWnd || !IsWindowVisible(hPlayerWnd) || IsIconic(hPlayerWnd)) return false;
+    if (!moving && !changed) {
+        playerFrameStats.Skip();
+        return isPlaying;
+    }
+    InvalidateRect(hPlayerWnd, nullptr, FALSE);
+    return true;
+}
+
+static void WakePlayerTick() {
+    if (!hPlayerWnd) return;
+    if (!playerTaskAdded) {
+        playerTask = GetFrameScheduler().AddTask("player", 80, 30, [] { return UpdatePosition(); });
+        playerTaskAdded = true;
+    }
+    WakeFrameTask(playerTask);
 }
 
 // ────────────────────── Subclassed Edit (Enter = search) ────────────────────
@@ -463,25 +606,89 @@ static LRESULT CALLBACK SearchEditProc(HWND hWnd, UINT msg, WPARAM wp, LPARAM lp
     return CallWindowProc(origEditProc, hWnd, msg, wp, lp);
 }
 
+// ────────────────────── Spectrogram panel ───────────────────────────────────
+// One tile column per pixel, playhead a quarter in from the left. Tiles
+// not computed yet stay dark and are queued on the pool by GetTile.
+static void DrawSpectrogram(HDC dc, const RECT& r) {
+    const int w = r.right - r.left, h = r.bottom - r.top;
+    const uint32_t rate = spectro.GetSampleRate();
+    if (w <= 0 || h <= 0 || rate == 0) return;
+    const size_t bins = SpectrogramCache::BINS;
+    const uint64_t tileCols = SpectrogramCache::TILE_COLUMNS;
+
+    // Background -> low -> high -> white
+    uint32_t palette[256];
+    COLORREF stops[4] = { RGB(28, 28, 38), cWaveLow, cWaveHigh, RGB(255, 255, 230) };
+    for (int i = 0; i < 256; i++) {
+        float t = i / 255.0f * 3.0f;
+        int s = min(2, (int)t);
+        float f = t - s;
+        COLORREF a = stops[s], b = stops[s + 1];
+        int cr = GetRValue(a) + (int)(f * (GetRValue(b) - GetRValue(a)));
+        int cg = GetGValue(a) + (int)(f * (GetGValue(b) - GetGValue(a)));
+        int cb = GetBValue(a) + (int)(f * (GetBValue(b) - GetBValue(a)));
+        palette[i] = (uint32_t)((cr << 16) | (cg << 8) | cb);
+    }
+
+    uint64_t framesPerCol = SpectrogramCache::GetFramesPerColumn(spectroLevel);
+    uint64_t playCol = (uint64_t)posCurMs * rate / 1000 / framesPerCol;
+    uint64_t firstCol = playCol > (uint64_t)(w / 4) ? playCol - w / 4 : 0;
+
+    static std::vector<uint32_t> pixels;
+    pixels.assign((size_t)w * bins, palette[0]);
+    for (int x = 0; x < w;) {
+        uint64_t col = firstCol + x;
+        int run = (int)min((uint64_t)(w - x), tileCols - col % tileCols);
+        SpectrogramCache::Tile tile = spectro.GetTile(spectroLevel, col / tileCols);
+        if (tile) {
+            const uint8_t* cells = tile->data() + (col % tileCols) * bins;
+            for (int i = 0; i < run; i++, cells += bins) {
+                for (size_t b = 0; b < bins; b++) pixels[b * w + x + i] = palette[cells[b]];
+            }
+        }
+        x += run;
+    }
+    spectro.GetTile(spectroLevel, (firstCol + w) / tileCols + 1);   // Read ahead of playback
+
+    // Bottom-up DIB: bin 0 (low frequencies) at the bottom
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
+    bmi.bmiHeader.biWidth = w;
+    bmi.bmiHeader.biHeight = (LONG)bins;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    SetStretchBltMode(dc, COLORONCOLOR);
+    StretchDIBits(dc, r.left, r.top, w, h, 0, 0, w, (int)bins, pixels.data(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+
+    RECT ph = {r.left + (int)(playCol - firstCol), r.top, r.left + (int)(playCol - firstCol) + 1, r.bottom};
+    HBRUSH pb = playerGdi.Brush(cAccent);
+    FillRect(dc, &ph, pb);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 //  PAINT — the entire window is custom-drawn
 // ═══════════════════════════════════════════════════════════════════════════
 static void PaintPlayer(HWND hWnd) {
+    TRACE_SCOPE(PaintPlayer);
     PAINTSTRUCT ps;
     HDC hdc = BeginPaint(hWnd, &ps);
     RECT wrc; GetClientRect(hWnd, &wrc);
     int W = wrc.right, H = wrc.bottom;
 
-    // Double-buffer
-    HDC mem = CreateCompatibleDC(hdc);
-    HBITMAP bmp = CreateCompatibleBitmap(hdc, W, H);
-    SelectObject(mem, bmp);
-    SetBkMode(mem, TRANSPARENT);
+    playerFrameStats.Begin();
+
+    // Double-buffer (kept between paints, resized with the window)
+    HDC mem = playerBuffer.Begin(hdc, W, H);
+    if (!mem) {
+        EndPaint(hWnd, &ps);
+        return;
+    }
+    playerGdi.Trim();
 
     // ── Background ──
-    HBRUSH brBg = CreateSolidBrush(cBg);
+    HBRUSH brBg = playerGdi.Brush(cBg);
     FillRect(mem, &wrc, brBg);
-    DeleteObject(brBg);
 
     int margin = 16;
     int y = margin;
@@ -506,11 +713,10 @@ static void PaintPlayer(HWND hWnd) {
 
     // ── Separator ──
     {
-        HPEN pen = CreatePen(PS_SOLID, 1, cBorder);
+        HPEN pen = playerGdi.Pen(PS_SOLID, 1, cBorder);
         SelectObject(mem, pen);
         MoveToEx(mem, margin, y, nullptr);
         LineTo(mem, W - margin, y);
-        DeleteObject(pen);
         y += 8;
     }
 
@@ -519,9 +725,8 @@ static void PaintPlayer(HWND hWnd) {
     {
         // Background pill
         RECT sr = {margin, y, W - margin, y + 34};
-        HBRUSH brS = CreateSolidBrush(cSearchBg);
+        HBRUSH brS = playerGdi.Brush(cSearchBg);
         FillRoundRect(mem, sr, 8, brS);
-        DeleteObject(brS);
 
         // Search icon (drawn lens)
         DrawSearchLens(mem, margin + 20, y + 17, 18, cTextDim);
@@ -535,9 +740,8 @@ static void PaintPlayer(HWND hWnd) {
         // Search button
         int btnW = 68;
         rcSearchBtn = {W - margin - btnW, y + 2, W - margin - 2, y + 32};
-        HBRUSH brBtn = CreateSolidBrush(hoverZone == HZ_SEARCH_BTN ? cAccentHover : cAccent);
+        HBRUSH brBtn = playerGdi.Brush(hoverZone == HZ_SEARCH_BTN ? cAccentHover : cAccent);
         FillRoundRect(mem, rcSearchBtn, 6, brBtn);
-        DeleteObject(brBtn);
         DrawTextCentered(mem, "Search", rcSearchBtn, fNormal, RGB(255,255,255));
 
         y += 42;
@@ -552,21 +756,19 @@ static void PaintPlayer(HWND hWnd) {
         y += 20;
     }
 
-    // ── Recording list ──
-    int listH = 140;
+    // ── Recording list ── (gives up height to the spectrogram)
+    int listH = showSpectro ? 104 : 140;
     rcListArea = {margin, y, W - margin, y + listH};
     {
         // List background
-        HBRUSH brList = CreateSolidBrush(cPanel);
+        HBRUSH brList = playerGdi.Brush(cPanel);
         FillRoundRect(mem, rcListArea, 6, brList);
-        DeleteObject(brList);
 
         // Border
-        HPEN bp = CreatePen(PS_SOLID, 1, cBorder);
+        HPEN bp = playerGdi.Pen(PS_SOLID, 1, cBorder);
         HBRUSH nbr = (HBRUSH)GetStockObject(NULL_BRUSH);
         SelectObject(mem, bp); SelectObject(mem, nbr);
         RoundRect(mem, rcListArea.left, rcListArea.top, rcListArea.right, rcListArea.bottom, 6, 6);
-        DeleteObject(bp);
 
         // Header
         int hy = y + 4;
@@ -584,13 +786,22 @@ static void PaintPlayer(HWND hWnd) {
             DrawFolderIcon(mem, (rcFolderBtn.left + rcFolderBtn.right)/2, (rcFolderBtn.top + rcFolderBtn.bottom)/2, 14, hoverZone == HZ_FOLDER ? cAccent : cTextDim);
         }
 
-        // Count badge
+        // Count badge (matches of total when filtered) and sort order
         {
             std::lock_guard<std::mutex> lk(listMtx);
-            char cnt[32]; sprintf_s(cnt, "(%d)", (int)recList.size());
-            RECT rb = {margin + 100, hy, margin + 200, hy + 16};
+            char cnt[48];
+            if (recList.GetQuery().IsFiltered())
+                sprintf_s(cnt, "(%d of %d)", recList.GetCount(), (int)GetRecordingCatalog().GetCount());
+            else
+                sprintf_s(cnt, "(%d)", recList.GetCount());
+            RECT rb = {margin + 100, hy, margin + 220, hy + 16};
             SetTextColor(mem, cTextDim);
             DrawTextA(mem, cnt, -1, &rb, DT_SINGLELINE | DT_VCENTER);
+
+            rcSortBtn = {rcFolderBtn.left - 80, hy, rcFolderBtn.left - 6, hy + 16};
+            SetTextColor(mem, hoverZone == HZ_SORT ? cAccent : cTextDim);
+            DrawTextA(mem, CatalogQuery::GetSortName(recList.GetQuery().sort), -1, &rcSortBtn,
+                      DT_SINGLELINE | DT_VCENTER | DT_RIGHT);
         }
 
         hy += 20;
@@ -603,25 +814,28 @@ static void PaintPlayer(HWND hWnd) {
         {
             std::lock_guard<std::mutex> lk(listMtx);
             int visible = (rcListArea.bottom - hy) / itemH;
-            int maxScroll = max(0, (int)recList.size() - visible);
+            int count = recList.GetCount();
+            int maxScroll = max(0, count - visible);
             if (listScrollY > maxScroll) listScrollY = maxScroll;
             if (listScrollY < 0) listScrollY = 0;
 
-            for (int i = listScrollY; i < (int)recList.size(); i++) {
+            // Only the rows on screen are formatted and drawn
+            recList.SetVisibleRange(listScrollY, visible + 1);
+            for (int i = listScrollY; i < count; i++) {
                 int iy = hy + (i - listScrollY) * itemH;
                 if (iy >= rcListArea.bottom) break;
+                const RecordingRow* row = recList.GetRow(i);
+                if (!row) break;
 
                 RECT ir = {rcListArea.left + 2, iy, rcListArea.right - 2, iy + itemH};
 
                 // Highlight
                 if (i == listSelIdx) {
-                    HBRUSH hb = CreateSolidBrush(cListSel);
+                    HBRUSH hb = playerGdi.Brush(cListSel);
                     FillRect(mem, &ir, hb);
-                    DeleteObject(hb);
                 } else if (i == listHoverIdx) {
-                    HBRUSH hb = CreateSolidBrush(cListHover);
+                    HBRUSH hb = playerGdi.Brush(cListHover);
                     FillRect(mem, &ir, hb);
-                    DeleteObject(hb);
                 }
 
                 // Icon (GDI drawn)
@@ -638,17 +852,30 @@ static void PaintPlayer(HWND hWnd) {
                 SetTextColor(mem, cText);
                 SelectObject(mem, fNormal);
                 RECT rn = {ir.left + 28, iy, ir.right - 90, iy + itemH};
-                DrawTextA(mem, recList[i].display.c_str(), -1, &rn,
+                DrawTextA(mem, row->display.c_str(), -1, &rn,
                           DT_SINGLELINE | DT_VCENTER | DT_END_ELLIPSIS);
 
-                // Date + size
+                // Date + duration (size until the header is read)
                 SelectObject(mem, fSmall);
                 SetTextColor(mem, cTextDim);
                 char meta[64];
-                sprintf_s(meta, "%s  %uKB", recList[i].dateStr.c_str(), recList[i].sizeKB);
+                if (row->durationMs > 0)
+                    sprintf_s(meta, "%s  %u:%02u", row->dateStr.c_str(), row->durationMs / 60000, row->durationMs / 1000 % 60);
+                else
+                    sprintf_s(meta, "%s  %uKB", row->dateStr.c_str(), row->sizeKB);
                 RECT rm = {ir.right - 140, iy, ir.right - 6, iy + itemH};
                 DrawTextA(mem, meta, -1, &rm, DT_SINGLELINE | DT_VCENTER | DT_RIGHT);
             }
+
+            // Scroll position
+            if (count > visible && visible > 0) {
+                int trackH = rcListArea.bottom - 4 - hy;
+                int thumbH = max(12, trackH * visible / count);
+                int thumbY = hy + (int)((int64_t)(trackH - thumbH) * listScrollY / max(1, maxScroll));
+                RECT th = {rcListArea.right - 5, thumbY, rcListArea.right - 2, thumbY + thumbH};
+                HBRUSH tb = playerGdi.Brush(cBorder);
+                FillRect(mem, &th, tb);
+            }
         }
         SelectClipRgn(mem, nullptr);
         DeleteObject(clip);
@@ -674,30 +901,38 @@ static void PaintPlayer(HWND hWnd) {
         y += 24;
     }
 
+    // ── Spectrogram ──
+    if (showSpectro && spectro.IsOpen()) {
+        int specH = 72;
+        RECT sr = {margin, y, W - margin, y + specH};
+        DrawSpectrogram(mem, sr);
+        y += specH + 6;
+    }
     // ── Waveform visualiser ──
-    {
-        int waveH = 36;
+    else {
+        int waveH = showSpectro ? 72 : 36;
         RECT wr = {margin, y, W - margin, y + waveH};
-        HBRUSH brW = CreateSolidBrush(RGB(28, 28, 38));
+        HBRUSH brW = playerGdi.Brush(RGB(28, 28, 38));
         FillRoundRect(mem, wr, 4, brW);
-        DeleteObject(brW);
 
         int barW = (W - margin * 2 - WAVE_BARS) / WAVE_BARS;
+        float played = posTotalMs ? (float)posCurMs / posTotalMs : 0.0f;
         for (int i = 0; i < WAVE_BARS; i++) {
             int bx = margin + 2 + i * (barW + 1);
             int bh = (int)(waveBars[i] * (waveH - 6));
             if (bh < 2) bh = 2;
             int by = y + waveH - 3 - bh;
 
-            // Gradient: use accent for tall bars, dim for short ones
-            float t = waveBars[i];
+            // Gradient: use accent for tall bars, dim for short ones.
+            // Bars ahead of the playhead stay at the dim end.
+            float t = ((i + 0.5f) / WAVE_BARS <= played) ? waveBars[i] : waveBars[i] * 0.25f;
+            t = std::floor(t * 64.0f) / 64.0f;      // 65 shades, so the brush cache stays small
             int r1 = GetRValue(cWaveLow), g1 = GetGValue(cWaveLow), b1 = GetBValue(cWaveLow);
             int r2 = GetRValue(cWaveHigh), g2 = GetGValue(cWaveHigh), b2 = GetBValue(cWaveHigh);
             COLORREF bc = RGB(r1 + (int)(t*(r2-r1)), g1 + (int)(t*(g2-g1)), b1 + (int)(t*(b2-b1)));
-            HBRUSH bb = CreateSolidBrush(bc);
+            HBRUSH bb = playerGdi.Brush(bc);
             RECT br2r = {bx, by, bx + barW, y + waveH - 3};
             FillRect(mem, &br2r, bb);
-            DeleteObject(bb);
         }
         y += waveH + 6;
     }
@@ -706,9 +941,8 @@ static void PaintPlayer(HWND hWnd) {
     {
         rcSeek = {margin, y, W - margin, y + 8};
         // Background
-        HBRUSH bg = CreateSolidBrush(cSeekBg);
+        HBRUSH bg = playerGdi.Brush(cSeekBg);
         FillRoundRect(mem, rcSeek, 4, bg);
-        DeleteObject(bg);
 
         // Progress fill
         float pct = (posTotalMs > 0) ? (float)posCurMs / posTotalMs : 0.0f;
@@ -716,17 +950,26 @@ static void PaintPlayer(HWND hWnd) {
         int fillW = (int)(pct * (rcSeek.right - rcSeek.left));
         if (fillW > 0) {
             RECT rf = {rcSeek.left, rcSeek.top, rcSeek.left + fillW, rcSeek.bottom};
-            HBRUSH fb = CreateSolidBrush(cSeekFill);
+            HBRUSH fb = playerGdi.Brush(cSeekFill);
             FillRoundRect(mem, rf, 4, fb);
-            DeleteObject(fb);
+        }
+        // Speech regions as a strip under the bar
+        if (speechValid && posTotalMs > 0 && speechPath == currentAudioPath) {
+            int bw = rcSeek.right - rcSeek.left;
+            HBRUSH sb = playerGdi.Brush(skipSilence ? cAccent : cWaveLow);
+            for (const auto& r : speechMs) {
+                int x1 = rcSeek.left + (int)((double)r.first / posTotalMs * bw);
+                int x2 = rcSeek.left + (int)((double)r.second / posTotalMs * bw);
+                RECT sr = {x1, rcSeek.bottom + 2, max(x2, x1 + 1), rcSeek.bottom + 4};
+                FillRect(mem, &sr, sb);
+            }
         }
         // Thumb
         int tx = rcSeek.left + fillW;
         if (isPlaying || isPaused) {
-            HBRUSH tb = CreateSolidBrush(RGB(255,255,255));
+            HBRUSH tb = playerGdi.Brush(RGB(255,255,255));
             RECT tr = {tx - 5, rcSeek.top - 3, tx + 5, rcSeek.bottom + 3};
             FillRoundRect(mem, tr, 5, tb);
-            DeleteObject(tb);
         }
 
         y += 14;
@@ -754,8 +997,8 @@ static void PaintPlayer(HWND hWnd) {
         // Prev ⏮
         rcPrev = {startX, cy - btnSz/2, startX + btnSz, cy + btnSz/2};
         {
-            HBRUSH b = CreateSolidBrush(hoverZone == HZ_PREV ? cListHover : cPanel);
-            FillRoundRect(mem, rcPrev, 6, b); DeleteObject(b);
+            HBRUSH b = playerGdi.Brush(hoverZone == HZ_PREV ? cListHover : cPanel);
+            FillRoundRect(mem, rcPrev, 6, b);
             DrawPrevIcon(mem, (rcPrev.left+rcPrev.right)/2, (rcPrev.top+rcPrev.bottom)/2, 24, hoverZone == HZ_PREV ? cAccent : cText);
         }
         startX += btnSz + gap;
@@ -763,8 +1006,8 @@ static void PaintPlayer(HWND hWnd) {
         // Stop ⏹
         rcStop = {startX, cy - btnSz/2, startX + btnSz, cy + btnSz/2};
         {
-            HBRUSH b = CreateSolidBrush(hoverZone == HZ_STOP ? cListHover : cPanel);
-            FillRoundRect(mem, rcStop, 6, b); DeleteObject(b);
+            HBRUSH b = playerGdi.Brush(hoverZone == HZ_STOP ? cListHover : cPanel);
+            FillRoundRect(mem, rcStop, 6, b);
             DrawStopSquare(mem, (rcStop.left+rcStop.right)/2, (rcStop.top+rcStop.bottom)/2, 24, hoverZone == HZ_STOP ? cMuted : cText);
         }
         startX += btnSz + gap;
@@ -772,8 +1015,8 @@ static void PaintPlayer(HWND hWnd) {
         // Play/Pause ▶ / ⏸  (bigger)
         rcPlay = {startX, cy - playBtnSz/2, startX + playBtnSz, cy + playBtnSz/2};
         {
-            HBRUSH b = CreateSolidBrush(hoverZone == HZ_PLAY ? cAccentHover : cAccent);
-            FillRoundRect(mem, rcPlay, playBtnSz/2, b); DeleteObject(b);
+            HBRUSH b = playerGdi.Brush(hoverZone == HZ_PLAY ? cAccentHover : cAccent);
+            FillRoundRect(mem, rcPlay, playBtnSz/2, b);
             int pcx = (rcPlay.left+rcPlay.right)/2, pcy = (rcPlay.top+rcPlay.bottom)/2;
             if (isPlaying)
                 DrawPauseIcon(mem, pcx, pcy, 22, RGB(255,255,255));
@@ -785,8 +1028,8 @@ static void PaintPlayer(HWND hWnd) {
         // Next ⏭
         rcNext = {startX, cy - btnSz/2, startX + btnSz, cy + btnSz/2};
         {
-            HBRUSH b = CreateSolidBrush(hoverZone == HZ_NEXT ? cListHover : cPanel);
-            FillRoundRect(mem, rcNext, 6, b); DeleteObject(b);
+            HBRUSH b = playerGdi.Brush(hoverZone == HZ_NEXT ? cListHover : cPanel);
+            FillRoundRect(mem, rcNext, 6, b);
             DrawNextIcon(mem, (rcNext.left+rcNext.right)/2, (rcNext.top+rcNext.bottom)/2, 24, hoverZone == HZ_NEXT ? cAccent : cText);
         }
         startX += btnSz + gap;
@@ -801,24 +1044,38 @@ static void PaintPlayer(HWND hWnd) {
         DrawSpeakerIcon(mem, vx + 10, y + 7, 16, cTextDim);
 
         rcVol = {vx + 30, y + 3, vx + 30 + volBarW, y + 9};
-        HBRUSH vbg = CreateSolidBrush(cSeekBg);
-        FillRoundRect(mem, rcVol, 3, vbg); DeleteObject(vbg);
+        HBRUSH vbg = playerGdi.Brush(cSeekBg);
+        FillRoundRect(mem, rcVol, 3, vbg);
         int vfill = (int)(volume * volBarW);
         RECT vfr = {rcVol.left, rcVol.top, rcVol.left + vfill, rcVol.bottom};
-        HBRUSH vfb = CreateSolidBrush(cAccent);
-        FillRoundRect(mem, vfr, 3, vfb); DeleteObject(vfb);
+        HBRUSH vfb = playerGdi.Brush(cAccent);
+        FillRoundRect(mem, vfr, 3, vfb);
 
         // volume pct
         char vpct[16]; sprintf_s(vpct, "%d%%", (int)(volume * 100));
         RECT vpr = {rcVol.right + 6, y, rcVol.right + 50, y + 14};
         SetTextColor(mem, cTextDim);
         DrawTextA(mem, vpct, -1, &vpr, DT_SINGLELINE | DT_VCENTER);
+
+        // Skip-silence pill (left edge, mirrors the speed pill)
+        rcSkip = {margin, y - 3, margin + 52, y + 17};
+        HBRUSH kb = playerGdi.Brush(hoverZone == HZ_SKIP ? cListHover : cPanel);
+        FillRoundRect(mem, rcSkip, 8, kb);
+        SetTextColor(mem, skipSilence ? cAccent : cTextDim);
+        DrawTextA(mem, "Skip", -1, &rcSkip, DT_SINGLELINE | DT_VCENTER | DT_CENTER);
+
+        // Speed pill (click = faster, right-click = slower)
+        rcSpeed = {W - margin - 52, y - 3, W - margin, y + 17};
+        HBRUSH sb = playerGdi.Brush(hoverZone == HZ_SPEED ? cListHover : cPanel);
+        FillRoundRect(mem, rcSpeed, 8, sb);
+        char spd[16]; sprintf_s(spd, "%gx", SPEED_STEPS[speedStep]);
+        SetTextColor(mem, SPEED_STEPS[speedStep] != 1.0 ? cAccent : cTextDim);
+        DrawTextA(mem, spd, -1, &rcSpeed, DT_SINGLELINE | DT_VCENTER | DT_CENTER);
     }
 
-    BitBlt(hdc, 0, 0, W, H, mem, 0, 0, SRCCOPY);
-    DeleteObject(bmp);
-    DeleteDC(mem);
+    playerBuffer.Present(hdc, wrc);
     EndPaint(hWnd, &ps);
+    playerFrameStats.End(false);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -835,6 +1092,7 @@ static HitZone HitTest(int x, int y) {
     if (PtInR(rcPrev, x, y))      return HZ_PREV;
     if (PtInR(rcNext, x, y))      return HZ_NEXT;
     if (PtInR(rcSearchBtn, x, y)) return HZ_SEARCH_BTN;
+    if (PtInR(rcSortBtn, x, y))   return HZ_SORT;
     if (PtInR(rcFolderBtn, x, y)) return HZ_FOLDER;
     // Seek — widen vertically for easier clicking
     {
@@ -845,6 +1103,8 @@ static HitZone HitTest(int x, int y) {
         RECT vr = rcVol; vr.top -= 6; vr.bottom += 6;
         if (PtInR(vr, x, y)) return HZ_VOL;
     }
+    if (PtInR(rcSpeed, x, y))     return HZ_SPEED;
+    if (PtInR(rcSkip, x, y))      return HZ_SKIP;
     if (PtInR(rcListArea, x, y)) return HZ_LIST_ITEM;
     return HZ_NONE;
 }
@@ -871,9 +1131,6 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
         // Style the edit control for dark theme
         // (we'll handle WM_CTLCOLOREDIT)
 
-        // Position timer for seek bar
-        SetTimer(hWnd, IDC_TIMER_POS, 80, nullptr);
-
         // Load recordings in background
         std::thread([]() {
             LoadRecordingList();
@@ -883,10 +1140,6 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
         return 0;
     }
 
-    case WM_TIMER:
-        if (wParam == IDC_TIMER_POS) UpdatePosition();
-        return 0;
-
     case WM_PAINT:
         PaintPlayer(hWnd);
         return 0;
@@ -921,7 +1174,7 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
         if (volDragging) {
             float pct = (float)(x - rcVol.left) / (rcVol.right - rcVol.left);
             volume = max(0.0f, min(1.0f, pct));
-            MCI_SetVolume((int)(volume * 1000));
+            Engine_SetVolume(volume);
             InvalidateRect(hWnd, nullptr, FALSE);
             return 0;
         }
@@ -935,7 +1188,7 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             int headerH = 24; // offset for header inside list
             int idx = listScrollY + (y - rcListArea.top - headerH) / itemH;
             std::lock_guard<std::mutex> lk(listMtx);
-            if (idx >= 0 && idx < (int)recList.size() && idx != listHoverIdx) {
+            if (idx >= 0 && idx < recList.GetCount() && idx != listHoverIdx) {
                 listHoverIdx = idx;
                 InvalidateRect(hWnd, nullptr, FALSE);
             }
@@ -973,23 +1226,23 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             SetCapture(hWnd);
             float pct = (float)(x - rcVol.left) / (rcVol.right - rcVol.left);
             volume = max(0.0f, min(1.0f, pct));
-            MCI_SetVolume((int)(volume * 1000));
+            Engine_SetVolume(volume);
             InvalidateRect(hWnd, nullptr, FALSE);
             return 0;
         }
 
         if (hz == HZ_PLAY) {
-            if (isPlaying) MCI_Pause();
-            else if (isPaused) MCI_Resume();
-            else if (!currentAudioPath.empty()) MCI_Play(currentAudioPath);
+            if (isPlaying) Engine_Pause();
+            else if (isPaused) Engine_Resume();
+            else if (!currentAudioPath.empty()) Engine_Play(currentAudioPath);
             else {
                 // Try playing first in list
                 std::string p;
                 {
                     std::lock_guard<std::mutex> lk(listMtx);
-                    if (!recList.empty()) {
+                    if (recList.GetCount() > 0) {
                         listSelIdx = 0;
-                        p = recList[0].path;
+                        p = recList.GetPath(0);
                     }
                 }
                 if (!p.empty()) PlayFile(p);
@@ -997,7 +1250,9 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             InvalidateRect(hWnd, nullptr, FALSE);
             return 0;
         }
-        if (hz == HZ_STOP)  { MCI_Stop(); InvalidateRect(hWnd, nullptr, FALSE); return 0; }
+        if (hz == HZ_STOP)  { Engine_Stop(); InvalidateRect(hWnd, nullptr, FALSE); return 0; }
+        if (hz == HZ_SPEED) { Engine_SetSpeed((speedStep + 1) % SPEED_STEP_COUNT); return 0; }
+        if (hz == HZ_SKIP)  { skipSilence = !skipSilence; InvalidateRect(hWnd, nullptr, FALSE); return 0; }
         if (hz == HZ_PREV)  { PlayPrev(); return 0; }
         if (hz == HZ_NEXT)  { PlayNext(); return 0; }
 
@@ -1005,6 +1260,16 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             SendMessage(hWnd, WM_COMMAND, MAKEWPARAM(IDC_EDIT_SEARCH + 999, 0), 0);
             return 0;
         }
+        if (hz == HZ_SORT) {
+            std::lock_guard<std::mutex> lk(listMtx);
+            CatalogQuery q = recList.GetQuery();
+            q.sort = (CatalogSort)(((int)q.sort + 1) % ((int)CatalogSort::Name + 1));
+            recList.SetQuery(q);
+            listScrollY = 0;
+            listSelIdx = recList.IndexOf(currentAudioPath);
+            InvalidateRect(hWnd, nullptr, FALSE);
+            return 0;
+        }
         if (hz == HZ_FOLDER) {
             if (!recordingFolder.empty())
                 ShellExecuteA(nullptr, "open", recordingFolder.c_str(), nullptr, nullptr, SW_SHOWNORMAL);
@@ -1018,9 +1283,9 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
             std::string p;
             {
                 std::lock_guard<std::mutex> lk(listMtx);
-                if (idx >= 0 && idx < (int)recList.size()) {
+                if (idx >= 0 && idx < recList.GetCount()) {
                     listSelIdx = idx;
-                    p = recList[idx].path;
+                    p = recList.GetPath(idx);
                 }
             }
             if (!p.empty()) PlayFile(p);
@@ -1033,16 +1298,8 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
         if (seekDragging) {
             seekDragging = false;
             ReleaseCapture();
-            MCI_SetPos(posCurMs);
-            if (isPlaying || isPaused) {
-                mciSendStringA("play myAudio notify", nullptr, 0, hPlayerWnd);
-                if (isPaused) {
-                    // Stay paused at new position
-                    mciSendStringA("pause myAudio", nullptr, 0, nullptr);
-                } else {
-                    isPlaying = true;
-                }
-            }
+            // Sample-accurate; a paused engine stays paused at the new position
+            if (isPlaying || isPaused) Engine_SetPos(posCurMs);
             InvalidateRect(hWnd, nullptr, FALSE);
             return 0;
         }
@@ -1065,7 +1322,7 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
                 int itemH = 28;
                 int headerH = 24;
                 int visible = (rcListArea.bottom - rcListArea.top - headerH) / itemH;
-                int maxScroll = max(0, (int)recList.size() - visible);
+                int maxScroll = max(0, recList.GetCount() - visible);
                 if (listScrollY > maxScroll) listScrollY = maxScroll;
             }
             InvalidateRect(hWnd, nullptr, FALSE);
@@ -1076,65 +1333,116 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
     case WM_COMMAND: {
         int id = LOWORD(wParam);
         if (id == IDC_EDIT_SEARCH + 999) {
-            // Trigger search
+            // Filter the list (file name, metadata, date, duration) and
+            // play the first match; an empty query clears the filter
             char buf[256] = {};
             GetWindowTextA(hSearchEdit, buf, 256);
             std::string query = buf;
-            if (query.empty()) return 0;
+            std::string first;
+            int matches = 0;
             {
-                std::lock_guard<std::mutex> lk(searchMtx);
-                searchQuery = query;
+                std::lock_guard<std::mutex> lk(listMtx);
+                CatalogQuery q = CatalogQuery::Parse(query);
+                if (query.find("sort:") == std::string::npos) q.sort = recList.GetQuery().sort;
+                recList.SetQuery(q);
+                listScrollY = 0;
+                listSelIdx = recList.IndexOf(currentAudioPath);
+                matches = recList.GetCount();
+                if (matches > 0) first = recList.GetPath(0);
+            }
+            if (query.empty()) {
+                searchStatus.clear();
+            } else if (matches > 0) {
+                searchStatus = "Found " + std::to_string(matches) + (matches == 1 ? " recording." : " recordings.");
+                PlayFile(first);
+            } else {
+                searchStatus = "Recording NOT found.";
             }
-            searchStatus = "Searching...";
             InvalidateRect(hWnd, nullptr, FALSE);
-            std::thread([hWnd, query]() {
-                std::string result = FindRecordingByMetadata(query);
-                PostMessage(hWnd, WM_USER + 1, 0, (LPARAM)new std::string(result));
-            }).detach();
         }
         return 0;
     }
 
-    case WM_USER + 1: { // search result
+    case WM_USER + 10: // list loaded / headers read
+        {
+            std::lock_guard<std::mutex> lk(listMtx);
+            if (recList.Refresh()) listSelIdx = recList.IndexOf(currentAudioPath);
+        }
+        InvalidateRect(hWnd, nullptr, FALSE);
+        return 0;
+
+    case WM_PLAYER_TRACK_CHANGED: { // gapless advance to the queued file
         std::string* p = (std::string*)lParam;
         if (p) {
-            if (!p->empty()) {
-                searchStatus = "Found!";
-                PlayFile(*p);
-            } else {
-                searchStatus = "Recording NOT found.";
+            currentAudioPath = *p;
+            {
+                std::lock_guard<std::mutex> lk(listMtx);
+                int idx = recList.IndexOf(*p);
+                if (idx >= 0) listSelIdx = idx;
             }
+            LoadWavePeaksAsync(*p);
+            LoadSpeechMapAsync(*p);
+            SyncSpectrogram();
             delete p;
+            if (engine) posTotalMs = engine->GetDurationMs();
+            QueueFollowing();
+            WakePlayerTick();
             InvalidateRect(hWnd, nullptr, FALSE);
         }
         return 0;
     }
 
-    case WM_USER + 10: // list loaded
-        InvalidateRect(hWnd, nullptr, FALSE);
+    case WM_PLAYER_PEAKS: {
+        WavePeaksResult* r = (WavePeaksResult*)lParam;
+        if (r) {
+            // Ignore results for a file that is no longer loaded
+            if (r->path == wavePeaksPath) {
+                std::copy(r->peaks.begin(), r->peaks.end(), wavePeaks);
+                wavePeaksValid = true;
+                WakePlayerTick();   // Bars ease toward the new peaks
+            }
+            delete r;
+        }
         return 0;
+    }
 
-    case MM_MCINOTIFY:
-        if (wParam == MCI_NOTIFY_SUCCESSFUL) {
-            isPlaying = false; isPaused = false;
-            // Auto-next
-            PlayNext();
+    case WM_PLAYER_SPEECH: {
+        SpeechMapResult* r = (SpeechMapResult*)lParam;
+        if (r) {
+            if (r->path == speechPath) {
+                speechMs = std::move(r->ranges);
+                speechValid = true;
+                InvalidateRect(hWnd, nullptr, FALSE);
+            }
+            delete r;
         }
         return 0;
+    }
+
+    case WM_PLAYER_SPECTRO: // tiles landed
+        spectroPosted = false;
+        InvalidateRect(hWnd, nullptr, FALSE);
+        return 0;
+
+    case WM_PLAYER_ENDED:
+        isPlaying = false; isPaused = false;
+        // Auto-next
+        PlayNext();
+        return 0;
 
     case WM_KEYDOWN:
         if (wParam == VK_SPACE) {
-            if (isPlaying) MCI_Pause();
-            else if (isPaused) MCI_Resume();
-            else if (!currentAudioPath.empty()) MCI_Play(currentAudioPath);
+            if (isPlaying) Engine_Pause();
+            else if (isPaused) Engine_Resume();
+            else if (!currentAudioPath.empty()) Engine_Play(currentAudioPath);
             else {
                 // Play first in list (same as Play button)
                 std::string p;
                 {
                     std::lock_guard<std::mutex> lk(listMtx);
-                    if (!recList.empty()) {
+                    if (recList.GetCount() > 0) {
                         listSelIdx = 0;
-                        p = recList[0].path;
+                        p = recList.GetPath(0);
                     }
                 }
                 if (!p.empty()) PlayFile(p);
@@ -1144,21 +1452,47 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
         }
         if (wParam == VK_LEFT  && (GetKeyState(VK_CONTROL) & 0x8000)) { PlayPrev(); return 0; }
         if (wParam == VK_RIGHT && (GetKeyState(VK_CONTROL) & 0x8000)) { PlayNext(); return 0; }
+        if (wParam == VK_OEM_4) { Engine_SetSpeed(speedStep - 1); return 0; }   // [
+        if (wParam == VK_OEM_6) { Engine_SetSpeed(speedStep + 1); return 0; }   // ]
+        if (wParam == 'K') { skipSilence = !skipSilence; InvalidateRect(hWnd, nullptr, FALSE); return 0; }
+        if (wParam == 'G') { showSpectro = !showSpectro; SyncSpectrogram(); InvalidateRect(hWnd, nullptr, FALSE); return 0; }
+        if (showSpectro && (wParam == VK_OEM_PLUS || wParam == VK_OEM_MINUS)) {    // Zoom
+            if (wParam == VK_OEM_PLUS && spectroLevel > 0) spectroLevel--;
+            if (wParam == VK_OEM_MINUS && spectroLevel + 1 < SpectrogramCache::LEVELS) spectroLevel++;
+            InvalidateRect(hWnd, nullptr, FALSE);
+            return 0;
+        }
         break;
 
+    case WM_RBUTTONDOWN: {
+        int x = GET_X_LPARAM(lParam), y = GET_Y_LPARAM(lParam);
+        if (HitTest(x, y) == HZ_SPEED) {
+            Engine_SetSpeed(speedStep > 0 ? speedStep - 1 : SPEED_STEP_COUNT - 1);
+            return 0;
+        }
+        break;
+    }
+
+    case WM_SIZE:
+        if (wParam == SIZE_RESTORED) WakePlayerTick();  // Back from minimized
+        return 0;
+
     case WM_CLOSE:
-        MCI_Stop();
-        KillTimer(hWnd, IDC_TIMER_POS);
+        Engine_Stop();
         ShowWindow(hWnd, SW_HIDE);
         return 0;
 
     case WM_DESTROY: {
-        KillTimer(hWnd, IDC_TIMER_POS);
-        MCI_Stop();
+        Engine_Stop();
+        if (playerTaskAdded) GetFrameScheduler().SetActive(playerTask, false, 0);
+        delete engine;
+        engine = nullptr;
         if (fTitle)  { DeleteObject(fTitle);  fTitle  = nullptr; }
         if (fNormal) { DeleteObject(fNormal); fNormal = nullptr; }
         if (fSmall)  { DeleteObject(fSmall);  fSmall  = nullptr; }
         if (fMono)   { DeleteObject(fMono);   fMono   = nullptr; }
+        playerBuffer.Release();
+        playerGdi.Clear();
         hSearchEdit = nullptr;
         hPlayerWnd  = nullptr;
         return 0;
@@ -1179,6 +1513,7 @@ static LRESULT CALLBACK PlayerWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
 // ═══════════════════════════════════════════════════════════════════════════
 void CreatePlayerWindow(HINSTANCE hInstance) {
     if (hPlayerWnd) return;
+    StartupPhase phase("player window");
 
     WNDCLASSEX wc = {};
     wc.cbSize        = sizeof(WNDCLASSEX);
@@ -1219,7 +1554,7 @@ void ShowPlayerWindow() {
     }
     if (hPlayerWnd) {
         ShowWindow(hPlayerWnd, SW_SHOW);
-        SetTimer(hPlayerWnd, IDC_TIMER_POS, 80, nullptr);
+        WakePlayerTick();
         SetForegroundWindow(hPlayerWnd);
         // Refresh list
         std::thread([]() {
@@ -1231,7 +1566,7 @@ void ShowPlayerWindow() {
 
 void ClosePlayerWindow() {
     if (hPlayerWnd) {
-        MCI_Stop();
+        Engine_Stop();
         ShowWindow(hPlayerWnd, SW_HIDE);
     }
 }
@@ -4,8 +4,14 @@
 #include "audio/audio.h"
 #include "ui/tray.h"
 #include "ui/overlay.h"
+#include "ui/control_panel.h"
 #include "core/resource.h"
+#include "audio/recorder.h"
+#include "audio/call_recorder.h"
+#include "network/http_server.h"
+#include "core/trace.h"
 #include <dwmapi.h>
+#include <ctime>
 
 void UpdateUIState() {
     static int lastMuted = -1; // -1 for uninitialized
@@ -26,3 +32,143 @@ void ToggleMute() {
     ToggleMuteAll();
     UpdateUIState();
 }
+
+// ─────────────────────────── Frame scheduler ─────────────────────────────────
+// Every periodic UI task runs off one timer on the main window, re-armed
+// for the next deadline after each tick and killed when nothing is due.
+
+static FrameScheduler frameScheduler;
+static FrameScheduler::TaskId taskMeter, taskCalls, taskExtStatus, taskUiState, taskOverlay;
+static bool frameSchedulerReady = false;
+
+static bool IsShown(HWND hWnd) {
+    return hWnd && IsWindowVisible(hWnd) && !IsIconic(hWnd);
+}
+
+// Until just after the next local midnight (the call recorder's date rollover)
+static uint32_t MsUntilMidnight() {
+    time_t now = time(nullptr);
+    struct tm tm;
+    localtime_s(&tm, &now);
+    int secs = 86400 - (tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec);
+    return (uint32_t)secs * 1000 + 1000;
+}
+
+static void ArmFrameTimer() {
+    if (!hMainWnd) return;
+    uint64_t next = frameScheduler.GetNextWakeup();
+    if (next == FrameScheduler::NEVER) {
+        KillTimer(hMainWnd, FRAME_TIMER_ID);
+        return;
+    }
+    uint64_t now = GetTickCount64();
+    uint64_t delay = next > now ? next - now : 0;
+    if (delay < USER_TIMER_MINIMUM) delay = USER_TIMER_MINIMUM;
+    if (delay > 0x7FFFFFFF) delay = 0x7FFFFFFF;
+    SetTimer(hMainWnd, FRAME_TIMER_ID, (UINT)delay, nullptr);
+}
+
+static void UpdateExtensionStatus() {
+    HWND hStatus = GetDlgItem(hMainWnd, 9998);
+    if (!hStatus) return;
+    if (isDevModeEnabled && autoRecordCalls) {
+        ShowWindow(hStatus, SW_SHOW);
+        if (IsExtensionConnected()) {
+            SetWindowText(hStatus, "✓ Extension Connected");
+        } else {
+            SetWindowText(hStatus, "Waiting for Extension...");
+        }
+    } else {
+        ShowWindow(hStatus, SW_HIDE);
+    }
+}
+
+void InitFrameScheduler() {
+    if (frameSchedulerReady) return;
+    frameSchedulerReady = true;
+    TRACE_THREAD_NAME("UI");
+
+    // Level history + control panel sections (was the 50 ms main timer)
+    taskMeter = frameScheduler.AddTask("meter", 50, 10, [] {
+        UpdateMeter();
+        TickControlPanel();
+        return true;
+    });
+    // Call recorder date rollover, and the disconnect check while recording
+    taskCalls = frameScheduler.AddTask("calls", 250, 100, [] {
+        if (!g_CallRecorder) return false;
+        g_CallRecorder->Poll();     // No-op while disabled
+        if (hRecorderWnd && showRecorder) {
+            InvalidateRect(hRecorderWnd, nullptr, FALSE);
+        }
+        return true;
+    });
+    taskExtStatus = frameScheduler.AddTask("ext-status", 500, 250, [] {
+        UpdateExtensionStatus();
+        return true;
+    });
+    // Mute state safety net (was the 2 s main timer); changes on the current
+    // device already arrive through WM_APP_MUTE_CHANGED
+    taskUiState = frameScheduler.AddTask("ui-state", 2000, 1000, [] {
+        if (skipTimerCycles > 0) { skipTimerCycles--; return true; }
+        UpdateUIState();
+        return true;
+    });
+    taskOverlay = frameScheduler.AddTask("overlay", 16, 0, [] {
+        return StepOverlayAnimation();
+    });
+    RefreshFrameScheduler();
+}
+
+FrameScheduler& GetFrameScheduler() {
+    return frameScheduler;
+}
+
+void WakeFrameTask(FrameScheduler::TaskId id, bool runNow) {
+    uint64_t before = frameScheduler.GetNextWakeup();
+    frameScheduler.SetActive(id, true, GetTickCount64(), runNow);
+    if (frameScheduler.GetNextWakeup() != before) ArmFrameTimer();
+}
+
+void RefreshFrameScheduler() {
+    if (!frameSchedulerReady) return;
+    uint64_t now = GetTickCount64();
+    bool panel = IsShown(hControlPanel);
+    bool anyVisible = panel || IsShown(hMainWnd) || IsShown(hMeterWnd) || IsShown(hOverlayWnd);
+
+    frameScheduler.SetActive(taskMeter, panel || IsShown(hMeterWnd), now);
+    frameScheduler.SetActive(taskUiState, anyVisible, now);
+    frameScheduler.SetActive(taskExtStatus, IsShown(hMainWnd) && isDevModeEnabled && autoRecordCalls, now);
+    if (IsShown(hMainWnd) && !(isDevModeEnabled && autoRecordCalls)) UpdateExtensionStatus();
+
+    bool callsOn = g_CallRecorder != nullptr;
+    bool watchCall = callsOn && (g_CallRecorder->GetState() == CallAutoRecorder::State::RECORDING ||
+                                 (hRecorderWnd && showRecorder && IsShown(hRecorderWnd)));
+    static bool callsWatching = false;
+    if (watchCall != callsWatching || !frameScheduler.IsActive(taskCalls)) {
+        // Switching cadence: restart so the new period applies now, not after the old one
+        callsWatching = watchCall;
+        frameScheduler.SetActive(taskCalls, false, now);
+        frameScheduler.SetPeriod(taskCalls, watchCall ? 250 : MsUntilMidnight());
+    }
+    frameScheduler.SetActive(taskCalls, callsOn, now);
+
+    if (taskOverlay < frameScheduler.GetTaskCount() && !IsShown(hOverlayWnd)) {
+        frameScheduler.SetActive(taskOverlay, false, now);
+    }
+    ArmFrameTimer();
+}
+
+void RequestFrameSchedulerRefresh() {
+    if (hMainWnd) PostMessage(hMainWnd, WM_APP_FRAME_REFRESH, 0, 0);
+}
+
+void WakeOverlayAnimation() {
+    if (frameSchedulerReady) WakeFrameTask(taskOverlay, true);
+}
+
+void OnFrameTimer() {
+    TRACE_SCOPE(FrameTick);
+    frameScheduler.RunDue(GetTickCount64());
+    ArmFrameTimer();
+}
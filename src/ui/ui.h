@@ -1,4 +1,19 @@
 #pragma once
 
+#include "core/frame_scheduler.h"
+
 void ToggleMute();
 void UpdateUIState();
+
+// Central UI tick (core/frame_scheduler.h): one timer on the main window
+// drives the meters, animations, player position and housekeeping, and is
+// not armed at all while nothing visible needs it.
+#define FRAME_TIMER_ID 1
+
+void InitFrameScheduler();
+FrameScheduler& GetFrameScheduler();
+void WakeFrameTask(FrameScheduler::TaskId id, bool runNow = false);
+void WakeOverlayAnimation();
+void RefreshFrameScheduler();           // Re-evaluate which tasks should run (UI thread)
+void RequestFrameSchedulerRefresh();    // Same, from any thread
+void OnFrameTimer();                    // WM_TIMER FRAME_TIMER_ID on the main window